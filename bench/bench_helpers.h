@@ -0,0 +1,64 @@
+#ifndef GARA_BENCH_HELPERS_H
+#define GARA_BENCH_HELPERS_H
+
+#include <atomic>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace gara {
+namespace bench {
+
+/**
+ * @brief Scratch directory removed when the owner goes out of scope
+ */
+class TempDir {
+public:
+    explicit TempDir(const std::string& prefix) {
+        static std::atomic<int> counter{0};
+        path_ = std::filesystem::temp_directory_path() /
+                ("gara_bench_" + prefix + "_" + std::to_string(::getpid()) + "_" + std::to_string(counter++));
+        std::filesystem::create_directories(path_);
+    }
+
+    ~TempDir() {
+        std::error_code ec;
+        std::filesystem::remove_all(path_, ec);
+    }
+
+    TempDir(const TempDir&) = delete;
+    TempDir& operator=(const TempDir&) = delete;
+
+    const std::filesystem::path& path() const { return path_; }
+    std::string file(const std::string& name) const { return (path_ / name).string(); }
+
+private:
+    std::filesystem::path path_;
+};
+
+// Deterministic pseudo-random bytes, so runs hash and store the same input
+inline std::vector<char> randomData(size_t size, uint32_t seed = 42) {
+    std::mt19937 rng(seed);
+    std::vector<char> data(size);
+    for (auto& byte : data) {
+        byte = static_cast<char>(rng() & 0xFF);
+    }
+    return data;
+}
+
+// Fixed-width hex id, in the shape of the SHA256 image ids
+inline std::string hexId(uint64_t n) {
+    static const char* digits = "0123456789abcdef";
+    std::string id(64, '0');
+    for (int i = 63; i >= 0 && n > 0; --i, n >>= 4) {
+        id[i] = digits[n & 0xF];
+    }
+    return id;
+}
+
+} // namespace bench
+} // namespace gara
+
+#endif // GARA_BENCH_HELPERS_H
@@ -0,0 +1,45 @@
+#ifndef GARA_BENCH_IMAGES_H
+#define GARA_BENCH_IMAGES_H
+
+#include <string>
+#include <vector>
+#include <vips/vips8>
+
+namespace gara {
+namespace bench {
+
+// Formats the image benchmarks sweep over, indexed by benchmark arguments
+inline const std::vector<std::string>& sourceFormats() {
+    static const std::vector<std::string> formats = {"jpeg", "png", "webp"};
+    return formats;
+}
+
+/**
+ * @brief Encode a synthetic photo-like image (gradient plus noise)
+ *
+ * Flat colour compresses unrealistically well, so the noise keeps encoded
+ * sizes and decode cost close to real photographs.
+ */
+inline std::vector<char> encodeTestImage(int width, int height, const std::string& format) {
+    vips::VImage coords = vips::VImage::xyz(width, height);
+    vips::VImage x = coords[0];
+    vips::VImage y = coords[1];
+    vips::VImage noise = vips::VImage::gaussnoise(width, height, vips::VImage::option()->set("sigma", 20.0));
+    vips::VImage red = (x * (255.0 / width) + noise).cast(VIPS_FORMAT_UCHAR);
+    vips::VImage green = (y * (255.0 / height) + noise).cast(VIPS_FORMAT_UCHAR);
+    vips::VImage blue = ((x + y) * (127.0 / (width + height)) + noise).cast(VIPS_FORMAT_UCHAR);
+    vips::VImage image = red.bandjoin(green).bandjoin(blue)
+        .copy(vips::VImage::option()->set("interpretation", VIPS_INTERPRETATION_sRGB));
+
+    void* buffer = nullptr;
+    size_t length = 0;
+    image.write_to_buffer(("." + format).c_str(), &buffer, &length);
+    std::vector<char> data(static_cast<char*>(buffer), static_cast<char*>(buffer) + length);
+    g_free(buffer);
+    return data;
+}
+
+} // namespace bench
+} // namespace gara
+
+#endif // GARA_BENCH_IMAGES_H
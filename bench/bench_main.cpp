@@ -0,0 +1,28 @@
+#include <benchmark/benchmark.h>
+#include "services/image_processor.h"
+#include "utils/logger.h"
+#include "utils/metrics.h"
+#include <filesystem>
+
+int main(int argc, char** argv) {
+    // Keep logging and EMF output out of the measured paths
+    gara::Logger::initialize("gara-bench", "error", gara::Logger::Format::TEXT, "bench");
+    gara::Metrics::initialize("GaraBench", "gara-bench", "bench", false);
+
+    if (!gara::ImageProcessor::initialize()) {
+        return 1;
+    }
+
+    // SQLiteClient::initialize reads src/db/schema.sql relative to the working directory
+    std::filesystem::current_path(GARA_SOURCE_DIR);
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+
+    gara::ImageProcessor::shutdown();
+    return 0;
+}
@@ -0,0 +1,95 @@
+#include <benchmark/benchmark.h>
+#include "bench_helpers.h"
+#include "services/cache_manager.h"
+#include "services/local_file_service.h"
+#include <memory>
+
+using namespace gara;
+using namespace gara::bench;
+
+namespace {
+
+constexpr int CACHED_RENDITIONS = 1000;
+constexpr size_t RENDITION_BYTES = 16 * 1024;
+
+TransformRequest renditionRequest(int i) {
+    return TransformRequest(hexId(static_cast<uint64_t>(i)), "webp", 640, 0, false);
+}
+
+/**
+ * @brief CacheManager over a LocalFileService holding CACHED_RENDITIONS renditions
+ *
+ * state.range(0) is 1 for the default in-process memory cache, 0 for lookups
+ * that always reach the file service.
+ */
+class CacheManagerFixture : public benchmark::Fixture {
+public:
+    void SetUp(const benchmark::State& state) override {
+        dir_ = std::make_unique<TempDir>("cache_manager");
+        auto file_service = std::make_shared<LocalFileService>(dir_->path().string());
+
+        CacheConfig config;
+        if (state.range(0) == 0) {
+            config.memory_max_bytes = 0;
+        }
+        cache_ = std::make_unique<CacheManager>(file_service, config);
+
+        auto data = randomData(RENDITION_BYTES);
+        for (int i = 0; i < CACHED_RENDITIONS; ++i) {
+            cache_->storeInCache(renditionRequest(i), data);
+        }
+    }
+
+    void TearDown(const benchmark::State&) override {
+        cache_.reset();
+        dir_.reset();
+    }
+
+protected:
+    std::unique_ptr<TempDir> dir_;
+    std::unique_ptr<CacheManager> cache_;
+};
+
+} // anonymous namespace
+
+BENCHMARK_DEFINE_F(CacheManagerFixture, GetCachedImage_Hit)(benchmark::State& state) {
+    int i = 0;
+    for (auto _ : state) {
+        std::string key = cache_->getCachedImage(renditionRequest(i++ % CACHED_RENDITIONS));
+        benchmark::DoNotOptimize(key.data());
+    }
+}
+BENCHMARK_REGISTER_F(CacheManagerFixture, GetCachedImage_Hit)->ArgName("memory")->Arg(0)->Arg(1);
+
+BENCHMARK_DEFINE_F(CacheManagerFixture, GetCachedImage_Miss)(benchmark::State& state) {
+    int i = CACHED_RENDITIONS;
+    for (auto _ : state) {
+        std::string key = cache_->getCachedImage(renditionRequest(i++));
+        benchmark::DoNotOptimize(key.data());
+    }
+}
+BENCHMARK_REGISTER_F(CacheManagerFixture, GetCachedImage_Miss)->ArgName("memory")->Arg(0)->Arg(1);
+
+BENCHMARK_DEFINE_F(CacheManagerFixture, GetCachedData_Hit)(benchmark::State& state) {
+    int i = 0;
+    for (auto _ : state) {
+        auto data = cache_->getCachedData(renditionRequest(i++ % CACHED_RENDITIONS));
+        benchmark::DoNotOptimize(data.get());
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(RENDITION_BYTES));
+}
+BENCHMARK_REGISTER_F(CacheManagerFixture, GetCachedData_Hit)->ArgName("memory")->Arg(0)->Arg(1);
+
+// One batch page worth of lookups, half of them hits
+BENCHMARK_DEFINE_F(CacheManagerFixture, GetCachedImages_Batch)(benchmark::State& state) {
+    std::vector<TransformRequest> requests;
+    for (int i = 0; i < 100; ++i) {
+        requests.push_back(renditionRequest(i % 2 == 0 ? i : CACHED_RENDITIONS + i));
+    }
+    for (auto _ : state) {
+        auto keys = cache_->getCachedImages(requests);
+        benchmark::DoNotOptimize(keys.data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(requests.size()));
+}
+BENCHMARK_REGISTER_F(CacheManagerFixture, GetCachedImages_Batch)->ArgName("memory")->Arg(0)->Arg(1);
@@ -0,0 +1,42 @@
+#include <benchmark/benchmark.h>
+#include "bench_helpers.h"
+#include "utils/file_utils.h"
+
+using namespace gara;
+using namespace gara::bench;
+
+namespace {
+
+void applySizes(benchmark::internal::Benchmark* bench) {
+    bench->ArgName("bytes")->RangeMultiplier(16)->Range(64 << 10, 64 << 20);
+}
+
+} // anonymous namespace
+
+static void BM_FileUtils_SHA256_Buffer(benchmark::State& state) {
+    std::vector<char> data = randomData(static_cast<size_t>(state.range(0)));
+
+    for (auto _ : state) {
+        std::string hash = utils::FileUtils::calculateSHA256(data);
+        benchmark::DoNotOptimize(hash.data());
+    }
+
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_FileUtils_SHA256_Buffer)->Apply(applySizes);
+
+// Reads through the page cache after the first iteration, so this measures
+// the read loop plus hashing rather than the disk
+static void BM_FileUtils_SHA256_File(benchmark::State& state) {
+    TempDir dir("sha256");
+    std::string path = dir.file("input.bin");
+    utils::FileUtils::writeToFile(path, randomData(static_cast<size_t>(state.range(0))));
+
+    for (auto _ : state) {
+        std::string hash = utils::FileUtils::calculateSHA256(path);
+        benchmark::DoNotOptimize(hash.data());
+    }
+
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_FileUtils_SHA256_File)->Apply(applySizes);
@@ -0,0 +1,90 @@
+#include <benchmark/benchmark.h>
+#include "bench_helpers.h"
+#include "bench_images.h"
+#include "services/image_processor.h"
+#include "utils/file_utils.h"
+#include <map>
+#include <utility>
+
+using namespace gara;
+using namespace gara::bench;
+
+namespace {
+
+constexpr int TARGET_WIDTH = 800;
+
+// Encoded sources are generated once per (format, edge) and shared between runs
+const TempDir& sourceDir() {
+    static TempDir dir("image_processor");
+    return dir;
+}
+
+const std::string& sourcePath(const std::string& format, int edge) {
+    static std::map<std::pair<std::string, int>, std::string> paths;
+    auto key = std::make_pair(format, edge);
+    auto it = paths.find(key);
+    if (it == paths.end()) {
+        std::string path = sourceDir().file("source_" + std::to_string(edge) + "." + format);
+        utils::FileUtils::writeToFile(path, encodeTestImage(edge, edge * 3 / 4, format));
+        it = paths.emplace(key, path).first;
+    }
+    return it->second;
+}
+
+void applyArgs(benchmark::internal::Benchmark* bench) {
+    bench->ArgNames({"src", "edge", "dst"});
+    bench->ArgsProduct({{0, 1, 2}, {640, 2048, 4096}, {0, 1, 2}});
+    bench->Unit(benchmark::kMillisecond);
+}
+
+} // anonymous namespace
+
+// File to file, as used for uploads: src/dst index sourceFormats()
+static void BM_ImageProcessor_Transform(benchmark::State& state) {
+    const std::string& source_format = sourceFormats()[state.range(0)];
+    const std::string& target_format = sourceFormats()[state.range(2)];
+    const std::string& input = sourcePath(source_format, static_cast<int>(state.range(1)));
+    std::string output = sourceDir().file("out_" + std::to_string(state.thread_index()) + "." + target_format);
+    ImageProcessor processor;
+
+    for (auto _ : state) {
+        bool ok = processor.transform(input, output, target_format, TARGET_WIDTH, 0);
+        benchmark::DoNotOptimize(ok);
+    }
+
+    state.SetLabel(source_format + "->" + target_format);
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(utils::FileUtils::getFileSize(input)));
+}
+BENCHMARK(BM_ImageProcessor_Transform)->Apply(applyArgs);
+
+// In-memory pipeline used for cache misses
+static void BM_ImageProcessor_TransformBuffer(benchmark::State& state) {
+    const std::string& source_format = sourceFormats()[state.range(0)];
+    const std::string& target_format = sourceFormats()[state.range(2)];
+    std::vector<char> input = utils::FileUtils::readFile(
+        sourcePath(source_format, static_cast<int>(state.range(1))));
+    ImageProcessor processor;
+
+    for (auto _ : state) {
+        std::vector<char> output = processor.transformBuffer(input, target_format, TARGET_WIDTH, 0);
+        benchmark::DoNotOptimize(output.data());
+    }
+
+    state.SetLabel(source_format + "->" + target_format);
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(input.size()));
+}
+BENCHMARK(BM_ImageProcessor_TransformBuffer)->Apply(applyArgs);
+
+// Header probe run on every upload
+static void BM_ImageProcessor_GetImageInfo(benchmark::State& state) {
+    const std::string& input = sourcePath(sourceFormats()[state.range(0)], 4096);
+    ImageProcessor processor;
+
+    for (auto _ : state) {
+        ImageInfo info = processor.getImageInfo(input);
+        benchmark::DoNotOptimize(info.width);
+    }
+
+    state.SetLabel(sourceFormats()[state.range(0)]);
+}
+BENCHMARK(BM_ImageProcessor_GetImageInfo)->ArgName("src")->DenseRange(0, 2);
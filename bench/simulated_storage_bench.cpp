@@ -0,0 +1,88 @@
+#include <benchmark/benchmark.h>
+#include "bench_helpers.h"
+#include "services/cache_manager.h"
+#include "services/local_file_service.h"
+#include "services/simulated_file_service.h"
+#include <memory>
+
+using namespace gara;
+using namespace gara::bench;
+
+namespace {
+
+constexpr int CACHED_RENDITIONS = 64;
+constexpr size_t RENDITION_BYTES = 16 * 1024;
+
+TransformRequest renditionRequest(int i) {
+    return TransformRequest(hexId(static_cast<uint64_t>(i)), "webp", 640, 0, false);
+}
+
+/**
+ * @brief CacheManager over a LocalFileService behind S3-like simulated latency
+ *
+ * Uses the StorageSimulationConfig defaults (30 ms median GETs, 50 ms PUTs)
+ * with a 50 MB/s transfer cap. state.range(0) toggles the in-process memory
+ * cache for lookups and write-behind for stores. Timings are wall-clock,
+ * since the simulated storage sleeps.
+ */
+class SimulatedStorageFixture : public benchmark::Fixture {
+public:
+    void SetUp(const benchmark::State& state) override {
+        dir_ = std::make_unique<TempDir>("simulated_storage");
+        auto local = std::make_shared<LocalFileService>(dir_->path().string());
+
+        // Seed through the bare backend so setup does not pay simulated PUTs
+        CacheConfig seed_config;
+        seed_config.memory_max_bytes = 0;
+        CacheManager seeder(local, seed_config);
+        auto data = randomData(RENDITION_BYTES);
+        for (int i = 0; i < CACHED_RENDITIONS; ++i) {
+            seeder.storeInCache(renditionRequest(i), data);
+        }
+
+        StorageSimulationConfig simulation;
+        simulation.enabled = true;
+        simulation.bandwidth_bytes_per_sec = 50ULL * 1024 * 1024;
+
+        CacheConfig config;
+        if (state.range(0) == 0) {
+            config.memory_max_bytes = 0;
+        } else {
+            config.write_behind = true;
+        }
+        cache_ = std::make_unique<CacheManager>(std::make_shared<SimulatedFileService>(local, simulation), config);
+    }
+
+    void TearDown(const benchmark::State&) override {
+        cache_.reset();
+        dir_.reset();
+    }
+
+protected:
+    std::unique_ptr<TempDir> dir_;
+    std::unique_ptr<CacheManager> cache_;
+};
+
+} // anonymous namespace
+
+BENCHMARK_DEFINE_F(SimulatedStorageFixture, GetCachedData_Hit)(benchmark::State& state) {
+    int i = 0;
+    for (auto _ : state) {
+        auto data = cache_->getCachedData(renditionRequest(i++ % CACHED_RENDITIONS));
+        benchmark::DoNotOptimize(data.get());
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(RENDITION_BYTES));
+}
+BENCHMARK_REGISTER_F(SimulatedStorageFixture, GetCachedData_Hit)
+    ->ArgName("memory")->Arg(0)->Arg(1)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+BENCHMARK_DEFINE_F(SimulatedStorageFixture, StoreInCache)(benchmark::State& state) {
+    auto data = randomData(RENDITION_BYTES);
+    int i = CACHED_RENDITIONS;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(cache_->storeInCache(renditionRequest(i++), data));
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(RENDITION_BYTES));
+}
+BENCHMARK_REGISTER_F(SimulatedStorageFixture, StoreInCache)
+    ->ArgName("write_behind")->Arg(0)->Arg(1)->UseRealTime()->Unit(benchmark::kMillisecond);
@@ -0,0 +1,149 @@
+#include <benchmark/benchmark.h>
+#include "bench_helpers.h"
+#include "db/sqlite_client.h"
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <sqlite3.h>
+#include <stdexcept>
+
+using namespace gara;
+using namespace gara::bench;
+
+namespace {
+
+constexpr int PAGE_SIZE = 100;
+constexpr int ALBUM_SIZE = 1000;
+const char* BENCH_ALBUM_ID = "bench-album";
+
+/**
+ * @brief SQLite database seeded with a fixed number of image rows and one album
+ *
+ * Seeding a million rows takes seconds, so each size is built once and
+ * shared by every benchmark that asks for it.
+ */
+struct SeededDatabase {
+    TempDir dir{"sqlite"};
+    std::unique_ptr<SQLiteClient> client;
+    ImagePageCursor middle;  // Cursor positioned halfway through NEWEST order
+
+    explicit SeededDatabase(int64_t rows) {
+        std::string path = dir.file("gara.db");
+        client = std::make_unique<SQLiteClient>(path);
+        if (!client->initialize()) {
+            throw std::runtime_error("Failed to initialize benchmark database");
+        }
+        insertImages(path, rows);
+
+        // Members spread across the table rather than one contiguous run
+        Album album(BENCH_ALBUM_ID, "Benchmark album");
+        for (int64_t i = 0; i < std::min<int64_t>(ALBUM_SIZE, rows); ++i) {
+            album.image_ids.push_back(hexId(static_cast<uint64_t>(i * (rows / ALBUM_SIZE + 1) % rows)));
+        }
+        client->putAlbum(album);
+
+        auto page = client->listImages(1, static_cast<int>(rows / 2), ImageSortOrder::NEWEST);
+        if (!page.empty()) {
+            middle = ImagePageCursor::fromImage(page.front());
+        }
+    }
+
+    // One bulk transaction through a separate handle; putImageMetadata would commit per row
+    static void insertImages(const std::string& path, int64_t rows) {
+        sqlite3* db = nullptr;
+        sqlite3_open(path.c_str(), &db);
+        sqlite3_exec(db, "BEGIN", nullptr, nullptr, nullptr);
+        sqlite3_stmt* stmt = nullptr;
+        sqlite3_prepare_v2(db,
+            "INSERT INTO images (image_id, name, original_format, size, width, height, uploaded_at) "
+            "VALUES (?, ?, 'jpeg', ?, 4000, 3000, ?)", -1, &stmt, nullptr);
+        for (int64_t i = 0; i < rows; ++i) {
+            std::string id = hexId(static_cast<uint64_t>(i));
+            std::string name = "image_" + std::to_string((i * 7919) % rows);
+            sqlite3_bind_text(stmt, 1, id.c_str(), -1, SQLITE_TRANSIENT);
+            sqlite3_bind_text(stmt, 2, name.c_str(), -1, SQLITE_TRANSIENT);
+            sqlite3_bind_int64(stmt, 3, 1000000 + i);
+            sqlite3_bind_int64(stmt, 4, 1700000000 + i);
+            sqlite3_step(stmt);
+            sqlite3_reset(stmt);
+        }
+        sqlite3_finalize(stmt);
+        sqlite3_exec(db, "COMMIT", nullptr, nullptr, nullptr);
+        sqlite3_exec(db, "ANALYZE", nullptr, nullptr, nullptr);
+        sqlite3_close(db);
+    }
+};
+
+SeededDatabase& seeded(int64_t rows) {
+    static std::map<int64_t, std::unique_ptr<SeededDatabase>> databases;
+    auto& db = databases[rows];
+    if (!db) {
+        db = std::make_unique<SeededDatabase>(rows);
+    }
+    return *db;
+}
+
+void applyRows(benchmark::internal::Benchmark* bench) {
+    bench->ArgName("rows")->Arg(10000)->Arg(1000000);
+}
+
+} // anonymous namespace
+
+static void BM_SQLiteClient_ListImages_FirstPage(benchmark::State& state) {
+    SQLiteClient& client = *seeded(state.range(0)).client;
+    auto order = static_cast<ImageSortOrder>(state.range(1));
+
+    for (auto _ : state) {
+        auto page = client.listImages(PAGE_SIZE, 0, order);
+        benchmark::DoNotOptimize(page.data());
+    }
+}
+BENCHMARK(BM_SQLiteClient_ListImages_FirstPage)
+    ->ArgNames({"rows", "order"})
+    ->ArgsProduct({{10000, 1000000}, {static_cast<int64_t>(ImageSortOrder::NEWEST),
+                                      static_cast<int64_t>(ImageSortOrder::NAME_ASC)}});
+
+// OFFSET scans every skipped row; compare with ListImagesAfter
+static void BM_SQLiteClient_ListImages_DeepOffset(benchmark::State& state) {
+    SQLiteClient& client = *seeded(state.range(0)).client;
+    int offset = static_cast<int>(state.range(0) / 2);
+
+    for (auto _ : state) {
+        auto page = client.listImages(PAGE_SIZE, offset, ImageSortOrder::NEWEST);
+        benchmark::DoNotOptimize(page.data());
+    }
+}
+BENCHMARK(BM_SQLiteClient_ListImages_DeepOffset)->Apply(applyRows);
+
+static void BM_SQLiteClient_ListImagesAfter_Middle(benchmark::State& state) {
+    SeededDatabase& db = seeded(state.range(0));
+
+    for (auto _ : state) {
+        auto page = db.client->listImagesAfter(PAGE_SIZE, ImageSortOrder::NEWEST, db.middle);
+        benchmark::DoNotOptimize(page.data());
+    }
+}
+BENCHMARK(BM_SQLiteClient_ListImagesAfter_Middle)->Apply(applyRows);
+
+static void BM_SQLiteClient_GetImageCount(benchmark::State& state) {
+    SQLiteClient& client = *seeded(state.range(0)).client;
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(client.getImageCount());
+    }
+}
+BENCHMARK(BM_SQLiteClient_GetImageCount)->Apply(applyRows);
+
+// Album of ALBUM_SIZE members; range(1) selects whether member ids are loaded
+static void BM_SQLiteClient_GetAlbum(benchmark::State& state) {
+    SQLiteClient& client = *seeded(state.range(0)).client;
+    bool include_images = state.range(1) != 0;
+
+    for (auto _ : state) {
+        auto album = client.getAlbum(BENCH_ALBUM_ID, include_images);
+        benchmark::DoNotOptimize(album.has_value());
+    }
+}
+BENCHMARK(BM_SQLiteClient_GetAlbum)
+    ->ArgNames({"rows", "images"})
+    ->ArgsProduct({{10000, 1000000}, {0, 1}});
@@ -13,6 +13,15 @@ constexpr int PRESIGNED_URL_EXPIRATION_SECONDS = 3600;
 // CORS max age in seconds (1 hour)
 constexpr int CORS_MAX_AGE_SECONDS = 3600;
 
+// Album image listing page size
+constexpr int ALBUM_IMAGES_DEFAULT_LIMIT = 100;
+constexpr int ALBUM_IMAGES_MAX_LIMIT = 1000;
+
+// Filtered album listing (GET /api/albums?tag=...) page size and tag count
+constexpr int ALBUMS_DEFAULT_LIMIT = 50;
+constexpr int ALBUMS_MAX_LIMIT = 500;
+constexpr size_t ALBUMS_MAX_TAG_FILTERS = 10;
+
 // Supported image file formats
 const std::vector<std::string> SUPPORTED_IMAGE_FORMATS = {
     "jpg", "jpeg", "png", "webp", "gif"
@@ -25,6 +34,7 @@ constexpr const char* ERROR_VALIDATION = "Validation error";
 
 // Query parameter values
 constexpr const char* PARAM_TRUE = "true";
+constexpr const char* INCLUDE_RENDITIONS = "renditions";
 
 } // namespace constants
 } // namespace gara
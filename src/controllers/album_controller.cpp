@@ -1,23 +1,62 @@
 #include "album_controller.h"
+#include "image_controller.h"
 #include "../middleware/auth_middleware.h"
 #include "../models/image_metadata.h"
 #include "../constants/album_constants.h"
 #include "../exceptions/album_exceptions.h"
 #include "../utils/logger.h"
 #include "../utils/metrics.h"
+#include "../utils/etag.h"
+#include "../utils/format_negotiation.h"
+#include "../utils/json_writer.h"
+#include "../utils/page_cursor.h"
 #include <nlohmann/json.hpp>
+#include <algorithm>
 
 using json = nlohmann::json;
 
 namespace gara {
 
+namespace {
+
+// Parses a non-negative integer query parameter, falling back when absent
+int parsePageParam(const crow::request& req, const char* name, int fallback) {
+    const char* value = req.url_params.get(name);
+    if (!value) {
+        return fallback;
+    }
+    try {
+        size_t consumed = 0;
+        int parsed = std::stoi(value, &consumed);
+        if (consumed == std::string(value).size() && parsed >= 0) {
+            return parsed;
+        }
+    } catch (const std::exception&) {
+    }
+    throw exceptions::ValidationException(std::string("Invalid ") + name + " parameter: " + value);
+}
+
+} // anonymous namespace
+
 AlbumController::AlbumController(
     std::shared_ptr<AlbumService> album_service,
     std::shared_ptr<FileServiceInterface> file_service,
-    std::shared_ptr<ConfigServiceInterface> config_service)
+    std::shared_ptr<ConfigServiceInterface> config_service,
+    std::shared_ptr<RawKeyResolver> raw_key_resolver,
+    std::shared_ptr<CacheManager> cache_manager,
+    const TransformConfig& transform_config)
     : album_service_(album_service),
       file_service_(file_service),
-      config_service_(config_service) {
+      config_service_(config_service),
+      raw_key_resolver_(raw_key_resolver),
+      cache_manager_(cache_manager),
+      transform_config_(transform_config) {
+    if (!raw_key_resolver_) {
+        raw_key_resolver_ = std::make_shared<RawKeyResolver>(nullptr, file_service_);
+    }
+    if (!cache_manager_) {
+        cache_manager_ = std::make_shared<CacheManager>(file_service_);
+    }
 }
 
 // registerRoutes is now a template method in the header
@@ -38,18 +77,85 @@ crow::response AlbumController::handleListAlbums(const crow::request& req) {
             published_only = true;
         }
 
-        auto albums = album_service_->listAlbums(published_only);
+        // Tag filters and paging read one indexed page instead of the cached full listing
+        std::vector<char*> tag_params = req.url_params.get_list("tag", false);
+        if (!tag_params.empty() || req.url_params.get("limit") || req.url_params.get("cursor")) {
+            return listAlbumsPage(req, published_only, tag_params);
+        }
+
+        // Serialized once per listing; cached listings are reused as-is
+        auto listing = album_service_->listAlbumsJson(published_only);
 
-        json response;
-        response["albums"] = json::array();
-        for (const auto& album : albums) {
-            response["albums"].push_back(album.toJson());
+        std::string if_none_match = req.get_header_value("If-None-Match");
+        if (!if_none_match.empty() && utils::ETag::matches(if_none_match, listing->etag)) {
+            crow::response resp(304);
+            resp.add_header("ETag", listing->etag);
+            addCorsHeaders(resp);
+            return resp;
         }
 
-        return buildJsonResponse(200, response);
+        // The strong ETag also keys the compressed-body cache
+        crow::response resp = buildJsonResponse(200, listing->body);
+        resp.add_header("ETag", listing->etag);
+        return resp;
     });
 }
 
+crow::response AlbumController::listAlbumsPage(const crow::request& req, bool published_only,
+                                               const std::vector<char*>& tag_params) {
+    AlbumQuery query;
+    query.published_only = published_only;
+    for (const char* tag : tag_params) {
+        if (tag[0] != '\0') {
+            query.tags.emplace_back(tag);
+        }
+    }
+    if (query.tags.size() > constants::ALBUMS_MAX_TAG_FILTERS) {
+        throw exceptions::ValidationException("Too many tag parameters: at most " +
+                                              std::to_string(constants::ALBUMS_MAX_TAG_FILTERS));
+    }
+
+    int limit = std::clamp(parsePageParam(req, "limit", constants::ALBUMS_DEFAULT_LIMIT),
+                           1, constants::ALBUMS_MAX_LIMIT);
+
+    std::optional<AlbumPageCursor> after;
+    if (const char* cursor_param = req.url_params.get("cursor")) {
+        after = utils::PageCursorCodec::decodeAlbum(cursor_param);
+        if (!after) {
+            throw exceptions::ValidationException("Invalid cursor parameter: malformed");
+        }
+    }
+
+    auto page = album_service_->listAlbumsPage(query, limit, after);
+
+    size_t estimate = 64;
+    for (const auto& album : page.albums) {
+        estimate += 256 + album.name.size() + album.description.size() +
+                    album.image_ids.size() * 67 + album.tags.size() * 24;
+    }
+    std::string body;
+    body.reserve(estimate);
+
+    utils::JsonWriter writer(body);
+    writer.beginObject();
+    writer.key("albums");
+    writer.beginArray();
+    for (const auto& album : page.albums) {
+        album.writeJson(writer);
+    }
+    writer.endArray();
+    writer.field("limit", limit);
+    writer.key("next_cursor");
+    if (page.next) {
+        writer.value(utils::PageCursorCodec::encodeAlbum(*page.next));
+    } else {
+        writer.null();
+    }
+    writer.endObject();
+
+    return buildJsonResponse(200, std::move(body));
+}
+
 crow::response AlbumController::handleGetAlbum(const std::string& album_id, const crow::request& req) {
     return handleJsonRequest(req, [this, &album_id, &req]() {
         auto album = album_service_->getAlbum(album_id);
@@ -62,26 +168,51 @@ crow::response AlbumController::handleGetAlbum(const std::string& album_id, cons
 
         // Generate presigned URLs for all images
         json response = album.toJson();
-        json images_with_urls = json::array();
-
-        for (const auto& image_id : album.image_ids) {
-            std::string url = generatePresignedUrlForImage(image_id);
-            if (!url.empty()) {
-                images_with_urls.push_back({
-                    {"id", image_id},
-                    {"url", url}
-                });
-            }
-        }
-
-        response["images"] = images_with_urls;
+        response["images"] = buildImageEntries(album.image_ids);
 
         // Add cover image URL if exists
         if (!album.cover_image_id.empty()) {
             response["cover_image_url"] = generatePresignedUrlForImage(album.cover_image_id);
         }
 
-        return buildJsonResponse(200, response);
+        bool varies_by_accept = wantsRenditions(req) && addRenditions(response, album.image_ids, req);
+
+        crow::response resp = buildJsonResponse(200, response);
+        if (varies_by_accept) {
+            resp.add_header("Vary", "Accept");
+        }
+        return resp;
+    });
+}
+
+crow::response AlbumController::handleListAlbumImages(const std::string& album_id, const crow::request& req) {
+    return handleJsonRequest(req, [this, &album_id, &req]() {
+        int limit = std::clamp(parsePageParam(req, "limit", constants::ALBUM_IMAGES_DEFAULT_LIMIT),
+                               1, constants::ALBUM_IMAGES_MAX_LIMIT);
+        int offset = parsePageParam(req, "offset", 0);
+
+        auto page = album_service_->listAlbumImages(album_id, limit, offset);
+
+        if (!page.album.published && !validateAuth(req)) {
+            return buildErrorResponse(404, "Not Found", "Album not found or not published");
+        }
+
+        json response = {
+            {"album_id", album_id},
+            {"image_ids", page.album.image_ids},
+            {"images", buildImageEntries(page.album.image_ids)},
+            {"total", page.total},
+            {"limit", page.limit},
+            {"offset", page.offset}
+        };
+
+        bool varies_by_accept = wantsRenditions(req) && addRenditions(response, page.album.image_ids, req);
+
+        crow::response resp = buildJsonResponse(200, response);
+        if (varies_by_accept) {
+            resp.add_header("Vary", "Accept");
+        }
+        return resp;
     });
 }
 
@@ -137,29 +268,111 @@ void AlbumController::addCorsHeaders(crow::response& resp) {
     resp.add_header("Access-Control-Allow-Origin", "*");
     resp.add_header("Access-Control-Allow-Methods", "GET, POST, PUT, DELETE, OPTIONS");
     resp.add_header("Access-Control-Allow-Headers", "Content-Type, X-API-Key, Authorization");
+    resp.add_header("Access-Control-Expose-Headers", "ETag");
     resp.add_header("Access-Control-Max-Age", std::to_string(constants::CORS_MAX_AGE_SECONDS));
 }
 
 bool AlbumController::validateAuth(const crow::request& req) {
-    std::string api_key = config_service_->getApiKey();
-    return middleware::AuthMiddleware::validateApiKey(req, api_key);
+    return middleware::AuthMiddleware::validateApiKey(req, *config_service_);
 }
 
 std::string AlbumController::generatePresignedUrlForImage(const std::string& image_id) {
-    // Try common image formats to find the image in S3
-    for (const auto& format : constants::SUPPORTED_IMAGE_FORMATS) {
-        std::string key = ImageMetadata::generateRawKey(image_id, format);
-        if (file_service_->objectExists(key)) {
-            return file_service_->generatePresignedUrl(key, constants::PRESIGNED_URL_EXPIRATION_SECONDS);
+    std::string key = raw_key_resolver_->resolve(image_id);
+    if (key.empty()) {
+        return ""; // Image not found
+    }
+
+    return file_service_->generatePresignedUrl(key, constants::PRESIGNED_URL_EXPIRATION_SECONDS);
+}
+
+json AlbumController::buildImageEntries(const std::vector<std::string>& image_ids) {
+    std::unordered_map<std::string, std::string> placeholders = album_service_->getPlaceholders(image_ids);
+
+    json images = json::array();
+    for (const auto& image_id : image_ids) {
+        std::string url = generatePresignedUrlForImage(image_id);
+        if (url.empty()) {
+            continue;
+        }
+        json entry = {
+            {"id", image_id},
+            {"url", url}
+        };
+        auto placeholder = placeholders.find(image_id);
+        if (placeholder != placeholders.end()) {
+            entry["placeholder"] = placeholder->second;
+        }
+        images.push_back(std::move(entry));
+    }
+    return images;
+}
+
+bool AlbumController::wantsRenditions(const crow::request& req) {
+    const char* include = req.url_params.get("include");
+    return include && std::string(include) == constants::INCLUDE_RENDITIONS;
+}
+
+bool AlbumController::addRenditions(json& response, const std::vector<std::string>& image_ids,
+                                    const crow::request& req) {
+    // Same parameters and validation as GET /api/images/<id>, so the keys match
+    TransformParams params;
+    params.format = req.url_params.get("format");
+    params.width = req.url_params.get("width");
+    params.height = req.url_params.get("height");
+    params.quality = req.url_params.get("quality");
+    params.profile = req.url_params.get("profile");
+    params.accept = req.get_header_value("Accept");
+
+    std::string error_message;
+    auto rendition = ImageController::buildTransformRequest(transform_config_, "", params, error_message);
+    if (!rendition) {
+        throw exceptions::ValidationException(error_message);
+    }
+
+    std::vector<TransformRequest> requests(image_ids.size(), *rendition);
+    for (size_t i = 0; i < image_ids.size(); ++i) {
+        requests[i].image_id = image_ids[i];
+    }
+    std::vector<std::string> keys = cache_manager_->getCachedImages(requests);
+    // Renditions whose upload has not landed have no usable URL yet
+    std::vector<bool> ready = cache_manager_->awaitUrls(keys);
+
+    json images = json::array();
+    json missing = json::array();
+    for (size_t i = 0; i < image_ids.size(); ++i) {
+        if (keys[i].empty() || !ready[i]) {
+            missing.push_back(image_ids[i]);
+            continue;
         }
+        images.push_back({
+            {"id", image_ids[i]},
+            {"url", file_service_->generatePresignedUrl(keys[i], constants::PRESIGNED_URL_EXPIRATION_SECONDS)}
+        });
     }
 
-    return ""; // Image not found
+    METRICS_COUNT("AlbumRenditions", static_cast<double>(images.size()), "Count", {{"status", "hit"}});
+    METRICS_COUNT("AlbumRenditions", static_cast<double>(missing.size()), "Count", {{"status", "miss"}});
+
+    // Missing renditions are generated by requesting them from /api/images/<id>
+    // (or in bulk from /api/images/batch) with the same parameters
+    response["renditions"] = {
+        {"format", rendition->target_format},
+        {"width", rendition->width},
+        {"height", rendition->height},
+        {"images", images},
+        {"missing", missing}
+    };
+
+    return params.format && std::string(params.format) == utils::FormatNegotiation::AUTO_FORMAT;
 }
 
 // Helper method implementations
 crow::response AlbumController::buildJsonResponse(int status_code, const json& body) {
-    crow::response resp(status_code, body.dump());
+    return buildJsonResponse(status_code, body.dump());
+}
+
+crow::response AlbumController::buildJsonResponse(int status_code, std::string body) {
+    crow::response resp(status_code, std::move(body));
     resp.add_header("Content-Type", "application/json");
     addCorsHeaders(resp);
     return resp;
@@ -4,6 +4,9 @@
 #include <crow.h>
 #include <memory>
 #include "../services/album_service.h"
+#include "../services/raw_key_resolver.h"
+#include "../services/cache_manager.h"
+#include "../models/transform_config.h"
 #include "../interfaces/file_service_interface.h"
 #include "../interfaces/config_service_interface.h"
 
@@ -14,7 +17,10 @@ public:
     AlbumController(
         std::shared_ptr<AlbumService> album_service,
         std::shared_ptr<FileServiceInterface> file_service,
-        std::shared_ptr<ConfigServiceInterface> config_service
+        std::shared_ptr<ConfigServiceInterface> config_service,
+        std::shared_ptr<RawKeyResolver> raw_key_resolver = nullptr,
+        std::shared_ptr<CacheManager> cache_manager = nullptr,
+        const TransformConfig& transform_config = TransformConfig()
     );
 
     // Register routes with Crow app (templated to support middleware)
@@ -25,6 +31,9 @@ private:
     std::shared_ptr<AlbumService> album_service_;
     std::shared_ptr<FileServiceInterface> file_service_;
     std::shared_ptr<ConfigServiceInterface> config_service_;
+    std::shared_ptr<RawKeyResolver> raw_key_resolver_;
+    std::shared_ptr<CacheManager> cache_manager_;
+    TransformConfig transform_config_;
 
     // Route handlers
     crow::response handleCreateAlbum(const crow::request& req);
@@ -35,14 +44,32 @@ private:
     crow::response handleAddImages(const std::string& album_id, const crow::request& req);
     crow::response handleRemoveImage(const std::string& album_id, const std::string& image_id, const crow::request& req);
     crow::response handleReorderImages(const std::string& album_id, const crow::request& req);
+    crow::response handleListAlbumImages(const std::string& album_id, const crow::request& req);
+
+    // GET /api/albums with tag, limit or cursor: one page from the album_tags index
+    crow::response listAlbumsPage(const crow::request& req, bool published_only,
+                                  const std::vector<char*>& tag_params);
 
     // Helper methods
     void addCorsHeaders(crow::response& resp);
     bool validateAuth(const crow::request& req);
     std::string generatePresignedUrlForImage(const std::string& image_id);
 
+    // [{id, url, placeholder}] for the images that exist; placeholder only
+    // when one was computed at upload
+    nlohmann::json buildImageEntries(const std::vector<std::string>& image_ids);
+
+    // Adds a "renditions" object when the request has ?include=renditions:
+    // URLs for every cached rendition, found in one CacheManager pass, and
+    // the IDs whose rendition has not been generated yet. Returns true when
+    // the result depends on the Accept header (format=auto)
+    bool addRenditions(nlohmann::json& response, const std::vector<std::string>& image_ids,
+                       const crow::request& req);
+    static bool wantsRenditions(const crow::request& req);
+
     // Response builder helpers
     crow::response buildJsonResponse(int status_code, const nlohmann::json& body);
+    crow::response buildJsonResponse(int status_code, std::string body);  // Already serialized
     crow::response buildErrorResponse(int status_code, const std::string& error, const std::string& details);
     crow::response buildAuthErrorResponse();
 
@@ -88,6 +115,12 @@ void AlbumController::registerRoutes(App& app) {
         return handleDeleteAlbum(album_id, req);
     });
 
+    // List one page of an album's images
+    CROW_ROUTE(app, "/api/albums/<string>/images").methods("GET"_method)
+    ([this](const crow::request& req, const std::string& album_id) {
+        return handleListAlbumImages(album_id, req);
+    });
+
     // Add images to album
     CROW_ROUTE(app, "/api/albums/<string>/images").methods("POST"_method)
     ([this](const crow::request& req, const std::string& album_id) {
@@ -0,0 +1,164 @@
+#include "file_controller.h"
+#include "../utils/etag.h"
+#include "../utils/file_utils.h"
+#include "../utils/http_range.h"
+#include "../utils/logger.h"
+#include "../utils/metrics.h"
+#include <fstream>
+#include <sstream>
+#include <system_error>
+
+namespace gara {
+
+namespace {
+
+// Partial responses are buffered, so cap how much one Range request reads;
+// Content-Range tells the client to ask again for the rest
+constexpr uint64_t MAX_RANGE_BYTES = 16 * 1024 * 1024;
+
+constexpr const char* IMMUTABLE_CACHE_CONTROL = "public, max-age=31536000, immutable";
+constexpr const char* REVALIDATE_CACHE_CONTROL = "public, no-cache";
+
+std::string contentTypeFor(const std::filesystem::path& path) {
+    std::string ext = path.extension().string();
+    return utils::FileUtils::getMimeType(ext.empty() ? ext : ext.substr(1));
+}
+
+} // anonymous namespace
+
+FileController::FileController(std::shared_ptr<LocalFileService> file_service,
+                               std::shared_ptr<CacheManager> cache_manager)
+    : file_service_(std::move(file_service)),
+      cache_manager_(std::move(cache_manager)) {
+}
+
+bool FileController::isContentAddressed(const std::string& key) {
+    return key.rfind("raw/", 0) == 0 || key.rfind("transformed/", 0) == 0;
+}
+
+std::string FileController::computeETag(const std::string& key, uintmax_t size, int64_t mtime) {
+    if (isContentAddressed(key)) {
+        return utils::ETag::fromStorageKey(key);
+    }
+    std::ostringstream tag;
+    tag << "W/\"" << std::hex << size << "-" << mtime << "\"";
+    return tag.str();
+}
+
+crow::response FileController::handleGetFile(const crow::request& req, const std::string& key) {
+    std::filesystem::path path = file_service_->resolveServablePath(key);
+
+    std::error_code ec;
+    uintmax_t size = path.empty() ? 0 : std::filesystem::file_size(path, ec);
+    if (path.empty() || ec) {
+        if (cache_manager_ && !path.empty()) {
+            if (auto pending = cache_manager_->getPendingData(key)) {
+                return handlePendingFile(req, key, *pending);
+            }
+        }
+        METRICS_COUNT("FileServeRequests", 1.0, "Count", {{"status", "not_found"}});
+        crow::response resp(404);
+        addCorsHeaders(resp);
+        return resp;
+    }
+
+    auto mtime = std::filesystem::last_write_time(path, ec).time_since_epoch().count();
+    std::string etag = computeETag(key, size, static_cast<int64_t>(mtime));
+
+    auto addCachingHeaders = [&](crow::response& resp) {
+        resp.add_header("ETag", etag);
+        resp.add_header("Cache-Control", isContentAddressed(key) ? IMMUTABLE_CACHE_CONTROL
+                                                                 : REVALIDATE_CACHE_CONTROL);
+        resp.add_header("Accept-Ranges", "bytes");
+        addCorsHeaders(resp);
+    };
+
+    const std::string& if_none_match = req.get_header_value("If-None-Match");
+    if (!if_none_match.empty() && utils::ETag::matches(if_none_match, etag)) {
+        METRICS_COUNT("FileServeRequests", 1.0, "Count", {{"status", "not_modified"}});
+        crow::response resp(304);
+        addCachingHeaders(resp);
+        return resp;
+    }
+
+    // If-Range needs a strong match; otherwise the client gets the whole object
+    const std::string& range_header = req.get_header_value("Range");
+    const std::string& if_range = req.get_header_value("If-Range");
+    bool range_allowed = if_range.empty() || (etag.rfind("W/", 0) != 0 && utils::ETag::matches(if_range, etag));
+    utils::ByteRange range;
+    utils::RangeStatus status = utils::RangeStatus::FULL;
+    if (!range_header.empty() && range_allowed) {
+        status = utils::HttpRange::parse(range_header, size, range);
+    }
+
+    if (status == utils::RangeStatus::UNSATISFIABLE) {
+        METRICS_COUNT("FileServeRequests", 1.0, "Count", {{"status", "unsatisfiable"}});
+        crow::response resp(416);
+        resp.add_header("Content-Range", utils::HttpRange::unsatisfiedRange(size));
+        addCachingHeaders(resp);
+        return resp;
+    }
+
+    if (status == utils::RangeStatus::PARTIAL) {
+        if (range.length() > MAX_RANGE_BYTES) {
+            range.last = range.first + MAX_RANGE_BYTES - 1;
+        }
+
+        std::ifstream file(path, std::ios::binary);
+        std::string body(range.length(), '\0');
+        if (!file.seekg(static_cast<std::streamoff>(range.first)) ||
+            !file.read(body.data(), static_cast<std::streamsize>(body.size()))) {
+            gara::Logger::log_structured(spdlog::level::err, "Failed to read file range", {
+                {"key", key},
+                {"first", range.first},
+                {"last", range.last}
+            });
+            METRICS_COUNT("FileServeRequests", 1.0, "Count", {{"status", "error"}});
+            crow::response resp(500);
+            addCorsHeaders(resp);
+            return resp;
+        }
+
+        METRICS_COUNT("FileServeRequests", 1.0, "Count", {{"status", "partial"}});
+        crow::response resp(206, std::move(body));
+        resp.add_header("Content-Type", contentTypeFor(path));
+        resp.add_header("Content-Range", utils::HttpRange::contentRange(range, size));
+        addCachingHeaders(resp);
+        return resp;
+    }
+
+    // Crow streams the file from disk in chunks instead of buffering it,
+    // and sets Content-Type and Content-Length from the file itself
+    METRICS_COUNT("FileServeRequests", 1.0, "Count", {{"status", "full"}});
+    crow::response resp;
+    resp.set_static_file_info_unsafe(path.string());
+    addCachingHeaders(resp);
+    return resp;
+}
+
+crow::response FileController::handlePendingFile(const crow::request& req, const std::string& key,
+                                                 const std::vector<char>& data) {
+    std::string etag = utils::ETag::fromStorageKey(key);
+    const std::string& if_none_match = req.get_header_value("If-None-Match");
+
+    crow::response resp;
+    if (!if_none_match.empty() && utils::ETag::matches(if_none_match, etag)) {
+        METRICS_COUNT("FileServeRequests", 1.0, "Count", {{"status", "not_modified"}});
+        resp.code = 304;
+    } else {
+        METRICS_COUNT("FileServeRequests", 1.0, "Count", {{"status", "pending"}});
+        resp.body.assign(data.begin(), data.end());
+        resp.add_header("Content-Type", contentTypeFor(key));
+    }
+    resp.add_header("ETag", etag);
+    resp.add_header("Cache-Control", IMMUTABLE_CACHE_CONTROL);
+    addCorsHeaders(resp);
+    return resp;
+}
+
+void FileController::addCorsHeaders(crow::response& resp) {
+    resp.add_header("Access-Control-Allow-Origin", "*");
+    resp.add_header("Access-Control-Expose-Headers", "ETag, Content-Range, Accept-Ranges");
+}
+
+} // namespace gara
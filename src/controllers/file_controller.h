@@ -0,0 +1,61 @@
+#ifndef GARA_FILE_CONTROLLER_H
+#define GARA_FILE_CONTROLLER_H
+
+#include <crow.h>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include "../services/local_file_service.h"
+#include "../services/cache_manager.h"
+
+namespace gara {
+
+/**
+ * @brief Serves stored objects over HTTP at /files/<key>
+ *
+ * This is the target of LocalFileService URLs, so local deployments need
+ * no separate web server. Full responses are streamed from disk by Crow;
+ * Range requests read only the requested slice. Renditions whose
+ * write-behind upload is still pending are served from memory.
+ */
+class FileController {
+public:
+    explicit FileController(std::shared_ptr<LocalFileService> file_service,
+                            std::shared_ptr<CacheManager> cache_manager = nullptr);
+
+    // Register routes with Crow app (templated to support middleware)
+    template<typename App>
+    void registerRoutes(App& app);
+
+    // Keys under raw/ and transformed/ embed the content hash and never change
+    static bool isContentAddressed(const std::string& key);
+
+    // Strong ETag from the content hash in the key, or a weak size/mtime tag otherwise
+    static std::string computeETag(const std::string& key, uintmax_t size, int64_t mtime);
+
+private:
+    std::shared_ptr<LocalFileService> file_service_;
+    std::shared_ptr<CacheManager> cache_manager_;
+
+    crow::response handleGetFile(const crow::request& req, const std::string& key);
+
+    // Serve a rendition that is not on disk yet; ranges are answered with the full body
+    crow::response handlePendingFile(const crow::request& req, const std::string& key,
+                                     const std::vector<char>& data);
+
+    void addCorsHeaders(crow::response& resp);
+};
+
+// Template implementation must be in header
+template<typename App>
+void FileController::registerRoutes(App& app) {
+    // HEAD is answered by Crow through the GET handler
+    CROW_ROUTE(app, "/files/<path>").methods("GET"_method)
+    ([this](const crow::request& req, const std::string& key) {
+        return handleGetFile(req, key);
+    });
+}
+
+} // namespace gara
+
+#endif // GARA_FILE_CONTROLLER_H
@@ -1,56 +1,125 @@
 #include "image_controller.h"
+#include "../utils/etag.h"
 #include "../utils/file_utils.h"
+#include "../utils/format_negotiation.h"
+#include "../utils/io_executor.h"
+#include "../utils/json_writer.h"
 #include "../utils/logger.h"
 #include "../utils/metrics.h"
+#include "../utils/multipart_parser.h"
+#include "../utils/page_cursor.h"
+#include "../utils/prometheus_registry.h"
+#include "../utils/rate_limiter.h"
+#include "../utils/sigv4.h"
+#include "../utils/trace.h"
 #include "../models/image_metadata.h"
 #include "../middleware/auth_middleware.h"
+#include "../exceptions/transform_exceptions.h"
 #include <nlohmann/json.hpp>
 #include <iostream>
+#include <fstream>
+#include <future>
+#include <algorithm>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <unordered_map>
 
 using json = nlohmann::json;
 
 namespace gara {
 
+namespace {
+// Upload bodies are hashed and written in chunks of this size
+constexpr size_t UPLOAD_CHUNK_SIZE = 1024 * 1024;
+
+// Largest file accepted by either upload endpoint
+constexpr size_t MAX_UPLOAD_BYTES = 100 * 1024 * 1024;
+
+// A duplicate upload waits this long for the in-flight one (large originals
+// take a while to reach S3) before storing its own copy
+constexpr std::chrono::minutes UPLOAD_COALESCE_TIMEOUT(5);
+
+// Rendition URLs are signed for this long
+constexpr int IMAGE_URL_EXPIRATION_SECONDS = 3600;
+
+// Renditions never change, but the JSON carries a signed URL; capping the
+// max-age at half its lifetime leaves any cached copy at least half an hour
+constexpr const char* IMAGE_RESPONSE_CACHE_CONTROL = "public, max-age=1800, immutable";
+
+// A redirect points at the same signed URL, so it is capped the same way but
+// is not immutable: a later request must get a freshly signed URL
+constexpr const char* REDIRECT_CACHE_CONTROL = "public, max-age=1800";
+
+// Inline bytes are the content-addressed rendition itself
+constexpr const char* INLINE_CACHE_CONTROL = "public, max-age=31536000, immutable";
+
+// The descriptor URL is stable across tile settings, so it is not immutable
+constexpr const char* TILE_DESCRIPTOR_CACHE_CONTROL = "public, max-age=86400";
+
+// Transforms run longer than requests served from cache, so buckets reach further
+const std::vector<double> TRANSFORM_LATENCY_BUCKETS = {
+    0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1.0, 2.5, 5.0, 10.0, 30.0
+};
+
+// Size label follows the executor's lanes (TRANSFORM small/large pixel thresholds)
+const char* sizeBucket(TransformPriority priority) {
+    switch (priority) {
+        case TransformPriority::HIGH: return "small";
+        case TransformPriority::NORMAL: return "medium";
+        case TransformPriority::LOW: return "large";
+    }
+    return "medium";
+}
+}
+
 ImageController::ImageController(std::shared_ptr<FileServiceInterface> file_service,
                                 std::shared_ptr<ImageProcessor> image_processor,
                                 std::shared_ptr<CacheManager> cache_manager,
                                 std::shared_ptr<ConfigServiceInterface> config_service,
                                 std::shared_ptr<WatermarkService> watermark_service,
-                                std::shared_ptr<DatabaseClientInterface> db_client)
+                                std::shared_ptr<DatabaseClientInterface> db_client,
+                                std::shared_ptr<RawKeyResolver> raw_key_resolver,
+                                const TransformConfig& transform_config,
+                                std::shared_ptr<PeerPool> peer_pool)
     : file_service_(file_service),
       image_processor_(image_processor),
       cache_manager_(cache_manager),
       config_service_(config_service),
       watermark_service_(watermark_service),
-      db_client_(db_client) {
+      db_client_(db_client),
+      raw_key_resolver_(raw_key_resolver),
+      transform_config_(transform_config),
+      peer_pool_(std::move(peer_pool)),
+      transform_flights_("transform", std::chrono::milliseconds(transform_config.coalesce_timeout_ms)),
+      upload_flights_("upload", UPLOAD_COALESCE_TIMEOUT),
+      governor_(transform_config.governor, transform_config.retry_after_seconds),
+      ingest_executor_(std::make_unique<utils::IoExecutor>(static_cast<size_t>(transform_config.ingest.workers))),
+      transform_executor_(std::make_unique<TransformExecutor>(
+          static_cast<size_t>(transform_config.worker_threads),
+          static_cast<size_t>(transform_config.queue_size))) {
+    if (transform_config.render_jobs.isEnabled()) {
+        // Background renders only take a worker nobody is waiting for
+        render_job_worker_ = std::make_unique<RenderJobWorker>(
+            transform_config.render_jobs, db_client_,
+            [this](const std::string& image_id, const std::vector<RenderJob>& jobs) {
+                return runRenderJobs(image_id, jobs);
+            },
+            [this]() { return transform_executor_->hasSpareCapacity(); });
+        render_job_worker_->start();
+    }
 }
 
 // registerRoutes is now a template method in the header
 
 crow::response ImageController::handleUpload(const crow::request& req) {
     try {
-        // Authenticate request using API key
-        std::string api_key = config_service_->getApiKey();
-
-        if (!middleware::AuthMiddleware::validateApiKey(req, api_key)) {
-            std::string provided_key = middleware::AuthMiddleware::extractApiKey(req);
-
-            crow::response auth_resp = [this, &provided_key]() {
-                if (provided_key.empty()) {
-                    return middleware::AuthMiddleware::unauthorizedResponse(
-                        "Missing X-API-Key header"
-                    );
-                } else {
-                    return middleware::AuthMiddleware::unauthorizedResponse(
-                        "Invalid API key"
-                    );
-                }
-            }();
-            addCorsHeaders(auth_resp);
-            return auth_resp;
+        // Authenticate request against the active API keys
+        if (!middleware::AuthMiddleware::validateApiKey(req, *config_service_)) {
+            return createAuthError(req);
         }
 
-        std::vector<char> file_data;
+        std::string_view file_data;
         std::string filename;
 
         // Extract uploaded file from multipart form data
@@ -59,8 +128,7 @@ crow::response ImageController::handleUpload(const crow::request& req) {
         }
 
         // Validate file size (100MB max)
-        const size_t max_size = 100 * 1024 * 1024;
-        if (file_data.size() > max_size) {
+        if (file_data.size() > MAX_UPLOAD_BYTES) {
             return createJsonError(413, "File too large. Maximum file size is 100MB");
         }
 
@@ -99,7 +167,44 @@ crow::response ImageController::handleGetImage(const crow::request& req,
                                               const std::string& image_id) {
     try {
         // Parse transformation parameters
-        TransformRequest transform_req = parseTransformParams(req, image_id);
+        std::string error_message;
+        auto transform_opt = parseTransformParams(req, image_id, error_message);
+        if (!transform_opt) {
+            return createJsonError(400, error_message);
+        }
+        TransformRequest transform_req = *transform_opt;
+
+        auto delivery_opt = parseDelivery(req.url_params.get("delivery"));
+        if (!delivery_opt) {
+            return createJsonError(400, "Invalid delivery parameter: must be json, redirect or inline");
+        }
+        ImageDelivery delivery = *delivery_opt;
+
+        // Negotiated responses differ per Accept header, so shared caches must key on it
+        auto format_param = req.url_params.get("format");
+        bool negotiated = format_param && std::string(format_param) == utils::FormatNegotiation::AUTO_FORMAT;
+
+        // The rendition key is deterministic, so revalidation needs no storage lookup
+        std::string etag = utils::ETag::fromStorageKey(transform_req.getCacheKey());
+        const std::string& if_none_match = req.get_header_value("If-None-Match");
+        if (!if_none_match.empty() && utils::ETag::matches(if_none_match, etag)) {
+            METRICS_COUNT("APIRequests", 1.0, "Count", {{"endpoint", "/get"}, {"status", "not_modified"}});
+            // Same caching policy as the 200 or 302 this revalidates
+            const char* cache_control = IMAGE_RESPONSE_CACHE_CONTROL;
+            if (delivery == ImageDelivery::INLINE) {
+                cache_control = INLINE_CACHE_CONTROL;
+            } else if (delivery == ImageDelivery::REDIRECT) {
+                cache_control = REDIRECT_CACHE_CONTROL;
+            }
+            crow::response resp(304);
+            resp.add_header("ETag", etag);
+            resp.add_header("Cache-Control", cache_control);
+            if (negotiated) {
+                resp.add_header("Vary", "Accept");
+            }
+            addCorsHeaders(resp);
+            return resp;
+        }
 
         // Get or create transformed image
         std::string s3_key = getOrCreateTransformed(transform_req);
@@ -115,23 +220,77 @@ crow::response ImageController::handleGetImage(const crow::request& req,
             return resp;
         }
 
+        // A URL to a write-behind rendition still uploading would not resolve
+        // yet, so unless it lands in time the bytes are sent instead
+        bool inline_fallback = delivery != ImageDelivery::INLINE && !cache_manager_->awaitUrl(s3_key);
+
+        if (delivery == ImageDelivery::INLINE || inline_fallback) {
+            auto body = readRendition(transform_req, s3_key);
+            if (!body) {
+                return createJsonError(500, "Failed to read transformed image");
+            }
+
+            METRICS_COUNT("ImageDeliveries", 1.0, "Count", {{"mode", inline_fallback ? "inline_fallback" : "inline"}});
+            crow::response resp(200, std::move(*body));
+            resp.add_header("Content-Type", utils::FileUtils::getMimeType(transform_req.target_format));
+            resp.add_header("ETag", etag);
+            resp.add_header("Cache-Control", INLINE_CACHE_CONTROL);
+            if (negotiated) {
+                resp.add_header("Vary", "Accept");
+            }
+            addCorsHeaders(resp);
+            return resp;
+        }
+
         // Generate presigned URL
-        std::string presigned_url = file_service_->generatePresignedUrl(s3_key, 3600);
+        std::string presigned_url;
+        {
+            TRACE_SPAN("presign");
+            presigned_url = file_service_->generatePresignedUrl(s3_key, IMAGE_URL_EXPIRATION_SECONDS);
+        }
 
+        if (delivery == ImageDelivery::REDIRECT) {
+            METRICS_COUNT("ImageDeliveries", 1.0, "Count", {{"mode", "redirect"}});
+            crow::response resp(302);
+            resp.add_header("Location", presigned_url);
+            resp.add_header("Cache-Control", REDIRECT_CACHE_CONTROL);
+            if (negotiated) {
+                resp.add_header("Vary", "Accept");
+            }
+            addCorsHeaders(resp);
+            return resp;
+        }
+
+        METRICS_COUNT("ImageDeliveries", 1.0, "Count", {{"mode", "json"}});
         json response = {
             {"image_id", image_id},
             {"format", transform_req.target_format},
             {"width", transform_req.width},
             {"height", transform_req.height},
             {"url", presigned_url},
-            {"expires_in", 3600}
+            {"expires_in", IMAGE_URL_EXPIRATION_SECONDS}
         };
 
         crow::response resp(200, response.dump());
         resp.add_header("Content-Type", "application/json");
+        resp.add_header("ETag", etag);
+        resp.add_header("Cache-Control", IMAGE_RESPONSE_CACHE_CONTROL);
+        if (negotiated) {
+            resp.add_header("Vary", "Accept");
+        }
         addCorsHeaders(resp);
         return resp;
 
+    } catch (const exceptions::TooManyRequestsException& e) {
+        METRICS_COUNT("APIRequests", 1.0, "Count", {{"endpoint", "/get"}, {"status", "rate_limited"}});
+        crow::response resp = createJsonError(429, "Rate limit exceeded. Please retry later");
+        resp.add_header("Retry-After", std::to_string(e.retryAfterSeconds()));
+        return resp;
+    } catch (const exceptions::ServiceUnavailableException& e) {
+        METRICS_COUNT("APIRequests", 1.0, "Count", {{"endpoint", "/get"}, {"status", "shed"}});
+        crow::response resp = createJsonError(503, "Service busy. Please retry later");
+        resp.add_header("Retry-After", std::to_string(e.retryAfterSeconds()));
+        return resp;
     } catch (const std::exception& e) {
         gara::Logger::log_structured(spdlog::level::err, "Get image error", {
             {"endpoint", "/api/images/:id"},
@@ -143,6 +302,697 @@ crow::response ImageController::handleGetImage(const crow::request& req,
     }
 }
 
+std::optional<ImageDelivery> ImageController::parseDelivery(const char* value) {
+    if (!value || std::strcmp(value, "json") == 0) {
+        return ImageDelivery::JSON;
+    }
+    if (std::strcmp(value, "redirect") == 0) {
+        return ImageDelivery::REDIRECT;
+    }
+    if (std::strcmp(value, "inline") == 0) {
+        return ImageDelivery::INLINE;
+    }
+    return std::nullopt;
+}
+
+crow::response ImageController::handlePeerRendition(const crow::request& req, const std::string& image_id) {
+    if (!peer_pool_) {
+        return createJsonError(404, "Peering is disabled");
+    }
+    if (req.get_header_value(PeerPool::PEER_HEADER).empty() ||
+        !middleware::AuthMiddleware::validateApiKey(req, *config_service_)) {
+        return middleware::AuthMiddleware::unauthorizedResponse("Peer requests need a valid API key");
+    }
+
+    try {
+        TransformParams params;
+        params.format = req.url_params.get("format");
+        params.width = req.url_params.get("width");
+        params.height = req.url_params.get("height");
+        params.quality = req.url_params.get("quality");
+        params.profile = req.url_params.get("profile");
+
+        std::string error_message;
+        auto request = buildTransformRequest(transform_config_, image_id, params, error_message);
+        if (!request) {
+            return createJsonError(400, error_message);
+        }
+
+        // Nodes on different settings (mid-rollout) would cache under different keys
+        const char* expected_key = req.url_params.get("key");
+        if (!expected_key || request->getCacheKey() != expected_key) {
+            return createJsonError(409, "Rendition key mismatch between peers");
+        }
+
+        std::string storage_key = getOrCreateTransformed(*request, false);
+        if (storage_key.empty()) {
+            return createJsonError(404, "Image not found or transformation failed");
+        }
+
+        if (req.url_params.get("inline")) {
+            auto body = readRendition(*request, storage_key, false);
+            if (!body) {
+                return createJsonError(500, "Failed to read transformed image");
+            }
+            crow::response resp(200, std::move(*body));
+            resp.add_header("Content-Type", utils::FileUtils::getMimeType(request->target_format));
+            return resp;
+        }
+
+        crow::response resp(200, json{{"key", storage_key}}.dump());
+        resp.add_header("Content-Type", "application/json");
+        return resp;
+
+    } catch (const exceptions::ServiceUnavailableException& e) {
+        crow::response resp = createJsonError(503, "Service busy. Please retry later");
+        resp.add_header("Retry-After", std::to_string(e.retryAfterSeconds()));
+        return resp;
+    } catch (const std::exception& e) {
+        gara::Logger::log_structured(spdlog::level::err, "Peer rendition error", {
+            {"endpoint", "/internal/peer/renditions/:id"},
+            {"image_id", image_id},
+            {"error", e.what()}
+        });
+        return createJsonError(500, "Internal server error");
+    }
+}
+
+std::optional<std::string> ImageController::readRendition(const TransformRequest& request,
+                                                          const std::string& storage_key,
+                                                          bool ask_owner) {
+    TRACE_SPAN("download");
+
+    // Small renditions, and any still waiting on a write-behind upload, are in memory
+    auto held = cache_manager_->getCachedData(request);
+    if (!held) {
+        held = cache_manager_->getPendingData(storage_key);
+    }
+    if (held) {
+        return std::string(held->begin(), held->end());
+    }
+
+    // The owner holds the key's small renditions in memory
+    if (ask_owner) {
+        if (auto fetched = fetchPeerRendition(request)) {
+            return fetched;
+        }
+    }
+
+    if (auto mapped = file_service_->mapObject(storage_key)) {
+        return std::string(mapped->data(), mapped->size());
+    }
+
+    auto data = file_service_->downloadData(storage_key);
+    if (data.empty()) {
+        gara::Logger::log_structured(spdlog::level::err, "Failed to read rendition for inline delivery", {
+            {"image_id", request.image_id},
+            {"storage_key", storage_key}
+        });
+        return std::nullopt;
+    }
+    return std::string(data.begin(), data.end());
+}
+
+crow::response ImageController::handleGetTileDescriptor(const crow::request& req,
+                                                       const std::string& image_id) {
+    if (!transform_config_.tiles.enabled) {
+        return createJsonError(404, "Tiles are disabled");
+    }
+    try {
+        std::string descriptor_key = getOrCreateTiles(image_id);
+        if (descriptor_key.empty()) {
+            return createJsonError(404, "Image not found or tile generation failed");
+        }
+
+        std::vector<char> descriptor = file_service_->downloadData(descriptor_key);
+        if (descriptor.empty()) {
+            return createJsonError(500, "Failed to read tile descriptor");
+        }
+
+        METRICS_COUNT("TileOperations", 1.0, "Count", {{"operation", "descriptor"}, {"status", "success"}});
+        crow::response resp(200, std::string(descriptor.begin(), descriptor.end()));
+        resp.add_header("Content-Type", "application/xml");
+        resp.add_header("Cache-Control", TILE_DESCRIPTOR_CACHE_CONTROL);
+        addCorsHeaders(resp);
+        return resp;
+
+    } catch (const exceptions::ServiceUnavailableException& e) {
+        METRICS_COUNT("TileOperations", 1.0, "Count", {{"operation", "descriptor"}, {"status", "shed"}});
+        crow::response resp = createJsonError(503, "Tiles are being generated. Please retry later");
+        resp.add_header("Retry-After", std::to_string(e.retryAfterSeconds()));
+        return resp;
+    } catch (const std::exception& e) {
+        gara::Logger::log_structured(spdlog::level::err, "Get tile descriptor error", {
+            {"endpoint", "/api/images/:id/tiles/image.dzi"},
+            {"image_id", image_id},
+            {"error", e.what()}
+        });
+        return createJsonError(500, "Internal server error. An error occurred while processing your request");
+    }
+}
+
+crow::response ImageController::handleGetTile(const crow::request& req, const std::string& image_id,
+                                              int level, const std::string& tile_name) {
+    int col = 0;
+    int row = 0;
+    if (!transform_config_.tiles.enabled) {
+        return createJsonError(404, "Tiles are disabled");
+    }
+    if (level < 0 || level > 32 || !transform_config_.tiles.parseTileName(tile_name, col, row)) {
+        return createJsonError(404, "Tile not found");
+    }
+    try {
+        // Tiles are only requested after the descriptor, so this is normally one cached existence check
+        if (getOrCreateTiles(image_id).empty()) {
+            return createJsonError(404, "Image not found or tile generation failed");
+        }
+
+        std::string tile_key = tilePrefix(image_id) + "image_files/" + std::to_string(level) + "/" +
+                               std::to_string(col) + "_" + std::to_string(row) + "." +
+                               transform_config_.tiles.extension();
+        std::string presigned_url;
+        {
+            TRACE_SPAN("presign");
+            presigned_url = file_service_->generatePresignedUrl(tile_key, IMAGE_URL_EXPIRATION_SECONDS);
+        }
+
+        METRICS_COUNT("TileOperations", 1.0, "Count", {{"operation", "tile"}, {"status", "success"}});
+        crow::response resp(302);
+        resp.add_header("Location", presigned_url);
+        resp.add_header("Cache-Control", REDIRECT_CACHE_CONTROL);
+        addCorsHeaders(resp);
+        return resp;
+
+    } catch (const exceptions::ServiceUnavailableException& e) {
+        METRICS_COUNT("TileOperations", 1.0, "Count", {{"operation", "tile"}, {"status", "shed"}});
+        crow::response resp = createJsonError(503, "Tiles are being generated. Please retry later");
+        resp.add_header("Retry-After", std::to_string(e.retryAfterSeconds()));
+        return resp;
+    } catch (const std::exception& e) {
+        gara::Logger::log_structured(spdlog::level::err, "Get tile error", {
+            {"endpoint", "/api/images/:id/tiles/image_files"},
+            {"image_id", image_id},
+            {"error", e.what()}
+        });
+        return createJsonError(500, "Internal server error. An error occurred while processing your request");
+    }
+}
+
+std::string ImageController::tilePrefix(const std::string& image_id) const {
+    bool watermarked = watermark_service_ && watermark_service_->isEnabled();
+    return "tiles/" + image_id + "/" + transform_config_.tiles.variant() + (watermarked ? "-wm" : "") + "/";
+}
+
+std::string ImageController::getOrCreateTiles(const std::string& image_id) {
+    std::string descriptor_key = tilePrefix(image_id) + "image.dzi";
+    if (file_service_->objectExists(descriptor_key)) {
+        return descriptor_key;
+    }
+
+    // One generation per pyramid; later requests wait on it
+    auto result = transform_flights_.run(descriptor_key, [this, &image_id, &descriptor_key]() {
+        if (file_service_->objectExists(descriptor_key)) {
+            return descriptor_key;
+        }
+
+        auto task = std::make_shared<std::packaged_task<std::string()>>(
+            [this, image_id]() { return createTiles(image_id); });
+        std::future<std::string> generated = task->get_future();
+        if (!transform_executor_->trySubmit(TransformPriority::LOW, [task]() { (*task)(); })) {
+            throw exceptions::ServiceUnavailableException("Transform queue is full",
+                                                          transform_config_.retry_after_seconds);
+        }
+        return generated.get();
+    });
+
+    if (!result) {
+        // Large originals can take longer than the coalescing timeout; the
+        // generation carries on and a retry finds the finished pyramid
+        throw exceptions::ServiceUnavailableException("Tile generation in progress",
+                                                      transform_config_.retry_after_seconds);
+    }
+    return *result;
+}
+
+std::string ImageController::createTiles(const std::string& image_id) {
+    auto start = std::chrono::steady_clock::now();
+    RawDownload raw = startRawDownload(image_id);
+    if (raw.raw_key.empty()) {
+        METRICS_COUNT("TileOperations", 1.0, "Count", {{"operation", "generate"}, {"status", "raw_not_found"}});
+        return "";
+    }
+
+    std::vector<char> downloaded;
+    utils::ByteView raw_data;
+    if (raw.mapped) {
+        raw_data = raw.mapped->view();
+    } else {
+        downloaded = raw.data.get();
+        raw_data = downloaded;
+    }
+    if (raw_data.empty()) {
+        METRICS_COUNT("TileOperations", 1.0, "Count", {{"operation", "generate"}, {"status", "download_error"}});
+        return "";
+    }
+
+    // dzsave writes a directory tree, so the pyramid is cut into a scratch directory first
+    std::filesystem::path output_dir = utils::FileUtils::createTempFile("gara_tiles_");
+    std::error_code ec;
+    std::filesystem::remove(output_dir, ec);
+    std::filesystem::create_directories(output_dir, ec);
+    struct ScratchDir {
+        std::filesystem::path path;
+        ~ScratchDir() {
+            std::error_code ignored;
+            std::filesystem::remove_all(path, ignored);
+        }
+    } scratch{output_dir};
+
+    {
+        // Every level is cut from the full-size decode, so admit the full-size cost
+        ResourceGovernor::Permit permit = governor_.admit(
+            estimateCost(raw_data, {{transform_config_.tiles.format, 0, 0, EncoderProfile()}}));
+        if (!image_processor_->generateTiles(raw_data, output_dir.string(), transform_config_.tiles,
+                                             watermarkStep())) {
+            METRICS_COUNT("TileOperations", 1.0, "Count", {{"operation", "generate"}, {"status", "error"}});
+            return "";
+        }
+    }
+
+    std::string prefix = tilePrefix(image_id);
+    std::string content_type = utils::FileUtils::getMimeType(transform_config_.tiles.extension());
+    std::vector<std::future<bool>> uploads;
+    for (const auto& entry : std::filesystem::recursive_directory_iterator(output_dir / "image_files")) {
+        if (!entry.is_regular_file()) {
+            continue;
+        }
+        std::string local_path = entry.path().string();
+        std::string key = prefix + std::filesystem::relative(entry.path(), output_dir).generic_string();
+        uploads.push_back(utils::IoExecutor::shared().submit([this, local_path, key, content_type]() {
+            return file_service_->uploadFile(local_path, key, content_type);
+        }));
+    }
+
+    bool uploaded = true;
+    for (auto& upload : uploads) {
+        uploaded = upload.get() && uploaded;
+    }
+
+    std::string descriptor_key = prefix + "image.dzi";
+    if (!uploaded ||
+        !file_service_->uploadFile((output_dir / "image.dzi").string(), descriptor_key, "application/xml")) {
+        gara::Logger::log_structured(spdlog::level::err, "Failed to upload tile pyramid", {
+            {"image_id", image_id},
+            {"tiles", uploads.size()}
+        });
+        METRICS_COUNT("TileOperations", 1.0, "Count", {{"operation", "generate"}, {"status", "upload_error"}});
+        return "";
+    }
+
+    auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    gara::Logger::log_structured(spdlog::level::info, "Generated tile pyramid", {
+        {"image_id", image_id},
+        {"tiles", uploads.size()},
+        {"prefix", prefix},
+        {"duration_ms", elapsed_ms}
+    });
+    METRICS_COUNT("TileOperations", 1.0, "Count", {{"operation", "generate"}, {"status", "success"}});
+    return descriptor_key;
+}
+
+crow::response ImageController::handleBulkUpload(const crow::request& req) {
+    try {
+        // Authenticate request against the active API keys
+        if (!middleware::AuthMiddleware::validateApiKey(req, *config_service_)) {
+            return createAuthError(req);
+        }
+
+        auto parts = utils::MultipartParser::findFileParts(req.body, req.get_header_value("Content-Type"));
+        if (parts.empty()) {
+            return createJsonError(400, "Failed to extract files from request. Please upload one or more image files");
+        }
+        const size_t max_files = static_cast<size_t>(transform_config_.ingest.max_files);
+        if (parts.size() > max_files) {
+            return createJsonError(413, "Too many files: at most " + std::to_string(max_files) + " per request");
+        }
+
+        // First file to finish hashing claims its content for the batch
+        std::mutex claims_mutex;
+        std::unordered_map<std::string, size_t> claims;  // image ID -> index of the file storing it
+
+        // Cheap checks run here; hashing, probing and storage writes overlap on the ingest pool
+        std::vector<std::string> rejections(parts.size());
+        std::vector<std::future<StagedUpload>> pending(parts.size());
+        for (size_t i = 0; i < parts.size(); ++i) {
+            const utils::MultipartFilePart& part = parts[i];
+            if (part.data.size() > MAX_UPLOAD_BYTES) {
+                rejections[i] = "File too large. Maximum file size is 100MB";
+                continue;
+            }
+            if (!utils::FileUtils::isValidImageFormat(utils::FileUtils::getFileExtension(part.filename)) ||
+                utils::FileUtils::detectImageFormat(part.data.data(), part.data.size()).empty()) {
+                rejections[i] = "Unsupported or unrecognised image file";
+                continue;
+            }
+            pending[i] = ingest_executor_->submit([this, &part, &claims_mutex, &claims, i]() {
+                return ingestFile(part.data, part.filename, [&claims_mutex, &claims, i](const std::string& image_id) {
+                    std::lock_guard<std::mutex> lock(claims_mutex);
+                    return claims.emplace(image_id, i).second;
+                });
+            });
+        }
+
+        // Every task is waited for before anything else can throw, since they reference parts and claims
+        std::vector<StagedUpload> staged(parts.size());
+        for (size_t i = 0; i < parts.size(); ++i) {
+            if (!pending[i].valid()) {
+                staged[i].status = StagedUploadStatus::INVALID;
+                continue;
+            }
+            try {
+                staged[i] = pending[i].get();
+            } catch (const std::exception& e) {
+                gara::Logger::log_structured(spdlog::level::err, "Bulk upload file failed", {
+                    {"filename", parts[i].filename},
+                    {"error", e.what()}
+                });
+            }
+        }
+
+        // A file coalesced into another file of the batch shares that file's outcome
+        for (size_t i = 0; i < staged.size(); ++i) {
+            auto claim = claims.find(staged[i].metadata.image_id);
+            if (staged[i].status == StagedUploadStatus::EXISTING && claim != claims.end() && claim->second != i) {
+                StagedUploadStatus leader = staged[claim->second].status;
+                if (leader == StagedUploadStatus::INVALID || leader == StagedUploadStatus::FAILED) {
+                    staged[i].status = leader;
+                }
+            }
+        }
+
+        json results = json::array();
+        size_t created = 0;
+        size_t duplicates = 0;
+        for (size_t i = 0; i < parts.size(); ++i) {
+            json result = {
+                {"filename", parts[i].filename},
+                {"size", parts[i].data.size()}
+            };
+            if (!staged[i].metadata.image_id.empty()) {
+                result["image_id"] = staged[i].metadata.image_id;
+            }
+            switch (staged[i].status) {
+                case StagedUploadStatus::STORED:
+                    result["status"] = "created";
+                    ++created;
+                    break;
+                case StagedUploadStatus::EXISTING:
+                    result["status"] = "duplicate";
+                    ++duplicates;
+                    break;
+                case StagedUploadStatus::INVALID:
+                    result["status"] = "invalid";
+                    result["error"] = rejections[i].empty() ? "Invalid image file" : rejections[i];
+                    break;
+                case StagedUploadStatus::FAILED:
+                    result["status"] = "error";
+                    result["error"] = "Failed to process and upload image";
+                    break;
+            }
+            results.push_back(std::move(result));
+        }
+
+        gara::Logger::log_structured(spdlog::level::info, "Bulk upload completed", {
+            {"files", parts.size()},
+            {"created", created},
+            {"duplicates", duplicates}
+        });
+        METRICS_COUNT("BulkUploadFiles", static_cast<double>(parts.size()), "Count", {{"endpoint", "/upload/bulk"}});
+        METRICS_COUNT("APIRequests", 1.0, "Count", {{"endpoint", "/upload/bulk"}, {"status", "success"}});
+
+        json response = {
+            {"results", results},
+            {"created", created},
+            {"duplicates", duplicates},
+            {"failed", parts.size() - created - duplicates},
+            {"count", parts.size()},
+            {"upload_timestamp", std::time(nullptr)}
+        };
+        crow::response resp(200, response.dump());
+        resp.add_header("Content-Type", "application/json");
+        addCorsHeaders(resp);
+        return resp;
+
+    } catch (const std::exception& e) {
+        gara::Logger::log_structured(spdlog::level::err, "Bulk upload error", {
+            {"endpoint", "/api/images/upload/bulk"},
+            {"error", e.what()}
+        });
+        METRICS_COUNT("APIRequests", 1.0, "Count", {{"endpoint", "/upload/bulk"}, {"status", "error"}});
+        return createJsonError(500, "Internal server error. An error occurred while processing your request");
+    }
+}
+
+crow::response ImageController::handleBatchGetImages(const crow::request& req) {
+    try {
+        json body = json::parse(req.body, nullptr, false);
+        if (body.is_discarded() || !body.is_object() || !body.contains("items") || !body["items"].is_array()) {
+            return createJsonError(400, "Invalid request body: expected an object with an \"items\" array");
+        }
+        const json& items = body["items"];
+        if (items.size() > ImageBatchConfig::MAX_ITEMS) {
+            return createJsonError(400, "Too many items: at most " +
+                                   std::to_string(ImageBatchConfig::MAX_ITEMS) + " per batch");
+        }
+
+        json results = json::array();
+        std::vector<TransformRequest> requests;
+        std::vector<size_t> result_index;  // Position in results for each request
+
+        for (const auto& item : items) {
+            if (!item.is_object() || !item.contains("image_id") || !item["image_id"].is_string()) {
+                results.push_back({{"status", "invalid"}, {"error", "Each item needs a string image_id"}});
+                continue;
+            }
+            std::string image_id = item["image_id"].get<std::string>();
+
+            // Batch items take the same parameters as the single-image query string
+            auto field = [&item](const char* name) -> std::string {
+                if (!item.contains(name) || item[name].is_null()) {
+                    return "";
+                }
+                return item[name].is_string() ? item[name].get<std::string>() : item[name].dump();
+            };
+            std::string format = field("format");
+            std::string width = field("width");
+            std::string height = field("height");
+            std::string quality = field("quality");
+            std::string profile = field("profile");
+
+            TransformParams params;
+            params.format = format.empty() ? nullptr : format.c_str();
+            params.width = width.empty() ? nullptr : width.c_str();
+            params.height = height.empty() ? nullptr : height.c_str();
+            params.quality = quality.empty() ? nullptr : quality.c_str();
+            params.profile = profile.empty() ? nullptr : profile.c_str();
+            params.accept = req.get_header_value("Accept");
+
+            std::string error_message;
+            auto request = buildTransformRequest(transform_config_, image_id, params, error_message);
+            if (!request) {
+                results.push_back({{"image_id", image_id}, {"status", "invalid"}, {"error", error_message}});
+                continue;
+            }
+            result_index.push_back(results.size());
+            results.push_back(nullptr);
+            requests.push_back(std::move(*request));
+        }
+
+        std::vector<bool> busy;
+        std::vector<std::string> keys = resolveTransformedBatch(requests, busy);
+        // Renditions whose upload has not landed have no usable URL yet
+        std::vector<bool> ready = cache_manager_->awaitUrls(keys);
+
+        size_t resolved = 0;
+        for (size_t i = 0; i < requests.size(); ++i) {
+            const TransformRequest& request = requests[i];
+            json& result = results[result_index[i]];
+            result = {
+                {"image_id", request.image_id},
+                {"format", request.target_format},
+                {"width", request.width},
+                {"height", request.height}
+            };
+            if (!keys[i].empty() && ready[i]) {
+                result["status"] = "ok";
+                result["url"] = file_service_->generatePresignedUrl(keys[i], IMAGE_URL_EXPIRATION_SECONDS);
+                result["expires_in"] = IMAGE_URL_EXPIRATION_SECONDS;
+                ++resolved;
+            } else if (busy[i] || !keys[i].empty()) {
+                result["status"] = "busy";
+                result["retry_after"] = transform_config_.retry_after_seconds;
+            } else {
+                result["status"] = "not_found";
+            }
+        }
+
+        METRICS_COUNT("BatchItems", static_cast<double>(items.size()), "Count", {{"endpoint", "/batch"}});
+        METRICS_COUNT("APIRequests", 1.0, "Count", {{"endpoint", "/batch"}, {"status", "success"}});
+
+        json response = {
+            {"results", results},
+            {"resolved", resolved},
+            {"count", results.size()}
+        };
+        crow::response resp(200, response.dump());
+        resp.add_header("Content-Type", "application/json");
+        addCorsHeaders(resp);
+        return resp;
+
+    } catch (const std::exception& e) {
+        gara::Logger::log_structured(spdlog::level::err, "Batch image error", {
+            {"endpoint", "/api/images/batch"},
+            {"error", e.what()}
+        });
+        METRICS_COUNT("APIRequests", 1.0, "Count", {{"endpoint", "/batch"}, {"status", "error"}});
+        return createJsonError(500, "Internal server error. An error occurred while processing your request");
+    }
+}
+
+crow::response ImageController::handleQueueRenderJobs(const crow::request& req) {
+    try {
+        if (!middleware::AuthMiddleware::validateApiKey(req, *config_service_)) {
+            return createAuthError(req);
+        }
+        if (!render_job_worker_) {
+            return createJsonError(503, "Render jobs are disabled. Set RENDER_JOBS_ENABLED=true");
+        }
+
+        json body = json::parse(req.body, nullptr, false);
+        if (body.is_discarded() || !body.is_object() || !body.contains("renditions") ||
+            !body["renditions"].is_array() || body["renditions"].empty()) {
+            return createJsonError(400, "Invalid request body: expected an object with a \"renditions\" array");
+        }
+        const json& items = body["renditions"];
+        if (items.size() > ImageBatchConfig::MAX_ITEMS) {
+            return createJsonError(400, "Too many renditions: at most " +
+                                   std::to_string(ImageBatchConfig::MAX_ITEMS) + " per request");
+        }
+
+        int priority = RenderJobPriority::BACKFILL;
+        if (body.contains("priority")) {
+            if (!body["priority"].is_number_integer()) {
+                return createJsonError(400, "Invalid priority: must be an integer");
+            }
+            priority = body["priority"].get<int>();
+        }
+
+        // Validated as GET would, so each job stores the rendition a GET with these parameters asks for
+        std::vector<RenderJob> renditions;
+        json queued = json::array();
+        for (const auto& item : items) {
+            if (!item.is_object()) {
+                return createJsonError(400, "Each rendition must be an object");
+            }
+            auto field = [&item](const char* name) -> std::string {
+                if (!item.contains(name) || item[name].is_null()) {
+                    return "";
+                }
+                return item[name].is_string() ? item[name].get<std::string>() : item[name].dump();
+            };
+            std::string format = field("format");
+            std::string width = field("width");
+            std::string height = field("height");
+            std::string quality = field("quality");
+            std::string profile = field("profile");
+
+            TransformParams params;
+            params.format = format.empty() ? nullptr : format.c_str();
+            params.width = width.empty() ? nullptr : width.c_str();
+            params.height = height.empty() ? nullptr : height.c_str();
+            params.quality = quality.empty() ? nullptr : quality.c_str();
+            params.profile = profile.empty() ? nullptr : profile.c_str();
+            params.accept = req.get_header_value("Accept");
+
+            std::string error_message;
+            auto request = buildTransformRequest(transform_config_, "", params, error_message);
+            if (!request) {
+                return createJsonError(400, error_message);
+            }
+
+            RenderJob rendition;
+            rendition.format = request->target_format;
+            rendition.width = request->width;
+            rendition.height = request->height;
+            rendition.quality = request->quality;
+            rendition.profile = profile;
+            queued.push_back({
+                {"format", rendition.format},
+                {"width", rendition.width},
+                {"height", rendition.height}
+            });
+            renditions.push_back(std::move(rendition));
+        }
+
+        if (!render_job_worker_->startBackfill(renditions, priority)) {
+            return createJsonError(409, "A render job backfill is already running");
+        }
+
+        gara::Logger::log_structured(spdlog::level::info, "Render job backfill started", {
+            {"renditions", renditions.size()},
+            {"priority", priority}
+        });
+        METRICS_COUNT("APIRequests", 1.0, "Count", {{"endpoint", "/render-jobs"}, {"status", "success"}});
+
+        json response = {
+            {"status", "started"},
+            {"renditions", queued},
+            {"priority", priority}
+        };
+        crow::response resp(202, response.dump());
+        resp.add_header("Content-Type", "application/json");
+        addCorsHeaders(resp);
+        return resp;
+
+    } catch (const std::exception& e) {
+        gara::Logger::log_structured(spdlog::level::err, "Render job queue error", {
+            {"endpoint", "/api/images/render-jobs"},
+            {"error", e.what()}
+        });
+        METRICS_COUNT("APIRequests", 1.0, "Count", {{"endpoint", "/render-jobs"}, {"status", "error"}});
+        return createJsonError(500, "Internal server error. An error occurred while processing your request");
+    }
+}
+
+crow::response ImageController::handleGetRenderJobs(const crow::request& req) {
+    try {
+        if (!middleware::AuthMiddleware::validateApiKey(req, *config_service_)) {
+            return createAuthError(req);
+        }
+
+        RenderJobCounts counts = db_client_->getRenderJobCounts(std::time(nullptr));
+        json response = {
+            {"enabled", render_job_worker_ != nullptr},
+            {"pending", counts.pending},
+            {"leased", counts.leased},
+            {"failed", counts.failed},
+            {"backfill_running", render_job_worker_ && render_job_worker_->backfillRunning()}
+        };
+        crow::response resp(200, response.dump());
+        resp.add_header("Content-Type", "application/json");
+        addCorsHeaders(resp);
+        return resp;
+
+    } catch (const std::exception& e) {
+        gara::Logger::log_structured(spdlog::level::err, "Render job status error", {
+            {"endpoint", "/api/images/render-jobs"},
+            {"error", e.what()}
+        });
+        return createJsonError(500, "Internal server error. An error occurred while processing your request");
+    }
+}
+
 crow::response ImageController::handleHealthCheck(const crow::request& req) {
     json response = {
         {"status", "healthy"},
@@ -156,48 +1006,90 @@ crow::response ImageController::handleHealthCheck(const crow::request& req) {
 }
 
 bool ImageController::extractUploadedFile(const crow::request& req,
-                                         std::vector<char>& file_data,
+                                         std::string_view& file_data,
                                          std::string& filename) {
-    // Parse multipart form data
-    crow::multipart::message msg(req);
-
-    for (const auto& part : msg.parts) {
-        auto it = part.headers.find("Content-Disposition");
-        if (it != part.headers.end()) {
-            const auto& disposition = it->second;
-
-            // Check if this part contains a file
-            auto filename_it = disposition.params.find("filename");
-            if (filename_it != disposition.params.end()) {
-                filename = filename_it->second;
-                file_data.assign(part.body.begin(), part.body.end());
-
-                // Validate file extension
-                std::string ext = utils::FileUtils::getFileExtension(filename);
-                if (!utils::FileUtils::isValidImageFormat(ext)) {
-                    return false;
-                }
+    // Scan multipart form data in place; the part body is not copied
+    auto part = utils::MultipartParser::findFilePart(req.body, req.get_header_value("Content-Type"));
+    if (!part) {
+        return false;
+    }
 
-                return true;
-            }
-        }
+    filename = part->filename;
+    file_data = part->data;
+
+    // Validate file extension
+    std::string ext = utils::FileUtils::getFileExtension(filename);
+    if (!utils::FileUtils::isValidImageFormat(ext)) {
+        return false;
+    }
+
+    // Validate header bytes before doing any work on the body
+    if (utils::FileUtils::detectImageFormat(file_data.data(), file_data.size()).empty()) {
+        gara::Logger::log_structured(spdlog::level::warn, "Upload rejected: unrecognised image header", {
+            {"filename", filename},
+            {"size_bytes", file_data.size()}
+        });
+        return false;
     }
 
-    return false;
+    return true;
+}
+
+std::optional<TransformRequest> ImageController::parseTransformParams(const crow::request& req,
+                                                                      const std::string& image_id,
+                                                                      std::string& error_message) {
+    // Parse query parameters
+    TransformParams params;
+    params.format = req.url_params.get("format");
+    params.width = req.url_params.get("width");
+    params.height = req.url_params.get("height");
+    params.quality = req.url_params.get("quality");
+    params.profile = req.url_params.get("profile");
+    params.accept = req.get_header_value("Accept");
+
+    return buildTransformRequest(transform_config_, image_id, params, error_message);
 }
 
-TransformRequest ImageController::parseTransformParams(const crow::request& req,
-                                                      const std::string& image_id) {
+std::optional<TransformRequest> ImageController::buildTransformRequest(const TransformConfig& config,
+                                                                       const std::string& image_id,
+                                                                       const TransformParams& params,
+                                                                       std::string& error_message) {
     TransformRequest transform_req;
     transform_req.image_id = image_id;
 
-    // Parse query parameters
-    auto format_param = req.url_params.get("format");
-    auto width_param = req.url_params.get("width");
-    auto height_param = req.url_params.get("height");
+    const char* format_param = params.format;
+    const char* width_param = params.width;
+    const char* height_param = params.height;
+    const char* quality_param = params.quality;
+    const char* profile_param = params.profile;
 
-    // Set format (default: jpeg)
+    // Quality and profile change the output bytes, so they are validated
+    // rather than silently defaulted
+    if (quality_param) {
+        try {
+            transform_req.quality = std::stoi(quality_param);
+        } catch (const std::exception&) {
+            transform_req.quality = -1;
+        }
+        if (transform_req.quality < 1 || transform_req.quality > 100) {
+            error_message = "Invalid quality parameter: must be an integer between 1 and 100";
+            return std::nullopt;
+        }
+    }
+
+    std::string profile_name = profile_param ? std::string(profile_param)
+                                             : config.encoder.default_profile;
+    if (!config.encoder.find(profile_name)) {
+        error_message = "Invalid profile parameter: unknown encoder profile '" + profile_name + "'";
+        return std::nullopt;
+    }
+    transform_req.encoder_profile = profileKeySegment(profile_name);
+
+    // Set format (default: jpeg); "auto" picks the best format the client accepts
     transform_req.target_format = format_param ? std::string(format_param) : "jpeg";
+    if (transform_req.target_format == utils::FormatNegotiation::AUTO_FORMAT) {
+        transform_req.target_format = utils::FormatNegotiation::negotiate(params.accept);
+    }
 
     // Set dimensions (default: 0 for original)
     const int MAX_DIMENSION = 10000;  // Reasonable maximum to prevent resource exhaustion
@@ -224,13 +1116,123 @@ TransformRequest ImageController::parseTransformParams(const crow::request& req,
         transform_req.height = 0;
     }
 
+    // Snap to the size ladder before the cache key is built, so arbitrary
+    // sizes cannot each create a new rendition
+    int requested_width = transform_req.width;
+    int requested_height = transform_req.height;
+    const SizeLadder& ladder = config.size_ladder;
+    if (!ladder.apply(transform_req.width) || !ladder.apply(transform_req.height)) {
+        METRICS_COUNT("TransformSizePolicy", 1.0, "Count", {{"result", "rejected"}});
+        error_message = "Unsupported dimensions: width and height must be 0 or one of " + ladder.describe();
+        return std::nullopt;
+    }
+    if (transform_req.width != requested_width || transform_req.height != requested_height) {
+        METRICS_COUNT("TransformSizePolicy", 1.0, "Count", {{"result", "snapped"}});
+    }
+
     return transform_req;
 }
 
-std::string ImageController::processUpload(const std::vector<char>& file_data,
+std::string ImageController::profileKeySegment(const std::string& profile_name) {
+    return profile_name == EncoderConfig::BASELINE_PROFILE ? "" : profile_name;
+}
+
+EncoderProfile ImageController::encoderFor(const TransformRequest& request) const {
+    return transform_config_.encoder.resolve(request.encoder_profile, request.quality);
+}
+
+std::string ImageController::spoolUpload(std::string_view file_data, const std::string& filename,
+                                        utils::TempFile& temp_file) {
+    utils::Sha256Hasher hasher;
+    std::ofstream out(temp_file.getPath(), std::ios::binary);
+    for (size_t offset = 0; out && offset < file_data.size(); offset += UPLOAD_CHUNK_SIZE) {
+        size_t chunk = std::min(UPLOAD_CHUNK_SIZE, file_data.size() - offset);
+        hasher.update(file_data.data() + offset, chunk);
+        out.write(file_data.data() + offset, static_cast<std::streamsize>(chunk));
+    }
+    if (!out) {
+        gara::Logger::log_structured(spdlog::level::err, "Failed to write temporary file for upload", {
+            {"filename", filename},
+            {"size_bytes", file_data.size()}
+        });
+        METRICS_COUNT("UploadOperations", 1.0, "Count", {{"status", "temp_file_error"}});
+        return "";
+    }
+    return hasher.finalizeHex();
+}
+
+std::string ImageController::processUpload(std::string_view file_data,
                                           const std::string& filename) {
-    // Calculate hash (image ID)
-    std::string image_id = utils::FileUtils::calculateSHA256(file_data);
+    // Hash (image ID) and spool to a temp file in one chunked pass
+    utils::TempFile temp_file("upload_");
+    std::string image_id = spoolUpload(file_data, filename, temp_file);
+    if (image_id.empty()) {
+        return "";
+    }
+
+    StagedUpload staged = coalesceUpload(image_id, temp_file, file_data, filename);
+    bool stored = staged.status == StagedUploadStatus::STORED || staged.status == StagedUploadStatus::EXISTING;
+    return stored ? image_id : "";
+}
+
+StagedUpload ImageController::coalesceUpload(const std::string& image_id, utils::TempFile& temp_file,
+                                             std::string_view file_data, const std::string& filename) {
+    // Concurrent uploads of the same bytes share one validate, upload and
+    // metadata write; duplicates get the leader's image ID
+    StagedUpload staged;
+    bool led = false;
+    auto work = [&]() {
+        led = true;
+        staged = storeUpload(image_id, temp_file, file_data, filename);
+        bool stored = staged.status == StagedUploadStatus::STORED || staged.status == StagedUploadStatus::EXISTING;
+        return stored ? image_id : std::string();
+    };
+    auto result = upload_flights_.run(image_id, work);
+    if (!result) {
+        gara::Logger::log_structured(spdlog::level::warn, "Timed out waiting for concurrent upload", {
+            {"image_id", image_id},
+            {"size_bytes", file_data.size()}
+        });
+        work();
+        return staged;
+    }
+    if (!led) {
+        METRICS_COUNT("UploadOperations", 1.0, "Count", {{"status", "coalesced"}});
+        staged.metadata.image_id = image_id;
+        staged.status = result->empty() ? StagedUploadStatus::FAILED : StagedUploadStatus::EXISTING;
+    }
+    return staged;
+}
+
+StagedUpload ImageController::storeUpload(const std::string& image_id, utils::TempFile& temp_file,
+                                          std::string_view file_data, const std::string& filename) {
+    StagedUpload staged = stageUpload(image_id, temp_file, file_data, filename);
+    if (staged.status != StagedUploadStatus::STORED) {
+        return staged;
+    }
+
+    // Store metadata in database (fail upload if metadata storage fails for consistency).
+    // The object was written by this flight, so no other upload relies on it yet
+    if (!storeImageMetadata(staged.metadata)) {
+        // Attempt to clean up uploaded file
+        file_service_->deleteObject(staged.metadata.s3_raw_key);
+        gara::Logger::log_structured(spdlog::level::err, "Upload rolled back due to metadata storage failure", {
+            {"image_id", image_id},
+            {"s3_key", staged.metadata.s3_raw_key}
+        });
+        METRICS_COUNT("UploadOperations", 1.0, "Count", {{"status", "metadata_storage_error"}});
+        staged.status = StagedUploadStatus::FAILED;
+        return staged;
+    }
+
+    finishUpload(staged.metadata, file_data);
+    return staged;
+}
+
+StagedUpload ImageController::stageUpload(const std::string& image_id, utils::TempFile& temp_file,
+                                          std::string_view file_data, const std::string& filename) {
+    StagedUpload staged;
+    staged.metadata.image_id = image_id;
 
     // Get file extension
     std::string extension = utils::FileUtils::getFileExtension(filename);
@@ -239,117 +1241,595 @@ std::string ImageController::processUpload(const std::vector<char>& file_data,
     std::string s3_key = ImageMetadata::generateRawKey(image_id, extension);
 
     // Check if already uploaded (deduplication)
-    if (file_service_->objectExists(s3_key)) {
-        gara::Logger::log_structured(spdlog::level::info, "Image already exists (deduplicated)", {
-            {"image_id", image_id},
-            {"s3_key", s3_key},
-            {"size_bytes", file_data.size()}
-        });
-        METRICS_COUNT("UploadOperations", 1.0, "Count", {{"status", "deduplicated"}});
-        return image_id;
-    }
-
-    // Create temporary file
-    utils::TempFile temp_file("upload_");
-    if (!temp_file.write(file_data)) {
-        gara::Logger::log_structured(spdlog::level::err, "Failed to write temporary file for upload", {
+    if (file_service_->objectExists(s3_key)) {
+        gara::Logger::log_structured(spdlog::level::info, "Image already exists (deduplicated)", {
             {"image_id", image_id},
+            {"s3_key", s3_key},
             {"size_bytes", file_data.size()}
         });
-        METRICS_COUNT("UploadOperations", 1.0, "Count", {{"status", "temp_file_error"}});
-        return "";
+        METRICS_COUNT("UploadOperations", 1.0, "Count", {{"status", "deduplicated"}});
+        staged.status = StagedUploadStatus::EXISTING;
+        return staged;
     }
 
-    // Validate image
-    if (!image_processor_->isValidImage(temp_file.getPath())) {
+    // Validate image and read its dimensions with a single header probe
+    ImageInfo img_info = image_processor_->getImageInfo(temp_file.getPath());
+    if (!img_info.is_valid) {
         gara::Logger::log_structured(spdlog::level::err, "Invalid image file uploaded", {
             {"image_id", image_id},
             {"filename", filename},
             {"extension", extension}
         });
         METRICS_COUNT("UploadOperations", 1.0, "Count", {{"status", "invalid_image"}});
-        return "";
+        staged.status = StagedUploadStatus::INVALID;
+        return staged;
     }
 
-    // Get image information (dimensions)
-    ImageInfo img_info = image_processor_->getImageInfo(temp_file.getPath());
+    // Read while the file is still local; an image without one still uploads
+    std::string placeholder = image_processor_->computePlaceholder(temp_file.getPath());
 
     // Upload to S3
     std::string content_type = utils::FileUtils::getMimeType(extension);
-    if (!file_service_->uploadFile(temp_file.getPath(), s3_key, content_type)) {
+    if (!file_service_->moveFileToStorage(temp_file.getPath(), s3_key, content_type)) {
         gara::Logger::log_structured(spdlog::level::err, "Failed to upload image to S3", {
             {"image_id", image_id},
             {"s3_key", s3_key},
             {"content_type", content_type}
         });
         METRICS_COUNT("UploadOperations", 1.0, "Count", {{"status", "s3_upload_error"}});
-        return "";
+        return staged;
     }
+    temp_file.release();
 
-    // Store metadata in database (fail upload if metadata storage fails for consistency)
-    if (!storeImageMetadata(image_id, filename, extension, file_data.size(), img_info)) {
-        // Attempt to clean up uploaded file
-        file_service_->deleteObject(s3_key);
-        gara::Logger::log_structured(spdlog::level::err, "Upload rolled back due to metadata storage failure", {
-            {"image_id", image_id},
-            {"s3_key", s3_key}
-        });
-        METRICS_COUNT("UploadOperations", 1.0, "Count", {{"status", "metadata_storage_error"}});
-        return "";
+    staged.status = StagedUploadStatus::STORED;
+    staged.metadata = buildImageMetadata(image_id, filename, extension, file_data.size(), img_info, placeholder);
+    return staged;
+}
+
+StagedUpload ImageController::ingestFile(std::string_view file_data, const std::string& filename,
+                                         const std::function<bool(const std::string&)>& claim) {
+    utils::TempFile temp_file("upload_");
+    std::string image_id = spoolUpload(file_data, filename, temp_file);
+    if (image_id.empty()) {
+        return StagedUpload();
+    }
+
+    // The file that claimed this content first stores it for the whole batch
+    if (!claim(image_id)) {
+        METRICS_COUNT("UploadOperations", 1.0, "Count", {{"status", "coalesced"}});
+        StagedUpload staged;
+        staged.status = StagedUploadStatus::EXISTING;
+        staged.metadata.image_id = image_id;
+        return staged;
     }
+    // Coalesced with uploads of other requests, and committed on its own like /upload
+    return coalesceUpload(image_id, temp_file, file_data, filename);
+}
 
+void ImageController::finishUpload(const ImageMetadata& metadata, std::string_view file_data) {
     gara::Logger::log_structured(spdlog::level::info, "Image uploaded successfully", {
-        {"image_id", image_id},
-        {"s3_key", s3_key},
+        {"image_id", metadata.image_id},
+        {"s3_key", metadata.s3_raw_key},
         {"size_bytes", file_data.size()},
-        {"content_type", content_type},
-        {"width", img_info.width},
-        {"height", img_info.height}
+        {"content_type", utils::FileUtils::getMimeType(metadata.original_format)},
+        {"width", metadata.width},
+        {"height", metadata.height}
     });
+    raw_key_resolver_->remember(metadata.image_id, metadata.s3_raw_key);
     METRICS_COUNT("UploadOperations", 1.0, "Count", {{"status", "success"}});
-    return image_id;
+    schedulePregeneration(metadata.image_id, file_data);
+}
+
+void ImageController::schedulePregeneration(const std::string& image_id, std::string_view file_data) {
+    const auto& profiles = transform_config_.pregenerate_renditions;
+    if (profiles.empty()) {
+        return;
+    }
+
+    if (render_job_worker_) {
+        // Queued in the database so neither a full pool nor a restart loses
+        // them; the worker fetches the original again when it gets to them
+        std::time_t now = std::time(nullptr);
+        std::vector<RenderJob> jobs;
+        for (const auto& profile : profiles) {
+            RenderJob job;
+            job.image_id = image_id;
+            job.format = profile.format;
+            job.width = profile.width;
+            job.height = profile.height;
+            job.priority = RenderJobPriority::PREGENERATE;
+            job.run_after = now;
+            jobs.push_back(std::move(job));
+        }
+        bool enqueued = db_client_->enqueueRenderJobs(jobs);
+        if (!enqueued) {
+            gara::Logger::log_structured(spdlog::level::warn, "Failed to queue rendition pre-generation", {
+                {"image_id", image_id},
+                {"renditions", profiles.size()}
+            });
+        }
+        METRICS_COUNT("RenditionPregeneration", static_cast<double>(jobs.size()), "Count",
+                     {{"status", enqueued ? "queued" : "skipped"}});
+        return;
+    }
+
+    // The request body goes away with the request, so the task keeps its own copy
+    auto raw_data = std::make_shared<std::vector<char>>(file_data.begin(), file_data.end());
+
+    // Low lane: on-demand renditions for viewers take priority over speculative ones
+    bool queued = transform_executor_->trySubmit(TransformPriority::LOW, [this, image_id, raw_data]() {
+        // Skip renditions a GET already produced while the task was queued
+        std::vector<TransformRequest> pending;
+        for (const auto& profile : transform_config_.pregenerate_renditions) {
+            // Same key a GET with these parameters computes
+            TransformRequest request(image_id, profile.format, profile.width, profile.height);
+            request.encoder_profile = profileKeySegment(transform_config_.encoder.default_profile);
+            if (cache_manager_->getCachedImage(request).empty()) {
+                pending.push_back(std::move(request));
+            }
+        }
+        if (pending.empty()) {
+            return;
+        }
+
+        std::vector<std::optional<std::string>> keys;
+        try {
+            keys = renderAndStore(pending, *raw_data);
+        } catch (const exceptions::ServiceUnavailableException&) {
+            // Renditions will be generated on first request instead
+            METRICS_COUNT("RenditionPregeneration", 1.0, "Count", {{"status", "skipped"}});
+            return;
+        }
+        for (const auto& key : keys) {
+            if (key) {
+                METRICS_COUNT("RenditionPregeneration", 1.0, "Count",
+                             {{"status", key->empty() ? "error" : "success"}});
+            }
+        }
+    });
+
+    if (!queued) {
+        // Renditions will be generated on first request instead
+        gara::Logger::log_structured(spdlog::level::warn, "Transform queue full, skipping rendition pre-generation", {
+            {"image_id", image_id},
+            {"renditions", profiles.size()}
+        });
+        METRICS_COUNT("RenditionPregeneration", 1.0, "Count", {{"status", "skipped"}});
+    }
+}
+
+std::vector<std::optional<std::string>> ImageController::renderAndStore(const std::vector<TransformRequest>& requests,
+                                                                       utils::ByteView raw_data) {
+    std::vector<RenditionTarget> targets;
+    targets.reserve(requests.size());
+    for (const auto& request : requests) {
+        targets.push_back({request.target_format, request.width, request.height, encoderFor(request)});
+    }
+
+    // One decode feeds every rendition; the largest output bounds the cost
+    std::vector<std::vector<char>> outputs;
+    {
+        ResourceGovernor::Permit permit = governor_.admit(estimateCost(raw_data, targets));
+        outputs = image_processor_->transformBufferMany(raw_data, targets, watermarkStep());
+    }
+
+    std::vector<std::optional<std::string>> keys(requests.size());
+    for (size_t i = 0; i < requests.size(); ++i) {
+        const TransformRequest& request = requests[i];
+        // A GET arriving meanwhile waits on this flight; one already in flight is left to finish
+        keys[i] = transform_flights_.tryRun(request.getCacheKey(), [this, &request, raw_data, &outputs, i]() {
+            std::string cached_key = cache_manager_->getCachedImage(request);
+            if (!cached_key.empty()) {
+                return cached_key;
+            }
+            // Failed outputs retry alone, which also covers the watermark fallback
+            return outputs[i].empty()
+                ? transformAndStore(request, raw_data)
+                : storeTransformed(request, outputs[i]);
+        });
+    }
+    return keys;
+}
+
+std::optional<TransformRequest> ImageController::renderJobRequest(const RenderJob& job,
+                                                                  std::string& error_message) const {
+    // Jobs hold parameters validated when they were queued; only settings
+    // changed since then can make them invalid
+    std::string profile_name = job.profile.empty() ? transform_config_.encoder.default_profile : job.profile;
+    if (!transform_config_.encoder.find(profile_name)) {
+        error_message = "Unknown encoder profile '" + profile_name + "'";
+        return std::nullopt;
+    }
+    if (job.quality < 0 || job.quality > 100) {
+        error_message = "Invalid quality " + std::to_string(job.quality);
+        return std::nullopt;
+    }
+
+    TransformRequest request(job.image_id, job.format, job.width, job.height);
+    request.quality = job.quality;
+    request.encoder_profile = profileKeySegment(profile_name);
+    return request;
+}
+
+std::vector<RenderJobResult> ImageController::runRenderJobs(const std::string& image_id,
+                                                            const std::vector<RenderJob>& jobs) {
+    std::vector<RenderJobResult> results(jobs.size());
+    std::vector<TransformRequest> pending;
+    std::vector<size_t> pending_index;  // Job position of each pending request
+
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        std::string error_message;
+        auto request = renderJobRequest(jobs[i], error_message);
+        if (!request) {
+            results[i] = {RenderJobOutcome::FAILED, error_message};
+            continue;
+        }
+        // Already produced by a GET or an earlier attempt
+        if (!cache_manager_->getCachedImage(*request).empty()) {
+            results[i].outcome = RenderJobOutcome::DONE;
+            continue;
+        }
+        pending_index.push_back(i);
+        pending.push_back(std::move(*request));
+    }
+    if (pending.empty()) {
+        return results;
+    }
+
+    auto fail_pending = [&results, &pending_index](RenderJobOutcome outcome, const std::string& error) {
+        for (size_t index : pending_index) {
+            results[index] = {outcome, error};
+        }
+        return results;
+    };
+
+    RawDownload raw = startRawDownload(image_id);
+    if (raw.raw_key.empty()) {
+        return fail_pending(RenderJobOutcome::FAILED, "Image not found");
+    }
+
+    // Low lane, like pre-generation; the worker only claims jobs while the pool has room
+    auto task = std::make_shared<std::packaged_task<std::vector<std::optional<std::string>>()>>(
+        [this, &pending, raw = std::move(raw)]() mutable {
+            std::vector<char> downloaded;
+            utils::ByteView raw_data;
+            if (raw.mapped) {
+                raw_data = raw.mapped->view();
+            } else {
+                downloaded = raw.data.get();
+                raw_data = downloaded;
+            }
+            if (raw_data.empty()) {
+                throw std::runtime_error("Failed to download raw image");
+            }
+            return renderAndStore(pending, raw_data);
+        });
+    auto rendered = task->get_future();
+    if (!transform_executor_->trySubmit(TransformPriority::LOW, [task]() { (*task)(); })) {
+        return fail_pending(RenderJobOutcome::RETRY, "Transform queue is full");
+    }
+
+    // Download, governor and pool errors propagate and retry the whole image
+    std::vector<std::optional<std::string>> keys = rendered.get();
+    for (size_t i = 0; i < keys.size(); ++i) {
+        RenderJobResult& result = results[pending_index[i]];
+        if (!keys[i]) {
+            result = {RenderJobOutcome::RETRY, "Rendition is being generated by another request"};
+        } else if (keys[i]->empty()) {
+            result = {RenderJobOutcome::RETRY, "Transform failed"};
+        } else {
+            result.outcome = RenderJobOutcome::DONE;
+        }
+    }
+    return results;
 }
 
-std::string ImageController::getOrCreateTransformed(const TransformRequest& request) {
+std::string ImageController::getOrCreateTransformed(const TransformRequest& request, bool forward) {
     // Start timing the operation
     auto timer = gara::Metrics::get()->start_timer("ImageTransformDuration");
 
     // Check cache first
-    std::string cached_key = cache_manager_->getCachedImage(request);
+    std::string cached_key;
+    {
+        TRACE_SPAN("cache");
+        cached_key = cache_manager_->getCachedImage(request);
+    }
     if (!cached_key.empty()) {
-        gara::Logger::log_structured(spdlog::level::info, "Cache hit", {
+        LOG_STRUCTURED_SAMPLED(spdlog::level::info, "Cache hit", {
             {"cache_key", cached_key},
             {"image_id", request.image_id},
             {"operation", "transform"}
         });
         METRICS_COUNT("CacheHits", 1.0, "Count", {{"operation", "transform"}});
+        static auto& prometheus_hits = PrometheusRegistry::instance().counter(
+            "gara_transform_cache_requests_total", "Rendition cache lookups by result", {{"result", "hit"}});
+        prometheus_hits.inc();
         return cached_key;
     }
 
-    gara::Logger::log_structured(spdlog::level::info, "Cache miss - transforming image", {
+    LOG_STRUCTURED_SAMPLED(spdlog::level::info, "Cache miss - transforming image", {
         {"image_id", request.image_id},
         {"width", request.width},
         {"height", request.height},
         {"format", request.target_format}
     });
     METRICS_COUNT("CacheMisses", 1.0, "Count", {{"operation", "transform"}});
+    static auto& prometheus_misses = PrometheusRegistry::instance().counter(
+        "gara_transform_cache_requests_total", "Rendition cache lookups by result", {{"result", "miss"}});
+    prometheus_misses.inc();
+
+    // Misses cost the client more than hits and hold one of its transform slots
+    utils::RateLimiter::TransformPermit permit = utils::RateLimiter::admitTransform();
+
+    // Concurrent misses for the same transformation share one download/transform/upload
+    TRACE_SPAN("transform");
+    auto result = transform_flights_.run(request.getCacheKey(), [this, &request, forward]() {
+        if (forward) {
+            if (auto forwarded = forwardTransform(request)) {
+                return *forwarded;
+            }
+        }
+        return runTransformTask(request);
+    });
+
+    if (!result) {
+        gara::Logger::log_structured(spdlog::level::warn, "Timed out waiting for in-flight transformation", {
+            {"image_id", request.image_id},
+            {"cache_key", request.getCacheKey()},
+            {"timeout_ms", transform_config_.coalesce_timeout_ms}
+        });
+        METRICS_COUNT("TransformOperations", 1.0, "Count", {{"status", "coalesce_timeout"}});
+        return "";
+    }
+
+    return *result;
+}
+
+std::optional<std::string> ImageController::forwardTransform(const TransformRequest& request) {
+    if (!peer_pool_) {
+        return std::nullopt;
+    }
+    std::string owner = peer_pool_->ownerOf(request.getCacheKey());
+    if (owner.empty()) {
+        return std::nullopt;
+    }
+
+    static auto& forwarded_ok = PrometheusRegistry::instance().counter(
+        "gara_peer_requests_total", "Rendition misses sent to the owning peer by result", {{"result", "ok"}});
+    static auto& forwarded_not_found = PrometheusRegistry::instance().counter(
+        "gara_peer_requests_total", "Rendition misses sent to the owning peer by result", {{"result", "not_found"}});
+    static auto& forwarded_busy = PrometheusRegistry::instance().counter(
+        "gara_peer_requests_total", "Rendition misses sent to the owning peer by result", {{"result", "busy"}});
+    static auto& forwarded_error = PrometheusRegistry::instance().counter(
+        "gara_peer_requests_total", "Rendition misses sent to the owning peer by result", {{"result", "error"}});
+
+    PeerPool::Response response;
+    {
+        TRACE_SPAN("peer");
+        response = peer_pool_->get(owner, peerRenditionPath(request, false));
+    }
+
+    if (response.status == 200) {
+        json body = json::parse(response.body, nullptr, false);
+        if (body.is_object() && body.contains("key") && body["key"].is_string()) {
+            forwarded_ok.inc();
+            return body["key"].get<std::string>();
+        }
+    } else if (response.status == 404) {
+        forwarded_not_found.inc();
+        return std::string();
+    } else if (response.status == 503) {
+        // The owner is out of capacity; transforming here as well would only add load
+        forwarded_busy.inc();
+        throw exceptions::ServiceUnavailableException("Owning peer is busy",
+            response.retry_after_seconds > 0 ? response.retry_after_seconds : transform_config_.retry_after_seconds);
+    }
+
+    forwarded_error.inc();
+    gara::Logger::log_structured(spdlog::level::warn, "Peer could not produce rendition, transforming locally", {
+        {"image_id", request.image_id},
+        {"cache_key", request.getCacheKey()},
+        {"peer", owner},
+        {"status", response.status}
+    });
+    return std::nullopt;
+}
+
+std::optional<std::string> ImageController::fetchPeerRendition(const TransformRequest& request) {
+    if (!peer_pool_) {
+        return std::nullopt;
+    }
+    std::string owner = peer_pool_->ownerOf(request.getCacheKey());
+    if (owner.empty()) {
+        return std::nullopt;
+    }
+
+    PeerPool::Response response = peer_pool_->get(owner, peerRenditionPath(request, true));
+    if (response.status != 200) {
+        return std::nullopt;
+    }
+    return std::move(response.body);
+}
+
+std::string ImageController::peerRenditionPath(const TransformRequest& request, bool inline_body) {
+    // The owner rebuilds the request from the same parameters through
+    // buildTransformRequest and checks that it arrives at the same key
+    std::string profile = request.encoder_profile.empty() ? EncoderConfig::BASELINE_PROFILE
+                                                          : request.encoder_profile;
+    std::string path = "/internal/peer/renditions/" + utils::SigV4::uriEncode(request.image_id) +
+                       "?format=" + utils::SigV4::uriEncode(request.target_format) +
+                       "&width=" + std::to_string(request.width) +
+                       "&height=" + std::to_string(request.height) +
+                       "&profile=" + utils::SigV4::uriEncode(profile) +
+                       "&key=" + utils::SigV4::uriEncode(request.getCacheKey());
+    if (request.quality > 0) {
+        path += "&quality=" + std::to_string(request.quality);
+    }
+    if (inline_body) {
+        path += "&inline=1";
+    }
+    return path;
+}
+
+std::string ImageController::runTransformTask(const TransformRequest& request) {
+    TransformPriority priority = TransformExecutor::classify(
+        request.width, request.height,
+        transform_config_.small_max_pixels, transform_config_.large_min_pixels);
+
+    // Fetch the original while the task waits for a worker, so the worker
+    // goes straight to decoding instead of blocking on storage
+    RawDownload raw = startRawDownload(request.image_id);
+    // The worker records its stages into this request's trace
+    auto queued_at = utils::RequestTrace::Clock::now();
+    auto task = std::make_shared<std::packaged_task<std::string()>>(
+        [this, request, priority, raw = std::move(raw),
+         trace = utils::RequestTrace::current(), queued_at]() mutable {
+            utils::RequestTrace::Scope scope(trace);
+            if (trace) {
+                trace->addSpan("queue", queued_at, utils::RequestTrace::Clock::now());
+            }
+            return timedCreateTransformed(request, priority, std::move(raw));
+        });
+    std::future<std::string> result = task->get_future();
+
+    if (!transform_executor_->trySubmit(priority, [task]() { (*task)(); })) {
+        gara::Logger::log_structured(spdlog::level::warn, "Transform queue full, shedding request", {
+            {"image_id", request.image_id},
+            {"queue_depth", transform_executor_->queueDepth()}
+        });
+        throw exceptions::ServiceUnavailableException("Transform queue is full",
+                                                      transform_config_.retry_after_seconds);
+    }
+
+    return result.get();
+}
+
+std::string ImageController::timedCreateTransformed(const TransformRequest& request,
+                                                    TransformPriority priority,
+                                                    RawDownload raw) {
+    auto& registry = PrometheusRegistry::instance();
+    static auto& in_flight = registry.gauge(
+        "gara_transforms_in_flight", "Transforms currently running on the worker pool");
+    auto& latency = registry.histogram(
+        "gara_transform_duration_seconds", "Rendition transform latency by format and size",
+        TRANSFORM_LATENCY_BUCKETS, {
+            {"format", request.target_format},
+            {"size", sizeBucket(priority)}
+        });
+
+    in_flight.inc();
+    auto start = std::chrono::steady_clock::now();
+    std::string key;
+    try {
+        key = createTransformed(request, std::move(raw));
+    } catch (...) {
+        in_flight.dec();
+        throw;
+    }
+    in_flight.dec();
+    latency.observe(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    return key;
+}
+
+std::vector<std::string> ImageController::resolveTransformedBatch(const std::vector<TransformRequest>& requests,
+                                                                  std::vector<bool>& busy) {
+    std::vector<std::string> keys = cache_manager_->getCachedImages(requests);
+    busy.assign(requests.size(), false);
+
+    struct PendingTransform {
+        size_t index;
+        std::future<std::optional<std::string>> key;
+    };
+    std::vector<PendingTransform> pending;
+    std::unordered_map<std::string, size_t> first_miss;  // Duplicate items share one transform
+    std::vector<std::pair<size_t, size_t>> duplicates;
+
+    // Queue every miss before waiting on any, so they run side by side
+    for (size_t i = 0; i < requests.size(); ++i) {
+        if (!keys[i].empty()) {
+            continue;
+        }
+        const TransformRequest& request = requests[i];
+        auto [it, inserted] = first_miss.try_emplace(request.getCacheKey(), i);
+        if (!inserted) {
+            duplicates.emplace_back(i, it->second);
+            continue;
+        }
+        if (!utils::RateLimiter::chargeMisses(1)) {
+            busy[i] = true;
+            continue;
+        }
 
-    // Download raw image
-    std::string raw_key = "raw/" + request.image_id + ".*";
+        TransformPriority priority = TransformExecutor::classify(
+            request.width, request.height,
+            transform_config_.small_max_pixels, transform_config_.large_min_pixels);
+        auto task = std::make_shared<std::packaged_task<std::optional<std::string>()>>(
+            [this, request, priority]() {
+                // Never wait inside a worker: a GET already transforming this key finishes it
+                return transform_flights_.tryRun(request.getCacheKey(), [this, &request, priority]() {
+                    return timedCreateTransformed(request, priority);
+                });
+            });
+        std::future<std::optional<std::string>> key = task->get_future();
 
-    // We need to find the actual raw image (we stored it with original extension)
-    // For now, try common extensions
-    std::vector<std::string> extensions = {"jpg", "jpeg", "png", "gif", "bmp", "tiff", "webp"};
-    std::string found_raw_key;
+        if (!transform_executor_->trySubmit(priority, [task]() { (*task)(); })) {
+            busy[i] = true;
+            continue;
+        }
+        pending.push_back({i, std::move(key)});
+    }
 
-    for (const auto& ext : extensions) {
-        std::string test_key = ImageMetadata::generateRawKey(request.image_id, ext);
-        if (file_service_->objectExists(test_key)) {
-            found_raw_key = test_key;
-            break;
+    for (auto& transform : pending) {
+        try {
+            std::optional<std::string> key = transform.key.get();
+            if (!key) {
+                // Joined a transform already in flight; waiting is safe on this thread
+                key = getOrCreateTransformed(requests[transform.index]);
+            }
+            keys[transform.index] = *key;
+        } catch (const exceptions::ServiceUnavailableException&) {
+            busy[transform.index] = true;
+        } catch (const std::exception& e) {
+            gara::Logger::log_structured(spdlog::level::err, "Batch transform failed", {
+                {"image_id", requests[transform.index].image_id},
+                {"error", e.what()}
+            });
         }
     }
 
+    for (const auto& [index, original] : duplicates) {
+        keys[index] = keys[original];
+        busy[index] = busy[original];
+    }
+
+    return keys;
+}
+
+RawDownload ImageController::startRawDownload(const std::string& image_id) {
+    RawDownload raw;
+    // Raw image is stored under its original extension, recorded in the image metadata
+    {
+        TRACE_SPAN("raw");
+        raw.raw_key = raw_key_resolver_->resolve(image_id);
+    }
+    raw.resolved = true;
+    if (raw.raw_key.empty()) {
+        return raw;
+    }
+    // Local storage is decoded straight from the stored file, with no copy
+    raw.mapped = file_service_->mapObject(raw.raw_key);
+    if (!raw.mapped) {
+        raw.data = file_service_->downloadDataAsync(raw.raw_key);
+    }
+    return raw;
+}
+
+std::string ImageController::createTransformed(const TransformRequest& request, RawDownload raw) {
+    if (!raw.resolved) {
+        raw = startRawDownload(request.image_id);
+    }
+    const std::string& found_raw_key = raw.raw_key;
+
     if (found_raw_key.empty()) {
         gara::Logger::log_structured(spdlog::level::err, "Raw image not found in S3", {
             {"image_id", request.image_id},
@@ -359,9 +1839,17 @@ std::string ImageController::getOrCreateTransformed(const TransformRequest& requ
         return "";
     }
 
-    // Download raw image to temp file
-    utils::TempFile raw_temp("raw_");
-    if (!file_service_->downloadFile(found_raw_key, raw_temp.getPath())) {
+    // Wait for the raw image download to land in memory; time spent queued overlaps it
+    std::vector<char> downloaded;
+    utils::ByteView raw_data;
+    if (raw.mapped) {
+        raw_data = raw.mapped->view();
+    } else {
+        TRACE_SPAN("download");
+        downloaded = raw.data.get();
+        raw_data = downloaded;
+    }
+    if (raw_data.empty()) {
         gara::Logger::log_structured(spdlog::level::err, "Failed to download raw image from S3", {
             {"image_id", request.image_id},
             {"s3_key", found_raw_key}
@@ -370,19 +1858,72 @@ std::string ImageController::getOrCreateTransformed(const TransformRequest& requ
         return "";
     }
 
-    // Create temp file for transformed image
-    utils::TempFile transformed_temp("transformed_");
+    return transformAndStore(request, raw_data);
+}
+
+ImagePostProcessor ImageController::watermarkStep() const {
+    if (!watermark_service_->isEnabled()) {
+        return nullptr;
+    }
+    return [this](const vips::VImage& image) {
+        return watermark_service_->applyWatermark(image);
+    };
+}
+
+uint64_t ImageController::estimateCost(utils::ByteView raw_data,
+                                       const std::vector<RenditionTarget>& targets) {
+    ImageInfo info = image_processor_->getBufferInfo(raw_data);
+    uint64_t cost = raw_data.size();
+    for (const auto& target : targets) {
+        cost = std::max(cost, ResourceGovernor::estimateCost(raw_data.size(), info.width, info.height, info.bands,
+                                                             info.format, target.width, target.height));
+    }
+    return cost;
+}
+
+std::string ImageController::transformAndStore(const TransformRequest& request,
+                                               utils::ByteView raw_data) {
+    // Held until the encoded output exists; throws ServiceUnavailableException when the budget stays full
+    ResourceGovernor::Permit permit;
+    {
+        TRACE_SPAN("admission");
+        permit = governor_.admit(
+            estimateCost(raw_data, {{request.target_format, request.width, request.height, EncoderProfile()}}));
+    }
+
+    if (streamsToDisk(request, raw_data)) {
+        return streamAndStore(request, raw_data, std::move(permit));
+    }
+
+    // Watermark is composited inside the same pipeline so the image is encoded only once
+    ImagePostProcessor watermark_step = watermarkStep();
 
-    // Transform image
-    bool success = image_processor_->transform(
-        raw_temp.getPath(),
-        transformed_temp.getPath(),
+    EncoderProfile encoder = encoderFor(request);
+    std::vector<char> transformed_data = image_processor_->transformBuffer(
+        raw_data,
         request.target_format,
         request.width,
-        request.height
+        request.height,
+        encoder,
+        watermark_step
     );
 
-    if (!success) {
+    if (transformed_data.empty() && watermark_step) {
+        // Log error but continue without the watermark (graceful degradation)
+        gara::Logger::log_structured(spdlog::level::warn, "Watermark failed, using non-watermarked image", {
+            {"image_id", request.image_id},
+            {"graceful_degradation", true}
+        });
+        transformed_data = image_processor_->transformBuffer(
+            raw_data,
+            request.target_format,
+            request.width,
+            request.height,
+            encoder
+        );
+    }
+
+    if (transformed_data.empty()) {
         gara::Logger::log_structured(spdlog::level::err, "Image transformation failed", {
             {"image_id", request.image_id},
             {"format", request.target_format},
@@ -392,38 +1933,99 @@ std::string ImageController::getOrCreateTransformed(const TransformRequest& requ
         METRICS_COUNT("TransformOperations", 1.0, "Count", {{"status", "transform_error"}});
         return "";
     }
+    permit.release();
 
-    // Apply watermark if enabled
-    if (watermark_service_->isEnabled()) {
-        try {
-            // Load transformed image
-            vips::VImage transformed_image = vips::VImage::new_from_file(
-                transformed_temp.getPath().c_str()
-            );
-
-            // Apply watermark
-            vips::VImage watermarked = watermark_service_->applyWatermark(transformed_image);
+    return storeTransformed(request, transformed_data);
+}
 
-            // Save watermarked image back to temp file
-            watermarked.write_to_file(transformed_temp.getPath().c_str());
+std::string ImageController::storeTransformed(const TransformRequest& request,
+                                              const std::vector<char>& transformed_data) {
+    // Store in cache (S3)
+    bool stored;
+    {
+        TRACE_SPAN("upload");
+        stored = cache_manager_->storeInCache(request, transformed_data);
+    }
+    if (!stored) {
+        gara::Logger::log_structured(spdlog::level::err, "Failed to cache transformed image", {
+            {"image_id", request.image_id},
+            {"cache_key", request.getCacheKey()}
+        });
+        METRICS_COUNT("TransformOperations", 1.0, "Count", {{"status", "cache_error"}});
+        return "";
+    }
 
-            gara::Logger::log_structured(spdlog::level::info, "Watermark applied successfully", {
-                {"image_id", request.image_id},
-                {"format", request.target_format}
-            });
+    // Return the S3 key
+    return request.getCacheKey();
+}
 
-        } catch (const vips::VError& e) {
-            // Log error but continue (graceful degradation)
-            gara::Logger::log_structured(spdlog::level::warn, "Watermark failed, using non-watermarked image", {
-                {"image_id", request.image_id},
-                {"error", e.what()},
-                {"graceful_degradation", true}
-            });
+bool ImageController::streamsToDisk(const TransformRequest& request, utils::ByteView raw_data) {
+    if (transform_config_.stream_min_pixels <= 0) {
+        return false;
+    }
+    long long width = request.width;
+    long long height = request.height;
+    if (width == 0 || height == 0) {
+        ImageInfo info = image_processor_->getBufferInfo(raw_data);
+        if (!info.is_valid || info.width <= 0 || info.height <= 0) {
+            return false;
+        }
+        if (width == 0 && height == 0) {
+            width = info.width;
+            height = info.height;
+        } else if (width == 0) {
+            width = height * info.width / info.height;
+        } else {
+            height = width * info.height / info.width;
         }
     }
+    return width * height >= transform_config_.stream_min_pixels;
+}
 
-    // Store in cache (S3)
-    if (!cache_manager_->storeInCache(request, transformed_temp.getPath())) {
+std::string ImageController::streamAndStore(const TransformRequest& request, utils::ByteView raw_data,
+                                            ResourceGovernor::Permit permit) {
+    utils::TempFile spool("gara_rendition_");
+    EncoderProfile encoder = encoderFor(request);
+    auto encode = [&](const ImagePostProcessor& post_process) {
+        std::ofstream out(spool.getPath(), std::ios::binary | std::ios::trunc);
+        EncodedChunkSink sink = [&out](const char* data, size_t size) {
+            return static_cast<bool>(out.write(data, static_cast<std::streamsize>(size)));
+        };
+        bool encoded = image_processor_->transformStream(raw_data, request.target_format, request.width,
+                                                         request.height, encoder, sink, post_process);
+        out.close();
+        return encoded && !out.fail();
+    };
+
+    ImagePostProcessor watermark_step = watermarkStep();
+    bool encoded = encode(watermark_step);
+    if (!encoded && watermark_step) {
+        gara::Logger::log_structured(spdlog::level::warn, "Watermark failed, using non-watermarked image", {
+            {"image_id", request.image_id},
+            {"graceful_degradation", true}
+        });
+        encoded = encode(nullptr);
+    }
+
+    if (!encoded) {
+        gara::Logger::log_structured(spdlog::level::err, "Image transformation failed", {
+            {"image_id", request.image_id},
+            {"format", request.target_format},
+            {"width", request.width},
+            {"height", request.height}
+        });
+        METRICS_COUNT("TransformOperations", 1.0, "Count", {{"status", "transform_error"}});
+        return "";
+    }
+    permit.release();
+    METRICS_COUNT("TransformOperations", 1.0, "Count", {{"status", "streamed"}});
+
+    bool stored;
+    {
+        TRACE_SPAN("upload");
+        stored = cache_manager_->moveToCache(request, spool.getPath());
+    }
+    if (!stored) {
         gara::Logger::log_structured(spdlog::level::err, "Failed to cache transformed image", {
             {"image_id", request.image_id},
             {"cache_key", request.getCacheKey()}
@@ -431,8 +2033,8 @@ std::string ImageController::getOrCreateTransformed(const TransformRequest& requ
         METRICS_COUNT("TransformOperations", 1.0, "Count", {{"status", "cache_error"}});
         return "";
     }
+    spool.release();
 
-    // Return the S3 key
     return request.getCacheKey();
 }
 
@@ -447,32 +2049,64 @@ crow::response ImageController::handleListImages(const crow::request& req) {
 
         const auto& params = *params_opt;
 
-        // Get total count and images from database
-        int total = db_client_->getImageCount();
-        std::vector<ImageMetadata> images = db_client_->listImages(
-            params.limit, params.offset, params.sort_order);
+        // Fetch one extra row to learn whether another page follows
+        std::vector<ImageMetadata> images;
+        if (params.offset > 0) {
+            images = db_client_->listImages(params.limit + 1, params.offset, params.sort_order);
+        } else {
+            images = db_client_->listImagesAfter(params.limit + 1, params.sort_order, params.after);
+        }
+
+        bool has_more = images.size() > static_cast<size_t>(params.limit);
+        if (has_more) {
+            images.resize(params.limit);
+        }
+
+        int total = -1;
+        if (params.count_mode != ImageCountMode::NONE) {
+            total = imageCount(params.count_mode);
+        }
 
-        // Build JSON response
-        json images_json = json::array();
+        // Serialize rows straight into the body; a json DOM would cost a heap
+        // node per field and hold the page twice while dump() runs
+        size_t estimate = 128;
         for (const auto& img : images) {
-            images_json.push_back(img.toJson());
+            estimate += 160 + img.name.size();
         }
+        std::string body;
+        body.reserve(estimate);
 
-        json response = {
-            {"images", images_json},
-            {"total", total},
-            {"limit", params.limit},
-            {"offset", params.offset}
-        };
+        utils::JsonWriter writer(body);
+        writer.beginObject();
+        writer.key("images");
+        writer.beginArray();
+        for (const auto& img : images) {
+            img.writeJson(writer);
+        }
+        writer.endArray();
+        writer.field("limit", params.limit);
+        writer.key("next_cursor");
+        if (has_more && !images.empty()) {
+            writer.value(utils::PageCursorCodec::encode(
+                params.sort_order, ImagePageCursor::fromImage(images.back())));
+        } else {
+            writer.null();
+        }
+        writer.field("offset", params.offset);
+        if (params.count_mode != ImageCountMode::NONE) {
+            writer.field("total", total);
+        }
+        writer.endObject();
 
         gara::Logger::log_structured(spdlog::level::info, "Listed images successfully", {
             {"total", total},
             {"limit", params.limit},
             {"offset", params.offset},
+            {"cursor", params.after.has_value()},
             {"returned", images.size()}
         });
 
-        crow::response resp(200, response.dump());
+        crow::response resp(200, std::move(body));
         resp.add_header("Content-Type", "application/json");
         addCorsHeaders(resp);
         return resp;
@@ -489,9 +2123,18 @@ void ImageController::addCorsHeaders(crow::response& resp) {
     resp.add_header("Access-Control-Allow-Origin", "*");
     resp.add_header("Access-Control-Allow-Methods", "GET, POST, PUT, DELETE, OPTIONS");
     resp.add_header("Access-Control-Allow-Headers", "Content-Type, X-API-Key, Authorization");
+    resp.add_header("Access-Control-Expose-Headers", "ETag");
     resp.add_header("Access-Control-Max-Age", "3600");
 }
 
+crow::response ImageController::createAuthError(const crow::request& req) {
+    crow::response resp = middleware::AuthMiddleware::extractApiKey(req).empty()
+        ? middleware::AuthMiddleware::unauthorizedResponse("Missing X-API-Key header")
+        : middleware::AuthMiddleware::unauthorizedResponse("Invalid API key");
+    addCorsHeaders(resp);
+    return resp;
+}
+
 crow::response ImageController::createJsonError(int status_code, const std::string& error_message) {
     json error_response = {{"error", error_message}};
     crow::response resp(status_code, error_response.dump());
@@ -554,12 +2197,60 @@ std::optional<ListImageParams> ImageController::parseListParams(
         }
     }
 
+    // Parse cursor parameter (decoded against the sort order it was issued for)
+    auto cursor_param = req.url_params.get("cursor");
+    if (cursor_param) {
+        if (params.offset > 0) {
+            error_message = "Invalid cursor parameter: cannot be combined with offset";
+            return std::nullopt;
+        }
+        params.after = utils::PageCursorCodec::decode(cursor_param, params.sort_order);
+        if (!params.after) {
+            error_message = "Invalid cursor parameter: malformed or issued for a different sort order";
+            return std::nullopt;
+        }
+    }
+
+    // Parse count parameter
+    auto count_param = req.url_params.get("count");
+    if (count_param) {
+        std::string count_str = count_param;
+        if (count_str == "cached") {
+            params.count_mode = ImageCountMode::CACHED;
+        } else if (count_str == "exact") {
+            params.count_mode = ImageCountMode::EXACT;
+        } else if (count_str == "none") {
+            params.count_mode = ImageCountMode::NONE;
+        } else {
+            error_message = "Invalid count parameter: must be one of 'cached', 'exact', 'none'";
+            return std::nullopt;
+        }
+    }
+
     return params;
 }
 
-bool ImageController::storeImageMetadata(const std::string& image_id, const std::string& filename,
-                                        const std::string& extension, size_t file_size,
-                                        const ImageInfo& img_info) {
+int ImageController::imageCount(ImageCountMode mode) {
+    auto now = std::chrono::steady_clock::now();
+    {
+        std::lock_guard<std::mutex> lock(image_count_mutex_);
+        if (mode == ImageCountMode::CACHED && now < image_count_expires_at_) {
+            return cached_image_count_;
+        }
+    }
+
+    // Count outside the lock; concurrent refreshes just race to store the same value
+    int count = db_client_->getImageCount();
+
+    std::lock_guard<std::mutex> lock(image_count_mutex_);
+    cached_image_count_ = count;
+    image_count_expires_at_ = now + std::chrono::seconds(ImageListingConfig::COUNT_CACHE_SECONDS);
+    return count;
+}
+
+ImageMetadata ImageController::buildImageMetadata(const std::string& image_id, const std::string& filename,
+                                                  const std::string& extension, size_t file_size,
+                                                  const ImageInfo& img_info, const std::string& placeholder) {
     ImageMetadata metadata;
     metadata.image_id = image_id;
     metadata.original_format = extension;
@@ -574,16 +2265,26 @@ bool ImageController::storeImageMetadata(const std::string& image_id, const std:
     // Set dimensions from image info
     metadata.width = img_info.width;
     metadata.height = img_info.height;
+    metadata.placeholder = placeholder;
+    return metadata;
+}
 
+bool ImageController::storeImageMetadata(const ImageMetadata& metadata) {
     if (!db_client_->putImageMetadata(metadata)) {
         gara::Logger::log_structured(spdlog::level::err, "Failed to store image metadata in database", {
-            {"image_id", image_id},
+            {"image_id", metadata.image_id},
             {"name", metadata.name}
         });
         return false;
     }
 
+    invalidateImageCount();
     return true;
 }
 
+void ImageController::invalidateImageCount() {
+    std::lock_guard<std::mutex> lock(image_count_mutex_);
+    image_count_expires_at_ = std::chrono::steady_clock::time_point();
+}
+
 } // namespace gara
@@ -2,13 +2,27 @@
 #define GARA_IMAGE_CONTROLLER_H
 
 #include <crow.h>
+#include <chrono>
+#include <functional>
+#include <future>
 #include <memory>
+#include <mutex>
+#include <string_view>
 #include "../interfaces/file_service_interface.h"
 #include "../interfaces/database_client_interface.h"
 #include "../services/image_processor.h"
 #include "../services/cache_manager.h"
 #include "../interfaces/config_service_interface.h"
 #include "../services/watermark_service.h"
+#include "../services/raw_key_resolver.h"
+#include "../services/resource_governor.h"
+#include "../services/transform_executor.h"
+#include "../services/peer_pool.h"
+#include "../services/render_job_worker.h"
+#include "../models/transform_config.h"
+#include "../utils/file_utils.h"
+#include "../utils/io_executor.h"
+#include "../utils/single_flight.h"
 
 namespace gara {
 
@@ -17,13 +31,66 @@ namespace ImageListingConfig {
     constexpr int DEFAULT_LIMIT = 100;
     constexpr int MAX_LIMIT = 1000;
     constexpr int DEFAULT_OFFSET = 0;
+    constexpr int COUNT_CACHE_SECONDS = 30;  // How stale a cached "total" may be
 }
 
+// Constants for the batch rendition API
+namespace ImageBatchConfig {
+    constexpr size_t MAX_ITEMS = 200;
+}
+
+// Outcome of validating an upload and moving it into storage
+enum class StagedUploadStatus {
+    STORED,    // Object written; its metadata row too once storeUpload returns
+    EXISTING,  // Same content already in storage
+    INVALID,   // Not a decodable image
+    FAILED     // Storage or temp file error
+};
+
+struct StagedUpload {
+    StagedUploadStatus status = StagedUploadStatus::FAILED;
+    ImageMetadata metadata;  // Complete when STORED; image_id is set for every status after hashing
+};
+
+// How the "total" field of an image listing is produced
+enum class ImageCountMode {
+    CACHED,  // Reuse a recent COUNT(*) (default)
+    EXACT,   // Run COUNT(*) for this request
+    NONE     // Omit the total
+};
+
 // Structure to hold parsed list parameters
 struct ListImageParams {
     int limit = ImageListingConfig::DEFAULT_LIMIT;
     int offset = ImageListingConfig::DEFAULT_OFFSET;
     ImageSortOrder sort_order = ImageSortOrder::NEWEST;
+    std::optional<ImagePageCursor> after;  // Set when a cursor was supplied
+    ImageCountMode count_mode = ImageCountMode::CACHED;
+};
+
+// How GET /api/images/<id> hands over the rendition (?delivery=)
+enum class ImageDelivery {
+    JSON,      // Envelope with a presigned URL (default)
+    REDIRECT,  // 302 to the presigned URL
+    INLINE     // The rendition bytes themselves
+};
+
+// Raw transformation parameters from a query string or a batch item (null = absent)
+struct TransformParams {
+    const char* format = nullptr;
+    const char* width = nullptr;
+    const char* height = nullptr;
+    const char* quality = nullptr;
+    const char* profile = nullptr;
+    std::string accept;  // Accept header, used by format=auto
+};
+
+// Original image bytes fetched from storage ahead of a transform
+struct RawDownload {
+    bool resolved = false;                // raw_key has been looked up
+    std::string raw_key;                  // Empty when the image is unknown
+    std::future<std::vector<char>> data;  // Valid once the download was started
+    std::shared_ptr<const utils::MappedFile> mapped;  // Set instead of data when storage is read in place
 };
 
 class ImageController {
@@ -33,12 +100,26 @@ public:
                    std::shared_ptr<CacheManager> cache_manager,
                    std::shared_ptr<ConfigServiceInterface> config_service,
                    std::shared_ptr<WatermarkService> watermark_service,
-                   std::shared_ptr<DatabaseClientInterface> db_client);
+                   std::shared_ptr<DatabaseClientInterface> db_client,
+                   std::shared_ptr<RawKeyResolver> raw_key_resolver,
+                   const TransformConfig& transform_config = TransformConfig(),
+                   std::shared_ptr<PeerPool> peer_pool = nullptr);
 
     // Register routes with Crow app (templated to support middleware)
     template<typename App>
     void registerRoutes(App& app);
 
+    // Parse ?delivery= (absent means json); nullopt for an unknown mode
+    static std::optional<ImageDelivery> parseDelivery(const char* value);
+
+    // Validate raw parameters into a transform request, applying the encoder
+    // profile and size ladder so the cache key matches GET /api/images/<id>
+    // Returns std::nullopt with error_message set for invalid parameters
+    static std::optional<TransformRequest> buildTransformRequest(const TransformConfig& config,
+                                                                 const std::string& image_id,
+                                                                 const TransformParams& params,
+                                                                 std::string& error_message);
+
 private:
     std::shared_ptr<FileServiceInterface> file_service_;
     std::shared_ptr<ImageProcessor> image_processor_;
@@ -46,48 +127,242 @@ private:
     std::shared_ptr<ConfigServiceInterface> config_service_;
     std::shared_ptr<WatermarkService> watermark_service_;
     std::shared_ptr<DatabaseClientInterface> db_client_;
+    std::shared_ptr<RawKeyResolver> raw_key_resolver_;
+    TransformConfig transform_config_;
+
+    // Owners of rendition keys across the cluster (null when peering is off)
+    std::shared_ptr<PeerPool> peer_pool_;
+
+    // Coalesces concurrent cache misses for the same transformation
+    utils::SingleFlight<std::string> transform_flights_;
+
+    // Coalesces concurrent uploads of the same content (keyed by image ID)
+    utils::SingleFlight<std::string> upload_flights_;
+
+    // Admits transforms against the memory budget
+    ResourceGovernor governor_;
+
+    // Cached image count so listing pages do not all run COUNT(*)
+    std::mutex image_count_mutex_;
+    int cached_image_count_ = 0;
+    std::chrono::steady_clock::time_point image_count_expires_at_;
+
+    // Hashes, probes and stores the files of bulk uploads
+    std::unique_ptr<utils::IoExecutor> ingest_executor_;
+
+    // Runs transforms off the HTTP threads (joined before the members its tasks use)
+    std::unique_ptr<TransformExecutor> transform_executor_;
+
+    // Drains the durable render job queue onto the transform pool (null when
+    // disabled; declared last so it stops before the pool is joined)
+    std::unique_ptr<RenderJobWorker> render_job_worker_;
 
     // Upload endpoint handler
     crow::response handleUpload(const crow::request& req);
 
+    // Bulk upload endpoint handler: every file part is ingested in parallel,
+    // each committing its metadata row as soon as its object is stored
+    crow::response handleBulkUpload(const crow::request& req);
+
     // Get/transform image endpoint handler
     crow::response handleGetImage(const crow::request& req, const std::string& image_id);
 
     // List images endpoint handler
     crow::response handleListImages(const crow::request& req);
 
+    // Batch rendition URL endpoint handler
+    crow::response handleBatchGetImages(const crow::request& req);
+
     // Health check for image service
     crow::response handleHealthCheck(const crow::request& req);
 
-    // Helper: Parse multipart form data and extract file
+    // Peer endpoint: produce a rendition this node owns for a non-owner.
+    // Answers {"key": ...}, or the bytes with ?inline=1; never forwards again
+    crow::response handlePeerRendition(const crow::request& req, const std::string& image_id);
+
+    // Render job endpoint handlers: queue renditions for every stored image, and queue status
+    crow::response handleQueueRenderJobs(const crow::request& req);
+    crow::response handleGetRenderJobs(const crow::request& req);
+
+    // DeepZoom descriptor endpoint handler (generates the pyramid on first use)
+    crow::response handleGetTileDescriptor(const crow::request& req, const std::string& image_id);
+
+    // DeepZoom tile endpoint handler: redirects to the stored tile
+    crow::response handleGetTile(const crow::request& req, const std::string& image_id,
+                                 int level, const std::string& tile_name);
+
+    // Helper: Locate the uploaded file inside the multipart body (no copy)
+    // file_data points into req.body
     bool extractUploadedFile(const crow::request& req,
-                            std::vector<char>& file_data,
+                            std::string_view& file_data,
                             std::string& filename);
 
     // Helper: Parse query parameters for transformation
-    TransformRequest parseTransformParams(const crow::request& req,
-                                         const std::string& image_id);
+    // Returns std::nullopt with error_message set for an invalid quality or profile
+    std::optional<TransformRequest> parseTransformParams(const crow::request& req,
+                                                         const std::string& image_id,
+                                                         std::string& error_message);
+
+    // Helper: Cache key segment for an encoder profile name ("" for the baseline)
+    static std::string profileKeySegment(const std::string& profile_name);
+
+    // Helper: Encoder settings for a request's profile and quality
+    EncoderProfile encoderFor(const TransformRequest& request) const;
 
     // Helper: Process and upload raw image
-    std::string processUpload(const std::vector<char>& file_data,
+    // Hashes and writes the data in one chunked pass, then moves it into storage
+    std::string processUpload(std::string_view file_data,
                              const std::string& filename);
 
+    // Helper: Hash file_data (the image ID) while writing it to temp_file
+    // Empty if the temp file could not be written
+    std::string spoolUpload(std::string_view file_data, const std::string& filename,
+                            utils::TempFile& temp_file);
+
+    // Helper: storeUpload shared with concurrent uploads of the same content,
+    // including those of other requests. A waiter gets EXISTING when the
+    // leader stored or found the image, FAILED otherwise
+    StagedUpload coalesceUpload(const std::string& image_id, utils::TempFile& temp_file,
+                                std::string_view file_data, const std::string& filename);
+
+    // Helper: Validate, store and record a hashed upload spooled to temp_file.
+    // The object is removed again if its metadata row cannot be written
+    StagedUpload storeUpload(const std::string& image_id, utils::TempFile& temp_file,
+                             std::string_view file_data, const std::string& filename);
+
+    // Helper: Validate a hashed upload and move it into storage, without
+    // writing its metadata row. Consumes temp_file when STORED
+    StagedUpload stageUpload(const std::string& image_id, utils::TempFile& temp_file,
+                             std::string_view file_data, const std::string& filename);
+
+    // Helper: Hash, spool, store and record one file of a bulk upload on the ingest pool.
+    // claim(image_id) is false when an earlier file of the batch has the same content
+    StagedUpload ingestFile(std::string_view file_data, const std::string& filename,
+                            const std::function<bool(const std::string&)>& claim);
+
+    // Helper: Remember, count and pre-generate an upload whose metadata is committed
+    void finishUpload(const ImageMetadata& metadata, std::string_view file_data);
+
     // Helper: Get or create transformed image
-    std::string getOrCreateTransformed(const TransformRequest& request);
+    // On a miss the key's owner produces it, unless forward is false or this node owns it
+    std::string getOrCreateTransformed(const TransformRequest& request, bool forward = true);
+
+    // Helper: Ask the key's owner for the rendition. nullopt when this node owns
+    // it or the owner cannot answer, so the caller transforms locally; "" when
+    // the owner reports the image unknown. Throws
+    // exceptions::ServiceUnavailableException when the owner is shedding load
+    std::optional<std::string> forwardTransform(const TransformRequest& request);
+
+    // Helper: Rendition bytes from the key's owner (nullopt if this node owns it or the owner fails)
+    std::optional<std::string> fetchPeerRendition(const TransformRequest& request);
+
+    // Helper: Peer endpoint path (with query) that rebuilds request on the owner
+    static std::string peerRenditionPath(const TransformRequest& request, bool inline_body);
+
+    // Helper: Download, transform and cache an image (cache miss path).
+    // Reuses raw when the original was already requested via startRawDownload
+    std::string createTransformed(const TransformRequest& request, RawDownload raw = RawDownload());
+
+    // Helper: Resolve the original's key and start fetching it on the I/O pool
+    RawDownload startRawDownload(const std::string& image_id);
+
+    // Helper: Peak memory estimate for producing the largest of several targets from raw bytes
+    uint64_t estimateCost(utils::ByteView raw_data, const std::vector<RenditionTarget>& targets);
+
+    // Helper: Transform raw bytes already in memory and cache the result
+    std::string transformAndStore(const TransformRequest& request, utils::ByteView raw_data);
+
+    // Helper: Upload already-encoded rendition bytes to the cache
+    std::string storeTransformed(const TransformRequest& request, const std::vector<char>& transformed_data);
+
+    // Helper: Whether the rendition covers at least stream_min_pixels (probes the header when a side is 0)
+    bool streamsToDisk(const TransformRequest& request, utils::ByteView raw_data);
+
+    // Helper: transformAndStore for large renditions. Encoded chunks go to a
+    // spool file as libvips produces them and the file is handed to the cache
+    std::string streamAndStore(const TransformRequest& request, utils::ByteView raw_data,
+                               ResourceGovernor::Permit permit);
+
+    // Helper: Watermark post-process step, or null when watermarking is disabled
+    ImagePostProcessor watermarkStep() const;
+
+    // Helper: Queue background generation of the configured renditions for a new upload
+    // (as render jobs when the durable queue is enabled)
+    void schedulePregeneration(const std::string& image_id, std::string_view file_data);
+
+    // Helper: Decode raw_data once, transform it for every request and cache
+    // the results. Empty keys mark failures; nullopt marks a rendition another
+    // caller is already producing. Throws exceptions::ServiceUnavailableException
+    // when the memory budget stays full
+    std::vector<std::optional<std::string>> renderAndStore(const std::vector<TransformRequest>& requests,
+                                                           utils::ByteView raw_data);
+
+    // Helper: RenderJobWorker batch handler; renders one image's jobs on the low lane
+    std::vector<RenderJobResult> runRenderJobs(const std::string& image_id, const std::vector<RenderJob>& jobs);
+
+    // Helper: Transform request a render job stands for
+    // Returns std::nullopt with error_message set when its profile or quality is no longer valid
+    std::optional<TransformRequest> renderJobRequest(const RenderJob& job, std::string& error_message) const;
+
+    // Helper: Run createTransformed on the transform pool and wait for it
+    // Throws exceptions::ServiceUnavailableException when the queue is full
+    std::string runTransformTask(const TransformRequest& request);
+
+    // Helper: createTransformed with the pool's in-flight and latency metrics
+    std::string timedCreateTransformed(const TransformRequest& request, TransformPriority priority,
+                                       RawDownload raw = RawDownload());
+
+    // Helper: Resolve many renditions at once: cache hits in one pass, misses
+    // transformed in parallel on the pool. Empty keys mark failures; busy[i]
+    // is set when item i was shed because the queue was full
+    std::vector<std::string> resolveTransformedBatch(const std::vector<TransformRequest>& requests,
+                                                     std::vector<bool>& busy);
+
+    // Helper: Rendition bytes for delivery=inline, from memory when held there,
+    // then from the key's owning peer (unless ask_owner is false), otherwise
+    // from storage (mapped when local). The bytes are copied into one buffer
+    // for the response body, not streamed. nullopt if unreadable
+    std::optional<std::string> readRendition(const TransformRequest& request, const std::string& storage_key,
+                                             bool ask_owner = true);
+
+    // Helper: Storage prefix of an image's pyramid for the current tile settings
+    std::string tilePrefix(const std::string& image_id) const;
+
+    // Helper: Descriptor key of the image's pyramid, generating it on first use
+    // Empty if the image is unknown or generation failed; throws
+    // exceptions::ServiceUnavailableException when the pool is full or a
+    // generation already in flight outlasts the coalescing timeout
+    std::string getOrCreateTiles(const std::string& image_id);
+
+    // Helper: Cut the pyramid on a worker and upload it, descriptor last so
+    // its presence means every tile is in place
+    std::string createTiles(const std::string& image_id);
 
     // Helper: Add CORS headers to response
     void addCorsHeaders(crow::response& resp);
 
+    // Helper: 401 for a request without a valid API key, with CORS headers
+    crow::response createAuthError(const crow::request& req);
+
     // Helper: Create JSON error response with CORS headers
     crow::response createJsonError(int status_code, const std::string& error_message);
 
     // Helper: Parse and validate list image parameters
     std::optional<ListImageParams> parseListParams(const crow::request& req, std::string& error_message);
 
+    // Helper: Total image count, served from cache unless an exact count is requested
+    int imageCount(ImageCountMode mode);
+
+    // Helper: Metadata row for a validated upload
+    static ImageMetadata buildImageMetadata(const std::string& image_id, const std::string& filename,
+                                            const std::string& extension, size_t file_size,
+                                            const ImageInfo& img_info, const std::string& placeholder);
+
     // Helper: Store image metadata in database
-    bool storeImageMetadata(const std::string& image_id, const std::string& filename,
-                           const std::string& extension, size_t file_size,
-                           const ImageInfo& img_info);
+    bool storeImageMetadata(const ImageMetadata& metadata);
+
+    // Helper: Let the next listing recount instead of serving a stale total
+    void invalidateImageCount();
 };
 
 // Template implementation must be in header
@@ -99,18 +374,65 @@ void ImageController::registerRoutes(App& app) {
         return handleUpload(req);
     });
 
+    // Upload many images in one multipart request
+    CROW_ROUTE(app, "/api/images/upload/bulk").methods("POST"_method)
+    ([this](const crow::request& req) {
+        return handleBulkUpload(req);
+    });
+
     // List images (must come before /<string> route)
     CROW_ROUTE(app, "/api/images").methods("GET"_method)
     ([this](const crow::request& req) {
         return handleListImages(req);
     });
 
+    // Rendition URLs for many images in one request
+    CROW_ROUTE(app, "/api/images/batch").methods("POST"_method)
+    ([this](const crow::request& req) {
+        return handleBatchGetImages(req);
+    });
+
+    CROW_ROUTE(app, "/api/images/batch").methods("OPTIONS"_method)
+    ([this](const crow::request&) {
+        crow::response resp(204);
+        addCorsHeaders(resp);
+        return resp;
+    });
+
+    // Durable background rendition queue (must come before /<string> route)
+    CROW_ROUTE(app, "/api/images/render-jobs").methods("POST"_method)
+    ([this](const crow::request& req) {
+        return handleQueueRenderJobs(req);
+    });
+
+    CROW_ROUTE(app, "/api/images/render-jobs").methods("GET"_method)
+    ([this](const crow::request& req) {
+        return handleGetRenderJobs(req);
+    });
+
+    // DeepZoom pyramid; viewers resolve tile URLs relative to the descriptor
+    CROW_ROUTE(app, "/api/images/<string>/tiles/image.dzi").methods("GET"_method)
+    ([this](const crow::request& req, const std::string& image_id) {
+        return handleGetTileDescriptor(req, image_id);
+    });
+
+    CROW_ROUTE(app, "/api/images/<string>/tiles/image_files/<int>/<string>").methods("GET"_method)
+    ([this](const crow::request& req, const std::string& image_id, int level, const std::string& tile_name) {
+        return handleGetTile(req, image_id, level, tile_name);
+    });
+
     // Get/transform image
     CROW_ROUTE(app, "/api/images/<string>")
     ([this](const crow::request& req, const std::string& image_id) {
         return handleGetImage(req, image_id);
     });
 
+    // Renditions owned by this node, requested by its peers
+    CROW_ROUTE(app, "/internal/peer/renditions/<string>").methods("GET"_method)
+    ([this](const crow::request& req, const std::string& image_id) {
+        return handlePeerRendition(req, image_id);
+    });
+
     // Health check
     CROW_ROUTE(app, "/api/images/health")
     ([this](const crow::request& req) {
@@ -1,10 +1,15 @@
 #include "mysql_client.h"
 #include "../utils/logger.h"
+#include "../utils/prometheus_registry.h"
+#include <mysql/errmsg.h>
 #include <nlohmann/json.hpp>
+#include <algorithm>
 #include <fstream>
 #include <sstream>
 #include <stdexcept>
 #include <cstdlib>
+#include <cstring>
+#include <type_traits>
 
 using json = nlohmann::json;
 
@@ -13,6 +18,82 @@ namespace gara {
 namespace {
     constexpr unsigned int CONNECTION_TIMEOUT_SECONDS = 10;
     constexpr int DEFAULT_MYSQL_PORT = 3306;
+
+    // The nullness flag type MYSQL_BIND points at differs between client libraries
+    using BindFlag = std::remove_pointer_t<decltype(MYSQL_BIND::is_null)>;
+
+    // Runs a block of statements as one transaction, rolling back unless committed
+    class Transaction {
+    public:
+        explicit Transaction(MYSQL* handle)
+            : handle_(handle), active_(mysql_query(handle, "START TRANSACTION") == 0) {
+            if (!active_) {
+                LOG_ERROR("Failed to start transaction: {}", mysql_error(handle_));
+            }
+        }
+        ~Transaction() {
+            if (active_ && mysql_query(handle_, "ROLLBACK") != 0) {
+                LOG_WARN("Failed to roll back transaction: {}", mysql_error(handle_));
+            }
+        }
+
+        Transaction(const Transaction&) = delete;
+        Transaction& operator=(const Transaction&) = delete;
+
+        bool active() const { return active_; }
+
+        bool commit() {
+            if (!active_) {
+                return false;
+            }
+            if (mysql_query(handle_, "COMMIT") != 0) {
+                LOG_ERROR("Failed to commit transaction: {}", mysql_error(handle_));
+                return false;
+            }
+            active_ = false;
+            return true;
+        }
+
+    private:
+        MYSQL* handle_;
+        bool active_;
+    };
+
+    // When this thread last released a primary connection; its reads stay on
+    // the primary for read_your_writes_ms afterwards
+    thread_local std::chrono::steady_clock::time_point last_write_at;
+
+    int parsePositiveEnv(const char* name, int fallback) {
+        const char* value = std::getenv(name);
+        if (value == nullptr) {
+            return fallback;
+        }
+        try {
+            return std::max(0, std::stoi(value));
+        } catch (...) {
+            LOG_WARN("Invalid {} value, using default {}", name, fallback);
+            return fallback;
+        }
+    }
+
+    constexpr const char* IMAGE_UPSERT_PREFIX =
+        "INSERT INTO images (image_id, name, original_format, size, width, height, uploaded_at, placeholder) VALUES ";
+
+    constexpr const char* IMAGE_UPSERT_SUFFIX =
+        " ON DUPLICATE KEY UPDATE "
+        "name = VALUES(name), "
+        "original_format = VALUES(original_format), "
+        "size = VALUES(size), "
+        "width = VALUES(width), "
+        "height = VALUES(height), "
+        "uploaded_at = VALUES(uploaded_at), "
+        "placeholder = VALUES(placeholder)";
+
+    // Rows per multi-row INSERT in putImageMetadataBatch, well under max_allowed_packet
+    constexpr size_t IMAGE_BATCH_ROWS = 500;
+
+    // Rows per multi-row INSERT in enqueueRenderJobs
+    constexpr size_t RENDER_JOB_BATCH_ROWS = 500;
 }
 
 // MySQLConfig implementation
@@ -40,71 +121,447 @@ MySQLConfig MySQLConfig::fromEnvironment() {
         config.database = database;
     }
 
+    config.pool_min = parsePositiveEnv("MYSQL_POOL_MIN", config.pool_min);
+    config.pool_max = std::max(1, parsePositiveEnv("MYSQL_POOL_MAX", config.pool_max));
+    config.pool_min = std::min(config.pool_min, config.pool_max);
+    config.pool_idle_timeout_seconds =
+        parsePositiveEnv("MYSQL_POOL_IDLE_TIMEOUT_SECONDS", config.pool_idle_timeout_seconds);
+    config.pool_acquire_timeout_ms =
+        parsePositiveEnv("MYSQL_POOL_ACQUIRE_TIMEOUT_MS", config.pool_acquire_timeout_ms);
+    config.pool_health_check_seconds =
+        std::max(1, parsePositiveEnv("MYSQL_POOL_HEALTH_CHECK_SECONDS", config.pool_health_check_seconds));
+
+    if (const char* replicas = std::getenv("MYSQL_REPLICA_HOSTS")) {
+        config.replicas = parseEndpoints(replicas, config.port);
+    }
+    config.read_your_writes_ms = parsePositiveEnv("MYSQL_READ_YOUR_WRITES_MS", config.read_your_writes_ms);
+
     return config;
 }
 
+std::vector<MySQLEndpoint> MySQLConfig::parseEndpoints(const std::string& list, int default_port) {
+    std::vector<MySQLEndpoint> endpoints;
+    std::stringstream stream(list);
+    std::string entry;
+    while (std::getline(stream, entry, ',')) {
+        size_t start = entry.find_first_not_of(" \t");
+        if (start == std::string::npos) {
+            continue;
+        }
+        entry = entry.substr(start, entry.find_last_not_of(" \t") - start + 1);
+
+        MySQLEndpoint endpoint{entry, default_port};
+        size_t colon = entry.rfind(':');
+        if (colon != std::string::npos) {
+            endpoint.host = entry.substr(0, colon);
+            std::string port = entry.substr(colon + 1);
+            try {
+                size_t consumed = 0;
+                endpoint.port = std::stoi(port, &consumed);
+                if (consumed != port.size() || endpoint.port <= 0) {
+                    throw std::invalid_argument(port);
+                }
+            } catch (...) {
+                LOG_WARN("Invalid MySQL replica endpoint {}, skipping", entry);
+                continue;
+            }
+        }
+        if (!endpoint.host.empty()) {
+            endpoints.push_back(std::move(endpoint));
+        }
+    }
+    return endpoints;
+}
+
+// MySQLConnection implementation
+
+MySQLConnection::~MySQLConnection() {
+    for (auto& entry : statements) {
+        mysql_stmt_close(entry.second);
+    }
+    if (handle) {
+        mysql_close(handle);
+    }
+}
+
 // MySQLClient implementation
 
 MySQLClient::MySQLClient(const MySQLConfig& config)
-    : conn_(nullptr), config_(config) {
+    : config_(config) {
+
+    config_.pool_max = std::max(1, config_.pool_max);
+    config_.pool_min = std::clamp(config_.pool_min, 1, config_.pool_max);
+
+    primary_ = std::make_unique<Pool>(MySQLEndpoint{config_.host, config_.port}, "mysql_pool");
 
-    conn_ = mysql_init(nullptr);
-    if (conn_ == nullptr) {
-        throw std::runtime_error("Failed to initialize MySQL connection");
+    // The first connection surfaces bad credentials at startup
+    auto first = openConnection(primary_->endpoint);
+    if (!first) {
+        throw std::runtime_error("Failed to connect to MySQL");
+    }
+    primary_->idle.push_back(std::move(first));
+    primary_->total_connections = 1;
+    fillPool(*primary_);
+
+    // An unreachable replica only costs read capacity, so it does not fail startup
+    for (const auto& endpoint : config_.replicas) {
+        auto replica = std::make_unique<Pool>(endpoint, "mysql_replica_pool");
+        fillPool(*replica);
+        replica->healthy = replica->total_connections > 0;
+        if (!replica->healthy) {
+            gara::Logger::log_structured(spdlog::level::warn, "MySQL replica unavailable at startup", {
+                {"host", endpoint.host},
+                {"port", endpoint.port}
+            });
+        }
+        replicas_.push_back(std::move(replica));
+    }
+
+    maintenance_thread_ = std::thread(&MySQLClient::maintenanceLoop, this);
+
+    gara::Logger::log_structured(spdlog::level::info, "MySQL database connected", {
+        {"user", config_.user},
+        {"host", config_.host},
+        {"port", config_.port},
+        {"database", config_.database},
+        {"pool_min", config_.pool_min},
+        {"pool_max", config_.pool_max},
+        {"connections", primary_->total_connections},
+        {"replicas", replicas_.size()},
+        {"healthy_replicas", healthyReplicaCount()},
+        {"read_your_writes_ms", config_.read_your_writes_ms}
+    });
+}
+
+MySQLClient::~MySQLClient() {
+    {
+        std::lock_guard<std::mutex> lock(maintenance_mutex_);
+        stopping_ = true;
+    }
+    maintenance_cv_.notify_all();
+    if (maintenance_thread_.joinable()) {
+        maintenance_thread_.join();
     }
 
-    bool reconnect = true;
-    mysql_options(conn_, MYSQL_OPT_RECONNECT, &reconnect);
+    for (Pool* pool : allPools()) {
+        std::lock_guard<utils::InstrumentedMutex> lock(pool->mutex);
+        pool->idle.clear();
+        pool->total_connections = 0;
+    }
+    LOG_INFO("MySQL database connections closed");
+}
+
+std::vector<MySQLClient::Pool*> MySQLClient::allPools() const {
+    std::vector<Pool*> pools = {primary_.get()};
+    for (const auto& replica : replicas_) {
+        pools.push_back(replica.get());
+    }
+    return pools;
+}
+
+std::unique_ptr<MySQLConnection> MySQLClient::openConnection(const MySQLEndpoint& endpoint) {
+    auto conn = std::make_unique<MySQLConnection>();
+    conn->handle = mysql_init(nullptr);
+    if (conn->handle == nullptr) {
+        LOG_ERROR("Failed to initialize MySQL connection");
+        return nullptr;
+    }
 
+    // Reconnecting silently would invalidate cached prepared statements, so a
+    // lost connection is discarded and replaced instead
     unsigned int timeout = CONNECTION_TIMEOUT_SECONDS;
-    mysql_options(conn_, MYSQL_OPT_CONNECT_TIMEOUT, &timeout);
+    mysql_options(conn->handle, MYSQL_OPT_CONNECT_TIMEOUT, &timeout);
 
-    if (mysql_real_connect(conn_, config_.host.c_str(), config_.user.c_str(),
+    if (mysql_real_connect(conn->handle, endpoint.host.c_str(), config_.user.c_str(),
                            config_.password.c_str(), config_.database.c_str(),
-                           config_.port, nullptr, 0) == nullptr) {
-        std::string error = mysql_error(conn_);
-        mysql_close(conn_);
-        conn_ = nullptr;
-        throw std::runtime_error("Failed to connect to MySQL: " + error);
+                           endpoint.port, nullptr, 0) == nullptr) {
+        LOG_ERROR("Failed to connect to MySQL at {}:{}: {}", endpoint.host, endpoint.port,
+                  mysql_error(conn->handle));
+        return nullptr;
     }
 
-    mysql_set_character_set(conn_, "utf8mb4");
+    mysql_set_character_set(conn->handle, "utf8mb4");
 
-    LOG_INFO("MySQL database connected: {}@{}:{}/{}",
-             config_.user, config_.host, config_.port, config_.database);
+    conn->last_used = std::chrono::steady_clock::now();
+    conn->last_checked = conn->last_used;
+    return conn;
 }
 
-MySQLClient::~MySQLClient() {
+std::unique_ptr<MySQLConnection> MySQLClient::acquire(Pool& pool) {
+    std::unique_lock<utils::InstrumentedMutex> lock(pool.mutex);
+
+    bool available = pool.cv.wait_for(lock, std::chrono::milliseconds(config_.pool_acquire_timeout_ms), [&pool, this]() {
+        return !pool.idle.empty() || pool.total_connections < static_cast<size_t>(config_.pool_max);
+    });
+    if (!available) {
+        LOG_WARN("Timed out waiting for a MySQL connection to {} ({} open)",
+                 pool.endpoint.host, pool.total_connections);
+        return nullptr;
+    }
+
+    if (!pool.idle.empty()) {
+        auto conn = std::move(pool.idle.back());
+        pool.idle.pop_back();
+        ++pool.in_use;
+        return conn;
+    }
+
+    // Reserve the slot, then connect without holding the lock
+    ++pool.total_connections;
+    ++pool.in_use;
+    lock.unlock();
+
+    auto conn = openConnection(pool.endpoint);
+    if (!conn) {
+        lock.lock();
+        --pool.total_connections;
+        --pool.in_use;
+        pool.healthy = false;
+        lock.unlock();
+        pool.cv.notify_one();
+    }
+    return conn;
+}
+
+void MySQLClient::release(Pool& pool, std::unique_ptr<MySQLConnection> conn) {
+    {
+        std::lock_guard<utils::InstrumentedMutex> lock(pool.mutex);
+        --pool.in_use;
+        if (conn->broken) {
+            --pool.total_connections;
+            LOG_WARN("Discarding broken MySQL connection to {} ({} open)",
+                     pool.endpoint.host, pool.total_connections);
+        } else {
+            conn->last_used = std::chrono::steady_clock::now();
+            pool.idle.push_back(std::move(conn));
+        }
+    }
+    pool.cv.notify_one();
+    // A broken connection is closed here, outside the pool lock
+}
+
+void MySQLClient::fillPool(Pool& pool) {
+    while (!stopping_) {
+        {
+            std::lock_guard<utils::InstrumentedMutex> lock(pool.mutex);
+            if (pool.total_connections >= static_cast<size_t>(config_.pool_min)) {
+                break;
+            }
+            ++pool.total_connections;
+        }
+        auto conn = openConnection(pool.endpoint);
+        std::lock_guard<utils::InstrumentedMutex> lock(pool.mutex);
+        if (!conn) {
+            --pool.total_connections;
+            break;
+        }
+        pool.idle.insert(pool.idle.begin(), std::move(conn));
+        pool.cv.notify_one();
+    }
+}
+
+MySQLClient::Pool* MySQLClient::pickReplica() {
+    // Fewest connections in use wins; the rotating start spreads ties
+    size_t count = replicas_.size();
+    size_t start = next_replica_.fetch_add(1, std::memory_order_relaxed);
+    Pool* best = nullptr;
+    size_t best_in_use = 0;
+    for (size_t i = 0; i < count; ++i) {
+        Pool& replica = *replicas_[(start + i) % count];
+        if (!replica.healthy) {
+            continue;
+        }
+        size_t in_use;
+        {
+            std::lock_guard<utils::InstrumentedMutex> lock(replica.mutex);
+            in_use = replica.in_use;
+        }
+        if (best == nullptr || in_use < best_in_use) {
+            best = &replica;
+            best_in_use = in_use;
+        }
+    }
+    return best;
+}
+
+void MySQLClient::maintenanceLoop() {
+    auto interval = std::chrono::seconds(config_.pool_health_check_seconds);
+    std::unique_lock<std::mutex> lock(maintenance_mutex_);
+    while (!maintenance_cv_.wait_for(lock, interval, [this]() { return stopping_.load(); })) {
+        lock.unlock();
+        for (Pool* pool : allPools()) {
+            maintainIdleConnections(*pool);
+        }
+        lock.lock();
+    }
+}
+
+void MySQLClient::maintainIdleConnections(Pool& pool) {
+    auto now = std::chrono::steady_clock::now();
+    auto idle_timeout = std::chrono::seconds(config_.pool_idle_timeout_seconds);
+    auto check_interval = std::chrono::seconds(config_.pool_health_check_seconds);
+
+    // Take stale connections out of the pool so pings never block queries
+    std::vector<std::unique_ptr<MySQLConnection>> to_check;
+    std::vector<std::unique_ptr<MySQLConnection>> to_close;
+    {
+        std::lock_guard<utils::InstrumentedMutex> lock(pool.mutex);
+        size_t keep = pool.total_connections;
+        for (auto it = pool.idle.begin(); it != pool.idle.end();) {
+            MySQLConnection& conn = **it;
+            if (keep > static_cast<size_t>(config_.pool_min) && now - conn.last_used > idle_timeout) {
+                to_close.push_back(std::move(*it));
+                it = pool.idle.erase(it);
+                --keep;
+            } else if (now - conn.last_checked > check_interval) {
+                to_check.push_back(std::move(*it));
+                it = pool.idle.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        pool.total_connections -= to_close.size();
+    }
+
+    size_t dropped = 0;
+    for (auto& conn : to_check) {
+        if (mysql_ping(conn->handle) != 0) {
+            LOG_WARN("MySQL health check failed for {}: {}", pool.endpoint.host, mysql_error(conn->handle));
+            conn->broken = true;
+            ++dropped;
+        }
+        conn->last_checked = now;
+    }
+
+    {
+        std::lock_guard<utils::InstrumentedMutex> lock(pool.mutex);
+        for (auto& conn : to_check) {
+            if (!conn->broken) {
+                pool.idle.insert(pool.idle.begin(), std::move(conn));
+            }
+        }
+        pool.total_connections -= dropped;
+    }
+    pool.cv.notify_all();
+
+    // Top the pool back up to its floor
+    fillPool(pool);
+
+    if (!to_close.empty() || dropped > 0) {
+        LOG_DEBUG("MySQL pool maintenance closed {} idle and {} broken connections to {}",
+                  to_close.size(), dropped, pool.endpoint.host);
+    }
+
+    // A replica takes reads again once it holds a connection that answered
+    if (&pool != primary_.get()) {
+        bool healthy;
+        {
+            std::lock_guard<utils::InstrumentedMutex> lock(pool.mutex);
+            healthy = pool.total_connections > 0 && dropped == 0;
+        }
+        if (pool.healthy.exchange(healthy) != healthy) {
+            gara::Logger::log_structured(healthy ? spdlog::level::info : spdlog::level::warn,
+                                         healthy ? "MySQL replica healthy" : "MySQL replica unhealthy", {
+                {"host", pool.endpoint.host},
+                {"port", pool.endpoint.port}
+            });
+        }
+    }
+}
+
+void MySQLClient::markIfDisconnected(MySQLConnection& conn, unsigned int error_code) {
+    if (error_code == CR_SERVER_GONE_ERROR || error_code == CR_SERVER_LOST) {
+        conn.broken = true;
+    }
+}
+
+MySQLClient::ConnectionLease::ConnectionLease(MySQLClient& client, Route route)
+    : client_(client), route_(route) {
+    static auto& replica_reads = PrometheusRegistry::instance().counter(
+        "gara_mysql_reads_total", "Read-only MySQL calls by the server that served them", {{"target", "replica"}});
+    static auto& primary_reads = PrometheusRegistry::instance().counter(
+        "gara_mysql_reads_total", "Read-only MySQL calls by the server that served them", {{"target", "primary"}});
+
+    if (route_ == Route::REPLICA && !client_.replicas_.empty()) {
+        auto window = std::chrono::milliseconds(client_.config_.read_your_writes_ms);
+        bool sticky = window.count() > 0 && std::chrono::steady_clock::now() - last_write_at < window;
+        if (!sticky) {
+            pool_ = client_.pickReplica();
+            if (pool_) {
+                conn_ = client_.acquire(*pool_);
+            }
+            if (conn_) {
+                replica_reads.inc();
+                return;
+            }
+        }
+        primary_reads.inc();
+    }
+
+    pool_ = client_.primary_.get();
+    conn_ = client_.acquire(*pool_);
+}
+
+MySQLClient::ConnectionLease::~ConnectionLease() {
     if (conn_) {
-        mysql_close(conn_);
-        LOG_INFO("MySQL database connection closed");
+        client_.release(*pool_, std::move(conn_));
+    }
+    if (route_ == Route::PRIMARY) {
+        last_write_at = std::chrono::steady_clock::now();
     }
 }
 
-bool MySQLClient::isConnected() const {
-    return conn_ != nullptr && mysql_ping(const_cast<MYSQL*>(conn_)) == 0;
+size_t MySQLClient::connectionCount() const {
+    size_t total = 0;
+    for (Pool* pool : allPools()) {
+        std::lock_guard<utils::InstrumentedMutex> lock(pool->mutex);
+        total += pool->total_connections;
+    }
+    return total;
 }
 
-bool MySQLClient::reconnectIfNeeded() {
-    if (conn_ == nullptr) {
-        return false;
+size_t MySQLClient::healthyReplicaCount() const {
+    return static_cast<size_t>(std::count_if(replicas_.begin(), replicas_.end(),
+        [](const std::unique_ptr<Pool>& replica) { return replica->healthy.load(); }));
+}
+
+bool MySQLClient::isConnected() const {
+    Pool& pool = *primary_;
+
+    // Take an idle connection out of the pool so the ping never blocks queries
+    std::unique_ptr<MySQLConnection> conn;
+    {
+        std::lock_guard<utils::InstrumentedMutex> lock(pool.mutex);
+        if (pool.idle.empty()) {
+            // Every open connection is checked out and serving queries
+            return pool.total_connections > 0;
+        }
+        conn = std::move(pool.idle.back());
+        pool.idle.pop_back();
     }
 
-    if (mysql_ping(conn_) != 0) {
-        LOG_WARN("MySQL connection lost, attempting reconnect...");
-        if (mysql_ping(conn_) != 0) {
-            LOG_ERROR("Failed to reconnect to MySQL: {}", mysql_error(conn_));
-            return false;
+    bool alive = mysql_ping(conn->handle) == 0;
+    if (!alive) {
+        LOG_WARN("MySQL health check failed for {}: {}", pool.endpoint.host, mysql_error(conn->handle));
+    }
+
+    {
+        std::lock_guard<utils::InstrumentedMutex> lock(pool.mutex);
+        if (alive) {
+            conn->last_checked = std::chrono::steady_clock::now();
+            pool.idle.push_back(std::move(conn));
+        } else {
+            --pool.total_connections;
         }
-        LOG_INFO("MySQL reconnected successfully");
     }
-    return true;
+    pool.cv.notify_one();
+    // A dead connection is closed here, outside the pool lock; maintenance tops the pool back up
+    return alive;
 }
 
 bool MySQLClient::initialize() {
-    std::lock_guard<std::mutex> lock(db_mutex_);
-
-    if (!reconnectIfNeeded()) {
+    ConnectionLease lease(*this);
+    if (!lease) {
         return false;
     }
 
@@ -114,9 +571,17 @@ bool MySQLClient::initialize() {
         return false;
     }
 
-    std::stringstream buffer;
-    buffer << schema_file.rdbuf();
-    std::string schema_sql = buffer.str();
+    // Drop comment lines first: each table is preceded by one, and a chunk
+    // starting with "--" would otherwise be skipped below
+    std::string schema_sql;
+    std::string line;
+    while (std::getline(schema_file, line)) {
+        size_t first = line.find_first_not_of(" \t");
+        if (first != std::string::npos && line.compare(first, 2, "--") == 0) {
+            continue;
+        }
+        schema_sql += line + "\n";
+    }
 
     std::istringstream stream(schema_sql);
     std::string statement;
@@ -130,25 +595,133 @@ bool MySQLClient::initialize() {
 
         if (statement.empty() || statement[0] == '-') continue;
 
-        if (mysql_query(conn_, statement.c_str()) != 0) {
-            LOG_ERROR("Failed to execute schema statement: {}", mysql_error(conn_));
+        if (!executeQuery(lease.connection(), statement)) {
+            LOG_ERROR("Failed to execute schema statement");
             return false;
         }
     }
 
+    if (!migrateLegacyImageIds(lease.connection()) || !migrateImagePlaceholderColumn(lease.connection()) ||
+        !migrateAlbumTags(lease.connection())) {
+        return false;
+    }
+
     LOG_INFO("MySQL database schema initialized successfully");
     return true;
 }
 
-// Helper methods
+bool MySQLClient::migrateImagePlaceholderColumn(MySQLConnection& conn) {
+    MySQLResult result = executeSelect(conn,
+        "SELECT 1 FROM information_schema.COLUMNS "
+        "WHERE TABLE_SCHEMA = DATABASE() AND TABLE_NAME = 'images' AND COLUMN_NAME = 'placeholder'");
+    if (!result) {
+        return false;
+    }
+    if (result.fetchRow() != nullptr) {
+        return true;
+    }
+
+    if (!executeQuery(conn, "ALTER TABLE images ADD COLUMN placeholder VARCHAR(128)")) {
+        LOG_ERROR("Failed to add images.placeholder");
+        return false;
+    }
+
+    LOG_INFO("Added placeholder column to images");
+    return true;
+}
+
+bool MySQLClient::migrateAlbumTags(MySQLConnection& conn) {
+    // Albums written before album_tags existed have tags only in the JSON column
+    MySQLResult result = executeSelect(conn,
+        "SELECT album_id, tags FROM albums a "
+        "WHERE tags IS NOT NULL AND JSON_LENGTH(tags) > 0 "
+        "AND NOT EXISTS (SELECT 1 FROM album_tags t WHERE t.album_id = a.album_id)");
+    if (!result) {
+        return false;
+    }
+
+    std::vector<std::pair<std::string, std::vector<std::string>>> untagged;
+    MYSQL_ROW row;
+    while ((row = result.fetchRow()) != nullptr) {
+        unsigned long* lengths = result.fetchLengths();
+        untagged.emplace_back(getSafeString(row, 0, lengths), jsonToVector(getSafeString(row, 1, lengths)));
+    }
+
+    if (untagged.empty()) {
+        return true;
+    }
+
+    Transaction txn(conn.handle);
+    if (!txn.active()) {
+        return false;
+    }
+
+    for (const auto& [album_id, tags] : untagged) {
+        if (!replaceAlbumTags(conn, album_id, tags)) {
+            return false;
+        }
+    }
+
+    if (!txn.commit()) {
+        return false;
+    }
+
+    gara::Logger::log_structured(spdlog::level::info, "Backfilled album_tags from albums.tags", {
+        {"albums", untagged.size()}
+    });
+    return true;
+}
+
+bool MySQLClient::migrateLegacyImageIds(MySQLConnection& conn) {
+    MySQLResult result = executeSelect(conn,
+        "SELECT album_id, image_ids FROM albums "
+        "WHERE image_ids IS NOT NULL AND JSON_LENGTH(image_ids) > 0");
+    if (!result) {
+        return false;
+    }
+
+    std::vector<std::pair<std::string, std::vector<std::string>>> legacy;
+    MYSQL_ROW row;
+    while ((row = result.fetchRow()) != nullptr) {
+        unsigned long* lengths = result.fetchLengths();
+        legacy.emplace_back(getSafeString(row, 0, lengths), jsonToVector(getSafeString(row, 1, lengths)));
+    }
 
-std::string MySQLClient::escapeString(const std::string& str) {
-    if (conn_ == nullptr) {
-        return str;
+    if (legacy.empty()) {
+        return true;
     }
 
+    Transaction txn(conn.handle);
+    if (!txn.active()) {
+        return false;
+    }
+
+    for (const auto& [album_id, image_ids] : legacy) {
+        // INSERT IGNORE keeps the first position of an ID listed twice
+        if (!insertAlbumImages(conn, album_id, image_ids, 0, true)) {
+            return false;
+        }
+        if (!executeQuery(conn, "UPDATE albums SET image_ids = NULL WHERE album_id = '" +
+                                escapeString(conn.handle, album_id) + "'")) {
+            return false;
+        }
+    }
+
+    if (!txn.commit()) {
+        return false;
+    }
+
+    gara::Logger::log_structured(spdlog::level::info, "Migrated album image_ids into album_images", {
+        {"albums", legacy.size()}
+    });
+    return true;
+}
+
+// Helper methods
+
+std::string MySQLClient::escapeString(MYSQL* conn, const std::string& str) {
     std::vector<char> buffer(str.length() * 2 + 1);
-    unsigned long len = mysql_real_escape_string(conn_, buffer.data(), str.c_str(), str.length());
+    unsigned long len = mysql_real_escape_string(conn, buffer.data(), str.c_str(), str.length());
     return std::string(buffer.data(), len);
 }
 
@@ -176,62 +749,65 @@ std::string MySQLClient::getSafeString(MYSQL_ROW row, int index, unsigned long*
 }
 
 std::string MySQLClient::getSortOrderSql(ImageSortOrder sort_order) {
+    // image_id breaks ties so pages are stable and match the composite indexes
+    switch (sort_order) {
+        case ImageSortOrder::NEWEST:   return "uploaded_at DESC, image_id DESC";
+        case ImageSortOrder::OLDEST:   return "uploaded_at ASC, image_id ASC";
+        case ImageSortOrder::NAME_ASC: return "name ASC, image_id ASC";
+        case ImageSortOrder::NAME_DESC: return "name DESC, image_id DESC";
+        default: return "uploaded_at DESC, image_id DESC";
+    }
+}
+
+std::string MySQLClient::getKeysetConditionSql(ImageSortOrder sort_order) {
+    // The leading bound gives the optimizer an index range; the OR handles ties.
+    // Parameters: key, key, image_id
     switch (sort_order) {
-        case ImageSortOrder::NEWEST:   return "uploaded_at DESC";
-        case ImageSortOrder::OLDEST:   return "uploaded_at ASC";
-        case ImageSortOrder::NAME_ASC: return "name ASC";
-        case ImageSortOrder::NAME_DESC: return "name DESC";
-        default: return "uploaded_at DESC";
+        case ImageSortOrder::OLDEST:
+            return "uploaded_at >= ? AND (uploaded_at > ? OR image_id > ?)";
+        case ImageSortOrder::NAME_ASC:
+            return "name >= ? AND (name > ? OR image_id > ?)";
+        case ImageSortOrder::NAME_DESC:
+            return "name <= ? AND (name < ? OR image_id < ?)";
+        case ImageSortOrder::NEWEST:
+        default:
+            return "uploaded_at <= ? AND (uploaded_at < ? OR image_id < ?)";
     }
 }
 
 // Query execution helpers
 
-bool MySQLClient::executeQuery(const std::string& sql) {
-    if (mysql_query(conn_, sql.c_str()) != 0) {
-        LOG_ERROR("SQL execution failed: {}", mysql_error(conn_));
+bool MySQLClient::executeQuery(MySQLConnection& conn, const std::string& sql) {
+    if (mysql_real_query(conn.handle, sql.c_str(), sql.length()) != 0) {
+        LOG_ERROR("SQL execution failed: {}", mysql_error(conn.handle));
+        markIfDisconnected(conn, mysql_errno(conn.handle));
         return false;
     }
     return true;
 }
 
-MySQLResult MySQLClient::executeSelect(const std::string& sql) {
-    if (mysql_query(conn_, sql.c_str()) != 0) {
-        LOG_ERROR("SELECT execution failed: {}", mysql_error(conn_));
+MySQLResult MySQLClient::executeSelect(MySQLConnection& conn, const std::string& sql) {
+    if (mysql_real_query(conn.handle, sql.c_str(), sql.length()) != 0) {
+        LOG_ERROR("SELECT execution failed: {}", mysql_error(conn.handle));
+        markIfDisconnected(conn, mysql_errno(conn.handle));
         return MySQLResult(nullptr);
     }
 
-    MYSQL_RES* result = mysql_store_result(conn_);
+    MYSQL_RES* result = mysql_store_result(conn.handle);
     if (result == nullptr) {
-        LOG_ERROR("Failed to store result: {}", mysql_error(conn_));
+        LOG_ERROR("Failed to store result: {}", mysql_error(conn.handle));
+        markIfDisconnected(conn, mysql_errno(conn.handle));
     }
     return MySQLResult(result);
 }
 
-template<typename T>
-std::optional<T> MySQLClient::executeSingleRowQuery(
-    const std::string& sql,
-    std::function<T(MYSQL_ROW, unsigned long*)> extractor) {
-
-    MySQLResult result = executeSelect(sql);
-    if (!result) {
-        return std::nullopt;
-    }
-
-    MYSQL_ROW row = result.fetchRow();
-    if (row == nullptr) {
-        return std::nullopt;
-    }
-
-    return extractor(row, result.fetchLengths());
-}
-
 template<typename T>
 std::vector<T> MySQLClient::executeMultiRowQuery(
+    MySQLConnection& conn,
     const std::string& sql,
     std::function<T(MYSQL_ROW, unsigned long*)> extractor) {
 
-    MySQLResult result = executeSelect(sql);
+    MySQLResult result = executeSelect(conn, sql);
     if (!result) {
         return {};
     }
@@ -245,6 +821,135 @@ std::vector<T> MySQLClient::executeMultiRowQuery(
     return items;
 }
 
+MYSQL_STMT* MySQLClient::prepareCached(MySQLConnection& conn, const std::string& sql) {
+    auto it = conn.statements.find(sql);
+    if (it != conn.statements.end()) {
+        return it->second;
+    }
+
+    MYSQL_STMT* stmt = mysql_stmt_init(conn.handle);
+    if (stmt == nullptr) {
+        LOG_ERROR("Failed to allocate MySQL statement: {}", mysql_error(conn.handle));
+        return nullptr;
+    }
+
+    if (mysql_stmt_prepare(stmt, sql.c_str(), sql.length()) != 0) {
+        LOG_ERROR("Failed to prepare statement: {}", mysql_stmt_error(stmt));
+        markIfDisconnected(conn, mysql_stmt_errno(stmt));
+        mysql_stmt_close(stmt);
+        return nullptr;
+    }
+
+    // Report column widths after store_result so result buffers fit exactly
+    bool update_max_length = true;
+    mysql_stmt_attr_set(stmt, STMT_ATTR_UPDATE_MAX_LENGTH, &update_max_length);
+
+    conn.statements.emplace(sql, stmt);
+    return stmt;
+}
+
+bool MySQLClient::executePrepared(MySQLConnection& conn, const std::string& sql,
+                                  const std::vector<MySQLParam>& params,
+                                  const std::function<void(MYSQL_ROW, unsigned long*)>& on_row) {
+    MYSQL_STMT* stmt = prepareCached(conn, sql);
+    if (stmt == nullptr) {
+        return false;
+    }
+
+    auto fail = [&](const char* stage) {
+        LOG_ERROR("Prepared statement {} failed: {}", stage, mysql_stmt_error(stmt));
+        markIfDisconnected(conn, mysql_stmt_errno(stmt));
+        mysql_stmt_free_result(stmt);
+        return false;
+    };
+
+    std::vector<MYSQL_BIND> param_binds(params.size());
+    std::memset(param_binds.data(), 0, sizeof(MYSQL_BIND) * param_binds.size());
+    for (size_t i = 0; i < params.size(); ++i) {
+        const MySQLParam& param = params[i];
+        if (param.type == MySQLParam::Type::STRING) {
+            param_binds[i].buffer_type = MYSQL_TYPE_STRING;
+            param_binds[i].buffer = const_cast<char*>(param.text.data());
+            param_binds[i].buffer_length = param.text.length();
+        } else {
+            param_binds[i].buffer_type = MYSQL_TYPE_LONGLONG;
+            param_binds[i].buffer = const_cast<long long*>(&param.number);
+        }
+    }
+
+    if (!param_binds.empty() && mysql_stmt_bind_param(stmt, param_binds.data()) != 0) {
+        return fail("bind");
+    }
+    if (mysql_stmt_execute(stmt) != 0) {
+        return fail("execute");
+    }
+
+    MySQLResult metadata(mysql_stmt_result_metadata(stmt));
+    if (!metadata) {
+        return true;  // Statement produced no result set
+    }
+    if (mysql_stmt_store_result(stmt) != 0) {
+        return fail("store");
+    }
+
+    unsigned int field_count = mysql_num_fields(metadata.get());
+    MYSQL_FIELD* fields = mysql_fetch_fields(metadata.get());
+
+    std::vector<MYSQL_BIND> result_binds(field_count);
+    std::memset(result_binds.data(), 0, sizeof(MYSQL_BIND) * result_binds.size());
+    std::vector<std::vector<char>> buffers(field_count);
+    std::vector<unsigned long> lengths(field_count);
+    std::unique_ptr<BindFlag[]> nulls(new BindFlag[field_count]());
+
+    // max_length is only tracked for string columns; numbers fit in the floor
+    constexpr unsigned long MIN_COLUMN_BUFFER = 32;
+    for (unsigned int i = 0; i < field_count; ++i) {
+        buffers[i].resize(std::max(fields[i].max_length, MIN_COLUMN_BUFFER) + 1);
+        result_binds[i].buffer_type = MYSQL_TYPE_STRING;
+        result_binds[i].buffer = buffers[i].data();
+        result_binds[i].buffer_length = buffers[i].size();
+        result_binds[i].length = &lengths[i];
+        result_binds[i].is_null = &nulls[i];
+    }
+
+    if (mysql_stmt_bind_result(stmt, result_binds.data()) != 0) {
+        return fail("bind result");
+    }
+
+    std::vector<char*> row(field_count);
+    int rc;
+    while ((rc = mysql_stmt_fetch(stmt)) == 0 || rc == MYSQL_DATA_TRUNCATED) {
+        if (rc == MYSQL_DATA_TRUNCATED) {
+            // Grow any column that did not fit and fetch it again
+            for (unsigned int i = 0; i < field_count; ++i) {
+                if (nulls[i] || lengths[i] < buffers[i].size()) {
+                    continue;
+                }
+                buffers[i].assign(lengths[i] + 1, '\0');
+                result_binds[i].buffer = buffers[i].data();
+                result_binds[i].buffer_length = buffers[i].size();
+                if (mysql_stmt_fetch_column(stmt, &result_binds[i], i, 0) != 0) {
+                    return fail("fetch column");
+                }
+            }
+            if (mysql_stmt_bind_result(stmt, result_binds.data()) != 0) {
+                return fail("bind result");
+            }
+        }
+        for (unsigned int i = 0; i < field_count; ++i) {
+            row[i] = nulls[i] ? nullptr : buffers[i].data();
+        }
+        on_row(row.data(), lengths.data());
+    }
+
+    if (rc != MYSQL_NO_DATA) {
+        return fail("fetch");
+    }
+
+    mysql_stmt_free_result(stmt);
+    return true;
+}
+
 // Row extraction
 
 Album MySQLClient::extractAlbum(MYSQL_ROW row, unsigned long* lengths) {
@@ -255,9 +960,6 @@ Album MySQLClient::extractAlbum(MYSQL_ROW row, unsigned long* lengths) {
     album.description = getSafeString(row, AlbumColumns::DESCRIPTION, lengths);
     album.cover_image_id = getSafeString(row, AlbumColumns::COVER_IMAGE_ID, lengths);
 
-    std::string image_ids_json = getSafeString(row, AlbumColumns::IMAGE_IDS, lengths);
-    album.image_ids = jsonToVector(image_ids_json.empty() ? "[]" : image_ids_json);
-
     std::string tags_json = getSafeString(row, AlbumColumns::TAGS, lengths);
     album.tags = jsonToVector(tags_json.empty() ? "[]" : tags_json);
 
@@ -281,6 +983,11 @@ ImageMetadata MySQLClient::extractImageMetadata(MYSQL_ROW row, unsigned long* le
     metadata.name = getSafeString(row, ImageColumns::NAME, lengths);
     metadata.original_format = getSafeString(row, ImageColumns::FORMAT, lengths);
 
+    // Raw objects are stored under a key derived from the original format
+    if (!metadata.original_format.empty()) {
+        metadata.s3_raw_key = ImageMetadata::generateRawKey(metadata.image_id, metadata.original_format);
+    }
+
     if (row[ImageColumns::SIZE] != nullptr) {
         metadata.original_size = static_cast<size_t>(std::stoull(row[ImageColumns::SIZE]));
     }
@@ -293,6 +1000,7 @@ ImageMetadata MySQLClient::extractImageMetadata(MYSQL_ROW row, unsigned long* le
     if (row[ImageColumns::UPLOADED_AT] != nullptr) {
         metadata.upload_timestamp = static_cast<std::time_t>(std::stoll(row[ImageColumns::UPLOADED_AT]));
     }
+    metadata.placeholder = getSafeString(row, ImageColumns::PLACEHOLDER, lengths);
 
     return metadata;
 }
@@ -300,21 +1008,36 @@ ImageMetadata MySQLClient::extractImageMetadata(MYSQL_ROW row, unsigned long* le
 // Album operations
 
 bool MySQLClient::putAlbum(const Album& album) {
-    std::lock_guard<std::mutex> lock(db_mutex_);
+    ConnectionLease lease(*this);
+    if (!lease) {
+        return false;
+    }
 
-    if (!reconnectIfNeeded()) {
+    Transaction txn(lease.handle());
+    if (!txn.active()) {
         return false;
     }
 
+    // A plain read: FOR UPDATE on a missing key would take a gap lock that
+    // concurrent album creations can deadlock on
+    bool is_new = true;
+    {
+        MySQLResult existing = executeSelect(lease.connection(),
+            "SELECT 1 FROM albums WHERE album_id = '" + escapeString(lease.handle(), album.album_id) + "'");
+        if (!existing) {
+            return false;
+        }
+        is_new = existing.fetchRow() == nullptr;
+    }
+
     std::ostringstream sql;
     sql << "INSERT INTO albums (album_id, name, description, cover_image_id, "
-        << "image_ids, tags, published, created_at, updated_at) VALUES ("
-        << "'" << escapeString(album.album_id) << "', "
-        << "'" << escapeString(album.name) << "', "
-        << "'" << escapeString(album.description) << "', "
-        << "'" << escapeString(album.cover_image_id) << "', "
-        << "'" << escapeString(vectorToJson(album.image_ids)) << "', "
-        << "'" << escapeString(vectorToJson(album.tags)) << "', "
+        << "tags, published, created_at, updated_at) VALUES ("
+        << "'" << escapeString(lease.handle(), album.album_id) << "', "
+        << "'" << escapeString(lease.handle(), album.name) << "', "
+        << "'" << escapeString(lease.handle(), album.description) << "', "
+        << "'" << escapeString(lease.handle(), album.cover_image_id) << "', "
+        << "'" << escapeString(lease.handle(), vectorToJson(album.tags)) << "', "
         << (album.published ? 1 : 0) << ", "
         << static_cast<long long>(album.created_at) << ", "
         << static_cast<long long>(album.updated_at) << ") "
@@ -322,45 +1045,61 @@ bool MySQLClient::putAlbum(const Album& album) {
         << "name = VALUES(name), "
         << "description = VALUES(description), "
         << "cover_image_id = VALUES(cover_image_id), "
-        << "image_ids = VALUES(image_ids), "
         << "tags = VALUES(tags), "
         << "published = VALUES(published), "
         << "updated_at = VALUES(updated_at)";
 
-    if (!executeQuery(sql.str())) {
+    if (!executeQuery(lease.connection(), sql.str())) {
         LOG_ERROR("Failed to execute putAlbum for: {}", album.album_id);
         return false;
     }
 
+    if (is_new && !insertAlbumImages(lease.connection(), album.album_id, album.image_ids, 0, false)) {
+        return false;
+    }
+
+    if (!replaceAlbumTags(lease.connection(), album.album_id, album.tags)) {
+        return false;
+    }
+
+    if (!txn.commit()) {
+        return false;
+    }
+
     LOG_DEBUG("Album stored successfully: {}", album.album_id);
     return true;
 }
 
-std::optional<Album> MySQLClient::getAlbum(const std::string& album_id) {
-    std::lock_guard<std::mutex> lock(db_mutex_);
-
-    if (!reconnectIfNeeded()) {
+std::optional<Album> MySQLClient::getAlbum(const std::string& album_id, bool include_images) {
+    ConnectionLease lease(*this, Route::REPLICA);
+    if (!lease) {
         return std::nullopt;
     }
 
-    std::string sql = "SELECT album_id, name, description, cover_image_id, image_ids, "
-                      "tags, published, created_at, updated_at "
-                      "FROM albums WHERE album_id = '" + escapeString(album_id) + "'";
+    static const std::string sql =
+        "SELECT album_id, name, description, cover_image_id, "
+        "tags, published, created_at, updated_at "
+        "FROM albums WHERE album_id = ?";
 
-    return executeSingleRowQuery<Album>(sql,
-        [this](MYSQL_ROW row, unsigned long* lengths) {
-            return extractAlbum(row, lengths);
+    std::optional<Album> album;
+    executePrepared(lease.connection(), sql, {MySQLParam::string(album_id)},
+        [this, &album](MYSQL_ROW row, unsigned long* lengths) {
+            album = extractAlbum(row, lengths);
         });
+
+    if (album && include_images) {
+        album->image_ids = loadAlbumImages(lease.connection(), album_id, -1, 0);
+    }
+    return album;
 }
 
 std::vector<Album> MySQLClient::listAlbums(bool published_only) {
-    std::lock_guard<std::mutex> lock(db_mutex_);
-
-    if (!reconnectIfNeeded()) {
+    ConnectionLease lease(*this, Route::REPLICA);
+    if (!lease) {
         return {};
     }
 
-    std::string sql = "SELECT album_id, name, description, cover_image_id, image_ids, "
+    std::string sql = "SELECT album_id, name, description, cover_image_id, "
                       "tags, published, created_at, updated_at FROM albums";
 
     if (published_only) {
@@ -368,77 +1107,457 @@ std::vector<Album> MySQLClient::listAlbums(bool published_only) {
     }
     sql += " ORDER BY created_at DESC";
 
-    auto albums = executeMultiRowQuery<Album>(sql,
+    auto albums = executeMultiRowQuery<Album>(lease.connection(), sql,
         [this](MYSQL_ROW row, unsigned long* lengths) {
             return extractAlbum(row, lengths);
         });
 
+    // Fill every album's membership from one ordered scan
+    std::unordered_map<std::string, Album*> by_id;
+    for (auto& album : albums) {
+        by_id[album.album_id] = &album;
+    }
+
+    std::string images_sql = "SELECT ai.album_id, ai.image_id FROM album_images ai";
+    if (published_only) {
+        images_sql += " JOIN albums a ON a.album_id = ai.album_id WHERE a.published = 1";
+    }
+    images_sql += " ORDER BY ai.album_id, ai.position";
+
+    MySQLResult images = executeSelect(lease.connection(), images_sql);
+    if (!images) {
+        return {};
+    }
+
+    MYSQL_ROW row;
+    while ((row = images.fetchRow()) != nullptr) {
+        unsigned long* lengths = images.fetchLengths();
+        auto it = by_id.find(getSafeString(row, 0, lengths));
+        if (it != by_id.end()) {
+            it->second->image_ids.push_back(getSafeString(row, 1, lengths));
+        }
+    }
+
     LOG_DEBUG("Listed {} albums", albums.size());
     return albums;
 }
 
-bool MySQLClient::deleteAlbum(const std::string& album_id) {
-    std::lock_guard<std::mutex> lock(db_mutex_);
+std::vector<Album> MySQLClient::listAlbumsAfter(const AlbumQuery& query, int limit,
+                                                const std::optional<AlbumPageCursor>& after) {
+    ConnectionLease lease(*this, Route::REPLICA);
+    if (!lease) {
+        return {};
+    }
+
+    std::string sql = "SELECT album_id, name, description, cover_image_id, "
+                      "tags, published, created_at, updated_at FROM albums WHERE 1 = 1";
+    std::vector<MySQLParam> params;
+
+    // Albums carrying every requested tag, found on idx_album_tags_tag
+    std::vector<std::string> tags = query.tags;
+    std::sort(tags.begin(), tags.end());
+    tags.erase(std::unique(tags.begin(), tags.end()), tags.end());
+    if (!tags.empty()) {
+        sql += " AND album_id IN (SELECT album_id FROM album_tags WHERE tag IN (?";
+        for (size_t i = 1; i < tags.size(); ++i) {
+            sql += ", ?";
+        }
+        sql += ") GROUP BY album_id HAVING COUNT(*) = " + std::to_string(tags.size()) + ")";
+        for (const auto& tag : tags) {
+            params.push_back(MySQLParam::string(tag));
+        }
+    }
+    if (query.published_only) {
+        sql += " AND published = 1";
+    }
+    if (after) {
+        sql += " AND created_at <= ? AND (created_at < ? OR album_id < ?)";
+        MySQLParam created_at = MySQLParam::integer(static_cast<long long>(after->created_at));
+        params.push_back(created_at);
+        params.push_back(created_at);
+        params.push_back(MySQLParam::string(after->album_id));
+    }
+    sql += " ORDER BY created_at DESC, album_id DESC LIMIT ?";
+    params.push_back(MySQLParam::integer(limit));
+
+    std::vector<Album> albums;
+    bool ok = executePrepared(lease.connection(), sql, params,
+        [this, &albums](MYSQL_ROW row, unsigned long* lengths) {
+            albums.push_back(extractAlbum(row, lengths));
+        });
+    if (!ok) {
+        return {};
+    }
+    if (albums.empty()) {
+        return albums;
+    }
+
+    // Membership of just this page, in one ordered read
+    std::unordered_map<std::string, Album*> by_id;
+    std::ostringstream images_sql;
+    images_sql << "SELECT album_id, image_id FROM album_images WHERE album_id IN (";
+    for (size_t i = 0; i < albums.size(); ++i) {
+        by_id[albums[i].album_id] = &albums[i];
+        images_sql << (i > 0 ? ", '" : "'") << escapeString(lease.handle(), albums[i].album_id) << "'";
+    }
+    images_sql << ") ORDER BY album_id, position";
+
+    MySQLResult images = executeSelect(lease.connection(), images_sql.str());
+    if (!images) {
+        return {};
+    }
+
+    MYSQL_ROW row;
+    while ((row = images.fetchRow()) != nullptr) {
+        unsigned long* lengths = images.fetchLengths();
+        auto it = by_id.find(getSafeString(row, 0, lengths));
+        if (it != by_id.end()) {
+            it->second->image_ids.push_back(getSafeString(row, 1, lengths));
+        }
+    }
+
+    LOG_DEBUG("Listed {} albums after cursor", albums.size());
+    return albums;
+}
 
-    if (!reconnectIfNeeded()) {
+bool MySQLClient::deleteAlbum(const std::string& album_id) {
+    ConnectionLease lease(*this);
+    if (!lease) {
         return false;
     }
 
-    std::string sql = "DELETE FROM albums WHERE album_id = '" + escapeString(album_id) + "'";
+    std::string sql = "DELETE FROM albums WHERE album_id = '" + escapeString(lease.handle(), album_id) + "'";
 
-    if (!executeQuery(sql)) {
+    if (!executeQuery(lease.connection(), sql)) {
         return false;
     }
 
-    my_ulonglong affected = mysql_affected_rows(conn_);
+    my_ulonglong affected = mysql_affected_rows(lease.handle());
     LOG_DEBUG("Album deleted: {} (rows affected: {})", album_id, affected);
 
     return affected > 0;
 }
 
 bool MySQLClient::albumNameExists(const std::string& name, const std::string& exclude_album_id) {
-    std::lock_guard<std::mutex> lock(db_mutex_);
-
-    if (!reconnectIfNeeded()) {
+    ConnectionLease lease(*this);
+    if (!lease) {
         return false;
     }
 
-    std::string sql = "SELECT 1 FROM albums WHERE name = '" + escapeString(name) + "'";
+    std::string sql = "SELECT 1 FROM albums WHERE name = '" + escapeString(lease.handle(), name) + "'";
     if (!exclude_album_id.empty()) {
-        sql += " AND album_id != '" + escapeString(exclude_album_id) + "'";
+        sql += " AND album_id != '" + escapeString(lease.handle(), exclude_album_id) + "'";
     }
 
-    MySQLResult result = executeSelect(sql);
+    MySQLResult result = executeSelect(lease.connection(), sql);
     return result && result.fetchRow() != nullptr;
 }
 
-// Image metadata operations
+// Album membership operations
 
-bool MySQLClient::putImageMetadata(const ImageMetadata& metadata) {
-    std::lock_guard<std::mutex> lock(db_mutex_);
+bool MySQLClient::lockAlbum(MySQLConnection& conn, const std::string& album_id) {
+    MySQLResult result = executeSelect(conn,
+        "SELECT 1 FROM albums WHERE album_id = '" + escapeString(conn.handle, album_id) + "' FOR UPDATE");
+    return result && result.fetchRow() != nullptr;
+}
+
+bool MySQLClient::insertAlbumImages(MySQLConnection& conn, const std::string& album_id,
+                                    const std::vector<std::string>& image_ids,
+                                    int first_position, bool ignore_duplicates) {
+    if (image_ids.empty()) {
+        return true;
+    }
+
+    std::string escaped_album_id = escapeString(conn.handle, album_id);
+
+    // One multi-row INSERT keeps a large add to a single round trip
+    std::ostringstream sql;
+    sql << (ignore_duplicates ? "INSERT IGNORE" : "INSERT")
+        << " INTO album_images (album_id, image_id, position) VALUES ";
+    for (size_t i = 0; i < image_ids.size(); ++i) {
+        if (i > 0) {
+            sql << ", ";
+        }
+        sql << "('" << escaped_album_id << "', '"
+            << escapeString(conn.handle, image_ids[i]) << "', "
+            << first_position + static_cast<int>(i) << ")";
+    }
+
+    return executeQuery(conn, sql.str());
+}
+
+bool MySQLClient::replaceAlbumTags(MySQLConnection& conn, const std::string& album_id,
+                                   const std::vector<std::string>& tags) {
+    std::string escaped_album_id = escapeString(conn.handle, album_id);
+    if (!executeQuery(conn, "DELETE FROM album_tags WHERE album_id = '" + escaped_album_id + "'")) {
+        return false;
+    }
+    if (tags.empty()) {
+        return true;
+    }
+
+    // INSERT IGNORE stores a tag listed twice once
+    std::ostringstream sql;
+    sql << "INSERT IGNORE INTO album_tags (album_id, tag) VALUES ";
+    for (size_t i = 0; i < tags.size(); ++i) {
+        if (i > 0) {
+            sql << ", ";
+        }
+        sql << "('" << escaped_album_id << "', '" << escapeString(conn.handle, tags[i]) << "')";
+    }
+
+    return executeQuery(conn, sql.str());
+}
+
+std::vector<std::string> MySQLClient::loadAlbumImages(MySQLConnection& conn, const std::string& album_id,
+                                                      int limit, int offset) {
+    static const std::string all_sql =
+        "SELECT image_id FROM album_images WHERE album_id = ? ORDER BY position";
+    static const std::string page_sql = all_sql + " LIMIT ? OFFSET ?";
+
+    std::vector<MySQLParam> params = {MySQLParam::string(album_id)};
+    if (limit >= 0) {
+        params.push_back(MySQLParam::integer(limit));
+        params.push_back(MySQLParam::integer(offset));
+    }
+
+    std::vector<std::string> image_ids;
+    executePrepared(conn, limit >= 0 ? page_sql : all_sql, params,
+        [&image_ids](MYSQL_ROW row, unsigned long* lengths) {
+            image_ids.push_back(getSafeString(row, 0, lengths));
+        });
+    return image_ids;
+}
+
+bool MySQLClient::addAlbumImages(const std::string& album_id,
+                                 const std::vector<std::string>& image_ids,
+                                 int position, std::time_t updated_at) {
+    ConnectionLease lease(*this);
+    if (!lease) {
+        return false;
+    }
+
+    Transaction txn(lease.handle());
+    if (!txn.active() || !lockAlbum(lease.connection(), album_id)) {
+        return false;
+    }
+
+    std::string escaped_album_id = escapeString(lease.handle(), album_id);
+
+    // Stored positions may have gaps, so find the one currently at the given index
+    std::optional<int> insert_at;
+    if (position >= 0) {
+        MySQLResult result = executeSelect(lease.connection(),
+            "SELECT position FROM album_images WHERE album_id = '" + escaped_album_id +
+            "' ORDER BY position LIMIT 1 OFFSET " + std::to_string(position));
+        if (!result) {
+            return false;
+        }
+        if (MYSQL_ROW row = result.fetchRow()) {
+            insert_at = std::stoi(row[0]);
+        }
+    }
+
+    int first_position = 0;
+    if (insert_at) {
+        std::string shift = "UPDATE album_images SET position = position + " +
+                            std::to_string(image_ids.size()) +
+                            " WHERE album_id = '" + escaped_album_id +
+                            "' AND position >= " + std::to_string(*insert_at);
+        if (!executeQuery(lease.connection(), shift)) {
+            return false;
+        }
+        first_position = *insert_at;
+    } else {
+        MySQLResult result = executeSelect(lease.connection(),
+            "SELECT COALESCE(MAX(position) + 1, 0) FROM album_images WHERE album_id = '" +
+            escaped_album_id + "'");
+        MYSQL_ROW row = result ? result.fetchRow() : nullptr;
+        if (row == nullptr || row[0] == nullptr) {
+            return false;
+        }
+        first_position = std::stoi(row[0]);
+    }
+
+    std::string touch = "UPDATE albums SET updated_at = " + std::to_string(static_cast<long long>(updated_at)) +
+                        " WHERE album_id = '" + escaped_album_id + "'";
+
+    if (!insertAlbumImages(lease.connection(), album_id, image_ids, first_position, false) ||
+        !executeQuery(lease.connection(), touch) || !txn.commit()) {
+        LOG_ERROR("Failed to add images to album: {}", album_id);
+        return false;
+    }
+
+    LOG_DEBUG("Added {} images to album {}", image_ids.size(), album_id);
+    return true;
+}
+
+bool MySQLClient::removeAlbumImage(const std::string& album_id, const std::string& image_id,
+                                   std::time_t updated_at) {
+    ConnectionLease lease(*this);
+    if (!lease) {
+        return false;
+    }
+
+    Transaction txn(lease.handle());
+    if (!txn.active() || !lockAlbum(lease.connection(), album_id)) {
+        return false;
+    }
+
+    std::string escaped_album_id = escapeString(lease.handle(), album_id);
+
+    std::string remove = "DELETE FROM album_images WHERE album_id = '" + escaped_album_id +
+                         "' AND image_id = '" + escapeString(lease.handle(), image_id) + "'";
+    if (!executeQuery(lease.connection(), remove) || mysql_affected_rows(lease.handle()) == 0) {
+        return false;
+    }
+
+    std::string touch = "UPDATE albums SET updated_at = " + std::to_string(static_cast<long long>(updated_at)) +
+                        " WHERE album_id = '" + escaped_album_id + "'";
+    if (!executeQuery(lease.connection(), touch) || !txn.commit()) {
+        return false;
+    }
+
+    LOG_DEBUG("Removed image {} from album {}", image_id, album_id);
+    return true;
+}
+
+bool MySQLClient::reorderAlbumImages(const std::string& album_id,
+                                     const std::vector<std::string>& image_ids,
+                                     std::time_t updated_at) {
+    if (image_ids.empty()) {
+        return true;
+    }
 
-    if (!reconnectIfNeeded()) {
+    ConnectionLease lease(*this);
+    if (!lease) {
         return false;
     }
 
+    Transaction txn(lease.handle());
+    if (!txn.active() || !lockAlbum(lease.connection(), album_id)) {
+        return false;
+    }
+
+    std::string escaped_album_id = escapeString(lease.handle(), album_id);
+
+    // FIELD() gives each ID its 1-based index in the new order, so the whole
+    // reorder is one statement
+    std::ostringstream reorder;
+    reorder << "UPDATE album_images SET position = FIELD(image_id";
+    for (const auto& image_id : image_ids) {
+        reorder << ", '" << escapeString(lease.handle(), image_id) << "'";
+    }
+    reorder << ") - 1 WHERE album_id = '" << escaped_album_id << "'";
+
+    std::string touch = "UPDATE albums SET updated_at = " + std::to_string(static_cast<long long>(updated_at)) +
+                        " WHERE album_id = '" + escaped_album_id + "'";
+
+    if (!executeQuery(lease.connection(), reorder.str()) ||
+        !executeQuery(lease.connection(), touch) || !txn.commit()) {
+        LOG_ERROR("Failed to reorder images in album: {}", album_id);
+        return false;
+    }
+
+    LOG_DEBUG("Reordered {} images in album {}", image_ids.size(), album_id);
+    return true;
+}
+
+std::vector<std::string> MySQLClient::listAlbumImages(const std::string& album_id,
+                                                      int limit, int offset) {
+    ConnectionLease lease(*this, Route::REPLICA);
+    if (!lease) {
+        return {};
+    }
+    return loadAlbumImages(lease.connection(), album_id, limit, offset);
+}
+
+int MySQLClient::getAlbumImageCount(const std::string& album_id) {
+    ConnectionLease lease(*this, Route::REPLICA);
+    if (!lease) {
+        return 0;
+    }
+
+    static const std::string sql = "SELECT COUNT(*) FROM album_images WHERE album_id = ?";
+
+    int count = 0;
+    executePrepared(lease.connection(), sql, {MySQLParam::string(album_id)},
+        [&count](MYSQL_ROW row, unsigned long*) {
+            if (row[0] != nullptr) {
+                count = std::stoi(row[0]);
+            }
+        });
+    return count;
+}
+
+std::optional<std::unordered_set<std::string>> MySQLClient::albumImagesContained(
+    const std::string& album_id, const std::vector<std::string>& image_ids) {
+    if (image_ids.empty()) {
+        return std::unordered_set<std::string>{};
+    }
+
+    // Primary: callers decide album writes on the answer, like albumNameExists
+    ConnectionLease lease(*this);
+    if (!lease) {
+        return std::nullopt;
+    }
+
+    // Chunked like imagesExist; each ID is a primary key lookup
+    constexpr size_t IDS_PER_QUERY = 1000;
+
+    std::string escaped_album = escapeString(lease.handle(), album_id);
+    std::unordered_set<std::string> found;
+    for (size_t start = 0; start < image_ids.size(); start += IDS_PER_QUERY) {
+        size_t end = std::min(start + IDS_PER_QUERY, image_ids.size());
+
+        std::ostringstream sql;
+        sql << "SELECT image_id FROM album_images WHERE album_id = '" << escaped_album
+            << "' AND image_id IN (";
+        for (size_t i = start; i < end; ++i) {
+            sql << (i > start ? ", '" : "'") << escapeString(lease.handle(), image_ids[i]) << "'";
+        }
+        sql << ")";
+
+        MySQLResult result = executeSelect(lease.connection(), sql.str());
+        if (!result) {
+            return std::nullopt;
+        }
+
+        MYSQL_ROW row;
+        while ((row = result.fetchRow()) != nullptr) {
+            found.insert(getSafeString(row, 0, result.fetchLengths()));
+        }
+    }
+    return found;
+}
+
+// Image metadata operations
+
+std::string MySQLClient::imageValuesSql(MYSQL* handle, const ImageMetadata& metadata) {
     std::ostringstream sql;
-    sql << "INSERT INTO images (image_id, name, original_format, size, width, height, uploaded_at) VALUES ("
-        << "'" << escapeString(metadata.image_id) << "', "
-        << "'" << escapeString(metadata.name) << "', "
-        << "'" << escapeString(metadata.original_format) << "', "
+    sql << "("
+        << "'" << escapeString(handle, metadata.image_id) << "', "
+        << "'" << escapeString(handle, metadata.name) << "', "
+        << "'" << escapeString(handle, metadata.original_format) << "', "
         << static_cast<long long>(metadata.original_size) << ", "
         << metadata.width << ", "
         << metadata.height << ", "
-        << static_cast<long long>(metadata.upload_timestamp) << ") "
-        << "ON DUPLICATE KEY UPDATE "
-        << "name = VALUES(name), "
-        << "original_format = VALUES(original_format), "
-        << "size = VALUES(size), "
-        << "width = VALUES(width), "
-        << "height = VALUES(height), "
-        << "uploaded_at = VALUES(uploaded_at)";
+        << static_cast<long long>(metadata.upload_timestamp) << ", "
+        << (metadata.placeholder.empty() ? "NULL"
+                                         : "'" + escapeString(handle, metadata.placeholder) + "'") << ")";
+    return sql.str();
+}
 
-    if (!executeQuery(sql.str())) {
+bool MySQLClient::putImageMetadata(const ImageMetadata& metadata) {
+    ConnectionLease lease(*this);
+    if (!lease) {
+        return false;
+    }
+
+    std::string sql = std::string(IMAGE_UPSERT_PREFIX) + imageValuesSql(lease.handle(), metadata) +
+                      IMAGE_UPSERT_SUFFIX;
+
+    if (!executeQuery(lease.connection(), sql)) {
         LOG_ERROR("Failed to execute putImageMetadata for: {}", metadata.image_id);
         return false;
     }
@@ -447,51 +1566,127 @@ bool MySQLClient::putImageMetadata(const ImageMetadata& metadata) {
     return true;
 }
 
-std::optional<ImageMetadata> MySQLClient::getImageMetadata(const std::string& image_id) {
-    std::lock_guard<std::mutex> lock(db_mutex_);
+bool MySQLClient::putImageMetadataBatch(const std::vector<ImageMetadata>& batch) {
+    if (batch.empty()) {
+        return true;
+    }
+
+    ConnectionLease lease(*this);
+    if (!lease) {
+        return false;
+    }
+
+    // Multi-row INSERTs inside one transaction, so the batch lands whole or not at all
+    Transaction txn(lease.handle());
+    if (!txn.active()) {
+        return false;
+    }
+    for (size_t offset = 0; offset < batch.size(); offset += IMAGE_BATCH_ROWS) {
+        std::string sql = IMAGE_UPSERT_PREFIX;
+        size_t end = std::min(batch.size(), offset + IMAGE_BATCH_ROWS);
+        for (size_t i = offset; i < end; ++i) {
+            if (i > offset) {
+                sql += ", ";
+            }
+            sql += imageValuesSql(lease.handle(), batch[i]);
+        }
+        sql += IMAGE_UPSERT_SUFFIX;
 
-    if (!reconnectIfNeeded()) {
+        if (!executeQuery(lease.connection(), sql)) {
+            LOG_ERROR("Failed to execute putImageMetadataBatch at row {}", offset);
+            return false;
+        }
+    }
+    if (!txn.commit()) {
+        return false;
+    }
+
+    LOG_DEBUG("Image metadata batch stored successfully: {} rows", batch.size());
+    return true;
+}
+
+std::optional<ImageMetadata> MySQLClient::getImageMetadata(const std::string& image_id) {
+    ConnectionLease lease(*this, Route::REPLICA);
+    if (!lease) {
         return std::nullopt;
     }
 
-    std::string sql = "SELECT image_id, name, original_format, size, width, height, uploaded_at "
-                      "FROM images WHERE image_id = '" + escapeString(image_id) + "'";
+    static const std::string sql =
+        "SELECT image_id, name, original_format, size, width, height, uploaded_at, placeholder "
+        "FROM images WHERE image_id = ?";
 
-    return executeSingleRowQuery<ImageMetadata>(sql,
-        [this](MYSQL_ROW row, unsigned long* lengths) {
-            return extractImageMetadata(row, lengths);
+    std::optional<ImageMetadata> metadata;
+    executePrepared(lease.connection(), sql, {MySQLParam::string(image_id)},
+        [this, &metadata](MYSQL_ROW row, unsigned long* lengths) {
+            metadata = extractImageMetadata(row, lengths);
         });
+    return metadata;
 }
 
 std::vector<ImageMetadata> MySQLClient::listImages(int limit, int offset, ImageSortOrder sort_order) {
-    std::lock_guard<std::mutex> lock(db_mutex_);
-
-    if (!reconnectIfNeeded()) {
+    ConnectionLease lease(*this, Route::REPLICA);
+    if (!lease) {
         return {};
     }
 
-    std::ostringstream sql;
-    sql << "SELECT image_id, name, original_format, size, width, height, uploaded_at "
-        << "FROM images ORDER BY " << getSortOrderSql(sort_order)
-        << " LIMIT " << limit << " OFFSET " << offset;
+    // One cached statement per sort order
+    std::string sql = "SELECT image_id, name, original_format, size, width, height, uploaded_at, placeholder "
+                      "FROM images ORDER BY " + getSortOrderSql(sort_order) + " LIMIT ? OFFSET ?";
 
-    auto images = executeMultiRowQuery<ImageMetadata>(sql.str(),
-        [this](MYSQL_ROW row, unsigned long* lengths) {
-            return extractImageMetadata(row, lengths);
+    std::vector<ImageMetadata> images;
+    bool ok = executePrepared(lease.connection(), sql,
+        {MySQLParam::integer(limit), MySQLParam::integer(offset)},
+        [this, &images](MYSQL_ROW row, unsigned long* lengths) {
+            images.push_back(extractImageMetadata(row, lengths));
         });
+    if (!ok) {
+        return {};
+    }
 
     LOG_DEBUG("Listed {} images", images.size());
     return images;
 }
 
-int MySQLClient::getImageCount() {
-    std::lock_guard<std::mutex> lock(db_mutex_);
+std::vector<ImageMetadata> MySQLClient::listImagesAfter(int limit, ImageSortOrder sort_order,
+                                                        const std::optional<ImagePageCursor>& after) {
+    ConnectionLease lease(*this, Route::REPLICA);
+    if (!lease) {
+        return {};
+    }
+
+    std::string sql = "SELECT image_id, name, original_format, size, width, height, uploaded_at, placeholder "
+                      "FROM images ";
+    std::vector<MySQLParam> params;
+    if (after) {
+        sql += "WHERE " + getKeysetConditionSql(sort_order) + " ";
+        bool by_name = sort_order == ImageSortOrder::NAME_ASC || sort_order == ImageSortOrder::NAME_DESC;
+        MySQLParam key = by_name ? MySQLParam::string(after->name)
+                                 : MySQLParam::integer(static_cast<long long>(after->uploaded_at));
+        params = {key, key, MySQLParam::string(after->image_id)};
+    }
+    sql += "ORDER BY " + getSortOrderSql(sort_order) + " LIMIT ?";
+    params.push_back(MySQLParam::integer(limit));
 
-    if (!reconnectIfNeeded()) {
+    std::vector<ImageMetadata> images;
+    bool ok = executePrepared(lease.connection(), sql, params,
+        [this, &images](MYSQL_ROW row, unsigned long* lengths) {
+            images.push_back(extractImageMetadata(row, lengths));
+        });
+    if (!ok) {
+        return {};
+    }
+
+    LOG_DEBUG("Listed {} images after cursor", images.size());
+    return images;
+}
+
+int MySQLClient::getImageCount() {
+    ConnectionLease lease(*this, Route::REPLICA);
+    if (!lease) {
         return 0;
     }
 
-    MySQLResult result = executeSelect("SELECT COUNT(*) FROM images");
+    MySQLResult result = executeSelect(lease.connection(), "SELECT COUNT(*) FROM images");
     if (!result) {
         return 0;
     }
@@ -505,16 +1700,466 @@ int MySQLClient::getImageCount() {
 }
 
 bool MySQLClient::imageExists(const std::string& image_id) {
-    std::lock_guard<std::mutex> lock(db_mutex_);
+    ConnectionLease lease(*this, Route::REPLICA);
+    if (!lease) {
+        return false;
+    }
+
+    static const std::string sql = "SELECT 1 FROM images WHERE image_id = ? LIMIT 1";
+
+    bool exists = false;
+    executePrepared(lease.connection(), sql, {MySQLParam::string(image_id)},
+        [&exists](MYSQL_ROW, unsigned long*) {
+            exists = true;
+        });
+    return exists;
+}
+
+std::unordered_set<std::string> MySQLClient::imagesExist(const std::vector<std::string>& image_ids) {
+    if (image_ids.empty()) {
+        return {};
+    }
+
+    ConnectionLease lease(*this, Route::REPLICA);
+    if (!lease) {
+        return {};
+    }
+
+    // Chunked so a huge batch stays well under max_allowed_packet
+    constexpr size_t IDS_PER_QUERY = 1000;
+
+    std::unordered_set<std::string> found;
+    for (size_t start = 0; start < image_ids.size(); start += IDS_PER_QUERY) {
+        size_t end = std::min(start + IDS_PER_QUERY, image_ids.size());
+
+        std::ostringstream sql;
+        sql << "SELECT image_id FROM images WHERE image_id IN (";
+        for (size_t i = start; i < end; ++i) {
+            sql << (i > start ? ", '" : "'") << escapeString(lease.handle(), image_ids[i]) << "'";
+        }
+        sql << ")";
+
+        MySQLResult result = executeSelect(lease.connection(), sql.str());
+        if (!result) {
+            return {};
+        }
+
+        MYSQL_ROW row;
+        while ((row = result.fetchRow()) != nullptr) {
+            found.insert(getSafeString(row, 0, result.fetchLengths()));
+        }
+    }
+
+    LOG_DEBUG("{} of {} images exist", found.size(), image_ids.size());
+    return found;
+}
 
-    if (!reconnectIfNeeded()) {
+std::unordered_map<std::string, std::string> MySQLClient::getImagePlaceholders(
+    const std::vector<std::string>& image_ids) {
+    if (image_ids.empty()) {
+        return {};
+    }
+
+    ConnectionLease lease(*this, Route::REPLICA);
+    if (!lease) {
+        return {};
+    }
+
+    // Chunked like imagesExist
+    constexpr size_t IDS_PER_QUERY = 1000;
+
+    std::unordered_map<std::string, std::string> placeholders;
+    for (size_t start = 0; start < image_ids.size(); start += IDS_PER_QUERY) {
+        size_t end = std::min(start + IDS_PER_QUERY, image_ids.size());
+
+        std::ostringstream sql;
+        sql << "SELECT image_id, placeholder FROM images WHERE placeholder IS NOT NULL AND image_id IN (";
+        for (size_t i = start; i < end; ++i) {
+            sql << (i > start ? ", '" : "'") << escapeString(lease.handle(), image_ids[i]) << "'";
+        }
+        sql << ")";
+
+        MySQLResult result = executeSelect(lease.connection(), sql.str());
+        if (!result) {
+            return {};
+        }
+
+        MYSQL_ROW row;
+        while ((row = result.fetchRow()) != nullptr) {
+            unsigned long* lengths = result.fetchLengths();
+            placeholders.emplace(getSafeString(row, 0, lengths), getSafeString(row, 1, lengths));
+        }
+    }
+
+    return placeholders;
+}
+
+bool MySQLClient::putRendition(const RenditionRecord& record) {
+    ConnectionLease lease(*this);
+    if (!lease) {
         return false;
     }
 
-    std::string sql = "SELECT 1 FROM images WHERE image_id = '" + escapeString(image_id) + "'";
+    std::ostringstream sql;
+    sql << "INSERT INTO renditions (storage_key, image_id, size_bytes, last_accessed, hits) VALUES ("
+        << "'" << escapeString(lease.handle(), record.storage_key) << "', "
+        << "'" << escapeString(lease.handle(), record.image_id) << "', "
+        << static_cast<unsigned long long>(record.size_bytes) << ", "
+        << static_cast<long long>(record.last_accessed) << ", "
+        << static_cast<long long>(record.hits) << ") "
+        << "ON DUPLICATE KEY UPDATE "
+        << "image_id = VALUES(image_id), "
+        << "size_bytes = VALUES(size_bytes), "
+        << "last_accessed = VALUES(last_accessed), "
+        << "hits = VALUES(hits)";
+
+    if (!executeQuery(lease.connection(), sql.str())) {
+        LOG_ERROR("Failed to execute putRendition for: {}", record.storage_key);
+        return false;
+    }
+    return true;
+}
 
-    MySQLResult result = executeSelect(sql);
-    return result && result.fetchRow() != nullptr;
+bool MySQLClient::touchRenditions(const std::vector<std::string>& storage_keys,
+                                  std::time_t accessed_at) {
+    if (storage_keys.empty()) {
+        return true;
+    }
+
+    ConnectionLease lease(*this);
+    if (!lease) {
+        return false;
+    }
+
+    constexpr size_t KEYS_PER_QUERY = 1000;
+    long long accessed = static_cast<long long>(accessed_at);
+
+    for (size_t start = 0; start < storage_keys.size(); start += KEYS_PER_QUERY) {
+        size_t end = std::min(start + KEYS_PER_QUERY, storage_keys.size());
+
+        std::ostringstream sql;
+        sql << "UPDATE renditions SET last_accessed = GREATEST(last_accessed, " << accessed
+            << "), hits = hits + 1 WHERE storage_key IN (";
+        for (size_t i = start; i < end; ++i) {
+            sql << (i > start ? ", '" : "'") << escapeString(lease.handle(), storage_keys[i]) << "'";
+        }
+        sql << ")";
+
+        if (!executeQuery(lease.connection(), sql.str())) {
+            LOG_ERROR("Failed to execute touchRenditions");
+            return false;
+        }
+    }
+    return true;
+}
+
+std::vector<std::string> MySQLClient::listRenditionKeys(const std::string& image_id) {
+    ConnectionLease lease(*this, Route::REPLICA);
+    if (!lease) {
+        return {};
+    }
+
+    std::string sql = "SELECT storage_key FROM renditions WHERE image_id = '" +
+                      escapeString(lease.handle(), image_id) + "'";
+
+    MySQLResult result = executeSelect(lease.connection(), sql);
+    if (!result) {
+        return {};
+    }
+
+    std::vector<std::string> keys;
+    MYSQL_ROW row;
+    while ((row = result.fetchRow()) != nullptr) {
+        keys.push_back(getSafeString(row, 0, result.fetchLengths()));
+    }
+    return keys;
+}
+
+std::vector<RenditionRecord> MySQLClient::listEvictionCandidates(int limit,
+                                                                 RenditionEvictionPolicy policy) {
+    ConnectionLease lease(*this, Route::REPLICA);
+    if (!lease) {
+        return {};
+    }
+
+    std::ostringstream sql;
+    sql << "SELECT storage_key, image_id, size_bytes, last_accessed, hits FROM renditions ORDER BY "
+        << (policy == RenditionEvictionPolicy::LFU ? "hits ASC, last_accessed ASC" : "last_accessed ASC")
+        << " LIMIT " << limit;
+
+    MySQLResult result = executeSelect(lease.connection(), sql.str());
+    if (!result) {
+        return {};
+    }
+
+    std::vector<RenditionRecord> records;
+    MYSQL_ROW row;
+    while ((row = result.fetchRow()) != nullptr) {
+        unsigned long* lengths = result.fetchLengths();
+        RenditionRecord record;
+        record.storage_key = getSafeString(row, 0, lengths);
+        record.image_id = getSafeString(row, 1, lengths);
+        record.size_bytes = row[2] ? std::stoull(row[2]) : 0;
+        record.last_accessed = row[3] ? static_cast<std::time_t>(std::stoll(row[3])) : 0;
+        record.hits = row[4] ? std::stoll(row[4]) : 0;
+        records.push_back(std::move(record));
+    }
+    return records;
+}
+
+bool MySQLClient::deleteRenditions(const std::vector<std::string>& storage_keys) {
+    if (storage_keys.empty()) {
+        return true;
+    }
+
+    ConnectionLease lease(*this);
+    if (!lease) {
+        return false;
+    }
+
+    constexpr size_t KEYS_PER_QUERY = 1000;
+
+    for (size_t start = 0; start < storage_keys.size(); start += KEYS_PER_QUERY) {
+        size_t end = std::min(start + KEYS_PER_QUERY, storage_keys.size());
+
+        std::ostringstream sql;
+        sql << "DELETE FROM renditions WHERE storage_key IN (";
+        for (size_t i = start; i < end; ++i) {
+            sql << (i > start ? ", '" : "'") << escapeString(lease.handle(), storage_keys[i]) << "'";
+        }
+        sql << ")";
+
+        if (!executeQuery(lease.connection(), sql.str())) {
+            LOG_ERROR("Failed to execute deleteRenditions");
+            return false;
+        }
+    }
+
+    LOG_DEBUG("Removed {} renditions from the index", storage_keys.size());
+    return true;
+}
+
+uint64_t MySQLClient::getRenditionBytes() {
+    ConnectionLease lease(*this, Route::REPLICA);
+    if (!lease) {
+        return 0;
+    }
+
+    MySQLResult result = executeSelect(lease.connection(), "SELECT COALESCE(SUM(size_bytes), 0) FROM renditions");
+    if (!result) {
+        return 0;
+    }
+
+    MYSQL_ROW row = result.fetchRow();
+    if (row == nullptr || row[0] == nullptr) {
+        return 0;
+    }
+
+    return std::stoull(row[0]);
+}
+
+bool MySQLClient::enqueueRenderJobs(const std::vector<RenderJob>& jobs) {
+    if (jobs.empty()) {
+        return true;
+    }
+
+    ConnectionLease lease(*this);
+    if (!lease) {
+        return false;
+    }
+
+    Transaction txn(lease.handle());
+    if (!txn.active()) {
+        return false;
+    }
+
+    long long now = static_cast<long long>(std::time(nullptr));
+    for (size_t start = 0; start < jobs.size(); start += RENDER_JOB_BATCH_ROWS) {
+        size_t end = std::min(start + RENDER_JOB_BATCH_ROWS, jobs.size());
+
+        std::ostringstream sql;
+        sql << "INSERT INTO render_jobs (image_id, format, width, height, quality, profile, priority, "
+            << "run_after, created_at) VALUES ";
+        for (size_t i = start; i < end; ++i) {
+            const RenderJob& job = jobs[i];
+            sql << (i > start ? ", (" : "(")
+                << "'" << escapeString(lease.handle(), job.image_id) << "', "
+                << "'" << escapeString(lease.handle(), job.format) << "', "
+                << job.width << ", " << job.height << ", " << job.quality << ", "
+                << "'" << escapeString(lease.handle(), job.profile) << "', "
+                << job.priority << ", " << static_cast<long long>(job.run_after) << ", " << now << ")";
+        }
+        // A repeat raises the priority; a failed job starts over (assignments apply left to right).
+        // Dropping the lease token keeps an in-flight claim from completing the newer request
+        sql << " ON DUPLICATE KEY UPDATE "
+            << "priority = GREATEST(priority, VALUES(priority)), "
+            << "attempts = IF(failed, 0, attempts), "
+            << "run_after = IF(failed, VALUES(run_after), run_after), "
+            << "failed = FALSE, "
+            << "lease_token = NULL";
+
+        if (!executeQuery(lease.connection(), sql.str())) {
+            LOG_ERROR("Failed to execute enqueueRenderJobs at row {}", start);
+            return false;
+        }
+    }
+    return txn.commit();
+}
+
+std::vector<RenderJob> MySQLClient::claimRenderJobs(const std::string& lease_token, int max_images,
+                                                    std::time_t now, std::time_t lease_expires_at) {
+    ConnectionLease lease(*this);
+    if (!lease) {
+        return {};
+    }
+
+    long long now_value = static_cast<long long>(now);
+    std::string ready = "failed = FALSE AND run_after <= " + std::to_string(now_value) +
+                        " AND lease_expires_at <= " + std::to_string(now_value);
+
+    // The max_images images with the highest-priority ready jobs; grouped so
+    // an image with many jobs still counts once against the limit
+    std::vector<std::string> image_ids;
+    {
+        MySQLResult result = executeSelect(lease.connection(),
+            "SELECT image_id FROM render_jobs WHERE " + ready +
+            " GROUP BY image_id ORDER BY MAX(priority) DESC, MIN(run_after) ASC LIMIT " +
+            std::to_string(max_images));
+        if (!result) {
+            return {};
+        }
+        MYSQL_ROW row;
+        while ((row = result.fetchRow()) != nullptr) {
+            image_ids.push_back(getSafeString(row, 0, result.fetchLengths()));
+        }
+    }
+    if (image_ids.empty()) {
+        return {};
+    }
+
+    // The UPDATE re-checks readiness under row locks, so concurrent claims never share a job
+    std::string escaped_token = escapeString(lease.handle(), lease_token);
+    std::ostringstream update;
+    update << "UPDATE render_jobs SET lease_token = '" << escaped_token << "', lease_expires_at = "
+           << static_cast<long long>(lease_expires_at) << ", attempts = attempts + 1 WHERE image_id IN (";
+    for (size_t i = 0; i < image_ids.size(); ++i) {
+        update << (i > 0 ? ", '" : "'") << escapeString(lease.handle(), image_ids[i]) << "'";
+    }
+    update << ") AND " << ready;
+
+    if (!executeQuery(lease.connection(), update.str())) {
+        LOG_ERROR("Failed to execute claimRenderJobs");
+        return {};
+    }
+
+    MySQLResult result = executeSelect(lease.connection(),
+        "SELECT job_id, image_id, format, width, height, quality, profile, priority, attempts, run_after "
+        "FROM render_jobs WHERE lease_token = '" + escaped_token + "' ORDER BY image_id, priority DESC");
+    if (!result) {
+        return {};
+    }
+
+    std::vector<RenderJob> jobs;
+    MYSQL_ROW row;
+    while ((row = result.fetchRow()) != nullptr) {
+        unsigned long* lengths = result.fetchLengths();
+        RenderJob job;
+        job.job_id = row[0] ? std::stoll(row[0]) : 0;
+        job.image_id = getSafeString(row, 1, lengths);
+        job.format = getSafeString(row, 2, lengths);
+        job.width = row[3] ? std::stoi(row[3]) : 0;
+        job.height = row[4] ? std::stoi(row[4]) : 0;
+        job.quality = row[5] ? std::stoi(row[5]) : 0;
+        job.profile = getSafeString(row, 6, lengths);
+        job.priority = row[7] ? std::stoi(row[7]) : 0;
+        job.attempts = row[8] ? std::stoi(row[8]) : 0;
+        job.run_after = row[9] ? static_cast<std::time_t>(std::stoll(row[9])) : 0;
+        jobs.push_back(std::move(job));
+    }
+    return jobs;
+}
+
+bool MySQLClient::completeRenderJobs(const std::string& lease_token, const std::vector<int64_t>& job_ids) {
+    if (job_ids.empty()) {
+        return true;
+    }
+
+    ConnectionLease lease(*this);
+    if (!lease) {
+        return false;
+    }
+
+    constexpr size_t IDS_PER_QUERY = 1000;
+
+    std::string escaped_token = escapeString(lease.handle(), lease_token);
+    for (size_t start = 0; start < job_ids.size(); start += IDS_PER_QUERY) {
+        size_t end = std::min(start + IDS_PER_QUERY, job_ids.size());
+
+        std::ostringstream sql;
+        sql << "DELETE FROM render_jobs WHERE job_id IN (";
+        for (size_t i = start; i < end; ++i) {
+            sql << (i > start ? ", " : "") << static_cast<long long>(job_ids[i]);
+        }
+        sql << ") AND lease_token = '" << escaped_token << "'";
+
+        if (!executeQuery(lease.connection(), sql.str())) {
+            LOG_ERROR("Failed to execute completeRenderJobs");
+            return false;
+        }
+    }
+    return true;
+}
+
+bool MySQLClient::releaseRenderJob(const std::string& lease_token, int64_t job_id,
+                                   std::optional<std::time_t> retry_at, const std::string& error) {
+    ConnectionLease lease(*this);
+    if (!lease) {
+        return false;
+    }
+
+    std::ostringstream sql;
+    sql << "UPDATE render_jobs SET lease_token = NULL, lease_expires_at = 0, ";
+    if (retry_at) {
+        sql << "run_after = " << static_cast<long long>(*retry_at) << ", failed = FALSE, ";
+    } else {
+        sql << "failed = TRUE, ";
+    }
+    sql << "last_error = '" << escapeString(lease.handle(), error) << "' "
+        << "WHERE job_id = " << static_cast<long long>(job_id)
+        << " AND lease_token = '" << escapeString(lease.handle(), lease_token) << "'";
+
+    if (!executeQuery(lease.connection(), sql.str())) {
+        LOG_ERROR("Failed to execute releaseRenderJob for: {}", job_id);
+        return false;
+    }
+    return true;
+}
+
+RenderJobCounts MySQLClient::getRenderJobCounts(std::time_t now) {
+    ConnectionLease lease(*this, Route::REPLICA);
+    if (!lease) {
+        return {};
+    }
+
+    std::string now_value = std::to_string(static_cast<long long>(now));
+    MySQLResult result = executeSelect(lease.connection(),
+        "SELECT COALESCE(SUM(NOT failed AND lease_expires_at <= " + now_value + "), 0), "
+        "COALESCE(SUM(NOT failed AND lease_expires_at > " + now_value + "), 0), "
+        "COALESCE(SUM(failed), 0) FROM render_jobs");
+    if (!result) {
+        return {};
+    }
+
+    MYSQL_ROW row = result.fetchRow();
+    if (row == nullptr) {
+        return {};
+    }
+
+    RenderJobCounts counts;
+    counts.pending = row[0] ? std::stoll(row[0]) : 0;
+    counts.leased = row[1] ? std::stoll(row[1]) : 0;
+    counts.failed = row[2] ? std::stoll(row[2]) : 0;
+    return counts;
 }
 
 } // namespace gara
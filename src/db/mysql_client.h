@@ -2,14 +2,29 @@
 #define GARA_DB_MYSQL_CLIENT_H
 
 #include <mysql/mysql.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <string>
 #include <memory>
 #include <mutex>
 #include <functional>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 #include "../interfaces/database_client_interface.h"
+#include "../utils/instrumented_mutex.h"
 
 namespace gara {
 
+/**
+ * @brief Host and port of a MySQL server
+ */
+struct MySQLEndpoint {
+    std::string host;
+    int port = 3306;
+};
+
 /**
  * @brief MySQL connection configuration
  */
@@ -20,7 +35,21 @@ struct MySQLConfig {
     std::string password;
     std::string database = "gara";
 
+    // Connection pool
+    int pool_min = 2;                       // Connections kept open even when idle
+    int pool_max = 16;                      // Upper bound on open connections
+    int pool_idle_timeout_seconds = 300;    // Idle connections above pool_min are closed after this
+    int pool_acquire_timeout_ms = 5000;     // How long a query waits for a free connection
+    int pool_health_check_seconds = 30;     // Idle connections are pinged at most this often
+
+    // Read replicas; each gets its own pool sized like the primary's
+    std::vector<MySQLEndpoint> replicas;    // Empty sends every query to the primary
+    int read_your_writes_ms = 0;            // Reads on a thread that just wrote go to the primary for this long
+
     static MySQLConfig fromEnvironment();
+
+    // "host[:port],host[:port]"; entries with a bad port are skipped
+    static std::vector<MySQLEndpoint> parseEndpoints(const std::string& list, int default_port);
 };
 
 /**
@@ -44,8 +73,50 @@ private:
     MYSQL_RES* result_;
 };
 
+/**
+ * @brief A pooled MySQL connection and the statements prepared on it
+ */
+struct MySQLConnection {
+    MYSQL* handle = nullptr;
+    std::unordered_map<std::string, MYSQL_STMT*> statements;
+    std::chrono::steady_clock::time_point last_used;
+    std::chrono::steady_clock::time_point last_checked;
+    bool broken = false;  // Lost the server; discarded instead of returned to the pool
+
+    MySQLConnection() = default;
+    ~MySQLConnection();
+
+    MySQLConnection(const MySQLConnection&) = delete;
+    MySQLConnection& operator=(const MySQLConnection&) = delete;
+};
+
+/**
+ * @brief Bound parameter for a prepared statement
+ */
+struct MySQLParam {
+    enum class Type { STRING, INTEGER };
+
+    Type type;
+    std::string text;
+    long long number = 0;
+
+    static MySQLParam string(const std::string& value) { return {Type::STRING, value, 0}; }
+    static MySQLParam integer(long long value) { return {Type::INTEGER, "", value}; }
+};
+
 /**
  * @brief MySQL implementation of the database client interface
+ *
+ * Queries check out a connection from a bounded pool so concurrent requests
+ * run on separate server sessions. Hot lookups use server-side prepared
+ * statements cached per connection. Idle connections are health-checked and
+ * trimmed by a background thread rather than pinged on every call.
+ *
+ * With replicas configured, read-only calls go to the healthy replica with
+ * the fewest connections in use and writes stay on the primary. A replica
+ * that fails to connect or answer a ping is skipped until the next health
+ * check succeeds; with none healthy, reads fall back to the primary. Reads
+ * that guard a write (albumNameExists) always use the primary.
  */
 class MySQLClient : public DatabaseClientInterface {
 public:
@@ -57,26 +128,127 @@ public:
 
     // DatabaseClientInterface implementation
     bool putAlbum(const Album& album) override;
-    std::optional<Album> getAlbum(const std::string& album_id) override;
+    std::optional<Album> getAlbum(const std::string& album_id,
+                                  bool include_images = true) override;
     std::vector<Album> listAlbums(bool published_only = false) override;
+    std::vector<Album> listAlbumsAfter(const AlbumQuery& query, int limit,
+                                       const std::optional<AlbumPageCursor>& after) override;
     bool deleteAlbum(const std::string& album_id) override;
     bool albumNameExists(const std::string& name,
                         const std::string& exclude_album_id = "") override;
 
+    bool addAlbumImages(const std::string& album_id, const std::vector<std::string>& image_ids,
+                        int position, std::time_t updated_at) override;
+    bool removeAlbumImage(const std::string& album_id, const std::string& image_id,
+                          std::time_t updated_at) override;
+    bool reorderAlbumImages(const std::string& album_id, const std::vector<std::string>& image_ids,
+                            std::time_t updated_at) override;
+    std::vector<std::string> listAlbumImages(const std::string& album_id,
+                                             int limit, int offset) override;
+    int getAlbumImageCount(const std::string& album_id) override;
+    std::optional<std::unordered_set<std::string>> albumImagesContained(
+        const std::string& album_id, const std::vector<std::string>& image_ids) override;
+
     bool putImageMetadata(const ImageMetadata& metadata) override;
+    bool putImageMetadataBatch(const std::vector<ImageMetadata>& batch) override;
     std::optional<ImageMetadata> getImageMetadata(const std::string& image_id) override;
     std::vector<ImageMetadata> listImages(int limit, int offset,
                                           ImageSortOrder sort_order) override;
+    std::vector<ImageMetadata> listImagesAfter(int limit, ImageSortOrder sort_order,
+                                               const std::optional<ImagePageCursor>& after) override;
     int getImageCount() override;
     bool imageExists(const std::string& image_id) override;
+    std::unordered_set<std::string> imagesExist(const std::vector<std::string>& image_ids) override;
+    std::unordered_map<std::string, std::string> getImagePlaceholders(
+        const std::vector<std::string>& image_ids) override;
+
+    // Transform index operations
+    bool putRendition(const RenditionRecord& record) override;
+    bool touchRenditions(const std::vector<std::string>& storage_keys, std::time_t accessed_at) override;
+    std::vector<std::string> listRenditionKeys(const std::string& image_id) override;
+    std::vector<RenditionRecord> listEvictionCandidates(int limit, RenditionEvictionPolicy policy) override;
+    bool deleteRenditions(const std::vector<std::string>& storage_keys) override;
+    uint64_t getRenditionBytes() override;
+
+    // Render job queue operations
+    bool enqueueRenderJobs(const std::vector<RenderJob>& jobs) override;
+    std::vector<RenderJob> claimRenderJobs(const std::string& lease_token, int max_images,
+                                           std::time_t now, std::time_t lease_expires_at) override;
+    bool completeRenderJobs(const std::string& lease_token, const std::vector<int64_t>& job_ids) override;
+    bool releaseRenderJob(const std::string& lease_token, int64_t job_id,
+                          std::optional<std::time_t> retry_at, const std::string& error) override;
+    RenderJobCounts getRenderJobCounts(std::time_t now) override;
 
     bool initialize();
     bool isConnected() const;
 
+    /**
+     * @brief Number of open connections (idle and checked out), replicas included
+     */
+    size_t connectionCount() const;
+
+    /**
+     * @brief Number of replicas currently taking reads
+     */
+    size_t healthyReplicaCount() const;
+
 private:
-    MYSQL* conn_;
+    /**
+     * @brief Connections to one server: the primary or a replica
+     */
+    struct Pool {
+        Pool(MySQLEndpoint endpoint, const char* lock_name)
+            : endpoint(std::move(endpoint)), mutex(lock_name) {}
+
+        MySQLEndpoint endpoint;
+        mutable utils::InstrumentedMutex mutex;
+        std::condition_variable_any cv;
+        std::vector<std::unique_ptr<MySQLConnection>> idle;  // Most recently used last
+        size_t total_connections = 0;
+        size_t in_use = 0;
+        std::atomic<bool> healthy{true};
+    };
+
+    /**
+     * @brief Whether a call may be served by a replica
+     */
+    enum class Route {
+        PRIMARY,  // Writes, and reads that must see them
+        REPLICA   // Read-only; a replica when one is healthy
+    };
+
+    /**
+     * @brief RAII checkout of a pooled connection
+     */
+    class ConnectionLease {
+    public:
+        explicit ConnectionLease(MySQLClient& client, Route route = Route::PRIMARY);
+        ~ConnectionLease();
+
+        ConnectionLease(const ConnectionLease&) = delete;
+        ConnectionLease& operator=(const ConnectionLease&) = delete;
+
+        explicit operator bool() const { return conn_ != nullptr; }
+        MySQLConnection& connection() { return *conn_; }
+        MYSQL* handle() { return conn_->handle; }
+
+    private:
+        MySQLClient& client_;
+        Pool* pool_ = nullptr;
+        Route route_;
+        std::unique_ptr<MySQLConnection> conn_;
+    };
+
     MySQLConfig config_;
-    mutable std::mutex db_mutex_;
+
+    std::unique_ptr<Pool> primary_;
+    std::vector<std::unique_ptr<Pool>> replicas_;
+    std::atomic<size_t> next_replica_{0};  // Rotates ties between equally loaded replicas
+
+    std::mutex maintenance_mutex_;
+    std::condition_variable maintenance_cv_;
+    std::atomic<bool> stopping_{false};
+    std::thread maintenance_thread_;
 
     // Column indices for albums table
     struct AlbumColumns {
@@ -84,11 +256,10 @@ private:
         static constexpr int NAME = 1;
         static constexpr int DESCRIPTION = 2;
         static constexpr int COVER_IMAGE_ID = 3;
-        static constexpr int IMAGE_IDS = 4;
-        static constexpr int TAGS = 5;
-        static constexpr int PUBLISHED = 6;
-        static constexpr int CREATED_AT = 7;
-        static constexpr int UPDATED_AT = 8;
+        static constexpr int TAGS = 4;
+        static constexpr int PUBLISHED = 5;
+        static constexpr int CREATED_AT = 6;
+        static constexpr int UPDATED_AT = 7;
     };
 
     // Column indices for images table
@@ -100,10 +271,24 @@ private:
         static constexpr int WIDTH = 4;
         static constexpr int HEIGHT = 5;
         static constexpr int UPLOADED_AT = 6;
+        static constexpr int PLACEHOLDER = 7;
     };
 
-    bool reconnectIfNeeded();
-    std::string escapeString(const std::string& str);
+    // Pool management
+    std::unique_ptr<MySQLConnection> openConnection(const MySQLEndpoint& endpoint);
+    std::unique_ptr<MySQLConnection> acquire(Pool& pool);
+    void release(Pool& pool, std::unique_ptr<MySQLConnection> conn);
+    void fillPool(Pool& pool);
+    Pool* pickReplica();  // nullptr when no replica is healthy
+    std::vector<Pool*> allPools() const;  // Primary first
+    void maintenanceLoop();
+    void maintainIdleConnections(Pool& pool);
+    static void markIfDisconnected(MySQLConnection& conn, unsigned int error_code);
+
+    static std::string escapeString(MYSQL* conn, const std::string& str);
+
+    // "(...)" VALUES tuple of an images row
+    static std::string imageValuesSql(MYSQL* handle, const ImageMetadata& metadata);
 
     // JSON helpers
     static std::string vectorToJson(const std::vector<std::string>& vec);
@@ -115,20 +300,42 @@ private:
     ImageMetadata extractImageMetadata(MYSQL_ROW row, unsigned long* lengths);
 
     static std::string getSortOrderSql(ImageSortOrder sort_order);
+    static std::string getKeysetConditionSql(ImageSortOrder sort_order);
 
-    // Query execution helpers
-    bool executeQuery(const std::string& sql);
-    MySQLResult executeSelect(const std::string& sql);
+    // Album membership helpers (called inside a checked-out connection)
+    bool migrateLegacyImageIds(MySQLConnection& conn);
+    bool migrateImagePlaceholderColumn(MySQLConnection& conn);  // images.placeholder on older databases
+    bool migrateAlbumTags(MySQLConnection& conn);  // album_tags from albums.tags on older databases
+    bool replaceAlbumTags(MySQLConnection& conn, const std::string& album_id,
+                          const std::vector<std::string>& tags);
+    bool lockAlbum(MySQLConnection& conn, const std::string& album_id);  // SELECT ... FOR UPDATE
+    bool insertAlbumImages(MySQLConnection& conn, const std::string& album_id,
+                           const std::vector<std::string>& image_ids,
+                           int first_position, bool ignore_duplicates);
+    std::vector<std::string> loadAlbumImages(MySQLConnection& conn, const std::string& album_id,
+                                             int limit, int offset);  // limit -1 reads all
 
-    template<typename T>
-    std::optional<T> executeSingleRowQuery(
-        const std::string& sql,
-        std::function<T(MYSQL_ROW, unsigned long*)> extractor);
+    // Query execution helpers
+    bool executeQuery(MySQLConnection& conn, const std::string& sql);
+    MySQLResult executeSelect(MySQLConnection& conn, const std::string& sql);
 
     template<typename T>
     std::vector<T> executeMultiRowQuery(
+        MySQLConnection& conn,
         const std::string& sql,
         std::function<T(MYSQL_ROW, unsigned long*)> extractor);
+
+    /**
+     * @brief Run a cached prepared statement, calling on_row for each result row
+     *
+     * Rows are handed over in the same MYSQL_ROW/lengths shape as the text
+     * protocol so the extract helpers work for both.
+     */
+    bool executePrepared(MySQLConnection& conn, const std::string& sql,
+                         const std::vector<MySQLParam>& params,
+                         const std::function<void(MYSQL_ROW, unsigned long*)>& on_row);
+
+    MYSQL_STMT* prepareCached(MySQLConnection& conn, const std::string& sql);
 };
 
 } // namespace gara
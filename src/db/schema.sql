@@ -7,7 +7,7 @@ CREATE TABLE IF NOT EXISTS albums (
     name TEXT UNIQUE NOT NULL,
     description TEXT,
     cover_image_id TEXT,
-    image_ids TEXT,  -- JSON array of image IDs
+    image_ids TEXT,  -- Legacy JSON array, migrated into album_images on startup
     tags TEXT,       -- JSON array of tags
     published INTEGER DEFAULT 0,  -- 0 = false, 1 = true
     created_at INTEGER,  -- Unix timestamp
@@ -17,7 +17,30 @@ CREATE TABLE IF NOT EXISTS albums (
 -- Indexes for performance
 CREATE INDEX IF NOT EXISTS idx_albums_published ON albums(published);
 CREATE INDEX IF NOT EXISTS idx_albums_name ON albums(name);
-CREATE INDEX IF NOT EXISTS idx_albums_created_at ON albums(created_at DESC);
+-- Serves the newest-first listing and its cursors, album_id breaking ties
+DROP INDEX IF EXISTS idx_albums_created_at;
+CREATE INDEX IF NOT EXISTS idx_albums_created_at_id ON albums(created_at, album_id);
+
+-- Album tags, one row per tag; albums.tags keeps the JSON copy the album reads return
+-- Backfilled from albums.tags on startup
+CREATE TABLE IF NOT EXISTS album_tags (
+    album_id TEXT NOT NULL REFERENCES albums(album_id) ON DELETE CASCADE,
+    tag TEXT NOT NULL,
+    PRIMARY KEY (album_id, tag)
+);
+
+CREATE INDEX IF NOT EXISTS idx_album_tags_tag ON album_tags(tag, album_id);
+
+-- Album membership, one row per image
+-- position orders images within an album, removals may leave gaps
+CREATE TABLE IF NOT EXISTS album_images (
+    album_id TEXT NOT NULL REFERENCES albums(album_id) ON DELETE CASCADE,
+    image_id TEXT NOT NULL,
+    position INTEGER NOT NULL,
+    PRIMARY KEY (album_id, image_id)
+);
+
+CREATE INDEX IF NOT EXISTS idx_album_images_position ON album_images(album_id, position);
 
 -- Images table
 CREATE TABLE IF NOT EXISTS images (
@@ -27,9 +50,51 @@ CREATE TABLE IF NOT EXISTS images (
     size INTEGER NOT NULL,             -- File size in bytes
     width INTEGER,                     -- Image width in pixels
     height INTEGER,                    -- Image height in pixels
-    uploaded_at INTEGER NOT NULL       -- Unix timestamp
+    uploaded_at INTEGER NOT NULL,      -- Unix timestamp
+    placeholder TEXT                   -- BlurHash; added to older databases on startup
 );
 
 -- Indexes for performance
-CREATE INDEX IF NOT EXISTS idx_images_uploaded_at ON images(uploaded_at DESC);
-CREATE INDEX IF NOT EXISTS idx_images_name ON images(name ASC);
+-- Composite indexes serve both directions of each sort and the keyset
+-- (cursor) comparisons, with image_id as the tie-breaker
+DROP INDEX IF EXISTS idx_images_uploaded_at;
+DROP INDEX IF EXISTS idx_images_name;
+CREATE INDEX IF NOT EXISTS idx_images_uploaded_at_id ON images(uploaded_at, image_id);
+CREATE INDEX IF NOT EXISTS idx_images_name_id ON images(name, image_id);
+
+-- Transform index: one row per rendition in the transformed cache
+CREATE TABLE IF NOT EXISTS renditions (
+    storage_key TEXT PRIMARY KEY,      -- transformed/<image_id>_<params>.<ext>
+    image_id TEXT NOT NULL,            -- Source image
+    size_bytes INTEGER NOT NULL,       -- Encoded size
+    last_accessed INTEGER NOT NULL,    -- Unix timestamp
+    hits INTEGER NOT NULL DEFAULT 0    -- Accesses since stored
+);
+
+CREATE INDEX IF NOT EXISTS idx_renditions_image_id ON renditions(image_id);
+CREATE INDEX IF NOT EXISTS idx_renditions_last_accessed ON renditions(last_accessed);
+CREATE INDEX IF NOT EXISTS idx_renditions_hits ON renditions(hits, last_accessed);
+
+-- Background rendition jobs, one per image and parameter set
+-- Claimed by leasing: a job whose lease runs out is claimed again
+CREATE TABLE IF NOT EXISTS render_jobs (
+    job_id INTEGER PRIMARY KEY AUTOINCREMENT,
+    image_id TEXT NOT NULL,
+    format TEXT NOT NULL,
+    width INTEGER NOT NULL,
+    height INTEGER NOT NULL,
+    quality INTEGER NOT NULL DEFAULT 0,          -- 0 = profile default
+    profile TEXT NOT NULL DEFAULT '',            -- Encoder profile name, '' = the default
+    priority INTEGER NOT NULL DEFAULT 0,         -- Higher is claimed first
+    attempts INTEGER NOT NULL DEFAULT 0,         -- Claims so far
+    run_after INTEGER NOT NULL,                  -- Unix timestamp; not claimed before
+    lease_token TEXT,                            -- Claim holding the job
+    lease_expires_at INTEGER NOT NULL DEFAULT 0, -- Unix timestamp
+    failed INTEGER NOT NULL DEFAULT 0,           -- 1 once the last attempt failed
+    last_error TEXT,
+    created_at INTEGER NOT NULL,                 -- Unix timestamp
+    UNIQUE (image_id, format, width, height, quality, profile)
+);
+
+CREATE INDEX IF NOT EXISTS idx_render_jobs_ready ON render_jobs(failed, priority DESC, run_after);
+CREATE INDEX IF NOT EXISTS idx_render_jobs_lease ON render_jobs(lease_token);
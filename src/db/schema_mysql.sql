@@ -7,14 +7,35 @@ CREATE TABLE IF NOT EXISTS albums (
     name VARCHAR(255) UNIQUE NOT NULL,
     description TEXT,
     cover_image_id VARCHAR(64),
-    image_ids JSON,         -- JSON array of image IDs
+    image_ids JSON,         -- Legacy JSON array, migrated into album_images on startup
     tags JSON,              -- JSON array of tags
     published BOOLEAN DEFAULT FALSE,
     created_at BIGINT,      -- Unix timestamp
     updated_at BIGINT,      -- Unix timestamp
     INDEX idx_albums_published (published),
     INDEX idx_albums_name (name),
-    INDEX idx_albums_created_at (created_at DESC)
+    INDEX idx_albums_created_at (created_at, album_id)  -- Newest-first listing and its cursors
+) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4 COLLATE=utf8mb4_unicode_ci;
+
+-- Album tags, one row per tag; albums.tags keeps the JSON copy the album reads return
+-- Backfilled from albums.tags on startup
+CREATE TABLE IF NOT EXISTS album_tags (
+    album_id VARCHAR(64) NOT NULL,
+    tag VARCHAR(191) NOT NULL,
+    PRIMARY KEY (album_id, tag),
+    INDEX idx_album_tags_tag (tag, album_id),
+    FOREIGN KEY (album_id) REFERENCES albums(album_id) ON DELETE CASCADE
+) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4 COLLATE=utf8mb4_unicode_ci;
+
+-- Album membership, one row per image
+-- position orders images within an album, removals may leave gaps
+CREATE TABLE IF NOT EXISTS album_images (
+    album_id VARCHAR(64) NOT NULL,
+    image_id VARCHAR(64) NOT NULL,
+    position INT NOT NULL,
+    PRIMARY KEY (album_id, image_id),
+    INDEX idx_album_images_position (album_id, position),
+    FOREIGN KEY (album_id) REFERENCES albums(album_id) ON DELETE CASCADE
 ) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4 COLLATE=utf8mb4_unicode_ci;
 
 -- Images table
@@ -26,6 +47,42 @@ CREATE TABLE IF NOT EXISTS images (
     width INT,                              -- Image width in pixels
     height INT,                             -- Image height in pixels
     uploaded_at BIGINT NOT NULL,            -- Unix timestamp
-    INDEX idx_images_uploaded_at (uploaded_at DESC),
-    INDEX idx_images_name (name ASC)
+    placeholder VARCHAR(128),               -- BlurHash; added to older databases on startup
+    INDEX idx_images_uploaded_at (uploaded_at, image_id),  -- Serves both sort directions and cursors
+    INDEX idx_images_name (name, image_id)
+) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4 COLLATE=utf8mb4_unicode_ci;
+
+-- Transform index: one row per rendition in the transformed cache
+CREATE TABLE IF NOT EXISTS renditions (
+    storage_key VARCHAR(255) PRIMARY KEY,   -- transformed/<image_id>_<params>.<ext>
+    image_id VARCHAR(64) NOT NULL,          -- Source image
+    size_bytes BIGINT NOT NULL,             -- Encoded size
+    last_accessed BIGINT NOT NULL,          -- Unix timestamp
+    hits BIGINT NOT NULL DEFAULT 0,         -- Accesses since stored
+    INDEX idx_renditions_image_id (image_id),
+    INDEX idx_renditions_last_accessed (last_accessed),
+    INDEX idx_renditions_hits (hits, last_accessed)
+) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4 COLLATE=utf8mb4_unicode_ci;
+
+-- Background rendition jobs, one per image and parameter set
+-- Claimed by leasing: a job whose lease runs out is claimed again
+CREATE TABLE IF NOT EXISTS render_jobs (
+    job_id BIGINT AUTO_INCREMENT PRIMARY KEY,
+    image_id VARCHAR(64) NOT NULL,
+    format VARCHAR(16) NOT NULL,
+    width INT NOT NULL,
+    height INT NOT NULL,
+    quality INT NOT NULL DEFAULT 0,              -- 0 = profile default
+    profile VARCHAR(32) NOT NULL DEFAULT '',     -- Encoder profile name, '' = the default
+    priority INT NOT NULL DEFAULT 0,             -- Higher is claimed first
+    attempts INT NOT NULL DEFAULT 0,             -- Claims so far
+    run_after BIGINT NOT NULL,                   -- Unix timestamp; not claimed before
+    lease_token VARCHAR(128),                    -- Claim holding the job
+    lease_expires_at BIGINT NOT NULL DEFAULT 0,  -- Unix timestamp
+    failed BOOLEAN NOT NULL DEFAULT FALSE,       -- Set once the last attempt failed
+    last_error TEXT,
+    created_at BIGINT NOT NULL,                  -- Unix timestamp
+    UNIQUE KEY uq_render_jobs_rendition (image_id, format, width, height, quality, profile),
+    INDEX idx_render_jobs_ready (failed, priority DESC, run_after),
+    INDEX idx_render_jobs_lease (lease_token)
 ) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4 COLLATE=utf8mb4_unicode_ci;
@@ -1,40 +1,253 @@
 #include "sqlite_client.h"
 #include "../utils/logger.h"
 #include <nlohmann/json.hpp>
+#include <algorithm>
+#include <cstdlib>
 #include <fstream>
 #include <sstream>
 #include <stdexcept>
+#include <unordered_set>
 
 using json = nlohmann::json;
 
 namespace gara {
 
-SQLiteClient::SQLiteClient(const std::string& db_path)
-    : db_(nullptr), db_path_(db_path) {
+namespace {
+
+// Returns a cached statement to a clean state when the caller is done with it,
+// so a read that stopped at its first row does not keep its snapshot open.
+class StatementReset {
+public:
+    explicit StatementReset(sqlite3_stmt* stmt) : stmt_(stmt) {}
+    ~StatementReset() {
+        if (stmt_) {
+            sqlite3_reset(stmt_);
+            sqlite3_clear_bindings(stmt_);
+        }
+    }
+
+    StatementReset(const StatementReset&) = delete;
+    StatementReset& operator=(const StatementReset&) = delete;
+
+private:
+    sqlite3_stmt* stmt_;
+};
+
+// Runs a block of writes as one transaction, rolling back unless committed
+class Transaction {
+public:
+    explicit Transaction(sqlite3* db) : db_(db), active_(exec("BEGIN IMMEDIATE")) {}
+    ~Transaction() {
+        if (active_) {
+            exec("ROLLBACK");
+        }
+    }
+
+    Transaction(const Transaction&) = delete;
+    Transaction& operator=(const Transaction&) = delete;
+
+    bool active() const { return active_; }
+
+    bool commit() {
+        if (!active_ || !exec("COMMIT")) {
+            return false;
+        }
+        active_ = false;
+        return true;
+    }
+
+private:
+    bool exec(const char* sql) {
+        char* error_msg = nullptr;
+        if (sqlite3_exec(db_, sql, nullptr, nullptr, &error_msg) != SQLITE_OK) {
+            LOG_ERROR("SQLite {} failed: {}", sql, error_msg ? error_msg : "Unknown error");
+            sqlite3_free(error_msg);
+            return false;
+        }
+        return true;
+    }
+
+    sqlite3* db_;
+    bool active_;
+};
+
+bool isInMemoryPath(const std::string& db_path) {
+    return db_path.empty() || db_path == ":memory:" ||
+           db_path.find("mode=memory") != std::string::npos;
+}
+
+} // anonymous namespace
+
+SQLiteConfig SQLiteConfig::fromEnvironment() {
+    SQLiteConfig config;
+
+    if (const char* readers = std::getenv("SQLITE_READ_CONNECTIONS")) {
+        try {
+            config.read_connections = std::max(0, std::stoi(readers));
+        } catch (...) {
+            LOG_WARN("Invalid SQLITE_READ_CONNECTIONS value, using default {}", config.read_connections);
+        }
+    }
+    if (const char* mmap_size = std::getenv("SQLITE_MMAP_SIZE")) {
+        try {
+            config.mmap_size = std::max(0LL, std::stoll(mmap_size));
+        } catch (...) {
+            LOG_WARN("Invalid SQLITE_MMAP_SIZE value, using default {}", config.mmap_size);
+        }
+    }
+    if (const char* cache_size = std::getenv("SQLITE_CACHE_SIZE_KB")) {
+        try {
+            config.cache_size_kb = std::max(0, std::stoi(cache_size));
+        } catch (...) {
+            LOG_WARN("Invalid SQLITE_CACHE_SIZE_KB value, using default {}", config.cache_size_kb);
+        }
+    }
+    if (const char* busy_timeout = std::getenv("SQLITE_BUSY_TIMEOUT_MS")) {
+        try {
+            config.busy_timeout_ms = std::max(0, std::stoi(busy_timeout));
+        } catch (...) {
+            LOG_WARN("Invalid SQLITE_BUSY_TIMEOUT_MS value, using default {}", config.busy_timeout_ms);
+        }
+    }
+    if (const char* synchronous = std::getenv("SQLITE_SYNCHRONOUS")) {
+        config.synchronous = synchronous;
+    }
 
-    int rc = sqlite3_open(db_path.c_str(), &db_);
+    return config;
+}
+
+SQLiteClient::SQLiteClient(const std::string& db_path, const SQLiteConfig& config)
+    : db_path_(db_path), config_(config) {
+
+    int rc = sqlite3_open(db_path.c_str(), &writer_.db);
     if (rc != SQLITE_OK) {
-        LOG_ERROR("Failed to open SQLite database: {}", sqlite3_errmsg(db_));
+        LOG_ERROR("Failed to open SQLite database: {}", sqlite3_errmsg(writer_.db));
+        sqlite3_close(writer_.db);
+        writer_.db = nullptr;
         throw std::runtime_error("Failed to open database: " + db_path);
     }
 
-    // Enable WAL mode for better concurrency
+    // Enable WAL mode so pooled readers never block behind the writer
     executeSql("PRAGMA journal_mode=WAL");
-    executeSql("PRAGMA synchronous=NORMAL");
+    executeSql("PRAGMA synchronous=" + config_.synchronous);
     executeSql("PRAGMA foreign_keys=ON");
+    configureConnection(writer_.db);
+
+    openReaders();
 
-    LOG_INFO("SQLite database opened: {}", db_path);
+    gara::Logger::log_structured(spdlog::level::info, "SQLite database opened", {
+        {"path", db_path},
+        {"read_connections", readers_.size()},
+        {"mmap_size", config_.mmap_size},
+        {"synchronous", config_.synchronous}
+    });
 }
 
 SQLiteClient::~SQLiteClient() {
-    if (db_) {
-        sqlite3_close(db_);
+    for (auto& reader : readers_) {
+        closeConnection(*reader);
+    }
+    if (writer_.db) {
+        closeConnection(writer_);
         LOG_INFO("SQLite database closed");
     }
 }
 
+void SQLiteClient::configureConnection(sqlite3* db) {
+    sqlite3_busy_timeout(db, config_.busy_timeout_ms);
+
+    std::string pragmas =
+        "PRAGMA mmap_size=" + std::to_string(config_.mmap_size) + ";"
+        "PRAGMA cache_size=-" + std::to_string(config_.cache_size_kb) + ";"
+        "PRAGMA temp_store=MEMORY;";
+
+    char* error_msg = nullptr;
+    if (sqlite3_exec(db, pragmas.c_str(), nullptr, nullptr, &error_msg) != SQLITE_OK) {
+        LOG_WARN("Failed to apply SQLite pragmas: {}", error_msg ? error_msg : "Unknown error");
+        sqlite3_free(error_msg);
+    }
+}
+
+void SQLiteClient::openReaders() {
+    if (config_.read_connections <= 0) {
+        return;
+    }
+    if (isInMemoryPath(db_path_)) {
+        // Each connection to :memory: is a separate database
+        LOG_DEBUG("In-memory SQLite database, reads will use the writer connection");
+        return;
+    }
+
+    for (int i = 0; i < config_.read_connections; ++i) {
+        auto reader = std::make_unique<Connection>();
+        int rc = sqlite3_open_v2(db_path_.c_str(), &reader->db,
+                                 SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX, nullptr);
+        if (rc != SQLITE_OK) {
+            LOG_WARN("Failed to open SQLite read connection: {}", sqlite3_errmsg(reader->db));
+            sqlite3_close(reader->db);
+            break;
+        }
+        configureConnection(reader->db);
+        idle_readers_.push_back(reader.get());
+        readers_.push_back(std::move(reader));
+    }
+}
+
+void SQLiteClient::closeConnection(Connection& conn) {
+    for (auto& entry : conn.statements) {
+        sqlite3_finalize(entry.second);
+    }
+    conn.statements.clear();
+    sqlite3_close(conn.db);
+    conn.db = nullptr;
+}
+
+sqlite3_stmt* SQLiteClient::prepareCached(Connection& conn, const std::string& sql) {
+    auto it = conn.statements.find(sql);
+    if (it != conn.statements.end()) {
+        return it->second;
+    }
+
+    sqlite3_stmt* stmt = nullptr;
+    int rc = sqlite3_prepare_v3(conn.db, sql.c_str(), -1, SQLITE_PREPARE_PERSISTENT, &stmt, nullptr);
+    if (rc != SQLITE_OK) {
+        LOG_ERROR("Failed to prepare statement: {}", sqlite3_errmsg(conn.db));
+        sqlite3_finalize(stmt);
+        return nullptr;
+    }
+
+    conn.statements.emplace(sql, stmt);
+    return stmt;
+}
+
+SQLiteClient::ReadLease::ReadLease(SQLiteClient& client)
+    : client_(client), conn_(nullptr) {
+    if (client_.readers_.empty()) {
+        writer_lock_ = std::unique_lock<utils::InstrumentedMutex>(client_.db_mutex_);
+        conn_ = &client_.writer_;
+        return;
+    }
+
+    std::unique_lock<utils::InstrumentedMutex> lock(client_.readers_mutex_);
+    client_.readers_cv_.wait(lock, [this]() { return !client_.idle_readers_.empty(); });
+    conn_ = client_.idle_readers_.back();
+    client_.idle_readers_.pop_back();
+}
+
+SQLiteClient::ReadLease::~ReadLease() {
+    if (writer_lock_.owns_lock()) {
+        return;
+    }
+
+    {
+        std::lock_guard<utils::InstrumentedMutex> lock(client_.readers_mutex_);
+        client_.idle_readers_.push_back(conn_);
+    }
+    client_.readers_cv_.notify_one();
+}
+
 bool SQLiteClient::initialize() {
-    std::lock_guard<std::mutex> lock(db_mutex_);
+    std::lock_guard<utils::InstrumentedMutex> lock(db_mutex_);
 
     // Read schema file
     std::ifstream schema_file("src/db/schema.sql");
@@ -49,7 +262,7 @@ bool SQLiteClient::initialize() {
 
     // Execute schema
     char* error_msg = nullptr;
-    int rc = sqlite3_exec(db_, schema_sql.c_str(), nullptr, nullptr, &error_msg);
+    int rc = sqlite3_exec(writer_.db, schema_sql.c_str(), nullptr, nullptr, &error_msg);
 
     if (rc != SQLITE_OK) {
         std::string error = error_msg ? error_msg : "Unknown error";
@@ -58,13 +271,139 @@ bool SQLiteClient::initialize() {
         return false;
     }
 
+    if (!migrateLegacyImageIds() || !migrateImagePlaceholderColumn() || !migrateAlbumTags()) {
+        return false;
+    }
+
     LOG_INFO("Database schema initialized successfully");
     return true;
 }
 
+bool SQLiteClient::migrateImagePlaceholderColumn() {
+    Connection& conn = writer_;
+
+    sqlite3_stmt* stmt = prepareCached(conn, "SELECT 1 FROM pragma_table_info('images') WHERE name = 'placeholder'");
+    if (!stmt) {
+        return false;
+    }
+    bool present;
+    {
+        StatementReset reset(stmt);
+        present = sqlite3_step(stmt) == SQLITE_ROW;
+    }
+    if (present) {
+        return true;
+    }
+
+    char* error_msg = nullptr;
+    if (sqlite3_exec(conn.db, "ALTER TABLE images ADD COLUMN placeholder TEXT", nullptr, nullptr,
+                     &error_msg) != SQLITE_OK) {
+        LOG_ERROR("Failed to add images.placeholder: {}", error_msg ? error_msg : "Unknown error");
+        sqlite3_free(error_msg);
+        return false;
+    }
+
+    LOG_INFO("Added placeholder column to images");
+    return true;
+}
+
+bool SQLiteClient::migrateAlbumTags() {
+    Connection& conn = writer_;
+
+    // Albums written before album_tags existed have tags only in the JSON column
+    const char* sql = R"(
+        INSERT OR IGNORE INTO album_tags (album_id, tag)
+        SELECT a.album_id, t.value FROM albums a, json_each(a.tags) t
+        WHERE a.tags IS NOT NULL AND json_valid(a.tags) AND a.tags != '[]'
+          AND NOT EXISTS (SELECT 1 FROM album_tags x WHERE x.album_id = a.album_id)
+    )";
+
+    char* error_msg = nullptr;
+    if (sqlite3_exec(conn.db, sql, nullptr, nullptr, &error_msg) != SQLITE_OK) {
+        LOG_ERROR("Failed to backfill album_tags: {}", error_msg ? error_msg : "Unknown error");
+        sqlite3_free(error_msg);
+        return false;
+    }
+
+    int rows = sqlite3_changes(conn.db);
+    if (rows > 0) {
+        gara::Logger::log_structured(spdlog::level::info, "Backfilled album_tags from albums.tags", {
+            {"rows", rows}
+        });
+    }
+    return true;
+}
+
+bool SQLiteClient::migrateLegacyImageIds() {
+    Connection& conn = writer_;
+
+    const char* select_sql = R"(
+        SELECT album_id, image_ids FROM albums
+        WHERE image_ids IS NOT NULL AND image_ids NOT IN ('', '[]')
+    )";
+
+    std::vector<std::pair<std::string, std::vector<std::string>>> legacy;
+    {
+        sqlite3_stmt* stmt = prepareCached(conn, select_sql);
+        if (!stmt) {
+            return false;
+        }
+        StatementReset reset(stmt);
+
+        while (sqlite3_step(stmt) == SQLITE_ROW) {
+            std::string album_id = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+            const char* image_ids_json = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
+            legacy.emplace_back(album_id, jsonToVector(image_ids_json ? image_ids_json : "[]"));
+        }
+    }
+
+    if (legacy.empty()) {
+        return true;
+    }
+
+    Transaction txn(conn.db);
+    if (!txn.active()) {
+        return false;
+    }
+
+    sqlite3_stmt* clear = prepareCached(conn, "UPDATE albums SET image_ids = NULL WHERE album_id = ?");
+    if (!clear) {
+        return false;
+    }
+    StatementReset reset(clear);
+
+    for (auto& [album_id, image_ids] : legacy) {
+        // Older rows could hold the same ID twice; keep its first position
+        std::unordered_set<std::string> seen;
+        image_ids.erase(std::remove_if(image_ids.begin(), image_ids.end(),
+                                       [&seen](const std::string& id) { return !seen.insert(id).second; }),
+                        image_ids.end());
+
+        if (!insertAlbumImages(conn, album_id, image_ids, 0)) {
+            return false;
+        }
+
+        sqlite3_bind_text(clear, 1, album_id.c_str(), -1, SQLITE_TRANSIENT);
+        if (sqlite3_step(clear) != SQLITE_DONE) {
+            LOG_ERROR("Failed to clear legacy image_ids: {}", sqlite3_errmsg(conn.db));
+            return false;
+        }
+        sqlite3_reset(clear);
+    }
+
+    if (!txn.commit()) {
+        return false;
+    }
+
+    gara::Logger::log_structured(spdlog::level::info, "Migrated album image_ids into album_images", {
+        {"albums", legacy.size()}
+    });
+    return true;
+}
+
 bool SQLiteClient::executeSql(const std::string& sql) {
     char* error_msg = nullptr;
-    int rc = sqlite3_exec(db_, sql.c_str(), nullptr, nullptr, &error_msg);
+    int rc = sqlite3_exec(writer_.db, sql.c_str(), nullptr, nullptr, &error_msg);
 
     if (rc != SQLITE_OK) {
         std::string error = error_msg ? error_msg : "Unknown error";
@@ -105,43 +444,169 @@ Album SQLiteClient::extractAlbum(sqlite3_stmt* stmt) {
     const char* cover = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3));
     album.cover_image_id = cover ? cover : "";
 
-    const char* image_ids_json = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 4));
-    album.image_ids = jsonToVector(image_ids_json ? image_ids_json : "[]");
-
-    const char* tags_json = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 5));
+    const char* tags_json = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 4));
     album.tags = jsonToVector(tags_json ? tags_json : "[]");
 
-    album.published = sqlite3_column_int(stmt, 6) != 0;
-    album.created_at = static_cast<std::time_t>(sqlite3_column_int64(stmt, 7));
-    album.updated_at = static_cast<std::time_t>(sqlite3_column_int64(stmt, 8));
+    album.published = sqlite3_column_int(stmt, 5) != 0;
+    album.created_at = static_cast<std::time_t>(sqlite3_column_int64(stmt, 6));
+    album.updated_at = static_cast<std::time_t>(sqlite3_column_int64(stmt, 7));
 
     return album;
 }
 
+std::vector<std::string> SQLiteClient::loadAlbumImages(Connection& conn, const std::string& album_id,
+                                                       int limit, int offset) {
+    const char* sql = R"(
+        SELECT image_id FROM album_images
+        WHERE album_id = ?
+        ORDER BY position
+        LIMIT ? OFFSET ?
+    )";
+
+    sqlite3_stmt* stmt = prepareCached(conn, sql);
+    if (!stmt) {
+        return {};
+    }
+    StatementReset reset(stmt);
+
+    sqlite3_bind_text(stmt, 1, album_id.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_int(stmt, 2, limit);
+    sqlite3_bind_int(stmt, 3, offset);
+
+    std::vector<std::string> image_ids;
+
+    int rc;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+        image_ids.emplace_back(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0)));
+    }
+
+    if (rc != SQLITE_DONE) {
+        LOG_ERROR("Failed to load album images: {}", sqlite3_errmsg(conn.db));
+        return {};
+    }
+
+    return image_ids;
+}
+
+bool SQLiteClient::insertAlbumImages(Connection& conn, const std::string& album_id,
+                                     const std::vector<std::string>& image_ids, int first_position) {
+    const char* sql = "INSERT INTO album_images (album_id, image_id, position) VALUES (?, ?, ?)";
+
+    sqlite3_stmt* stmt = prepareCached(conn, sql);
+    if (!stmt) {
+        return false;
+    }
+    StatementReset reset(stmt);
+
+    sqlite3_bind_text(stmt, 1, album_id.c_str(), -1, SQLITE_TRANSIENT);
+    for (size_t i = 0; i < image_ids.size(); ++i) {
+        sqlite3_bind_text(stmt, 2, image_ids[i].c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_int(stmt, 3, first_position + static_cast<int>(i));
+
+        if (sqlite3_step(stmt) != SQLITE_DONE) {
+            LOG_ERROR("Failed to insert album image: {}", sqlite3_errmsg(conn.db));
+            return false;
+        }
+        sqlite3_reset(stmt);
+    }
+
+    return true;
+}
+
+bool SQLiteClient::touchAlbum(Connection& conn, const std::string& album_id, std::time_t updated_at) {
+    const char* sql = "UPDATE albums SET updated_at = ? WHERE album_id = ?";
+
+    sqlite3_stmt* stmt = prepareCached(conn, sql);
+    if (!stmt) {
+        return false;
+    }
+    StatementReset reset(stmt);
+
+    sqlite3_bind_int64(stmt, 1, static_cast<sqlite3_int64>(updated_at));
+    sqlite3_bind_text(stmt, 2, album_id.c_str(), -1, SQLITE_STATIC);
+
+    if (sqlite3_step(stmt) != SQLITE_DONE) {
+        LOG_ERROR("Failed to update album timestamp: {}", sqlite3_errmsg(conn.db));
+        return false;
+    }
+
+    return sqlite3_changes(conn.db) > 0;
+}
+
+bool SQLiteClient::replaceAlbumTags(Connection& conn, const std::string& album_id,
+                                    const std::vector<std::string>& tags) {
+    sqlite3_stmt* clear = prepareCached(conn, "DELETE FROM album_tags WHERE album_id = ?");
+    if (!clear) {
+        return false;
+    }
+    {
+        StatementReset reset(clear);
+        sqlite3_bind_text(clear, 1, album_id.c_str(), -1, SQLITE_STATIC);
+        if (sqlite3_step(clear) != SQLITE_DONE) {
+            LOG_ERROR("Failed to clear album tags: {}", sqlite3_errmsg(conn.db));
+            return false;
+        }
+    }
+
+    // A tag listed twice is stored once
+    sqlite3_stmt* stmt = prepareCached(conn, "INSERT OR IGNORE INTO album_tags (album_id, tag) VALUES (?, ?)");
+    if (!stmt) {
+        return false;
+    }
+    StatementReset reset(stmt);
+
+    sqlite3_bind_text(stmt, 1, album_id.c_str(), -1, SQLITE_STATIC);
+    for (const auto& tag : tags) {
+        sqlite3_bind_text(stmt, 2, tag.c_str(), -1, SQLITE_STATIC);
+        if (sqlite3_step(stmt) != SQLITE_DONE) {
+            LOG_ERROR("Failed to insert album tag: {}", sqlite3_errmsg(conn.db));
+            return false;
+        }
+        sqlite3_reset(stmt);
+    }
+
+    return true;
+}
+
 bool SQLiteClient::putAlbum(const Album& album) {
-    std::lock_guard<std::mutex> lock(db_mutex_);
+    std::lock_guard<utils::InstrumentedMutex> lock(db_mutex_);
+    Connection& conn = writer_;
+
+    Transaction txn(conn.db);
+    if (!txn.active()) {
+        return false;
+    }
+
+    bool is_new = true;
+    {
+        sqlite3_stmt* stmt = prepareCached(conn, "SELECT 1 FROM albums WHERE album_id = ?");
+        if (!stmt) {
+            return false;
+        }
+        StatementReset reset(stmt);
+
+        sqlite3_bind_text(stmt, 1, album.album_id.c_str(), -1, SQLITE_STATIC);
+        is_new = sqlite3_step(stmt) != SQLITE_ROW;
+    }
 
     const char* sql = R"(
         INSERT INTO albums (album_id, name, description, cover_image_id,
-                          image_ids, tags, published, created_at, updated_at)
-        VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?)
+                          tags, published, created_at, updated_at)
+        VALUES (?, ?, ?, ?, ?, ?, ?, ?)
         ON CONFLICT(album_id) DO UPDATE SET
             name = excluded.name,
             description = excluded.description,
             cover_image_id = excluded.cover_image_id,
-            image_ids = excluded.image_ids,
             tags = excluded.tags,
             published = excluded.published,
             updated_at = excluded.updated_at
     )";
 
-    sqlite3_stmt* stmt;
-    int rc = sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr);
-
-    if (rc != SQLITE_OK) {
-        LOG_ERROR("Failed to prepare statement: {}", sqlite3_errmsg(db_));
+    sqlite3_stmt* stmt = prepareCached(conn, sql);
+    if (!stmt) {
         return false;
     }
+    StatementReset reset(stmt);
 
     // Bind parameters
     sqlite3_bind_text(stmt, 1, album.album_id.c_str(), -1, SQLITE_TRANSIENT);
@@ -149,21 +614,29 @@ bool SQLiteClient::putAlbum(const Album& album) {
     sqlite3_bind_text(stmt, 3, album.description.c_str(), -1, SQLITE_TRANSIENT);
     sqlite3_bind_text(stmt, 4, album.cover_image_id.c_str(), -1, SQLITE_TRANSIENT);
 
-    std::string image_ids_json = vectorToJson(album.image_ids);
-    sqlite3_bind_text(stmt, 5, image_ids_json.c_str(), -1, SQLITE_TRANSIENT);
-
     std::string tags_json = vectorToJson(album.tags);
-    sqlite3_bind_text(stmt, 6, tags_json.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(stmt, 5, tags_json.c_str(), -1, SQLITE_TRANSIENT);
 
-    sqlite3_bind_int(stmt, 7, album.published ? 1 : 0);
-    sqlite3_bind_int64(stmt, 8, static_cast<sqlite3_int64>(album.created_at));
-    sqlite3_bind_int64(stmt, 9, static_cast<sqlite3_int64>(album.updated_at));
+    sqlite3_bind_int(stmt, 6, album.published ? 1 : 0);
+    sqlite3_bind_int64(stmt, 7, static_cast<sqlite3_int64>(album.created_at));
+    sqlite3_bind_int64(stmt, 8, static_cast<sqlite3_int64>(album.updated_at));
 
-    rc = sqlite3_step(stmt);
-    sqlite3_finalize(stmt);
+    int rc = sqlite3_step(stmt);
 
     if (rc != SQLITE_DONE) {
-        LOG_ERROR("Failed to execute putAlbum: {}", sqlite3_errmsg(db_));
+        LOG_ERROR("Failed to execute putAlbum: {}", sqlite3_errmsg(conn.db));
+        return false;
+    }
+
+    if (is_new && !insertAlbumImages(conn, album.album_id, album.image_ids, 0)) {
+        return false;
+    }
+
+    if (!replaceAlbumTags(conn, album.album_id, album.tags)) {
+        return false;
+    }
+
+    if (!txn.commit()) {
         return false;
     }
 
@@ -171,107 +644,240 @@ bool SQLiteClient::putAlbum(const Album& album) {
     return true;
 }
 
-std::optional<Album> SQLiteClient::getAlbum(const std::string& album_id) {
-    std::lock_guard<std::mutex> lock(db_mutex_);
+std::optional<Album> SQLiteClient::getAlbum(const std::string& album_id, bool include_images) {
+    ReadLease lease(*this);
+    Connection& conn = lease.connection();
+
+    std::optional<Album> album;
+    {
+        const char* sql = R"(
+            SELECT album_id, name, description, cover_image_id,
+                   tags, published, created_at, updated_at
+            FROM albums
+            WHERE album_id = ?
+        )";
+
+        sqlite3_stmt* stmt = prepareCached(conn, sql);
+        if (!stmt) {
+            return std::nullopt;
+        }
+        StatementReset reset(stmt);
+
+        sqlite3_bind_text(stmt, 1, album_id.c_str(), -1, SQLITE_STATIC);
+
+        int rc = sqlite3_step(stmt);
+
+        if (rc == SQLITE_ROW) {
+            album = extractAlbum(stmt);
+        } else if (rc != SQLITE_DONE) {
+            LOG_ERROR("Failed to execute getAlbum: {}", sqlite3_errmsg(conn.db));
+        }
+    }
+
+    if (album && include_images) {
+        album->image_ids = loadAlbumImages(conn, album_id, -1, 0);
+    }
 
-    const char* sql = R"(
-        SELECT album_id, name, description, cover_image_id, image_ids,
+    return album;
+}
+
+std::vector<Album> SQLiteClient::listAlbums(bool published_only) {
+    ReadLease lease(*this);
+    Connection& conn = lease.connection();
+
+    std::string sql = R"(
+        SELECT album_id, name, description, cover_image_id,
                tags, published, created_at, updated_at
         FROM albums
-        WHERE album_id = ?
     )";
 
-    sqlite3_stmt* stmt;
-    int rc = sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr);
+    if (published_only) {
+        sql += " WHERE published = 1";
+    }
+
+    sql += " ORDER BY created_at DESC";
 
-    if (rc != SQLITE_OK) {
-        LOG_ERROR("Failed to prepare statement: {}", sqlite3_errmsg(db_));
-        return std::nullopt;
+    sqlite3_stmt* stmt = prepareCached(conn, sql);
+    if (!stmt) {
+        return {};
     }
+    StatementReset reset(stmt);
 
-    sqlite3_bind_text(stmt, 1, album_id.c_str(), -1, SQLITE_STATIC);
+    std::vector<Album> albums;
 
-    rc = sqlite3_step(stmt);
+    int rc;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+        albums.push_back(extractAlbum(stmt));
+    }
 
-    if (rc == SQLITE_ROW) {
-        Album album = extractAlbum(stmt);
-        sqlite3_finalize(stmt);
-        return album;
+    if (rc != SQLITE_DONE) {
+        LOG_ERROR("Failed to execute listAlbums: {}", sqlite3_errmsg(conn.db));
+        return {};
+    }
+
+    // Fill every album's membership from one ordered scan
+    std::unordered_map<std::string, Album*> by_id;
+    for (auto& album : albums) {
+        by_id[album.album_id] = &album;
+    }
+
+    std::string images_sql = "SELECT ai.album_id, ai.image_id FROM album_images ai";
+    if (published_only) {
+        images_sql += " JOIN albums a ON a.album_id = ai.album_id WHERE a.published = 1";
     }
+    images_sql += " ORDER BY ai.album_id, ai.position";
 
-    sqlite3_finalize(stmt);
+    sqlite3_stmt* images_stmt = prepareCached(conn, images_sql);
+    if (!images_stmt) {
+        return {};
+    }
+    StatementReset images_reset(images_stmt);
+
+    while ((rc = sqlite3_step(images_stmt)) == SQLITE_ROW) {
+        auto it = by_id.find(reinterpret_cast<const char*>(sqlite3_column_text(images_stmt, 0)));
+        if (it != by_id.end()) {
+            it->second->image_ids.emplace_back(
+                reinterpret_cast<const char*>(sqlite3_column_text(images_stmt, 1)));
+        }
+    }
 
     if (rc != SQLITE_DONE) {
-        LOG_ERROR("Failed to execute getAlbum: {}", sqlite3_errmsg(db_));
+        LOG_ERROR("Failed to load album images for listAlbums: {}", sqlite3_errmsg(conn.db));
+        return {};
     }
 
-    return std::nullopt;
+    LOG_DEBUG("Listed {} albums", albums.size());
+    return albums;
 }
 
-std::vector<Album> SQLiteClient::listAlbums(bool published_only) {
-    std::lock_guard<std::mutex> lock(db_mutex_);
+std::vector<Album> SQLiteClient::listAlbumsAfter(const AlbumQuery& query, int limit,
+                                                 const std::optional<AlbumPageCursor>& after) {
+    ReadLease lease(*this);
+    Connection& conn = lease.connection();
 
     std::string sql = R"(
-        SELECT album_id, name, description, cover_image_id, image_ids,
+        SELECT album_id, name, description, cover_image_id,
                tags, published, created_at, updated_at
         FROM albums
+        WHERE 1 = 1
     )";
 
-    if (published_only) {
-        sql += " WHERE published = 1";
+    // Albums carrying every requested tag, found on idx_album_tags_tag
+    std::vector<std::string> tags = query.tags;
+    std::sort(tags.begin(), tags.end());
+    tags.erase(std::unique(tags.begin(), tags.end()), tags.end());
+    if (!tags.empty()) {
+        sql += " AND album_id IN (SELECT album_id FROM album_tags WHERE tag IN (?";
+        for (size_t i = 1; i < tags.size(); ++i) {
+            sql += ", ?";
+        }
+        sql += ") GROUP BY album_id HAVING COUNT(*) = " + std::to_string(tags.size()) + ")";
+    }
+    if (query.published_only) {
+        sql += " AND published = 1";
+    }
+    if (after) {
+        sql += " AND created_at <= ? AND (created_at < ? OR album_id < ?)";
     }
+    sql += " ORDER BY created_at DESC, album_id DESC LIMIT ?";
 
-    sql += " ORDER BY created_at DESC";
+    std::vector<Album> albums;
+    {
+        sqlite3_stmt* stmt = prepareCached(conn, sql);
+        if (!stmt) {
+            return {};
+        }
+        StatementReset reset(stmt);
+
+        int index = 1;
+        for (const auto& tag : tags) {
+            sqlite3_bind_text(stmt, index++, tag.c_str(), -1, SQLITE_STATIC);
+        }
+        if (after) {
+            sqlite3_bind_int64(stmt, index++, static_cast<sqlite3_int64>(after->created_at));
+            sqlite3_bind_int64(stmt, index++, static_cast<sqlite3_int64>(after->created_at));
+            sqlite3_bind_text(stmt, index++, after->album_id.c_str(), -1, SQLITE_STATIC);
+        }
+        sqlite3_bind_int(stmt, index, limit);
+
+        int rc;
+        while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+            albums.push_back(extractAlbum(stmt));
+        }
+
+        if (rc != SQLITE_DONE) {
+            LOG_ERROR("Failed to execute listAlbumsAfter: {}", sqlite3_errmsg(conn.db));
+            return {};
+        }
+    }
 
-    sqlite3_stmt* stmt;
-    int rc = sqlite3_prepare_v2(db_, sql.c_str(), -1, &stmt, nullptr);
+    if (albums.empty()) {
+        return albums;
+    }
 
-    if (rc != SQLITE_OK) {
-        LOG_ERROR("Failed to prepare statement: {}", sqlite3_errmsg(db_));
-        return {};
+    // Membership of just this page, in one ordered read
+    std::unordered_map<std::string, Album*> by_id;
+    std::vector<std::string> album_ids;
+    for (auto& album : albums) {
+        by_id[album.album_id] = &album;
+        album_ids.push_back(album.album_id);
     }
 
-    std::vector<Album> albums;
+    const char* images_sql = R"(
+        SELECT album_id, image_id FROM album_images
+        WHERE album_id IN (SELECT value FROM json_each(?))
+        ORDER BY album_id, position
+    )";
 
-    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
-        albums.push_back(extractAlbum(stmt));
+    sqlite3_stmt* images_stmt = prepareCached(conn, images_sql);
+    if (!images_stmt) {
+        return {};
+    }
+    StatementReset images_reset(images_stmt);
+
+    std::string ids_json = vectorToJson(album_ids);
+    sqlite3_bind_text(images_stmt, 1, ids_json.c_str(), -1, SQLITE_STATIC);
+
+    int rc;
+    while ((rc = sqlite3_step(images_stmt)) == SQLITE_ROW) {
+        auto it = by_id.find(reinterpret_cast<const char*>(sqlite3_column_text(images_stmt, 0)));
+        if (it != by_id.end()) {
+            it->second->image_ids.emplace_back(
+                reinterpret_cast<const char*>(sqlite3_column_text(images_stmt, 1)));
+        }
     }
-
-    sqlite3_finalize(stmt);
 
     if (rc != SQLITE_DONE) {
-        LOG_ERROR("Failed to execute listAlbums: {}", sqlite3_errmsg(db_));
+        LOG_ERROR("Failed to load album images for listAlbumsAfter: {}", sqlite3_errmsg(conn.db));
         return {};
     }
 
-    LOG_DEBUG("Listed {} albums", albums.size());
+    LOG_DEBUG("Listed {} albums after cursor", albums.size());
     return albums;
 }
 
 bool SQLiteClient::deleteAlbum(const std::string& album_id) {
-    std::lock_guard<std::mutex> lock(db_mutex_);
+    std::lock_guard<utils::InstrumentedMutex> lock(db_mutex_);
+    Connection& conn = writer_;
 
     const char* sql = "DELETE FROM albums WHERE album_id = ?";
 
-    sqlite3_stmt* stmt;
-    int rc = sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr);
-
-    if (rc != SQLITE_OK) {
-        LOG_ERROR("Failed to prepare statement: {}", sqlite3_errmsg(db_));
+    sqlite3_stmt* stmt = prepareCached(conn, sql);
+    if (!stmt) {
         return false;
     }
+    StatementReset reset(stmt);
 
     sqlite3_bind_text(stmt, 1, album_id.c_str(), -1, SQLITE_STATIC);
 
-    rc = sqlite3_step(stmt);
-    sqlite3_finalize(stmt);
+    int rc = sqlite3_step(stmt);
 
     if (rc != SQLITE_DONE) {
-        LOG_ERROR("Failed to execute deleteAlbum: {}", sqlite3_errmsg(db_));
+        LOG_ERROR("Failed to execute deleteAlbum: {}", sqlite3_errmsg(conn.db));
         return false;
     }
 
-    int changes = sqlite3_changes(db_);
+    int changes = sqlite3_changes(conn.db);
     LOG_DEBUG("Album deleted: {} (rows affected: {})", album_id, changes);
 
     return changes > 0;
@@ -279,7 +885,8 @@ bool SQLiteClient::deleteAlbum(const std::string& album_id) {
 
 bool SQLiteClient::albumNameExists(const std::string& name,
                                    const std::string& exclude_album_id) {
-    std::lock_guard<std::mutex> lock(db_mutex_);
+    ReadLease lease(*this);
+    Connection& conn = lease.connection();
 
     std::string sql = "SELECT 1 FROM albums WHERE name = ?";
 
@@ -287,13 +894,11 @@ bool SQLiteClient::albumNameExists(const std::string& name,
         sql += " AND album_id != ?";
     }
 
-    sqlite3_stmt* stmt;
-    int rc = sqlite3_prepare_v2(db_, sql.c_str(), -1, &stmt, nullptr);
-
-    if (rc != SQLITE_OK) {
-        LOG_ERROR("Failed to prepare statement: {}", sqlite3_errmsg(db_));
+    sqlite3_stmt* stmt = prepareCached(conn, sql);
+    if (!stmt) {
         return false;
     }
+    StatementReset reset(stmt);
 
     sqlite3_bind_text(stmt, 1, name.c_str(), -1, SQLITE_STATIC);
 
@@ -301,66 +906,345 @@ bool SQLiteClient::albumNameExists(const std::string& name,
         sqlite3_bind_text(stmt, 2, exclude_album_id.c_str(), -1, SQLITE_STATIC);
     }
 
-    rc = sqlite3_step(stmt);
+    int rc = sqlite3_step(stmt);
     bool exists = (rc == SQLITE_ROW);
 
-    sqlite3_finalize(stmt);
     return exists;
 }
 
-// Image metadata operations
+// Album membership operations
 
-ImageMetadata SQLiteClient::extractImageMetadata(sqlite3_stmt* stmt) {
-    ImageMetadata metadata;
+bool SQLiteClient::addAlbumImages(const std::string& album_id,
+                                  const std::vector<std::string>& image_ids,
+                                  int position, std::time_t updated_at) {
+    std::lock_guard<utils::InstrumentedMutex> lock(db_mutex_);
+    Connection& conn = writer_;
 
-    metadata.image_id = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
-    metadata.name = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
-    metadata.original_format = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2));
-    metadata.original_size = static_cast<size_t>(sqlite3_column_int64(stmt, 3));
-    metadata.width = sqlite3_column_int(stmt, 4);
-    metadata.height = sqlite3_column_int(stmt, 5);
-    metadata.upload_timestamp = static_cast<std::time_t>(sqlite3_column_int64(stmt, 6));
+    Transaction txn(conn.db);
+    if (!txn.active() || !touchAlbum(conn, album_id, updated_at)) {
+        return false;
+    }
 
-    return metadata;
-}
+    // Stored positions may have gaps, so find the one currently at the given index
+    std::optional<int> insert_at;
+    if (position >= 0) {
+        sqlite3_stmt* stmt = prepareCached(conn, R"(
+            SELECT position FROM album_images
+            WHERE album_id = ?
+            ORDER BY position
+            LIMIT 1 OFFSET ?
+        )");
+        if (!stmt) {
+            return false;
+        }
+        StatementReset reset(stmt);
+
+        sqlite3_bind_text(stmt, 1, album_id.c_str(), -1, SQLITE_STATIC);
+        sqlite3_bind_int(stmt, 2, position);
+        if (sqlite3_step(stmt) == SQLITE_ROW) {
+            insert_at = sqlite3_column_int(stmt, 0);
+        }
+    }
+
+    int first_position = 0;
+    if (insert_at) {
+        sqlite3_stmt* stmt = prepareCached(conn, R"(
+            UPDATE album_images SET position = position + ?
+            WHERE album_id = ? AND position >= ?
+        )");
+        if (!stmt) {
+            return false;
+        }
+        StatementReset reset(stmt);
+
+        sqlite3_bind_int(stmt, 1, static_cast<int>(image_ids.size()));
+        sqlite3_bind_text(stmt, 2, album_id.c_str(), -1, SQLITE_STATIC);
+        sqlite3_bind_int(stmt, 3, *insert_at);
+        if (sqlite3_step(stmt) != SQLITE_DONE) {
+            LOG_ERROR("Failed to shift album images: {}", sqlite3_errmsg(conn.db));
+            return false;
+        }
+        first_position = *insert_at;
+    } else {
+        sqlite3_stmt* stmt = prepareCached(conn,
+            "SELECT COALESCE(MAX(position) + 1, 0) FROM album_images WHERE album_id = ?");
+        if (!stmt) {
+            return false;
+        }
+        StatementReset reset(stmt);
+
+        sqlite3_bind_text(stmt, 1, album_id.c_str(), -1, SQLITE_STATIC);
+        if (sqlite3_step(stmt) != SQLITE_ROW) {
+            LOG_ERROR("Failed to find album end position: {}", sqlite3_errmsg(conn.db));
+            return false;
+        }
+        first_position = sqlite3_column_int(stmt, 0);
+    }
+
+    if (!insertAlbumImages(conn, album_id, image_ids, first_position) || !txn.commit()) {
+        return false;
+    }
+
+    LOG_DEBUG("Added {} images to album {}", image_ids.size(), album_id);
+    return true;
+}
+
+bool SQLiteClient::removeAlbumImage(const std::string& album_id, const std::string& image_id,
+                                    std::time_t updated_at) {
+    std::lock_guard<utils::InstrumentedMutex> lock(db_mutex_);
+    Connection& conn = writer_;
+
+    Transaction txn(conn.db);
+    if (!txn.active()) {
+        return false;
+    }
+
+    {
+        sqlite3_stmt* stmt = prepareCached(conn,
+            "DELETE FROM album_images WHERE album_id = ? AND image_id = ?");
+        if (!stmt) {
+            return false;
+        }
+        StatementReset reset(stmt);
+
+        sqlite3_bind_text(stmt, 1, album_id.c_str(), -1, SQLITE_STATIC);
+        sqlite3_bind_text(stmt, 2, image_id.c_str(), -1, SQLITE_STATIC);
+        if (sqlite3_step(stmt) != SQLITE_DONE) {
+            LOG_ERROR("Failed to execute removeAlbumImage: {}", sqlite3_errmsg(conn.db));
+            return false;
+        }
+        if (sqlite3_changes(conn.db) == 0) {
+            return false;
+        }
+    }
+
+    if (!touchAlbum(conn, album_id, updated_at) || !txn.commit()) {
+        return false;
+    }
+
+    LOG_DEBUG("Removed image {} from album {}", image_id, album_id);
+    return true;
+}
+
+bool SQLiteClient::reorderAlbumImages(const std::string& album_id,
+                                      const std::vector<std::string>& image_ids,
+                                      std::time_t updated_at) {
+    std::lock_guard<utils::InstrumentedMutex> lock(db_mutex_);
+    Connection& conn = writer_;
+
+    Transaction txn(conn.db);
+    if (!txn.active() || !touchAlbum(conn, album_id, updated_at)) {
+        return false;
+    }
+
+    sqlite3_stmt* stmt = prepareCached(conn,
+        "UPDATE album_images SET position = ? WHERE album_id = ? AND image_id = ?");
+    if (!stmt) {
+        return false;
+    }
+    StatementReset reset(stmt);
+
+    sqlite3_bind_text(stmt, 2, album_id.c_str(), -1, SQLITE_STATIC);
+    for (size_t i = 0; i < image_ids.size(); ++i) {
+        sqlite3_bind_int(stmt, 1, static_cast<int>(i));
+        sqlite3_bind_text(stmt, 3, image_ids[i].c_str(), -1, SQLITE_STATIC);
+
+        if (sqlite3_step(stmt) != SQLITE_DONE) {
+            LOG_ERROR("Failed to execute reorderAlbumImages: {}", sqlite3_errmsg(conn.db));
+            return false;
+        }
+        sqlite3_reset(stmt);
+    }
+
+    if (!txn.commit()) {
+        return false;
+    }
+
+    LOG_DEBUG("Reordered {} images in album {}", image_ids.size(), album_id);
+    return true;
+}
+
+std::vector<std::string> SQLiteClient::listAlbumImages(const std::string& album_id,
+                                                       int limit, int offset) {
+    ReadLease lease(*this);
+    return loadAlbumImages(lease.connection(), album_id, limit, offset);
+}
+
+int SQLiteClient::getAlbumImageCount(const std::string& album_id) {
+    ReadLease lease(*this);
+    Connection& conn = lease.connection();
+
+    const char* sql = "SELECT COUNT(*) FROM album_images WHERE album_id = ?";
+
+    sqlite3_stmt* stmt = prepareCached(conn, sql);
+    if (!stmt) {
+        return 0;
+    }
+    StatementReset reset(stmt);
+
+    sqlite3_bind_text(stmt, 1, album_id.c_str(), -1, SQLITE_STATIC);
+
+    int rc = sqlite3_step(stmt);
+    if (rc != SQLITE_ROW) {
+        LOG_ERROR("Failed to execute getAlbumImageCount: {}", sqlite3_errmsg(conn.db));
+        return 0;
+    }
+
+    return sqlite3_column_int(stmt, 0);
+}
+
+std::optional<std::unordered_set<std::string>> SQLiteClient::albumImagesContained(
+    const std::string& album_id, const std::vector<std::string>& image_ids) {
+    if (image_ids.empty()) {
+        return std::unordered_set<std::string>{};
+    }
+
+    ReadLease lease(*this);
+    Connection& conn = lease.connection();
+
+    // Primary key lookups, one per ID; the album's other rows are never read
+    const char* sql = R"(
+        SELECT image_id FROM album_images
+        WHERE album_id = ? AND image_id IN (SELECT value FROM json_each(?))
+    )";
+
+    sqlite3_stmt* stmt = prepareCached(conn, sql);
+    if (!stmt) {
+        return std::nullopt;
+    }
+    StatementReset reset(stmt);
+
+    std::string ids_json = vectorToJson(image_ids);
+    sqlite3_bind_text(stmt, 1, album_id.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 2, ids_json.c_str(), -1, SQLITE_STATIC);
+
+    std::unordered_set<std::string> found;
+
+    int rc;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+        found.emplace(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0)));
+    }
+
+    if (rc != SQLITE_DONE) {
+        LOG_ERROR("Failed to execute albumImagesContained: {}", sqlite3_errmsg(conn.db));
+        return std::nullopt;
+    }
+
+    return found;
+}
+
+// Image metadata operations
+
+ImageMetadata SQLiteClient::extractImageMetadata(sqlite3_stmt* stmt) {
+    ImageMetadata metadata;
+
+    metadata.image_id = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+    metadata.name = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
+    metadata.original_format = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2));
+    metadata.original_size = static_cast<size_t>(sqlite3_column_int64(stmt, 3));
+    metadata.width = sqlite3_column_int(stmt, 4);
+    metadata.height = sqlite3_column_int(stmt, 5);
+    metadata.upload_timestamp = static_cast<std::time_t>(sqlite3_column_int64(stmt, 6));
+    if (const unsigned char* placeholder = sqlite3_column_text(stmt, 7)) {
+        metadata.placeholder = reinterpret_cast<const char*>(placeholder);
+    }
+
+    // Raw objects are stored under a key derived from the original format
+    if (!metadata.original_format.empty()) {
+        metadata.s3_raw_key = ImageMetadata::generateRawKey(metadata.image_id, metadata.original_format);
+    }
+
+    return metadata;
+}
 
 std::string SQLiteClient::getSortOrderSql(ImageSortOrder sort_order) {
+    // image_id breaks ties so pages are stable and match the composite indexes
     switch (sort_order) {
         case ImageSortOrder::NEWEST:
-            return "uploaded_at DESC";
+            return "uploaded_at DESC, image_id DESC";
+        case ImageSortOrder::OLDEST:
+            return "uploaded_at ASC, image_id ASC";
+        case ImageSortOrder::NAME_ASC:
+            return "name ASC, image_id ASC";
+        case ImageSortOrder::NAME_DESC:
+            return "name DESC, image_id DESC";
+        default:
+            return "uploaded_at DESC, image_id DESC";
+    }
+}
+
+std::string SQLiteClient::getKeysetConditionSql(ImageSortOrder sort_order) {
+    // Row values let SQLite seek the composite index directly to the cursor
+    switch (sort_order) {
         case ImageSortOrder::OLDEST:
-            return "uploaded_at ASC";
+            return "(uploaded_at, image_id) > (?1, ?2)";
         case ImageSortOrder::NAME_ASC:
-            return "name ASC";
+            return "(name, image_id) > (?1, ?2)";
         case ImageSortOrder::NAME_DESC:
-            return "name DESC";
+            return "(name, image_id) < (?1, ?2)";
+        case ImageSortOrder::NEWEST:
         default:
-            return "uploaded_at DESC";
+            return "(uploaded_at, image_id) < (?1, ?2)";
     }
 }
 
 bool SQLiteClient::putImageMetadata(const ImageMetadata& metadata) {
-    std::lock_guard<std::mutex> lock(db_mutex_);
+    std::lock_guard<utils::InstrumentedMutex> lock(db_mutex_);
+    if (!upsertImage(writer_, metadata)) {
+        return false;
+    }
+
+    LOG_DEBUG("Image metadata stored successfully: {}", metadata.image_id);
+    return true;
+}
+
+bool SQLiteClient::putImageMetadataBatch(const std::vector<ImageMetadata>& batch) {
+    if (batch.empty()) {
+        return true;
+    }
+
+    std::lock_guard<utils::InstrumentedMutex> lock(db_mutex_);
+    Connection& conn = writer_;
 
+    // One transaction: one journal sync for the whole batch instead of one per row
+    Transaction txn(conn.db);
+    if (!txn.active()) {
+        LOG_ERROR("Failed to begin putImageMetadataBatch transaction: {}", sqlite3_errmsg(conn.db));
+        return false;
+    }
+    for (const auto& metadata : batch) {
+        if (!upsertImage(conn, metadata)) {
+            return false;
+        }
+    }
+    if (!txn.commit()) {
+        LOG_ERROR("Failed to commit putImageMetadataBatch: {}", sqlite3_errmsg(conn.db));
+        return false;
+    }
+
+    LOG_DEBUG("Image metadata batch stored successfully: {} rows", batch.size());
+    return true;
+}
+
+bool SQLiteClient::upsertImage(Connection& conn, const ImageMetadata& metadata) {
     const char* sql = R"(
-        INSERT INTO images (image_id, name, original_format, size, width, height, uploaded_at)
-        VALUES (?, ?, ?, ?, ?, ?, ?)
+        INSERT INTO images (image_id, name, original_format, size, width, height, uploaded_at, placeholder)
+        VALUES (?, ?, ?, ?, ?, ?, ?, ?)
         ON CONFLICT(image_id) DO UPDATE SET
             name = excluded.name,
             original_format = excluded.original_format,
             size = excluded.size,
             width = excluded.width,
             height = excluded.height,
-            uploaded_at = excluded.uploaded_at
+            uploaded_at = excluded.uploaded_at,
+            placeholder = excluded.placeholder
     )";
 
-    sqlite3_stmt* stmt;
-    int rc = sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr);
-
-    if (rc != SQLITE_OK) {
-        LOG_ERROR("Failed to prepare statement: {}", sqlite3_errmsg(db_));
+    sqlite3_stmt* stmt = prepareCached(conn, sql);
+    if (!stmt) {
         return false;
     }
+    StatementReset reset(stmt);
 
     // Bind parameters
     sqlite3_bind_text(stmt, 1, metadata.image_id.c_str(), -1, SQLITE_TRANSIENT);
@@ -370,50 +1254,48 @@ bool SQLiteClient::putImageMetadata(const ImageMetadata& metadata) {
     sqlite3_bind_int(stmt, 5, metadata.width);
     sqlite3_bind_int(stmt, 6, metadata.height);
     sqlite3_bind_int64(stmt, 7, static_cast<sqlite3_int64>(metadata.upload_timestamp));
+    if (metadata.placeholder.empty()) {
+        sqlite3_bind_null(stmt, 8);
+    } else {
+        sqlite3_bind_text(stmt, 8, metadata.placeholder.c_str(), -1, SQLITE_TRANSIENT);
+    }
 
-    rc = sqlite3_step(stmt);
-    sqlite3_finalize(stmt);
+    int rc = sqlite3_step(stmt);
 
     if (rc != SQLITE_DONE) {
-        LOG_ERROR("Failed to execute putImageMetadata: {}", sqlite3_errmsg(db_));
+        LOG_ERROR("Failed to execute putImageMetadata: {}", sqlite3_errmsg(conn.db));
         return false;
     }
-
-    LOG_DEBUG("Image metadata stored successfully: {}", metadata.image_id);
     return true;
 }
 
 std::optional<ImageMetadata> SQLiteClient::getImageMetadata(const std::string& image_id) {
-    std::lock_guard<std::mutex> lock(db_mutex_);
+    ReadLease lease(*this);
+    Connection& conn = lease.connection();
 
     const char* sql = R"(
-        SELECT image_id, name, original_format, size, width, height, uploaded_at
+        SELECT image_id, name, original_format, size, width, height, uploaded_at, placeholder
         FROM images
         WHERE image_id = ?
     )";
 
-    sqlite3_stmt* stmt;
-    int rc = sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr);
-
-    if (rc != SQLITE_OK) {
-        LOG_ERROR("Failed to prepare statement: {}", sqlite3_errmsg(db_));
+    sqlite3_stmt* stmt = prepareCached(conn, sql);
+    if (!stmt) {
         return std::nullopt;
     }
+    StatementReset reset(stmt);
 
     sqlite3_bind_text(stmt, 1, image_id.c_str(), -1, SQLITE_STATIC);
 
-    rc = sqlite3_step(stmt);
+    int rc = sqlite3_step(stmt);
 
     if (rc == SQLITE_ROW) {
         ImageMetadata metadata = extractImageMetadata(stmt);
-        sqlite3_finalize(stmt);
         return metadata;
     }
 
-    sqlite3_finalize(stmt);
-
     if (rc != SQLITE_DONE) {
-        LOG_ERROR("Failed to execute getImageMetadata: {}", sqlite3_errmsg(db_));
+        LOG_ERROR("Failed to execute getImageMetadata: {}", sqlite3_errmsg(conn.db));
     }
 
     return std::nullopt;
@@ -421,36 +1303,34 @@ std::optional<ImageMetadata> SQLiteClient::getImageMetadata(const std::string& i
 
 std::vector<ImageMetadata> SQLiteClient::listImages(int limit, int offset,
                                                     ImageSortOrder sort_order) {
-    std::lock_guard<std::mutex> lock(db_mutex_);
+    ReadLease lease(*this);
+    Connection& conn = lease.connection();
 
     std::string sql = R"(
-        SELECT image_id, name, original_format, size, width, height, uploaded_at
+        SELECT image_id, name, original_format, size, width, height, uploaded_at, placeholder
         FROM images
         ORDER BY )" + getSortOrderSql(sort_order) + R"(
         LIMIT ? OFFSET ?
     )";
 
-    sqlite3_stmt* stmt;
-    int rc = sqlite3_prepare_v2(db_, sql.c_str(), -1, &stmt, nullptr);
-
-    if (rc != SQLITE_OK) {
-        LOG_ERROR("Failed to prepare statement: {}", sqlite3_errmsg(db_));
+    sqlite3_stmt* stmt = prepareCached(conn, sql);
+    if (!stmt) {
         return {};
     }
+    StatementReset reset(stmt);
 
     sqlite3_bind_int(stmt, 1, limit);
     sqlite3_bind_int(stmt, 2, offset);
 
     std::vector<ImageMetadata> images;
 
+    int rc;
     while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
         images.push_back(extractImageMetadata(stmt));
     }
 
-    sqlite3_finalize(stmt);
-
     if (rc != SQLITE_DONE) {
-        LOG_ERROR("Failed to execute listImages: {}", sqlite3_errmsg(db_));
+        LOG_ERROR("Failed to execute listImages: {}", sqlite3_errmsg(conn.db));
         return {};
     }
 
@@ -458,30 +1338,73 @@ std::vector<ImageMetadata> SQLiteClient::listImages(int limit, int offset,
     return images;
 }
 
+std::vector<ImageMetadata> SQLiteClient::listImagesAfter(int limit, ImageSortOrder sort_order,
+                                                         const std::optional<ImagePageCursor>& after) {
+    ReadLease lease(*this);
+    Connection& conn = lease.connection();
+
+    std::string sql = R"(
+        SELECT image_id, name, original_format, size, width, height, uploaded_at, placeholder
+        FROM images
+        )" + (after ? "WHERE " + getKeysetConditionSql(sort_order) : std::string()) + R"(
+        ORDER BY )" + getSortOrderSql(sort_order) + R"(
+        LIMIT ?3
+    )";
+
+    sqlite3_stmt* stmt = prepareCached(conn, sql);
+    if (!stmt) {
+        return {};
+    }
+    StatementReset reset(stmt);
+
+    if (after) {
+        bool by_name = sort_order == ImageSortOrder::NAME_ASC || sort_order == ImageSortOrder::NAME_DESC;
+        if (by_name) {
+            sqlite3_bind_text(stmt, 1, after->name.c_str(), -1, SQLITE_STATIC);
+        } else {
+            sqlite3_bind_int64(stmt, 1, static_cast<sqlite3_int64>(after->uploaded_at));
+        }
+        sqlite3_bind_text(stmt, 2, after->image_id.c_str(), -1, SQLITE_STATIC);
+    }
+    sqlite3_bind_int(stmt, 3, limit);
+
+    std::vector<ImageMetadata> images;
+
+    int rc;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+        images.push_back(extractImageMetadata(stmt));
+    }
+
+    if (rc != SQLITE_DONE) {
+        LOG_ERROR("Failed to execute listImagesAfter: {}", sqlite3_errmsg(conn.db));
+        return {};
+    }
+
+    LOG_DEBUG("Listed {} images after cursor", images.size());
+    return images;
+}
+
 int SQLiteClient::getImageCount() {
-    std::lock_guard<std::mutex> lock(db_mutex_);
+    ReadLease lease(*this);
+    Connection& conn = lease.connection();
 
     const char* sql = "SELECT COUNT(*) FROM images";
 
-    sqlite3_stmt* stmt;
-    int rc = sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr);
-
-    if (rc != SQLITE_OK) {
-        LOG_ERROR("Failed to prepare statement: {}", sqlite3_errmsg(db_));
+    sqlite3_stmt* stmt = prepareCached(conn, sql);
+    if (!stmt) {
         return 0;
     }
+    StatementReset reset(stmt);
 
-    rc = sqlite3_step(stmt);
+    int rc = sqlite3_step(stmt);
 
     int count = 0;
     if (rc == SQLITE_ROW) {
         count = sqlite3_column_int(stmt, 0);
     }
 
-    sqlite3_finalize(stmt);
-
     if (rc != SQLITE_ROW && rc != SQLITE_DONE) {
-        LOG_ERROR("Failed to execute getImageCount: {}", sqlite3_errmsg(db_));
+        LOG_ERROR("Failed to execute getImageCount: {}", sqlite3_errmsg(conn.db));
         return 0;
     }
 
@@ -489,25 +1412,520 @@ int SQLiteClient::getImageCount() {
 }
 
 bool SQLiteClient::imageExists(const std::string& image_id) {
-    std::lock_guard<std::mutex> lock(db_mutex_);
+    ReadLease lease(*this);
+    Connection& conn = lease.connection();
 
     const char* sql = "SELECT 1 FROM images WHERE image_id = ?";
 
-    sqlite3_stmt* stmt;
-    int rc = sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr);
-
-    if (rc != SQLITE_OK) {
-        LOG_ERROR("Failed to prepare statement: {}", sqlite3_errmsg(db_));
+    sqlite3_stmt* stmt = prepareCached(conn, sql);
+    if (!stmt) {
         return false;
     }
+    StatementReset reset(stmt);
 
     sqlite3_bind_text(stmt, 1, image_id.c_str(), -1, SQLITE_STATIC);
 
-    rc = sqlite3_step(stmt);
+    int rc = sqlite3_step(stmt);
     bool exists = (rc == SQLITE_ROW);
 
-    sqlite3_finalize(stmt);
     return exists;
 }
 
+std::unordered_set<std::string> SQLiteClient::imagesExist(const std::vector<std::string>& image_ids) {
+    if (image_ids.empty()) {
+        return {};
+    }
+
+    ReadLease lease(*this);
+    Connection& conn = lease.connection();
+
+    // The IDs travel as one JSON array so a single cached statement serves
+    // any batch size without hitting the bound-parameter limit
+    const char* sql = R"(
+        SELECT image_id FROM images
+        WHERE image_id IN (SELECT value FROM json_each(?))
+    )";
+
+    sqlite3_stmt* stmt = prepareCached(conn, sql);
+    if (!stmt) {
+        return {};
+    }
+    StatementReset reset(stmt);
+
+    std::string ids_json = vectorToJson(image_ids);
+    sqlite3_bind_text(stmt, 1, ids_json.c_str(), -1, SQLITE_STATIC);
+
+    std::unordered_set<std::string> found;
+
+    int rc;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+        found.emplace(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0)));
+    }
+
+    if (rc != SQLITE_DONE) {
+        LOG_ERROR("Failed to execute imagesExist: {}", sqlite3_errmsg(conn.db));
+        return {};
+    }
+
+    LOG_DEBUG("{} of {} images exist", found.size(), image_ids.size());
+    return found;
+}
+
+std::unordered_map<std::string, std::string> SQLiteClient::getImagePlaceholders(
+    const std::vector<std::string>& image_ids) {
+    if (image_ids.empty()) {
+        return {};
+    }
+
+    ReadLease lease(*this);
+    Connection& conn = lease.connection();
+
+    const char* sql = R"(
+        SELECT image_id, placeholder FROM images
+        WHERE image_id IN (SELECT value FROM json_each(?)) AND placeholder IS NOT NULL
+    )";
+
+    sqlite3_stmt* stmt = prepareCached(conn, sql);
+    if (!stmt) {
+        return {};
+    }
+    StatementReset reset(stmt);
+
+    std::string ids_json = vectorToJson(image_ids);
+    sqlite3_bind_text(stmt, 1, ids_json.c_str(), -1, SQLITE_STATIC);
+
+    std::unordered_map<std::string, std::string> placeholders;
+
+    int rc;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+        placeholders.emplace(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0)),
+                             reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1)));
+    }
+
+    if (rc != SQLITE_DONE) {
+        LOG_ERROR("Failed to execute getImagePlaceholders: {}", sqlite3_errmsg(conn.db));
+        return {};
+    }
+
+    return placeholders;
+}
+
+bool SQLiteClient::putRendition(const RenditionRecord& record) {
+    std::lock_guard<utils::InstrumentedMutex> lock(db_mutex_);
+    Connection& conn = writer_;
+
+    const char* sql = R"(
+        INSERT INTO renditions (storage_key, image_id, size_bytes, last_accessed, hits)
+        VALUES (?, ?, ?, ?, ?)
+        ON CONFLICT(storage_key) DO UPDATE SET
+            image_id = excluded.image_id,
+            size_bytes = excluded.size_bytes,
+            last_accessed = excluded.last_accessed,
+            hits = excluded.hits
+    )";
+
+    sqlite3_stmt* stmt = prepareCached(conn, sql);
+    if (!stmt) {
+        return false;
+    }
+    StatementReset reset(stmt);
+
+    sqlite3_bind_text(stmt, 1, record.storage_key.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 2, record.image_id.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_int64(stmt, 3, static_cast<sqlite3_int64>(record.size_bytes));
+    sqlite3_bind_int64(stmt, 4, static_cast<sqlite3_int64>(record.last_accessed));
+    sqlite3_bind_int64(stmt, 5, static_cast<sqlite3_int64>(record.hits));
+
+    if (sqlite3_step(stmt) != SQLITE_DONE) {
+        LOG_ERROR("Failed to execute putRendition: {}", sqlite3_errmsg(conn.db));
+        return false;
+    }
+    return true;
+}
+
+bool SQLiteClient::touchRenditions(const std::vector<std::string>& storage_keys,
+                                   std::time_t accessed_at) {
+    if (storage_keys.empty()) {
+        return true;
+    }
+
+    std::lock_guard<utils::InstrumentedMutex> lock(db_mutex_);
+    Connection& conn = writer_;
+
+    const char* sql = R"(
+        UPDATE renditions SET last_accessed = MAX(last_accessed, ?), hits = hits + 1
+        WHERE storage_key IN (SELECT value FROM json_each(?))
+    )";
+
+    sqlite3_stmt* stmt = prepareCached(conn, sql);
+    if (!stmt) {
+        return false;
+    }
+    StatementReset reset(stmt);
+
+    std::string keys_json = vectorToJson(storage_keys);
+    sqlite3_bind_int64(stmt, 1, static_cast<sqlite3_int64>(accessed_at));
+    sqlite3_bind_text(stmt, 2, keys_json.c_str(), -1, SQLITE_STATIC);
+
+    if (sqlite3_step(stmt) != SQLITE_DONE) {
+        LOG_ERROR("Failed to execute touchRenditions: {}", sqlite3_errmsg(conn.db));
+        return false;
+    }
+    return true;
+}
+
+std::vector<std::string> SQLiteClient::listRenditionKeys(const std::string& image_id) {
+    ReadLease lease(*this);
+    Connection& conn = lease.connection();
+
+    sqlite3_stmt* stmt = prepareCached(conn, "SELECT storage_key FROM renditions WHERE image_id = ?");
+    if (!stmt) {
+        return {};
+    }
+    StatementReset reset(stmt);
+
+    sqlite3_bind_text(stmt, 1, image_id.c_str(), -1, SQLITE_STATIC);
+
+    std::vector<std::string> keys;
+    int rc;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+        keys.emplace_back(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0)));
+    }
+
+    if (rc != SQLITE_DONE) {
+        LOG_ERROR("Failed to execute listRenditionKeys: {}", sqlite3_errmsg(conn.db));
+        return {};
+    }
+    return keys;
+}
+
+std::vector<RenditionRecord> SQLiteClient::listEvictionCandidates(int limit,
+                                                                  RenditionEvictionPolicy policy) {
+    ReadLease lease(*this);
+    Connection& conn = lease.connection();
+
+    const char* sql = policy == RenditionEvictionPolicy::LFU
+        ? "SELECT storage_key, image_id, size_bytes, last_accessed, hits FROM renditions "
+          "ORDER BY hits ASC, last_accessed ASC LIMIT ?"
+        : "SELECT storage_key, image_id, size_bytes, last_accessed, hits FROM renditions "
+          "ORDER BY last_accessed ASC LIMIT ?";
+
+    sqlite3_stmt* stmt = prepareCached(conn, sql);
+    if (!stmt) {
+        return {};
+    }
+    StatementReset reset(stmt);
+
+    sqlite3_bind_int(stmt, 1, limit);
+
+    std::vector<RenditionRecord> records;
+    int rc;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+        RenditionRecord record;
+        record.storage_key = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+        record.image_id = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
+        record.size_bytes = static_cast<uint64_t>(sqlite3_column_int64(stmt, 2));
+        record.last_accessed = static_cast<std::time_t>(sqlite3_column_int64(stmt, 3));
+        record.hits = sqlite3_column_int64(stmt, 4);
+        records.push_back(std::move(record));
+    }
+
+    if (rc != SQLITE_DONE) {
+        LOG_ERROR("Failed to execute listEvictionCandidates: {}", sqlite3_errmsg(conn.db));
+        return {};
+    }
+    return records;
+}
+
+bool SQLiteClient::deleteRenditions(const std::vector<std::string>& storage_keys) {
+    if (storage_keys.empty()) {
+        return true;
+    }
+
+    std::lock_guard<utils::InstrumentedMutex> lock(db_mutex_);
+    Connection& conn = writer_;
+
+    sqlite3_stmt* stmt = prepareCached(conn,
+        "DELETE FROM renditions WHERE storage_key IN (SELECT value FROM json_each(?))");
+    if (!stmt) {
+        return false;
+    }
+    StatementReset reset(stmt);
+
+    std::string keys_json = vectorToJson(storage_keys);
+    sqlite3_bind_text(stmt, 1, keys_json.c_str(), -1, SQLITE_STATIC);
+
+    if (sqlite3_step(stmt) != SQLITE_DONE) {
+        LOG_ERROR("Failed to execute deleteRenditions: {}", sqlite3_errmsg(conn.db));
+        return false;
+    }
+
+    LOG_DEBUG("Removed {} renditions from the index", storage_keys.size());
+    return true;
+}
+
+uint64_t SQLiteClient::getRenditionBytes() {
+    ReadLease lease(*this);
+    Connection& conn = lease.connection();
+
+    sqlite3_stmt* stmt = prepareCached(conn, "SELECT COALESCE(SUM(size_bytes), 0) FROM renditions");
+    if (!stmt) {
+        return 0;
+    }
+    StatementReset reset(stmt);
+
+    if (sqlite3_step(stmt) != SQLITE_ROW) {
+        LOG_ERROR("Failed to execute getRenditionBytes: {}", sqlite3_errmsg(conn.db));
+        return 0;
+    }
+    return static_cast<uint64_t>(sqlite3_column_int64(stmt, 0));
+}
+
+bool SQLiteClient::enqueueRenderJobs(const std::vector<RenderJob>& jobs) {
+    if (jobs.empty()) {
+        return true;
+    }
+
+    std::lock_guard<utils::InstrumentedMutex> lock(db_mutex_);
+    Connection& conn = writer_;
+
+    // A repeat raises the priority; a failed job starts over. Dropping the
+    // lease token keeps an in-flight claim from completing the newer request
+    const char* sql = R"(
+        INSERT INTO render_jobs (image_id, format, width, height, quality, profile, priority, run_after, created_at)
+        VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?)
+        ON CONFLICT(image_id, format, width, height, quality, profile) DO UPDATE SET
+            priority = MAX(priority, excluded.priority),
+            attempts = CASE WHEN failed = 1 THEN 0 ELSE attempts END,
+            run_after = CASE WHEN failed = 1 THEN excluded.run_after ELSE run_after END,
+            failed = 0,
+            lease_token = NULL
+    )";
+
+    Transaction txn(conn.db);
+    if (!txn.active()) {
+        return false;
+    }
+
+    sqlite3_stmt* stmt = prepareCached(conn, sql);
+    if (!stmt) {
+        return false;
+    }
+
+    std::time_t now = std::time(nullptr);
+    for (const auto& job : jobs) {
+        StatementReset reset(stmt);
+        sqlite3_bind_text(stmt, 1, job.image_id.c_str(), -1, SQLITE_STATIC);
+        sqlite3_bind_text(stmt, 2, job.format.c_str(), -1, SQLITE_STATIC);
+        sqlite3_bind_int(stmt, 3, job.width);
+        sqlite3_bind_int(stmt, 4, job.height);
+        sqlite3_bind_int(stmt, 5, job.quality);
+        sqlite3_bind_text(stmt, 6, job.profile.c_str(), -1, SQLITE_STATIC);
+        sqlite3_bind_int(stmt, 7, job.priority);
+        sqlite3_bind_int64(stmt, 8, static_cast<sqlite3_int64>(job.run_after));
+        sqlite3_bind_int64(stmt, 9, static_cast<sqlite3_int64>(now));
+
+        if (sqlite3_step(stmt) != SQLITE_DONE) {
+            LOG_ERROR("Failed to execute enqueueRenderJobs: {}", sqlite3_errmsg(conn.db));
+            return false;
+        }
+    }
+    return txn.commit();
+}
+
+std::vector<RenderJob> SQLiteClient::claimRenderJobs(const std::string& lease_token, int max_images,
+                                                     std::time_t now, std::time_t lease_expires_at) {
+    std::lock_guard<utils::InstrumentedMutex> lock(db_mutex_);
+    Connection& conn = writer_;
+
+    Transaction txn(conn.db);
+    if (!txn.active()) {
+        return {};
+    }
+
+    // The max_images images with the highest-priority ready jobs; grouped so
+    // an image with many jobs still counts once against the limit
+    std::vector<std::string> image_ids;
+    {
+        sqlite3_stmt* stmt = prepareCached(conn, R"(
+            SELECT image_id FROM render_jobs
+            WHERE failed = 0 AND run_after <= ? AND lease_expires_at <= ?
+            GROUP BY image_id
+            ORDER BY MAX(priority) DESC, MIN(run_after) ASC LIMIT ?
+        )");
+        if (!stmt) {
+            return {};
+        }
+        StatementReset reset(stmt);
+
+        sqlite3_bind_int64(stmt, 1, static_cast<sqlite3_int64>(now));
+        sqlite3_bind_int64(stmt, 2, static_cast<sqlite3_int64>(now));
+        sqlite3_bind_int(stmt, 3, max_images);
+
+        int rc;
+        while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+            image_ids.emplace_back(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0)));
+        }
+        if (rc != SQLITE_DONE) {
+            LOG_ERROR("Failed to execute claimRenderJobs: {}", sqlite3_errmsg(conn.db));
+            return {};
+        }
+    }
+    if (image_ids.empty()) {
+        return {};
+    }
+
+    // Lease every ready job of those images
+    std::string ids_json = vectorToJson(image_ids);
+    {
+        sqlite3_stmt* stmt = prepareCached(conn, R"(
+            UPDATE render_jobs SET lease_token = ?, lease_expires_at = ?, attempts = attempts + 1
+            WHERE image_id IN (SELECT value FROM json_each(?))
+              AND failed = 0 AND run_after <= ? AND lease_expires_at <= ?
+        )");
+        if (!stmt) {
+            return {};
+        }
+        StatementReset reset(stmt);
+
+        sqlite3_bind_text(stmt, 1, lease_token.c_str(), -1, SQLITE_STATIC);
+        sqlite3_bind_int64(stmt, 2, static_cast<sqlite3_int64>(lease_expires_at));
+        sqlite3_bind_text(stmt, 3, ids_json.c_str(), -1, SQLITE_STATIC);
+        sqlite3_bind_int64(stmt, 4, static_cast<sqlite3_int64>(now));
+        sqlite3_bind_int64(stmt, 5, static_cast<sqlite3_int64>(now));
+
+        if (sqlite3_step(stmt) != SQLITE_DONE) {
+            LOG_ERROR("Failed to execute claimRenderJobs: {}", sqlite3_errmsg(conn.db));
+            return {};
+        }
+    }
+
+    std::vector<RenderJob> jobs;
+    {
+        sqlite3_stmt* stmt = prepareCached(conn, R"(
+            SELECT job_id, image_id, format, width, height, quality, profile, priority, attempts, run_after
+            FROM render_jobs WHERE lease_token = ? ORDER BY image_id, priority DESC
+        )");
+        if (!stmt) {
+            return {};
+        }
+        StatementReset reset(stmt);
+
+        sqlite3_bind_text(stmt, 1, lease_token.c_str(), -1, SQLITE_STATIC);
+
+        int rc;
+        while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+            RenderJob job;
+            job.job_id = sqlite3_column_int64(stmt, 0);
+            job.image_id = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
+            job.format = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2));
+            job.width = sqlite3_column_int(stmt, 3);
+            job.height = sqlite3_column_int(stmt, 4);
+            job.quality = sqlite3_column_int(stmt, 5);
+            job.profile = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 6));
+            job.priority = sqlite3_column_int(stmt, 7);
+            job.attempts = sqlite3_column_int(stmt, 8);
+            job.run_after = static_cast<std::time_t>(sqlite3_column_int64(stmt, 9));
+            jobs.push_back(std::move(job));
+        }
+        if (rc != SQLITE_DONE) {
+            LOG_ERROR("Failed to execute claimRenderJobs: {}", sqlite3_errmsg(conn.db));
+            return {};
+        }
+    }
+
+    if (!txn.commit()) {
+        return {};
+    }
+    return jobs;
+}
+
+bool SQLiteClient::completeRenderJobs(const std::string& lease_token, const std::vector<int64_t>& job_ids) {
+    if (job_ids.empty()) {
+        return true;
+    }
+
+    std::lock_guard<utils::InstrumentedMutex> lock(db_mutex_);
+    Connection& conn = writer_;
+
+    sqlite3_stmt* stmt = prepareCached(conn,
+        "DELETE FROM render_jobs WHERE job_id IN (SELECT value FROM json_each(?)) AND lease_token = ?");
+    if (!stmt) {
+        return false;
+    }
+    StatementReset reset(stmt);
+
+    std::string ids_json = json(job_ids).dump();
+    sqlite3_bind_text(stmt, 1, ids_json.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 2, lease_token.c_str(), -1, SQLITE_STATIC);
+
+    if (sqlite3_step(stmt) != SQLITE_DONE) {
+        LOG_ERROR("Failed to execute completeRenderJobs: {}", sqlite3_errmsg(conn.db));
+        return false;
+    }
+    return true;
+}
+
+bool SQLiteClient::releaseRenderJob(const std::string& lease_token, int64_t job_id,
+                                    std::optional<std::time_t> retry_at, const std::string& error) {
+    std::lock_guard<utils::InstrumentedMutex> lock(db_mutex_);
+    Connection& conn = writer_;
+
+    sqlite3_stmt* stmt = prepareCached(conn, R"(
+        UPDATE render_jobs SET lease_token = NULL, lease_expires_at = 0,
+            run_after = COALESCE(?, run_after), failed = ?, last_error = ?
+        WHERE job_id = ? AND lease_token = ?
+    )");
+    if (!stmt) {
+        return false;
+    }
+    StatementReset reset(stmt);
+
+    if (retry_at) {
+        sqlite3_bind_int64(stmt, 1, static_cast<sqlite3_int64>(*retry_at));
+    } else {
+        sqlite3_bind_null(stmt, 1);
+    }
+    sqlite3_bind_int(stmt, 2, retry_at ? 0 : 1);
+    sqlite3_bind_text(stmt, 3, error.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_int64(stmt, 4, static_cast<sqlite3_int64>(job_id));
+    sqlite3_bind_text(stmt, 5, lease_token.c_str(), -1, SQLITE_STATIC);
+
+    if (sqlite3_step(stmt) != SQLITE_DONE) {
+        LOG_ERROR("Failed to execute releaseRenderJob: {}", sqlite3_errmsg(conn.db));
+        return false;
+    }
+    return true;
+}
+
+RenderJobCounts SQLiteClient::getRenderJobCounts(std::time_t now) {
+    ReadLease lease(*this);
+    Connection& conn = lease.connection();
+
+    sqlite3_stmt* stmt = prepareCached(conn, R"(
+        SELECT COALESCE(SUM(failed = 0 AND lease_expires_at <= ?), 0),
+               COALESCE(SUM(failed = 0 AND lease_expires_at > ?), 0),
+               COALESCE(SUM(failed), 0)
+        FROM render_jobs
+    )");
+    if (!stmt) {
+        return {};
+    }
+    StatementReset reset(stmt);
+
+    sqlite3_bind_int64(stmt, 1, static_cast<sqlite3_int64>(now));
+    sqlite3_bind_int64(stmt, 2, static_cast<sqlite3_int64>(now));
+
+    if (sqlite3_step(stmt) != SQLITE_ROW) {
+        LOG_ERROR("Failed to execute getRenderJobCounts: {}", sqlite3_errmsg(conn.db));
+        return {};
+    }
+
+    RenderJobCounts counts;
+    counts.pending = sqlite3_column_int64(stmt, 0);
+    counts.leased = sqlite3_column_int64(stmt, 1);
+    counts.failed = sqlite3_column_int64(stmt, 2);
+    return counts;
+}
+
 } // namespace gara
@@ -2,23 +2,47 @@
 #define GARA_DB_SQLITE_CLIENT_H
 
 #include <sqlite3.h>
+#include <condition_variable>
 #include <string>
 #include <memory>
 #include <mutex>
+#include <unordered_map>
+#include <vector>
 #include "../interfaces/database_client_interface.h"
+#include "../utils/instrumented_mutex.h"
 
 namespace gara {
 
+/**
+ * @brief SQLite connection tuning
+ */
+struct SQLiteConfig {
+    int read_connections = 4;                    // Read-only connections (0 = reads share the writer)
+    long long mmap_size = 256LL * 1024 * 1024;   // PRAGMA mmap_size in bytes (0 disables mmap)
+    int cache_size_kb = 8192;                    // Page cache per connection
+    int busy_timeout_ms = 5000;                  // How long to wait for a lock before SQLITE_BUSY
+    std::string synchronous = "NORMAL";          // PRAGMA synchronous (NORMAL is durable enough under WAL)
+
+    static SQLiteConfig fromEnvironment();
+};
+
 /**
  * @brief SQLite implementation of the database client interface
+ *
+ * Writes go through a single connection guarded by a mutex. Reads check out
+ * one of a small pool of read-only connections so they run in parallel under
+ * WAL instead of queueing behind the writer. Every connection keeps its
+ * prepared statements for its whole lifetime.
  */
 class SQLiteClient : public DatabaseClientInterface {
 public:
     /**
      * @brief Constructor
      * @param db_path Path to the SQLite database file
+     * @param config Connection tuning
      */
-    explicit SQLiteClient(const std::string& db_path);
+    explicit SQLiteClient(const std::string& db_path,
+                          const SQLiteConfig& config = SQLiteConfig());
 
     /**
      * @brief Destructor - closes database connection
@@ -31,19 +55,58 @@ public:
 
     // DatabaseClientInterface implementation
     bool putAlbum(const Album& album) override;
-    std::optional<Album> getAlbum(const std::string& album_id) override;
+    std::optional<Album> getAlbum(const std::string& album_id,
+                                  bool include_images = true) override;
     std::vector<Album> listAlbums(bool published_only = false) override;
+    std::vector<Album> listAlbumsAfter(const AlbumQuery& query, int limit,
+                                       const std::optional<AlbumPageCursor>& after) override;
     bool deleteAlbum(const std::string& album_id) override;
     bool albumNameExists(const std::string& name,
                         const std::string& exclude_album_id = "") override;
 
+    // Album membership operations
+    bool addAlbumImages(const std::string& album_id, const std::vector<std::string>& image_ids,
+                        int position, std::time_t updated_at) override;
+    bool removeAlbumImage(const std::string& album_id, const std::string& image_id,
+                          std::time_t updated_at) override;
+    bool reorderAlbumImages(const std::string& album_id, const std::vector<std::string>& image_ids,
+                            std::time_t updated_at) override;
+    std::vector<std::string> listAlbumImages(const std::string& album_id,
+                                             int limit, int offset) override;
+    int getAlbumImageCount(const std::string& album_id) override;
+    std::optional<std::unordered_set<std::string>> albumImagesContained(
+        const std::string& album_id, const std::vector<std::string>& image_ids) override;
+
     // Image metadata operations
     bool putImageMetadata(const ImageMetadata& metadata) override;
+    bool putImageMetadataBatch(const std::vector<ImageMetadata>& batch) override;
     std::optional<ImageMetadata> getImageMetadata(const std::string& image_id) override;
     std::vector<ImageMetadata> listImages(int limit, int offset,
                                           ImageSortOrder sort_order) override;
+    std::vector<ImageMetadata> listImagesAfter(int limit, ImageSortOrder sort_order,
+                                               const std::optional<ImagePageCursor>& after) override;
     int getImageCount() override;
     bool imageExists(const std::string& image_id) override;
+    std::unordered_set<std::string> imagesExist(const std::vector<std::string>& image_ids) override;
+    std::unordered_map<std::string, std::string> getImagePlaceholders(
+        const std::vector<std::string>& image_ids) override;
+
+    // Transform index operations
+    bool putRendition(const RenditionRecord& record) override;
+    bool touchRenditions(const std::vector<std::string>& storage_keys, std::time_t accessed_at) override;
+    std::vector<std::string> listRenditionKeys(const std::string& image_id) override;
+    std::vector<RenditionRecord> listEvictionCandidates(int limit, RenditionEvictionPolicy policy) override;
+    bool deleteRenditions(const std::vector<std::string>& storage_keys) override;
+    uint64_t getRenditionBytes() override;
+
+    // Render job queue operations
+    bool enqueueRenderJobs(const std::vector<RenderJob>& jobs) override;
+    std::vector<RenderJob> claimRenderJobs(const std::string& lease_token, int max_images,
+                                           std::time_t now, std::time_t lease_expires_at) override;
+    bool completeRenderJobs(const std::string& lease_token, const std::vector<int64_t>& job_ids) override;
+    bool releaseRenderJob(const std::string& lease_token, int64_t job_id,
+                          std::optional<std::time_t> retry_at, const std::string& error) override;
+    RenderJobCounts getRenderJobCounts(std::time_t now) override;
 
     /**
      * @brief Initialize the database schema
@@ -51,10 +114,77 @@ public:
      */
     bool initialize();
 
+    /**
+     * @brief Number of pooled read-only connections (0 when reads use the writer)
+     */
+    size_t readConnectionCount() const { return readers_.size(); }
+
 private:
-    sqlite3* db_;
+    /**
+     * @brief A database handle and the statements prepared on it
+     */
+    struct Connection {
+        sqlite3* db = nullptr;
+        std::unordered_map<std::string, sqlite3_stmt*> statements;
+    };
+
+    /**
+     * @brief RAII checkout of a connection for read queries
+     *
+     * Hands out an idle pooled reader, or the writer (with the write lock
+     * held) when the pool is disabled.
+     */
+    class ReadLease {
+    public:
+        explicit ReadLease(SQLiteClient& client);
+        ~ReadLease();
+
+        ReadLease(const ReadLease&) = delete;
+        ReadLease& operator=(const ReadLease&) = delete;
+
+        Connection& connection() { return *conn_; }
+
+    private:
+        SQLiteClient& client_;
+        Connection* conn_;
+        std::unique_lock<utils::InstrumentedMutex> writer_lock_;
+    };
+
+    Connection writer_;
     std::string db_path_;
-    mutable std::mutex db_mutex_;  // For thread safety
+    SQLiteConfig config_;
+    mutable utils::InstrumentedMutex db_mutex_{"sqlite_writer"};  // Serialises use of writer_
+
+    std::vector<std::unique_ptr<Connection>> readers_;
+    std::vector<Connection*> idle_readers_;
+    utils::InstrumentedMutex readers_mutex_{"sqlite_readers"};
+    std::condition_variable_any readers_cv_;
+
+    /**
+     * @brief Open the read-only pool (skipped for in-memory databases)
+     */
+    void openReaders();
+
+    /**
+     * @brief Apply per-connection pragmas
+     */
+    void configureConnection(sqlite3* db);
+
+    /**
+     * @brief Fetch a prepared statement for sql on conn, preparing it on first use
+     * @return Reset statement with cleared bindings, or nullptr on failure
+     */
+    sqlite3_stmt* prepareCached(Connection& conn, const std::string& sql);
+
+    /**
+     * @brief Insert or update one images row on conn (caller holds db_mutex_)
+     */
+    bool upsertImage(Connection& conn, const ImageMetadata& metadata);
+
+    /**
+     * @brief Finalize a connection's statements and close it
+     */
+    static void closeConnection(Connection& conn);
 
     /**
      * @brief Execute SQL statement
@@ -78,6 +208,45 @@ private:
      */
     Album extractAlbum(sqlite3_stmt* stmt);
 
+    /**
+     * @brief Move album image_ids left in the legacy JSON column into album_images
+     */
+    bool migrateLegacyImageIds();
+
+    /**
+     * @brief Add images.placeholder to databases created before it existed
+     */
+    bool migrateImagePlaceholderColumn();
+
+    /**
+     * @brief Fill album_tags for albums whose tags only exist in the JSON column
+     */
+    bool migrateAlbumTags();
+
+    /**
+     * @brief Read album image IDs in position order (limit -1 reads all)
+     */
+    std::vector<std::string> loadAlbumImages(Connection& conn, const std::string& album_id,
+                                             int limit, int offset);
+
+    /**
+     * @brief Insert image IDs with consecutive positions starting at first_position
+     */
+    bool insertAlbumImages(Connection& conn, const std::string& album_id,
+                           const std::vector<std::string>& image_ids, int first_position);
+
+    /**
+     * @brief Set an album's updated_at
+     * @return true if the album exists
+     */
+    bool touchAlbum(Connection& conn, const std::string& album_id, std::time_t updated_at);
+
+    /**
+     * @brief Replace an album's rows in album_tags
+     */
+    bool replaceAlbumTags(Connection& conn, const std::string& album_id,
+                          const std::vector<std::string>& tags);
+
     /**
      * @brief Helper to extract ImageMetadata from SQLite row
      */
@@ -87,6 +256,11 @@ private:
      * @brief Convert ImageSortOrder to SQL ORDER BY clause
      */
     std::string getSortOrderSql(ImageSortOrder sort_order);
+
+    /**
+     * @brief WHERE clause selecting rows after a cursor for the given sort order
+     */
+    static std::string getKeysetConditionSql(ImageSortOrder sort_order);
 };
 
 } // namespace gara
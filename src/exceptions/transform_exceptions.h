@@ -0,0 +1,38 @@
+#ifndef GARA_EXCEPTIONS_TRANSFORM_EXCEPTIONS_H
+#define GARA_EXCEPTIONS_TRANSFORM_EXCEPTIONS_H
+
+#include <stdexcept>
+#include <string>
+
+namespace gara {
+namespace exceptions {
+
+/**
+ * @brief Exception thrown when the service sheds load (e.g., transform queue full)
+ */
+class ServiceUnavailableException : public std::runtime_error {
+public:
+    ServiceUnavailableException(const std::string& message, int retry_after_seconds)
+        : std::runtime_error(message), retry_after_seconds_(retry_after_seconds) {}
+
+    int retryAfterSeconds() const { return retry_after_seconds_; }
+
+private:
+    int retry_after_seconds_;
+};
+
+/**
+ * @brief Exception thrown when one client exceeds its rate limit or transform cap
+ *
+ * Derives from ServiceUnavailableException so paths that only shed load
+ * still back off; request handlers catch it first to answer 429.
+ */
+class TooManyRequestsException : public ServiceUnavailableException {
+public:
+    using ServiceUnavailableException::ServiceUnavailableException;
+};
+
+} // namespace exceptions
+} // namespace gara
+
+#endif // GARA_EXCEPTIONS_TRANSFORM_EXCEPTIONS_H
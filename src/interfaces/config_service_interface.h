@@ -2,6 +2,7 @@
 #define GARA_CONFIG_SERVICE_INTERFACE_H
 
 #include <string>
+#include <string_view>
 
 namespace gara {
 
@@ -21,6 +22,12 @@ public:
      */
     virtual std::string getApiKey() = 0;
 
+    /**
+     * @brief Check a presented key against every currently accepted key
+     * @return true if provided_key is accepted
+     */
+    virtual bool validateApiKey(std::string_view provided_key) = 0;
+
     /**
      * @brief Force refresh the API key
      * @return true if successful, false otherwise
@@ -1,11 +1,15 @@
 #ifndef GARA_INTERFACES_DATABASE_CLIENT_INTERFACE_H
 #define GARA_INTERFACES_DATABASE_CLIENT_INTERFACE_H
 
+#include <cstdint>
+#include <ctime>
 #include <string>
 #include <vector>
 #include <map>
 #include <memory>
 #include <optional>
+#include <unordered_map>
+#include <unordered_set>
 #include "../models/album.h"
 #include "../models/image_metadata.h"
 
@@ -21,6 +25,92 @@ enum class ImageSortOrder {
     NAME_DESC    // Sort by name descending
 };
 
+/**
+ * @brief Position of the last row of a page in keyset pagination
+ *
+ * Rows are ordered by (uploaded_at, image_id) or (name, image_id) depending
+ * on the sort order, so only the fields for that order are compared.
+ */
+struct ImagePageCursor {
+    std::time_t uploaded_at = 0;
+    std::string name;
+    std::string image_id;
+
+    static ImagePageCursor fromImage(const ImageMetadata& image) {
+        return ImagePageCursor{image.upload_timestamp, image.name, image.image_id};
+    }
+};
+
+/**
+ * @brief Position of the last row of a page of albums
+ *
+ * Filtered album listings are ordered newest first by (created_at, album_id).
+ */
+struct AlbumPageCursor {
+    std::time_t created_at = 0;
+    std::string album_id;
+
+    static AlbumPageCursor fromAlbum(const Album& album) {
+        return AlbumPageCursor{album.created_at, album.album_id};
+    }
+};
+
+/**
+ * @brief Filters for a page of albums
+ */
+struct AlbumQuery {
+    std::vector<std::string> tags;  // Albums carrying every one of these tags
+    bool published_only = false;
+};
+
+/**
+ * @brief A transformed rendition recorded in the transform index
+ */
+struct RenditionRecord {
+    std::string storage_key;
+    std::string image_id;
+    uint64_t size_bytes = 0;
+    std::time_t last_accessed = 0;
+    int64_t hits = 0;  // Accesses since the rendition was stored
+};
+
+/**
+ * @brief Which renditions the evictor removes first
+ */
+enum class RenditionEvictionPolicy {
+    LRU,  // Least recently accessed
+    LFU   // Fewest hits, ties broken by least recent access
+};
+
+/**
+ * @brief A rendition queued for background generation
+ *
+ * There is one job per image and parameter set; enqueuing it again raises
+ * its priority and revives it if it had failed. A claimed job is leased to
+ * one worker until it is completed, released or its lease runs out.
+ */
+struct RenderJob {
+    int64_t job_id = 0;
+    std::string image_id;
+    std::string format;
+    int width = 0;
+    int height = 0;
+    int quality = 0;            // Encoder quality override (0 = profile default)
+    std::string profile;        // Encoder profile name (empty = the default profile)
+    int priority = 0;           // Higher is claimed first
+    int attempts = 0;           // Claims so far, including the current one
+    std::time_t run_after = 0;  // Not claimed before this time
+};
+
+/**
+ * @brief Jobs in the render queue by state
+ */
+struct RenderJobCounts {
+    int64_t pending = 0;  // Waiting, including retries that are not due yet
+    int64_t leased = 0;   // Held by a worker
+    int64_t failed = 0;   // Given up on after the last attempt
+};
+
 /**
  * @brief Database-agnostic interface for album storage operations
  *
@@ -33,6 +123,11 @@ public:
 
     /**
      * @brief Store or update an album
+     *
+     * image_ids seed the album's membership when it is first created. For an
+     * existing album only the album fields are written; membership changes go
+     * through addAlbumImages, removeAlbumImage and reorderAlbumImages.
+     *
      * @param album The album to store
      * @return true if successful, false otherwise
      */
@@ -41,9 +136,11 @@ public:
     /**
      * @brief Retrieve an album by ID
      * @param album_id The album ID to retrieve
+     * @param include_images If false, image_ids is left empty (skips the membership read)
      * @return Optional album if found, nullopt otherwise
      */
-    virtual std::optional<Album> getAlbum(const std::string& album_id) = 0;
+    virtual std::optional<Album> getAlbum(const std::string& album_id,
+                                          bool include_images = true) = 0;
 
     /**
      * @brief List all albums or filter by published status
@@ -52,6 +149,20 @@ public:
      */
     virtual std::vector<Album> listAlbums(bool published_only = false) = 0;
 
+    /**
+     * @brief List a page of albums matching a query (keyset pagination)
+     *
+     * Tag filters are answered from the album_tags index rather than by
+     * scanning every album's tags.
+     *
+     * @param query Tag and published filters
+     * @param limit Maximum number of albums to return
+     * @param after Last row of the previous page, or nullopt for the first page
+     * @return Vector of albums, newest first, with their membership
+     */
+    virtual std::vector<Album> listAlbumsAfter(const AlbumQuery& query, int limit,
+                                               const std::optional<AlbumPageCursor>& after) = 0;
+
     /**
      * @brief Delete an album by ID
      * @param album_id The album ID to delete
@@ -68,6 +179,65 @@ public:
     virtual bool albumNameExists(const std::string& name,
                                  const std::string& exclude_album_id = "") = 0;
 
+    /**
+     * @brief Insert images into an album's ordered membership
+     * @param album_id The album to modify
+     * @param image_ids Images to insert, in order
+     * @param position Index to insert at; -1 or past the end appends
+     * @param updated_at New value for the album's updated_at
+     * @return true if successful, false otherwise
+     */
+    virtual bool addAlbumImages(const std::string& album_id,
+                                const std::vector<std::string>& image_ids,
+                                int position, std::time_t updated_at) = 0;
+
+    /**
+     * @brief Remove one image from an album
+     * @param album_id The album to modify
+     * @param image_id The image to remove
+     * @param updated_at New value for the album's updated_at
+     * @return true if the image was in the album, false otherwise
+     */
+    virtual bool removeAlbumImage(const std::string& album_id, const std::string& image_id,
+                                  std::time_t updated_at) = 0;
+
+    /**
+     * @brief Replace the order of an album's images
+     * @param album_id The album to modify
+     * @param image_ids Every image of the album in its new order
+     * @param updated_at New value for the album's updated_at
+     * @return true if successful, false otherwise
+     */
+    virtual bool reorderAlbumImages(const std::string& album_id,
+                                    const std::vector<std::string>& image_ids,
+                                    std::time_t updated_at) = 0;
+
+    /**
+     * @brief List a page of an album's image IDs in album order
+     * @param album_id The album to read
+     * @param limit Maximum number of IDs to return, or -1 for all of them
+     * @param offset Number of IDs to skip
+     * @return Vector of image IDs
+     */
+    virtual std::vector<std::string> listAlbumImages(const std::string& album_id,
+                                                     int limit, int offset) = 0;
+
+    /**
+     * @brief Count the images in an album
+     * @param album_id The album to count
+     * @return Number of images in the album
+     */
+    virtual int getAlbumImageCount(const std::string& album_id) = 0;
+
+    /**
+     * @brief Check which of many images belong to an album, without reading its membership
+     * @param album_id The album to check
+     * @param image_ids The image IDs to check
+     * @return The subset of image_ids in the album, or nullopt if the lookup failed
+     */
+    virtual std::optional<std::unordered_set<std::string>> albumImagesContained(
+        const std::string& album_id, const std::vector<std::string>& image_ids) = 0;
+
     /**
      * @brief Store or update image metadata
      * @param metadata The image metadata to store
@@ -75,6 +245,13 @@ public:
      */
     virtual bool putImageMetadata(const ImageMetadata& metadata) = 0;
 
+    /**
+     * @brief Store or update many images' metadata in one transaction
+     * @param batch The image metadata to store
+     * @return true if every row was stored, false (with nothing stored) otherwise
+     */
+    virtual bool putImageMetadataBatch(const std::vector<ImageMetadata>& batch) = 0;
+
     /**
      * @brief Retrieve image metadata by ID
      * @param image_id The image ID to retrieve
@@ -92,6 +269,20 @@ public:
     virtual std::vector<ImageMetadata> listImages(int limit, int offset,
                                                    ImageSortOrder sort_order) = 0;
 
+    /**
+     * @brief List images following a cursor (keyset pagination)
+     *
+     * Unlike OFFSET pagination the cost does not grow with page depth: the
+     * query seeks straight to the cursor on the sort index.
+     *
+     * @param limit Maximum number of images to return
+     * @param sort_order Sort order for results
+     * @param after Last row of the previous page, or nullopt for the first page
+     * @return Vector of image metadata
+     */
+    virtual std::vector<ImageMetadata> listImagesAfter(int limit, ImageSortOrder sort_order,
+                                                       const std::optional<ImagePageCursor>& after) = 0;
+
     /**
      * @brief Get total count of images
      * @return Total number of images in the database
@@ -104,6 +295,116 @@ public:
      * @return true if image exists, false otherwise
      */
     virtual bool imageExists(const std::string& image_id) = 0;
+
+    /**
+     * @brief Check which of many images exist, in as few queries as possible
+     * @param image_ids The image IDs to check
+     * @return The subset of image_ids present in the database
+     */
+    virtual std::unordered_set<std::string> imagesExist(const std::vector<std::string>& image_ids) = 0;
+
+    /**
+     * @brief Look up the placeholders of many images in as few queries as possible
+     * @param image_ids The image IDs to look up
+     * @return image_id -> placeholder for images that have one
+     */
+    virtual std::unordered_map<std::string, std::string> getImagePlaceholders(
+        const std::vector<std::string>& image_ids) = 0;
+
+    /**
+     * @brief Record a stored rendition, resetting its hit count
+     * @param record The rendition to store or update
+     * @return true if successful, false otherwise
+     */
+    virtual bool putRendition(const RenditionRecord& record) = 0;
+
+    /**
+     * @brief Mark renditions as accessed; unknown keys are ignored
+     * @param storage_keys Keys accessed since the last call (each counts as one hit)
+     * @param accessed_at New value for last_accessed
+     * @return true if successful, false otherwise
+     */
+    virtual bool touchRenditions(const std::vector<std::string>& storage_keys,
+                                 std::time_t accessed_at) = 0;
+
+    /**
+     * @brief List the storage keys of every recorded rendition of an image
+     * @param image_id The source image
+     * @return Vector of storage keys
+     */
+    virtual std::vector<std::string> listRenditionKeys(const std::string& image_id) = 0;
+
+    /**
+     * @brief List the renditions to evict first under a policy
+     * @param limit Maximum number of renditions to return
+     * @param policy Eviction order
+     * @return Vector of renditions, coldest first
+     */
+    virtual std::vector<RenditionRecord> listEvictionCandidates(int limit,
+                                                                RenditionEvictionPolicy policy) = 0;
+
+    /**
+     * @brief Remove renditions from the index
+     * @param storage_keys Keys to remove
+     * @return true if successful, false otherwise
+     */
+    virtual bool deleteRenditions(const std::vector<std::string>& storage_keys) = 0;
+
+    /**
+     * @brief Get total size of the recorded renditions
+     * @return Sum of size_bytes over the index
+     */
+    virtual uint64_t getRenditionBytes() = 0;
+
+    /**
+     * @brief Queue renditions for background generation
+     * @param jobs Jobs to add (job_id and attempts are ignored)
+     *
+     * Queueing a job that is already leased takes it away from its lease, so
+     * the in-flight claim cannot complete it; it runs again once the lease expires.
+     * @return true if every job was queued, false otherwise
+     */
+    virtual bool enqueueRenderJobs(const std::vector<RenderJob>& jobs) = 0;
+
+    /**
+     * @brief Lease the ready jobs of the highest-priority images
+     *
+     * A job is ready when it has not failed, run_after has passed and it
+     * holds no live lease. Every ready job of a claimed image is leased, so
+     * one decode can serve them all.
+     * @param lease_token Unique to this claim
+     * @param max_images Most images to claim
+     * @param now Current time
+     * @param lease_expires_at When jobs not completed or released become ready again
+     * @return Leased jobs grouped by image, with attempts counting this claim
+     */
+    virtual std::vector<RenderJob> claimRenderJobs(const std::string& lease_token, int max_images,
+                                                   std::time_t now, std::time_t lease_expires_at) = 0;
+
+    /**
+     * @brief Remove finished jobs from the queue
+     * @param lease_token The claim that leased them; jobs no longer held by it are left alone
+     * @param job_ids Jobs to remove
+     * @return true if successful, false otherwise
+     */
+    virtual bool completeRenderJobs(const std::string& lease_token, const std::vector<int64_t>& job_ids) = 0;
+
+    /**
+     * @brief Give up a leased job's lease
+     * @param lease_token The claim that leased it; a job no longer held by it is left alone
+     * @param job_id The job
+     * @param retry_at When it becomes ready again; std::nullopt marks it failed
+     * @param error Why the attempt failed
+     * @return true if successful, false otherwise
+     */
+    virtual bool releaseRenderJob(const std::string& lease_token, int64_t job_id,
+                                  std::optional<std::time_t> retry_at, const std::string& error) = 0;
+
+    /**
+     * @brief Count the queued jobs by state
+     * @param now Current time, which decides whether a lease is live
+     */
+    virtual RenderJobCounts getRenderJobCounts(std::time_t now) = 0;
 };
 
 } // namespace gara
@@ -1,6 +1,10 @@
 #ifndef GARA_FILE_SERVICE_INTERFACE_H
 #define GARA_FILE_SERVICE_INTERFACE_H
 
+#include "../utils/io_executor.h"
+#include "../utils/mapped_file.h"
+#include <future>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -24,6 +28,11 @@ public:
     virtual bool uploadData(const std::vector<char>& data, const std::string& key,
                            const std::string& content_type = "application/octet-stream") = 0;
 
+    // Move a local file into storage; local_path is consumed
+    // (implementations may rename instead of copying)
+    virtual bool moveFileToStorage(const std::string& local_path, const std::string& key,
+                                   const std::string& content_type = "application/octet-stream") = 0;
+
     // Download file to local path
     virtual bool downloadFile(const std::string& key, const std::string& local_path) = 0;
 
@@ -41,6 +50,48 @@ public:
 
     // Get storage name (bucket name or storage path)
     virtual const std::string& getBucketName() const = 0;
+
+    // Read-only view of a stored object without copying it, for backends
+    // that keep objects on local disk; nullptr means use downloadData
+    virtual std::shared_ptr<const utils::MappedFile> mapObject(const std::string& key) {
+        return nullptr;
+    }
+
+    // Asynchronous variants. The defaults run the blocking methods on the
+    // shared I/O pool; backends may override them with native async I/O.
+    // The service must outlive the returned futures.
+
+    virtual std::future<bool> uploadDataAsync(std::vector<char> data, const std::string& key,
+                                              const std::string& content_type = "application/octet-stream") {
+        return utils::IoExecutor::shared().submit([this, data = std::move(data), key, content_type]() {
+            return uploadData(data, key, content_type);
+        });
+    }
+
+    virtual std::future<bool> uploadFileAsync(const std::string& local_path, const std::string& key,
+                                              const std::string& content_type = "application/octet-stream") {
+        return utils::IoExecutor::shared().submit([this, local_path, key, content_type]() {
+            return uploadFile(local_path, key, content_type);
+        });
+    }
+
+    virtual std::future<bool> downloadFileAsync(const std::string& key, const std::string& local_path) {
+        return utils::IoExecutor::shared().submit([this, key, local_path]() {
+            return downloadFile(key, local_path);
+        });
+    }
+
+    virtual std::future<std::vector<char>> downloadDataAsync(const std::string& key) {
+        return utils::IoExecutor::shared().submit([this, key]() {
+            return downloadData(key);
+        });
+    }
+
+    virtual std::future<bool> objectExistsAsync(const std::string& key) {
+        return utils::IoExecutor::shared().submit([this, key]() {
+            return objectExists(key);
+        });
+    }
 };
 
 } // namespace gara
@@ -0,0 +1,100 @@
+#include "http_client.h"
+#include <curl/curl.h>
+
+namespace gara {
+namespace loadgen {
+
+namespace {
+
+struct BodySink {
+    size_t bytes = 0;
+    std::string* body = nullptr;
+};
+
+size_t writeBody(char* data, size_t size, size_t count, void* user) {
+    auto* sink = static_cast<BodySink*>(user);
+    size_t total = size * count;
+    sink->bytes += total;
+    if (sink->body) {
+        sink->body->append(data, total);
+    }
+    return total;
+}
+
+} // anonymous namespace
+
+HttpClient::HttpClient(const std::string& base_url, const std::string& api_key, int timeout_seconds)
+    : handle_(curl_easy_init()),
+      base_url_(base_url),
+      api_key_(api_key),
+      timeout_seconds_(timeout_seconds) {
+    while (!base_url_.empty() && base_url_.back() == '/') {
+        base_url_.pop_back();
+    }
+}
+
+HttpClient::~HttpClient() {
+    if (handle_) {
+        curl_easy_cleanup(static_cast<CURL*>(handle_));
+    }
+}
+
+HttpResult HttpClient::send(const PlannedRequest& request, bool keep_body) {
+    HttpResult result;
+    CURL* handle = static_cast<CURL*>(handle_);
+    if (!handle) {
+        result.error = "curl_easy_init failed";
+        return result;
+    }
+
+    // Reset per-request options; the connection cache survives
+    curl_easy_reset(handle);
+
+    std::string url = base_url_ + request.path;
+    curl_slist* headers = nullptr;
+    if (!request.content_type.empty()) {
+        headers = curl_slist_append(headers, ("Content-Type: " + request.content_type).c_str());
+    }
+    if (request.authenticated && !api_key_.empty()) {
+        headers = curl_slist_append(headers, ("X-API-Key: " + api_key_).c_str());
+    }
+    // Ask for compressed-capable responses like real clients do
+    headers = curl_slist_append(headers, "Accept: image/avif,image/webp,*/*");
+
+    BodySink sink;
+    sink.body = keep_body ? &result.body : nullptr;
+
+    curl_easy_setopt(handle, CURLOPT_URL, url.c_str());
+    curl_easy_setopt(handle, CURLOPT_HTTPHEADER, headers);
+    curl_easy_setopt(handle, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(handle, CURLOPT_TCP_KEEPALIVE, 1L);
+    curl_easy_setopt(handle, CURLOPT_TCP_NODELAY, 1L);
+    curl_easy_setopt(handle, CURLOPT_TIMEOUT, static_cast<long>(timeout_seconds_));
+    curl_easy_setopt(handle, CURLOPT_FOLLOWLOCATION, 0L);
+    curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, writeBody);
+    curl_easy_setopt(handle, CURLOPT_WRITEDATA, &sink);
+
+    if (request.method == "HEAD") {
+        curl_easy_setopt(handle, CURLOPT_NOBODY, 1L);
+    } else if (request.method == "POST") {
+        curl_easy_setopt(handle, CURLOPT_POST, 1L);
+        curl_easy_setopt(handle, CURLOPT_POSTFIELDS, request.body.data());
+        curl_easy_setopt(handle, CURLOPT_POSTFIELDSIZE_LARGE, static_cast<curl_off_t>(request.body.size()));
+    } else if (request.method != "GET") {
+        curl_easy_setopt(handle, CURLOPT_CUSTOMREQUEST, request.method.c_str());
+    }
+
+    CURLcode code = curl_easy_perform(handle);
+    curl_slist_free_all(headers);
+
+    if (code != CURLE_OK) {
+        result.error = curl_easy_strerror(code);
+        return result;
+    }
+    curl_easy_getinfo(handle, CURLINFO_RESPONSE_CODE, &result.status);
+    result.bytes = sink.bytes;
+    return result;
+}
+
+} // namespace loadgen
+} // namespace gara
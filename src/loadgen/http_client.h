@@ -0,0 +1,44 @@
+#ifndef GARA_LOADGEN_HTTP_CLIENT_H
+#define GARA_LOADGEN_HTTP_CLIENT_H
+
+#include "workload.h"
+#include <string>
+
+namespace gara {
+namespace loadgen {
+
+struct HttpResult {
+    long status = 0;          // 0 when the transfer itself failed
+    size_t bytes = 0;         // Response body size
+    std::string body;         // Only filled when the request asked for it
+    std::string error;        // libcurl error for failed transfers
+};
+
+/**
+ * @brief Blocking keep-alive HTTP client for one load generator worker
+ *
+ * Owns a single libcurl easy handle, so consecutive requests reuse the
+ * connection exactly as a browser or CDN would. Redirects are not followed:
+ * the measured latency is the server's, not the storage backend's.
+ */
+class HttpClient {
+public:
+    HttpClient(const std::string& base_url, const std::string& api_key, int timeout_seconds);
+    ~HttpClient();
+
+    HttpClient(const HttpClient&) = delete;
+    HttpClient& operator=(const HttpClient&) = delete;
+
+    HttpResult send(const PlannedRequest& request, bool keep_body = false);
+
+private:
+    void* handle_;  // CURL*, kept out of the header
+    std::string base_url_;
+    std::string api_key_;
+    int timeout_seconds_;
+};
+
+} // namespace loadgen
+} // namespace gara
+
+#endif // GARA_LOADGEN_HTTP_CLIENT_H
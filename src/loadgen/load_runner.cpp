@@ -0,0 +1,267 @@
+#include "load_runner.h"
+#include "http_client.h"
+#include <iomanip>
+#include <sstream>
+#include <thread>
+
+namespace gara {
+namespace loadgen {
+
+namespace {
+
+// A send this far behind its slot means every worker was busy
+constexpr auto LATE_SEND_THRESHOLD = std::chrono::milliseconds(10);
+
+const double REPORTED_PERCENTILES[] = {50.0, 90.0, 99.0, 99.9};
+
+double toMs(uint64_t micros) {
+    return static_cast<double>(micros) / 1000.0;
+}
+
+const char* modeName(LoadMode mode) {
+    switch (mode) {
+        case LoadMode::OPEN: return "open";
+        case LoadMode::REPLAY: return "replay";
+        default: return "closed";
+    }
+}
+
+} // anonymous namespace
+
+// ============================================================================
+// Reports
+// ============================================================================
+
+void OperationReport::merge(const OperationReport& other) {
+    latency.merge(other.latency);
+    requests += other.requests;
+    ok += other.ok;
+    client_errors += other.client_errors;
+    server_errors += other.server_errors;
+    transport_errors += other.transport_errors;
+    bytes += other.bytes;
+}
+
+OperationReport LoadReport::total() const {
+    OperationReport total;
+    for (const auto& report : operations) {
+        total.merge(report);
+    }
+    return total;
+}
+
+void LoadReport::print(std::ostream& out, const LoadgenConfig& config) const {
+    out << "mode=" << modeName(config.mode) << " concurrency=" << config.concurrency;
+    if (config.mode == LoadMode::OPEN) {
+        out << " target_rate=" << config.rate << "/s";
+    }
+    out << " measured=" << std::fixed << std::setprecision(1) << elapsed_seconds << "s\n\n";
+
+    out << std::left << std::setw(12) << "operation" << std::right
+        << std::setw(10) << "requests" << std::setw(9) << "rps"
+        << std::setw(8) << "2xx/3xx" << std::setw(7) << "4xx" << std::setw(7) << "5xx" << std::setw(7) << "err"
+        << std::setw(10) << "mean" << std::setw(10) << "p50" << std::setw(10) << "p90"
+        << std::setw(10) << "p99" << std::setw(10) << "p99.9" << std::setw(10) << "max" << "  (ms)\n";
+
+    auto row = [&](const std::string& name, const OperationReport& report) {
+        double rps = elapsed_seconds > 0 ? report.requests / elapsed_seconds : 0;
+        out << std::left << std::setw(12) << name << std::right
+            << std::setw(10) << report.requests << std::setw(9) << std::setprecision(1) << rps
+            << std::setw(8) << report.ok << std::setw(7) << report.client_errors
+            << std::setw(7) << report.server_errors << std::setw(7) << report.transport_errors
+            << std::setprecision(2) << std::setw(10) << report.latency.mean() / 1000.0;
+        for (double p : REPORTED_PERCENTILES) {
+            out << std::setw(10) << toMs(report.latency.percentile(p));
+        }
+        out << std::setw(10) << toMs(report.latency.max()) << "\n";
+    };
+
+    for (size_t i = 0; i < OPERATION_COUNT; ++i) {
+        if (operations[i].requests > 0) {
+            row(operationName(static_cast<Operation>(i)), operations[i]);
+        }
+    }
+    row("total", total());
+
+    if (late_sends > 0) {
+        out << "\n" << late_sends << " requests started more than "
+            << LATE_SEND_THRESHOLD.count() << "ms late; raise --concurrency to hold the rate\n";
+    }
+    if (skipped_lines > 0) {
+        out << skipped_lines << " access-log lines skipped (not GET/HEAD or unparseable)\n";
+    }
+}
+
+nlohmann::json LoadReport::toJson(const LoadgenConfig& config) const {
+    auto encode = [&](const OperationReport& report) {
+        nlohmann::json percentiles = nlohmann::json::object();
+        for (double p : REPORTED_PERCENTILES) {
+            std::ostringstream name;
+            name << "p" << p;
+            percentiles[name.str()] = toMs(report.latency.percentile(p));
+        }
+        return nlohmann::json{
+            {"requests", report.requests},
+            {"throughput_rps", elapsed_seconds > 0 ? report.requests / elapsed_seconds : 0},
+            {"ok", report.ok},
+            {"client_errors", report.client_errors},
+            {"server_errors", report.server_errors},
+            {"transport_errors", report.transport_errors},
+            {"bytes", report.bytes},
+            {"latency_ms", {
+                {"mean", report.latency.mean() / 1000.0},
+                {"min", toMs(report.latency.min())},
+                {"max", toMs(report.latency.max())},
+                {"percentiles", percentiles}
+            }}
+        };
+    };
+
+    nlohmann::json ops = nlohmann::json::object();
+    for (size_t i = 0; i < OPERATION_COUNT; ++i) {
+        if (operations[i].requests > 0) {
+            ops[operationName(static_cast<Operation>(i))] = encode(operations[i]);
+        }
+    }
+
+    return {
+        {"mode", modeName(config.mode)},
+        {"url", config.base_url},
+        {"concurrency", config.concurrency},
+        {"target_rate", config.mode == LoadMode::OPEN ? nlohmann::json(config.rate) : nlohmann::json(nullptr)},
+        {"elapsed_seconds", elapsed_seconds},
+        {"late_sends", late_sends},
+        {"skipped_lines", skipped_lines},
+        {"operations", ops},
+        {"total", encode(total())}
+    };
+}
+
+// ============================================================================
+// LoadRunner
+// ============================================================================
+
+LoadRunner::LoadRunner(const LoadgenConfig& config, const WorkloadGenerator* generator,
+                       std::vector<AccessLogEntry> entries)
+    : config_(config), generator_(generator), entries_(std::move(entries)) {
+}
+
+uint64_t LoadRunner::requestLimit() const {
+    uint64_t limit = config_.mode == LoadMode::REPLAY ? entries_.size() : UINT64_MAX;
+    if (config_.max_requests > 0) {
+        limit = std::min(limit, config_.max_requests);
+    }
+    return limit;
+}
+
+std::optional<LoadRunner::Clock::time_point> LoadRunner::dueTime(uint64_t i) const {
+    if (config_.mode == LoadMode::OPEN) {
+        return start_ + std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double>(static_cast<double>(i) / config_.rate));
+    }
+    if (config_.mode == LoadMode::REPLAY && config_.replay_speed > 0) {
+        return start_ + std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double>(entries_[i].offset_seconds / config_.replay_speed));
+    }
+    return std::nullopt;
+}
+
+PlannedRequest LoadRunner::requestFor(uint64_t i, std::mt19937_64& rng) const {
+    if (config_.mode == LoadMode::REPLAY) {
+        const AccessLogEntry& entry = entries_[i];
+        PlannedRequest request;
+        request.op = AccessLog::classify(entry.method, entry.path);
+        request.method = entry.method;
+        request.path = entry.path;
+        return request;
+    }
+    return generator_->next(rng);
+}
+
+void LoadRunner::record(Operation op, long status, size_t bytes, uint64_t latency_us) {
+    size_t index = static_cast<size_t>(op);
+    std::lock_guard<std::mutex> lock(mutexes_[index]);
+    OperationReport& report = reports_[index];
+    report.latency.record(latency_us);
+    report.requests++;
+    report.bytes += bytes;
+    if (status == 0) {
+        report.transport_errors++;
+    } else if (status >= 500) {
+        report.server_errors++;
+    } else if (status >= 400) {
+        report.client_errors++;
+    } else {
+        report.ok++;
+    }
+}
+
+void LoadRunner::workerLoop(int worker) {
+    HttpClient client(config_.base_url, config_.api_key, config_.timeout_seconds);
+    std::mt19937_64 rng(config_.seed * 7919 + static_cast<uint64_t>(worker));
+    uint64_t limit = requestLimit();
+
+    for (;;) {
+        uint64_t i = next_request_.fetch_add(1);
+        if (i >= limit) {
+            return;
+        }
+
+        auto due = dueTime(i);
+        if (due) {
+            if (stop_at_ && *due >= *stop_at_) {
+                return;
+            }
+            std::this_thread::sleep_until(*due);
+        }
+        Clock::time_point sent = Clock::now();
+        if (stop_at_ && sent >= *stop_at_) {
+            return;
+        }
+        if (due && sent - *due > LATE_SEND_THRESHOLD) {
+            late_sends_++;
+        }
+
+        PlannedRequest request = requestFor(i, rng);
+        HttpResult result = client.send(request);
+        Clock::time_point done = Clock::now();
+
+        Clock::time_point began = due ? *due : sent;
+        if (began < measure_from_) {
+            continue;  // Warmup
+        }
+        auto latency = std::chrono::duration_cast<std::chrono::microseconds>(done - began).count();
+        record(request.op, result.status, result.bytes, static_cast<uint64_t>(latency));
+    }
+}
+
+LoadReport LoadRunner::run() {
+    start_ = Clock::now();
+    measure_from_ = start_ + std::chrono::seconds(config_.warmup_seconds);
+    if (config_.duration_seconds > 0) {
+        stop_at_ = measure_from_ + std::chrono::seconds(config_.duration_seconds);
+    }
+
+    std::vector<std::thread> workers;
+    workers.reserve(config_.concurrency);
+    for (int i = 0; i < config_.concurrency; ++i) {
+        workers.emplace_back(&LoadRunner::workerLoop, this, i);
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    Clock::time_point end = Clock::now();
+    if (stop_at_) {
+        end = std::min(end, *stop_at_);
+    }
+
+    LoadReport report;
+    report.operations = reports_;
+    report.elapsed_seconds = std::max(0.0, std::chrono::duration<double>(end - measure_from_).count());
+    report.late_sends = late_sends_.load();
+    return report;
+}
+
+} // namespace loadgen
+} // namespace gara
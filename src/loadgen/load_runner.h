@@ -0,0 +1,85 @@
+#ifndef GARA_LOADGEN_LOAD_RUNNER_H
+#define GARA_LOADGEN_LOAD_RUNNER_H
+
+#include "loadgen_config.h"
+#include "workload.h"
+#include "../utils/latency_histogram.h"
+#include <nlohmann/json.hpp>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <ostream>
+#include <vector>
+
+namespace gara {
+namespace loadgen {
+
+struct OperationReport {
+    utils::LatencyHistogram latency;  // Microseconds
+    uint64_t requests = 0;
+    uint64_t ok = 0;                  // 2xx and 3xx
+    uint64_t client_errors = 0;       // 4xx
+    uint64_t server_errors = 0;       // 5xx (503 = load shedding)
+    uint64_t transport_errors = 0;    // Timeouts, refused connections
+    uint64_t bytes = 0;
+
+    void merge(const OperationReport& other);
+};
+
+struct LoadReport {
+    std::array<OperationReport, OPERATION_COUNT> operations;
+    double elapsed_seconds = 0;   // Measured window only
+    uint64_t late_sends = 0;      // Open/replay requests sent >10ms after their slot (workers saturated)
+    uint64_t skipped_lines = 0;   // Access-log lines that could not be replayed
+
+    OperationReport total() const;
+    void print(std::ostream& out, const LoadgenConfig& config) const;
+    nlohmann::json toJson(const LoadgenConfig& config) const;
+};
+
+/**
+ * @brief Drives one load test and collects latencies per operation
+ *
+ * Open and replay modes measure each request from the time it was due,
+ * not from when a worker got to it, so a saturated server shows up as
+ * latency instead of as silently lower load (no coordinated omission).
+ */
+class LoadRunner {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // Generator drives closed and open modes; entries drive replay mode
+    LoadRunner(const LoadgenConfig& config, const WorkloadGenerator* generator,
+               std::vector<AccessLogEntry> entries = {});
+
+    LoadReport run();
+
+private:
+    // When request i is due, or nullopt in closed mode / unpaced replay
+    std::optional<Clock::time_point> dueTime(uint64_t i) const;
+    PlannedRequest requestFor(uint64_t i, std::mt19937_64& rng) const;
+    uint64_t requestLimit() const;
+    void workerLoop(int worker);
+    void record(Operation op, long status, size_t bytes, uint64_t latency_us);
+
+    LoadgenConfig config_;
+    const WorkloadGenerator* generator_;
+    std::vector<AccessLogEntry> entries_;
+
+    Clock::time_point start_;
+    Clock::time_point measure_from_;
+    std::optional<Clock::time_point> stop_at_;
+
+    std::atomic<uint64_t> next_request_{0};
+    std::atomic<uint64_t> late_sends_{0};
+    std::array<std::mutex, OPERATION_COUNT> mutexes_;
+    std::array<OperationReport, OPERATION_COUNT> reports_;
+};
+
+} // namespace loadgen
+} // namespace gara
+
+#endif // GARA_LOADGEN_LOAD_RUNNER_H
@@ -0,0 +1,160 @@
+#ifndef GARA_LOADGEN_CONFIG_H
+#define GARA_LOADGEN_CONFIG_H
+
+#include "workload.h"
+#include <algorithm>
+#include <cstdlib>
+#include <optional>
+#include <string>
+
+namespace gara {
+namespace loadgen {
+
+enum class LoadMode {
+    CLOSED,  // Fixed number of workers, each sends as soon as the last reply arrives
+    OPEN,    // Constant arrival rate regardless of how fast the server answers
+    REPLAY   // Access-log requests at their original spacing (scaled by speed)
+};
+
+struct LoadgenConfig {
+    std::string base_url;
+    std::string api_key;
+    LoadMode mode;
+    int concurrency;            // Workers (closed) or max requests in flight (open, replay)
+    double rate;                // Requests per second in open mode
+    int duration_seconds;       // Measurement length; 0 means until max_requests (or log end)
+    int warmup_seconds;         // Excluded from the report
+    uint64_t max_requests;      // Stop after this many (0 = no limit)
+    int timeout_seconds;        // Per request
+    TrafficMix mix;
+    std::string upload_file;    // Image uploaded by the upload operation (empty disables it)
+    std::string access_log;     // Log replayed in replay mode
+    double replay_speed;        // 2.0 replays twice as fast; 0 sends as fast as workers allow
+    std::string json_out;       // Write the report as JSON here
+    uint64_t seed;
+
+    // Default constructor with sensible defaults
+    LoadgenConfig()
+        : base_url("http://localhost:8080"),
+          mode(LoadMode::CLOSED),
+          concurrency(16),
+          rate(100.0),
+          duration_seconds(30),
+          warmup_seconds(5),
+          max_requests(0),
+          timeout_seconds(30),
+          mix(TrafficMix::defaults()),
+          replay_speed(1.0),
+          seed(1) {}
+
+    static const char* usage() {
+        return
+            "Usage: gara-loadgen [options]\n"
+            "  --url=URL              Server base URL (default http://localhost:8080)\n"
+            "  --mode=MODE            closed | open | replay (default closed)\n"
+            "  --concurrency=N        Workers, or max in-flight requests for open/replay (default 16)\n"
+            "  --rate=R               Open-loop arrival rate in requests/s (default 100)\n"
+            "  --duration=S           Measured seconds after warmup (default 30; replay: whole log)\n"
+            "  --warmup=S             Seconds excluded from the report (default 5)\n"
+            "  --requests=N           Stop after N requests (default unlimited)\n"
+            "  --timeout=S            Per-request timeout (default 30)\n"
+            "  --mix=SPEC             Weights, e.g. cached_get=70,cold_get=5,list=15,album=8,upload=2\n"
+            "  --upload-file=PATH     Image sent by upload requests (required for uploads)\n"
+            "  --api-key=KEY          X-API-Key for uploads (default $API_KEY)\n"
+            "  --access-log=PATH      Combined Log Format or JSON-lines log for --mode=replay\n"
+            "  --speed=X              Replay speed multiplier, 0 = as fast as possible (default 1)\n"
+            "  --json-out=PATH        Also write the report as JSON\n"
+            "  --seed=N               Random seed (default 1)\n";
+    }
+
+    // Factory method to create config from command-line flags (--name=value)
+    static std::optional<LoadgenConfig> fromArgs(int argc, char** argv, std::string& error) {
+        LoadgenConfig config;
+        const char* api_key_env = std::getenv("API_KEY");
+        if (api_key_env) {
+            config.api_key = api_key_env;
+        }
+
+        bool duration_set = false;
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            size_t eq = arg.find('=');
+            if (arg.rfind("--", 0) != 0 || eq == std::string::npos) {
+                error = "Expected --name=value, got: " + arg;
+                return std::nullopt;
+            }
+            std::string name = arg.substr(2, eq - 2);
+            std::string value = arg.substr(eq + 1);
+
+            if (name == "url") {
+                config.base_url = value;
+            } else if (name == "mode") {
+                if (value == "closed") {
+                    config.mode = LoadMode::CLOSED;
+                } else if (value == "open") {
+                    config.mode = LoadMode::OPEN;
+                } else if (value == "replay") {
+                    config.mode = LoadMode::REPLAY;
+                } else {
+                    error = "Unknown mode: " + value;
+                    return std::nullopt;
+                }
+            } else if (name == "concurrency") {
+                config.concurrency = std::clamp(std::atoi(value.c_str()), 1, 4096);
+            } else if (name == "rate") {
+                config.rate = std::max(0.001, std::atof(value.c_str()));
+            } else if (name == "duration") {
+                config.duration_seconds = std::max(0, std::atoi(value.c_str()));
+                duration_set = true;
+            } else if (name == "warmup") {
+                config.warmup_seconds = std::max(0, std::atoi(value.c_str()));
+            } else if (name == "requests") {
+                config.max_requests = std::strtoull(value.c_str(), nullptr, 10);
+            } else if (name == "timeout") {
+                config.timeout_seconds = std::max(1, std::atoi(value.c_str()));
+            } else if (name == "mix") {
+                auto mix = TrafficMix::parse(value, error);
+                if (!mix) {
+                    return std::nullopt;
+                }
+                config.mix = *mix;
+            } else if (name == "upload-file") {
+                config.upload_file = value;
+            } else if (name == "api-key") {
+                config.api_key = value;
+            } else if (name == "access-log") {
+                config.access_log = value;
+            } else if (name == "speed") {
+                config.replay_speed = std::max(0.0, std::atof(value.c_str()));
+            } else if (name == "json-out") {
+                config.json_out = value;
+            } else if (name == "seed") {
+                config.seed = std::strtoull(value.c_str(), nullptr, 10);
+            } else {
+                error = "Unknown option: --" + name;
+                return std::nullopt;
+            }
+        }
+
+        if (config.mode == LoadMode::REPLAY) {
+            if (config.access_log.empty()) {
+                error = "--mode=replay needs --access-log";
+                return std::nullopt;
+            }
+            // A replay runs to the end of the log unless told otherwise
+            if (!duration_set) {
+                config.duration_seconds = 0;
+            }
+        }
+        if (config.duration_seconds == 0 && config.max_requests == 0 && config.mode != LoadMode::REPLAY) {
+            error = "--duration=0 needs --requests";
+            return std::nullopt;
+        }
+        return config;
+    }
+};
+
+} // namespace loadgen
+} // namespace gara
+
+#endif // GARA_LOADGEN_CONFIG_H
@@ -0,0 +1,101 @@
+#include "http_client.h"
+#include "load_runner.h"
+#include "loadgen_config.h"
+#include "workload.h"
+#include "../utils/file_utils.h"
+#include <curl/curl.h>
+#include <nlohmann/json.hpp>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+using namespace gara::loadgen;
+
+namespace {
+
+// Image and album ids to aim GETs at, read from the server's own listings
+Corpus discoverCorpus(const LoadgenConfig& config) {
+    Corpus corpus;
+    HttpClient client(config.base_url, config.api_key, config.timeout_seconds);
+
+    auto fetch = [&](const std::string& path, const char* array, const char* id_field,
+                     std::vector<std::string>& ids) {
+        PlannedRequest request;
+        request.path = path;
+        HttpResult result = client.send(request, true);
+        if (result.status != 200) {
+            std::cerr << "warning: GET " << path << " returned "
+                      << (result.status ? std::to_string(result.status) : result.error) << "\n";
+            return;
+        }
+        auto body = nlohmann::json::parse(result.body, nullptr, false);
+        if (body.is_discarded() || !body.contains(array)) {
+            return;
+        }
+        for (const auto& item : body[array]) {
+            if (item.contains(id_field) && item[id_field].is_string()) {
+                ids.push_back(item[id_field].get<std::string>());
+            }
+        }
+    };
+    fetch("/api/images?limit=1000&sort=newest", "images", "image_id", corpus.image_ids);
+    fetch("/api/albums", "albums", "album_id", corpus.album_ids);
+
+    if (!config.upload_file.empty()) {
+        corpus.upload_payload = gara::utils::FileUtils::readFile(config.upload_file);
+        corpus.upload_filename = std::filesystem::path(config.upload_file).filename().string();
+        if (corpus.upload_payload.empty()) {
+            std::cerr << "warning: could not read " << config.upload_file << ", uploads disabled\n";
+        }
+    }
+    return corpus;
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv) {
+    std::string error;
+    auto config = LoadgenConfig::fromArgs(argc, argv, error);
+    if (!config) {
+        std::cerr << "gara-loadgen: " << error << "\n\n" << LoadgenConfig::usage();
+        return 2;
+    }
+
+    curl_global_init(CURL_GLOBAL_DEFAULT);
+
+    std::unique_ptr<WorkloadGenerator> generator;
+    std::vector<AccessLogEntry> entries;
+    size_t skipped = 0;
+
+    if (config->mode == LoadMode::REPLAY) {
+        entries = AccessLog::load(config->access_log, skipped);
+        if (entries.empty()) {
+            std::cerr << "gara-loadgen: no replayable requests in " << config->access_log << "\n";
+            curl_global_cleanup();
+            return 1;
+        }
+        std::cerr << "Replaying " << entries.size() << " requests spanning "
+                  << entries.back().offset_seconds << "s\n";
+    } else {
+        Corpus corpus = discoverCorpus(*config);
+        std::cerr << "Target has " << corpus.image_ids.size() << " images and "
+                  << corpus.album_ids.size() << " albums\n";
+        if (corpus.upload_payload.empty() && config->mix.weights[static_cast<size_t>(Operation::UPLOAD)] > 0) {
+            std::cerr << "warning: no --upload-file, upload traffic becomes list traffic\n";
+        }
+        generator = std::make_unique<WorkloadGenerator>(config->mix, std::move(corpus));
+    }
+
+    LoadRunner runner(*config, generator.get(), std::move(entries));
+    LoadReport report = runner.run();
+    report.skipped_lines = skipped;
+
+    report.print(std::cout, *config);
+    if (!config->json_out.empty()) {
+        std::ofstream out(config->json_out);
+        out << report.toJson(*config).dump(2) << "\n";
+    }
+
+    curl_global_cleanup();
+    return 0;
+}
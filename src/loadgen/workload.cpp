@@ -0,0 +1,347 @@
+#include "workload.h"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <sstream>
+
+namespace gara {
+namespace loadgen {
+
+namespace {
+
+const char* OPERATION_NAMES[OPERATION_COUNT] = {
+    "upload", "cached_get", "cold_get", "list", "album", "other"
+};
+
+// Widths for COLD_GET cycle through this range before quality changes
+constexpr uint64_t COLD_WIDTH_MIN = 64;
+constexpr uint64_t COLD_WIDTH_SPAN = 3000;
+
+const char* LIST_SORTS[] = {"newest", "oldest", "name_asc", "name_desc"};
+
+int monthIndex(const char* name) {
+    static const char* months[] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun",
+                                   "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+    for (int i = 0; i < 12; ++i) {
+        if (std::strncmp(name, months[i], 3) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// "10/Oct/2000:13:55:36 -0700" -> epoch seconds
+std::optional<double> parseClfTime(const std::string& text) {
+    int day = 0, year = 0, hour = 0, minute = 0, second = 0, zone = 0;
+    char month[4] = {0};
+    if (std::sscanf(text.c_str(), "%d/%3s/%d:%d:%d:%d %d", &day, month, &year, &hour, &minute, &second, &zone) < 6) {
+        return std::nullopt;
+    }
+    int mon = monthIndex(month);
+    if (mon < 0) {
+        return std::nullopt;
+    }
+    std::tm tm{};
+    tm.tm_mday = day;
+    tm.tm_mon = mon;
+    tm.tm_year = year - 1900;
+    tm.tm_hour = hour;
+    tm.tm_min = minute;
+    tm.tm_sec = second;
+    int zone_seconds = (std::abs(zone) / 100 * 3600 + std::abs(zone) % 100 * 60) * (zone < 0 ? -1 : 1);
+    return static_cast<double>(timegm(&tm)) - zone_seconds;
+}
+
+// "2025-01-02T03:04:05.678Z" -> epoch seconds (zone suffix ignored: logs are UTC)
+std::optional<double> parseIsoTime(const std::string& text) {
+    std::tm tm{};
+    double seconds = 0;
+    if (std::sscanf(text.c_str(), "%d-%d-%dT%d:%d:%lf", &tm.tm_year, &tm.tm_mon, &tm.tm_mday,
+                    &tm.tm_hour, &tm.tm_min, &seconds) != 6) {
+        return std::nullopt;
+    }
+    tm.tm_year -= 1900;
+    tm.tm_mon -= 1;
+    double whole = std::floor(seconds);
+    tm.tm_sec = static_cast<int>(whole);
+    return static_cast<double>(timegm(&tm)) + (seconds - whole);
+}
+
+std::string randomHex(std::mt19937_64& rng, int bytes) {
+    static const char* digits = "0123456789abcdef";
+    std::string out;
+    out.reserve(bytes * 2);
+    for (int i = 0; i < bytes; ++i) {
+        auto byte = static_cast<unsigned>(rng() & 0xFF);
+        out.push_back(digits[byte >> 4]);
+        out.push_back(digits[byte & 0xF]);
+    }
+    return out;
+}
+
+} // anonymous namespace
+
+const char* operationName(Operation op) {
+    return OPERATION_NAMES[static_cast<size_t>(op)];
+}
+
+// ============================================================================
+// TrafficMix
+// ============================================================================
+
+TrafficMix TrafficMix::defaults() {
+    TrafficMix mix;
+    mix.weights[static_cast<size_t>(Operation::UPLOAD)] = 2;
+    mix.weights[static_cast<size_t>(Operation::CACHED_GET)] = 70;
+    mix.weights[static_cast<size_t>(Operation::COLD_GET)] = 5;
+    mix.weights[static_cast<size_t>(Operation::LIST)] = 15;
+    mix.weights[static_cast<size_t>(Operation::ALBUM)] = 8;
+    return mix;
+}
+
+std::optional<TrafficMix> TrafficMix::parse(const std::string& spec, std::string& error) {
+    TrafficMix mix;
+    std::stringstream stream(spec);
+    std::string entry;
+    while (std::getline(stream, entry, ',')) {
+        if (entry.empty()) {
+            continue;
+        }
+        size_t eq = entry.find('=');
+        std::string name = entry.substr(0, eq);
+        size_t index = 0;
+        while (index < OPERATION_COUNT - 1 && name != OPERATION_NAMES[index]) {
+            ++index;
+        }
+        if (index == OPERATION_COUNT - 1) {
+            error = "Unknown operation in mix: " + name;
+            return std::nullopt;
+        }
+        double weight = eq == std::string::npos ? 1.0 : std::atof(entry.c_str() + eq + 1);
+        if (weight < 0) {
+            error = "Negative weight in mix: " + entry;
+            return std::nullopt;
+        }
+        mix.weights[index] = weight;
+    }
+
+    double total = 0;
+    for (double weight : mix.weights) {
+        total += weight;
+    }
+    if (total <= 0) {
+        error = "Traffic mix has no positive weights";
+        return std::nullopt;
+    }
+    return mix;
+}
+
+Operation TrafficMix::pick(std::mt19937_64& rng) const {
+    std::discrete_distribution<size_t> distribution(weights.begin(), weights.end());
+    return static_cast<Operation>(distribution(rng));
+}
+
+// ============================================================================
+// WorkloadGenerator
+// ============================================================================
+
+WorkloadGenerator::WorkloadGenerator(const TrafficMix& mix, Corpus corpus, int warm_set_size)
+    : mix_(mix), corpus_(std::move(corpus)), warm_set_size_(std::max(1, warm_set_size)) {
+}
+
+PlannedRequest WorkloadGenerator::next(std::mt19937_64& rng) const {
+    return build(mix_.pick(rng), rng);
+}
+
+PlannedRequest WorkloadGenerator::build(Operation op, std::mt19937_64& rng) const {
+    const auto& images = corpus_.image_ids;
+    if ((op == Operation::CACHED_GET || op == Operation::COLD_GET) && images.empty()) {
+        op = Operation::LIST;
+    }
+    if (op == Operation::UPLOAD && corpus_.upload_payload.empty()) {
+        op = Operation::LIST;
+    }
+
+    PlannedRequest request;
+    request.op = op;
+
+    switch (op) {
+        case Operation::UPLOAD: {
+            std::string boundary = "gara-loadgen-" + randomHex(rng, 8);
+            request.method = "POST";
+            request.path = "/api/images/upload";
+            request.content_type = "multipart/form-data; boundary=" + boundary;
+            request.body = multipartBody(corpus_.upload_payload, corpus_.upload_filename, boundary,
+                                         randomHex(rng, 16));
+            request.authenticated = true;
+            break;
+        }
+        case Operation::CACHED_GET: {
+            size_t warm = std::min(images.size(), static_cast<size_t>(warm_set_size_));
+            request.path = "/api/images/" + images[rng() % warm] + "?format=webp&width=320";
+            break;
+        }
+        case Operation::COLD_GET: {
+            // Walk (width, quality, image) combinations so a rendition is never asked for twice
+            uint64_t n = cold_counter_.fetch_add(1);
+            uint64_t width = COLD_WIDTH_MIN + n % COLD_WIDTH_SPAN;
+            uint64_t quality = 40 + (n / COLD_WIDTH_SPAN) % 60;
+            const std::string& id = images[(n / (COLD_WIDTH_SPAN * 60)) % images.size()];
+            request.path = "/api/images/" + id + "?format=jpeg&width=" + std::to_string(width) +
+                           "&quality=" + std::to_string(quality);
+            break;
+        }
+        case Operation::LIST: {
+            size_t pages = std::max<size_t>(1, images.size() / 50);
+            request.path = "/api/images?limit=50&offset=" + std::to_string((rng() % pages) * 50) +
+                           "&sort=" + LIST_SORTS[rng() % 4];
+            break;
+        }
+        case Operation::ALBUM: {
+            const auto& albums = corpus_.album_ids;
+            if (albums.empty() || rng() % 4 == 0) {
+                request.path = "/api/albums";
+            } else {
+                request.path = "/api/albums/" + albums[rng() % albums.size()];
+            }
+            break;
+        }
+        case Operation::OTHER:
+            request.path = "/health";
+            break;
+    }
+    return request;
+}
+
+std::string WorkloadGenerator::multipartBody(const std::vector<char>& payload, const std::string& filename,
+                                             const std::string& boundary, const std::string& trailer) {
+    std::string body;
+    body.reserve(payload.size() + trailer.size() + 256);
+    body += "--" + boundary + "\r\n";
+    body += "Content-Disposition: form-data; name=\"file\"; filename=\"" + filename + "\"\r\n";
+    body += "Content-Type: application/octet-stream\r\n\r\n";
+    body.append(payload.begin(), payload.end());
+    // Decoders stop at the end-of-image marker, so trailing bytes only change the hash
+    body += trailer;
+    body += "\r\n--" + boundary + "--\r\n";
+    return body;
+}
+
+// ============================================================================
+// AccessLog
+// ============================================================================
+
+std::optional<std::pair<double, AccessLogEntry>> AccessLog::parseLine(const std::string& line) {
+    size_t start = line.find_first_not_of(" \t");
+    if (start == std::string::npos) {
+        return std::nullopt;
+    }
+
+    AccessLogEntry entry;
+    double timestamp = 0;
+
+    if (line[start] == '{') {
+        auto j = nlohmann::json::parse(line, nullptr, false);
+        if (j.is_discarded() || !j.is_object()) {
+            return std::nullopt;
+        }
+        for (const char* key : {"path", "url", "endpoint", "uri"}) {
+            if (j.contains(key) && j[key].is_string()) {
+                entry.path = j[key].get<std::string>();
+                break;
+            }
+        }
+        entry.method = j.value("method", std::string("GET"));
+        for (const char* key : {"timestamp", "time", "ts"}) {
+            if (!j.contains(key)) {
+                continue;
+            }
+            if (j[key].is_number()) {
+                timestamp = j[key].get<double>();
+                // Millisecond epochs
+                if (timestamp > 1e11) {
+                    timestamp /= 1000.0;
+                }
+            } else if (j[key].is_string()) {
+                timestamp = parseIsoTime(j[key].get<std::string>()).value_or(0);
+            }
+            break;
+        }
+    } else {
+        // host ident user [time] "METHOD path PROTO" status bytes ...
+        size_t time_open = line.find('[');
+        size_t time_close = line.find(']', time_open);
+        size_t request_open = line.find('"', time_close);
+        size_t request_close = line.find('"', request_open + 1);
+        if (time_open == std::string::npos || time_close == std::string::npos ||
+            request_open == std::string::npos || request_close == std::string::npos) {
+            return std::nullopt;
+        }
+        timestamp = parseClfTime(line.substr(time_open + 1, time_close - time_open - 1)).value_or(0);
+
+        std::istringstream request(line.substr(request_open + 1, request_close - request_open - 1));
+        request >> entry.method >> entry.path;
+    }
+
+    if (entry.method.empty() || entry.path.empty() || entry.path[0] != '/') {
+        return std::nullopt;
+    }
+    std::transform(entry.method.begin(), entry.method.end(), entry.method.begin(), ::toupper);
+    return std::make_pair(timestamp, entry);
+}
+
+std::vector<AccessLogEntry> AccessLog::load(const std::string& path, size_t& skipped) {
+    std::vector<std::pair<double, AccessLogEntry>> parsed;
+    std::ifstream file(path);
+    std::string line;
+    while (std::getline(file, line)) {
+        auto entry = parseLine(line);
+        if (!entry || !replayable(entry->second.method)) {
+            ++skipped;
+            continue;
+        }
+        parsed.push_back(std::move(*entry));
+    }
+
+    // Logs from several hosts interleave slightly out of order
+    std::stable_sort(parsed.begin(), parsed.end(), [](const auto& a, const auto& b) {
+        return a.first < b.first;
+    });
+
+    std::vector<AccessLogEntry> entries;
+    entries.reserve(parsed.size());
+    double first = parsed.empty() ? 0 : parsed.front().first;
+    for (auto& [timestamp, entry] : parsed) {
+        entry.offset_seconds = std::max(0.0, timestamp - first);
+        entries.push_back(std::move(entry));
+    }
+    return entries;
+}
+
+Operation AccessLog::classify(const std::string& method, const std::string& path) {
+    std::string route = path.substr(0, path.find('?'));
+    if (method == "POST" && route == "/api/images/upload") {
+        return Operation::UPLOAD;
+    }
+    if (route == "/api/images") {
+        return Operation::LIST;
+    }
+    if (route.rfind("/api/albums", 0) == 0) {
+        return Operation::ALBUM;
+    }
+    if (route.rfind("/api/images/", 0) == 0 && route != "/api/images/batch" && route != "/api/images/health") {
+        // Replays cannot tell hits from misses up front
+        return Operation::CACHED_GET;
+    }
+    return Operation::OTHER;
+}
+
+bool AccessLog::replayable(const std::string& method) {
+    return method == "GET" || method == "HEAD";
+}
+
+} // namespace loadgen
+} // namespace gara
@@ -0,0 +1,119 @@
+#ifndef GARA_LOADGEN_WORKLOAD_H
+#define GARA_LOADGEN_WORKLOAD_H
+
+#include <array>
+#include <atomic>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace gara {
+namespace loadgen {
+
+enum class Operation {
+    UPLOAD,      // POST /api/images/upload with a unique payload
+    CACHED_GET,  // GET /api/images/{id} for a small warm set of renditions
+    COLD_GET,    // GET /api/images/{id} with a width never requested before
+    LIST,        // GET /api/images page
+    ALBUM,       // GET /api/albums or /api/albums/{id}
+    OTHER        // Replayed requests that fit none of the above
+};
+
+constexpr size_t OPERATION_COUNT = 6;
+
+const char* operationName(Operation op);
+
+/**
+ * @brief Relative weights of each generated operation
+ *
+ * Parsed from "cached_get=70,cold_get=5,list=15,album=8,upload=2".
+ */
+struct TrafficMix {
+    std::array<double, OPERATION_COUNT> weights{};
+
+    static TrafficMix defaults();
+    static std::optional<TrafficMix> parse(const std::string& spec, std::string& error);
+
+    Operation pick(std::mt19937_64& rng) const;
+};
+
+// One HTTP request, ready to send
+struct PlannedRequest {
+    Operation op = Operation::OTHER;
+    std::string method = "GET";
+    std::string path;                  // Path and query, relative to the base URL
+    std::string body;
+    std::string content_type;
+    bool authenticated = false;        // Sends X-API-Key
+};
+
+// Ids discovered on the target server
+struct Corpus {
+    std::vector<std::string> image_ids;
+    std::vector<std::string> album_ids;
+    std::vector<char> upload_payload;  // Image file uploaded by UPLOAD (empty disables uploads)
+    std::string upload_filename = "loadgen.jpg";
+};
+
+/**
+ * @brief Turns a traffic mix into concrete requests against a corpus
+ *
+ * Thread-safe: each caller passes its own random engine. Operations
+ * without the data they need (no images, no upload payload) fall back to
+ * LIST so the configured rate is still met.
+ */
+class WorkloadGenerator {
+public:
+    WorkloadGenerator(const TrafficMix& mix, Corpus corpus, int warm_set_size = 32);
+
+    PlannedRequest next(std::mt19937_64& rng) const;
+    PlannedRequest build(Operation op, std::mt19937_64& rng) const;
+
+    // Multipart body for an upload; the trailer after the image makes each body hash differently
+    static std::string multipartBody(const std::vector<char>& payload, const std::string& filename,
+                                     const std::string& boundary, const std::string& trailer);
+
+private:
+    TrafficMix mix_;
+    Corpus corpus_;
+    int warm_set_size_;
+    mutable std::atomic<uint64_t> cold_counter_{0};
+};
+
+// One request from a production access log
+struct AccessLogEntry {
+    double offset_seconds = 0;  // Since the first entry
+    std::string method;
+    std::string path;
+};
+
+/**
+ * @brief Parser for access logs to replay
+ *
+ * Accepts Common/Combined Log Format lines (nginx, Apache, most ingress
+ * controllers) and JSON lines carrying "method" and "path" (or "url" or
+ * "endpoint"), with an optional numeric "timestamp" or "time" in seconds.
+ */
+class AccessLog {
+public:
+    // Absolute time of the entry in seconds, or nullopt when the line is not a request
+    static std::optional<std::pair<double, AccessLogEntry>> parseLine(const std::string& line);
+
+    /**
+     * @brief Load a log, keeping replayable requests and rebasing times on the first entry
+     * @param skipped Incremented for every line that was not replayable
+     */
+    static std::vector<AccessLogEntry> load(const std::string& path, size_t& skipped);
+
+    // Classify a replayed request for reporting
+    static Operation classify(const std::string& method, const std::string& path);
+
+    // Whether the request can be replayed without its original body
+    static bool replayable(const std::string& method);
+};
+
+} // namespace loadgen
+} // namespace gara
+
+#endif // GARA_LOADGEN_WORKLOAD_H
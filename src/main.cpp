@@ -7,11 +7,18 @@
 #include <filesystem>
 
 #include "services/local_file_service.h"
+#include "services/s3_file_service.h"
+#include "services/cached_file_service.h"
+#include "services/simulated_file_service.h"
 #include "services/image_processor.h"
 #include "services/cache_manager.h"
 #include "services/local_config_service.h"
 #include "services/watermark_service.h"
 #include "services/album_service.h"
+#include "services/raw_key_resolver.h"
+#include "services/otlp_exporter.h"
+#include "services/warmup_service.h"
+#include "services/peer_pool.h"
 #include "interfaces/database_client_interface.h"
 #include "db/sqlite_client.h"
 #ifdef GARA_MYSQL_SUPPORT
@@ -19,10 +26,26 @@
 #endif
 #include "controllers/image_controller.h"
 #include "controllers/album_controller.h"
+#include "controllers/file_controller.h"
 #include "models/watermark_config.h"
+#include "models/transform_config.h"
+#include "models/cache_config.h"
+#include "models/album_cache_config.h"
+#include "models/compression_config.h"
+#include "models/peer_config.h"
+#include "models/rate_limit_config.h"
+#include "models/storage_simulation_config.h"
+#include "models/tracing_config.h"
+#include "models/warmup_config.h"
+#include "middleware/auth_middleware.h"
 #include "middleware/request_context_middleware.h"
+#include "middleware/compression_middleware.h"
+#include "middleware/rate_limit_middleware.h"
+#include "utils/allocator_stats.h"
+#include "utils/container_limits.h"
 #include "utils/logger.h"
 #include "utils/metrics.h"
+#include "utils/prometheus_registry.h"
 
 int main() {
     // Get logging configuration from environment
@@ -39,18 +62,22 @@ int main() {
         ? gara::Logger::Format::TEXT
         : gara::Logger::Format::JSON;
 
-    gara::Logger::initialize("gara-image", log_level, log_format, environment);
+    gara::Logger::initialize("gara-image", log_level, log_format, environment,
+                             gara::LoggerOptions::fromEnvironment());
 
     // Initialize metrics
     const char* metrics_enabled_env = std::getenv("METRICS_ENABLED");
     const char* metrics_namespace_env = std::getenv("METRICS_NAMESPACE");
+    const char* metrics_flush_env = std::getenv("METRICS_FLUSH_INTERVAL_MS");
 
     bool metrics_enabled = metrics_enabled_env
         ? (std::string(metrics_enabled_env) == "true")
         : true;
     std::string metrics_namespace = metrics_namespace_env ? metrics_namespace_env : "GaraImage";
+    int metrics_flush_ms = metrics_flush_env ? std::max(1, std::atoi(metrics_flush_env)) : 10000;
 
-    gara::Metrics::initialize(metrics_namespace, "gara-image", environment, metrics_enabled);
+    gara::Metrics::initialize(metrics_namespace, "gara-image", environment, metrics_enabled,
+                              std::chrono::milliseconds(metrics_flush_ms));
 
     // Initialize libvips
     if (!gara::ImageProcessor::initialize()) {
@@ -63,18 +90,24 @@ int main() {
     const char* db_type_env = std::getenv("DATABASE_TYPE");
     const char* db_path_env = std::getenv("DATABASE_PATH");
     const char* api_key_env_var = std::getenv("API_KEY_ENV_VAR");
+    const char* public_base_url_env = std::getenv("PUBLIC_BASE_URL");
+    const char* storage_backend_env = std::getenv("STORAGE_BACKEND");
 
     std::string storage_path = storage_path_env ? storage_path_env : "./data/images";
     std::string db_type = db_type_env ? db_type_env : "sqlite";
     std::string db_path = db_path_env ? db_path_env : "./data/gara.db";
     std::string api_key_var = api_key_env_var ? api_key_env_var : "API_KEY";
+    std::string public_base_url = public_base_url_env ? public_base_url_env : "";
+    std::string storage_backend = storage_backend_env ? storage_backend_env : "local";
 
     LOG_INFO("Starting Gara Image Service (Local Mode)");
     gara::Logger::log_structured(spdlog::level::info, "Service configuration", {
+        {"storage_backend", storage_backend},
         {"storage_path", storage_path},
         {"database_type", db_type},
         {"database_path", db_path},
         {"api_key_env_var", api_key_var},
+        {"public_base_url", public_base_url},
         {"mode", "local"}
     });
 
@@ -100,7 +133,9 @@ int main() {
                 {"host", mysql_config.host},
                 {"port", mysql_config.port},
                 {"user", mysql_config.user},
-                {"database", mysql_config.database}
+                {"database", mysql_config.database},
+                {"pool_min", mysql_config.pool_min},
+                {"pool_max", mysql_config.pool_max}
             });
             auto mysql_client = std::make_shared<gara::MySQLClient>(mysql_config);
             if (!mysql_client->initialize()) {
@@ -115,7 +150,8 @@ int main() {
 #endif
         } else {
             // Default to SQLite
-            auto sqlite_client = std::make_shared<gara::SQLiteClient>(db_path);
+            auto sqlite_client = std::make_shared<gara::SQLiteClient>(
+                db_path, gara::SQLiteConfig::fromEnvironment());
             if (!sqlite_client->initialize()) {
                 LOG_CRITICAL("Failed to initialize SQLite database schema");
                 return 1;
@@ -128,11 +164,77 @@ int main() {
         return 1;
     }
 
+    // Size libvips' own thread pool so transform workers x vips threads ~= cores.
+    // Defaults follow the cgroup CPU quota and memory limit; environment settings win
+    auto transform_config = gara::TransformConfig::fromEnvironment();
+    vips_concurrency_set(transform_config.effectiveVipsConcurrency());
+    gara::ImageProcessor::configureCache(transform_config.governor);
+
+    const auto& container_limits = gara::utils::ContainerLimits::current();
+    gara::Logger::log_structured(spdlog::level::info, "Resource limits", {
+        {"source", container_limits.source},
+        {"host_cpus", container_limits.host_cpus},
+        {"cpu_quota", container_limits.cpu_quota},
+        {"cpus", container_limits.cpus()},
+        {"memory_limit_bytes", container_limits.memory_limit_bytes},
+        {"transform_workers", transform_config.worker_threads},
+        {"vips_concurrency", transform_config.effectiveVipsConcurrency()},
+        {"vips_cache_max_mem_mb", transform_config.governor.vips_cache_max_mem_mb},
+        {"transform_memory_budget_bytes", transform_config.governor.memory_budget_bytes}
+    });
+
     // Initialize services
-    auto file_service = std::make_shared<gara::LocalFileService>(storage_path);
+    std::shared_ptr<gara::LocalFileService> local_file_service;
+    std::shared_ptr<gara::FileServiceInterface> file_service;
+    // STORAGE_SIM_ENABLED puts S3-like latency, bandwidth and errors in front of the backend,
+    // beneath the caches, for capacity testing
+    auto storage_sim_config = gara::StorageSimulationConfig::fromEnvironment();
+    auto simulate = [&storage_sim_config](std::shared_ptr<gara::FileServiceInterface> backend)
+        -> std::shared_ptr<gara::FileServiceInterface> {
+        if (!storage_sim_config.isEnabled()) {
+            return backend;
+        }
+        gara::Logger::log_structured(spdlog::level::warn, "Storage simulation enabled", {
+            {"get_median_ms", storage_sim_config.get.median_ms},
+            {"put_median_ms", storage_sim_config.put.median_ms},
+            {"bandwidth_bytes_per_sec", storage_sim_config.bandwidth_bytes_per_sec},
+            {"get_error_rate", storage_sim_config.get.error_rate}
+        });
+        return std::make_shared<gara::SimulatedFileService>(std::move(backend), storage_sim_config);
+    };
+    if (storage_backend == "s3") {
+        try {
+            file_service = simulate(std::make_shared<gara::S3FileService>(gara::S3Config::fromEnvironment()));
+        } catch (const std::exception& e) {
+            LOG_CRITICAL("Failed to initialize S3 storage: " + std::string(e.what()));
+            return 1;
+        }
+
+        // Keep recently used originals on local disk so multi-size bursts download them once
+        auto raw_cache_config = gara::RawCacheConfig::fromEnvironment();
+        if (raw_cache_config.isEnabled()) {
+            try {
+                file_service = std::make_shared<gara::CachedFileService>(file_service, raw_cache_config);
+                LOG_INFO("Raw disk cache enabled at " + raw_cache_config.directory);
+            } catch (const std::exception& e) {
+                LOG_WARN("Raw disk cache disabled: " + std::string(e.what()));
+            }
+        }
+    } else {
+        local_file_service = std::make_shared<gara::LocalFileService>(storage_path, public_base_url);
+        file_service = simulate(local_file_service);
+    }
     auto image_processor = std::make_shared<gara::ImageProcessor>();
-    auto cache_manager = std::make_shared<gara::CacheManager>(file_service);
-    auto config_service = std::make_shared<gara::LocalConfigService>(api_key_var);
+    auto cache_config = gara::CacheConfig::fromEnvironment();
+    // The /files route serves write-behind renditions from memory until their upload lands
+    cache_config.pending_urls_served = local_file_service != nullptr;
+    auto cache_manager = std::make_shared<gara::CacheManager>(file_service, cache_config, db_client);
+    // API_KEYS_FILE holds extra accepted keys (one per line) and is watched, for rotation without restarts
+    const char* api_keys_file_env = std::getenv("API_KEYS_FILE");
+    const char* api_key_refresh_env = std::getenv("API_KEY_REFRESH_SECONDS");
+    auto config_service = std::make_shared<gara::LocalConfigService>(
+        api_key_var, api_keys_file_env ? api_keys_file_env : "",
+        api_key_refresh_env ? std::atoi(api_key_refresh_env) : 30);
 
     // Initialize watermark service
     auto watermark_config = gara::WatermarkConfig::fromEnvironment();
@@ -152,16 +254,93 @@ int main() {
     }
 
     // Initialize album service
-    auto album_service = std::make_shared<gara::AlbumService>(db_client, file_service);
+    auto raw_key_resolver = std::make_shared<gara::RawKeyResolver>(db_client, file_service);
+    auto album_cache_config = gara::AlbumCacheConfig::fromEnvironment();
+    std::shared_ptr<gara::AlbumCache> album_cache;
+    if (album_cache_config.isEnabled()) {
+        album_cache = std::make_shared<gara::AlbumCache>(album_cache_config);
+    }
+    gara::Logger::log_structured(spdlog::level::info, "Album cache configuration", {
+        {"enabled", album_cache_config.isEnabled()},
+        {"max_bytes", album_cache_config.max_bytes},
+        {"ttl_seconds", album_cache_config.ttl_seconds}
+    });
+    auto album_service = std::make_shared<gara::AlbumService>(db_client, file_service, raw_key_resolver,
+                                                              album_cache);
+
+    // Preload caches from the last hot-set snapshot; /ready waits for it
+    auto warmup_config = gara::WarmupConfig::fromEnvironment();
+    auto warmup_service = std::make_shared<gara::WarmupService>(warmup_config, cache_manager, raw_key_resolver,
+                                                                album_service, album_cache);
+    gara::Logger::log_structured(spdlog::level::info, "Warm-up configuration", {
+        {"enabled", warmup_config.isEnabled()},
+        {"snapshot_path", warmup_config.snapshot_path},
+        {"snapshot_interval_seconds", warmup_config.snapshot_interval_seconds}
+    });
+
+    // Cluster-wide rendition ownership; needs storage shared by every node (S3)
+    auto peer_config = gara::PeerConfig::fromEnvironment();
+    std::shared_ptr<gara::PeerPool> peer_pool;
+    if (peer_config.isEnabled()) {
+        peer_pool = std::make_shared<gara::PeerPool>(peer_config);
+    }
+    gara::Logger::log_structured(spdlog::level::info, "Peer cache configuration", {
+        {"enabled", peer_config.isEnabled()},
+        {"self_url", peer_config.self_url},
+        {"dns_name", peer_config.dns_name},
+        {"members", peer_pool ? peer_pool->members().size() : 0}
+    });
 
     // Initialize controllers
-    gara::ImageController image_controller(file_service, image_processor, cache_manager, config_service, watermark_service, db_client);
-    gara::AlbumController album_controller(album_service, file_service, config_service);
+    gara::ImageController image_controller(file_service, image_processor, cache_manager, config_service,
+                                           watermark_service, db_client, raw_key_resolver, transform_config,
+                                           peer_pool);
+    gara::AlbumController album_controller(album_service, file_service, config_service, raw_key_resolver,
+                                           cache_manager, transform_config);
+    // Presigned S3 URLs are fetched from the bucket directly, so /files is local-only
+    std::unique_ptr<gara::FileController> file_controller;
+    if (local_file_service) {
+        file_controller = std::make_unique<gara::FileController>(local_file_service, cache_manager);
+    }
 
     // Startup App with middleware
-    using App = crow::App<gara::RequestContextMiddleware>;
+    using App = crow::App<gara::RequestContextMiddleware, gara::RateLimitMiddleware, gara::CompressionMiddleware>;
     App app;
 
+    // Per-stage request spans: Server-Timing on responses, OTLP export when a collector is set
+    auto tracing_config = gara::TracingConfig::fromEnvironment();
+    std::shared_ptr<gara::OtlpExporter> trace_exporter;
+    if (tracing_config.exportEnabled()) {
+        trace_exporter = std::make_shared<gara::OtlpExporter>(tracing_config);
+        gara::Logger::log_structured(spdlog::level::info, "OTLP trace export enabled", {
+            {"endpoint", trace_exporter->url()},
+            {"service_name", tracing_config.service_name},
+            {"sample_ratio", tracing_config.sample_ratio}
+        });
+    }
+    app.get_middleware<gara::RequestContextMiddleware>().configure(tracing_config, trace_exporter);
+
+    // Per-client token buckets; cache misses cost more and are capped per client
+    auto rate_limit_config = gara::RateLimitConfig::fromEnvironment();
+    app.get_middleware<gara::RateLimitMiddleware>().configure(rate_limit_config);
+    gara::Logger::log_structured(spdlog::level::info, "Rate limit configuration", {
+        {"enabled", rate_limit_config.enabled},
+        {"requests_per_second", rate_limit_config.requests_per_second},
+        {"burst", rate_limit_config.burst},
+        {"miss_cost", rate_limit_config.miss_cost},
+        {"max_concurrent_transforms", rate_limit_config.max_concurrent_transforms}
+    });
+
+    // gzip/br/zstd for JSON bodies, negotiated per request
+    auto compression_config = gara::CompressionConfig::fromEnvironment();
+    app.get_middleware<gara::CompressionMiddleware>().configure(compression_config);
+    gara::Logger::log_structured(spdlog::level::info, "Response compression configuration", {
+        {"enabled", compression_config.enabled},
+        {"min_bytes", compression_config.min_bytes},
+        {"brotli", gara::utils::ResponseCompressor::isSupported(gara::utils::ContentEncoding::BROTLI)},
+        {"zstd", gara::utils::ResponseCompressor::isSupported(gara::utils::ContentEncoding::ZSTD)}
+    });
+
     // Basic routes
     CROW_ROUTE(app, "/")([](){
         return "Gara Image Service - Local image storage and transformation";
@@ -189,6 +368,56 @@ int main() {
         return resp;
     });
 
+    // Readiness: 503 until warm-up has filled the caches, while /health stays 200
+    CROW_ROUTE(app, "/ready")([warmup_service]() {
+        bool ready = warmup_service->ready();
+        nlohmann::json ready_status = {
+            {"status", ready ? "ready" : "warming"},
+            {"timestamp", gara::Logger::get_timestamp()}
+        };
+        crow::response resp(ready ? 200 : 503, ready_status.dump());
+        resp.add_header("Content-Type", "application/json");
+        return resp;
+    });
+
+    // Prometheus scrape endpoint
+    CROW_ROUTE(app, "/metrics")([]() {
+        gara::ImageProcessor::publishMemoryStats();
+        crow::response resp(200, gara::PrometheusRegistry::instance().render());
+        resp.add_header("Content-Type", "text/plain; version=0.0.4");
+        return resp;
+    });
+
+    // Allocator and libvips memory for tuning limits; needs an API key
+    CROW_ROUTE(app, "/debug/memory")([config_service](const crow::request& req) {
+        if (!gara::middleware::AuthMiddleware::validateApiKey(req, *config_service)) {
+            return gara::middleware::AuthMiddleware::unauthorizedResponse("Invalid or missing API key");
+        }
+
+        nlohmann::json allocator_stats = nlohmann::json::object();
+        for (const auto& [name, value] : gara::utils::AllocatorStats::sample()) {
+            allocator_stats[name] = value;
+        }
+        gara::VipsMemoryStats vips_stats = gara::ImageProcessor::memoryStats();
+        nlohmann::json memory = {
+            {"allocator", gara::utils::AllocatorStats::allocatorName()},
+            {"allocator_stats", allocator_stats},
+            {"allocation_counters", gara::utils::AllocatorStats::threadCountersEnabled()},
+            {"resident_bytes", gara::utils::AllocatorStats::residentBytes()},
+            {"vips", {
+                {"tracked_bytes", vips_stats.tracked_bytes},
+                {"highwater_bytes", vips_stats.highwater_bytes},
+                {"allocations", vips_stats.allocations},
+                {"open_files", vips_stats.open_files},
+                {"cache_operations", vips_stats.cache_operations}
+            }},
+            {"timestamp", gara::Logger::get_timestamp()}
+        };
+        crow::response resp(200, memory.dump());
+        resp.add_header("Content-Type", "application/json");
+        return resp;
+    });
+
     // OpenAPI documentation endpoints
     CROW_ROUTE(app, "/api/openapi.yaml")([]() {
         std::ifstream file("openapi.yaml");
@@ -224,6 +453,11 @@ int main() {
     // Register album routes
     album_controller.registerRoutes(app);
 
+    // Serve stored objects for the URLs LocalFileService hands out
+    if (file_controller) {
+        file_controller->registerRoutes(app);
+    }
+
     // Get port from environment
     char* port_env = std::getenv("PORT");
     int port = 8080;
@@ -239,22 +473,44 @@ int main() {
         }
     }
 
+    // HTTP threads block while their transform runs on the pool, so keep enough
+    // of them that a full pool and queue cannot starve health checks or cache hits
+    unsigned int server_threads = static_cast<unsigned int>(
+        gara::TransformConfig::hardwareThreads() + transform_config.worker_threads + transform_config.queue_size);
+    const char* server_threads_env = std::getenv("SERVER_THREADS");
+    if (server_threads_env && std::atoi(server_threads_env) > 0) {
+        server_threads = static_cast<unsigned int>(std::atoi(server_threads_env));
+    }
+
     gara::Logger::log_structured(spdlog::level::info, "Starting server", {
         {"port", port},
+        {"server_threads", server_threads},
+        {"transform_workers", transform_config.worker_threads},
+        {"transform_queue_size", transform_config.queue_size},
+        {"vips_concurrency", transform_config.effectiveVipsConcurrency()},
         {"log_level", log_level},
         {"log_format", log_format_str},
         {"metrics_enabled", metrics_enabled},
         {"mode", "local"}
     });
 
+    warmup_service->start();
+
     // Run app
     app
     .port(port)
     .loglevel(crow::LogLevel::Warning)
-    .multithreaded().run();
+    .concurrency(server_threads)
+    .run();
 
     // Cleanup
+    warmup_service.reset();
+    if (trace_exporter) {
+        trace_exporter->shutdown();
+    }
     gara::ImageProcessor::shutdown();
+    gara::Metrics::shutdown();
+    gara::Logger::shutdown();
 
     return 0;
 }
@@ -9,22 +9,67 @@ using json = nlohmann::json;
 namespace gara {
 namespace middleware {
 
+namespace {
+
+CounterMetric auth_success("AuthAttempts", {{"status", "success"}});
+CounterMetric auth_unconfigured("AuthAttempts", {{"status", "unconfigured"}});
+CounterMetric auth_missing_key("AuthAttempts", {{"status", "missing_key"}});
+CounterMetric auth_invalid_key("AuthAttempts", {{"status", "invalid_key"}});
+
+void recordMissingKey(const crow::request& req) {
+    gara::Logger::log_structured(spdlog::level::warn, "Authentication failed: missing API key", {
+        {"reason", "missing_key"},
+        {"endpoint", std::string(req.url)}
+    });
+    auth_missing_key.add();
+}
+
+void recordInvalidKey(const crow::request& req) {
+    // Security: Log failed auth without revealing the actual key
+    gara::Logger::log_structured(spdlog::level::warn, "Authentication failed: invalid API key", {
+        {"reason", "invalid_key"},
+        {"endpoint", std::string(req.url)}
+    });
+    auth_invalid_key.add();
+}
+
+} // anonymous namespace
+
+bool AuthMiddleware::validateApiKey(const crow::request& req, ConfigServiceInterface& config_service) {
+    if (!config_service.isInitialized()) {
+        LOG_WARN("Authentication attempted but API key not configured");
+        auth_unconfigured.add();
+        return false;
+    }
+
+    // Crow's header map is case-insensitive
+    const std::string& provided_key = req.get_header_value("X-API-Key");
+    if (provided_key.empty()) {
+        recordMissingKey(req);
+        return false;
+    }
+
+    if (!config_service.validateApiKey(provided_key)) {
+        recordInvalidKey(req);
+        return false;
+    }
+
+    auth_success.add();
+    return true;
+}
+
 bool AuthMiddleware::validateApiKey(const crow::request& req, const std::string& expected_key) {
     // If expected key is empty, authentication is not configured
     if (expected_key.empty()) {
         LOG_WARN("Authentication attempted but API key not configured");
-        METRICS_COUNT("AuthAttempts", 1.0, "Count", {{"status", "unconfigured"}});
+        auth_unconfigured.add();
         return false;
     }
 
     std::string provided_key = extractApiKey(req);
 
     if (provided_key.empty()) {
-        gara::Logger::log_structured(spdlog::level::warn, "Authentication failed: missing API key", {
-            {"reason", "missing_key"},
-            {"endpoint", std::string(req.url)}
-        });
-        METRICS_COUNT("AuthAttempts", 1.0, "Count", {{"status", "missing_key"}});
+        recordMissingKey(req);
         return false;
     }
 
@@ -32,15 +77,10 @@ bool AuthMiddleware::validateApiKey(const crow::request& req, const std::string&
     bool valid = constantTimeCompare(provided_key, expected_key);
 
     if (!valid) {
-        // Security: Log failed auth without revealing the actual key
-        gara::Logger::log_structured(spdlog::level::warn, "Authentication failed: invalid API key", {
-            {"reason", "invalid_key"},
-            {"endpoint", std::string(req.url)}
-        });
-        METRICS_COUNT("AuthAttempts", 1.0, "Count", {{"status", "invalid_key"}});
+        recordInvalidKey(req);
     } else {
         // Track successful authentication
-        METRICS_COUNT("AuthAttempts", 1.0, "Count", {{"status", "success"}});
+        auth_success.add();
     }
 
     return valid;
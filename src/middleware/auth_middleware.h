@@ -3,6 +3,7 @@
 
 #include <string>
 #include <crow.h>
+#include "../interfaces/config_service_interface.h"
 
 namespace gara {
 namespace middleware {
@@ -20,6 +21,15 @@ public:
      */
     static bool validateApiKey(const crow::request& req, const std::string& expected_key);
 
+    /**
+     * Validate API key from request headers against every active key
+     * Takes no locks and allocates nothing when the key is accepted
+     * @param req Crow HTTP request
+     * @param config_service Source of the accepted keys
+     * @return true if authentication succeeds, false otherwise
+     */
+    static bool validateApiKey(const crow::request& req, ConfigServiceInterface& config_service);
+
     /**
      * Extract X-API-Key header from request
      * @param req Crow HTTP request
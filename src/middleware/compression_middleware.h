@@ -0,0 +1,115 @@
+#pragma once
+
+#include <crow.h>
+#include <memory>
+#include <string>
+#include "models/compression_config.h"
+#include "utils/lru_cache.h"
+#include "utils/metrics.h"
+#include "utils/response_compression.h"
+#include "utils/trace.h"
+
+namespace gara {
+
+/**
+ * Compression middleware for JSON API responses
+ * Encodes application/json bodies of at least COMPRESSION_MIN_BYTES with the
+ * coding negotiated from Accept-Encoding. Image responses are already
+ * compressed and pass through untouched, as do responses a handler encoded
+ * itself.
+ *
+ * A response with a strong ETag names its bytes, so the encoded body is
+ * cached under (coding, ETag) and a repeat of a cached listing skips the
+ * encoder. The ETag turns weak once encoded, as the coded bytes differ.
+ */
+struct CompressionMiddleware {
+    struct context {
+        std::string accept_encoding;
+    };
+
+    // Call before the app starts
+    void configure(const CompressionConfig& config) {
+        compressor_ = std::make_shared<utils::ResponseCompressor>(config);
+        cache_ = std::make_shared<utils::ShardedLruCache<std::shared_ptr<const std::string>>>(
+            config.cache_max_bytes, std::chrono::seconds(0));
+    }
+
+    void before_handle(crow::request& req, crow::response& res, context& ctx) {
+        ctx.accept_encoding = req.get_header_value("Accept-Encoding");
+    }
+
+    void after_handle(crow::request& req, crow::response& res, context& ctx) {
+        if (!compressor_ || !compressor_->config().enabled ||
+            res.body.size() < compressor_->config().min_bytes ||
+            res.code < 200 || res.code == 204 || res.code == 206 ||
+            !res.get_header_value("Content-Encoding").empty() ||
+            res.get_header_value("Content-Type").rfind("application/json", 0) != 0) {
+            return;
+        }
+
+        // Caches must key this response on the coding whichever one is chosen
+        res.add_header("Vary", "Accept-Encoding");
+
+        utils::ContentEncoding encoding = compressor_->negotiate(ctx.accept_encoding);
+        if (encoding == utils::ContentEncoding::IDENTITY) {
+            return;
+        }
+
+        std::string etag = res.get_header_value("ETag");
+        bool cacheable = !etag.empty() && etag.rfind("W/", 0) != 0;
+        std::string cache_key = cacheable
+            ? std::string(utils::ResponseCompressor::token(encoding)) + " " + etag : std::string();
+
+        std::shared_ptr<const std::string> encoded;
+        if (cacheable) {
+            if (auto cached = cache_->get(cache_key)) {
+                encoded = *cached;
+                compressionCounter(encoding, CACHE_HIT).add();
+            }
+        }
+        if (!encoded) {
+            TRACE_SPAN("compress");
+            auto compressed = compressor_->compress(res.body, encoding);
+            if (!compressed) {
+                compressionCounter(encoding, SKIPPED).add();
+                return;
+            }
+            encoded = std::make_shared<const std::string>(std::move(*compressed));
+            compressionCounter(encoding, COMPRESSED).add();
+            if (cacheable) {
+                cache_->put(cache_key, encoded, encoded->size() + cache_key.size());
+            }
+        }
+
+        res.body = *encoded;
+        res.set_header("Content-Encoding", utils::ResponseCompressor::token(encoding));
+        if (cacheable) {
+            res.set_header("ETag", "W/" + etag);
+        }
+    }
+
+private:
+    enum Outcome { COMPRESSED, CACHE_HIT, SKIPPED };
+
+    static CounterMetric& compressionCounter(utils::ContentEncoding encoding, Outcome outcome) {
+        static CounterMetric counters[3][3] = {
+            {{"ResponseCompression", {{"encoding", "gzip"}, {"result", "compressed"}}},
+             {"ResponseCompression", {{"encoding", "gzip"}, {"result", "cache_hit"}}},
+             {"ResponseCompression", {{"encoding", "gzip"}, {"result", "skipped"}}}},
+            {{"ResponseCompression", {{"encoding", "br"}, {"result", "compressed"}}},
+             {"ResponseCompression", {{"encoding", "br"}, {"result", "cache_hit"}}},
+             {"ResponseCompression", {{"encoding", "br"}, {"result", "skipped"}}}},
+            {{"ResponseCompression", {{"encoding", "zstd"}, {"result", "compressed"}}},
+             {"ResponseCompression", {{"encoding", "zstd"}, {"result", "cache_hit"}}},
+             {"ResponseCompression", {{"encoding", "zstd"}, {"result", "skipped"}}}},
+        };
+        size_t row = encoding == utils::ContentEncoding::BROTLI ? 1
+                   : encoding == utils::ContentEncoding::ZSTD ? 2 : 0;
+        return counters[row][outcome];
+    }
+
+    std::shared_ptr<utils::ResponseCompressor> compressor_;
+    std::shared_ptr<utils::ShardedLruCache<std::shared_ptr<const std::string>>> cache_;
+};
+
+} // namespace gara
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <crow.h>
+#include <memory>
+#include <optional>
+#include <string>
+#include <nlohmann/json.hpp>
+#include "middleware/auth_middleware.h"
+#include "models/rate_limit_config.h"
+#include "utils/metrics.h"
+#include "utils/rate_limiter.h"
+
+namespace gara {
+
+/**
+ * Rate limit middleware for per-client fairness
+ * Charges each request one token from its API key and IP buckets and answers
+ * 429 with Retry-After when either is empty. Admitted requests make their
+ * client current for the handler's thread, so a rendition cache miss can be
+ * charged its heavier cost and held to the client's transform cap (see
+ * utils::RateLimiter::admitTransform). Probes, metrics scrapes and peer
+ * requests are exempt.
+ */
+struct RateLimitMiddleware {
+    struct context {
+        std::optional<utils::RateLimiter::Scope> scope;
+    };
+
+    // Call before the app starts
+    void configure(const RateLimitConfig& config) {
+        limiter_ = config.isEnabled() ? std::make_shared<utils::RateLimiter>(config) : nullptr;
+    }
+
+    void before_handle(crow::request& req, crow::response& res, context& ctx) {
+        // Peer requests were already charged by the node the client reached
+        if (!limiter_ || req.url == "/health" || req.url == "/ready" || req.url == "/metrics" ||
+            req.url.rfind("/internal/peer/", 0) == 0) {
+            return;
+        }
+
+        auto client = utils::RateLimiter::client(middleware::AuthMiddleware::extractApiKey(req), clientIp(req));
+        auto decision = limiter_->admit(client, 1);
+        if (!decision.allowed) {
+            static CounterMetric limited("RateLimited", {{"reason", "requests"}});
+            limited.add();
+            nlohmann::json body = {{"error", "Rate limit exceeded. Please retry later"}};
+            res.code = 429;
+            res.body = body.dump();
+            res.add_header("Content-Type", "application/json");
+            res.add_header("Retry-After", std::to_string(decision.retry_after_seconds));
+            res.end();
+            return;
+        }
+        ctx.scope.emplace(limiter_.get(), client);
+    }
+
+    void after_handle(crow::request& req, crow::response& res, context& ctx) {
+        ctx.scope.reset();
+    }
+
+private:
+    std::string clientIp(const crow::request& req) const {
+        if (limiter_->config().trust_forwarded_for) {
+            std::string forwarded = req.get_header_value("X-Forwarded-For");
+            size_t comma = forwarded.find(',');
+            std::string first = forwarded.substr(0, comma);
+            size_t begin = first.find_first_not_of(' ');
+            if (begin != std::string::npos) {
+                return first.substr(begin, first.find_last_not_of(' ') - begin + 1);
+            }
+        }
+        return req.remote_ip_address;
+    }
+
+    std::shared_ptr<utils::RateLimiter> limiter_;
+};
+
+} // namespace gara
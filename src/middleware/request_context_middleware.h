@@ -1,29 +1,47 @@
 #pragma once
 
 #include <crow.h>
+#include <memory>
 #include <string>
+#include "models/tracing_config.h"
+#include "services/otlp_exporter.h"
+#include "utils/allocator_stats.h"
 #include "utils/id_generator.h"
+#include "utils/metrics.h"
+#include "utils/prometheus_registry.h"
+#include "utils/trace.h"
 
 namespace gara {
 
 /**
  * Request context middleware for correlation tracking
- * Adds a unique request ID to each incoming request for distributed tracing
+ * Adds a unique request ID to each incoming request for distributed tracing,
+ * and installs the request's span trace for the handler's thread. Stage
+ * timings go out as a Server-Timing header and, when an exporter is
+ * configured, as OTLP spans.
  */
 struct RequestContextMiddleware {
     struct context {
         std::string request_id;
         std::string endpoint;
         std::chrono::steady_clock::time_point start_time;
+        std::shared_ptr<utils::RequestTrace> trace;  // Null when tracing is disabled
+        uint64_t allocated_at_start = 0;             // Thread's allocation total on arrival
     };
 
+    // Call before the app starts; exporter may be null
+    void configure(const TracingConfig& config, std::shared_ptr<OtlpExporter> exporter) {
+        tracing_ = config;
+        exporter_ = std::move(exporter);
+    }
+
     void before_handle(crow::request& req, crow::response& res, context& ctx) {
         // Generate unique request ID (or use existing from X-Request-ID header)
         auto header_id = req.get_header_value("X-Request-ID");
         if (!header_id.empty()) {
             ctx.request_id = header_id;
         } else {
-            ctx.request_id = utils::IdGenerator::generateAlbumId();
+            ctx.request_id = utils::IdGenerator::generateRequestId();
         }
 
         // Store endpoint path
@@ -31,21 +49,54 @@ struct RequestContextMiddleware {
 
         // Record start time for request duration tracking
         ctx.start_time = std::chrono::steady_clock::now();
+        ctx.allocated_at_start = utils::AllocatorStats::threadAllocatedBytes();
 
         // Add request ID to response headers for client correlation
         res.add_header("X-Request-ID", ctx.request_id);
+
+        if (tracing_.isEnabled()) {
+            // The sample ratio only decides export; Server-Timing covers every request
+            ctx.trace = std::make_shared<utils::RequestTrace>(
+                req.get_header_value("traceparent"), ctx.request_id,
+                exporter_ ? tracing_.sample_ratio : 0.0);
+            utils::RequestTrace::setCurrent(ctx.trace);
+        }
     }
 
     void after_handle(crow::request& req, crow::response& res, context& ctx) {
         // Calculate request duration
         auto end_time = std::chrono::steady_clock::now();
-        auto duration_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-            end_time - ctx.start_time
-        ).count();
+        double duration_seconds = std::chrono::duration<double>(end_time - ctx.start_time).count();
 
-        // This can be used to log request completion metrics
-        // Will be integrated with logging/metrics in controllers
-        (void)duration_ms; // Unused for now, but available for metrics
+        PrometheusRegistry::instance().histogram(
+            "gara_http_request_duration_seconds", "HTTP request latency by route",
+            PrometheusRegistry::defaultLatencyBuckets(), {
+                {"method", crow::method_name(req.method)},
+                {"route", PrometheusRegistry::routeLabel(req.url)},
+                {"status", std::to_string(res.code / 100) + "xx"}
+            }).observe(duration_seconds);
+
+        if (utils::AllocatorStats::threadCountersEnabled()) {
+            // Handler thread only; transforms on the worker pool report TransformAllocatedBytes
+            uint64_t allocated = utils::AllocatorStats::threadAllocatedBytes() - ctx.allocated_at_start;
+            METRICS_COUNT("RequestAllocatedBytes", static_cast<double>(allocated), "Bytes",
+                          {{"route", PrometheusRegistry::routeLabel(req.url)}});
+        }
+
+        if (ctx.trace) {
+            ctx.trace->finish(crow::method_name(req.method), PrometheusRegistry::routeLabel(req.url), res.code);
+            if (tracing_.server_timing) {
+                res.add_header("Server-Timing", ctx.trace->serverTiming());
+                res.add_header("Timing-Allow-Origin", "*");
+            }
+            if (exporter_) {
+                res.add_header("traceresponse", ctx.trace->traceparent());
+                if (ctx.trace->sampled()) {
+                    exporter_->enqueue(ctx.trace);
+                }
+            }
+            utils::RequestTrace::setCurrent(nullptr);
+        }
     }
 
     // Helper to get request ID from context
@@ -65,6 +116,10 @@ struct RequestContextMiddleware {
             now - ctx.start_time
         ).count();
     }
+
+private:
+    TracingConfig tracing_;
+    std::shared_ptr<OtlpExporter> exporter_;
 };
 
 } // namespace gara
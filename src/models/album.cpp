@@ -28,6 +28,21 @@ nlohmann::json Album::toJson() const {
     return j;
 }
 
+void Album::writeJson(utils::JsonWriter& writer) const {
+    // Keys in nlohmann's (sorted) order so both paths produce identical bytes
+    writer.beginObject();
+    writer.field("album_id", album_id);
+    writer.field("cover_image_id", cover_image_id);
+    writer.field("created_at", static_cast<int64_t>(created_at));
+    writer.field("description", description);
+    writer.field("image_ids", image_ids);
+    writer.field("name", name);
+    writer.field("published", published);
+    writer.field("tags", tags);
+    writer.field("updated_at", static_cast<int64_t>(updated_at));
+    writer.endObject();
+}
+
 Album Album::fromJson(const nlohmann::json& j) {
     Album album;
 
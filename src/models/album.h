@@ -5,6 +5,7 @@
 #include <vector>
 #include <ctime>
 #include <nlohmann/json.hpp>
+#include "../utils/json_writer.h"
 
 namespace gara {
 
@@ -26,6 +27,9 @@ struct Album {
     // Convert to/from JSON
     nlohmann::json toJson() const;
     static Album fromJson(const nlohmann::json& j);
+
+    // Write the same object as toJson() straight into a response body
+    void writeJson(utils::JsonWriter& writer) const;
 };
 
 struct CreateAlbumRequest {
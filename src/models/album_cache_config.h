@@ -0,0 +1,41 @@
+#ifndef GARA_ALBUM_CACHE_CONFIG_H
+#define GARA_ALBUM_CACHE_CONFIG_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+
+namespace gara {
+
+struct AlbumCacheConfig {
+    size_t max_bytes;   // Budget for cached albums and listings (0 disables the cache)
+    int ttl_seconds;    // Upper bound on staleness for writes made by other instances
+
+    // Default constructor with sensible defaults
+    AlbumCacheConfig()
+        : max_bytes(16 * 1024 * 1024),
+          ttl_seconds(30) {}
+
+    bool isEnabled() const { return max_bytes > 0 && ttl_seconds > 0; }
+
+    // Factory method to create config from environment variables
+    static AlbumCacheConfig fromEnvironment() {
+        AlbumCacheConfig config;
+
+        const char* max_bytes_env = std::getenv("ALBUM_CACHE_MAX_BYTES");
+        if (max_bytes_env) {
+            config.max_bytes = std::strtoull(max_bytes_env, nullptr, 10);
+        }
+
+        const char* ttl_env = std::getenv("ALBUM_CACHE_TTL_SECONDS");
+        if (ttl_env) {
+            config.ttl_seconds = std::max(0, std::atoi(ttl_env));
+        }
+
+        return config;
+    }
+};
+
+} // namespace gara
+
+#endif // GARA_ALBUM_CACHE_CONFIG_H
@@ -0,0 +1,122 @@
+#ifndef GARA_CACHE_CONFIG_H
+#define GARA_CACHE_CONFIG_H
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace gara {
+
+struct CacheConfig {
+    size_t memory_max_bytes;          // In-process LRU budget (0 disables it)
+    int memory_ttl_seconds;           // How long a known-present key is trusted
+    size_t memory_max_entry_bytes;    // Encoded renditions up to this size are kept in memory
+    int memory_shards;                // Number of lock stripes
+
+    bool write_behind;                // Return renditions before their upload finishes
+    size_t write_behind_max_pending;  // Queued uploads before stores turn synchronous again
+    size_t write_behind_max_bytes;    // Budget for bytes held by queued uploads
+    int write_behind_workers;         // Background upload threads
+    int write_behind_max_attempts;    // Upload attempts before a rendition is dropped
+    int write_behind_url_wait_ms;     // How long a URL request waits for a pending upload
+    bool pending_urls_served;         // Storage URLs are served by this process (local /files)
+
+    uint64_t storage_max_bytes;       // Budget for transformed renditions in storage (0 = unbounded)
+    std::string eviction_policy;      // "lru" or "lfu"
+    int eviction_interval_seconds;    // Evictor and access-flush period (0 disables the thread)
+
+    // Default constructor with sensible defaults
+    CacheConfig()
+        : memory_max_bytes(64 * 1024 * 1024),
+          memory_ttl_seconds(300),
+          memory_max_entry_bytes(64 * 1024),
+          memory_shards(16),
+          write_behind(false),
+          write_behind_max_pending(256),
+          write_behind_max_bytes(256 * 1024 * 1024),
+          write_behind_workers(2),
+          write_behind_max_attempts(3),
+          write_behind_url_wait_ms(2000),
+          pending_urls_served(false),
+          storage_max_bytes(0),
+          eviction_policy("lru"),
+          eviction_interval_seconds(60) {}
+
+    // Factory method to create config from environment variables
+    static CacheConfig fromEnvironment() {
+        CacheConfig config;
+
+        const char* max_bytes_env = std::getenv("CACHE_MEMORY_MAX_BYTES");
+        if (max_bytes_env) {
+            config.memory_max_bytes = std::strtoull(max_bytes_env, nullptr, 10);
+        }
+
+        const char* ttl_env = std::getenv("CACHE_MEMORY_TTL_SECONDS");
+        if (ttl_env) {
+            config.memory_ttl_seconds = std::atoi(ttl_env);
+        }
+
+        const char* entry_bytes_env = std::getenv("CACHE_MEMORY_MAX_ENTRY_BYTES");
+        if (entry_bytes_env) {
+            config.memory_max_entry_bytes = std::strtoull(entry_bytes_env, nullptr, 10);
+        }
+
+        const char* shards_env = std::getenv("CACHE_MEMORY_SHARDS");
+        if (shards_env) {
+            config.memory_shards = std::atoi(shards_env);
+        }
+
+        const char* write_behind_env = std::getenv("CACHE_WRITE_BEHIND");
+        if (write_behind_env) {
+            config.write_behind = std::string(write_behind_env) == "true";
+        }
+
+        const char* pending_env = std::getenv("CACHE_WRITE_BEHIND_MAX_PENDING");
+        if (pending_env) {
+            config.write_behind_max_pending = std::strtoull(pending_env, nullptr, 10);
+        }
+
+        const char* pending_bytes_env = std::getenv("CACHE_WRITE_BEHIND_MAX_BYTES");
+        if (pending_bytes_env) {
+            config.write_behind_max_bytes = std::strtoull(pending_bytes_env, nullptr, 10);
+        }
+
+        const char* workers_env = std::getenv("CACHE_WRITE_BEHIND_WORKERS");
+        if (workers_env) {
+            config.write_behind_workers = std::max(1, std::atoi(workers_env));
+        }
+
+        const char* attempts_env = std::getenv("CACHE_WRITE_BEHIND_MAX_ATTEMPTS");
+        if (attempts_env) {
+            config.write_behind_max_attempts = std::max(1, std::atoi(attempts_env));
+        }
+
+        const char* url_wait_env = std::getenv("CACHE_WRITE_BEHIND_URL_WAIT_MS");
+        if (url_wait_env) {
+            config.write_behind_url_wait_ms = std::max(0, std::atoi(url_wait_env));
+        }
+
+        const char* storage_max_env = std::getenv("CACHE_STORAGE_MAX_BYTES");
+        if (storage_max_env) {
+            config.storage_max_bytes = std::strtoull(storage_max_env, nullptr, 10);
+        }
+
+        const char* policy_env = std::getenv("CACHE_EVICTION_POLICY");
+        if (policy_env) {
+            config.eviction_policy = std::string(policy_env) == "lfu" ? "lfu" : "lru";
+        }
+
+        const char* interval_env = std::getenv("CACHE_EVICTION_INTERVAL_SECONDS");
+        if (interval_env) {
+            config.eviction_interval_seconds = std::max(0, std::atoi(interval_env));
+        }
+
+        return config;
+    }
+};
+
+} // namespace gara
+
+#endif // GARA_CACHE_CONFIG_H
@@ -0,0 +1,68 @@
+#ifndef GARA_COMPRESSION_CONFIG_H
+#define GARA_COMPRESSION_CONFIG_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <string>
+
+namespace gara {
+
+struct CompressionConfig {
+    bool enabled;              // Compress JSON responses per Accept-Encoding
+    size_t min_bytes;          // Smaller bodies go out uncompressed
+    int gzip_level;            // zlib level 1-9
+    int brotli_quality;        // Brotli quality 0-11
+    int zstd_level;            // zstd level 1-19
+    size_t cache_max_bytes;    // Compressed bodies kept for responses with a strong ETag (0 disables)
+
+    // Default constructor with sensible defaults
+    CompressionConfig()
+        : enabled(true),
+          min_bytes(1024),
+          gzip_level(6),
+          brotli_quality(5),
+          zstd_level(3),
+          cache_max_bytes(8 * 1024 * 1024) {}
+
+    // Factory method to create config from environment variables
+    static CompressionConfig fromEnvironment() {
+        CompressionConfig config;
+
+        const char* enabled_env = std::getenv("COMPRESSION_ENABLED");
+        if (enabled_env) {
+            config.enabled = std::string(enabled_env) != "false";
+        }
+
+        const char* min_bytes_env = std::getenv("COMPRESSION_MIN_BYTES");
+        if (min_bytes_env) {
+            config.min_bytes = std::strtoull(min_bytes_env, nullptr, 10);
+        }
+
+        const char* gzip_env = std::getenv("COMPRESSION_GZIP_LEVEL");
+        if (gzip_env) {
+            config.gzip_level = std::clamp(std::atoi(gzip_env), 1, 9);
+        }
+
+        const char* brotli_env = std::getenv("COMPRESSION_BROTLI_QUALITY");
+        if (brotli_env) {
+            config.brotli_quality = std::clamp(std::atoi(brotli_env), 0, 11);
+        }
+
+        const char* zstd_env = std::getenv("COMPRESSION_ZSTD_LEVEL");
+        if (zstd_env) {
+            config.zstd_level = std::clamp(std::atoi(zstd_env), 1, 19);
+        }
+
+        const char* cache_env = std::getenv("COMPRESSION_CACHE_MAX_BYTES");
+        if (cache_env) {
+            config.cache_max_bytes = std::strtoull(cache_env, nullptr, 10);
+        }
+
+        return config;
+    }
+};
+
+} // namespace gara
+
+#endif // GARA_COMPRESSION_CONFIG_H
@@ -0,0 +1,110 @@
+#ifndef GARA_ENCODER_CONFIG_H
+#define GARA_ENCODER_CONFIG_H
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace gara {
+
+// Encoder settings applied to every output format; each format reads the
+// fields it understands
+struct EncoderProfile {
+    std::string name;
+    int quality = 85;             // JPEG, WebP and AVIF Q (1-100)
+    int effort = 4;               // CPU spent on compression, 0-9 (WebP caps at 6)
+    int png_compression = 6;      // zlib level 0-9
+    bool png_palette = false;     // Quantize PNG to a palette (lossy, much smaller)
+    bool jpeg_trellis = false;    // Trellis quantization and deringing (mozjpeg builds)
+    bool jpeg_interlace = false;  // Progressive JPEG
+};
+
+struct EncoderConfig {
+    // Renditions encoded with this profile keep the original, unsuffixed cache keys
+    static constexpr const char* BASELINE_PROFILE = "balanced";
+
+    std::string default_profile;   // Used when a request names no profile
+    std::vector<EncoderProfile> profiles;
+
+    // Default constructor with the built-in fast / balanced / smallest profiles
+    EncoderConfig() : default_profile(BASELINE_PROFILE) {
+        EncoderProfile fast;
+        fast.name = "fast";
+        fast.quality = 80;
+        fast.effort = 0;
+        fast.png_compression = 1;
+
+        EncoderProfile balanced;
+        balanced.name = BASELINE_PROFILE;
+
+        EncoderProfile smallest;
+        smallest.name = "smallest";
+        smallest.quality = 75;
+        smallest.effort = 7;
+        smallest.png_compression = 9;
+        smallest.png_palette = true;
+        smallest.jpeg_trellis = true;
+        smallest.jpeg_interlace = true;
+
+        profiles = {fast, balanced, smallest};
+    }
+
+    // Look up a profile by name; nullptr if unknown
+    const EncoderProfile* find(const std::string& name) const {
+        for (const auto& profile : profiles) {
+            if (profile.name == name) {
+                return &profile;
+            }
+        }
+        return nullptr;
+    }
+
+    // Settings for a request: the named profile (baseline if empty or unknown)
+    // with quality overridden when quality > 0
+    EncoderProfile resolve(const std::string& name, int quality = 0) const {
+        const EncoderProfile* found = find(name.empty() ? BASELINE_PROFILE : name);
+        EncoderProfile profile = found ? *found : EncoderProfile();
+        if (!found) {
+            profile.name = BASELINE_PROFILE;
+        }
+        if (quality > 0) {
+            profile.quality = quality;
+        }
+        return profile;
+    }
+
+    // Factory method to create config from environment variables:
+    // ENCODER_PROFILE picks the default, ENCODER_<NAME>_QUALITY and
+    // ENCODER_<NAME>_EFFORT tune individual profiles
+    static EncoderConfig fromEnvironment() {
+        EncoderConfig config;
+
+        for (auto& profile : config.profiles) {
+            std::string prefix = "ENCODER_" + profile.name;
+            std::transform(prefix.begin(), prefix.end(), prefix.begin(), ::toupper);
+
+            const char* quality_env = std::getenv((prefix + "_QUALITY").c_str());
+            if (quality_env) {
+                profile.quality = std::clamp(std::atoi(quality_env), 1, 100);
+            }
+
+            const char* effort_env = std::getenv((prefix + "_EFFORT").c_str());
+            if (effort_env) {
+                profile.effort = std::clamp(std::atoi(effort_env), 0, 9);
+            }
+        }
+
+        const char* default_env = std::getenv("ENCODER_PROFILE");
+        if (default_env && config.find(default_env)) {
+            config.default_profile = default_env;
+        }
+
+        return config;
+    }
+};
+
+} // namespace gara
+
+#endif // GARA_ENCODER_CONFIG_H
@@ -0,0 +1,75 @@
+#ifndef GARA_GOVERNOR_CONFIG_H
+#define GARA_GOVERNOR_CONFIG_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include "../utils/container_limits.h"
+
+namespace gara {
+
+struct GovernorConfig {
+    uint64_t memory_budget_bytes;  // Estimated transform memory admitted at once (0 disables admission control)
+    int admission_timeout_ms;      // How long a transform waits for budget before a 503
+    int vips_cache_max_mem_mb;     // libvips operation cache memory limit
+    int vips_cache_max_ops;        // libvips operation cache entry limit
+    int vips_cache_max_files;      // Files the libvips operation cache may hold open
+
+    // Default constructor with sensible defaults, scaled to the container memory limit
+    GovernorConfig()
+        : memory_budget_bytes(defaultMemoryBudget(utils::ContainerLimits::current().memory_limit_bytes)),
+          admission_timeout_ms(10000),
+          vips_cache_max_mem_mb(defaultVipsCacheMemMb(utils::ContainerLimits::current().memory_limit_bytes)),
+          vips_cache_max_ops(100),
+          vips_cache_max_files(16) {}
+
+    // Half of a memory limit (0 = none) for transforms, at most 1 GiB
+    static uint64_t defaultMemoryBudget(uint64_t memory_limit_bytes) {
+        const uint64_t budget = 1024ULL * 1024 * 1024;
+        return memory_limit_bytes > 0 ? std::min(budget, memory_limit_bytes / 2) : budget;
+    }
+
+    // A 32nd of a memory limit (0 = none) for the libvips operation cache, within 16-256 MB
+    static int defaultVipsCacheMemMb(uint64_t memory_limit_bytes) {
+        if (memory_limit_bytes == 0) {
+            return 64;
+        }
+        return static_cast<int>(std::clamp<uint64_t>(memory_limit_bytes / 32 / (1024 * 1024), 16, 256));
+    }
+
+    // Factory method to create config from environment variables
+    static GovernorConfig fromEnvironment() {
+        GovernorConfig config;
+
+        const char* budget_env = std::getenv("TRANSFORM_MEMORY_BUDGET_MB");
+        if (budget_env) {
+            config.memory_budget_bytes = std::strtoull(budget_env, nullptr, 10) * 1024 * 1024;
+        }
+
+        const char* timeout_env = std::getenv("TRANSFORM_ADMISSION_TIMEOUT_MS");
+        if (timeout_env) {
+            config.admission_timeout_ms = std::max(0, std::atoi(timeout_env));
+        }
+
+        const char* cache_mem_env = std::getenv("VIPS_CACHE_MAX_MEM_MB");
+        if (cache_mem_env) {
+            config.vips_cache_max_mem_mb = std::max(0, std::atoi(cache_mem_env));
+        }
+
+        const char* cache_ops_env = std::getenv("VIPS_CACHE_MAX_OPS");
+        if (cache_ops_env) {
+            config.vips_cache_max_ops = std::max(0, std::atoi(cache_ops_env));
+        }
+
+        const char* cache_files_env = std::getenv("VIPS_CACHE_MAX_FILES");
+        if (cache_files_env) {
+            config.vips_cache_max_files = std::max(0, std::atoi(cache_files_env));
+        }
+
+        return config;
+    }
+};
+
+} // namespace gara
+
+#endif // GARA_GOVERNOR_CONFIG_H
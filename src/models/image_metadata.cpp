@@ -20,11 +20,22 @@ std::string ImageMetadata::generateRawKey(const std::string& hash, const std::st
 std::string ImageMetadata::generateTransformedKey(const std::string& hash,
                                                   const std::string& format,
                                                   int width, int height,
-                                                  bool watermarked) {
+                                                  bool watermarked,
+                                                  int quality,
+                                                  const std::string& encoder_profile) {
     std::ostringstream oss;
     oss << "transformed/" << hash << "_" << format << "_"
         << width << "x" << height;
 
+    // Encoder choices only appear when they differ from the defaults,
+    // so existing renditions keep their keys
+    if (quality > 0) {
+        oss << "_q" << quality;
+    }
+    if (!encoder_profile.empty()) {
+        oss << "_" << encoder_profile;
+    }
+
     // Add watermark identifier if watermarked
     if (watermarked) {
         oss << "_wm";
@@ -35,28 +46,37 @@ std::string ImageMetadata::generateTransformedKey(const std::string& hash,
 }
 
 TransformRequest::TransformRequest()
-    : image_id(""), target_format("jpeg"), width(0), height(0), watermarked(true) {}
+    : image_id(""), target_format("jpeg"), width(0), height(0), watermarked(true), quality(0) {}
 
 TransformRequest::TransformRequest(const std::string& id, const std::string& format,
                                   int w, int h, bool wm)
-    : image_id(id), target_format(format), width(w), height(h), watermarked(wm) {}
+    : image_id(id), target_format(format), width(w), height(h), watermarked(wm), quality(0) {}
 
 std::string TransformRequest::getCacheKey() const {
-    return ImageMetadata::generateTransformedKey(image_id, target_format, width, height, watermarked);
+    return ImageMetadata::generateTransformedKey(image_id, target_format, width, height, watermarked,
+                                                 quality, encoder_profile);
 }
 
+namespace {
+
+// Convert Unix timestamp to ISO 8601 format
+std::string formatUploadedAt(std::time_t timestamp) {
+    char buffer[80];
+    std::tm timeinfo;
+    gmtime_r(&timestamp, &timeinfo);
+    size_t length = std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%S.000Z", &timeinfo);
+    return std::string(buffer, length);
+}
+
+} // anonymous namespace
+
 nlohmann::json ImageMetadata::toJson() const {
     nlohmann::json j;
     j["id"] = image_id;
     j["name"] = name;
     j["size"] = original_size;
     j["format"] = original_format;
-
-    // Convert Unix timestamp to ISO 8601 format
-    char buffer[80];
-    std::tm* timeinfo = std::gmtime(&upload_timestamp);
-    std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%S.000Z", timeinfo);
-    j["uploadedAt"] = buffer;
+    j["uploadedAt"] = formatUploadedAt(upload_timestamp);
 
     // Only include dimensions if they're known (not 0)
     if (width > 0) {
@@ -65,8 +85,31 @@ nlohmann::json ImageMetadata::toJson() const {
     if (height > 0) {
         j["height"] = height;
     }
+    if (!placeholder.empty()) {
+        j["placeholder"] = placeholder;
+    }
 
     return j;
 }
 
+void ImageMetadata::writeJson(utils::JsonWriter& writer) const {
+    // Keys in nlohmann's (sorted) order so both paths produce identical bytes
+    writer.beginObject();
+    writer.field("format", original_format);
+    if (height > 0) {
+        writer.field("height", height);
+    }
+    writer.field("id", image_id);
+    writer.field("name", name);
+    if (!placeholder.empty()) {
+        writer.field("placeholder", placeholder);
+    }
+    writer.field("size", static_cast<uint64_t>(original_size));
+    writer.field("uploadedAt", formatUploadedAt(upload_timestamp));
+    if (width > 0) {
+        writer.field("width", width);
+    }
+    writer.endObject();
+}
+
 } // namespace gara
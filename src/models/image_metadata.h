@@ -4,6 +4,7 @@
 #include <string>
 #include <ctime>
 #include <nlohmann/json.hpp>
+#include "../utils/json_writer.h"
 
 namespace gara {
 
@@ -18,6 +19,7 @@ struct ImageMetadata {
     std::string name;              // Original filename without extension
     int width;                     // Image width in pixels (0 if unknown)
     int height;                    // Image height in pixels (0 if unknown)
+    std::string placeholder;       // BlurHash shown while loading ("" if not computed)
 
     // Constructor
     ImageMetadata();
@@ -28,13 +30,19 @@ struct ImageMetadata {
     static std::string generateRawKey(const std::string& hash, const std::string& format);
 
     // Generate S3 key for transformed image
+    // quality 0 and an empty encoder profile mean defaults and add nothing to the key
     static std::string generateTransformedKey(const std::string& hash,
                                              const std::string& format,
                                              int width, int height,
-                                             bool watermarked = false);
+                                             bool watermarked = false,
+                                             int quality = 0,
+                                             const std::string& encoder_profile = "");
 
     // Convert to JSON for API response
     nlohmann::json toJson() const;
+
+    // Write the same object as toJson() straight into a response body
+    void writeJson(utils::JsonWriter& writer) const;
 };
 
 struct TransformRequest {
@@ -43,6 +51,8 @@ struct TransformRequest {
     int width;                  // Target width (0 = maintain aspect)
     int height;                 // Target height (0 = maintain aspect)
     bool watermarked;           // Whether to apply watermark
+    int quality;                // Encoder quality override (0 = profile default)
+    std::string encoder_profile;  // Named encoder profile (empty = baseline)
 
     TransformRequest();
     TransformRequest(const std::string& id, const std::string& format,
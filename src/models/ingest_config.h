@@ -0,0 +1,39 @@
+#ifndef GARA_INGEST_CONFIG_H
+#define GARA_INGEST_CONFIG_H
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace gara {
+
+// POST /api/images/upload/bulk
+struct IngestConfig {
+    int workers;       // Files hashed, probed and stored in parallel (shared by all bulk requests)
+    int max_files;     // Files accepted in one request
+
+    // Default constructor with sensible defaults
+    IngestConfig()
+        : workers(8),
+          max_files(1000) {}
+
+    // Factory method to create config from environment variables
+    static IngestConfig fromEnvironment() {
+        IngestConfig config;
+
+        const char* workers_env = std::getenv("BULK_UPLOAD_WORKERS");
+        if (workers_env) {
+            config.workers = std::max(1, std::atoi(workers_env));
+        }
+
+        const char* max_files_env = std::getenv("BULK_UPLOAD_MAX_FILES");
+        if (max_files_env) {
+            config.max_files = std::max(1, std::atoi(max_files_env));
+        }
+
+        return config;
+    }
+};
+
+} // namespace gara
+
+#endif // GARA_INGEST_CONFIG_H
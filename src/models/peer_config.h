@@ -0,0 +1,109 @@
+#ifndef GARA_PEER_CONFIG_H
+#define GARA_PEER_CONFIG_H
+
+#include <algorithm>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace gara {
+
+struct PeerConfig {
+    std::string self_url;             // This node's base URL as peers reach it (http://10.0.0.5:8080)
+    std::vector<std::string> urls;    // Static members, self included
+    std::string dns_name;             // Headless service name resolved for members instead of urls
+    int port;                         // Port of members found through DNS
+    int refresh_seconds;              // How often DNS membership is re-resolved
+    int virtual_nodes;                // Ring points per member; more spreads keys more evenly
+    int timeout_ms;                   // Whole peer request, including the owner's transform
+    int connect_timeout_ms;           // Give up on an unreachable owner quickly and transform locally
+    std::string api_key;              // Sent as X-API-Key on peer requests
+
+    // Default constructor with sensible defaults
+    PeerConfig()
+        : port(8080),
+          refresh_seconds(30),
+          virtual_nodes(160),
+          timeout_ms(30000),
+          connect_timeout_ms(500) {}
+
+    // Factory method to create config from environment variables
+    static PeerConfig fromEnvironment() {
+        PeerConfig config;
+
+        const char* self_env = std::getenv("PEER_SELF_URL");
+        if (self_env) {
+            config.self_url = normalizeUrl(self_env);
+        }
+
+        const char* urls_env = std::getenv("PEER_URLS");
+        if (urls_env) {
+            std::stringstream stream(urls_env);
+            std::string url;
+            while (std::getline(stream, url, ',')) {
+                url = normalizeUrl(url);
+                if (!url.empty()) {
+                    config.urls.push_back(url);
+                }
+            }
+        }
+
+        const char* dns_env = std::getenv("PEER_DNS_NAME");
+        if (dns_env) {
+            config.dns_name = dns_env;
+        }
+
+        const char* port_env = std::getenv("PEER_PORT");
+        if (port_env) {
+            config.port = std::clamp(std::atoi(port_env), 1, 65535);
+        }
+
+        const char* refresh_env = std::getenv("PEER_REFRESH_SECONDS");
+        if (refresh_env) {
+            config.refresh_seconds = std::max(1, std::atoi(refresh_env));
+        }
+
+        const char* virtual_nodes_env = std::getenv("PEER_VIRTUAL_NODES");
+        if (virtual_nodes_env) {
+            config.virtual_nodes = std::clamp(std::atoi(virtual_nodes_env), 1, 1000);
+        }
+
+        const char* timeout_env = std::getenv("PEER_TIMEOUT_MS");
+        if (timeout_env) {
+            config.timeout_ms = std::max(100, std::atoi(timeout_env));
+        }
+
+        const char* connect_timeout_env = std::getenv("PEER_CONNECT_TIMEOUT_MS");
+        if (connect_timeout_env) {
+            config.connect_timeout_ms = std::max(10, std::atoi(connect_timeout_env));
+        }
+
+        const char* api_key_env = std::getenv("PEER_API_KEY");
+        if (api_key_env) {
+            config.api_key = api_key_env;
+        }
+
+        return config;
+    }
+
+    // Peering needs to know which member is this node
+    bool isEnabled() const { return !self_url.empty() && (!urls.empty() || !dns_name.empty()); }
+
+    // Trims whitespace and trailing slashes so members compare equal to self_url
+    static std::string normalizeUrl(const std::string& url) {
+        size_t begin = url.find_first_not_of(" \t");
+        if (begin == std::string::npos) {
+            return "";
+        }
+        std::string trimmed = url.substr(begin, url.find_last_not_of(" \t") - begin + 1);
+        while (!trimmed.empty() && trimmed.back() == '/') {
+            trimmed.pop_back();
+        }
+        return trimmed;
+    }
+};
+
+} // namespace gara
+
+#endif // GARA_PEER_CONFIG_H
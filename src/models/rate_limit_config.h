@@ -0,0 +1,78 @@
+#ifndef GARA_RATE_LIMIT_CONFIG_H
+#define GARA_RATE_LIMIT_CONFIG_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <string>
+
+namespace gara {
+
+struct RateLimitConfig {
+    bool enabled;                    // Enforce per-client token buckets
+    double requests_per_second;      // Token refill rate per bucket
+    int burst;                       // Bucket capacity in tokens
+    int miss_cost;                   // Extra tokens a rendition cache miss costs (a request costs 1)
+    int max_concurrent_transforms;   // Cache-miss transforms one client may hold at once (0 = no cap)
+    bool trust_forwarded_for;        // Identify clients by the first X-Forwarded-For hop
+    size_t table_size;               // Bucket slots; clients hashing to one slot share it
+
+    // Default constructor with sensible defaults
+    RateLimitConfig()
+        : enabled(false),
+          requests_per_second(20.0),
+          burst(100),
+          miss_cost(10),
+          max_concurrent_transforms(4),
+          trust_forwarded_for(false),
+          table_size(65536) {}
+
+    // Factory method to create config from environment variables
+    static RateLimitConfig fromEnvironment() {
+        RateLimitConfig config;
+
+        const char* enabled_env = std::getenv("RATE_LIMIT_ENABLED");
+        if (enabled_env) {
+            config.enabled = std::string(enabled_env) == "true";
+        }
+
+        const char* rate_env = std::getenv("RATE_LIMIT_REQUESTS_PER_SECOND");
+        if (rate_env) {
+            config.requests_per_second = std::clamp(std::atof(rate_env), 0.01, 100000.0);
+        }
+
+        // Tokens are kept in thousandths within 24 bits of the bucket word
+        const char* burst_env = std::getenv("RATE_LIMIT_BURST");
+        if (burst_env) {
+            config.burst = std::clamp(std::atoi(burst_env), 1, 16000);
+        }
+
+        const char* miss_cost_env = std::getenv("RATE_LIMIT_MISS_COST");
+        if (miss_cost_env) {
+            config.miss_cost = std::max(0, std::atoi(miss_cost_env));
+        }
+
+        const char* concurrency_env = std::getenv("RATE_LIMIT_MAX_CONCURRENT_TRANSFORMS");
+        if (concurrency_env) {
+            config.max_concurrent_transforms = std::max(0, std::atoi(concurrency_env));
+        }
+
+        const char* forwarded_env = std::getenv("RATE_LIMIT_TRUST_FORWARDED_FOR");
+        if (forwarded_env) {
+            config.trust_forwarded_for = std::string(forwarded_env) == "true";
+        }
+
+        const char* table_env = std::getenv("RATE_LIMIT_TABLE_SIZE");
+        if (table_env) {
+            config.table_size = std::max<size_t>(64, std::strtoull(table_env, nullptr, 10));
+        }
+
+        return config;
+    }
+
+    bool isEnabled() const { return enabled; }
+};
+
+} // namespace gara
+
+#endif // GARA_RATE_LIMIT_CONFIG_H
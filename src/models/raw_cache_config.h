@@ -0,0 +1,43 @@
+#ifndef GARA_RAW_CACHE_CONFIG_H
+#define GARA_RAW_CACHE_CONFIG_H
+
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+
+namespace gara {
+
+struct RawCacheConfig {
+    std::string directory;       // Where cached originals are kept
+    uint64_t max_bytes;          // Disk budget (0 disables the cache)
+    std::string key_prefix;      // Only keys under this prefix are cached
+
+    // Default constructor with sensible defaults
+    RawCacheConfig()
+        : directory("./data/raw-cache"),
+          max_bytes(1024ULL * 1024 * 1024),
+          key_prefix("raw/") {}
+
+    bool isEnabled() const { return max_bytes > 0 && !directory.empty(); }
+
+    // Factory method to create config from environment variables
+    static RawCacheConfig fromEnvironment() {
+        RawCacheConfig config;
+
+        const char* dir_env = std::getenv("RAW_CACHE_DIR");
+        if (dir_env) {
+            config.directory = dir_env;
+        }
+
+        const char* max_bytes_env = std::getenv("RAW_CACHE_MAX_BYTES");
+        if (max_bytes_env) {
+            config.max_bytes = std::strtoull(max_bytes_env, nullptr, 10);
+        }
+
+        return config;
+    }
+};
+
+} // namespace gara
+
+#endif // GARA_RAW_CACHE_CONFIG_H
@@ -0,0 +1,100 @@
+#ifndef GARA_RENDER_JOB_CONFIG_H
+#define GARA_RENDER_JOB_CONFIG_H
+
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+
+namespace gara {
+
+// Priorities of the jobs the service queues itself; higher is claimed first
+namespace RenderJobPriority {
+    constexpr int PREGENERATE = 10;  // Renditions of a new upload
+    constexpr int BACKFILL = 0;      // Default for POST /api/images/render-jobs
+}
+
+// Durable background rendition queue (render_jobs table) and its workers
+struct RenderJobConfig {
+    bool enabled;               // Run the workers; pre-generation is queued in the database
+    int workers;                // Images rendered at once by this instance
+    int batch_images;           // Images each worker claims per round
+    int poll_interval_ms;       // Wait between rounds when idle or the transform pool is busy
+    int lease_seconds;          // Unfinished jobs of a crashed instance become ready after this
+    int max_attempts;           // A job failing this many times is kept as failed
+    int retry_base_seconds;     // First retry delay, doubled per attempt
+    int retry_max_seconds;      // Upper bound of the retry delay
+
+    // Default constructor with sensible defaults
+    RenderJobConfig()
+        : enabled(false),
+          workers(1),
+          batch_images(4),
+          poll_interval_ms(1000),
+          lease_seconds(300),
+          max_attempts(5),
+          retry_base_seconds(30),
+          retry_max_seconds(3600) {}
+
+    bool isEnabled() const { return enabled; }
+
+    // Delay before the next attempt of a job that has failed attempts times
+    int retryDelaySeconds(int attempts) const {
+        long long delay = retry_base_seconds;
+        for (int i = 1; i < attempts && delay < retry_max_seconds; ++i) {
+            delay *= 2;
+        }
+        return static_cast<int>(std::min<long long>(delay, retry_max_seconds));
+    }
+
+    // Factory method to create config from environment variables
+    static RenderJobConfig fromEnvironment() {
+        RenderJobConfig config;
+
+        const char* enabled_env = std::getenv("RENDER_JOBS_ENABLED");
+        if (enabled_env) {
+            std::string value = enabled_env;
+            config.enabled = (value == "true" || value == "1");
+        }
+
+        const char* workers_env = std::getenv("RENDER_JOBS_WORKERS");
+        if (workers_env) {
+            config.workers = std::max(1, std::atoi(workers_env));
+        }
+
+        const char* batch_env = std::getenv("RENDER_JOBS_BATCH_IMAGES");
+        if (batch_env) {
+            config.batch_images = std::max(1, std::atoi(batch_env));
+        }
+
+        const char* poll_env = std::getenv("RENDER_JOBS_POLL_INTERVAL_MS");
+        if (poll_env) {
+            config.poll_interval_ms = std::max(10, std::atoi(poll_env));
+        }
+
+        const char* lease_env = std::getenv("RENDER_JOBS_LEASE_SECONDS");
+        if (lease_env) {
+            config.lease_seconds = std::max(1, std::atoi(lease_env));
+        }
+
+        const char* attempts_env = std::getenv("RENDER_JOBS_MAX_ATTEMPTS");
+        if (attempts_env) {
+            config.max_attempts = std::max(1, std::atoi(attempts_env));
+        }
+
+        const char* retry_base_env = std::getenv("RENDER_JOBS_RETRY_BASE_SECONDS");
+        if (retry_base_env) {
+            config.retry_base_seconds = std::max(1, std::atoi(retry_base_env));
+        }
+
+        const char* retry_max_env = std::getenv("RENDER_JOBS_RETRY_MAX_SECONDS");
+        if (retry_max_env) {
+            config.retry_max_seconds = std::max(config.retry_base_seconds, std::atoi(retry_max_env));
+        }
+
+        return config;
+    }
+};
+
+} // namespace gara
+
+#endif // GARA_RENDER_JOB_CONFIG_H
@@ -0,0 +1,123 @@
+#ifndef GARA_S3_CONFIG_H
+#define GARA_S3_CONFIG_H
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstddef>
+#include <string>
+
+namespace gara {
+
+struct S3Config {
+    std::string bucket;
+    std::string region;
+    std::string endpoint;              // e.g. http://minio:9000; empty for AWS
+    bool force_path_style;             // bucket in the path instead of the host name
+    std::string access_key_id;
+    std::string secret_access_key;
+    std::string session_token;
+
+    size_t multipart_threshold_bytes;  // Larger uploads use multipart
+    size_t part_size_bytes;            // Multipart part and ranged GET chunk size
+    int transfer_concurrency;          // Parallel parts per upload or download
+    int max_idle_connections;          // Keep-alive handles kept in the pool
+    int request_timeout_seconds;
+    int head_cache_ttl_seconds;        // How long objectExists results are trusted
+    size_t head_cache_max_bytes;       // Budget for cached existence results (0 disables)
+    int presign_bucket_seconds;        // Presigned URLs are reused within aligned windows this wide (0 disables)
+    size_t presign_cache_max_bytes;    // Budget for reused presigned URLs
+
+    // Default constructor with sensible defaults
+    S3Config()
+        : region("us-east-1"),
+          force_path_style(false),
+          multipart_threshold_bytes(64 * 1024 * 1024),
+          part_size_bytes(8 * 1024 * 1024),
+          transfer_concurrency(4),
+          max_idle_connections(32),
+          request_timeout_seconds(30),
+          head_cache_ttl_seconds(60),
+          head_cache_max_bytes(4 * 1024 * 1024),
+          presign_bucket_seconds(900),
+          presign_cache_max_bytes(4 * 1024 * 1024) {}
+
+    bool isConfigured() const {
+        return !bucket.empty() && !access_key_id.empty() && !secret_access_key.empty();
+    }
+
+    // Factory method to create config from environment variables
+    static S3Config fromEnvironment() {
+        S3Config config;
+
+        auto read = [](const char* name, std::string& target) {
+            const char* value = std::getenv(name);
+            if (value) {
+                target = value;
+            }
+        };
+        read("S3_BUCKET_NAME", config.bucket);
+        read("AWS_REGION", config.region);
+        read("S3_REGION", config.region);
+        read("S3_ENDPOINT", config.endpoint);
+        read("AWS_ACCESS_KEY_ID", config.access_key_id);
+        read("AWS_SECRET_ACCESS_KEY", config.secret_access_key);
+        read("AWS_SESSION_TOKEN", config.session_token);
+
+        const char* path_style_env = std::getenv("S3_FORCE_PATH_STYLE");
+        if (path_style_env) {
+            config.force_path_style = std::string(path_style_env) == "true";
+        }
+
+        const char* threshold_env = std::getenv("S3_MULTIPART_THRESHOLD_MB");
+        if (threshold_env) {
+            config.multipart_threshold_bytes = std::max<size_t>(5, std::strtoull(threshold_env, nullptr, 10)) * 1024 * 1024;
+        }
+
+        // S3 rejects multipart parts under 5 MB (except the last)
+        const char* part_size_env = std::getenv("S3_PART_SIZE_MB");
+        if (part_size_env) {
+            config.part_size_bytes = std::max<size_t>(5, std::strtoull(part_size_env, nullptr, 10)) * 1024 * 1024;
+        }
+
+        const char* concurrency_env = std::getenv("S3_TRANSFER_CONCURRENCY");
+        if (concurrency_env) {
+            config.transfer_concurrency = std::clamp(std::atoi(concurrency_env), 1, 32);
+        }
+
+        const char* connections_env = std::getenv("S3_MAX_IDLE_CONNECTIONS");
+        if (connections_env) {
+            config.max_idle_connections = std::max(1, std::atoi(connections_env));
+        }
+
+        const char* timeout_env = std::getenv("S3_REQUEST_TIMEOUT_SECONDS");
+        if (timeout_env) {
+            config.request_timeout_seconds = std::max(1, std::atoi(timeout_env));
+        }
+
+        const char* head_ttl_env = std::getenv("S3_HEAD_CACHE_TTL_SECONDS");
+        if (head_ttl_env) {
+            config.head_cache_ttl_seconds = std::max(1, std::atoi(head_ttl_env));
+        }
+
+        const char* head_bytes_env = std::getenv("S3_HEAD_CACHE_MAX_BYTES");
+        if (head_bytes_env) {
+            config.head_cache_max_bytes = std::strtoull(head_bytes_env, nullptr, 10);
+        }
+
+        const char* presign_bucket_env = std::getenv("S3_PRESIGN_BUCKET_SECONDS");
+        if (presign_bucket_env) {
+            config.presign_bucket_seconds = std::max(0, std::atoi(presign_bucket_env));
+        }
+
+        const char* presign_bytes_env = std::getenv("S3_PRESIGN_CACHE_MAX_BYTES");
+        if (presign_bytes_env) {
+            config.presign_cache_max_bytes = std::strtoull(presign_bytes_env, nullptr, 10);
+        }
+
+        return config;
+    }
+};
+
+} // namespace gara
+
+#endif // GARA_S3_CONFIG_H
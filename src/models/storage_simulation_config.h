@@ -0,0 +1,108 @@
+#ifndef GARA_STORAGE_SIMULATION_CONFIG_H
+#define GARA_STORAGE_SIMULATION_CONFIG_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <initializer_list>
+#include <string>
+
+namespace gara {
+
+// Latency and failure behavior of one class of storage operation
+struct StorageOperationProfile {
+    double median_ms;    // Typical round trip
+    double p99_ms;       // Tail; latencies are log-normal between the two (<= median means fixed)
+    double error_rate;   // Fraction of calls that fail after paying their latency
+
+    StorageOperationProfile(double median, double p99, double errors = 0.0)
+        : median_ms(median), p99_ms(p99), error_rate(errors) {}
+};
+
+struct StorageSimulationConfig {
+    bool enabled;                          // Wrap the storage backend in SimulatedFileService
+    StorageOperationProfile get;           // downloadFile / downloadData
+    StorageOperationProfile put;           // uploadFile / uploadData / moveFileToStorage
+    StorageOperationProfile head;          // objectExists
+    StorageOperationProfile del;           // deleteObject
+    uint64_t bandwidth_bytes_per_sec;      // Per-transfer throughput cap (0 = unlimited)
+    uint64_t seed;                         // Random seed, for repeatable runs
+
+    // Default constructor with S3-like numbers from the same region
+    StorageSimulationConfig()
+        : enabled(false),
+          get(30.0, 80.0),
+          put(50.0, 150.0),
+          head(20.0, 60.0),
+          del(20.0, 60.0),
+          bandwidth_bytes_per_sec(0),
+          seed(42) {}
+
+    bool isEnabled() const { return enabled; }
+
+    // Factory method to create config from environment variables
+    static StorageSimulationConfig fromEnvironment() {
+        StorageSimulationConfig config;
+
+        const char* enabled_env = std::getenv("STORAGE_SIM_ENABLED");
+        if (enabled_env) {
+            std::string value = enabled_env;
+            config.enabled = (value == "true" || value == "1");
+        }
+
+        // Applies to every operation unless STORAGE_SIM_<OP>_ERROR_RATE overrides it
+        const char* error_rate_env = std::getenv("STORAGE_SIM_ERROR_RATE");
+        if (error_rate_env) {
+            double rate = clampRate(std::atof(error_rate_env));
+            for (auto* profile : {&config.get, &config.put, &config.head, &config.del}) {
+                profile->error_rate = rate;
+            }
+        }
+
+        readProfile("GET", config.get);
+        readProfile("PUT", config.put);
+        readProfile("HEAD", config.head);
+        readProfile("DELETE", config.del);
+
+        const char* bandwidth_env = std::getenv("STORAGE_SIM_BANDWIDTH_BYTES_PER_SEC");
+        if (bandwidth_env) {
+            config.bandwidth_bytes_per_sec = std::strtoull(bandwidth_env, nullptr, 10);
+        }
+
+        const char* seed_env = std::getenv("STORAGE_SIM_SEED");
+        if (seed_env) {
+            config.seed = std::strtoull(seed_env, nullptr, 10);
+        }
+
+        return config;
+    }
+
+private:
+    static double clampRate(double rate) {
+        return std::clamp(rate, 0.0, 1.0);
+    }
+
+    // STORAGE_SIM_<OP>_LATENCY_MS, STORAGE_SIM_<OP>_P99_MS and STORAGE_SIM_<OP>_ERROR_RATE
+    static void readProfile(const std::string& op, StorageOperationProfile& profile) {
+        std::string prefix = "STORAGE_SIM_" + op + "_";
+
+        const char* latency_env = std::getenv((prefix + "LATENCY_MS").c_str());
+        if (latency_env) {
+            profile.median_ms = std::max(0.0, std::atof(latency_env));
+        }
+
+        const char* p99_env = std::getenv((prefix + "P99_MS").c_str());
+        if (p99_env) {
+            profile.p99_ms = std::max(0.0, std::atof(p99_env));
+        }
+
+        const char* error_rate_env = std::getenv((prefix + "ERROR_RATE").c_str());
+        if (error_rate_env) {
+            profile.error_rate = clampRate(std::atof(error_rate_env));
+        }
+    }
+};
+
+} // namespace gara
+
+#endif // GARA_STORAGE_SIMULATION_CONFIG_H
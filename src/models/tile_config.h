@@ -0,0 +1,101 @@
+#ifndef GARA_TILE_CONFIG_H
+#define GARA_TILE_CONFIG_H
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <string>
+
+namespace gara {
+
+// DeepZoom tile pyramids, generated on first request and stored under tiles/<image_id>/
+struct TileConfig {
+    bool enabled;          // Serve /api/images/<id>/tiles/
+    int tile_size;         // Tile edge in pixels, excluding overlap
+    int overlap;           // Pixels shared with each neighbouring tile
+    std::string format;    // jpeg, png or webp
+    int quality;           // Encoder quality for jpeg and webp tiles
+
+    // Default constructor with sensible defaults (OpenSeadragon's usual layout)
+    TileConfig()
+        : enabled(true),
+          tile_size(254),
+          overlap(1),
+          format("jpeg"),
+          quality(85) {}
+
+    // File extension of tiles, as written by dzsave and named in the descriptor
+    std::string extension() const {
+        if (format == "png" || format == "webp") {
+            return format;
+        }
+        return "jpg";
+    }
+
+    // Settings baked into a pyramid, so changing them generates a new one
+    // instead of mixing layouts (e.g. "jpg-254-1-q85")
+    std::string variant() const {
+        return extension() + "-" + std::to_string(tile_size) + "-" + std::to_string(overlap) +
+               "-q" + std::to_string(quality);
+    }
+
+    // Parse "<col>_<row>.<extension>"; false for anything else
+    bool parseTileName(const std::string& name, int& col, int& row) const {
+        std::string suffix = "." + extension();
+        if (name.size() <= suffix.size() ||
+            name.compare(name.size() - suffix.size(), suffix.size(), suffix) != 0) {
+            return false;
+        }
+        std::string stem = name.substr(0, name.size() - suffix.size());
+        size_t underscore = stem.find('_');
+        if (underscore == std::string::npos || underscore == 0 || underscore + 1 == stem.size() ||
+            underscore > 9 || stem.size() - underscore - 1 > 9) {
+            return false;
+        }
+        for (size_t i = 0; i < stem.size(); ++i) {
+            if (i != underscore && !std::isdigit(static_cast<unsigned char>(stem[i]))) {
+                return false;
+            }
+        }
+        col = std::atoi(stem.substr(0, underscore).c_str());
+        row = std::atoi(stem.substr(underscore + 1).c_str());
+        return true;
+    }
+
+    // Factory method to create config from environment variables
+    static TileConfig fromEnvironment() {
+        TileConfig config;
+
+        const char* enabled_env = std::getenv("TILES_ENABLED");
+        if (enabled_env) {
+            config.enabled = std::string(enabled_env) != "false";
+        }
+
+        const char* size_env = std::getenv("TILE_SIZE");
+        if (size_env) {
+            config.tile_size = std::clamp(std::atoi(size_env), 16, 2048);
+        }
+
+        const char* overlap_env = std::getenv("TILE_OVERLAP");
+        if (overlap_env) {
+            config.overlap = std::clamp(std::atoi(overlap_env), 0, 16);
+        }
+
+        const char* format_env = std::getenv("TILE_FORMAT");
+        if (format_env) {
+            std::string format = format_env;
+            config.format = (format == "png" || format == "webp") ? format : "jpeg";
+        }
+
+        const char* quality_env = std::getenv("TILE_QUALITY");
+        if (quality_env) {
+            config.quality = std::clamp(std::atoi(quality_env), 1, 100);
+        }
+
+        return config;
+    }
+};
+
+} // namespace gara
+
+#endif // GARA_TILE_CONFIG_H
@@ -0,0 +1,84 @@
+#ifndef GARA_TRACING_CONFIG_H
+#define GARA_TRACING_CONFIG_H
+
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+
+namespace gara {
+
+struct TracingConfig {
+    bool server_timing;           // Send per-stage durations in a Server-Timing response header
+    std::string otlp_endpoint;    // OTLP/HTTP collector base URL, e.g. http://otel-collector:4318 (empty disables export)
+    std::string service_name;     // service.name resource attribute on exported spans
+    double sample_ratio;          // Share of unparented requests exported (a sampled traceparent always is)
+    int max_queue_size;           // Finished traces buffered for export; newer ones are dropped when full
+    int max_batch_size;           // Traces sent per export request
+    int flush_interval_ms;        // Longest a finished trace waits before being sent
+    int export_timeout_ms;        // Per-request timeout for the collector
+
+    // Default constructor with sensible defaults
+    TracingConfig()
+        : server_timing(true),
+          service_name("gara-image"),
+          sample_ratio(1.0),
+          max_queue_size(2048),
+          max_batch_size(256),
+          flush_interval_ms(2000),
+          export_timeout_ms(5000) {}
+
+    bool exportEnabled() const { return !otlp_endpoint.empty(); }
+
+    bool isEnabled() const { return server_timing || exportEnabled(); }
+
+    // Factory method to create config from environment variables
+    static TracingConfig fromEnvironment() {
+        TracingConfig config;
+
+        const char* server_timing_env = std::getenv("TRACING_SERVER_TIMING");
+        if (server_timing_env) {
+            config.server_timing = std::string(server_timing_env) != "false";
+        }
+
+        const char* traces_endpoint_env = std::getenv("OTEL_EXPORTER_OTLP_ENDPOINT");
+        if (traces_endpoint_env) {
+            config.otlp_endpoint = traces_endpoint_env;
+        }
+
+        const char* service_env = std::getenv("OTEL_SERVICE_NAME");
+        if (service_env && *service_env) {
+            config.service_name = service_env;
+        }
+
+        const char* ratio_env = std::getenv("TRACING_SAMPLE_RATIO");
+        if (ratio_env) {
+            config.sample_ratio = std::clamp(std::atof(ratio_env), 0.0, 1.0);
+        }
+
+        const char* queue_env = std::getenv("TRACING_MAX_QUEUE_SIZE");
+        if (queue_env) {
+            config.max_queue_size = std::max(1, std::atoi(queue_env));
+        }
+
+        const char* batch_env = std::getenv("TRACING_MAX_BATCH_SIZE");
+        if (batch_env) {
+            config.max_batch_size = std::max(1, std::atoi(batch_env));
+        }
+
+        const char* flush_env = std::getenv("TRACING_FLUSH_INTERVAL_MS");
+        if (flush_env) {
+            config.flush_interval_ms = std::max(10, std::atoi(flush_env));
+        }
+
+        const char* timeout_env = std::getenv("TRACING_EXPORT_TIMEOUT_MS");
+        if (timeout_env) {
+            config.export_timeout_ms = std::max(100, std::atoi(timeout_env));
+        }
+
+        return config;
+    }
+};
+
+} // namespace gara
+
+#endif // GARA_TRACING_CONFIG_H
@@ -0,0 +1,223 @@
+#ifndef GARA_TRANSFORM_CONFIG_H
+#define GARA_TRANSFORM_CONFIG_H
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "encoder_config.h"
+#include "governor_config.h"
+#include "ingest_config.h"
+#include "render_job_config.h"
+#include "tile_config.h"
+#include "../utils/container_limits.h"
+
+namespace gara {
+
+// A rendition generated ahead of the first request for it
+struct RenditionProfile {
+    std::string format;
+    int width = 0;   // 0 = maintain aspect
+    int height = 0;  // 0 = maintain aspect
+
+    // Parse a comma-separated list such as "webp:320,webp:640x480,jpeg:1280x0";
+    // malformed entries are skipped
+    static std::vector<RenditionProfile> parseList(const std::string& spec) {
+        std::vector<RenditionProfile> profiles;
+        std::stringstream stream(spec);
+        std::string entry;
+        while (std::getline(stream, entry, ',')) {
+            entry.erase(std::remove_if(entry.begin(), entry.end(), ::isspace), entry.end());
+            size_t colon = entry.find(':');
+            if (colon == std::string::npos || colon == 0) {
+                continue;
+            }
+
+            RenditionProfile profile;
+            profile.format = entry.substr(0, colon);
+            std::transform(profile.format.begin(), profile.format.end(), profile.format.begin(), ::tolower);
+
+            std::string size = entry.substr(colon + 1);
+            size_t x = size.find('x');
+            try {
+                profile.width = std::stoi(size.substr(0, x));
+                profile.height = x == std::string::npos ? 0 : std::stoi(size.substr(x + 1));
+            } catch (const std::exception&) {
+                continue;
+            }
+            if (profile.width < 0 || profile.height < 0) {
+                continue;
+            }
+            profiles.push_back(profile);
+        }
+        return profiles;
+    }
+};
+
+// How requested dimensions are matched against the size ladder
+enum class SizePolicy {
+    OFF,     // Any size up to the maximum dimension
+    SNAP,    // Round up to the next ladder size (the largest if beyond it)
+    REJECT   // Only ladder sizes are accepted
+};
+
+// Allowed rendition sizes; bounds how many distinct transforms one image can produce
+struct SizeLadder {
+    SizePolicy policy = SizePolicy::OFF;
+    std::vector<int> sizes;  // Ascending, unique, positive
+
+    // Parse "160,320,640"; non-positive and malformed entries are skipped
+    static std::vector<int> parseSizes(const std::string& spec) {
+        std::vector<int> sizes;
+        std::stringstream stream(spec);
+        std::string entry;
+        while (std::getline(stream, entry, ',')) {
+            try {
+                int size = std::stoi(entry);
+                if (size > 0) {
+                    sizes.push_back(size);
+                }
+            } catch (const std::exception&) {
+                continue;
+            }
+        }
+        std::sort(sizes.begin(), sizes.end());
+        sizes.erase(std::unique(sizes.begin(), sizes.end()), sizes.end());
+        return sizes;
+    }
+
+    static SizePolicy parsePolicy(const std::string& name) {
+        if (name == "snap") return SizePolicy::SNAP;
+        if (name == "reject") return SizePolicy::REJECT;
+        return SizePolicy::OFF;
+    }
+
+    // Apply the policy to one dimension (0 = keep aspect, always allowed);
+    // returns false if the policy rejects it
+    bool apply(int& dimension) const {
+        if (policy == SizePolicy::OFF || sizes.empty() || dimension <= 0) {
+            return true;
+        }
+        auto rung = std::lower_bound(sizes.begin(), sizes.end(), dimension);
+        if (policy == SizePolicy::REJECT) {
+            return rung != sizes.end() && *rung == dimension;
+        }
+        dimension = rung == sizes.end() ? sizes.back() : *rung;
+        return true;
+    }
+
+    // Comma-separated sizes for error messages
+    std::string describe() const {
+        std::string text;
+        for (int size : sizes) {
+            text += (text.empty() ? "" : ",") + std::to_string(size);
+        }
+        return text;
+    }
+};
+
+struct TransformConfig {
+    int coalesce_timeout_ms;   // How long duplicate cache misses wait for the in-flight transform
+    int worker_threads;        // Transform worker pool size
+    int queue_size;            // Max transforms waiting for a worker before shedding load
+    int retry_after_seconds;   // Retry-After sent with 503 when shedding load
+    int vips_concurrency;      // libvips threads per transform (0 = cores / workers)
+    long long small_max_pixels;  // Renditions up to this area use the high priority lane
+    long long large_min_pixels;  // Renditions from this area use the low priority lane
+    long long stream_min_pixels; // Renditions from this area are encoded straight to disk (0 = never)
+    std::vector<RenditionProfile> pregenerate_renditions;  // Generated in the background after upload
+    EncoderConfig encoder;     // Named encoder profiles and the default one
+    SizeLadder size_ladder;    // Snapping or rejection of off-ladder widths and heights
+    GovernorConfig governor;   // Memory admission control and libvips cache limits
+    TileConfig tiles;          // DeepZoom tile pyramids
+    IngestConfig ingest;       // Bulk upload worker pool and limits
+    RenderJobConfig render_jobs;  // Durable background rendition queue
+
+    // Default constructor with sensible defaults
+    TransformConfig()
+        : coalesce_timeout_ms(30000),
+          worker_threads(std::max(1, hardwareThreads() / 2)),
+          queue_size(32),
+          retry_after_seconds(2),
+          vips_concurrency(0),
+          small_max_pixels(512LL * 512LL),
+          large_min_pixels(2048LL * 2048LL),
+          stream_min_pixels(2048LL * 2048LL) {}
+
+    // Factory method to create config from environment variables
+    static TransformConfig fromEnvironment() {
+        TransformConfig config;
+
+        const char* coalesce_timeout_env = std::getenv("TRANSFORM_COALESCE_TIMEOUT_MS");
+        if (coalesce_timeout_env) {
+            config.coalesce_timeout_ms = std::atoi(coalesce_timeout_env);
+        }
+
+        const char* workers_env = std::getenv("TRANSFORM_WORKERS");
+        if (workers_env) {
+            config.worker_threads = std::max(1, std::atoi(workers_env));
+        }
+
+        const char* queue_env = std::getenv("TRANSFORM_QUEUE_SIZE");
+        if (queue_env) {
+            config.queue_size = std::max(0, std::atoi(queue_env));
+        }
+
+        const char* retry_after_env = std::getenv("TRANSFORM_RETRY_AFTER_SECONDS");
+        if (retry_after_env) {
+            config.retry_after_seconds = std::max(1, std::atoi(retry_after_env));
+        }
+
+        const char* vips_concurrency_env = std::getenv("VIPS_CONCURRENCY");
+        if (vips_concurrency_env) {
+            config.vips_concurrency = std::max(0, std::atoi(vips_concurrency_env));
+        }
+
+        const char* stream_min_pixels_env = std::getenv("TRANSFORM_STREAM_MIN_PIXELS");
+        if (stream_min_pixels_env) {
+            config.stream_min_pixels = std::max(0LL, std::atoll(stream_min_pixels_env));
+        }
+
+        const char* pregenerate_env = std::getenv("PREGENERATE_RENDITIONS");
+        if (pregenerate_env) {
+            config.pregenerate_renditions = RenditionProfile::parseList(pregenerate_env);
+        }
+
+        config.encoder = EncoderConfig::fromEnvironment();
+
+        const char* size_policy_env = std::getenv("TRANSFORM_SIZE_POLICY");
+        if (size_policy_env) {
+            config.size_ladder.policy = SizeLadder::parsePolicy(size_policy_env);
+        }
+
+        const char* size_ladder_env = std::getenv("TRANSFORM_SIZE_LADDER");
+        config.size_ladder.sizes = SizeLadder::parseSizes(
+            size_ladder_env ? size_ladder_env : "64,128,160,240,320,480,640,800,960,1280,1600,1920,2560,3840");
+
+        config.governor = GovernorConfig::fromEnvironment();
+        config.tiles = TileConfig::fromEnvironment();
+        config.ingest = IngestConfig::fromEnvironment();
+        config.render_jobs = RenderJobConfig::fromEnvironment();
+
+        return config;
+    }
+
+    // libvips threads per transform so that workers x vips threads ~= cores
+    int effectiveVipsConcurrency() const {
+        if (vips_concurrency > 0) {
+            return vips_concurrency;
+        }
+        return std::max(1, hardwareThreads() / std::max(1, worker_threads));
+    }
+
+    // CPUs the process may use: the cgroup CPU quota when there is one, not the host's cores
+    static int hardwareThreads() {
+        return utils::ContainerLimits::current().cpus();
+    }
+};
+
+} // namespace gara
+
+#endif // GARA_TRANSFORM_CONFIG_H
@@ -0,0 +1,48 @@
+#ifndef GARA_WARMUP_CONFIG_H
+#define GARA_WARMUP_CONFIG_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <string>
+
+namespace gara {
+
+struct WarmupConfig {
+    std::string snapshot_path;       // Hot-set snapshot file, ideally on a volume shared across deploys (empty disables)
+    int snapshot_interval_seconds;   // How often the running service rewrites the snapshot
+    size_t max_entries;              // Cap per section (renditions, raw keys, albums)
+
+    // Default constructor with sensible defaults
+    WarmupConfig()
+        : snapshot_interval_seconds(300),
+          max_entries(5000) {}
+
+    bool isEnabled() const { return !snapshot_path.empty(); }
+
+    // Factory method to create config from environment variables
+    static WarmupConfig fromEnvironment() {
+        WarmupConfig config;
+
+        const char* path_env = std::getenv("WARMUP_SNAPSHOT_PATH");
+        if (path_env) {
+            config.snapshot_path = path_env;
+        }
+
+        const char* interval_env = std::getenv("WARMUP_SNAPSHOT_INTERVAL_SECONDS");
+        if (interval_env) {
+            config.snapshot_interval_seconds = std::max(1, std::atoi(interval_env));
+        }
+
+        const char* entries_env = std::getenv("WARMUP_MAX_ENTRIES");
+        if (entries_env) {
+            config.max_entries = std::strtoull(entries_env, nullptr, 10);
+        }
+
+        return config;
+    }
+};
+
+} // namespace gara
+
+#endif // GARA_WARMUP_CONFIG_H
@@ -0,0 +1,110 @@
+#include "album_cache.h"
+#include "../utils/metrics.h"
+
+namespace gara {
+
+namespace {
+
+CounterMetric album_hits("AlbumCacheOperations", {{"operation", "get"}, {"status", "hit"}});
+CounterMetric album_misses("AlbumCacheOperations", {{"operation", "get"}, {"status", "miss"}});
+CounterMetric listing_hits("AlbumCacheOperations", {{"operation", "list"}, {"status", "hit"}});
+CounterMetric listing_misses("AlbumCacheOperations", {{"operation", "list"}, {"status", "miss"}});
+
+// Approximate heap footprint, charged against the byte budget
+size_t albumCost(const Album& album) {
+    size_t cost = sizeof(Album) + album.album_id.size() + album.name.size() +
+                  album.description.size() + album.cover_image_id.size();
+    for (const auto& image_id : album.image_ids) {
+        cost += sizeof(std::string) + image_id.size();
+    }
+    for (const auto& tag : album.tags) {
+        cost += sizeof(std::string) + tag.size();
+    }
+    return cost;
+}
+
+} // anonymous namespace
+
+AlbumCache::AlbumCache(const AlbumCacheConfig& config)
+    : ttl_(config.ttl_seconds),
+      albums_(config.isEnabled() ? config.max_bytes : 0, ttl_) {}
+
+uint64_t AlbumCache::version() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return version_;
+}
+
+std::shared_ptr<const Album> AlbumCache::getAlbum(const std::string& album_id) {
+    if (!enabled()) {
+        return nullptr;
+    }
+    auto cached = albums_.get(album_id);
+    if (!cached) {
+        album_misses.add();
+        return nullptr;
+    }
+    album_hits.add();
+    return *cached;
+}
+
+void AlbumCache::putAlbum(std::shared_ptr<const Album> album, uint64_t read_version) {
+    if (!enabled() || !album) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (read_version != version_) {
+        return;
+    }
+    size_t cost = albumCost(*album);
+    std::string album_id = album->album_id;
+    albums_.put(album_id, std::move(album), cost);
+}
+
+std::shared_ptr<const AlbumCache::Listing> AlbumCache::getListing(bool published_only) {
+    if (!enabled()) {
+        return nullptr;
+    }
+    std::shared_ptr<const Listing> listing;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const ListingSlot& slot = listings_[published_only ? 1 : 0];
+        if (slot.listing && std::chrono::steady_clock::now() < slot.expires_at) {
+            listing = slot.listing;
+        }
+    }
+    (listing ? listing_hits : listing_misses).add();
+    return listing;
+}
+
+void AlbumCache::putListing(bool published_only, std::shared_ptr<const Listing> listing,
+                            uint64_t read_version) {
+    if (!enabled() || !listing) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (read_version != version_) {
+        return;
+    }
+    ListingSlot& slot = listings_[published_only ? 1 : 0];
+    slot.listing = std::move(listing);
+    slot.expires_at = std::chrono::steady_clock::now() + ttl_;
+}
+
+std::vector<std::string> AlbumCache::albumIds(size_t limit) const {
+    std::vector<std::string> ids;
+    for (auto& entry : albums_.snapshot(limit)) {
+        ids.push_back(std::move(entry.first));
+    }
+    return ids;
+}
+
+void AlbumCache::invalidate(const std::string& album_id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++version_;
+    for (auto& slot : listings_) {
+        slot.listing.reset();
+    }
+    albums_.erase(album_id);
+}
+
+} // namespace gara
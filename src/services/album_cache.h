@@ -0,0 +1,78 @@
+#ifndef GARA_ALBUM_CACHE_H
+#define GARA_ALBUM_CACHE_H
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "../models/album.h"
+#include "../models/album_cache_config.h"
+#include "../utils/lru_cache.h"
+
+namespace gara {
+
+/**
+ * @brief Read-through cache for album reads
+ *
+ * Holds single albums by ID and the two listAlbums results (all and
+ * published only). Each listing also carries its serialized response body, so
+ * a hit on the gallery home page skips both the database and serialization.
+ *
+ * Every write made through AlbumService calls invalidate(), which bumps a
+ * version. A reader takes version() before going to the database and passes
+ * it to put*(). If a write landed in between, the put is dropped, so a read
+ * that raced with a write never caches the old rows. Writes from other
+ * instances are not seen here; the TTL bounds how stale they can get.
+ */
+class AlbumCache {
+public:
+    struct Listing {
+        std::vector<Album> albums;
+        std::string body;  // {"albums":[...]}
+        std::string etag;  // Strong tag derived from body
+    };
+
+    explicit AlbumCache(const AlbumCacheConfig& config);
+
+    AlbumCache(const AlbumCache&) = delete;
+    AlbumCache& operator=(const AlbumCache&) = delete;
+
+    bool enabled() const { return albums_.enabled(); }
+
+    // Version to pass to put*() for data about to be read from the database
+    uint64_t version() const;
+
+    std::shared_ptr<const Album> getAlbum(const std::string& album_id);
+    void putAlbum(std::shared_ptr<const Album> album, uint64_t read_version);
+
+    std::shared_ptr<const Listing> getListing(bool published_only);
+    void putListing(bool published_only, std::shared_ptr<const Listing> listing, uint64_t read_version);
+
+    // Cached album IDs, most recently used first, for a hot-set snapshot
+    std::vector<std::string> albumIds(size_t limit) const;
+
+    // Drop the album and both listings; call after the database write succeeds
+    void invalidate(const std::string& album_id);
+
+private:
+    struct ListingSlot {
+        std::shared_ptr<const Listing> listing;
+        std::chrono::steady_clock::time_point expires_at;
+    };
+
+    std::chrono::seconds ttl_;
+
+    // Guards version_ and listings_; put*() check the version under it so a
+    // stale read cannot slip in after an invalidation
+    mutable std::mutex mutex_;
+    uint64_t version_ = 0;
+    ListingSlot listings_[2];  // [published_only]
+
+    utils::ShardedLruCache<std::shared_ptr<const Album>> albums_;
+};
+
+} // namespace gara
+
+#endif // GARA_ALBUM_CACHE_H
@@ -1,34 +1,109 @@
 #include "album_service.h"
 #include "../interfaces/file_service_interface.h"
-#include "../constants/album_constants.h"
 #include "../exceptions/album_exceptions.h"
+#include "../utils/file_utils.h"
 #include "../utils/id_generator.h"
+#include "../utils/json_writer.h"
 #include "../utils/logger.h"
 #include "../utils/metrics.h"
 #include <stdexcept>
 #include <algorithm>
+#include <unordered_set>
 
 namespace gara {
 
+namespace {
+
+std::string serializeAlbumList(const std::vector<Album>& albums) {
+    size_t estimate = 16;
+    for (const auto& album : albums) {
+        estimate += 256 + album.name.size() + album.description.size() +
+                    album.image_ids.size() * 67 + album.tags.size() * 24;
+    }
+    std::string body;
+    body.reserve(estimate);
+
+    utils::JsonWriter writer(body);
+    writer.beginObject();
+    writer.key("albums");
+    writer.beginArray();
+    for (const auto& album : albums) {
+        album.writeJson(writer);
+    }
+    writer.endArray();
+    writer.endObject();
+    return body;
+}
+
+// Strong tag for a serialized listing; identical bodies share it across instances
+std::string bodyETag(const std::string& body) {
+    utils::Sha256Hasher hasher;
+    hasher.update(body.data(), body.size());
+    std::string digest = hasher.finalizeHex();
+    return "\"" + digest.substr(0, 32) + "\"";
+}
+
+} // anonymous namespace
+
 AlbumService::AlbumService(std::shared_ptr<DatabaseClientInterface> db_client,
-                           std::shared_ptr<FileServiceInterface> file_service)
-    : db_client_(db_client), file_service_(file_service) {
+                           std::shared_ptr<FileServiceInterface> file_service,
+                           std::shared_ptr<RawKeyResolver> raw_key_resolver,
+                           std::shared_ptr<AlbumCache> cache)
+    : db_client_(db_client), file_service_(file_service), raw_key_resolver_(raw_key_resolver),
+      cache_(cache) {
+    if (!raw_key_resolver_ && file_service_) {
+        raw_key_resolver_ = std::make_shared<RawKeyResolver>(db_client_, file_service_);
+    }
 }
 
 bool AlbumService::validateImageExists(const std::string& image_id) {
+    return findMissingImages({image_id}).empty();
+}
+
+std::vector<std::string> AlbumService::findMissingImages(const std::vector<std::string>& image_ids) {
     if (!file_service_) {
         // If no file service provided (e.g., in tests), skip validation
-        return true;
+        return {};
     }
 
-    // Try common image formats
-    for (const auto& format : constants::SUPPORTED_IMAGE_FORMATS) {
-        std::string key = "raw/" + image_id + "." + format;
-        if (file_service_->objectExists(key)) {
-            return true;
+    // One query settles every image with metadata; the rest are probed in
+    // storage together rather than one image at a time
+    std::unordered_set<std::string> known = db_client_->imagesExist(image_ids);
+
+    std::vector<std::string> unknown;
+    for (const auto& image_id : image_ids) {
+        if (!known.count(image_id)) {
+            unknown.push_back(image_id);
         }
     }
-    return false;
+    if (unknown.empty()) {
+        return {};
+    }
+
+    std::vector<std::string> raw_keys = raw_key_resolver_->resolveAll(unknown);
+    std::vector<std::string> missing;
+    for (size_t i = 0; i < unknown.size(); ++i) {
+        if (raw_keys[i].empty()) {
+            missing.push_back(unknown[i]);
+        }
+    }
+    return missing;
+}
+
+std::unordered_set<std::string> AlbumService::albumMembers(const std::string& album_id,
+                                                           const std::vector<std::string>& image_ids,
+                                                           const std::string& operation) {
+    auto members = db_client_->albumImagesContained(album_id, image_ids);
+    if (!members) {
+        gara::Logger::log_structured(spdlog::level::err, "Failed to check album membership", {
+            {"operation", operation},
+            {"album_id", album_id}
+        });
+        METRICS_COUNT("AlbumOperations", 1.0, "Count",
+                     {{"operation", "membership_check"}, {"status", "error"}});
+        throw std::runtime_error("Failed to check album membership");
+    }
+    return std::move(*members);
 }
 
 Album AlbumService::createAlbum(const CreateAlbumRequest& request) {
@@ -78,6 +153,9 @@ Album AlbumService::createAlbum(const CreateAlbumRequest& request) {
                      {{"operation", "create"}, {"status", "error"}});
         throw std::runtime_error("Failed to create album");
     }
+    if (cache_) {
+        cache_->invalidate(album.album_id);
+    }
 
     gara::Logger::log_structured(spdlog::level::info, "Album created successfully", {
         {"operation", "createAlbum"},
@@ -94,6 +172,15 @@ Album AlbumService::getAlbum(const std::string& album_id) {
     auto timer = gara::Metrics::get()->start_timer("AlbumOperationDuration",
                                                    {{"operation", "get"}});
 
+    if (cache_) {
+        if (auto cached = cache_->getAlbum(album_id)) {
+            METRICS_COUNT("AlbumOperations", 1.0, "Count",
+                         {{"operation", "get"}, {"status", "success"}});
+            return *cached;
+        }
+    }
+
+    uint64_t cache_version = cache_ ? cache_->version() : 0;
     auto album_opt = db_client_->getAlbum(album_id);
 
     if (!album_opt) {
@@ -106,16 +193,54 @@ Album AlbumService::getAlbum(const std::string& album_id) {
         throw exceptions::NotFoundException("Album not found: " + album_id);
     }
 
+    if (cache_) {
+        cache_->putAlbum(std::make_shared<const Album>(*album_opt), cache_version);
+    }
+
     METRICS_COUNT("AlbumOperations", 1.0, "Count",
                  {{"operation", "get"}, {"status", "success"}});
     return *album_opt;
 }
 
+AlbumImagePage AlbumService::listAlbumImages(const std::string& album_id, int limit, int offset) {
+    auto timer = gara::Metrics::get()->start_timer("AlbumOperationDuration",
+                                                   {{"operation", "list_images"}});
+
+    // Album fields only; the page is read separately below
+    auto album_opt = db_client_->getAlbum(album_id, false);
+    if (!album_opt) {
+        gara::Logger::log_structured(spdlog::level::warn, "List album images failed: album not found", {
+            {"operation", "listAlbumImages"},
+            {"album_id", album_id}
+        });
+        METRICS_COUNT("AlbumOperations", 1.0, "Count",
+                     {{"operation", "list_images"}, {"status", "not_found"}});
+        throw exceptions::NotFoundException("Album not found: " + album_id);
+    }
+
+    AlbumImagePage page;
+    page.album = *album_opt;
+    page.album.image_ids = db_client_->listAlbumImages(album_id, limit, offset);
+    page.total = db_client_->getAlbumImageCount(album_id);
+    page.limit = limit;
+    page.offset = offset;
+
+    METRICS_COUNT("AlbumOperations", 1.0, "Count",
+                 {{"operation", "list_images"}, {"status", "success"}});
+    return page;
+}
+
+std::unordered_map<std::string, std::string> AlbumService::getPlaceholders(
+    const std::vector<std::string>& image_ids) {
+    return db_client_->getImagePlaceholders(image_ids);
+}
+
 std::vector<Album> AlbumService::listAlbums(bool published_only) {
     auto timer = gara::Metrics::get()->start_timer("AlbumOperationDuration",
                                                    {{"operation", "list"}});
 
-    auto albums = db_client_->listAlbums(published_only);
+    std::vector<Album> albums = cache_ ? readListing(published_only)->albums
+                                       : db_client_->listAlbums(published_only);
 
     gara::Logger::log_structured(spdlog::level::debug, "Albums listed", {
         {"operation", "listAlbums"},
@@ -129,6 +254,83 @@ std::vector<Album> AlbumService::listAlbums(bool published_only) {
     return albums;
 }
 
+std::shared_ptr<const AlbumCache::Listing> AlbumService::listAlbumsJson(bool published_only) {
+    auto timer = gara::Metrics::get()->start_timer("AlbumOperationDuration",
+                                                   {{"operation", "list"}});
+
+    auto listing = readListing(published_only);
+
+    METRICS_COUNT("AlbumOperations", 1.0, "Count",
+                 {{"operation", "list"}, {"status", "success"}});
+
+    return listing;
+}
+
+AlbumListPage AlbumService::listAlbumsPage(const AlbumQuery& query, int limit,
+                                           const std::optional<AlbumPageCursor>& after) {
+    auto timer = gara::Metrics::get()->start_timer("AlbumOperationDuration",
+                                                   {{"operation", "list_page"}});
+
+    // One extra row tells whether another page follows
+    AlbumListPage page;
+    page.albums = db_client_->listAlbumsAfter(query, limit + 1, after);
+    if (page.albums.size() > static_cast<size_t>(limit)) {
+        page.albums.resize(limit);
+        page.next = AlbumPageCursor::fromAlbum(page.albums.back());
+    }
+
+    gara::Logger::log_structured(spdlog::level::debug, "Album page listed", {
+        {"operation", "listAlbumsPage"},
+        {"count", std::to_string(page.albums.size())},
+        {"tags", std::to_string(query.tags.size())},
+        {"published_only", query.published_only ? "true" : "false"}
+    });
+
+    METRICS_COUNT("AlbumOperations", 1.0, "Count",
+                 {{"operation", "list_page"}, {"status", "success"}});
+
+    return page;
+}
+
+size_t AlbumService::warmCache(const std::vector<std::string>& album_ids) {
+    if (!cache_) {
+        return 0;
+    }
+
+    readListing(false);
+    readListing(true);
+
+    size_t loaded = 0;
+    for (const auto& album_id : album_ids) {
+        try {
+            getAlbum(album_id);
+            ++loaded;
+        } catch (const exceptions::NotFoundException&) {
+            // Deleted since the snapshot was written
+        }
+    }
+    return loaded;
+}
+
+std::shared_ptr<const AlbumCache::Listing> AlbumService::readListing(bool published_only) {
+    if (cache_) {
+        if (auto cached = cache_->getListing(published_only)) {
+            return cached;
+        }
+    }
+
+    uint64_t cache_version = cache_ ? cache_->version() : 0;
+    auto listing = std::make_shared<AlbumCache::Listing>();
+    listing->albums = db_client_->listAlbums(published_only);
+    listing->body = serializeAlbumList(listing->albums);
+    listing->etag = bodyETag(listing->body);
+
+    if (cache_) {
+        cache_->putListing(published_only, listing, cache_version);
+    }
+    return listing;
+}
+
 Album AlbumService::updateAlbum(const std::string& album_id, const UpdateAlbumRequest& request) {
     auto timer = gara::Metrics::get()->start_timer("AlbumOperationDuration",
                                                    {{"operation", "update"}});
@@ -199,6 +401,9 @@ Album AlbumService::updateAlbum(const std::string& album_id, const UpdateAlbumRe
                      {{"operation", "update"}, {"status", "error"}});
         throw std::runtime_error("Failed to update album");
     }
+    if (cache_) {
+        cache_->invalidate(album_id);
+    }
 
     gara::Logger::log_structured(spdlog::level::info, "Album updated successfully", {
         {"operation", "updateAlbum"},
@@ -228,6 +433,9 @@ bool AlbumService::deleteAlbum(const std::string& album_id) {
 
     // Delete from database
     bool success = db_client_->deleteAlbum(album_id);
+    if (success && cache_) {
+        cache_->invalidate(album_id);
+    }
 
     if (success) {
         gara::Logger::log_structured(spdlog::level::info, "Album deleted successfully", {
@@ -263,8 +471,8 @@ Album AlbumService::addImages(const std::string& album_id, const AddImagesReques
         throw std::runtime_error("Image IDs list cannot be empty");
     }
 
-    // Get existing album
-    auto album_opt = db_client_->getAlbum(album_id);
+    // Existence check only; the membership is checked by key below
+    auto album_opt = db_client_->getAlbum(album_id, false);
     if (!album_opt) {
         gara::Logger::log_structured(spdlog::level::warn, "Add images failed: album not found", {
             {"operation", "addImages"},
@@ -278,20 +486,23 @@ Album AlbumService::addImages(const std::string& album_id, const AddImagesReques
     Album album = *album_opt;
 
     // Validate all new image IDs exist and are not duplicates
-    for (const auto& image_id : request.image_ids) {
-        if (!validateImageExists(image_id)) {
-            gara::Logger::log_structured(spdlog::level::warn, "Add images failed: image not found", {
-                {"operation", "addImages"},
-                {"album_id", album_id},
-                {"image_id", image_id}
-            });
-            METRICS_COUNT("AlbumOperations", 1.0, "Count",
-                         {{"operation", "add_images"}, {"status", "validation_error"}});
-            throw exceptions::ValidationException("Image not found: " + image_id);
-        }
+    std::vector<std::string> missing = findMissingImages(request.image_ids);
+    if (!missing.empty()) {
+        gara::Logger::log_structured(spdlog::level::warn, "Add images failed: image not found", {
+            {"operation", "addImages"},
+            {"album_id", album_id},
+            {"image_id", missing.front()},
+            {"missing_count", std::to_string(missing.size())}
+        });
+        METRICS_COUNT("AlbumOperations", 1.0, "Count",
+                     {{"operation", "add_images"}, {"status", "validation_error"}});
+        throw exceptions::ValidationException("Image not found: " + missing.front());
+    }
 
-        // Check for duplicates in the album
-        if (std::find(album.image_ids.begin(), album.image_ids.end(), image_id) != album.image_ids.end()) {
+    std::unordered_set<std::string> members = albumMembers(album_id, request.image_ids, "addImages");
+    for (const auto& image_id : request.image_ids) {
+        // Check for duplicates in the album (or earlier in this request)
+        if (!members.insert(image_id).second) {
             gara::Logger::log_structured(spdlog::level::warn, "Add images failed: duplicate image", {
                 {"operation", "addImages"},
                 {"album_id", album_id},
@@ -303,25 +514,10 @@ Album AlbumService::addImages(const std::string& album_id, const AddImagesReques
         }
     }
 
-    // Add images at specified position or append (position=-1 means append)
-    if (request.position >= 0 && request.position <= static_cast<int>(album.image_ids.size())) {
-        album.image_ids.insert(
-            album.image_ids.begin() + request.position,
-            request.image_ids.begin(),
-            request.image_ids.end()
-        );
-    } else {
-        album.image_ids.insert(
-            album.image_ids.end(),
-            request.image_ids.begin(),
-            request.image_ids.end()
-        );
-    }
-
     album.updated_at = std::time(nullptr);
 
-    // Save updated album
-    if (!db_client_->putAlbum(album)) {
+    // Save only the new membership rows
+    if (!db_client_->addAlbumImages(album_id, request.image_ids, request.position, album.updated_at)) {
         gara::Logger::log_structured(spdlog::level::err, "Failed to add images to album", {
             {"operation", "addImages"},
             {"album_id", album_id}
@@ -330,6 +526,12 @@ Album AlbumService::addImages(const std::string& album_id, const AddImagesReques
                      {{"operation", "add_images"}, {"status", "error"}});
         throw std::runtime_error("Failed to add images to album");
     }
+    if (cache_) {
+        cache_->invalidate(album_id);
+    }
+
+    // The response carries the whole membership in its new order
+    album.image_ids = db_client_->listAlbumImages(album_id, -1, 0);
 
     gara::Logger::log_structured(spdlog::level::info, "Images added to album successfully", {
         {"operation", "addImages"},
@@ -346,8 +548,8 @@ Album AlbumService::removeImage(const std::string& album_id, const std::string&
     auto timer = gara::Metrics::get()->start_timer("AlbumOperationDuration",
                                                    {{"operation", "remove_image"}});
 
-    // Get existing album
-    auto album_opt = db_client_->getAlbum(album_id);
+    // Existence check only; the membership is checked by key below
+    auto album_opt = db_client_->getAlbum(album_id, false);
     if (!album_opt) {
         gara::Logger::log_structured(spdlog::level::warn, "Remove image failed: album not found", {
             {"operation", "removeImage"},
@@ -361,8 +563,7 @@ Album AlbumService::removeImage(const std::string& album_id, const std::string&
     Album album = *album_opt;
 
     // Find and remove the image
-    auto it = std::find(album.image_ids.begin(), album.image_ids.end(), image_id);
-    if (it == album.image_ids.end()) {
+    if (albumMembers(album_id, {image_id}, "removeImage").empty()) {
         gara::Logger::log_structured(spdlog::level::warn, "Remove image failed: image not in album", {
             {"operation", "removeImage"},
             {"album_id", album_id},
@@ -373,11 +574,10 @@ Album AlbumService::removeImage(const std::string& album_id, const std::string&
         throw exceptions::ValidationException("Image not found in album: " + image_id);
     }
 
-    album.image_ids.erase(it);
     album.updated_at = std::time(nullptr);
 
-    // Save updated album
-    if (!db_client_->putAlbum(album)) {
+    // Delete only the membership row
+    if (!db_client_->removeAlbumImage(album_id, image_id, album.updated_at)) {
         gara::Logger::log_structured(spdlog::level::err, "Failed to remove image from album", {
             {"operation", "removeImage"},
             {"album_id", album_id},
@@ -387,6 +587,12 @@ Album AlbumService::removeImage(const std::string& album_id, const std::string&
                      {{"operation", "remove_image"}, {"status", "error"}});
         throw std::runtime_error("Failed to remove image from album");
     }
+    if (cache_) {
+        cache_->invalidate(album_id);
+    }
+
+    // The response carries the remaining membership
+    album.image_ids = db_client_->listAlbumImages(album_id, -1, 0);
 
     gara::Logger::log_structured(spdlog::level::info, "Image removed from album successfully", {
         {"operation", "removeImage"},
@@ -403,8 +609,8 @@ Album AlbumService::reorderImages(const std::string& album_id, const ReorderImag
     auto timer = gara::Metrics::get()->start_timer("AlbumOperationDuration",
                                                    {{"operation", "reorder_images"}});
 
-    // Get existing album
-    auto album_opt = db_client_->getAlbum(album_id);
+    // Existence check only; the new order is checked by count and key below
+    auto album_opt = db_client_->getAlbum(album_id, false);
     if (!album_opt) {
         gara::Logger::log_structured(spdlog::level::warn, "Reorder images failed: album not found", {
             {"operation", "reorderImages"},
@@ -418,11 +624,12 @@ Album AlbumService::reorderImages(const std::string& album_id, const ReorderImag
     Album album = *album_opt;
 
     // Validate new order has same images
-    if (request.image_ids.size() != album.image_ids.size()) {
+    int image_count = db_client_->getAlbumImageCount(album_id);
+    if (request.image_ids.size() != static_cast<size_t>(image_count)) {
         gara::Logger::log_structured(spdlog::level::warn, "Reorder images failed: size mismatch", {
             {"operation", "reorderImages"},
             {"album_id", album_id},
-            {"expected", std::to_string(album.image_ids.size())},
+            {"expected", std::to_string(image_count)},
             {"provided", std::to_string(request.image_ids.size())}
         });
         METRICS_COUNT("AlbumOperations", 1.0, "Count",
@@ -430,9 +637,10 @@ Album AlbumService::reorderImages(const std::string& album_id, const ReorderImag
         throw exceptions::ValidationException("New order must contain all existing images");
     }
 
-    // Validate all images are present
+    // Validate all images are present, each exactly once
+    std::unordered_set<std::string> members = albumMembers(album_id, request.image_ids, "reorderImages");
     for (const auto& image_id : request.image_ids) {
-        if (std::find(album.image_ids.begin(), album.image_ids.end(), image_id) == album.image_ids.end()) {
+        if (members.erase(image_id) == 0) {
             gara::Logger::log_structured(spdlog::level::warn, "Reorder images failed: unknown image", {
                 {"operation", "reorderImages"},
                 {"album_id", album_id},
@@ -447,8 +655,8 @@ Album AlbumService::reorderImages(const std::string& album_id, const ReorderImag
     album.image_ids = request.image_ids;
     album.updated_at = std::time(nullptr);
 
-    // Save updated album
-    if (!db_client_->putAlbum(album)) {
+    // Rewrite positions only
+    if (!db_client_->reorderAlbumImages(album_id, album.image_ids, album.updated_at)) {
         gara::Logger::log_structured(spdlog::level::err, "Failed to reorder images in album", {
             {"operation", "reorderImages"},
             {"album_id", album_id}
@@ -457,6 +665,9 @@ Album AlbumService::reorderImages(const std::string& album_id, const ReorderImag
                      {{"operation", "reorder_images"}, {"status", "error"}});
         throw std::runtime_error("Failed to reorder images in album");
     }
+    if (cache_) {
+        cache_->invalidate(album_id);
+    }
 
     gara::Logger::log_structured(spdlog::level::info, "Images reordered successfully", {
         {"operation", "reorderImages"},
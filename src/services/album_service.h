@@ -2,30 +2,68 @@
 #define GARA_ALBUM_SERVICE_H
 
 #include <memory>
+#include <optional>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 #include "../models/album.h"
 #include "../interfaces/database_client_interface.h"
+#include "album_cache.h"
+#include "raw_key_resolver.h"
 
 namespace gara {
 
 // Forward declaration
 class FileServiceInterface;
 
+/**
+ * @brief One page of an album's images
+ *
+ * album carries the album fields with image_ids holding only this page.
+ */
+struct AlbumImagePage {
+    Album album;
+    int total = 0;   // Images in the whole album
+    int limit = 0;
+    int offset = 0;
+};
+
+/**
+ * @brief One page of a filtered album listing
+ */
+struct AlbumListPage {
+    std::vector<Album> albums;
+    std::optional<AlbumPageCursor> next;  // Set when another page follows
+};
+
 class AlbumService {
 public:
     /**
      * @brief Constructor with database client injection
      * @param db_client Database client interface (for dependency injection)
      * @param file_service Optional file service for image validation
+     * @param raw_key_resolver Optional shared resolver (one is created if omitted)
+     * @param cache Optional read-through cache for getAlbum and listAlbums
      */
     AlbumService(std::shared_ptr<DatabaseClientInterface> db_client,
-                 std::shared_ptr<FileServiceInterface> file_service = nullptr);
+                 std::shared_ptr<FileServiceInterface> file_service = nullptr,
+                 std::shared_ptr<RawKeyResolver> raw_key_resolver = nullptr,
+                 std::shared_ptr<AlbumCache> cache = nullptr);
 
     // CRUD operations
     Album createAlbum(const CreateAlbumRequest& request);
     Album getAlbum(const std::string& album_id);
     std::vector<Album> listAlbums(bool published_only = false);
+    // listAlbums() serialized as {"albums":[...]} with its ETag; served from the cache without re-serializing
+    std::shared_ptr<const AlbumCache::Listing> listAlbumsJson(bool published_only = false);
+    // Albums matching query, newest first, a page at a time; read from the
+    // album_tags index and never cached
+    AlbumListPage listAlbumsPage(const AlbumQuery& query, int limit,
+                                 const std::optional<AlbumPageCursor>& after);
+    // Read albums and both listings through the cache; unknown IDs are skipped.
+    // Returns how many albums were loaded (0 without a cache)
+    size_t warmCache(const std::vector<std::string>& album_ids);
     Album updateAlbum(const std::string& album_id, const UpdateAlbumRequest& request);
     bool deleteAlbum(const std::string& album_id);
 
@@ -33,13 +71,32 @@ public:
     Album addImages(const std::string& album_id, const AddImagesRequest& request);
     Album removeImage(const std::string& album_id, const std::string& image_id);
     Album reorderImages(const std::string& album_id, const ReorderImagesRequest& request);
+    AlbumImagePage listAlbumImages(const std::string& album_id, int limit, int offset);
+
+    // Loading placeholders (BlurHash) of the given images, in one query;
+    // images without one are left out
+    std::unordered_map<std::string, std::string> getPlaceholders(const std::vector<std::string>& image_ids);
 
 private:
     std::shared_ptr<DatabaseClientInterface> db_client_;
     std::shared_ptr<FileServiceInterface> file_service_;
+    std::shared_ptr<RawKeyResolver> raw_key_resolver_;
+    std::shared_ptr<AlbumCache> cache_;
+
+    // Helper: Listing from the cache, or read and serialized on a miss
+    std::shared_ptr<const AlbumCache::Listing> readListing(bool published_only);
 
     // Helper: Validate image exists in storage
     bool validateImageExists(const std::string& image_id);
+
+    // Helper: Image IDs that exist neither in the database nor in storage
+    std::vector<std::string> findMissingImages(const std::vector<std::string>& image_ids);
+
+    // Helper: which of image_ids are in the album; throws if the lookup fails,
+    // so a database error is never mistaken for an answer
+    std::unordered_set<std::string> albumMembers(const std::string& album_id,
+                                                 const std::vector<std::string>& image_ids,
+                                                 const std::string& operation);
 };
 
 } // namespace gara
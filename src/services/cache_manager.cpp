@@ -2,28 +2,238 @@
 #include "../utils/file_utils.h"
 #include "../utils/logger.h"
 #include "../utils/metrics.h"
+#include "../utils/prometheus_registry.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <future>
 
 namespace gara {
 
-CacheManager::CacheManager(std::shared_ptr<FileServiceInterface> file_service)
-    : file_service_(file_service) {
+namespace {
+// Approximate per-entry bookkeeping (list node, index slot, shared_ptr control block)
+constexpr size_t MEMORY_ENTRY_OVERHEAD_BYTES = 128;
+
+// Delay before the second write-behind attempt; doubles for each retry
+constexpr std::chrono::milliseconds WRITE_BEHIND_RETRY_BASE(100);
+
+PrometheusRegistry::Gauge& pendingUploadsGauge() {
+    static auto& gauge = PrometheusRegistry::instance().gauge(
+        "gara_cache_write_behind_pending", "Rendition uploads queued or in progress");
+    return gauge;
+}
+}
+
+CacheManager::PendingUpload::~PendingUpload() {
+    if (!spool_path.empty()) {
+        std::remove(spool_path.c_str());
+    }
+}
+
+CacheManager::CacheManager(std::shared_ptr<FileServiceInterface> file_service,
+                           const CacheConfig& config,
+                           std::shared_ptr<DatabaseClientInterface> db_client)
+    : file_service_(file_service),
+      config_(config),
+      memory_cache_(config.memory_max_bytes,
+                    std::chrono::seconds(config.memory_ttl_seconds),
+                    static_cast<size_t>(std::max(config.memory_shards, 1))) {
+    if (db_client) {
+        index_ = std::make_unique<TransformIndex>(db_client, file_service_, config_,
+            [this](const std::string& storage_key) { memory_cache_.erase(storage_key); });
+    }
+    if (config_.write_behind) {
+        for (int i = 0; i < std::max(config_.write_behind_workers, 1); ++i) {
+            upload_workers_.emplace_back(&CacheManager::uploadWorkerLoop, this);
+        }
+    }
+}
+
+CacheManager::~CacheManager() {
+    {
+        std::lock_guard<std::mutex> lock(pending_mutex_);
+        stopping_ = true;
+    }
+    pending_cv_.notify_all();
+    for (auto& worker : upload_workers_) {
+        worker.join();
+    }
 }
 
 bool CacheManager::existsInCache(const TransformRequest& request) {
-    std::string storage_key = getStorageKey(request);
-    return file_service_->objectExists(storage_key);
+    return !getCachedImage(request).empty();
 }
 
 std::string CacheManager::getCachedImage(const TransformRequest& request) {
     std::string storage_key = getStorageKey(request);
 
+    if (memory_cache_.get(storage_key)) {
+        METRICS_COUNT("CacheOperations", 1.0, "Count", {{"operation", "memory_get"}, {"status", "hit"}});
+        if (index_) {
+            index_->recordAccess(storage_key);
+        }
+        return storage_key;
+    }
+
+    if (hasPending(storage_key)) {
+        METRICS_COUNT("CacheOperations", 1.0, "Count", {{"operation", "pending_get"}, {"status", "hit"}});
+        return storage_key;
+    }
+
     if (file_service_->objectExists(storage_key)) {
+        rememberKey(storage_key);
+        if (index_) {
+            index_->recordAccess(storage_key);
+        }
         return storage_key;
     }
 
     return "";
 }
 
+std::vector<std::string> CacheManager::getCachedImages(const std::vector<TransformRequest>& requests) {
+    std::vector<std::string> keys(requests.size());
+    size_t memory_hits = 0;
+
+    for (size_t i = 0; i < requests.size(); ++i) {
+        std::string storage_key = getStorageKey(requests[i]);
+        if (memory_cache_.get(storage_key)) {
+            keys[i] = std::move(storage_key);
+            ++memory_hits;
+        }
+    }
+    if (memory_hits > 0) {
+        METRICS_COUNT("CacheOperations", static_cast<double>(memory_hits), "Count",
+                     {{"operation", "memory_get"}, {"status", "hit"}});
+    }
+
+    for (size_t i = 0; i < requests.size(); ++i) {
+        if (keys[i].empty()) {
+            std::string storage_key = getStorageKey(requests[i]);
+            if (hasPending(storage_key)) {
+                // Not remembered: the upload may still fail
+                keys[i] = std::move(storage_key);
+            } else if (file_service_->objectExists(storage_key)) {
+                rememberKey(storage_key);
+                keys[i] = std::move(storage_key);
+            }
+        }
+    }
+
+    if (index_) {
+        for (const auto& key : keys) {
+            if (!key.empty()) {
+                index_->recordAccess(key);
+            }
+        }
+    }
+    return keys;
+}
+
+std::shared_ptr<const std::vector<char>> CacheManager::getCachedData(const TransformRequest& request) {
+    std::string storage_key = getStorageKey(request);
+    auto entry = memory_cache_.get(storage_key);
+    if (entry && *entry) {
+        return *entry;
+    }
+    return getPendingData(storage_key);
+}
+
+std::shared_ptr<const std::vector<char>> CacheManager::getPendingData(const std::string& storage_key) {
+    if (!config_.write_behind) {
+        return nullptr;
+    }
+    std::shared_ptr<PendingUpload> upload;
+    {
+        std::lock_guard<std::mutex> lock(pending_mutex_);
+        auto it = pending_.find(storage_key);
+        if (it == pending_.end()) {
+            return nullptr;
+        }
+        upload = it->second;
+    }
+    if (upload->data) {
+        return upload->data;
+    }
+
+    // Spooled renditions are read back from their file, which upload keeps in place
+    std::vector<char> data(upload->size_bytes);
+    std::ifstream file(upload->spool_path, std::ios::binary);
+    if (!file.read(data.data(), static_cast<std::streamsize>(data.size()))) {
+        return nullptr;
+    }
+    return std::make_shared<const std::vector<char>>(std::move(data));
+}
+
+std::vector<bool> CacheManager::awaitUrls(const std::vector<std::string>& storage_keys) {
+    std::vector<bool> ready(storage_keys.size(), true);
+    if (!config_.write_behind || config_.pending_urls_served) {
+        return ready;
+    }
+
+    std::vector<size_t> waited;  // Keys found pending, checked again once they settle
+    {
+        std::unique_lock<std::mutex> lock(pending_mutex_);
+        for (size_t i = 0; i < storage_keys.size(); ++i) {
+            if (!storage_keys[i].empty() && pending_.count(storage_keys[i])) {
+                waited.push_back(i);
+            }
+        }
+        if (waited.empty()) {
+            return ready;
+        }
+
+        auto deadline = std::chrono::steady_clock::now() +
+                        std::chrono::milliseconds(config_.write_behind_url_wait_ms);
+        drained_cv_.wait_until(lock, deadline, [this, &storage_keys, &waited]() {
+            for (size_t i : waited) {
+                if (pending_.count(storage_keys[i])) {
+                    return false;
+                }
+            }
+            return true;
+        });
+        for (size_t i : waited) {
+            ready[i] = pending_.count(storage_keys[i]) == 0;
+        }
+    }
+
+    // A settled upload either landed (and was remembered before its entry was
+    // released) or was dropped; the probe covers a disabled or evicted memory tier
+    for (size_t i : waited) {
+        if (ready[i] && !memory_cache_.get(storage_keys[i])) {
+            ready[i] = file_service_->objectExists(storage_keys[i]);
+        }
+        if (!ready[i]) {
+            METRICS_COUNT("CacheOperations", 1.0, "Count", {{"operation", "pending_url"}, {"status", "not_ready"}});
+        }
+    }
+    return ready;
+}
+
+bool CacheManager::awaitUrl(const std::string& storage_key) {
+    return awaitUrls({storage_key}).front();
+}
+
+bool CacheManager::hasPending(const std::string& storage_key) {
+    if (!config_.write_behind) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(pending_mutex_);
+    return pending_.count(storage_key) > 0;
+}
+
+size_t CacheManager::pendingUploads() {
+    std::lock_guard<std::mutex> lock(pending_mutex_);
+    return pending_.size();
+}
+
+void CacheManager::flush() {
+    std::unique_lock<std::mutex> lock(pending_mutex_);
+    drained_cv_.wait(lock, [this]() { return pending_.empty(); });
+}
+
 bool CacheManager::storeInCache(const TransformRequest& request, const std::string& local_path) {
     auto timer = gara::Metrics::get()->start_timer("CacheDuration", {{"operation", "put"}});
 
@@ -31,34 +241,82 @@ bool CacheManager::storeInCache(const TransformRequest& request, const std::stri
     std::string content_type = utils::FileUtils::getMimeType(request.target_format);
 
     bool success = file_service_->uploadFile(local_path, storage_key, content_type);
+    size_t size_bytes = success ? utils::FileUtils::getFileSize(local_path) : 0;
+    if (success) {
+        recordStored(request, storage_key, nullptr, size_bytes);
+    }
+
+    recordStoreResult(request, storage_key, success, size_bytes);
+    return success;
+}
+
+bool CacheManager::storeInCache(const TransformRequest& request, const std::vector<char>& data) {
+    auto timer = gara::Metrics::get()->start_timer("CacheDuration", {{"operation", "put"}});
 
+    std::string storage_key = getStorageKey(request);
+    std::string content_type = utils::FileUtils::getMimeType(request.target_format);
+
+    if (config_.write_behind && !data.empty()) {
+        auto upload = std::make_shared<PendingUpload>();
+        upload->request = request;
+        upload->data = std::make_shared<const std::vector<char>>(data);
+        upload->size_bytes = data.size();
+        upload->content_type = content_type;
+        if (enqueueUpload(storage_key, std::move(upload))) {
+            METRICS_COUNT("CacheOperations", 1.0, "Count", {{"operation", "write_behind"}, {"status", "queued"}});
+            return true;
+        }
+        // Queue is full: fall back to storing inline, which also pushes back on the transform pool
+        METRICS_COUNT("CacheOperations", 1.0, "Count", {{"operation", "write_behind"}, {"status", "full"}});
+    }
+
+    bool success = !data.empty() && file_service_->uploadData(data, storage_key, content_type);
     if (success) {
-        gara::Logger::log_structured(spdlog::level::info, "Cached transformed image", {
-            {"storage_key", storage_key},
-            {"image_id", request.image_id},
-            {"format", request.target_format},
-            {"width", request.width},
-            {"height", request.height},
-            {"watermarked", request.watermarked}
-        });
-        METRICS_COUNT("CacheOperations", 1.0, "Count", {{"operation", "put"}, {"status", "success"}});
-    } else {
-        gara::Logger::log_structured(spdlog::level::err, "Failed to cache transformed image", {
-            {"storage_key", storage_key},
-            {"image_id", request.image_id},
-            {"format", request.target_format},
-            {"local_path", local_path}
-        });
-        METRICS_COUNT("CacheOperations", 1.0, "Count", {{"operation", "put"}, {"status", "failure"}});
+        recordStored(request, storage_key,
+                     data.size() <= config_.memory_max_entry_bytes
+                         ? std::make_shared<const std::vector<char>>(data) : nullptr,
+                     data.size());
     }
 
+    recordStoreResult(request, storage_key, success, data.size());
     return success;
 }
 
-std::string CacheManager::getPresignedUrl(const TransformRequest& request, int expiration_seconds) {
+bool CacheManager::moveToCache(const TransformRequest& request, const std::string& local_path) {
+    auto timer = gara::Metrics::get()->start_timer("CacheDuration", {{"operation", "put"}});
+
     std::string storage_key = getStorageKey(request);
+    std::string content_type = utils::FileUtils::getMimeType(request.target_format);
+    size_t size_bytes = utils::FileUtils::getFileSize(local_path);
+
+    if (config_.write_behind && size_bytes > 0) {
+        auto upload = std::make_shared<PendingUpload>();
+        upload->request = request;
+        upload->spool_path = local_path;
+        upload->size_bytes = size_bytes;
+        upload->content_type = content_type;
+        if (enqueueUpload(storage_key, upload)) {
+            METRICS_COUNT("CacheOperations", 1.0, "Count", {{"operation", "write_behind"}, {"status", "queued"}});
+            return true;
+        }
+        // Not queued, so the file is still the caller's
+        upload->spool_path.clear();
+        METRICS_COUNT("CacheOperations", 1.0, "Count", {{"operation", "write_behind"}, {"status", "full"}});
+    }
+
+    bool success = size_bytes > 0 && file_service_->moveFileToStorage(local_path, storage_key, content_type);
+    if (success) {
+        recordStored(request, storage_key, nullptr, size_bytes);
+    }
+
+    recordStoreResult(request, storage_key, success, size_bytes);
+    return success;
+}
+
+std::string CacheManager::getPresignedUrl(const TransformRequest& request, int expiration_seconds) {
+    std::string storage_key = getCachedImage(request);
 
-    if (!file_service_->objectExists(storage_key)) {
+    if (storage_key.empty() || !awaitUrl(storage_key)) {
         return "";
     }
 
@@ -66,31 +324,229 @@ std::string CacheManager::getPresignedUrl(const TransformRequest& request, int e
 }
 
 bool CacheManager::clearImageCache(const std::string& image_id) {
-    // In a production system, you'd want to list all objects with prefix
-    // and delete them. For now, this is a placeholder.
-    // You could use S3 ListObjectsV2 to find all transformed versions
-    gara::Logger::log_structured(spdlog::level::warn, "clearImageCache not fully implemented", {
+    // Drop every in-memory rendition of this image
+    std::string prefix = "transformed/" + image_id + "_";
+    auto has_prefix = [&prefix](const std::string& key) {
+        return key.compare(0, prefix.size(), prefix) == 0;
+    };
+    memory_cache_.eraseIf(has_prefix);
+    dropPending(has_prefix);
+
+    if (!index_) {
+        gara::Logger::log_structured(spdlog::level::warn, "clearImageCache needs the transform index", {
+            {"image_id", image_id},
+            {"operation", "clear_all_transformations"},
+            {"status", "not_implemented"}
+        });
+        METRICS_COUNT("CacheOperations", 1.0, "Count", {{"operation", "clear_all"}, {"status", "not_implemented"}});
+        return false;
+    }
+
+    std::vector<std::string> removed = index_->invalidateImage(image_id);
+    // A rendition stored while the objects were being deleted may have
+    // re-entered the memory tier, so sweep it once more
+    memory_cache_.eraseIf(has_prefix);
+
+    gara::Logger::log_structured(spdlog::level::info, "Cleared image renditions", {
         {"image_id", image_id},
-        {"operation", "clear_all_transformations"},
-        {"status", "not_implemented"}
+        {"renditions", removed.size()}
     });
-    METRICS_COUNT("CacheOperations", 1.0, "Count", {{"operation", "clear_all"}, {"status", "not_implemented"}});
-    return false;
+    METRICS_COUNT("CacheOperations", 1.0, "Count", {{"operation", "clear_all"}, {"status", "success"}});
+    return true;
 }
 
 bool CacheManager::clearTransformation(const TransformRequest& request) {
     std::string storage_key = getStorageKey(request);
-    return file_service_->deleteObject(storage_key);
+    memory_cache_.erase(storage_key);
+    bool dropped = dropPending([&storage_key](const std::string& key) { return key == storage_key; }) > 0;
+    if (index_) {
+        index_->forget(storage_key);
+    }
+    return file_service_->deleteObject(storage_key) || dropped;
+}
+
+bool CacheManager::enqueueUpload(const std::string& storage_key, std::shared_ptr<PendingUpload> upload) {
+    {
+        std::lock_guard<std::mutex> lock(pending_mutex_);
+        if (pending_.count(storage_key)) {
+            return true;  // Same rendition already on its way
+        }
+        if (stopping_ || pending_.size() >= config_.write_behind_max_pending ||
+            pending_bytes_ + upload->memoryBytes() > config_.write_behind_max_bytes) {
+            return false;
+        }
+
+        pending_bytes_ += upload->memoryBytes();
+        pending_.emplace(storage_key, std::move(upload));
+        upload_queue_.push_back(storage_key);
+    }
+    pendingUploadsGauge().inc();
+    pending_cv_.notify_one();
+    return true;
+}
+
+void CacheManager::uploadWorkerLoop() {
+    for (;;) {
+        std::string storage_key;
+        std::shared_ptr<PendingUpload> upload;
+        {
+            std::unique_lock<std::mutex> lock(pending_mutex_);
+            pending_cv_.wait(lock, [this]() { return stopping_ || !upload_queue_.empty(); });
+            if (upload_queue_.empty()) {
+                return;  // Stopping and drained
+            }
+            storage_key = std::move(upload_queue_.front());
+            upload_queue_.pop_front();
+            auto it = pending_.find(storage_key);
+            if (it == pending_.end()) {
+                continue;  // Cleared before its upload started
+            }
+            upload = it->second;
+        }
+        completeUpload(storage_key, upload);
+    }
+}
+
+void CacheManager::completeUpload(const std::string& storage_key,
+                                  const std::shared_ptr<PendingUpload>& upload) {
+    auto timer = gara::Metrics::get()->start_timer("CacheDuration", {{"operation", "put"}});
+
+    bool success = false;
+    int attempts = std::max(config_.write_behind_max_attempts, 1);
+    for (int attempt = 0; attempt < attempts && !success; ++attempt) {
+        if (attempt > 0) {
+            METRICS_COUNT("CacheOperations", 1.0, "Count", {{"operation", "write_behind"}, {"status", "retry"}});
+            std::this_thread::sleep_for(WRITE_BEHIND_RETRY_BASE * (1 << (attempt - 1)));
+        }
+        success = upload->data ? file_service_->uploadData(*upload->data, storage_key, upload->content_type)
+                               : file_service_->uploadFile(upload->spool_path, storage_key, upload->content_type);
+    }
+
+    bool cleared = false;
+    {
+        std::lock_guard<std::mutex> lock(pending_mutex_);
+        auto it = pending_.find(storage_key);
+        if (it != pending_.end() && it->second == upload) {
+            pending_.erase(it);
+            pending_bytes_ -= upload->memoryBytes();
+        } else {
+            cleared = true;
+        }
+        // Publish to the memory tier before releasing the entry, so lookups never see a gap
+        if (success && !cleared) {
+            rememberKey(storage_key, upload->size_bytes <= config_.memory_max_entry_bytes ? upload->data : nullptr);
+        } else if (!cleared) {
+            // Never landed: nothing may keep answering for it
+            memory_cache_.erase(storage_key);
+        }
+    }
+    if (!cleared) {
+        pendingUploadsGauge().dec();
+    }
+    drained_cv_.notify_all();
+
+    if (cleared) {
+        // The rendition was invalidated mid-upload; don't leave the stale copy behind
+        if (success) {
+            file_service_->deleteObject(storage_key);
+        }
+        return;
+    }
+    if (index_) {
+        if (success) {
+            index_->recordStored(storage_key, upload->request.image_id, upload->size_bytes);
+        } else {
+            index_->forget(storage_key);
+        }
+    }
+    recordStoreResult(upload->request, storage_key, success, upload->size_bytes);
+}
+
+size_t CacheManager::dropPending(const std::function<bool(const std::string&)>& matches) {
+    size_t dropped = 0;
+    {
+        std::lock_guard<std::mutex> lock(pending_mutex_);
+        for (auto it = pending_.begin(); it != pending_.end();) {
+            if (matches(it->first)) {
+                pending_bytes_ -= it->second->memoryBytes();
+                it = pending_.erase(it);
+                ++dropped;
+            } else {
+                ++it;
+            }
+        }
+    }
+    if (dropped > 0) {
+        pendingUploadsGauge().dec(static_cast<double>(dropped));
+        drained_cv_.notify_all();
+    }
+    return dropped;
+}
+
+std::vector<std::string> CacheManager::hotKeys(size_t limit) {
+    std::vector<std::string> keys;
+    for (auto& entry : memory_cache_.snapshot(limit)) {
+        keys.push_back(std::move(entry.first));
+    }
+    return keys;
+}
+
+size_t CacheManager::warmKeys(const std::vector<std::string>& storage_keys) {
+    std::vector<std::future<bool>> probes;
+    probes.reserve(storage_keys.size());
+    for (const auto& storage_key : storage_keys) {
+        probes.push_back(file_service_->objectExistsAsync(storage_key));
+    }
+
+    size_t warmed = 0;
+    for (size_t i = 0; i < storage_keys.size(); ++i) {
+        if (probes[i].get()) {
+            rememberKey(storage_keys[i]);
+            ++warmed;
+        }
+    }
+    return warmed;
+}
+
+void CacheManager::rememberKey(const std::string& storage_key,
+                               std::shared_ptr<const std::vector<char>> data) {
+    size_t cost = storage_key.size() + MEMORY_ENTRY_OVERHEAD_BYTES + (data ? data->size() : 0);
+    memory_cache_.put(storage_key, std::move(data), cost);
+}
+
+void CacheManager::recordStored(const TransformRequest& request, const std::string& storage_key,
+                                std::shared_ptr<const std::vector<char>> data, size_t size_bytes) {
+    rememberKey(storage_key, std::move(data));
+    if (index_) {
+        index_->recordStored(storage_key, request.image_id, size_bytes);
+    }
+}
+
+void CacheManager::recordStoreResult(const TransformRequest& request, const std::string& storage_key,
+                                     bool success, size_t size_bytes) {
+    if (success) {
+        LOG_STRUCTURED_SAMPLED(spdlog::level::info, "Cached transformed image", {
+            {"storage_key", storage_key},
+            {"image_id", request.image_id},
+            {"format", request.target_format},
+            {"width", request.width},
+            {"height", request.height},
+            {"watermarked", request.watermarked},
+            {"size_bytes", size_bytes}
+        });
+        METRICS_COUNT("CacheOperations", 1.0, "Count", {{"operation", "put"}, {"status", "success"}});
+    } else {
+        gara::Logger::log_structured(spdlog::level::err, "Failed to cache transformed image", {
+            {"storage_key", storage_key},
+            {"image_id", request.image_id},
+            {"format", request.target_format}
+        });
+        METRICS_COUNT("CacheOperations", 1.0, "Count", {{"operation", "put"}, {"status", "failure"}});
+    }
 }
 
 std::string CacheManager::getStorageKey(const TransformRequest& request) {
-    return ImageMetadata::generateTransformedKey(
-        request.image_id,
-        request.target_format,
-        request.width,
-        request.height,
-        request.watermarked
-    );
+    return request.getCacheKey();
 }
 
 } // namespace gara
@@ -2,41 +2,168 @@
 #define GARA_CACHE_MANAGER_H
 
 #include "../interfaces/file_service_interface.h"
+#include "../interfaces/database_client_interface.h"
 #include "../models/image_metadata.h"
+#include "../models/cache_config.h"
+#include "../utils/lru_cache.h"
+#include "transform_index.h"
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
 #include <string>
 #include <memory>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 
 namespace gara {
 
 class CacheManager {
 public:
-    explicit CacheManager(std::shared_ptr<FileServiceInterface> file_service);
-    ~CacheManager() = default;
+    // With a db_client, stored renditions are recorded in a transform index,
+    // which enables clearImageCache and budget-driven eviction
+    explicit CacheManager(std::shared_ptr<FileServiceInterface> file_service,
+                          const CacheConfig& config = CacheConfig(),
+                          std::shared_ptr<DatabaseClientInterface> db_client = nullptr);
+    // Finishes queued write-behind uploads before returning
+    ~CacheManager();
+
+    CacheManager(const CacheManager&) = delete;
+    CacheManager& operator=(const CacheManager&) = delete;
 
     // Check if transformed image exists in cache (S3)
     bool existsInCache(const TransformRequest& request);
 
     // Get transformed image from cache
     // Returns S3 key if found, empty string if not found
+    // Keys recently seen or stored are answered from memory without touching storage.
+    // A write-behind rendition counts as cached while its upload is pending, so
+    // callers handing out its storage URL must check awaitUrl() first
     std::string getCachedImage(const TransformRequest& request);
 
+    // Look up many renditions; result[i] is the key for requests[i] or empty.
+    // The memory tier answers first, so storage is only probed for the rest
+    std::vector<std::string> getCachedImages(const std::vector<TransformRequest>& requests);
+
+    // Whether the storage URL of each key can be handed out. Keys with a pending
+    // write-behind upload are waited on (up to write_behind_url_wait_ms in total)
+    // unless this process serves them from memory; false means the upload has
+    // not landed, or never will. Empty keys count as ready
+    std::vector<bool> awaitUrls(const std::vector<std::string>& storage_keys);
+    bool awaitUrl(const std::string& storage_key);
+
+    // Get encoded bytes of a small rendition held in memory
+    // Returns nullptr if the rendition is not held in memory
+    std::shared_ptr<const std::vector<char>> getCachedData(const TransformRequest& request);
+
     // Store transformed image in cache
     bool storeInCache(const TransformRequest& request, const std::string& local_path);
 
+    // Store already-encoded transformed image bytes in cache
+    // In write-behind mode this queues the upload and returns at once; the
+    // rendition counts as cached (and its bytes are served from memory) while
+    // the upload is pending. A full queue falls back to a synchronous upload
+    bool storeInCache(const TransformRequest& request, const std::vector<char>& data);
+
+    // Store a rendition encoded to a local file; local_path is consumed on
+    // success. In write-behind mode the file itself is queued, so large
+    // renditions wait for their upload on disk rather than in memory
+    bool moveToCache(const TransformRequest& request, const std::string& local_path);
+
+    // Bytes of a rendition whose write-behind upload has not landed yet
+    // Returns nullptr if no upload is pending for the storage key
+    std::shared_ptr<const std::vector<char>> getPendingData(const std::string& storage_key);
+
+    // Number of write-behind uploads queued or in progress
+    size_t pendingUploads();
+
+    // Block until every queued write-behind upload has finished
+    void flush();
+
+    // Storage keys in the memory tier, most recently used first, for a hot-set snapshot
+    std::vector<std::string> hotKeys(size_t limit);
+
+    // Seed the memory tier with keys from a hot-set snapshot. Keys are checked
+    // against storage (all probes in flight at once) and only present ones are
+    // kept; returns how many were kept
+    size_t warmKeys(const std::vector<std::string>& storage_keys);
+
     // Generate presigned URL for cached image
+    // Returns empty string if not cached or its write-behind upload has not landed
     std::string getPresignedUrl(const TransformRequest& request, int expiration_seconds = 3600);
 
     // Clear cache for specific image (all transformations)
+    // Renditions in storage are found through the transform index; without
+    // one only the memory tier is cleared and this returns false
     bool clearImageCache(const std::string& image_id);
 
+    // Transform index, or nullptr when no database was given
+    TransformIndex* transformIndex() { return index_.get(); }
+
     // Clear specific transformation from cache
     bool clearTransformation(const TransformRequest& request);
 
 private:
+    // Value is the encoded rendition, or nullptr when only presence is known
+    using MemoryCache = utils::ShardedLruCache<std::shared_ptr<const std::vector<char>>>;
+
+    struct PendingUpload {
+        TransformRequest request;
+        std::shared_ptr<const std::vector<char>> data;  // nullptr for a spooled upload
+        std::string spool_path;                         // File owned by a spooled upload
+        size_t size_bytes = 0;
+        std::string content_type;
+
+        // Bytes held in memory, which count against write_behind_max_bytes
+        size_t memoryBytes() const { return data ? size_bytes : 0; }
+
+        // Removes the spool file once the last holder lets go
+        ~PendingUpload();
+    };
+
     std::shared_ptr<FileServiceInterface> file_service_;
+    CacheConfig config_;
+    MemoryCache memory_cache_;
+
+    // Write-behind state; an entry stays in pending_ until its upload
+    // finishes, and is removed early when the rendition is cleared
+    std::mutex pending_mutex_;
+    std::condition_variable pending_cv_;   // Signals workers: work queued or stopping
+    std::condition_variable drained_cv_;   // Signals flush() and awaitUrls(): an upload finished
+    std::unordered_map<std::string, std::shared_ptr<PendingUpload>> pending_;
+    std::deque<std::string> upload_queue_;
+    size_t pending_bytes_ = 0;
+    bool stopping_ = false;
+    std::vector<std::thread> upload_workers_;
+
+    // Declared last so its evictor stops before the state it calls back into goes away
+    std::unique_ptr<TransformIndex> index_;
 
     // Generate storage key for transformed image
     std::string getStorageKey(const TransformRequest& request);
+
+    // Record a key known to be present in storage in the memory tier
+    void rememberKey(const std::string& storage_key, std::shared_ptr<const std::vector<char>> data = nullptr);
+
+    // Queue a write-behind upload; false when the queue is over its limits
+    bool enqueueUpload(const std::string& storage_key, std::shared_ptr<PendingUpload> upload);
+
+    // Whether a write-behind upload is pending for the storage key
+    bool hasPending(const std::string& storage_key);
+    void uploadWorkerLoop();
+    // Upload with retries; the pending entry is released afterwards
+    void completeUpload(const std::string& storage_key, const std::shared_ptr<PendingUpload>& upload);
+    // Drop pending uploads whose key matches; returns how many were dropped
+    size_t dropPending(const std::function<bool(const std::string&)>& matches);
+
+    // Record a successful store in the memory tier and the transform index
+    void recordStored(const TransformRequest& request, const std::string& storage_key,
+                      std::shared_ptr<const std::vector<char>> data, size_t size_bytes);
+
+    // Log and count the outcome of a cache store
+    void recordStoreResult(const TransformRequest& request, const std::string& storage_key,
+                           bool success, size_t size_bytes);
 };
 
 } // namespace gara
@@ -0,0 +1,391 @@
+#include "cached_file_service.h"
+#include "../utils/logger.h"
+#include "../utils/metrics.h"
+#include "../utils/prometheus_registry.h"
+#include <algorithm>
+#include <atomic>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+namespace gara {
+
+namespace {
+
+// Followers of an in-flight download wait this long before fetching themselves
+constexpr std::chrono::milliseconds FETCH_WAIT_TIMEOUT(60000);
+
+constexpr const char* TEMP_MARKER = ".tmp.";
+
+// Storage keys become single file names: '%' and '/' are percent-encoded
+std::string encodeKey(const std::string& key) {
+    std::string name;
+    name.reserve(key.size());
+    for (char c : key) {
+        if (c == '%') {
+            name += "%25";
+        } else if (c == '/') {
+            name += "%2F";
+        } else {
+            name += c;
+        }
+    }
+    return name;
+}
+
+std::string decodeKey(const std::string& name) {
+    std::string key;
+    key.reserve(name.size());
+    for (size_t i = 0; i < name.size(); ++i) {
+        if (name.compare(i, 3, "%2F") == 0) {
+            key += '/';
+            i += 2;
+        } else if (name.compare(i, 3, "%25") == 0) {
+            key += '%';
+            i += 2;
+        } else {
+            key += name[i];
+        }
+    }
+    return key;
+}
+
+std::atomic<uint64_t> temp_counter{0};
+
+PrometheusRegistry::Gauge& cachedBytesGauge() {
+    static auto& gauge = PrometheusRegistry::instance().gauge(
+        "gara_raw_cache_bytes", "Bytes of raw originals held in the local disk tier");
+    return gauge;
+}
+
+void countRequest(const char* status) {
+    METRICS_COUNT("RawCacheRequests", 1.0, "Count", {{"status", status}});
+}
+
+} // anonymous namespace
+
+CachedFileService::CachedFileService(std::shared_ptr<FileServiceInterface> backend,
+                                     const RawCacheConfig& config)
+    : backend_(std::move(backend)),
+      config_(config),
+      directory_(config.directory),
+      fetches_("raw_cache", FETCH_WAIT_TIMEOUT) {
+    std::filesystem::create_directories(directory_);
+    loadExisting();
+}
+
+bool CachedFileService::cacheable(const std::string& key) const {
+    return key.compare(0, config_.key_prefix.size(), config_.key_prefix) == 0;
+}
+
+std::filesystem::path CachedFileService::pathFor(const std::string& key) const {
+    return directory_ / encodeKey(key);
+}
+
+bool CachedFileService::uploadFile(const std::string& local_path, const std::string& key,
+                                   const std::string& content_type) {
+    return backend_->uploadFile(local_path, key, content_type);
+}
+
+bool CachedFileService::uploadData(const std::vector<char>& data, const std::string& key,
+                                   const std::string& content_type) {
+    if (!backend_->uploadData(data, key, content_type)) {
+        return false;
+    }
+    if (cacheable(key) && !data.empty()) {
+        store(key, data.data(), data.size());
+    }
+    return true;
+}
+
+bool CachedFileService::moveFileToStorage(const std::string& local_path, const std::string& key,
+                                          const std::string& content_type) {
+    return backend_->moveFileToStorage(local_path, key, content_type);
+}
+
+bool CachedFileService::downloadFile(const std::string& key, const std::string& local_path) {
+    if (!cacheable(key)) {
+        return backend_->downloadFile(key, local_path);
+    }
+
+    std::ifstream cached;
+    uint64_t size = 0;
+    if (openCached(key, cached, size)) {
+        std::ofstream out(local_path, std::ios::binary | std::ios::trunc);
+        if (out << cached.rdbuf()) {
+            countRequest("hit");
+            return true;
+        }
+    }
+
+    countRequest("miss");
+    if (!backend_->downloadFile(key, local_path)) {
+        return false;
+    }
+
+    // Copy into the tier through a temp file so readers never see a partial object
+    std::filesystem::path target = pathFor(key);
+    std::filesystem::path temp = target;
+    temp += TEMP_MARKER + std::to_string(temp_counter.fetch_add(1));
+    std::error_code ec;
+    std::filesystem::copy_file(local_path, temp, std::filesystem::copy_options::overwrite_existing, ec);
+    uint64_t copied = ec ? 0 : std::filesystem::file_size(temp, ec);
+    if (!ec) {
+        std::filesystem::rename(temp, target, ec);
+    }
+    if (ec) {
+        std::filesystem::remove(temp, ec);
+    } else {
+        admit(key, copied);
+    }
+    return true;
+}
+
+std::vector<char> CachedFileService::downloadData(const std::string& key) {
+    if (!cacheable(key)) {
+        return backend_->downloadData(key);
+    }
+
+    std::ifstream cached;
+    uint64_t size = 0;
+    if (openCached(key, cached, size)) {
+        std::vector<char> data(size);
+        if (cached.read(data.data(), static_cast<std::streamsize>(size))) {
+            countRequest("hit");
+            return data;
+        }
+    }
+
+    // Simultaneous misses for one original (a burst of sizes) share one download
+    bool leader = false;
+    auto shared = fetches_.run(key, [this, &key, &leader]() {
+        leader = true;
+        return fetch(key);
+    });
+    countRequest(leader ? "miss" : "coalesced");
+
+    if (shared && *shared && openCached(key, cached, size)) {
+        std::vector<char> data(size);
+        if (cached.read(data.data(), static_cast<std::streamsize>(size))) {
+            return data;
+        }
+    }
+
+    // Download failed, timed out, or the object does not fit the budget
+    return backend_->downloadData(key);
+}
+
+bool CachedFileService::objectExists(const std::string& key) {
+    if (cacheable(key)) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (entries_.count(key)) {
+            return true;
+        }
+    }
+    return backend_->objectExists(key);
+}
+
+std::future<bool> CachedFileService::objectExistsAsync(const std::string& key) {
+    if (cacheable(key)) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (entries_.count(key)) {
+            std::promise<bool> ready;
+            ready.set_value(true);
+            return ready.get_future();
+        }
+    }
+    return backend_->objectExistsAsync(key);
+}
+
+bool CachedFileService::deleteObject(const std::string& key) {
+    if (cacheable(key)) {
+        forget(key);
+    }
+    return backend_->deleteObject(key);
+}
+
+std::string CachedFileService::generatePresignedUrl(const std::string& key, int expiration_seconds) {
+    return backend_->generatePresignedUrl(key, expiration_seconds);
+}
+
+uint64_t CachedFileService::cachedBytes() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return bytes_;
+}
+
+size_t CachedFileService::cachedEntries() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+}
+
+bool CachedFileService::openCached(const std::string& key, std::ifstream& file, uint64_t& size) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(key);
+    if (it == entries_.end()) {
+        return false;
+    }
+
+    // Opened under the lock so eviction cannot unlink it first; once open,
+    // a later unlink leaves this reader's view intact
+    file.close();
+    file.clear();
+    file.open(pathFor(key), std::ios::binary);
+    if (!file) {
+        // Removed behind our back; drop the stale entry
+        bytes_ -= it->second.size;
+        lru_.erase(it->second.lru_position);
+        entries_.erase(it);
+        return false;
+    }
+
+    lru_.splice(lru_.begin(), lru_, it->second.lru_position);
+    size = it->second.size;
+    return true;
+}
+
+bool CachedFileService::fetch(const std::string& key) {
+    std::filesystem::path target = pathFor(key);
+    std::filesystem::path temp = target;
+    temp += TEMP_MARKER + std::to_string(temp_counter.fetch_add(1));
+
+    std::error_code ec;
+    if (!backend_->downloadFile(key, temp.string())) {
+        std::filesystem::remove(temp, ec);
+        return false;
+    }
+
+    uint64_t size = std::filesystem::file_size(temp, ec);
+    if (!ec) {
+        std::filesystem::rename(temp, target, ec);
+    }
+    if (ec) {
+        gara::Logger::log_structured(spdlog::level::warn, "Failed to add original to disk cache", {
+            {"key", key},
+            {"error", ec.message()}
+        });
+        std::filesystem::remove(temp, ec);
+        return false;
+    }
+
+    admit(key, size);
+    return true;
+}
+
+bool CachedFileService::store(const std::string& key, const char* data, size_t size) {
+    std::filesystem::path target = pathFor(key);
+    std::filesystem::path temp = target;
+    temp += TEMP_MARKER + std::to_string(temp_counter.fetch_add(1));
+
+    {
+        std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+        if (!out.write(data, static_cast<std::streamsize>(size))) {
+            std::error_code ec;
+            std::filesystem::remove(temp, ec);
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(temp, target, ec);
+    if (ec) {
+        std::filesystem::remove(temp, ec);
+        return false;
+    }
+
+    admit(key, size);
+    return true;
+}
+
+void CachedFileService::admit(const std::string& key, uint64_t size) {
+    std::vector<std::string> evicted;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = entries_.find(key);
+        if (it != entries_.end()) {
+            bytes_ -= it->second.size;
+            it->second.size = size;
+            lru_.splice(lru_.begin(), lru_, it->second.lru_position);
+        } else {
+            lru_.push_front(key);
+            entries_[key] = Entry{size, lru_.begin()};
+        }
+        bytes_ += size;
+
+        while (bytes_ > config_.max_bytes && !lru_.empty()) {
+            std::string victim = lru_.back();
+            lru_.pop_back();
+            auto victim_it = entries_.find(victim);
+            bytes_ -= victim_it->second.size;
+            entries_.erase(victim_it);
+
+            // Unlinking under the lock keeps a later admit of the same key from being deleted
+            std::error_code ec;
+            std::filesystem::remove(pathFor(victim), ec);
+            evicted.push_back(std::move(victim));
+        }
+        cachedBytesGauge().set(static_cast<double>(bytes_));
+    }
+
+    if (!evicted.empty()) {
+        METRICS_COUNT("RawCacheRequests", static_cast<double>(evicted.size()), "Count", {{"status", "evicted"}});
+    }
+}
+
+void CachedFileService::forget(const std::string& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(key);
+    if (it == entries_.end()) {
+        return;
+    }
+    bytes_ -= it->second.size;
+    lru_.erase(it->second.lru_position);
+    entries_.erase(it);
+
+    std::error_code ec;
+    std::filesystem::remove(pathFor(key), ec);
+    cachedBytesGauge().set(static_cast<double>(bytes_));
+}
+
+void CachedFileService::loadExisting() {
+    struct Found {
+        std::filesystem::file_time_type mtime;
+        std::string key;
+        uint64_t size;
+    };
+    std::vector<Found> found;
+
+    std::error_code ec;
+    for (const auto& file : std::filesystem::directory_iterator(directory_, ec)) {
+        std::string name = file.path().filename().string();
+        if (name.find(TEMP_MARKER) != std::string::npos) {
+            std::error_code remove_ec;
+            std::filesystem::remove(file.path(), remove_ec);  // Left by an interrupted download
+            continue;
+        }
+        std::error_code stat_ec;
+        if (!file.is_regular_file(stat_ec)) {
+            continue;
+        }
+        uint64_t size = file.file_size(stat_ec);
+        auto mtime = file.last_write_time(stat_ec);
+        if (!stat_ec) {
+            found.push_back({mtime, decodeKey(name), size});
+        }
+    }
+
+    // Oldest first, so the newest files end up at the front of the LRU
+    std::sort(found.begin(), found.end(), [](const Found& a, const Found& b) { return a.mtime < b.mtime; });
+    for (const auto& entry : found) {
+        admit(entry.key, entry.size);
+    }
+
+    if (!found.empty()) {
+        gara::Logger::log_structured(spdlog::level::info, "Loaded raw disk cache", {
+            {"directory", directory_.string()},
+            {"entries", entries_.size()},
+            {"bytes", bytes_}
+        });
+    }
+}
+
+} // namespace gara
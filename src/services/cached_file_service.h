@@ -0,0 +1,104 @@
+#ifndef GARA_CACHED_FILE_SERVICE_H
+#define GARA_CACHED_FILE_SERVICE_H
+
+#include "../interfaces/file_service_interface.h"
+#include "../models/raw_cache_config.h"
+#include "../utils/single_flight.h"
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace gara {
+
+/**
+ * @brief Local-disk hot tier for raw originals in front of another file service
+ *
+ * Downloads of keys under the configured prefix are kept as files in a local
+ * directory, bounded by a byte budget with LRU eviction, so renditions of
+ * the same original in different sizes fetch it from the backend once.
+ * Concurrent misses for one key share a single download. Readers open the
+ * cached file under the index lock; an eviction that races with a read
+ * only unlinks the file, so the open reader still sees the whole object.
+ *
+ * Cached files survive restarts: the directory is rescanned on startup.
+ */
+class CachedFileService : public FileServiceInterface {
+public:
+    CachedFileService(std::shared_ptr<FileServiceInterface> backend, const RawCacheConfig& config);
+
+    bool uploadFile(const std::string& local_path, const std::string& key,
+                   const std::string& content_type = "application/octet-stream") override;
+
+    // Raw uploads also seed the disk tier, since renditions usually follow
+    bool uploadData(const std::vector<char>& data, const std::string& key,
+                   const std::string& content_type = "application/octet-stream") override;
+
+    bool moveFileToStorage(const std::string& local_path, const std::string& key,
+                           const std::string& content_type = "application/octet-stream") override;
+
+    bool downloadFile(const std::string& key, const std::string& local_path) override;
+
+    std::vector<char> downloadData(const std::string& key) override;
+
+    bool objectExists(const std::string& key) override;
+
+    std::future<bool> objectExistsAsync(const std::string& key) override;
+
+    bool deleteObject(const std::string& key) override;
+
+    std::string generatePresignedUrl(const std::string& key, int expiration_seconds = 3600) override;
+
+    const std::string& getBucketName() const override { return backend_->getBucketName(); }
+
+    // Bytes currently held on disk
+    uint64_t cachedBytes();
+
+    // Number of cached originals
+    size_t cachedEntries();
+
+private:
+    struct Entry {
+        uint64_t size = 0;
+        std::list<std::string>::iterator lru_position;
+    };
+
+    bool cacheable(const std::string& key) const;
+    std::filesystem::path pathFor(const std::string& key) const;
+
+    // Open a cached copy and mark it recently used; false on a miss
+    bool openCached(const std::string& key, std::ifstream& file, uint64_t& size);
+
+    // Fetch key from the backend into the disk tier; false if it could not be fetched
+    bool fetch(const std::string& key);
+
+    // Write bytes to the disk tier under key
+    bool store(const std::string& key, const char* data, size_t size);
+
+    // Add a file now in place for key to the index and evict down to the budget
+    void admit(const std::string& key, uint64_t size);
+
+    void forget(const std::string& key);
+
+    // Rebuild the index from the directory, oldest files first
+    void loadExisting();
+
+    std::shared_ptr<FileServiceInterface> backend_;
+    RawCacheConfig config_;
+    std::filesystem::path directory_;
+
+    std::mutex mutex_;
+    std::list<std::string> lru_;  // Most recently used first
+    std::unordered_map<std::string, Entry> entries_;
+    uint64_t bytes_ = 0;
+
+    utils::SingleFlight<bool> fetches_;
+};
+
+} // namespace gara
+
+#endif // GARA_CACHED_FILE_SERVICE_H
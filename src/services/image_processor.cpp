@@ -1,12 +1,37 @@
 #include "image_processor.h"
 #include "../utils/logger.h"
 #include "../utils/metrics.h"
+#include "../utils/file_utils.h"
+#include "../utils/prometheus_registry.h"
+#include "../utils/trace.h"
+#include "../utils/blurhash.h"
 #include <iostream>
 #include <algorithm>
 #include <cmath>
 
 namespace gara {
 
+namespace {
+
+// Per-step libvips timings, also recorded as request trace spans ("open" is the
+// "decode" span); since libvips is lazy, decode cost lands in "encode"
+DurationMetric vips_open_duration("VipsStepDuration", {{"step", "open"}});
+DurationMetric vips_resize_duration("VipsStepDuration", {{"step", "resize"}});
+DurationMetric vips_post_process_duration("VipsStepDuration", {{"step", "post_process"}});
+DurationMetric vips_encode_duration("VipsStepDuration", {{"step", "encode"}});
+DurationMetric vips_placeholder_duration("VipsStepDuration", {{"step", "placeholder"}});
+
+CounterMetric animated_frames("AnimatedFrames", {});
+
+// Longer animations are cut to their first frames
+constexpr int MAX_ANIMATION_FRAMES = 1000;
+
+bool supportsAnimation(const std::string& format) {
+    return format == "webp" || format == "gif";
+}
+
+} // anonymous namespace
+
 ImageProcessor::ImageProcessor() {
 }
 
@@ -27,6 +52,43 @@ void ImageProcessor::shutdown() {
     vips_shutdown();
 }
 
+void ImageProcessor::configureCache(const GovernorConfig& config) {
+    vips_cache_set_max_mem(static_cast<size_t>(config.vips_cache_max_mem_mb) * 1024 * 1024);
+    vips_cache_set_max(config.vips_cache_max_ops);
+    vips_cache_set_max_files(config.vips_cache_max_files);
+    gara::Logger::log_structured(spdlog::level::info, "libvips operation cache configured", {
+        {"max_mem_mb", config.vips_cache_max_mem_mb},
+        {"max_ops", config.vips_cache_max_ops},
+        {"max_files", config.vips_cache_max_files}
+    });
+}
+
+VipsMemoryStats ImageProcessor::memoryStats() {
+    VipsMemoryStats stats;
+    stats.tracked_bytes = vips_tracked_get_mem();
+    stats.highwater_bytes = vips_tracked_get_mem_highwater();
+    stats.allocations = vips_tracked_get_allocs();
+    stats.open_files = vips_tracked_get_files();
+    stats.cache_operations = vips_cache_get_size();
+    return stats;
+}
+
+void ImageProcessor::publishMemoryStats() {
+    auto& registry = PrometheusRegistry::instance();
+    static auto& tracked = registry.gauge("gara_vips_memory_bytes", "Memory currently allocated by libvips");
+    static auto& highwater = registry.gauge("gara_vips_memory_highwater_bytes", "Peak memory allocated by libvips");
+    static auto& allocations = registry.gauge("gara_vips_allocations", "Live libvips allocations");
+    static auto& files = registry.gauge("gara_vips_open_files", "Files held open by libvips");
+    static auto& cache_ops = registry.gauge("gara_vips_cache_operations", "Operations in the libvips cache");
+
+    VipsMemoryStats stats = memoryStats();
+    tracked.set(static_cast<double>(stats.tracked_bytes));
+    highwater.set(static_cast<double>(stats.highwater_bytes));
+    allocations.set(static_cast<double>(stats.allocations));
+    files.set(static_cast<double>(stats.open_files));
+    cache_ops.set(static_cast<double>(stats.cache_operations));
+}
+
 bool ImageProcessor::transform(const std::string& input_path,
                               const std::string& output_path,
                               const std::string& target_format,
@@ -39,61 +101,204 @@ bool ImageProcessor::transform(const std::string& input_path,
     });
 
     try {
-        // Load image
-        vips::VImage image = vips::VImage::new_from_file(input_path.c_str());
+        // Opening only reads the header; pixels are decoded on demand
+        vips::VImage image;
+        {
+            METRICS_SCOPED_TIMER(vips_open_duration);
+            TRACE_SPAN("decode");
+            image = vips::VImage::new_from_file(input_path.c_str());
+        }
 
-        int original_width = image.width();
-        int original_height = image.height();
+        {
+            METRICS_SCOPED_TIMER(vips_resize_duration);
+            TRACE_SPAN("resize");
+            int thumb_width = target_width;
+            int thumb_height = target_height;
+            if (resolveThumbnailSize(image, thumb_width, thumb_height)) {
+                image = vips::VImage::thumbnail(input_path.c_str(), thumb_width,
+                                                createThumbnailOptions(thumb_height));
+            } else {
+                image = resizeImage(image, target_width, target_height);
+            }
+        }
 
-        // Calculate target dimensions if needed
-        if (target_width > 0 || target_height > 0) {
-            calculateDimensions(original_width, original_height, target_width, target_height);
+        // Save image with options
+        {
+            METRICS_SCOPED_TIMER(vips_encode_duration);
+            TRACE_SPAN("encode");
+            image.write_to_file(output_path.c_str(), createSaveOptions(target_format, qualityProfile(quality)));
+        }
 
-            // Resize image
-            double h_scale = static_cast<double>(target_width) / original_width;
-            double v_scale = static_cast<double>(target_height) / original_height;
+        METRICS_COUNT("ImageTransformations", 1.0, "Count", {
+            {"format", target_format},
+            {"status", "success"}
+        });
 
-            image = image.resize(h_scale, vips::VImage::option()
-                ->set("vscale", v_scale)
-                ->set("kernel", VIPS_KERNEL_LANCZOS3));
-        }
+        return true;
+
+    } catch (vips::VError& e) {
+        gara::Logger::log_structured(spdlog::level::err, "Image transformation failed", {
+            {"input_path", input_path},
+            {"output_path", output_path},
+            {"target_format", target_format},
+            {"target_width", target_width},
+            {"target_height", target_height},
+            {"error", e.what()}
+        });
+        METRICS_COUNT("ImageTransformations", 1.0, "Count", {
+            {"format", target_format},
+            {"status", "error"}
+        });
+        return false;
+    }
+}
 
-        // Prepare save options
-        vips::VOption* save_options = vips::VImage::option();
+std::vector<char> ImageProcessor::transformBuffer(utils::ByteView input_data,
+                                                 const std::string& target_format,
+                                                 int target_width,
+                                                 int target_height,
+                                                 int quality,
+                                                 const ImagePostProcessor& post_process) {
+    return transformBuffer(input_data, target_format, target_width, target_height,
+                           qualityProfile(quality), post_process);
+}
 
-        // Set quality for JPEG
-        if (target_format == "jpeg" || target_format == "jpg") {
-            save_options->set("Q", quality);
-            // Strip metadata to reduce file size
-            save_options->set("strip", true);
-            // Optimize for smaller file size
-            save_options->set("optimize_coding", true);
-        } else if (target_format == "png") {
-            // PNG compression level (1-9)
-            save_options->set("compression", 6);
-            save_options->set("strip", true);
-        } else if (target_format == "webp") {
-            save_options->set("Q", quality);
-            save_options->set("strip", true);
-        }
+std::vector<char> ImageProcessor::transformBuffer(utils::ByteView input_data,
+                                                 const std::string& target_format,
+                                                 int target_width,
+                                                 int target_height,
+                                                 const EncoderProfile& encoder,
+                                                 const ImagePostProcessor& post_process) {
+    auto timer = gara::Metrics::get()->start_timer("ImageProcessingDuration", {
+        {"operation", "transform_buffer"},
+        {"format", target_format}
+    });
+
+    try {
+        // Nothing is decoded until write_to_buffer pulls pixels through the graph
+        vips::VImage image = buildPipeline(input_data, target_format, target_width, target_height, post_process);
 
-        // Convert suffix for saving
+        void* buffer = nullptr;
+        size_t buffer_size = 0;
         std::string suffix = formatToSuffix(target_format);
+        {
+            METRICS_SCOPED_TIMER(vips_encode_duration);
+            TRACE_SPAN("encode");
+            image.write_to_buffer(suffix.c_str(), &buffer, &buffer_size,
+                                  createSaveOptions(target_format, encoder));
+        }
 
-        // Save image with options
-        image.write_to_file(output_path.c_str(), save_options);
+        std::vector<char> output(static_cast<char*>(buffer),
+                                 static_cast<char*>(buffer) + buffer_size);
+        g_free(buffer);
 
         METRICS_COUNT("ImageTransformations", 1.0, "Count", {
             {"format", target_format},
             {"status", "success"}
         });
 
+        return output;
+
+    } catch (vips::VError& e) {
+        gara::Logger::log_structured(spdlog::level::err, "In-memory image transformation failed", {
+            {"input_size", input_data.size()},
+            {"target_format", target_format},
+            {"target_width", target_width},
+            {"target_height", target_height},
+            {"error", e.what()}
+        });
+        METRICS_COUNT("ImageTransformations", 1.0, "Count", {
+            {"format", target_format},
+            {"status", "error"}
+        });
+        return {};
+    }
+}
+
+vips::VImage ImageProcessor::buildPipeline(utils::ByteView input_data,
+                                          const std::string& target_format,
+                                          int target_width,
+                                          int target_height,
+                                          const ImagePostProcessor& post_process) {
+    vips::VImage image;
+    {
+        METRICS_SCOPED_TIMER(vips_open_duration);
+        TRACE_SPAN("decode");
+        image = vips::VImage::new_from_buffer(input_data.data(), input_data.size(), "");
+    }
+    int frames = animationFrames(image, target_format);
+
+    {
+        METRICS_SCOPED_TIMER(vips_resize_duration);
+        TRACE_SPAN("resize");
+        int thumb_width = target_width;
+        int thumb_height = target_height;
+        if (frames > 1) {
+            image = thumbnailAnimated(input_data, image, frames, target_width, target_height);
+        } else if (resolveThumbnailSize(image, thumb_width, thumb_height)) {
+            // Shrink-on-load: JPEG/WebP decode directly at a reduced scale
+            image = vips::VImage::thumbnail_buffer(
+                const_cast<char*>(input_data.data()), input_data.size(),
+                thumb_width, createThumbnailOptions(thumb_height));
+        } else {
+            image = resizeImage(image, target_width, target_height);
+        }
+    }
+
+    if (post_process) {
+        METRICS_SCOPED_TIMER(vips_post_process_duration);
+        TRACE_SPAN("watermark");
+        image = frames > 1 ? applyPerFrame(image, post_process) : post_process(image);
+    }
+    return image;
+}
+
+namespace {
+
+// "write" handler of the custom target: hands each encoded chunk to the sink
+gint64 writeToSink(VipsTargetCustom*, const void* data, gint64 length, void* user) {
+    auto* sink = static_cast<const EncodedChunkSink*>(user);
+    return (*sink)(static_cast<const char*>(data), static_cast<size_t>(length)) ? length : -1;
+}
+
+} // anonymous namespace
+
+bool ImageProcessor::transformStream(utils::ByteView input_data,
+                                     const std::string& target_format,
+                                     int target_width,
+                                     int target_height,
+                                     const EncoderProfile& encoder,
+                                     const EncodedChunkSink& sink,
+                                     const ImagePostProcessor& post_process) {
+    auto timer = gara::Metrics::get()->start_timer("ImageProcessingDuration", {
+        {"operation", "transform_stream"},
+        {"format", target_format}
+    });
+
+    try {
+        vips::VImage image = buildPipeline(input_data, target_format, target_width, target_height, post_process);
+
+        // The encoder pulls strips through the pipeline and writes each one to
+        // the sink as it is compressed; no buffer ever holds the whole output
+        VipsTargetCustom* custom = vips_target_custom_new();
+        g_signal_connect(custom, "write", G_CALLBACK(writeToSink), const_cast<EncodedChunkSink*>(&sink));
+        vips::VTarget target(VIPS_TARGET(custom));
+        std::string suffix = formatToSuffix(target_format);
+        {
+            METRICS_SCOPED_TIMER(vips_encode_duration);
+            TRACE_SPAN("encode");
+            image.write_to_target(suffix.c_str(), target, createSaveOptions(target_format, encoder));
+        }
+
+        METRICS_COUNT("ImageTransformations", 1.0, "Count", {
+            {"format", target_format},
+            {"status", "success"}
+        });
         return true;
 
     } catch (vips::VError& e) {
-        gara::Logger::log_structured(spdlog::level::err, "Image transformation failed", {
-            {"input_path", input_path},
-            {"output_path", output_path},
+        gara::Logger::log_structured(spdlog::level::err, "Streaming image transformation failed", {
+            {"input_size", input_data.size()},
             {"target_format", target_format},
             {"target_width", target_width},
             {"target_height", target_height},
@@ -107,31 +312,240 @@ bool ImageProcessor::transform(const std::string& input_path,
     }
 }
 
+std::vector<std::vector<char>> ImageProcessor::transformBufferMany(
+    utils::ByteView input_data,
+    const std::vector<RenditionTarget>& targets,
+    const ImagePostProcessor& post_process) {
+    auto timer = gara::Metrics::get()->start_timer("ImageProcessingDuration", {
+        {"operation", "transform_buffer_many"}
+    });
+
+    std::vector<std::vector<char>> outputs(targets.size());
+    if (targets.empty()) {
+        return outputs;
+    }
+
+    vips::VImage decoded;
+    std::vector<std::pair<int, int>> sizes;
+    bool animated = false;
+    try {
+        vips::VImage header;
+        {
+            METRICS_SCOPED_TIMER(vips_open_duration);
+            TRACE_SPAN("decode");
+            header = vips::VImage::new_from_buffer(input_data.data(), input_data.size(), "");
+        }
+        animated = animationFrames(header, "webp") > 1;
+
+        sizes.reserve(targets.size());
+        for (const auto& target : targets) {
+            int width = target.width;
+            int height = target.height;
+            calculateDimensions(header.width(), header.height(), width, height);
+            sizes.emplace_back(width, height);
+        }
+
+        decoded = decodeForTargets(header, input_data, sizes);
+
+    } catch (vips::VError& e) {
+        gara::Logger::log_structured(spdlog::level::err, "Multi-size image decode failed", {
+            {"input_size", input_data.size()},
+            {"targets", targets.size()},
+            {"error", e.what()}
+        });
+        METRICS_COUNT("ImageTransformations", 1.0, "Count", {
+            {"format", "multi"},
+            {"status", "error"}
+        });
+        return outputs;
+    }
+
+    for (size_t i = 0; i < targets.size(); ++i) {
+        if (animated && supportsAnimation(targets[i].format)) {
+            // The shared decode holds one frame; animated outputs stream every frame instead
+            outputs[i] = transformBuffer(input_data, targets[i].format, targets[i].width, targets[i].height,
+                                         targets[i].encoder, post_process);
+        } else {
+            outputs[i] = encodeTarget(decoded, targets[i], sizes[i].first, sizes[i].second, post_process);
+        }
+    }
+
+    return outputs;
+}
+
+vips::VImage ImageProcessor::decodeForTargets(const vips::VImage& header,
+                                              utils::ByteView input_data,
+                                              const std::vector<std::pair<int, int>>& sizes) {
+    METRICS_SCOPED_TIMER(vips_resize_duration);
+    TRACE_SPAN("resize");
+
+    // Smallest uniform scale whose output still covers every target box
+    double scale = 0.0;
+    for (const auto& [width, height] : sizes) {
+        scale = std::max(scale, static_cast<double>(width) / header.width());
+        scale = std::max(scale, static_cast<double>(height) / header.height());
+    }
+
+    vips::VImage decoded;
+    if (scale >= 1.0) {
+        // Some target needs full resolution (or an upscale)
+        decoded = header;
+    } else {
+        int cover_width = std::max(1, static_cast<int>(std::ceil(header.width() * scale)));
+        int cover_height = std::max(1, static_cast<int>(std::ceil(header.height() * scale)));
+        decoded = vips::VImage::thumbnail_buffer(
+            const_cast<char*>(input_data.data()), input_data.size(),
+            cover_width, createThumbnailOptions(cover_height));
+    }
+
+    // Materialize once so each target reads pixels instead of re-decoding
+    return decoded.copy_memory();
+}
+
+std::vector<char> ImageProcessor::encodeTarget(const vips::VImage& decoded,
+                                               const RenditionTarget& target,
+                                               int target_width, int target_height,
+                                               const ImagePostProcessor& post_process) {
+    try {
+        vips::VImage image = decoded;
+        {
+            METRICS_SCOPED_TIMER(vips_resize_duration);
+            TRACE_SPAN("resize");
+            if (target_width == decoded.width() && target_height == decoded.height()) {
+                // Already the right size
+            } else if (target_width <= decoded.width() && target_height <= decoded.height()) {
+                image = decoded.thumbnail_image(target_width, createThumbnailOptions(target_height));
+            } else {
+                image = resizeImage(decoded, target_width, target_height);
+            }
+        }
+
+        if (post_process) {
+            METRICS_SCOPED_TIMER(vips_post_process_duration);
+            TRACE_SPAN("watermark");
+            image = post_process(image);
+        }
+
+        void* buffer = nullptr;
+        size_t buffer_size = 0;
+        std::string suffix = formatToSuffix(target.format);
+        {
+            METRICS_SCOPED_TIMER(vips_encode_duration);
+            TRACE_SPAN("encode");
+            image.write_to_buffer(suffix.c_str(), &buffer, &buffer_size,
+                                  createSaveOptions(target.format, target.encoder));
+        }
+
+        std::vector<char> output(static_cast<char*>(buffer),
+                                 static_cast<char*>(buffer) + buffer_size);
+        g_free(buffer);
+
+        METRICS_COUNT("ImageTransformations", 1.0, "Count", {
+            {"format", target.format},
+            {"status", "success"}
+        });
+
+        return output;
+
+    } catch (vips::VError& e) {
+        gara::Logger::log_structured(spdlog::level::err, "Rendition encode failed", {
+            {"target_format", target.format},
+            {"target_width", target_width},
+            {"target_height", target_height},
+            {"error", e.what()}
+        });
+        METRICS_COUNT("ImageTransformations", 1.0, "Count", {
+            {"format", target.format},
+            {"status", "error"}
+        });
+        return {};
+    }
+}
+
+bool ImageProcessor::generateTiles(utils::ByteView input_data,
+                                   const std::string& output_dir,
+                                   const TileConfig& config,
+                                   const ImagePostProcessor& post_process) {
+    auto timer = gara::Metrics::get()->start_timer("ImageProcessingDuration", {
+        {"operation", "tiles"},
+        {"format", config.format}
+    });
+
+    try {
+        vips::VImage image;
+        {
+            TRACE_SPAN("decode");
+            // dzsave reads its source top to bottom, so without a post-process step
+            // the decoder can stream strips instead of holding the whole image
+            image = vips::VImage::new_from_buffer(input_data.data(), input_data.size(), "",
+                vips::VImage::option()->set("access",
+                    post_process ? VIPS_ACCESS_RANDOM : VIPS_ACCESS_SEQUENTIAL));
+        }
+
+        if (post_process) {
+            TRACE_SPAN("watermark");
+            image = post_process(image);
+        }
+
+        std::string suffix = "." + config.extension();
+        if (config.format != "png") {
+            suffix += "[Q=" + std::to_string(config.quality) + "]";
+        }
+
+        {
+            TRACE_SPAN("encode");
+            image.dzsave((output_dir + "/image").c_str(), vips::VImage::option()
+                ->set("layout", VIPS_FOREIGN_DZ_LAYOUT_DZ)
+                ->set("tile_size", config.tile_size)
+                ->set("overlap", config.overlap)
+                ->set("suffix", suffix.c_str()));
+        }
+
+        METRICS_COUNT("ImageTransformations", 1.0, "Count", {
+            {"format", "tiles"},
+            {"status", "success"}
+        });
+        return true;
+
+    } catch (vips::VError& e) {
+        gara::Logger::log_structured(spdlog::level::err, "Tile pyramid generation failed", {
+            {"input_size", input_data.size()},
+            {"output_dir", output_dir},
+            {"error", e.what()}
+        });
+        METRICS_COUNT("ImageTransformations", 1.0, "Count", {
+            {"format", "tiles"},
+            {"status", "error"}
+        });
+        return false;
+    }
+}
+
 ImageInfo ImageProcessor::getImageInfo(const std::string& filepath) {
     ImageInfo info;
-    info.is_valid = false;
 
     try {
-        vips::VImage image = vips::VImage::new_from_file(filepath.c_str());
+        // Only the header is read; sequential + fail keep any later access cheap and strict
+        vips::VImage image = vips::VImage::new_from_file(filepath.c_str(), vips::VImage::option()
+            ->set("access", VIPS_ACCESS_SEQUENTIAL)
+            ->set("fail", true));
 
         info.width = image.width();
         info.height = image.height();
-        info.is_valid = true;
+        info.bands = image.bands();
 
-        // Try to determine format from filename
-        size_t dot_pos = filepath.find_last_of('.');
-        if (dot_pos != std::string::npos) {
-            info.format = filepath.substr(dot_pos + 1);
-            std::transform(info.format.begin(), info.format.end(),
-                         info.format.begin(), ::tolower);
+        if (image.get_typeof("vips-loader") != 0) {
+            info.format = loaderToFormat(image.get_string("vips-loader"));
+        }
+        if (image.get_typeof("orientation") != 0) {
+            info.orientation = image.get_int("orientation");
         }
 
-        // Calculate approximate size (width * height * channels)
-        int bands = image.bands();
-        info.size_bytes = info.width * info.height * bands;
+        info.size_bytes = utils::FileUtils::getFileSize(filepath);
+        info.is_valid = true;
 
     } catch (vips::VError& e) {
-        gara::Logger::log_structured(spdlog::level::err, "Failed to get image info", {
+        gara::Logger::log_structured(spdlog::level::debug, "Failed to probe image header", {
             {"filepath", filepath},
             {"error", e.what()}
         });
@@ -140,13 +554,200 @@ ImageInfo ImageProcessor::getImageInfo(const std::string& filepath) {
     return info;
 }
 
+ImageInfo ImageProcessor::getBufferInfo(utils::ByteView input_data) {
+    ImageInfo info;
+    if (input_data.empty()) {
+        return info;
+    }
+
+    try {
+        vips::VImage image = vips::VImage::new_from_buffer(input_data.data(), input_data.size(), "",
+            vips::VImage::option()->set("access", VIPS_ACCESS_SEQUENTIAL));
+
+        info.width = image.width();
+        info.height = image.height();
+        info.bands = image.bands();
+        if (image.get_typeof("vips-loader") != 0) {
+            info.format = loaderToFormat(image.get_string("vips-loader"));
+        }
+        info.size_bytes = input_data.size();
+        info.is_valid = true;
+
+    } catch (vips::VError& e) {
+        gara::Logger::log_structured(spdlog::level::debug, "Failed to probe image buffer", {
+            {"size_bytes", input_data.size()},
+            {"error", e.what()}
+        });
+    }
+
+    return info;
+}
+
 bool ImageProcessor::isValidImage(const std::string& filepath) {
+    return getImageInfo(filepath).is_valid;
+}
+
+std::string ImageProcessor::computePlaceholder(const std::string& filepath) {
+    METRICS_SCOPED_TIMER(vips_placeholder_duration);
+
     try {
-        vips::VImage image = vips::VImage::new_from_file(filepath.c_str());
-        return true;
+        // Unrotated, like the renditions and reported dimensions
+        vips::VImage image = vips::VImage::thumbnail(filepath.c_str(), PLACEHOLDER_SIZE, vips::VImage::option()
+            ->set("height", PLACEHOLDER_SIZE)
+            ->set("no_rotate", true));
+
+        image = image.colourspace(VIPS_INTERPRETATION_sRGB);
+        if (image.has_alpha()) {
+            image = image.flatten(vips::VImage::option()->set("background", std::vector<double>{255, 255, 255}));
+        }
+        image = image.extract_band(0, vips::VImage::option()->set("n", 3)).cast(VIPS_FORMAT_UCHAR);
+
+        size_t size = 0;
+        std::unique_ptr<void, decltype(&g_free)> pixels(image.write_to_memory(&size), g_free);
+        if (!pixels || size < static_cast<size_t>(image.width()) * image.height() * 3) {
+            return "";
+        }
+
+        // 4x3 components (3x4 for portrait) is BlurHash's usual detail level
+        bool landscape = image.width() >= image.height();
+        return utils::BlurHash::encode(static_cast<const uint8_t*>(pixels.get()), image.width(), image.height(),
+                                       landscape ? 4 : 3, landscape ? 3 : 4);
+
     } catch (vips::VError& e) {
+        gara::Logger::log_structured(spdlog::level::debug, "Failed to compute placeholder", {
+            {"filepath", filepath},
+            {"error", e.what()}
+        });
+        return "";
+    }
+}
+
+int ImageProcessor::animationFrames(const vips::VImage& header, const std::string& target_format) {
+    if (!supportsAnimation(target_format) || header.get_typeof("n-pages") == 0) {
+        return 1;
+    }
+    return std::clamp(header.get_int("n-pages"), 1, MAX_ANIMATION_FRAMES);
+}
+
+vips::VImage ImageProcessor::thumbnailAnimated(utils::ByteView input_data, const vips::VImage& header,
+                                               int frames, int target_width, int target_height) {
+    // The header holds the first frame only, so its size is the frame size
+    calculateDimensions(header.width(), header.height(), target_width, target_height);
+    animated_frames.add(frames);
+
+    // vips_thumbnail resizes page by page and updates page-height; frames are
+    // decoded as the encoder pulls them, so memory stays near one frame
+    std::string load_options = "n=" + std::to_string(frames);
+    return vips::VImage::thumbnail_buffer(
+        const_cast<char*>(input_data.data()), input_data.size(),
+        target_width, createThumbnailOptions(target_height)->set("option_string", load_options.c_str()));
+}
+
+vips::VImage ImageProcessor::applyPerFrame(const vips::VImage& image, const ImagePostProcessor& post_process) {
+    int page_height = image.get_typeof("page-height") != 0 ? image.get_int("page-height") : image.height();
+    int frames = page_height > 0 ? image.height() / page_height : 1;
+    if (frames <= 1) {
+        return post_process(image);
+    }
+
+    // Each frame is cropped out, processed and joined back lazily, so a
+    // watermark lands on every frame instead of once on the whole strip
+    std::vector<vips::VImage> processed;
+    processed.reserve(frames);
+    for (int i = 0; i < frames; ++i) {
+        processed.push_back(post_process(image.crop(0, i * page_height, image.width(), page_height)));
+    }
+    vips::VImage joined = vips::VImage::arrayjoin(processed, vips::VImage::option()->set("across", 1)).copy();
+    joined.set("page-height", page_height);
+    return joined;
+}
+
+vips::VImage ImageProcessor::resizeImage(const vips::VImage& image,
+                                         int target_width, int target_height) {
+    if (target_width <= 0 && target_height <= 0) {
+        return image;
+    }
+
+    int original_width = image.width();
+    int original_height = image.height();
+    calculateDimensions(original_width, original_height, target_width, target_height);
+
+    double h_scale = static_cast<double>(target_width) / original_width;
+    double v_scale = static_cast<double>(target_height) / original_height;
+
+    return image.resize(h_scale, vips::VImage::option()
+        ->set("vscale", v_scale)
+        ->set("kernel", VIPS_KERNEL_LANCZOS3));
+}
+
+bool ImageProcessor::resolveThumbnailSize(const vips::VImage& header,
+                                          int& target_width, int& target_height) {
+    if (target_width <= 0 && target_height <= 0) {
         return false;
     }
+
+    calculateDimensions(header.width(), header.height(), target_width, target_height);
+
+    // Upscales gain nothing from shrink-on-load, keep the resize path for them
+    return target_width <= header.width() && target_height <= header.height();
+}
+
+vips::VOption* ImageProcessor::createThumbnailOptions(int target_height) {
+    return vips::VImage::option()
+        ->set("height", target_height)
+        // Exact target box, matching the dimensions resize() would produce
+        ->set("size", VIPS_SIZE_FORCE)
+        // Keep orientation handling identical to the resize path
+        ->set("no_rotate", true);
+}
+
+vips::VOption* ImageProcessor::createSaveOptions(const std::string& target_format,
+                                                 const EncoderProfile& profile) {
+    vips::VOption* save_options = vips::VImage::option();
+
+    if (target_format == "jpeg" || target_format == "jpg") {
+        save_options->set("Q", profile.quality);
+        // Strip metadata to reduce file size
+        save_options->set("strip", true);
+        // Optimize for smaller file size
+        save_options->set("optimize_coding", true);
+        if (profile.jpeg_trellis) {
+            // Ignored by libjpeg-turbo, effective with mozjpeg
+            save_options->set("trellis_quant", true);
+            save_options->set("overshoot_deringing", true);
+            save_options->set("optimize_scans", true);
+        }
+        if (profile.jpeg_interlace) {
+            save_options->set("interlace", true);
+        }
+    } else if (target_format == "png") {
+        // PNG compression level (0-9)
+        save_options->set("compression", profile.png_compression);
+        save_options->set("strip", true);
+        if (profile.png_palette) {
+            save_options->set("palette", true);
+            save_options->set("Q", profile.quality);
+            save_options->set("effort", std::clamp(profile.effort + 1, 1, 10));
+        }
+    } else if (target_format == "webp") {
+        save_options->set("Q", profile.quality);
+        save_options->set("effort", std::min(profile.effort, 6));
+        save_options->set("strip", true);
+    } else if (target_format == "avif") {
+        // heifsave picks AV1 from the .avif suffix
+        save_options->set("Q", profile.quality);
+        save_options->set("effort", std::min(profile.effort, 9));
+        save_options->set("strip", true);
+    }
+
+    return save_options;
+}
+
+EncoderProfile ImageProcessor::qualityProfile(int quality) {
+    EncoderProfile profile;
+    profile.name = EncoderConfig::BASELINE_PROFILE;
+    profile.quality = quality;
+    return profile;
 }
 
 void ImageProcessor::calculateDimensions(int original_width, int original_height,
@@ -173,6 +774,12 @@ void ImageProcessor::calculateDimensions(int original_width, int original_height
     }
 }
 
+std::string ImageProcessor::loaderToFormat(const std::string& loader) {
+    // Loader names are "<format>load" with an optional "_buffer"/"_source" suffix
+    size_t pos = loader.find("load");
+    return pos == std::string::npos ? loader : loader.substr(0, pos);
+}
+
 std::string ImageProcessor::formatToSuffix(const std::string& format) {
     std::string lower_format = format;
     std::transform(lower_format.begin(), lower_format.end(),
@@ -183,6 +790,7 @@ std::string ImageProcessor::formatToSuffix(const std::string& format) {
     if (lower_format == "jpeg") return ".jpg";
     if (lower_format == "png") return ".png";
     if (lower_format == "webp") return ".webp";
+    if (lower_format == "avif") return ".avif";
     if (lower_format == "tiff" || lower_format == "tif") return ".tif";
     if (lower_format == "gif") return ".gif";
 
@@ -3,16 +3,50 @@
 
 #include <string>
 #include <memory>
+#include <vector>
+#include <functional>
+#include <utility>
 #include <vips/vips8>
+#include "../models/encoder_config.h"
+#include "../models/governor_config.h"
+#include "../models/tile_config.h"
+#include "../utils/mapped_file.h"
 
 namespace gara {
 
 struct ImageInfo {
-    int width;
-    int height;
-    std::string format;
-    size_t size_bytes;
-    bool is_valid;
+    int width = 0;
+    int height = 0;
+    std::string format;      // Format reported by the libvips loader (jpeg, png, ...)
+    size_t size_bytes = 0;   // Encoded file size on disk
+    int bands = 0;
+    int orientation = 1;     // EXIF orientation (1 = upright)
+    bool is_valid = false;
+};
+
+// libvips' own memory accounting
+struct VipsMemoryStats {
+    size_t tracked_bytes = 0;      // vips_tracked_get_mem
+    size_t highwater_bytes = 0;    // vips_tracked_get_mem_highwater
+    int allocations = 0;           // Live tracked allocations
+    int open_files = 0;
+    int cache_operations = 0;      // Operations held in the libvips cache
+};
+
+// Optional step applied to the resized image before it is encoded
+// (e.g. watermarking). Runs as part of the same lazy libvips pipeline.
+using ImagePostProcessor = std::function<vips::VImage(const vips::VImage&)>;
+
+// Receives encoded output chunk by chunk as the encoder produces it;
+// returning false aborts the encode
+using EncodedChunkSink = std::function<bool(const char* data, size_t size)>;
+
+// One output of a multi-size transform (0 keeps aspect ratio, as in transform())
+struct RenditionTarget {
+    std::string format = "jpeg";
+    int width = 0;
+    int height = 0;
+    EncoderProfile encoder;
 };
 
 class ImageProcessor {
@@ -26,8 +60,18 @@ public:
     // Shutdown libvips (call once at shutdown)
     static void shutdown();
 
+    // Apply operation cache limits (call after initialize)
+    static void configureCache(const GovernorConfig& config);
+
+    // Sample libvips memory and cache counters
+    static VipsMemoryStats memoryStats();
+
+    // Copy libvips memory and cache counters into Prometheus gauges
+    static void publishMemoryStats();
+
     // Transform image: convert format and/or resize
     // If width or height is 0, maintains aspect ratio
+    // Downscales use shrink-on-load so large sources are never fully decoded
     // Returns true on success
     bool transform(const std::string& input_path,
                   const std::string& output_path,
@@ -36,17 +80,122 @@ public:
                   int target_height = 0,
                   int quality = 85);
 
-    // Get image information without loading full image
+    // Transform an in-memory (or memory-mapped) image as a single pipeline:
+    // decode -> resize -> post-process -> encode once. libvips reads
+    // input_data in place, so it must stay valid until the call returns.
+    // Animated GIF/WebP sources keep their frames when encoded to webp or gif;
+    // frames stream through the pipeline, each resized and post-processed
+    // Returns encoded bytes, or an empty vector on failure
+    std::vector<char> transformBuffer(utils::ByteView input_data,
+                                      const std::string& target_format = "jpeg",
+                                      int target_width = 0,
+                                      int target_height = 0,
+                                      int quality = 85,
+                                      const ImagePostProcessor& post_process = nullptr);
+
+    // Same pipeline with a full encoder profile instead of a bare quality
+    std::vector<char> transformBuffer(utils::ByteView input_data,
+                                      const std::string& target_format,
+                                      int target_width,
+                                      int target_height,
+                                      const EncoderProfile& encoder,
+                                      const ImagePostProcessor& post_process = nullptr);
+
+    // Same pipeline, encoded through a custom libvips target: output reaches
+    // sink in chunks while later strips are still being decoded, so memory
+    // per transform stays at libvips' strip buffers however large the
+    // rendition. Returns true once the whole image has been written
+    bool transformStream(utils::ByteView input_data,
+                         const std::string& target_format,
+                         int target_width,
+                         int target_height,
+                         const EncoderProfile& encoder,
+                         const EncodedChunkSink& sink,
+                         const ImagePostProcessor& post_process = nullptr);
+
+    // Produce several renditions from one source. The source is decoded once,
+    // with shrink-on-load down to the smallest size that still covers every
+    // target, and each output is resized from those in-memory pixels.
+    // Returns one entry per target in order; failed targets are empty
+    std::vector<std::vector<char>> transformBufferMany(utils::ByteView input_data,
+                                                       const std::vector<RenditionTarget>& targets,
+                                                       const ImagePostProcessor& post_process = nullptr);
+
+    // Write a DeepZoom pyramid for a full-size source: <output_dir>/image.dzi
+    // plus image_files/<level>/<col>_<row>.<ext>. The source is decoded once
+    // and every level is cut from it by dzsave. Returns true on success
+    bool generateTiles(utils::ByteView input_data,
+                       const std::string& output_dir,
+                       const TileConfig& config,
+                       const ImagePostProcessor& post_process = nullptr);
+
+    // Probe image header: opens the file once and never decodes pixels
     ImageInfo getImageInfo(const std::string& filepath);
 
-    // Validate if file is a valid image
+    // Probe an in-memory image header without decoding pixels
+    // (size_bytes is the encoded buffer size)
+    ImageInfo getBufferInfo(utils::ByteView input_data);
+
+    // Validate if file is a valid image (header probe)
     bool isValidImage(const std::string& filepath);
 
+    // BlurHash of the image for clients to show while renditions load.
+    // Decodes a PLACEHOLDER_SIZE thumbnail (shrink-on-load where the format
+    // allows); returns "" if the file cannot be decoded
+    std::string computePlaceholder(const std::string& filepath);
+
+    static constexpr int PLACEHOLDER_SIZE = 32;
+
 private:
+    // Lazy decode -> resize -> post-process graph shared by the single-output transforms
+    vips::VImage buildPipeline(utils::ByteView input_data, const std::string& target_format,
+                               int target_width, int target_height, const ImagePostProcessor& post_process);
+
+    // Frames to carry over: n-pages of an animated source when the target
+    // format can hold animation (webp, gif), otherwise 1
+    static int animationFrames(const vips::VImage& header, const std::string& target_format);
+
+    // Load and resize every frame of an animated source as one streamed,
+    // page-aware pipeline; target dimensions are per frame
+    vips::VImage thumbnailAnimated(utils::ByteView input_data, const vips::VImage& header,
+                                   int frames, int target_width, int target_height);
+
+    // Run a post-process step (e.g. watermarking) on each frame of an animated image
+    static vips::VImage applyPerFrame(const vips::VImage& image, const ImagePostProcessor& post_process);
+
+    // Resize image to target dimensions (0 keeps aspect ratio)
+    vips::VImage resizeImage(const vips::VImage& image, int target_width, int target_height);
+
+    // Resolve target dimensions from the source header and report whether
+    // the request is a downscale that should go through vips_thumbnail
+    bool resolveThumbnailSize(const vips::VImage& header, int& target_width, int& target_height);
+
+    // Options for vips_thumbnail producing exactly target_width x target_height
+    vips::VOption* createThumbnailOptions(int target_height);
+
+    // Decode the source once at a size covering every target box
+    vips::VImage decodeForTargets(const vips::VImage& header,
+                                  utils::ByteView input_data,
+                                  const std::vector<std::pair<int, int>>& sizes);
+
+    // Resize, post-process and encode one target from decoded pixels
+    std::vector<char> encodeTarget(const vips::VImage& decoded, const RenditionTarget& target,
+                                   int target_width, int target_height,
+                                   const ImagePostProcessor& post_process);
+
+    // Build encoder options for the target format
+    vips::VOption* createSaveOptions(const std::string& target_format, const EncoderProfile& profile);
+
+    // Baseline profile with the given quality
+    static EncoderProfile qualityProfile(int quality);
+
     // Calculate dimensions maintaining aspect ratio
     void calculateDimensions(int original_width, int original_height,
                            int& target_width, int& target_height);
 
+    // Map a loader name (e.g. "jpegload", "pngload_source") to a format name
+    static std::string loaderToFormat(const std::string& loader);
+
     // Convert format name to libvips suffix
     std::string formatToSuffix(const std::string& format);
 };
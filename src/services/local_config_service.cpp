@@ -1,64 +1,138 @@
 #include "local_config_service.h"
 #include "../utils/logger.h"
+#include <algorithm>
 #include <cstdlib>
+#include <fstream>
+#include <sstream>
 
 namespace gara {
 
-LocalConfigService::LocalConfigService(const std::string& api_key_env_var)
-    : api_key_env_var_(api_key_env_var), initialized_(false) {
-
-    // Try to read API key on initialization
-    cached_api_key_ = readApiKeyFromEnv();
-    initialized_ = !cached_api_key_.empty();
+LocalConfigService::LocalConfigService(const std::string& api_key_env_var,
+                                       const std::string& keys_file,
+                                       int refresh_seconds)
+    : api_key_env_var_(api_key_env_var),
+      keys_file_(keys_file),
+      refresh_interval_(std::max(1, refresh_seconds)) {
+
+    // Try to read API keys on initialization
+    {
+        std::lock_guard<utils::InstrumentedMutex> lock(reload_mutex_);
+        key_sets_.push_back(std::make_unique<const utils::ApiKeySet>(readApiKeys()));
+        keys_.store(key_sets_.back().get(), std::memory_order_release);
+    }
 
-    if (initialized_) {
-        LOG_INFO("Local config service initialized with API key from: {}", api_key_env_var_);
+    if (isInitialized()) {
+        LOG_INFO("Local config service initialized with {} API key(s) from: {}{}", activeKeyCount(),
+                 api_key_env_var_, keys_file_.empty() ? "" : " and " + keys_file_);
     } else {
         LOG_WARN("Local config service initialized but API key not found in: {}", api_key_env_var_);
     }
+
+    if (!keys_file_.empty()) {
+        refresher_ = std::thread(&LocalConfigService::refreshLoop, this);
+    }
 }
 
-std::string LocalConfigService::readApiKeyFromEnv() {
+LocalConfigService::~LocalConfigService() {
+    {
+        std::lock_guard<utils::InstrumentedMutex> lock(reload_mutex_);
+        stopping_ = true;
+    }
+    stop_cv_.notify_all();
+    if (refresher_.joinable()) {
+        refresher_.join();
+    }
+}
+
+std::vector<std::string> LocalConfigService::readApiKeys() {
+    std::vector<std::string> keys;
+
     const char* api_key = std::getenv(api_key_env_var_.c_str());
+    if (api_key != nullptr) {
+        keys = utils::ApiKeySet::parse(api_key);
+    }
 
-    if (api_key == nullptr || std::string(api_key).empty()) {
-        LOG_WARN("API key not found in environment variable: {}", api_key_env_var_);
-        return "";
+    if (!keys_file_.empty()) {
+        keys_file_mtime_ = keysFileMtime();
+        std::ifstream file(keys_file_);
+        if (file) {
+            std::ostringstream content;
+            content << file.rdbuf();
+            for (auto& key : utils::ApiKeySet::parse(content.str())) {
+                keys.push_back(std::move(key));
+            }
+        } else {
+            LOG_WARN("API keys file not readable: {}", keys_file_);
+        }
     }
 
-    return std::string(api_key);
+    return keys;
 }
 
-std::string LocalConfigService::getApiKey() {
-    std::lock_guard<std::mutex> lock(cache_mutex_);
+std::filesystem::file_time_type LocalConfigService::keysFileMtime() const {
+    std::error_code ec;
+    auto mtime = std::filesystem::last_write_time(keys_file_, ec);
+    // A missing file reads once, not on every tick
+    return ec ? std::filesystem::file_time_type::min() : mtime;
+}
+
+void LocalConfigService::install(std::vector<std::string> keys) {
+    auto next = std::make_unique<const utils::ApiKeySet>(keys);
+    const utils::ApiKeySet* current = keys_.load(std::memory_order_acquire);
+    if (next->sameKeys(*current)) {
+        return;
+    }
+
+    keys_.store(next.get(), std::memory_order_release);
+    key_sets_.push_back(std::move(next));
+
+    gara::Logger::log_structured(spdlog::level::info, "API keys reloaded", {
+        {"active_keys", key_sets_.back()->size()},
+        {"source", keys_file_.empty() ? api_key_env_var_ : keys_file_}
+    });
+}
 
-    if (cached_api_key_.empty()) {
-        // Try to refresh if not cached
-        cached_api_key_ = readApiKeyFromEnv();
-        initialized_ = !cached_api_key_.empty();
+std::string LocalConfigService::getApiKey() {
+    if (!isInitialized()) {
+        // Try to refresh if not configured yet
+        refreshApiKey();
     }
+    return keys_.load(std::memory_order_acquire)->primary();
+}
 
-    return cached_api_key_;
+bool LocalConfigService::validateApiKey(std::string_view provided_key) {
+    return keys_.load(std::memory_order_acquire)->matches(provided_key);
 }
 
 bool LocalConfigService::refreshApiKey() {
-    std::lock_guard<std::mutex> lock(cache_mutex_);
-
-    cached_api_key_ = readApiKeyFromEnv();
-    initialized_ = !cached_api_key_.empty();
+    std::lock_guard<utils::InstrumentedMutex> lock(reload_mutex_);
+    install(readApiKeys());
 
-    if (initialized_) {
-        LOG_DEBUG("API key refreshed from environment");
+    bool initialized = !keys_.load(std::memory_order_acquire)->empty();
+    if (initialized) {
+        LOG_DEBUG("API keys refreshed");
     } else {
-        LOG_ERROR("Failed to refresh API key - not found in environment");
+        LOG_ERROR("Failed to refresh API key - not found in {}", api_key_env_var_);
     }
-
-    return initialized_;
+    return initialized;
 }
 
 bool LocalConfigService::isInitialized() const {
-    std::lock_guard<std::mutex> lock(cache_mutex_);
-    return initialized_;
+    return !keys_.load(std::memory_order_acquire)->empty();
+}
+
+size_t LocalConfigService::activeKeyCount() const {
+    return keys_.load(std::memory_order_acquire)->size();
+}
+
+void LocalConfigService::refreshLoop() {
+    std::unique_lock<utils::InstrumentedMutex> lock(reload_mutex_);
+    while (!stop_cv_.wait_for(lock, refresh_interval_, [this]() { return stopping_; })) {
+        if (keysFileMtime() == keys_file_mtime_) {
+            continue;
+        }
+        install(readApiKeys());
+    }
 }
 
 } // namespace gara
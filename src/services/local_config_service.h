@@ -2,8 +2,17 @@
 #define GARA_LOCAL_CONFIG_SERVICE_H
 
 #include "../interfaces/config_service_interface.h"
-#include <string>
+#include "../utils/api_key_set.h"
+#include "../utils/instrumented_mutex.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <memory>
 #include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
 
 namespace gara {
 
@@ -12,24 +21,48 @@ namespace gara {
  *
  * This service reads configuration from environment variables
  * instead of AWS Secrets Manager for local development.
+ *
+ * Accepted keys come from the environment variable (comma-separated) and,
+ * optionally, a keys file with one key per line. The file is re-read in the
+ * background when it changes, so keys rotate without a restart: add the new
+ * key, move clients over, then remove the old one.
+ *
+ * Key checks read an immutable ApiKeySet through an atomic pointer and take
+ * no lock. Replaced sets are retired, not freed, until the service is
+ * destroyed, so a check racing with a reload never reads freed memory; a
+ * set is a few dozen bytes per key and only changes on rotation.
  */
 class LocalConfigService : public ConfigServiceInterface {
 public:
     /**
      * @brief Constructor
      * @param api_key_env_var Environment variable name for API key (default: "API_KEY")
+     * @param keys_file Optional file of accepted keys, watched for changes (empty disables)
+     * @param refresh_seconds How often the keys file is checked for changes
      */
-    explicit LocalConfigService(const std::string& api_key_env_var = "API_KEY");
+    explicit LocalConfigService(const std::string& api_key_env_var = "API_KEY",
+                                const std::string& keys_file = "",
+                                int refresh_seconds = 30);
+
+    ~LocalConfigService() override;
+
+    LocalConfigService(const LocalConfigService&) = delete;
+    LocalConfigService& operator=(const LocalConfigService&) = delete;
 
     /**
-     * @brief Get the API key from environment variable
+     * @brief Get the primary API key (the first one configured)
      * @return API key string, or empty string if not set
      */
     std::string getApiKey() override;
 
     /**
-     * @brief Force refresh the API key (re-reads from environment)
-     * @return true if API key is available, false otherwise
+     * @brief Lock-free check against every active key
+     */
+    bool validateApiKey(std::string_view provided_key) override;
+
+    /**
+     * @brief Force refresh the API keys (re-reads the environment and keys file)
+     * @return true if at least one API key is available, false otherwise
      */
     bool refreshApiKey() override;
 
@@ -45,17 +78,37 @@ public:
      */
     const std::string& getSecretName() const override { return api_key_env_var_; }
 
+    // Number of keys currently accepted
+    size_t activeKeyCount() const;
+
 private:
     std::string api_key_env_var_;
-    mutable std::mutex cache_mutex_;
-    std::string cached_api_key_;
-    bool initialized_;
+    std::string keys_file_;
+    std::chrono::seconds refresh_interval_;
+
+    std::atomic<const utils::ApiKeySet*> keys_;
+
+    utils::InstrumentedMutex reload_mutex_{"config_reload"};  // Serializes reloads; never taken by key checks
+    std::vector<std::unique_ptr<const utils::ApiKeySet>> key_sets_;  // Current and retired
+    std::filesystem::file_time_type keys_file_mtime_;
+
+    std::condition_variable_any stop_cv_;
+    bool stopping_ = false;
+    std::thread refresher_;
 
     /**
-     * @brief Read API key from environment variable
-     * @return API key value or empty string
+     * @brief Read API keys from the environment variable and keys file
+     * @return Keys in configuration order (may be empty)
      */
-    std::string readApiKeyFromEnv();
+    std::vector<std::string> readApiKeys();
+
+    // Publish a new key set if it differs from the current one; caller holds reload_mutex_
+    void install(std::vector<std::string> keys);
+
+    // Modification time of the keys file, or a fixed value while it is missing
+    std::filesystem::file_time_type keysFileMtime() const;
+
+    void refreshLoop();
 };
 
 } // namespace gara
@@ -2,11 +2,23 @@
 #include "../utils/logger.h"
 #include <fstream>
 #include <stdexcept>
+#include <sys/stat.h>
 
 namespace gara {
 
-LocalFileService::LocalFileService(const std::string& storage_path)
-    : storage_path_(storage_path) {
+LocalFileService::LocalFileService(const std::string& storage_path, const std::string& public_base_url)
+    : storage_path_(storage_path), public_base_url_(public_base_url) {
+
+    // Avoid "//files" when the base URL is configured with a trailing slash
+    while (!public_base_url_.empty() && public_base_url_.back() == '/') {
+        public_base_url_.pop_back();
+    }
+
+    // umask can only be read by setting it, so do it once here rather than
+    // racing file creation on other threads later
+    mode_t mask = ::umask(0);
+    ::umask(mask);
+    stored_file_perms_ = static_cast<std::filesystem::perms>(0644 & ~mask);
 
     // Create storage directory if it doesn't exist
     try {
@@ -22,6 +34,30 @@ std::filesystem::path LocalFileService::getFilePath(const std::string& key) cons
     return std::filesystem::path(storage_path_) / key;
 }
 
+std::filesystem::path LocalFileService::resolveServablePath(const std::string& key) const {
+    if (key.empty() || key.front() == '/' || key.find('\\') != std::string::npos ||
+        key.find('\0') != std::string::npos) {
+        return {};
+    }
+
+    // Keys come straight from the URL, so reject any "." or ".." segment
+    for (const auto& part : std::filesystem::path(key)) {
+        if (part == "." || part == ".." || part.empty()) {
+            return {};
+        }
+    }
+
+    return getFilePath(key);
+}
+
+void LocalFileService::applyStoredFilePerms(const std::filesystem::path& dest_path) {
+    std::error_code ec;
+    std::filesystem::permissions(dest_path, stored_file_perms_, ec);
+    if (ec) {
+        LOG_WARN("Failed to set permissions on {}: {}", dest_path.string(), ec.message());
+    }
+}
+
 bool LocalFileService::ensureDirectoryExists(const std::filesystem::path& file_path) {
     try {
         auto parent = file_path.parent_path();
@@ -46,6 +82,7 @@ bool LocalFileService::uploadFile(const std::string& local_path, const std::stri
 
         std::filesystem::copy_file(local_path, dest_path,
                                   std::filesystem::copy_options::overwrite_existing);
+        applyStoredFilePerms(dest_path);
 
         LOG_DEBUG("File uploaded: {} -> {}", local_path, dest_path.string());
         return true;
@@ -56,6 +93,34 @@ bool LocalFileService::uploadFile(const std::string& local_path, const std::stri
     }
 }
 
+bool LocalFileService::moveFileToStorage(const std::string& local_path, const std::string& key,
+                                         const std::string& content_type) {
+    try {
+        auto dest_path = getFilePath(key);
+
+        if (!ensureDirectoryExists(dest_path)) {
+            return false;
+        }
+
+        std::error_code ec;
+        std::filesystem::rename(local_path, dest_path, ec);
+        if (ec) {
+            // Different filesystem (e.g. TEMP_UPLOAD_DIR outside storage): copy instead
+            std::filesystem::copy_file(local_path, dest_path,
+                                      std::filesystem::copy_options::overwrite_existing);
+            std::filesystem::remove(local_path);
+        }
+        applyStoredFilePerms(dest_path);
+
+        LOG_DEBUG("File moved: {} -> {}", local_path, dest_path.string());
+        return true;
+
+    } catch (const std::filesystem::filesystem_error& e) {
+        LOG_ERROR("Failed to move file into storage: {}", e.what());
+        return false;
+    }
+}
+
 bool LocalFileService::uploadData(const std::vector<char>& data, const std::string& key,
                                   const std::string& content_type) {
     try {
@@ -143,6 +208,24 @@ std::vector<char> LocalFileService::downloadData(const std::string& key) {
     }
 }
 
+std::shared_ptr<const utils::MappedFile> LocalFileService::mapObject(const std::string& key) {
+    auto src_path = resolveServablePath(key);
+    if (src_path.empty()) {
+        LOG_ERROR("Refusing to map unsafe key: {}", key);
+        return nullptr;
+    }
+
+    std::shared_ptr<const utils::MappedFile> mapped = utils::MappedFile::open(src_path.string());
+    if (!mapped) {
+        // Missing or empty; downloadData reports it
+        LOG_DEBUG("Could not map file: {}", src_path.string());
+        return nullptr;
+    }
+
+    LOG_DEBUG("Data mapped: {} ({} bytes)", src_path.string(), mapped->size());
+    return mapped;
+}
+
 bool LocalFileService::objectExists(const std::string& key) {
     auto file_path = getFilePath(key);
     return std::filesystem::exists(file_path);
@@ -168,17 +251,14 @@ bool LocalFileService::deleteObject(const std::string& key) {
 }
 
 std::string LocalFileService::generatePresignedUrl(const std::string& key, int expiration_seconds) {
-    // For local file service, return a file:// URL or a path
-    // In a real HTTP server context, this would return a URL like http://localhost:8080/files/{key}
+    // Served by the /files/<key> route; expiry does not apply to local storage
     auto file_path = getFilePath(key);
 
     if (!std::filesystem::exists(file_path)) {
         LOG_WARN("Generating URL for non-existent file: {}", file_path.string());
     }
 
-    // Return as file:// URL for now
-    // In production, this should be an HTTP URL served by the application
-    return "file://" + file_path.string();
+    return public_base_url_ + "/files/" + key;
 }
 
 } // namespace gara
@@ -17,8 +17,9 @@ public:
     /**
      * @brief Constructor
      * @param storage_path Root directory for file storage (replaces bucket_name)
+     * @param public_base_url Origin prepended to /files/<key> URLs; empty yields relative URLs
      */
-    explicit LocalFileService(const std::string& storage_path);
+    explicit LocalFileService(const std::string& storage_path, const std::string& public_base_url = "");
 
     virtual ~LocalFileService() = default;
 
@@ -29,10 +30,16 @@ public:
     bool uploadData(const std::vector<char>& data, const std::string& key,
                    const std::string& content_type = "application/octet-stream") override;
 
+    bool moveFileToStorage(const std::string& local_path, const std::string& key,
+                           const std::string& content_type = "application/octet-stream") override;
+
     bool downloadFile(const std::string& key, const std::string& local_path) override;
 
     std::vector<char> downloadData(const std::string& key) override;
 
+    // Maps the stored file in place (no copy); the key gets the same checks as resolveServablePath
+    std::shared_ptr<const utils::MappedFile> mapObject(const std::string& key) override;
+
     bool objectExists(const std::string& key) override;
 
     bool deleteObject(const std::string& key) override;
@@ -41,8 +48,23 @@ public:
 
     const std::string& getBucketName() const override { return storage_path_; }
 
+    /**
+     * @brief Resolve a key to its path for direct serving
+     * @return Empty path if the key is malformed or would escape the storage root
+     */
+    std::filesystem::path resolveServablePath(const std::string& key) const;
+
 private:
     std::string storage_path_;
+    std::string public_base_url_;
+    std::filesystem::perms stored_file_perms_;  // 0644 under the process umask
+
+    /**
+     * @brief Give a stored file the mode uploadData would, rather than its source's
+     *
+     * Files moved or copied in from mkstemp temp files would otherwise stay 0600
+     */
+    void applyStoredFilePerms(const std::filesystem::path& dest_path);
 
     /**
      * @brief Get the full filesystem path for a key
@@ -0,0 +1,206 @@
+#include "otlp_exporter.h"
+#include "../utils/logger.h"
+#include "../utils/prometheus_registry.h"
+#include <chrono>
+#include <curl/curl.h>
+#include <mutex>
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
+
+namespace gara {
+
+namespace {
+
+constexpr int SPAN_KIND_INTERNAL = 1;
+constexpr int SPAN_KIND_SERVER = 2;
+constexpr int STATUS_CODE_ERROR = 2;
+
+json stringAttribute(const std::string& key, const std::string& value) {
+    return {{"key", key}, {"value", {{"stringValue", value}}}};
+}
+
+// OTLP/JSON follows the proto3 mapping, so 64-bit integers travel as strings
+json intAttribute(const std::string& key, int64_t value) {
+    return {{"key", key}, {"value", {{"intValue", std::to_string(value)}}}};
+}
+
+std::once_flag curl_init_flag;
+
+size_t discardBody(char*, size_t size, size_t count, void*) {
+    return size * count;
+}
+
+} // anonymous namespace
+
+OtlpExporter::OtlpExporter(const TracingConfig& config)
+    : config_(config), url_(config.otlp_endpoint) {
+    std::call_once(curl_init_flag, []() { curl_global_init(CURL_GLOBAL_DEFAULT); });
+    while (!url_.empty() && url_.back() == '/') {
+        url_.pop_back();
+    }
+    const std::string path = "/v1/traces";
+    if (url_.size() < path.size() || url_.compare(url_.size() - path.size(), path.size(), path) != 0) {
+        url_ += path;
+    }
+    worker_ = std::thread(&OtlpExporter::exportLoop, this);
+}
+
+OtlpExporter::~OtlpExporter() {
+    shutdown();
+}
+
+void OtlpExporter::enqueue(std::shared_ptr<utils::RequestTrace> trace) {
+    static auto& dropped = PrometheusRegistry::instance().counter(
+        "gara_traces_dropped_total", "Finished traces dropped because the export queue was full");
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_ || queue_.size() >= static_cast<size_t>(config_.max_queue_size)) {
+            dropped.inc();
+            return;
+        }
+        queue_.push_back(std::move(trace));
+        if (queue_.size() < static_cast<size_t>(config_.max_batch_size)) {
+            return;  // The flush interval picks it up
+        }
+    }
+    cv_.notify_one();
+}
+
+void OtlpExporter::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_) {
+            return;
+        }
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+}
+
+void OtlpExporter::exportLoop() {
+    static auto& exported = PrometheusRegistry::instance().counter(
+        "gara_traces_exported_total", "Traces sent to the OTLP collector", {{"result", "success"}});
+    static auto& failed = PrometheusRegistry::instance().counter(
+        "gara_traces_exported_total", "Traces sent to the OTLP collector", {{"result", "error"}});
+
+    const size_t batch_size = static_cast<size_t>(config_.max_batch_size);
+    for (;;) {
+        std::vector<std::shared_ptr<utils::RequestTrace>> batch;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait_for(lock, std::chrono::milliseconds(config_.flush_interval_ms), [this, batch_size]() {
+                return stopping_ || queue_.size() >= batch_size;
+            });
+            if (queue_.empty()) {
+                if (stopping_) {
+                    return;
+                }
+                continue;
+            }
+            size_t count = std::min(batch_size, queue_.size());
+            batch.reserve(count);
+            for (size_t i = 0; i < count; ++i) {
+                batch.push_back(std::move(queue_.front()));
+                queue_.pop_front();
+            }
+        }
+
+        if (post(buildPayload(batch, config_.service_name))) {
+            exported.inc(static_cast<double>(batch.size()));
+        } else {
+            failed.inc(static_cast<double>(batch.size()));
+        }
+    }
+}
+
+bool OtlpExporter::post(const std::string& payload) {
+    CURL* handle = curl_easy_init();
+    if (!handle) {
+        return false;
+    }
+
+    curl_slist* headers = curl_slist_append(nullptr, "Content-Type: application/json");
+    curl_easy_setopt(handle, CURLOPT_URL, url_.c_str());
+    curl_easy_setopt(handle, CURLOPT_HTTPHEADER, headers);
+    curl_easy_setopt(handle, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(handle, CURLOPT_TIMEOUT_MS, static_cast<long>(config_.export_timeout_ms));
+    curl_easy_setopt(handle, CURLOPT_POST, 1L);
+    curl_easy_setopt(handle, CURLOPT_POSTFIELDS, payload.data());
+    curl_easy_setopt(handle, CURLOPT_POSTFIELDSIZE_LARGE, static_cast<curl_off_t>(payload.size()));
+    curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, discardBody);
+
+    CURLcode code = curl_easy_perform(handle);
+    long status = 0;
+    if (code == CURLE_OK) {
+        curl_easy_getinfo(handle, CURLINFO_RESPONSE_CODE, &status);
+    }
+    curl_slist_free_all(headers);
+    curl_easy_cleanup(handle);
+
+    if (code != CURLE_OK || status < 200 || status >= 300) {
+        gara::Logger::log_structured(spdlog::level::warn, "OTLP trace export failed", {
+            {"endpoint", url_},
+            {"status", status},
+            {"error", code != CURLE_OK ? curl_easy_strerror(code) : "unexpected status"}
+        });
+        return false;
+    }
+    return true;
+}
+
+std::string OtlpExporter::buildPayload(const std::vector<std::shared_ptr<utils::RequestTrace>>& traces,
+                                       const std::string& service_name) {
+    json spans = json::array();
+    for (const auto& trace : traces) {
+        json root = {
+            {"traceId", trace->traceId()},
+            {"spanId", trace->spanId()},
+            {"name", trace->method() + " " + trace->route()},
+            {"kind", SPAN_KIND_SERVER},
+            {"startTimeUnixNano", std::to_string(trace->unixNanos(trace->start()))},
+            {"endTimeUnixNano", std::to_string(trace->unixNanos(trace->end()))},
+            {"attributes", json::array({
+                stringAttribute("http.request.method", trace->method()),
+                stringAttribute("http.route", trace->route()),
+                intAttribute("http.response.status_code", trace->status()),
+                stringAttribute("gara.request_id", trace->requestId())
+            })}
+        };
+        if (!trace->parentSpanId().empty()) {
+            root["parentSpanId"] = trace->parentSpanId();
+        }
+        if (trace->status() >= 500) {
+            root["status"] = {{"code", STATUS_CODE_ERROR}};
+        }
+        spans.push_back(std::move(root));
+
+        for (const auto& span : trace->spans()) {
+            spans.push_back({
+                {"traceId", trace->traceId()},
+                {"spanId", span.span_id},
+                {"parentSpanId", trace->spanId()},
+                {"name", span.name},
+                {"kind", SPAN_KIND_INTERNAL},
+                {"startTimeUnixNano", std::to_string(trace->unixNanos(span.start))},
+                {"endTimeUnixNano", std::to_string(trace->unixNanos(span.end))}
+            });
+        }
+    }
+
+    json payload = {
+        {"resourceSpans", json::array({{
+            {"resource", {{"attributes", json::array({stringAttribute("service.name", service_name)})}}},
+            {"scopeSpans", json::array({{
+                {"scope", {{"name", "gara"}}},
+                {"spans", std::move(spans)}
+            }})}
+        }})}
+    };
+    return payload.dump();
+}
+
+} // namespace gara
@@ -0,0 +1,65 @@
+#ifndef GARA_OTLP_EXPORTER_H
+#define GARA_OTLP_EXPORTER_H
+
+#include "../models/tracing_config.h"
+#include "../utils/trace.h"
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace gara {
+
+/**
+ * @brief Ships finished request traces to an OpenTelemetry collector
+ *
+ * Traces are queued by the request thread and sent in batches as OTLP/HTTP
+ * JSON (POST {endpoint}/v1/traces) from one background thread, so a slow
+ * or unreachable collector never adds request latency. When the queue is
+ * full new traces are dropped and counted.
+ */
+class OtlpExporter {
+public:
+    explicit OtlpExporter(const TracingConfig& config);
+    ~OtlpExporter();
+
+    OtlpExporter(const OtlpExporter&) = delete;
+    OtlpExporter& operator=(const OtlpExporter&) = delete;
+
+    // Queue a finished, sampled trace; never blocks
+    void enqueue(std::shared_ptr<utils::RequestTrace> trace);
+
+    // Send what is queued and stop the export thread
+    void shutdown();
+
+    /**
+     * @brief ExportTraceServiceRequest JSON for a batch of finished traces
+     *
+     * Each trace becomes a SERVER root span named "<method> <route>" with one
+     * INTERNAL child per recorded stage.
+     */
+    static std::string buildPayload(const std::vector<std::shared_ptr<utils::RequestTrace>>& traces,
+                                    const std::string& service_name);
+
+    const std::string& url() const { return url_; }
+
+private:
+    void exportLoop();
+    bool post(const std::string& payload);
+
+    TracingConfig config_;
+    std::string url_;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<std::shared_ptr<utils::RequestTrace>> queue_;
+    bool stopping_ = false;
+    std::thread worker_;
+};
+
+} // namespace gara
+
+#endif // GARA_OTLP_EXPORTER_H
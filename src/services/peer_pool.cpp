@@ -0,0 +1,192 @@
+#include "peer_pool.h"
+#include "../utils/logger.h"
+#include "../utils/prometheus_registry.h"
+#include <arpa/inet.h>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <curl/curl.h>
+#include <mutex>
+#include <netdb.h>
+#include <set>
+#include <strings.h>
+
+namespace gara {
+
+namespace {
+
+std::once_flag curl_init_flag;
+
+size_t appendBody(char* data, size_t size, size_t count, void* user) {
+    static_cast<std::string*>(user)->append(data, size * count);
+    return size * count;
+}
+
+size_t readRetryAfter(char* data, size_t size, size_t count, void* user) {
+    static const char NAME[] = "Retry-After:";
+    size_t length = size * count;
+    if (length > sizeof(NAME) - 1 && strncasecmp(data, NAME, sizeof(NAME) - 1) == 0) {
+        *static_cast<int*>(user) = std::atoi(std::string(data + sizeof(NAME) - 1, length - sizeof(NAME) + 1).c_str());
+    }
+    return length;
+}
+
+} // anonymous namespace
+
+PeerPool::PeerPool(const PeerConfig& config)
+    : config_(config), mutex_("peer_ring") {
+    std::call_once(curl_init_flag, []() { curl_global_init(CURL_GLOBAL_DEFAULT); });
+
+    std::vector<std::string> members = config_.urls;
+    if (!config_.dns_name.empty()) {
+        members = resolve(config_.dns_name, config_.port);
+    }
+    setMembers(std::move(members));
+
+    if (!config_.dns_name.empty()) {
+        refresher_ = std::thread(&PeerPool::refreshLoop, this);
+    }
+}
+
+PeerPool::~PeerPool() {
+    {
+        std::lock_guard<utils::InstrumentedMutex> lock(mutex_);
+        stopping_ = true;
+    }
+    stop_cv_.notify_all();
+    if (refresher_.joinable()) {
+        refresher_.join();
+    }
+}
+
+std::string PeerPool::ownerOf(const std::string& key) const {
+    std::shared_ptr<const utils::ConsistentHashRing> ring;
+    {
+        std::lock_guard<utils::InstrumentedMutex> lock(mutex_);
+        ring = ring_;
+    }
+    const std::string& owner = ring->ownerOf(key);
+    return owner == config_.self_url ? "" : owner;
+}
+
+std::vector<std::string> PeerPool::members() const {
+    std::lock_guard<utils::InstrumentedMutex> lock(mutex_);
+    return ring_->members();
+}
+
+void PeerPool::setMembers(std::vector<std::string> members) {
+    for (auto& member : members) {
+        member = PeerConfig::normalizeUrl(member);
+    }
+    members.push_back(config_.self_url);
+
+    auto ring = std::make_shared<utils::ConsistentHashRing>(config_.virtual_nodes);
+    ring->setMembers(std::move(members));
+
+    static auto& member_gauge = PrometheusRegistry::instance().gauge(
+        "gara_peer_members", "Members of the peer cache ring, this node included");
+    member_gauge.set(static_cast<double>(ring->members().size()));
+
+    std::vector<std::string> current = ring->members();
+    std::vector<std::string> previous;
+    {
+        std::lock_guard<utils::InstrumentedMutex> lock(mutex_);
+        if (ring_) {
+            previous = ring_->members();
+        }
+        ring_ = std::move(ring);
+    }
+
+    if (previous != current) {
+        gara::Logger::log_structured(spdlog::level::info, "Peer membership changed", {
+            {"members", current.size()},
+            {"previous_members", previous.size()}
+        });
+    }
+}
+
+PeerPool::Response PeerPool::get(const std::string& owner_url, const std::string& path) const {
+    Response response;
+    CURL* handle = curl_easy_init();
+    if (!handle) {
+        return response;
+    }
+
+    std::string url = owner_url + path;
+    std::string peer_header = std::string(PEER_HEADER) + ": " + config_.self_url;
+    curl_slist* headers = curl_slist_append(nullptr, peer_header.c_str());
+    if (!config_.api_key.empty()) {
+        headers = curl_slist_append(headers, ("X-API-Key: " + config_.api_key).c_str());
+    }
+    curl_easy_setopt(handle, CURLOPT_URL, url.c_str());
+    curl_easy_setopt(handle, CURLOPT_HTTPHEADER, headers);
+    curl_easy_setopt(handle, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(handle, CURLOPT_TIMEOUT_MS, static_cast<long>(config_.timeout_ms));
+    curl_easy_setopt(handle, CURLOPT_CONNECTTIMEOUT_MS, static_cast<long>(config_.connect_timeout_ms));
+    curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, appendBody);
+    curl_easy_setopt(handle, CURLOPT_WRITEDATA, &response.body);
+    curl_easy_setopt(handle, CURLOPT_HEADERFUNCTION, readRetryAfter);
+    curl_easy_setopt(handle, CURLOPT_HEADERDATA, &response.retry_after_seconds);
+
+    CURLcode code = curl_easy_perform(handle);
+    if (code == CURLE_OK) {
+        curl_easy_getinfo(handle, CURLINFO_RESPONSE_CODE, &response.status);
+    } else {
+        gara::Logger::log_structured(spdlog::level::warn, "Peer request failed", {
+            {"peer", owner_url},
+            {"error", curl_easy_strerror(code)}
+        });
+        response.body.clear();
+    }
+    curl_slist_free_all(headers);
+    curl_easy_cleanup(handle);
+    return response;
+}
+
+std::vector<std::string> PeerPool::resolve(const std::string& name, int port) {
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+
+    addrinfo* results = nullptr;
+    int rc = getaddrinfo(name.c_str(), nullptr, &hints, &results);
+    if (rc != 0) {
+        gara::Logger::log_structured(spdlog::level::warn, "Failed to resolve peers", {
+            {"dns_name", name},
+            {"error", gai_strerror(rc)}
+        });
+        return {};
+    }
+
+    // One entry per address; getaddrinfo repeats them per protocol
+    std::set<std::string> urls;
+    for (addrinfo* entry = results; entry != nullptr; entry = entry->ai_next) {
+        char address[INET6_ADDRSTRLEN] = {0};
+        if (entry->ai_family == AF_INET) {
+            inet_ntop(AF_INET, &reinterpret_cast<sockaddr_in*>(entry->ai_addr)->sin_addr, address, sizeof(address));
+            urls.insert("http://" + std::string(address) + ":" + std::to_string(port));
+        } else if (entry->ai_family == AF_INET6) {
+            inet_ntop(AF_INET6, &reinterpret_cast<sockaddr_in6*>(entry->ai_addr)->sin6_addr, address,
+                      sizeof(address));
+            urls.insert("http://[" + std::string(address) + "]:" + std::to_string(port));
+        }
+    }
+    freeaddrinfo(results);
+    return std::vector<std::string>(urls.begin(), urls.end());
+}
+
+void PeerPool::refreshLoop() {
+    std::unique_lock<utils::InstrumentedMutex> lock(mutex_);
+    auto interval = std::chrono::seconds(config_.refresh_seconds);
+    while (!stop_cv_.wait_for(lock, interval, [this]() { return stopping_; })) {
+        lock.unlock();
+        // A failed lookup keeps the last membership rather than collapsing ownership onto this node
+        std::vector<std::string> members = resolve(config_.dns_name, config_.port);
+        if (!members.empty()) {
+            setMembers(std::move(members));
+        }
+        lock.lock();
+    }
+}
+
+} // namespace gara
@@ -0,0 +1,76 @@
+#ifndef GARA_PEER_POOL_H
+#define GARA_PEER_POOL_H
+
+#include "../models/peer_config.h"
+#include "../utils/consistent_hash.h"
+#include "../utils/instrumented_mutex.h"
+#include <condition_variable>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace gara {
+
+/**
+ * @brief Cluster membership and key ownership for peer caching
+ *
+ * Every node hashes rendition cache keys onto the same consistent hash ring,
+ * so they agree on which node owns a key. Non-owners ask the owner instead
+ * of transforming themselves, which makes single-flight and the rendition
+ * memory cache cluster-wide: a cold rendition is generated once, by its
+ * owner, however many nodes receive requests for it.
+ *
+ * Members come from PEER_URLS or, with PEER_DNS_NAME, from the addresses the
+ * name resolves to, re-resolved every PEER_REFRESH_SECONDS. This node is
+ * always a member. Lookups copy a shared pointer to an immutable ring.
+ */
+class PeerPool {
+public:
+    struct Response {
+        long status = 0;               // 0 when the peer could not be reached
+        std::string body;
+        int retry_after_seconds = 0;   // From Retry-After on a 503
+    };
+
+    // Header marking a request as forwarded; such requests are never forwarded again
+    static constexpr const char* PEER_HEADER = "X-Gara-Peer";
+
+    explicit PeerPool(const PeerConfig& config);
+    ~PeerPool();
+
+    PeerPool(const PeerPool&) = delete;
+    PeerPool& operator=(const PeerPool&) = delete;
+
+    // Base URL of the member owning key, or "" when this node owns it
+    std::string ownerOf(const std::string& key) const;
+
+    std::vector<std::string> members() const;
+
+    // Replace the membership (this node is added if missing)
+    void setMembers(std::vector<std::string> members);
+
+    // GET owner_url + path with the peer headers
+    Response get(const std::string& owner_url, const std::string& path) const;
+
+    const PeerConfig& config() const { return config_; }
+
+    // http://<address>:<port> for every address name resolves to (empty on failure)
+    static std::vector<std::string> resolve(const std::string& name, int port);
+
+private:
+    void refreshLoop();
+
+    PeerConfig config_;
+
+    mutable utils::InstrumentedMutex mutex_;
+    std::shared_ptr<const utils::ConsistentHashRing> ring_;
+
+    bool stopping_ = false;
+    std::condition_variable_any stop_cv_;
+    std::thread refresher_;
+};
+
+} // namespace gara
+
+#endif // GARA_PEER_POOL_H
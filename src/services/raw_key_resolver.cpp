@@ -0,0 +1,114 @@
+#include "raw_key_resolver.h"
+#include "../models/image_metadata.h"
+#include "../utils/logger.h"
+#include "../utils/metrics.h"
+#include <future>
+#include <vector>
+
+namespace gara {
+
+namespace {
+// Extensions raw originals may have been stored under
+const std::vector<std::string> RAW_IMAGE_EXTENSIONS = {"jpg", "jpeg", "png", "gif", "bmp", "tiff", "webp"};
+}
+
+RawKeyResolver::RawKeyResolver(std::shared_ptr<DatabaseClientInterface> db_client,
+                               std::shared_ptr<FileServiceInterface> file_service,
+                               size_t max_bytes)
+    : db_client_(db_client),
+      file_service_(file_service),
+      keys_(max_bytes, std::chrono::seconds(0)) {
+}
+
+std::string RawKeyResolver::lookup(const std::string& image_id) {
+    if (auto cached = keys_.get(image_id)) {
+        return *cached;
+    }
+
+    if (db_client_) {
+        auto metadata = db_client_->getImageMetadata(image_id);
+        if (metadata && !metadata->s3_raw_key.empty()) {
+            METRICS_COUNT("RawKeyLookups", 1.0, "Count", {{"source", "database"}});
+            remember(image_id, metadata->s3_raw_key);
+            return metadata->s3_raw_key;
+        }
+    }
+    return "";
+}
+
+std::string RawKeyResolver::resolve(const std::string& image_id) {
+    return resolveAll({image_id}).front();
+}
+
+std::vector<std::string> RawKeyResolver::resolveAll(const std::vector<std::string>& image_ids) {
+    std::vector<std::string> keys(image_ids.size());
+    std::vector<std::string> unresolved_ids;
+    std::vector<size_t> unresolved;
+
+    for (size_t i = 0; i < image_ids.size(); ++i) {
+        keys[i] = lookup(image_ids[i]);
+        if (keys[i].empty()) {
+            unresolved.push_back(i);
+            unresolved_ids.push_back(image_ids[i]);
+        }
+    }
+    if (unresolved.empty()) {
+        return keys;
+    }
+
+    std::vector<std::string> probed = probeStorage(unresolved_ids);
+    for (size_t j = 0; j < unresolved.size(); ++j) {
+        if (probed[j].empty()) {
+            METRICS_COUNT("RawKeyLookups", 1.0, "Count", {{"source", "none"}});
+            continue;
+        }
+        METRICS_COUNT("RawKeyLookups", 1.0, "Count", {{"source", "probe"}});
+        remember(unresolved_ids[j], probed[j]);
+        keys[unresolved[j]] = probed[j];
+    }
+    return keys;
+}
+
+void RawKeyResolver::remember(const std::string& image_id, const std::string& raw_key) {
+    keys_.put(image_id, raw_key, image_id.size() + raw_key.size() + 64);
+}
+
+std::vector<std::pair<std::string, std::string>> RawKeyResolver::hotMappings(size_t limit) {
+    return keys_.snapshot(limit);
+}
+
+void RawKeyResolver::forget(const std::string& image_id) {
+    keys_.erase(image_id);
+}
+
+std::vector<std::string> RawKeyResolver::probeStorage(const std::vector<std::string>& image_ids) {
+    std::vector<std::string> keys(image_ids.size());
+    if (!file_service_) {
+        return keys;
+    }
+
+    std::vector<std::vector<std::future<bool>>> probes(image_ids.size());
+    for (size_t i = 0; i < image_ids.size(); ++i) {
+        for (const auto& ext : RAW_IMAGE_EXTENSIONS) {
+            probes[i].push_back(file_service_->objectExistsAsync(ImageMetadata::generateRawKey(image_ids[i], ext)));
+        }
+    }
+
+    // Wait for every probe; the first extension (in list order) that exists wins
+    for (size_t i = 0; i < image_ids.size(); ++i) {
+        for (size_t e = 0; e < probes[i].size(); ++e) {
+            bool exists = probes[i][e].get();
+            if (exists && keys[i].empty()) {
+                keys[i] = ImageMetadata::generateRawKey(image_ids[i], RAW_IMAGE_EXTENSIONS[e]);
+                gara::Logger::log_structured(spdlog::level::debug, "Resolved raw key by probing storage", {
+                    {"image_id", image_ids[i]},
+                    {"raw_key", keys[i]}
+                });
+            }
+        }
+    }
+
+    return keys;
+}
+
+} // namespace gara
@@ -0,0 +1,78 @@
+#ifndef GARA_RAW_KEY_RESOLVER_H
+#define GARA_RAW_KEY_RESOLVER_H
+
+#include "../interfaces/database_client_interface.h"
+#include "../interfaces/file_service_interface.h"
+#include "../utils/lru_cache.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace gara {
+
+/**
+ * @brief Resolves the storage key of an image's raw (original) object
+ *
+ * Lookup order: in-memory id->key map, then image metadata in the database,
+ * then (for images uploaded without metadata) probing the storage backend
+ * over the known original extensions. Raw keys are content addressed and
+ * never change, so resolved keys are cached without expiry.
+ */
+class RawKeyResolver {
+public:
+    /**
+     * @param db_client Database client used for metadata lookups (may be nullptr)
+     * @param file_service File service used for the probing fallback
+     * @param max_bytes Memory budget for the id->key map
+     */
+    RawKeyResolver(std::shared_ptr<DatabaseClientInterface> db_client,
+                   std::shared_ptr<FileServiceInterface> file_service,
+                   size_t max_bytes = 4 * 1024 * 1024);
+
+    /**
+     * @brief Resolve the raw storage key for an image
+     * @param image_id Image ID (SHA256 hash)
+     * @return Raw storage key, or empty string if the image is unknown
+     */
+    std::string resolve(const std::string& image_id);
+
+    /**
+     * @brief Resolve many images at once
+     *
+     * Storage probes for every unresolved image are issued together through
+     * the asynchronous file service API instead of one after another.
+     * @return Raw keys in input order; empty for unknown images
+     */
+    std::vector<std::string> resolveAll(const std::vector<std::string>& image_ids);
+
+    /**
+     * @brief Record a raw key known to exist (e.g. right after upload)
+     */
+    void remember(const std::string& image_id, const std::string& raw_key);
+
+    /**
+     * @brief Cached (image_id, raw_key) pairs, most recently used first, for a hot-set snapshot
+     */
+    std::vector<std::pair<std::string, std::string>> hotMappings(size_t limit);
+
+    /**
+     * @brief Drop a cached mapping (e.g. after the raw object is deleted)
+     */
+    void forget(const std::string& image_id);
+
+private:
+    std::shared_ptr<DatabaseClientInterface> db_client_;
+    std::shared_ptr<FileServiceInterface> file_service_;
+    utils::ShardedLruCache<std::string> keys_;
+
+    // Cached key or metadata lookup; empty if the image needs probing
+    std::string lookup(const std::string& image_id);
+
+    // Fallback for images without metadata: probe each known extension,
+    // with all probes in flight at once
+    std::vector<std::string> probeStorage(const std::vector<std::string>& image_ids);
+};
+
+} // namespace gara
+
+#endif // GARA_RAW_KEY_RESOLVER_H
@@ -0,0 +1,251 @@
+#include "render_job_worker.h"
+#include "../utils/id_generator.h"
+#include "../utils/logger.h"
+#include "../utils/metrics.h"
+#include <chrono>
+#include <ctime>
+#include <optional>
+
+namespace gara {
+
+namespace {
+
+// Images read per page while a backfill walks the images table
+constexpr int BACKFILL_PAGE_SIZE = 1000;
+
+} // anonymous namespace
+
+RenderJobWorker::RenderJobWorker(const RenderJobConfig& config,
+                                 std::shared_ptr<DatabaseClientInterface> db_client,
+                                 BatchHandler handler,
+                                 CapacityProbe has_capacity)
+    : config_(config),
+      db_client_(std::move(db_client)),
+      handler_(std::move(handler)),
+      has_capacity_(std::move(has_capacity)) {}
+
+RenderJobWorker::~RenderJobWorker() {
+    stop();
+}
+
+void RenderJobWorker::start() {
+    workers_.reserve(static_cast<size_t>(config_.workers));
+    for (int i = 0; i < config_.workers; ++i) {
+        workers_.emplace_back(&RenderJobWorker::workerLoop, this);
+    }
+}
+
+void RenderJobWorker::stop() {
+    {
+        std::lock_guard<std::mutex> lock(stop_mutex_);
+        stopping_ = true;
+    }
+    stop_cv_.notify_all();
+
+    for (auto& worker : workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    if (backfill_thread_.joinable()) {
+        backfill_thread_.join();
+    }
+}
+
+bool RenderJobWorker::waitPoll() {
+    std::unique_lock<std::mutex> lock(stop_mutex_);
+    return !stop_cv_.wait_for(lock, std::chrono::milliseconds(config_.poll_interval_ms),
+                              [this]() { return stopping_; });
+}
+
+void RenderJobWorker::workerLoop() {
+    while (true) {
+        size_t claimed = 0;
+        try {
+            claimed = runOnce();
+        } catch (const std::exception& e) {
+            gara::Logger::log_structured(spdlog::level::err, "Render job round failed", {
+                {"error", e.what()}
+            });
+        }
+
+        // Keep going while there is work; otherwise wait for more or for capacity
+        if (claimed > 0) {
+            std::lock_guard<std::mutex> lock(stop_mutex_);
+            if (stopping_) {
+                return;
+            }
+        } else if (!waitPoll()) {
+            return;
+        }
+    }
+}
+
+size_t RenderJobWorker::runOnce() {
+    if (!hasCapacity()) {
+        return 0;
+    }
+
+    std::time_t now = std::time(nullptr);
+    std::string lease_token = utils::IdGenerator::generateRequestId();
+    std::vector<RenderJob> jobs = db_client_->claimRenderJobs(lease_token, config_.batch_images, now,
+                                                              now + config_.lease_seconds);
+
+    // Claimed jobs arrive grouped by image
+    for (size_t start = 0; start < jobs.size();) {
+        size_t end = start;
+        while (end < jobs.size() && jobs[end].image_id == jobs[start].image_id) {
+            ++end;
+        }
+        std::vector<RenderJob> image_jobs(jobs.begin() + start, jobs.begin() + end);
+
+        // Later images of the round wait for spare capacity too
+        while (start > 0 && !hasCapacity()) {
+            if (!waitPoll()) {
+                return jobs.size();
+            }
+        }
+
+        std::vector<RenderJobResult> results;
+        try {
+            results = handler_(image_jobs.front().image_id, image_jobs);
+        } catch (const std::exception& e) {
+            results.assign(image_jobs.size(), RenderJobResult{RenderJobOutcome::RETRY, e.what()});
+        }
+        results.resize(image_jobs.size());
+        settle(lease_token, image_jobs, results);
+        start = end;
+    }
+    return jobs.size();
+}
+
+void RenderJobWorker::settle(const std::string& lease_token, const std::vector<RenderJob>& jobs,
+                             const std::vector<RenderJobResult>& results) {
+    std::time_t now = std::time(nullptr);
+    std::vector<int64_t> done;
+    size_t retried = 0;
+    size_t failed = 0;
+
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        const RenderJob& job = jobs[i];
+        const RenderJobResult& result = results[i];
+        if (result.outcome == RenderJobOutcome::DONE) {
+            done.push_back(job.job_id);
+            continue;
+        }
+
+        if (result.outcome == RenderJobOutcome::RETRY && job.attempts < config_.max_attempts) {
+            db_client_->releaseRenderJob(lease_token, job.job_id, now + config_.retryDelaySeconds(job.attempts),
+                                         result.error);
+            ++retried;
+            continue;
+        }
+
+        db_client_->releaseRenderJob(lease_token, job.job_id, std::nullopt, result.error);
+        ++failed;
+        gara::Logger::log_structured(spdlog::level::warn, "Render job failed", {
+            {"job_id", job.job_id},
+            {"image_id", job.image_id},
+            {"format", job.format},
+            {"width", job.width},
+            {"height", job.height},
+            {"attempts", job.attempts},
+            {"error", result.error}
+        });
+    }
+
+    if (!done.empty()) {
+        if (!db_client_->completeRenderJobs(lease_token, done)) {
+            // Left leased; they are claimed again and found in the cache
+            gara::Logger::log_structured(spdlog::level::warn, "Failed to remove finished render jobs", {
+                {"image_id", jobs.front().image_id},
+                {"jobs", done.size()}
+            });
+        }
+        METRICS_COUNT("RenderJobs", static_cast<double>(done.size()), "Count", {{"status", "done"}});
+    }
+    if (retried > 0) {
+        METRICS_COUNT("RenderJobs", static_cast<double>(retried), "Count", {{"status", "retry"}});
+    }
+    if (failed > 0) {
+        METRICS_COUNT("RenderJobs", static_cast<double>(failed), "Count", {{"status", "failed"}});
+    }
+}
+
+bool RenderJobWorker::startBackfill(const std::vector<RenderJob>& renditions, int priority) {
+    if (backfill_running_.exchange(true, std::memory_order_acq_rel)) {
+        return false;
+    }
+    if (backfill_thread_.joinable()) {
+        backfill_thread_.join();  // The previous backfill has finished
+    }
+    backfill_thread_ = std::thread([this, renditions, priority]() {
+        try {
+            backfill(renditions, priority);
+        } catch (const std::exception& e) {
+            gara::Logger::log_structured(spdlog::level::err, "Render job backfill failed", {
+                {"error", e.what()}
+            });
+        }
+        backfill_running_.store(false, std::memory_order_release);
+    });
+    return true;
+}
+
+size_t RenderJobWorker::backfill(const std::vector<RenderJob>& renditions, int priority) {
+    auto started = std::chrono::steady_clock::now();
+    size_t images = 0;
+    size_t queued = 0;
+    std::optional<ImagePageCursor> after;
+
+    while (!renditions.empty()) {
+        {
+            std::lock_guard<std::mutex> lock(stop_mutex_);
+            if (stopping_) {
+                break;
+            }
+        }
+
+        std::vector<ImageMetadata> page = db_client_->listImagesAfter(BACKFILL_PAGE_SIZE, ImageSortOrder::OLDEST, after);
+        if (page.empty()) {
+            break;
+        }
+
+        std::time_t now = std::time(nullptr);
+        std::vector<RenderJob> jobs;
+        jobs.reserve(page.size() * renditions.size());
+        for (const auto& image : page) {
+            for (const auto& rendition : renditions) {
+                RenderJob job = rendition;
+                job.image_id = image.image_id;
+                job.priority = priority;
+                job.run_after = now;
+                jobs.push_back(std::move(job));
+            }
+        }
+        if (!db_client_->enqueueRenderJobs(jobs)) {
+            gara::Logger::log_structured(spdlog::level::err, "Render job backfill stopped: failed to queue jobs", {
+                {"images", images},
+                {"jobs_queued", queued}
+            });
+            return queued;
+        }
+
+        images += page.size();
+        queued += jobs.size();
+        after = ImagePageCursor::fromImage(page.back());
+        if (page.size() < static_cast<size_t>(BACKFILL_PAGE_SIZE)) {
+            break;
+        }
+    }
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - started);
+    gara::Logger::log_structured(spdlog::level::info, "Render job backfill queued", {
+        {"images", images},
+        {"jobs_queued", queued},
+        {"duration_ms", elapsed.count()}
+    });
+    return queued;
+}
+
+} // namespace gara
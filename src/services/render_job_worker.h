@@ -0,0 +1,122 @@
+#ifndef GARA_RENDER_JOB_WORKER_H
+#define GARA_RENDER_JOB_WORKER_H
+
+#include "../interfaces/database_client_interface.h"
+#include "../models/render_job_config.h"
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace gara {
+
+// What became of one job after its image was rendered
+enum class RenderJobOutcome {
+    DONE,    // Rendition is in the cache
+    RETRY,   // Transient failure; retried with backoff until max_attempts
+    FAILED   // Can never succeed (unknown image, invalid parameters)
+};
+
+struct RenderJobResult {
+    RenderJobOutcome outcome = RenderJobOutcome::RETRY;
+    std::string error;  // Kept on the job row unless DONE
+};
+
+/**
+ * @brief Workers draining the durable render job queue
+ *
+ * Each round a worker leases the ready jobs of a few images (highest
+ * priority first) and hands each image's jobs to the batch handler in one
+ * call, so a single decode serves every rendition of an image. Work is only
+ * claimed while the capacity probe reports spare transform workers, so a
+ * backfill of millions of renditions yields to foreground requests.
+ *
+ * Finished jobs are removed. Failed attempts are retried with exponential
+ * backoff, and a job that exhausts max_attempts stays in the table as
+ * failed. Jobs leased by an instance that died are claimed again once their
+ * lease runs out, so nothing queued is lost to a restart.
+ */
+class RenderJobWorker {
+public:
+    // Render one image's jobs; returns a result per job, in order
+    using BatchHandler = std::function<std::vector<RenderJobResult>(const std::string& image_id,
+                                                                    const std::vector<RenderJob>& jobs)>;
+
+    // True while the transform pool has room for background work
+    using CapacityProbe = std::function<bool()>;
+
+    RenderJobWorker(const RenderJobConfig& config,
+                    std::shared_ptr<DatabaseClientInterface> db_client,
+                    BatchHandler handler,
+                    CapacityProbe has_capacity = nullptr);
+
+    // Stops the workers and any backfill
+    ~RenderJobWorker();
+
+    RenderJobWorker(const RenderJobWorker&) = delete;
+    RenderJobWorker& operator=(const RenderJobWorker&) = delete;
+
+    // Start config.workers worker threads
+    void start();
+
+    // Stop claiming work and join every thread; leased jobs are picked up after their lease
+    void stop();
+
+    /**
+     * @brief Queue the renditions for every stored image on a background thread
+     * @param renditions Parameter sets to queue per image (image_id is ignored)
+     * @param priority Priority of the queued jobs
+     * @return false if a backfill is already running
+     *
+     * Images are paged oldest first. Re-queuing is harmless, so a backfill
+     * cut short by a restart can simply be started again.
+     */
+    bool startBackfill(const std::vector<RenderJob>& renditions, int priority);
+
+    bool backfillRunning() const { return backfill_running_.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Claim one round of jobs and render them on the calling thread
+     * @return Jobs claimed (0 when there was nothing ready or no spare capacity)
+     */
+    size_t runOnce();
+
+    /**
+     * @brief Queue the renditions for every stored image, on the calling thread
+     * @return Jobs queued
+     */
+    size_t backfill(const std::vector<RenderJob>& renditions, int priority);
+
+private:
+    void workerLoop();
+
+    // Sleep for the poll interval; false once stopping
+    bool waitPoll();
+
+    // Record the results of one image's jobs
+    void settle(const std::string& lease_token, const std::vector<RenderJob>& jobs,
+                const std::vector<RenderJobResult>& results);
+
+    bool hasCapacity() const { return !has_capacity_ || has_capacity_(); }
+
+    RenderJobConfig config_;
+    std::shared_ptr<DatabaseClientInterface> db_client_;
+    BatchHandler handler_;
+    CapacityProbe has_capacity_;
+
+    std::atomic<bool> backfill_running_{false};
+
+    std::mutex stop_mutex_;
+    std::condition_variable stop_cv_;
+    bool stopping_ = false;
+    std::vector<std::thread> workers_;
+    std::thread backfill_thread_;
+};
+
+} // namespace gara
+
+#endif // GARA_RENDER_JOB_WORKER_H
@@ -0,0 +1,151 @@
+#include "resource_governor.h"
+#include "../exceptions/transform_exceptions.h"
+#include "../utils/logger.h"
+#include "../utils/metrics.h"
+#include "../utils/prometheus_registry.h"
+#include <algorithm>
+#include <chrono>
+
+namespace gara {
+
+namespace {
+// Bands assumed when the header does not say (RGBA)
+constexpr int DEFAULT_BANDS = 4;
+}
+
+ResourceGovernor::Permit& ResourceGovernor::Permit::operator=(Permit&& other) noexcept {
+    if (this != &other) {
+        release();
+        governor_ = other.governor_;
+        cost_ = other.cost_;
+        other.governor_ = nullptr;
+    }
+    return *this;
+}
+
+void ResourceGovernor::Permit::release() {
+    if (governor_) {
+        governor_->release(cost_);
+        governor_ = nullptr;
+    }
+}
+
+ResourceGovernor::ResourceGovernor(const GovernorConfig& config, int retry_after_seconds)
+    : config_(config), retry_after_seconds_(retry_after_seconds) {
+}
+
+uint64_t ResourceGovernor::estimateCost(uint64_t input_bytes, int source_width, int source_height, int bands,
+                                        const std::string& source_format, int target_width, int target_height) {
+    if (source_width <= 0 || source_height <= 0) {
+        return input_bytes;
+    }
+    uint64_t band_count = static_cast<uint64_t>(bands > 0 ? bands : DEFAULT_BANDS);
+
+    // Resolve 0 dimensions the way the processor does: keep the aspect ratio
+    double scale;
+    if (target_width > 0 && target_height > 0) {
+        scale = std::min(static_cast<double>(target_width) / source_width,
+                         static_cast<double>(target_height) / source_height);
+    } else if (target_width > 0) {
+        scale = static_cast<double>(target_width) / source_width;
+    } else if (target_height > 0) {
+        scale = static_cast<double>(target_height) / source_height;
+    } else {
+        scale = 1.0;
+    }
+    uint64_t output_width = static_cast<uint64_t>(std::max(1.0, source_width * scale));
+    uint64_t output_height = static_cast<uint64_t>(std::max(1.0, source_height * scale));
+
+    // Shrink-on-load decodes at 1/2, 1/4 or 1/8 scale when that still covers the target
+    uint64_t load_shrink = 1;
+    if (source_format == "jpeg" || source_format == "jpg" || source_format == "webp") {
+        while (load_shrink < 8 && scale * load_shrink * 2 <= 1.0) {
+            load_shrink *= 2;
+        }
+    }
+    uint64_t decoded_pixels = ((static_cast<uint64_t>(source_width) + load_shrink - 1) / load_shrink) *
+                              ((static_cast<uint64_t>(source_height) + load_shrink - 1) / load_shrink);
+
+    return input_bytes + (decoded_pixels + output_width * output_height) * band_count;
+}
+
+ResourceGovernor::Permit ResourceGovernor::admit(uint64_t cost) {
+    if (!enabled()) {
+        return Permit();
+    }
+    cost = std::max<uint64_t>(1, std::min(cost, config_.memory_budget_bytes));
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (queue_.empty() && in_use_ + cost <= config_.memory_budget_bytes) {
+        in_use_ += cost;
+        publish();
+        METRICS_COUNT("TransformAdmission", 1.0, "Count", {{"status", "admitted"}});
+        return Permit(this, cost);
+    }
+
+    uint64_t ticket = next_ticket_++;
+    queue_.push_back(ticket);
+    publish();
+
+    bool admitted = cv_.wait_for(lock, std::chrono::milliseconds(config_.admission_timeout_ms), [&]() {
+        return queue_.front() == ticket && in_use_ + cost <= config_.memory_budget_bytes;
+    });
+
+    if (!admitted) {
+        queue_.erase(std::find(queue_.begin(), queue_.end(), ticket));
+        publish();
+        lock.unlock();
+        cv_.notify_all();  // The next waiter may now be at the front
+
+        static auto& rejections = PrometheusRegistry::instance().counter(
+            "gara_transform_admission_rejections_total", "Transforms rejected for lack of memory budget");
+        rejections.inc();
+        METRICS_COUNT("TransformAdmission", 1.0, "Count", {{"status", "rejected"}});
+        gara::Logger::log_structured(spdlog::level::warn, "Transform memory budget exhausted, shedding request", {
+            {"cost_bytes", cost},
+            {"budget_bytes", config_.memory_budget_bytes},
+            {"timeout_ms", config_.admission_timeout_ms}
+        });
+        throw exceptions::ServiceUnavailableException("Transform memory budget exhausted",
+                                                      retry_after_seconds_);
+    }
+
+    queue_.pop_front();
+    in_use_ += cost;
+    publish();
+    lock.unlock();
+    cv_.notify_all();  // Budget may remain for the next waiter too
+
+    METRICS_COUNT("TransformAdmission", 1.0, "Count", {{"status", "queued"}});
+    return Permit(this, cost);
+}
+
+uint64_t ResourceGovernor::inUseBytes() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return in_use_;
+}
+
+size_t ResourceGovernor::waiting() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return queue_.size();
+}
+
+void ResourceGovernor::release(uint64_t cost) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        in_use_ -= std::min(cost, in_use_);
+        publish();
+    }
+    cv_.notify_all();
+}
+
+void ResourceGovernor::publish() {
+    static auto& in_use = PrometheusRegistry::instance().gauge(
+        "gara_transform_memory_in_use_bytes", "Estimated memory of admitted transforms");
+    static auto& waiting = PrometheusRegistry::instance().gauge(
+        "gara_transform_admission_waiting", "Transforms waiting for memory budget");
+    in_use.set(static_cast<double>(in_use_));
+    waiting.set(static_cast<double>(queue_.size()));
+}
+
+} // namespace gara
@@ -0,0 +1,90 @@
+#ifndef GARA_RESOURCE_GOVERNOR_H
+#define GARA_RESOURCE_GOVERNOR_H
+
+#include "../models/governor_config.h"
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+
+namespace gara {
+
+/**
+ * @brief Admits transforms against a global memory budget
+ *
+ * Each transform's peak memory is estimated from the source header before
+ * any pixels are decoded, and the transform only starts once the estimate
+ * fits in what is left of the budget. Waiters are served in arrival order,
+ * so a large image is not starved by a stream of small ones. A transform
+ * that waits longer than the admission timeout is rejected with
+ * exceptions::ServiceUnavailableException (503). An estimate above the whole
+ * budget is clamped to it, so such an image runs alone instead of never.
+ */
+class ResourceGovernor {
+public:
+    // Budget held by one admitted transform; released on destruction
+    class Permit {
+    public:
+        Permit() = default;
+        ~Permit() { release(); }
+
+        Permit(Permit&& other) noexcept : governor_(other.governor_), cost_(other.cost_) {
+            other.governor_ = nullptr;
+        }
+        Permit& operator=(Permit&& other) noexcept;
+
+        Permit(const Permit&) = delete;
+        Permit& operator=(const Permit&) = delete;
+
+        uint64_t cost() const { return cost_; }
+        void release();
+
+    private:
+        friend class ResourceGovernor;
+        Permit(ResourceGovernor* governor, uint64_t cost) : governor_(governor), cost_(cost) {}
+
+        ResourceGovernor* governor_ = nullptr;
+        uint64_t cost_ = 0;
+    };
+
+    explicit ResourceGovernor(const GovernorConfig& config = GovernorConfig(), int retry_after_seconds = 2);
+
+    /**
+     * @brief Estimate peak bytes for transforming one source
+     *
+     * Counts the encoded input, the decoded source and the resized output at
+     * one byte per band. JPEG and WebP decoders shrink on load by up to 8x, so
+     * downscales of those formats decode fewer pixels. Target dimensions of 0
+     * keep the aspect ratio, as in transform requests.
+     */
+    static uint64_t estimateCost(uint64_t input_bytes, int source_width, int source_height, int bands,
+                                 const std::string& source_format, int target_width, int target_height);
+
+    /**
+     * @brief Wait for budget and take it
+     * @throws exceptions::ServiceUnavailableException if the wait times out
+     */
+    Permit admit(uint64_t cost);
+
+    bool enabled() const { return config_.memory_budget_bytes > 0; }
+    uint64_t budgetBytes() const { return config_.memory_budget_bytes; }
+    uint64_t inUseBytes();
+    size_t waiting();
+
+private:
+    void release(uint64_t cost);
+    void publish();  // Caller holds mutex_
+
+    GovernorConfig config_;
+    int retry_after_seconds_;  // Sent with admission rejections
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    uint64_t in_use_ = 0;
+    uint64_t next_ticket_ = 0;
+    std::deque<uint64_t> queue_;  // Tickets of waiting transforms, oldest first
+};
+
+} // namespace gara
+
+#endif // GARA_RESOURCE_GOVERNOR_H
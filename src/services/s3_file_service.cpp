@@ -0,0 +1,664 @@
+#include "s3_file_service.h"
+#include "../utils/logger.h"
+#include "../utils/metrics.h"
+#include <curl/curl.h>
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <unistd.h>
+
+namespace gara {
+
+namespace {
+
+constexpr int MAX_ATTEMPTS = 3;
+constexpr int RETRY_BASE_DELAY_MS = 50;
+constexpr size_t HEAD_CACHE_ENTRY_OVERHEAD = 64;
+constexpr int MAX_PRESIGN_EXPIRATION_SECONDS = 7 * 24 * 3600;  // SigV4 limit
+
+std::once_flag curl_init_flag;
+
+struct UploadCursor {
+    const char* data;
+    size_t remaining;
+};
+
+size_t readBody(char* buffer, size_t size, size_t nitems, void* userdata) {
+    auto* cursor = static_cast<UploadCursor*>(userdata);
+    size_t chunk = std::min(size * nitems, cursor->remaining);
+    if (chunk > 0) {
+        std::memcpy(buffer, cursor->data, chunk);
+    }
+    cursor->data += chunk;
+    cursor->remaining -= chunk;
+    return chunk;
+}
+
+size_t writeBody(char* data, size_t size, size_t nmemb, void* userdata) {
+    static_cast<std::string*>(userdata)->append(data, size * nmemb);
+    return size * nmemb;
+}
+
+size_t writeHeader(char* data, size_t size, size_t nitems, void* userdata) {
+    auto* headers = static_cast<std::map<std::string, std::string>*>(userdata);
+    std::string line(data, size * nitems);
+
+    if (line.rfind("HTTP/", 0) == 0) {
+        headers->clear();  // A new response (e.g. after a redirect) starts
+        return size * nitems;
+    }
+
+    size_t colon = line.find(':');
+    if (colon != std::string::npos) {
+        std::string name = line.substr(0, colon);
+        std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+        size_t start = line.find_first_not_of(" \t", colon + 1);
+        size_t end = line.find_last_not_of(" \t\r\n");
+        (*headers)[name] = start == std::string::npos || end < start ? "" : line.substr(start, end - start + 1);
+    }
+    return size * nitems;
+}
+
+bool isRetryable(long status) {
+    return status == 0 || status == 500 || status == 502 || status == 503 || status == 504;
+}
+
+void recordOperation(const char* operation, bool ok) {
+    METRICS_COUNT("StorageOperations", 1.0, "Count", {
+        {"backend", "s3"},
+        {"operation", operation},
+        {"status", ok ? "success" : "error"}
+    });
+}
+
+} // anonymous namespace
+
+// Idle curl easy handles; each keeps its own connection and DNS cache alive
+class S3FileService::HandlePool {
+public:
+    explicit HandlePool(size_t max_idle) : max_idle_(max_idle) {}
+
+    ~HandlePool() {
+        for (CURL* handle : idle_) {
+            curl_easy_cleanup(handle);
+        }
+    }
+
+    CURL* acquire() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!idle_.empty()) {
+                CURL* handle = idle_.back();
+                idle_.pop_back();
+                return handle;
+            }
+        }
+        return curl_easy_init();
+    }
+
+    void release(CURL* handle) {
+        // Reset clears options but keeps live connections
+        curl_easy_reset(handle);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (idle_.size() < max_idle_) {
+                idle_.push_back(handle);
+                return;
+            }
+        }
+        curl_easy_cleanup(handle);
+    }
+
+private:
+    std::mutex mutex_;
+    std::vector<CURL*> idle_;
+    size_t max_idle_;
+};
+
+S3FileService::S3FileService(const S3Config& config)
+    : config_(config),
+      handles_(std::make_unique<HandlePool>(static_cast<size_t>(std::max(1, config.max_idle_connections)))),
+      head_cache_(config.head_cache_max_bytes, std::chrono::seconds(config.head_cache_ttl_seconds)),
+      presign_cache_(config.presign_bucket_seconds, MAX_PRESIGN_EXPIRATION_SECONDS, config.presign_cache_max_bytes) {
+    if (!config_.isConfigured()) {
+        throw std::invalid_argument("S3 storage needs S3_BUCKET_NAME, AWS_ACCESS_KEY_ID and AWS_SECRET_ACCESS_KEY");
+    }
+    std::call_once(curl_init_flag, []() { curl_global_init(CURL_GLOBAL_DEFAULT); });
+
+    credentials_.access_key_id = config_.access_key_id;
+    credentials_.secret_access_key = config_.secret_access_key;
+    credentials_.session_token = config_.session_token;
+
+    std::string endpoint_host = "s3." + config_.region + ".amazonaws.com";
+    scheme_ = "https";
+    if (!config_.endpoint.empty()) {
+        std::string endpoint = config_.endpoint;
+        size_t scheme_end = endpoint.find("://");
+        if (scheme_end != std::string::npos) {
+            scheme_ = endpoint.substr(0, scheme_end);
+            endpoint = endpoint.substr(scheme_end + 3);
+        }
+        endpoint_host = endpoint.substr(0, endpoint.find('/'));
+    }
+
+    if (config_.force_path_style) {
+        host_ = endpoint_host;
+        path_prefix_ = "/" + utils::SigV4::uriEncode(config_.bucket);
+    } else {
+        host_ = config_.bucket + "." + endpoint_host;
+    }
+
+    gara::Logger::log_structured(spdlog::level::info, "S3 storage initialized", {
+        {"bucket", config_.bucket},
+        {"region", config_.region},
+        {"host", host_},
+        {"path_style", config_.force_path_style}
+    });
+}
+
+S3FileService::~S3FileService() = default;
+
+std::string S3FileService::objectPath(const std::string& key) const {
+    return path_prefix_ + "/" + utils::SigV4::uriEncode(key, false);
+}
+
+S3FileService::Response S3FileService::perform(const Request& request) {
+    Response response;
+    for (int attempt = 0; attempt < MAX_ATTEMPTS; ++attempt) {
+        if (attempt > 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(RETRY_BASE_DELAY_MS << (attempt - 1)));
+        }
+        response = performOnce(request);
+        if (!isRetryable(response.status)) {
+            break;
+        }
+    }
+    return response;
+}
+
+S3FileService::Response S3FileService::performOnce(const Request& request) {
+    Response response;
+
+    std::string path = objectPath(request.key);
+    std::string amz_date = utils::SigV4::amzDate(std::time(nullptr));
+    std::string payload_hash = request.body ? utils::SigV4::UNSIGNED_PAYLOAD : utils::SigV4::EMPTY_PAYLOAD_HASH;
+
+    utils::SigV4::Params headers = request.headers;
+    headers["host"] = host_;
+    headers["x-amz-date"] = amz_date;
+    headers["x-amz-content-sha256"] = payload_hash;
+    if (!credentials_.session_token.empty()) {
+        headers["x-amz-security-token"] = credentials_.session_token;
+    }
+    std::string authorization = utils::SigV4::authorization(request.method, path, request.query, headers,
+                                                            payload_hash, credentials_, config_.region, amz_date);
+
+    std::string url = scheme_ + "://" + host_ + path;
+    std::string query = utils::SigV4::canonicalQuery(request.query);
+    if (!query.empty()) {
+        url += "?" + query;
+    }
+
+    curl_slist* header_list = nullptr;
+    for (const auto& [name, value] : headers) {
+        if (name != "host") {
+            header_list = curl_slist_append(header_list, (name + ": " + value).c_str());
+        }
+    }
+    header_list = curl_slist_append(header_list, ("Authorization: " + authorization).c_str());
+    header_list = curl_slist_append(header_list, "Expect:");  // Skip the 100-continue round trip
+
+    CURL* handle = handles_->acquire();
+    if (!handle) {
+        curl_slist_free_all(header_list);
+        return response;
+    }
+
+    UploadCursor cursor{request.body, request.body_size};
+    curl_easy_setopt(handle, CURLOPT_URL, url.c_str());
+    curl_easy_setopt(handle, CURLOPT_HTTPHEADER, header_list);
+    curl_easy_setopt(handle, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(handle, CURLOPT_TCP_KEEPALIVE, 1L);
+    curl_easy_setopt(handle, CURLOPT_TIMEOUT, static_cast<long>(config_.request_timeout_seconds));
+    curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, writeBody);
+    curl_easy_setopt(handle, CURLOPT_WRITEDATA, &response.body);
+    curl_easy_setopt(handle, CURLOPT_HEADERFUNCTION, writeHeader);
+    curl_easy_setopt(handle, CURLOPT_HEADERDATA, &response.headers);
+
+    if (request.method == "HEAD") {
+        curl_easy_setopt(handle, CURLOPT_NOBODY, 1L);
+    } else if (request.method == "PUT") {
+        curl_easy_setopt(handle, CURLOPT_UPLOAD, 1L);
+        curl_easy_setopt(handle, CURLOPT_READFUNCTION, readBody);
+        curl_easy_setopt(handle, CURLOPT_READDATA, &cursor);
+        curl_easy_setopt(handle, CURLOPT_INFILESIZE_LARGE, static_cast<curl_off_t>(request.body_size));
+    } else if (request.method == "POST") {
+        curl_easy_setopt(handle, CURLOPT_POST, 1L);
+        curl_easy_setopt(handle, CURLOPT_POSTFIELDS, request.body ? request.body : "");
+        curl_easy_setopt(handle, CURLOPT_POSTFIELDSIZE_LARGE, static_cast<curl_off_t>(request.body_size));
+    } else if (request.method != "GET") {
+        curl_easy_setopt(handle, CURLOPT_CUSTOMREQUEST, request.method.c_str());
+    }
+
+    CURLcode result = curl_easy_perform(handle);
+    if (result == CURLE_OK) {
+        curl_easy_getinfo(handle, CURLINFO_RESPONSE_CODE, &response.status);
+    } else {
+        gara::Logger::log_structured(spdlog::level::warn, "S3 request failed", {
+            {"method", request.method},
+            {"key", request.key},
+            {"error", curl_easy_strerror(result)}
+        });
+    }
+
+    handles_->release(handle);
+    curl_slist_free_all(header_list);
+    return response;
+}
+
+void S3FileService::rememberExists(const std::string& key, bool exists) {
+    head_cache_.put(key, exists, key.size() + HEAD_CACHE_ENTRY_OVERHEAD);
+}
+
+bool S3FileService::putObject(const std::string& key, const char* data, size_t size,
+                              const std::string& content_type) {
+    Request request;
+    request.method = "PUT";
+    request.key = key;
+    request.headers["content-type"] = content_type;
+    request.body = data;
+    request.body_size = size;
+
+    Response response = perform(request);
+    recordOperation("put", response.ok());
+    if (!response.ok()) {
+        gara::Logger::log_structured(spdlog::level::err, "S3 upload failed", {
+            {"key", key},
+            {"status", response.status}
+        });
+        return false;
+    }
+    rememberExists(key, true);
+    return true;
+}
+
+bool S3FileService::forEachPart(size_t count, const std::function<bool(size_t part)>& fn) {
+    std::atomic<size_t> next_part{0};
+    std::atomic<bool> failed{false};
+    auto worker = [&]() {
+        for (size_t part = next_part++; part < count && !failed; part = next_part++) {
+            if (!fn(part)) {
+                failed = true;
+            }
+        }
+    };
+
+    size_t thread_count = std::min(count, static_cast<size_t>(std::max(1, config_.transfer_concurrency)));
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < thread_count; ++i) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    return !failed;
+}
+
+bool S3FileService::multipartUpload(const std::string& key, uint64_t size, const std::string& content_type,
+                                    const PartReader& read_part) {
+    Request create;
+    create.method = "POST";
+    create.key = key;
+    create.query["uploads"] = "";
+    create.headers["content-type"] = content_type;
+
+    Response created = perform(create);
+    std::string upload_id = xmlElement(created.body, "UploadId");
+    if (!created.ok() || upload_id.empty()) {
+        gara::Logger::log_structured(spdlog::level::err, "S3 multipart upload could not start", {
+            {"key", key},
+            {"status", created.status}
+        });
+        recordOperation("multipart_put", false);
+        return false;
+    }
+
+    const size_t part_size = config_.part_size_bytes;
+    size_t part_count = static_cast<size_t>((size + part_size - 1) / part_size);
+    std::vector<std::string> etags(part_count);
+
+    bool uploaded = forEachPart(part_count, [&](size_t part) {
+        uint64_t offset = static_cast<uint64_t>(part) * part_size;
+        size_t length = static_cast<size_t>(std::min<uint64_t>(part_size, size - offset));
+        std::vector<char> buffer;
+        if (!read_part(offset, length, buffer) || buffer.size() != length) {
+            return false;
+        }
+
+        Request upload;
+        upload.method = "PUT";
+        upload.key = key;
+        upload.query = {{"partNumber", std::to_string(part + 1)}, {"uploadId", upload_id}};
+        upload.body = buffer.data();
+        upload.body_size = length;
+
+        Response response = perform(upload);
+        auto etag = response.headers.find("etag");
+        if (!response.ok() || etag == response.headers.end()) {
+            return false;
+        }
+        etags[part] = etag->second;
+        return true;
+    });
+
+    if (uploaded) {
+        std::string manifest = "<CompleteMultipartUpload>";
+        for (size_t part = 0; part < part_count; ++part) {
+            manifest += "<Part><PartNumber>" + std::to_string(part + 1) + "</PartNumber><ETag>" +
+                        etags[part] + "</ETag></Part>";
+        }
+        manifest += "</CompleteMultipartUpload>";
+
+        Request complete;
+        complete.method = "POST";
+        complete.key = key;
+        complete.query["uploadId"] = upload_id;
+        complete.headers["content-type"] = "application/xml";
+        complete.body = manifest.data();
+        complete.body_size = manifest.size();
+
+        Response response = perform(complete);
+        // S3 can report a failed completion inside a 200 response
+        uploaded = response.ok() && response.body.find("<Error>") == std::string::npos;
+    }
+
+    recordOperation("multipart_put", uploaded);
+    if (!uploaded) {
+        Request abort;
+        abort.method = "DELETE";
+        abort.key = key;
+        abort.query["uploadId"] = upload_id;
+        perform(abort);
+
+        gara::Logger::log_structured(spdlog::level::err, "S3 multipart upload failed", {
+            {"key", key},
+            {"parts", part_count}
+        });
+        return false;
+    }
+
+    rememberExists(key, true);
+    return true;
+}
+
+bool S3FileService::uploadFile(const std::string& local_path, const std::string& key,
+                               const std::string& content_type) {
+    std::error_code ec;
+    uint64_t size = std::filesystem::file_size(local_path, ec);
+    if (ec) {
+        gara::Logger::log_structured(spdlog::level::err, "Failed to stat file for upload", {
+            {"path", local_path},
+            {"error", ec.message()}
+        });
+        return false;
+    }
+
+    if (size >= config_.multipart_threshold_bytes) {
+        return multipartUpload(key, size, content_type,
+            [&local_path](uint64_t offset, size_t length, std::vector<char>& buffer) {
+                std::ifstream file(local_path, std::ios::binary);
+                buffer.resize(length);
+                file.seekg(static_cast<std::streamoff>(offset));
+                file.read(buffer.data(), static_cast<std::streamsize>(length));
+                return static_cast<size_t>(file.gcount()) == length;
+            });
+    }
+
+    std::vector<char> data(static_cast<size_t>(size));
+    std::ifstream file(local_path, std::ios::binary);
+    if (!file.read(data.data(), static_cast<std::streamsize>(data.size())) && size > 0) {
+        return false;
+    }
+    return putObject(key, data.data(), data.size(), content_type);
+}
+
+bool S3FileService::uploadData(const std::vector<char>& data, const std::string& key,
+                               const std::string& content_type) {
+    if (data.size() >= config_.multipart_threshold_bytes) {
+        return multipartUpload(key, data.size(), content_type,
+            [&data](uint64_t offset, size_t length, std::vector<char>& buffer) {
+                buffer.assign(data.begin() + static_cast<std::ptrdiff_t>(offset),
+                              data.begin() + static_cast<std::ptrdiff_t>(offset + length));
+                return true;
+            });
+    }
+    return putObject(key, data.data(), data.size(), content_type);
+}
+
+bool S3FileService::moveFileToStorage(const std::string& local_path, const std::string& key,
+                                      const std::string& content_type) {
+    if (!uploadFile(local_path, key, content_type)) {
+        return false;
+    }
+    std::error_code ec;
+    std::filesystem::remove(local_path, ec);
+    return true;
+}
+
+bool S3FileService::download(const std::string& key, const std::function<bool(uint64_t size)>& on_size,
+                             const RangeWriter& write) {
+    // The first part doubles as the size probe, so small objects take one request
+    Request first;
+    first.key = key;
+    first.headers["range"] = "bytes=0-" + std::to_string(config_.part_size_bytes - 1);
+
+    Response response = perform(first);
+    uint64_t total = 0;
+    if (response.status == 206) {
+        auto parsed = totalFromContentRange(response.headers["content-range"]);
+        if (!parsed) {
+            return false;
+        }
+        total = *parsed;
+    } else if (response.status == 200) {
+        total = response.body.size();
+    } else if (response.status != 416) {  // 416: empty object
+        if (response.status == 404) {
+            rememberExists(key, false);
+        }
+        recordOperation("get", false);
+        return false;
+    }
+    rememberExists(key, true);
+
+    if (!on_size(total) || (!response.body.empty() && !write(0, response.body.data(), response.body.size()))) {
+        return false;
+    }
+
+    uint64_t fetched = response.body.size();
+    if (fetched >= total) {
+        recordOperation("get", true);
+        return true;
+    }
+
+    // Pin the remaining ranges to the version the first part came from
+    std::string etag = response.headers["etag"];
+    const size_t part_size = config_.part_size_bytes;
+    size_t remaining_parts = static_cast<size_t>((total - fetched + part_size - 1) / part_size);
+    bool ok = forEachPart(remaining_parts, [&](size_t part) {
+        uint64_t start = fetched + static_cast<uint64_t>(part) * part_size;
+        uint64_t last = std::min<uint64_t>(start + part_size, total) - 1;
+        return fetchRange(key, etag, start, last, write);
+    });
+    recordOperation("ranged_get", ok);
+    return ok;
+}
+
+bool S3FileService::fetchRange(const std::string& key, const std::string& etag, uint64_t first, uint64_t last,
+                               const RangeWriter& write) {
+    Request request;
+    request.key = key;
+    request.headers["range"] = "bytes=" + std::to_string(first) + "-" + std::to_string(last);
+    if (!etag.empty()) {
+        request.headers["if-match"] = etag;
+    }
+
+    Response response = perform(request);
+    if (response.status != 206 || response.body.size() != last - first + 1) {
+        gara::Logger::log_structured(spdlog::level::err, "S3 ranged read failed", {
+            {"key", key},
+            {"status", response.status},
+            {"range_start", first}
+        });
+        return false;
+    }
+    return write(first, response.body.data(), response.body.size());
+}
+
+bool S3FileService::downloadFile(const std::string& key, const std::string& local_path) {
+    int fd = ::open(local_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        gara::Logger::log_structured(spdlog::level::err, "Failed to open file for download", {
+            {"path", local_path}
+        });
+        return false;
+    }
+
+    // pwrite lets parts land at their offsets from several threads
+    bool ok = download(key,
+        [fd](uint64_t size) {
+            return ::ftruncate(fd, static_cast<off_t>(size)) == 0;
+        },
+        [fd](uint64_t offset, const char* data, size_t size) {
+            while (size > 0) {
+                ssize_t written = ::pwrite(fd, data, size, static_cast<off_t>(offset));
+                if (written <= 0) {
+                    return false;
+                }
+                data += written;
+                size -= static_cast<size_t>(written);
+                offset += static_cast<uint64_t>(written);
+            }
+            return true;
+        });
+
+    ok = ::close(fd) == 0 && ok;
+    if (!ok) {
+        std::error_code ec;
+        std::filesystem::remove(local_path, ec);
+    }
+    return ok;
+}
+
+std::vector<char> S3FileService::downloadData(const std::string& key) {
+    std::vector<char> data;
+    bool ok = download(key,
+        [&data](uint64_t size) {
+            data.resize(static_cast<size_t>(size));
+            return true;
+        },
+        [&data](uint64_t offset, const char* bytes, size_t size) {
+            if (offset + size > data.size()) {
+                return false;
+            }
+            std::memcpy(data.data() + offset, bytes, size);
+            return true;
+        });
+    return ok ? data : std::vector<char>();
+}
+
+bool S3FileService::objectExists(const std::string& key) {
+    auto cached = head_cache_.get(key);
+    if (cached) {
+        return *cached;
+    }
+
+    Request request;
+    request.method = "HEAD";
+    request.key = key;
+
+    Response response = perform(request);
+    if (response.ok() || response.status == 404) {
+        rememberExists(key, response.ok());
+        return response.ok();
+    }
+
+    // Errors are not cached: the next call asks S3 again
+    recordOperation("head", false);
+    gara::Logger::log_structured(spdlog::level::warn, "S3 existence check failed", {
+        {"key", key},
+        {"status", response.status}
+    });
+    return false;
+}
+
+std::future<bool> S3FileService::objectExistsAsync(const std::string& key) {
+    auto cached = head_cache_.get(key);
+    if (cached) {
+        std::promise<bool> known;
+        known.set_value(*cached);
+        return known.get_future();
+    }
+    return FileServiceInterface::objectExistsAsync(key);
+}
+
+bool S3FileService::deleteObject(const std::string& key) {
+    Request request;
+    request.method = "DELETE";
+    request.key = key;
+
+    Response response = perform(request);
+    recordOperation("delete", response.ok());
+    if (!response.ok()) {
+        return false;
+    }
+    rememberExists(key, false);
+    return true;
+}
+
+std::string S3FileService::generatePresignedUrl(const std::string& key, int expiration_seconds) {
+    return presign_cache_.get(key, expiration_seconds, std::time(nullptr),
+        [this, &key](std::time_t signed_at, int expires_in) {
+            std::string path = objectPath(key);
+            std::string query = utils::SigV4::presignQuery(
+                "GET", host_, path, credentials_, config_.region, utils::SigV4::amzDate(signed_at), expires_in);
+            return scheme_ + "://" + host_ + path + "?" + query;
+        });
+}
+
+std::optional<uint64_t> S3FileService::totalFromContentRange(const std::string& content_range) {
+    // "bytes 0-8388607/52428800"
+    size_t slash = content_range.rfind('/');
+    if (slash == std::string::npos || slash + 1 >= content_range.size() || content_range[slash + 1] == '*') {
+        return std::nullopt;
+    }
+    try {
+        return std::stoull(content_range.substr(slash + 1));
+    } catch (const std::exception&) {
+        return std::nullopt;
+    }
+}
+
+std::string S3FileService::xmlElement(const std::string& xml, const std::string& name) {
+    std::string open = "<" + name + ">";
+    size_t start = xml.find(open);
+    if (start == std::string::npos) {
+        return "";
+    }
+    start += open.size();
+    size_t end = xml.find("</" + name + ">", start);
+    return end == std::string::npos ? "" : xml.substr(start, end - start);
+}
+
+} // namespace gara
@@ -0,0 +1,127 @@
+#ifndef GARA_S3_FILE_SERVICE_H
+#define GARA_S3_FILE_SERVICE_H
+
+#include "../interfaces/file_service_interface.h"
+#include "../models/s3_config.h"
+#include "../utils/lru_cache.h"
+#include "../utils/presign_cache.h"
+#include "../utils/sigv4.h"
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <optional>
+
+namespace gara {
+
+/**
+ * @brief Amazon S3 (or S3-compatible) implementation of file storage service
+ *
+ * Talks to the S3 REST API directly through libcurl:
+ * - Requests reuse pooled easy handles, so connections stay alive between calls
+ * - Uploads above the multipart threshold are sent as parallel parts
+ * - Downloads fetch the first part, then the rest as parallel ranged GETs
+ * - objectExists answers from a short-lived HEAD cache kept in sync with
+ *   this process's own uploads and deletes
+ * - Presigned URLs are signed locally with SigV4 (no network round trip)
+ *   and reused within aligned time buckets, so repeat hits get the same URL
+ */
+class S3FileService : public FileServiceInterface {
+public:
+    explicit S3FileService(const S3Config& config);
+    ~S3FileService() override;
+
+    bool uploadFile(const std::string& local_path, const std::string& key,
+                   const std::string& content_type = "application/octet-stream") override;
+
+    bool uploadData(const std::vector<char>& data, const std::string& key,
+                   const std::string& content_type = "application/octet-stream") override;
+
+    bool moveFileToStorage(const std::string& local_path, const std::string& key,
+                           const std::string& content_type = "application/octet-stream") override;
+
+    bool downloadFile(const std::string& key, const std::string& local_path) override;
+
+    std::vector<char> downloadData(const std::string& key) override;
+
+    bool objectExists(const std::string& key) override;
+
+    // Answers HEAD cache hits without a trip through the I/O pool
+    std::future<bool> objectExistsAsync(const std::string& key) override;
+
+    bool deleteObject(const std::string& key) override;
+
+    std::string generatePresignedUrl(const std::string& key, int expiration_seconds = 3600) override;
+
+    const std::string& getBucketName() const override { return config_.bucket; }
+
+    /**
+     * @brief Canonical (encoded) request path for a key, including the bucket for path-style endpoints
+     */
+    std::string objectPath(const std::string& key) const;
+
+    /**
+     * @brief Host name requests are sent to (and signed for)
+     */
+    const std::string& host() const { return host_; }
+
+private:
+    class HandlePool;
+
+    // Supplies part bytes for a multipart upload
+    using PartReader = std::function<bool(uint64_t offset, size_t size, std::vector<char>& buffer)>;
+    // Writes downloaded bytes at an offset; called concurrently for distinct ranges
+    using RangeWriter = std::function<bool(uint64_t offset, const char* data, size_t size)>;
+
+    struct Response {
+        long status = 0;            // 0 when the transfer itself failed
+        std::string body;           // Bounded by the part size for ranged GETs
+        std::map<std::string, std::string> headers;  // Lowercase names
+
+        bool ok() const { return status >= 200 && status < 300; }
+    };
+
+    struct Request {
+        std::string method = "GET";
+        std::string key;
+        utils::SigV4::Params query;
+        utils::SigV4::Params headers;  // Extra headers to sign; lowercase names
+        const char* body = nullptr;
+        size_t body_size = 0;
+    };
+
+    // Signs and sends a request, retrying transport errors and 5xx responses
+    Response perform(const Request& request);
+    Response performOnce(const Request& request);
+
+    bool putObject(const std::string& key, const char* data, size_t size, const std::string& content_type);
+    bool multipartUpload(const std::string& key, uint64_t size, const std::string& content_type,
+                         const PartReader& read_part);
+
+    // Calls on_size once the object size is known, before any write
+    bool download(const std::string& key, const std::function<bool(uint64_t size)>& on_size,
+                  const RangeWriter& write);
+    bool fetchRange(const std::string& key, const std::string& etag, uint64_t first, uint64_t last,
+                    const RangeWriter& write);
+    // Runs fn(part) for parts [0, count) on up to transfer_concurrency threads; false if any failed
+    bool forEachPart(size_t count, const std::function<bool(size_t part)>& fn);
+
+    void rememberExists(const std::string& key, bool exists);
+
+    static std::optional<uint64_t> totalFromContentRange(const std::string& content_range);
+    static std::string xmlElement(const std::string& xml, const std::string& name);
+
+    S3Config config_;
+    utils::AwsCredentials credentials_;
+    std::string scheme_;
+    std::string host_;
+    std::string path_prefix_;  // "/bucket" for path-style endpoints
+
+    std::unique_ptr<HandlePool> handles_;
+    utils::ShardedLruCache<bool> head_cache_;
+    utils::PresignCache presign_cache_;
+};
+
+} // namespace gara
+
+#endif // GARA_S3_FILE_SERVICE_H
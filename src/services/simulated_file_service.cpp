@@ -0,0 +1,167 @@
+#include "simulated_file_service.h"
+#include "../utils/metrics.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <system_error>
+#include <thread>
+#include <utility>
+
+namespace gara {
+
+namespace {
+
+// z-score of the 99th percentile of a standard normal
+constexpr double Z_P99 = 2.3263478740;
+
+// Samples past this many p99s are clipped, so one draw cannot stall a run
+constexpr double MAX_P99_MULTIPLE = 4.0;
+
+const char* operationName(SimulatedFileService::Operation operation) {
+    switch (operation) {
+        case SimulatedFileService::Operation::GET: return "get";
+        case SimulatedFileService::Operation::PUT: return "put";
+        case SimulatedFileService::Operation::HEAD: return "head";
+        case SimulatedFileService::Operation::DELETE: return "delete";
+    }
+    return "unknown";
+}
+
+void sleepMs(double ms) {
+    if (ms > 0.0) {
+        std::this_thread::sleep_for(std::chrono::duration<double, std::milli>(ms));
+    }
+}
+
+uint64_t fileSize(const std::string& path) {
+    std::error_code ec;
+    auto size = std::filesystem::file_size(path, ec);
+    return ec ? 0 : static_cast<uint64_t>(size);
+}
+
+} // anonymous namespace
+
+SimulatedFileService::SimulatedFileService(std::shared_ptr<FileServiceInterface> backend,
+                                           const StorageSimulationConfig& config)
+    : backend_(std::move(backend)),
+      config_(config),
+      random_(config.seed) {}
+
+const StorageOperationProfile& SimulatedFileService::profileFor(Operation operation) const {
+    switch (operation) {
+        case Operation::GET: return config_.get;
+        case Operation::PUT: return config_.put;
+        case Operation::HEAD: return config_.head;
+        case Operation::DELETE: return config_.del;
+    }
+    return config_.get;
+}
+
+double SimulatedFileService::sampleLatencyMs(Operation operation) {
+    const StorageOperationProfile& profile = profileFor(operation);
+    if (profile.median_ms <= 0.0 || profile.p99_ms <= profile.median_ms) {
+        return profile.median_ms;
+    }
+
+    double sigma = std::log(profile.p99_ms / profile.median_ms) / Z_P99;
+    std::lognormal_distribution<double> distribution(std::log(profile.median_ms), sigma);
+    double sample;
+    {
+        std::lock_guard<std::mutex> lock(random_mutex_);
+        sample = distribution(random_);
+    }
+    return std::min(sample, profile.p99_ms * MAX_P99_MULTIPLE);
+}
+
+double SimulatedFileService::transferMs(uint64_t bytes) const {
+    if (config_.bandwidth_bytes_per_sec == 0) {
+        return 0.0;
+    }
+    return static_cast<double>(bytes) * 1000.0 / static_cast<double>(config_.bandwidth_bytes_per_sec);
+}
+
+bool SimulatedFileService::simulate(Operation operation) {
+    sleepMs(sampleLatencyMs(operation));
+
+    double error_rate = profileFor(operation).error_rate;
+    if (error_rate <= 0.0) {
+        return true;
+    }
+    bool failed;
+    {
+        std::lock_guard<std::mutex> lock(random_mutex_);
+        failed = std::uniform_real_distribution<double>(0.0, 1.0)(random_) < error_rate;
+    }
+    if (failed) {
+        METRICS_COUNT("StorageSimulatedErrors", 1.0, "Count", {{"operation", operationName(operation)}});
+    }
+    return !failed;
+}
+
+void SimulatedFileService::throttle(uint64_t bytes) const {
+    sleepMs(transferMs(bytes));
+}
+
+bool SimulatedFileService::uploadFile(const std::string& local_path, const std::string& key,
+                                      const std::string& content_type) {
+    if (!simulate(Operation::PUT)) {
+        return false;
+    }
+    throttle(fileSize(local_path));
+    return backend_->uploadFile(local_path, key, content_type);
+}
+
+bool SimulatedFileService::uploadData(const std::vector<char>& data, const std::string& key,
+                                      const std::string& content_type) {
+    if (!simulate(Operation::PUT)) {
+        return false;
+    }
+    throttle(data.size());
+    return backend_->uploadData(data, key, content_type);
+}
+
+bool SimulatedFileService::moveFileToStorage(const std::string& local_path, const std::string& key,
+                                             const std::string& content_type) {
+    if (!simulate(Operation::PUT)) {
+        return false;
+    }
+    throttle(fileSize(local_path));
+    return backend_->moveFileToStorage(local_path, key, content_type);
+}
+
+bool SimulatedFileService::downloadFile(const std::string& key, const std::string& local_path) {
+    if (!simulate(Operation::GET)) {
+        return false;
+    }
+    bool downloaded = backend_->downloadFile(key, local_path);
+    if (downloaded) {
+        throttle(fileSize(local_path));
+    }
+    return downloaded;
+}
+
+std::vector<char> SimulatedFileService::downloadData(const std::string& key) {
+    if (!simulate(Operation::GET)) {
+        return {};
+    }
+    std::vector<char> data = backend_->downloadData(key);
+    throttle(data.size());
+    return data;
+}
+
+bool SimulatedFileService::objectExists(const std::string& key) {
+    if (!simulate(Operation::HEAD)) {
+        return false;
+    }
+    return backend_->objectExists(key);
+}
+
+bool SimulatedFileService::deleteObject(const std::string& key) {
+    if (!simulate(Operation::DELETE)) {
+        return false;
+    }
+    return backend_->deleteObject(key);
+}
+
+} // namespace gara
@@ -0,0 +1,80 @@
+#ifndef GARA_SIMULATED_FILE_SERVICE_H
+#define GARA_SIMULATED_FILE_SERVICE_H
+
+#include "../interfaces/file_service_interface.h"
+#include "../models/storage_simulation_config.h"
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+
+namespace gara {
+
+/**
+ * @brief Remote-storage behavior in front of another file service, for capacity testing
+ *
+ * Every operation sleeps for a latency drawn from its profile's log-normal
+ * distribution, transfers additionally take size / bandwidth, and a profile's
+ * error rate fails that fraction of calls the way a backend would (false or
+ * an empty result) after they have paid their latency. Presigned URLs are
+ * signed locally by real backends and pass straight through.
+ *
+ * Objects are never memory-mapped, so reads always pay the simulated cost,
+ * as they do against S3. Wrapping LocalFileService this way lets the caches,
+ * write-behind and async paths be measured against S3-like storage offline.
+ */
+class SimulatedFileService : public FileServiceInterface {
+public:
+    enum class Operation { GET, PUT, HEAD, DELETE };
+
+    SimulatedFileService(std::shared_ptr<FileServiceInterface> backend, const StorageSimulationConfig& config);
+
+    bool uploadFile(const std::string& local_path, const std::string& key,
+                   const std::string& content_type = "application/octet-stream") override;
+
+    bool uploadData(const std::vector<char>& data, const std::string& key,
+                   const std::string& content_type = "application/octet-stream") override;
+
+    bool moveFileToStorage(const std::string& local_path, const std::string& key,
+                           const std::string& content_type = "application/octet-stream") override;
+
+    bool downloadFile(const std::string& key, const std::string& local_path) override;
+
+    std::vector<char> downloadData(const std::string& key) override;
+
+    bool objectExists(const std::string& key) override;
+
+    bool deleteObject(const std::string& key) override;
+
+    std::string generatePresignedUrl(const std::string& key, int expiration_seconds = 3600) override {
+        return backend_->generatePresignedUrl(key, expiration_seconds);
+    }
+
+    const std::string& getBucketName() const override { return backend_->getBucketName(); }
+
+    // Draw a latency for operation, in milliseconds
+    double sampleLatencyMs(Operation operation);
+
+    // Milliseconds a transfer of bytes takes under the bandwidth cap
+    double transferMs(uint64_t bytes) const;
+
+private:
+    const StorageOperationProfile& profileFor(Operation operation) const;
+
+    // Sleep for the operation's latency; false when the call should fail
+    bool simulate(Operation operation);
+
+    // Sleep for the transfer time of bytes
+    void throttle(uint64_t bytes) const;
+
+    std::shared_ptr<FileServiceInterface> backend_;
+    StorageSimulationConfig config_;
+
+    std::mutex random_mutex_;
+    std::mt19937_64 random_;
+};
+
+} // namespace gara
+
+#endif // GARA_SIMULATED_FILE_SERVICE_H
@@ -0,0 +1,145 @@
+#include "transform_executor.h"
+#include "../utils/allocator_stats.h"
+#include "../utils/logger.h"
+#include "../utils/metrics.h"
+
+namespace gara {
+
+namespace {
+const char* laneName(TransformPriority priority) {
+    switch (priority) {
+        case TransformPriority::HIGH: return "high";
+        case TransformPriority::NORMAL: return "normal";
+        case TransformPriority::LOW: return "low";
+    }
+    return "normal";
+}
+}
+
+TransformExecutor::TransformExecutor(size_t worker_count, size_t max_queue_size)
+    : max_queue_size_(max_queue_size) {
+    if (worker_count == 0) {
+        worker_count = 1;
+    }
+    workers_.reserve(worker_count);
+    for (size_t i = 0; i < worker_count; ++i) {
+        workers_.emplace_back(&TransformExecutor::workerLoop, this);
+    }
+}
+
+TransformExecutor::~TransformExecutor() {
+    shutdown();
+}
+
+bool TransformExecutor::trySubmit(TransformPriority priority, std::function<void()> task) {
+    size_t depth = 0;
+    {
+        std::lock_guard<utils::InstrumentedMutex> lock(mutex_);
+        if (stopping_ || queued_ >= max_queue_size_) {
+            METRICS_COUNT("TransformExecutorTasks", 1.0, "Count",
+                         {{"lane", laneName(priority)}, {"status", "rejected"}});
+            return false;
+        }
+        lanes_[static_cast<int>(priority)].push_back({std::move(task), std::chrono::steady_clock::now()});
+        depth = ++queued_;
+    }
+    cv_.notify_one();
+
+    METRICS_COUNT("TransformExecutorTasks", 1.0, "Count",
+                 {{"lane", laneName(priority)}, {"status", "queued"}});
+    METRICS_GAUGE("TransformQueueDepth", static_cast<double>(depth), "Count");
+    return true;
+}
+
+void TransformExecutor::shutdown() {
+    {
+        std::lock_guard<utils::InstrumentedMutex> lock(mutex_);
+        if (stopping_) {
+            return;
+        }
+        stopping_ = true;
+    }
+    cv_.notify_all();
+
+    for (auto& worker : workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+size_t TransformExecutor::queueDepth() const {
+    std::lock_guard<utils::InstrumentedMutex> lock(mutex_);
+    return queued_;
+}
+
+bool TransformExecutor::hasSpareCapacity() const {
+    std::lock_guard<utils::InstrumentedMutex> lock(mutex_);
+    return queued_ == 0 && running_ < workers_.size();
+}
+
+TransformPriority TransformExecutor::classify(int width, int height,
+                                              long long small_max_pixels, long long large_min_pixels) {
+    // Original-size output: cost is bounded only by the source
+    if (width <= 0 && height <= 0) {
+        return TransformPriority::LOW;
+    }
+
+    // With one side unknown, assume a square bounding box on the known side
+    long long w = width > 0 ? width : height;
+    long long h = height > 0 ? height : width;
+    long long pixels = w * h;
+
+    if (pixels <= small_max_pixels) {
+        return TransformPriority::HIGH;
+    }
+    if (pixels >= large_min_pixels) {
+        return TransformPriority::LOW;
+    }
+    return TransformPriority::NORMAL;
+}
+
+void TransformExecutor::workerLoop() {
+    while (true) {
+        QueuedTask task;
+        {
+            std::unique_lock<utils::InstrumentedMutex> lock(mutex_);
+            cv_.wait(lock, [this]() { return stopping_ || queued_ > 0; });
+            if (queued_ == 0) {
+                return;  // Stopping and drained
+            }
+            for (auto& lane : lanes_) {
+                if (!lane.empty()) {
+                    task = std::move(lane.front());
+                    lane.pop_front();
+                    break;
+                }
+            }
+            --queued_;
+            ++running_;
+        }
+
+        auto waited = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - task.enqueued_at);
+        METRICS_DURATION("TransformQueueWait", waited.count() / 1000.0);
+
+        uint64_t allocated_before = utils::AllocatorStats::threadAllocatedBytes();
+        try {
+            task.run();
+        } catch (const std::exception& e) {
+            gara::Logger::log_structured(spdlog::level::err, "Transform task failed", {
+                {"error", e.what()}
+            });
+        }
+        if (utils::AllocatorStats::threadCountersEnabled()) {
+            METRICS_COUNT("TransformAllocatedBytes",
+                          static_cast<double>(utils::AllocatorStats::threadAllocatedBytes() - allocated_before),
+                          "Bytes");
+        }
+
+        std::lock_guard<utils::InstrumentedMutex> lock(mutex_);
+        --running_;
+    }
+}
+
+} // namespace gara
@@ -0,0 +1,75 @@
+#ifndef GARA_TRANSFORM_EXECUTOR_H
+#define GARA_TRANSFORM_EXECUTOR_H
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "../utils/instrumented_mutex.h"
+
+namespace gara {
+
+// Scheduling lanes, drained strictly in this order
+enum class TransformPriority {
+    HIGH,     // Small thumbnails
+    NORMAL,   // Typical renditions
+    LOW       // Original-size or very large renditions
+};
+
+/**
+ * @brief Bounded worker pool that runs image transforms off the HTTP threads
+ *
+ * Tasks wait in one of three priority lanes. The total number of queued
+ * (not yet running) tasks is bounded; trySubmit refuses work beyond that so
+ * callers can shed load instead of piling up blocked requests.
+ */
+class TransformExecutor {
+public:
+    TransformExecutor(size_t worker_count, size_t max_queue_size);
+    ~TransformExecutor();
+
+    TransformExecutor(const TransformExecutor&) = delete;
+    TransformExecutor& operator=(const TransformExecutor&) = delete;
+
+    // Queue a task; returns false if the queue is full or the pool is stopped
+    bool trySubmit(TransformPriority priority, std::function<void()> task);
+
+    // Stop accepting work, finish queued tasks and join the workers
+    void shutdown();
+
+    // Number of tasks waiting for a worker
+    size_t queueDepth() const;
+
+    size_t workerCount() const { return workers_.size(); }
+
+    // True when nothing is queued and a worker is idle, i.e. background work would not delay anyone
+    bool hasSpareCapacity() const;
+
+    // Pick a lane from the requested output size (0 = original dimension)
+    static TransformPriority classify(int width, int height,
+                                      long long small_max_pixels, long long large_min_pixels);
+
+private:
+    struct QueuedTask {
+        std::function<void()> run;
+        std::chrono::steady_clock::time_point enqueued_at;
+    };
+
+    size_t max_queue_size_;
+    mutable utils::InstrumentedMutex mutex_{"transform_queue"};
+    std::condition_variable_any cv_;
+    std::deque<QueuedTask> lanes_[3];
+    size_t queued_ = 0;
+    size_t running_ = 0;
+    bool stopping_ = false;
+    std::vector<std::thread> workers_;
+
+    void workerLoop();
+};
+
+} // namespace gara
+
+#endif // GARA_TRANSFORM_EXECUTOR_H
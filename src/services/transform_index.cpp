@@ -0,0 +1,175 @@
+#include "transform_index.h"
+#include "../utils/logger.h"
+#include "../utils/metrics.h"
+#include "../utils/prometheus_registry.h"
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+
+namespace gara {
+
+namespace {
+// Accesses buffered between flushes; beyond this new keys wait for the next flush
+constexpr size_t MAX_BUFFERED_ACCESSES = 100000;
+
+// Renditions fetched per eviction query
+constexpr int EVICTION_BATCH_SIZE = 200;
+
+// An eviction pass stops once the cache is this far under budget, so it
+// does not run again on the very next store
+constexpr uint64_t EVICTION_TARGET_PERCENT = 90;
+}
+
+TransformIndex::TransformIndex(std::shared_ptr<DatabaseClientInterface> db_client,
+                               std::shared_ptr<FileServiceInterface> file_service,
+                               const CacheConfig& config,
+                               EvictionListener on_evict)
+    : db_client_(std::move(db_client)),
+      file_service_(std::move(file_service)),
+      config_(config),
+      policy_(config.eviction_policy == "lfu" ? RenditionEvictionPolicy::LFU : RenditionEvictionPolicy::LRU),
+      on_evict_(std::move(on_evict)) {
+    if (config_.eviction_interval_seconds > 0) {
+        evictor_ = std::thread(&TransformIndex::evictorLoop, this);
+    }
+}
+
+TransformIndex::~TransformIndex() {
+    {
+        std::lock_guard<std::mutex> lock(stop_mutex_);
+        stopping_ = true;
+    }
+    stop_cv_.notify_all();
+    if (evictor_.joinable()) {
+        evictor_.join();
+    }
+    flushAccesses();
+}
+
+void TransformIndex::recordStored(const std::string& storage_key, const std::string& image_id,
+                                  uint64_t size_bytes) {
+    RenditionRecord record;
+    record.storage_key = storage_key;
+    record.image_id = image_id;
+    record.size_bytes = size_bytes;
+    record.last_accessed = std::time(nullptr);
+
+    if (!db_client_->putRendition(record)) {
+        METRICS_COUNT("CacheOperations", 1.0, "Count", {{"operation", "index_put"}, {"status", "failure"}});
+    }
+}
+
+void TransformIndex::recordAccess(const std::string& storage_key) {
+    std::lock_guard<std::mutex> lock(access_mutex_);
+    if (accessed_.size() < MAX_BUFFERED_ACCESSES) {
+        accessed_.insert(storage_key);
+    }
+}
+
+void TransformIndex::flushAccesses() {
+    std::vector<std::string> keys;
+    {
+        std::lock_guard<std::mutex> lock(access_mutex_);
+        if (accessed_.empty()) {
+            return;
+        }
+        keys.assign(accessed_.begin(), accessed_.end());
+        accessed_.clear();
+    }
+
+    if (!db_client_->touchRenditions(keys, std::time(nullptr))) {
+        METRICS_COUNT("CacheOperations", 1.0, "Count", {{"operation", "index_touch"}, {"status", "failure"}});
+    }
+}
+
+std::vector<std::string> TransformIndex::invalidateImage(const std::string& image_id) {
+    std::vector<std::string> keys = db_client_->listRenditionKeys(image_id);
+    for (const auto& key : keys) {
+        file_service_->deleteObject(key);
+    }
+    db_client_->deleteRenditions(keys);
+    return keys;
+}
+
+void TransformIndex::forget(const std::string& storage_key) {
+    db_client_->deleteRenditions({storage_key});
+}
+
+uint64_t TransformIndex::evict() {
+    std::lock_guard<std::mutex> evict_lock(evict_mutex_);
+
+    // Eviction order depends on access data, so bring it up to date first
+    flushAccesses();
+
+    uint64_t total = db_client_->getRenditionBytes();
+    static auto& storage_bytes = PrometheusRegistry::instance().gauge(
+        "gara_cache_storage_bytes", "Bytes of transformed renditions recorded in the transform index");
+    storage_bytes.set(static_cast<double>(total));
+
+    uint64_t budget = config_.storage_max_bytes;
+    if (budget == 0 || total <= budget) {
+        return 0;
+    }
+
+    uint64_t target = budget / 100 * EVICTION_TARGET_PERCENT;
+    uint64_t freed = 0;
+    size_t evicted = 0;
+
+    while (total - freed > target) {
+        std::vector<RenditionRecord> candidates =
+            db_client_->listEvictionCandidates(EVICTION_BATCH_SIZE, policy_);
+        if (candidates.empty()) {
+            break;
+        }
+
+        std::vector<std::string> removed;
+        for (const auto& candidate : candidates) {
+            if (total - freed <= target) {
+                break;
+            }
+            // A missing object is already gone; the row goes either way
+            file_service_->deleteObject(candidate.storage_key);
+            if (on_evict_) {
+                on_evict_(candidate.storage_key);
+            }
+            removed.push_back(candidate.storage_key);
+            freed += std::min(candidate.size_bytes, total - freed);
+        }
+
+        if (!db_client_->deleteRenditions(removed)) {
+            break;
+        }
+        evicted += removed.size();
+    }
+
+    storage_bytes.set(static_cast<double>(total - freed));
+    static auto& evictions = PrometheusRegistry::instance().counter(
+        "gara_cache_evictions_total", "Transformed renditions removed by the evictor");
+    evictions.inc(static_cast<double>(evicted));
+    METRICS_COUNT("CacheOperations", static_cast<double>(evicted), "Count", {{"operation", "evict"}, {"status", "success"}});
+    gara::Logger::log_structured(spdlog::level::info, "Evicted cold renditions", {
+        {"evicted", evicted},
+        {"freed_bytes", freed},
+        {"budget_bytes", budget},
+        {"policy", config_.eviction_policy}
+    });
+    return freed;
+}
+
+void TransformIndex::evictorLoop() {
+    std::unique_lock<std::mutex> lock(stop_mutex_);
+    while (!stop_cv_.wait_for(lock, std::chrono::seconds(config_.eviction_interval_seconds),
+                              [this]() { return stopping_; })) {
+        lock.unlock();
+        try {
+            evict();
+        } catch (const std::exception& e) {
+            gara::Logger::log_structured(spdlog::level::err, "Rendition eviction failed", {
+                {"error", e.what()}
+            });
+        }
+        lock.lock();
+    }
+}
+
+} // namespace gara
@@ -0,0 +1,90 @@
+#ifndef GARA_TRANSFORM_INDEX_H
+#define GARA_TRANSFORM_INDEX_H
+
+#include "../interfaces/database_client_interface.h"
+#include "../interfaces/file_service_interface.h"
+#include "../models/cache_config.h"
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+namespace gara {
+
+/**
+ * @brief Record of the transformed renditions in storage, with eviction
+ *
+ * Every stored rendition gets a row (key, size, last access, hits) in the
+ * database. Accesses are buffered in memory and written in batches, so cache
+ * hits never wait on the database. A background thread flushes them and,
+ * when a storage budget is set, deletes the coldest renditions until the
+ * cache is back under budget.
+ */
+class TransformIndex {
+public:
+    // Called for each rendition the evictor removes, on the evictor thread
+    using EvictionListener = std::function<void(const std::string& storage_key)>;
+
+    TransformIndex(std::shared_ptr<DatabaseClientInterface> db_client,
+                   std::shared_ptr<FileServiceInterface> file_service,
+                   const CacheConfig& config = CacheConfig(),
+                   EvictionListener on_evict = nullptr);
+
+    // Stops the evictor and flushes buffered accesses
+    ~TransformIndex();
+
+    TransformIndex(const TransformIndex&) = delete;
+    TransformIndex& operator=(const TransformIndex&) = delete;
+
+    // Record a rendition that was just written to storage
+    void recordStored(const std::string& storage_key, const std::string& image_id, uint64_t size_bytes);
+
+    // Note a cache hit; written to the database on the next flush
+    void recordAccess(const std::string& storage_key);
+
+    // Write buffered accesses to the database now
+    void flushAccesses();
+
+    /**
+     * @brief Delete every recorded rendition of an image from storage and the index
+     * @return Storage keys that were removed
+     */
+    std::vector<std::string> invalidateImage(const std::string& image_id);
+
+    // Drop one rendition from the index (the caller deletes the object)
+    void forget(const std::string& storage_key);
+
+    /**
+     * @brief Run one eviction pass if the cache is over its budget
+     * @return Bytes freed
+     */
+    uint64_t evict();
+
+private:
+    void evictorLoop();
+
+    std::shared_ptr<DatabaseClientInterface> db_client_;
+    std::shared_ptr<FileServiceInterface> file_service_;
+    CacheConfig config_;
+    RenditionEvictionPolicy policy_;
+    EvictionListener on_evict_;
+
+    std::mutex access_mutex_;
+    std::unordered_set<std::string> accessed_;  // Hits since the last flush
+
+    std::mutex evict_mutex_;  // One eviction pass at a time
+
+    std::mutex stop_mutex_;
+    std::condition_variable stop_cv_;
+    bool stopping_ = false;
+    std::thread evictor_;
+};
+
+} // namespace gara
+
+#endif // GARA_TRANSFORM_INDEX_H
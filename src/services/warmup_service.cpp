@@ -0,0 +1,196 @@
+#include "warmup_service.h"
+#include "album_cache.h"
+#include "album_service.h"
+#include "cache_manager.h"
+#include "raw_key_resolver.h"
+#include "../utils/logger.h"
+#include "../utils/metrics.h"
+#include <nlohmann/json.hpp>
+#include <chrono>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+
+namespace gara {
+
+namespace {
+
+// First max_entries string elements of a JSON array section
+std::vector<std::string> readKeys(const nlohmann::json& snapshot, const char* section, size_t max_entries) {
+    std::vector<std::string> keys;
+    auto it = snapshot.find(section);
+    if (it == snapshot.end() || !it->is_array()) {
+        return keys;
+    }
+    for (const auto& key : *it) {
+        if (keys.size() == max_entries) {
+            break;
+        }
+        if (key.is_string()) {
+            keys.push_back(key.get<std::string>());
+        }
+    }
+    return keys;
+}
+
+} // anonymous namespace
+
+WarmupService::WarmupService(const WarmupConfig& config,
+                             std::shared_ptr<CacheManager> cache_manager,
+                             std::shared_ptr<RawKeyResolver> raw_key_resolver,
+                             std::shared_ptr<AlbumService> album_service,
+                             std::shared_ptr<AlbumCache> album_cache)
+    : config_(config),
+      cache_manager_(std::move(cache_manager)),
+      raw_key_resolver_(std::move(raw_key_resolver)),
+      album_service_(std::move(album_service)),
+      album_cache_(std::move(album_cache)) {}
+
+WarmupService::~WarmupService() {
+    {
+        std::lock_guard<std::mutex> lock(stop_mutex_);
+        stopping_ = true;
+    }
+    stop_cv_.notify_all();
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+    // A shutdown mid warm-up would replace the snapshot with a partial hot set
+    if (config_.isEnabled() && ready()) {
+        writeSnapshot();
+    }
+}
+
+void WarmupService::start() {
+    if (!config_.isEnabled()) {
+        ready_.store(true, std::memory_order_release);
+        return;
+    }
+    worker_ = std::thread(&WarmupService::run, this);
+}
+
+void WarmupService::run() {
+    try {
+        warm();
+    } catch (const std::exception& e) {
+        gara::Logger::log_structured(spdlog::level::err, "Cache warm-up failed", {
+            {"error", e.what()}
+        });
+    }
+    ready_.store(true, std::memory_order_release);
+
+    std::unique_lock<std::mutex> lock(stop_mutex_);
+    while (!stop_cv_.wait_for(lock, std::chrono::seconds(config_.snapshot_interval_seconds),
+                              [this]() { return stopping_; })) {
+        lock.unlock();
+        writeSnapshot();
+        lock.lock();
+    }
+}
+
+size_t WarmupService::warm() {
+    auto started = std::chrono::steady_clock::now();
+
+    std::ifstream file(config_.snapshot_path);
+    if (!file) {
+        gara::Logger::log_structured(spdlog::level::info, "No hot-set snapshot, starting cold", {
+            {"path", config_.snapshot_path}
+        });
+        return 0;
+    }
+
+    nlohmann::json snapshot = nlohmann::json::parse(file, nullptr, false);
+    if (snapshot.is_discarded() || !snapshot.is_object()) {
+        gara::Logger::log_structured(spdlog::level::warn, "Ignoring unreadable hot-set snapshot", {
+            {"path", config_.snapshot_path}
+        });
+        return 0;
+    }
+
+    size_t raw_keys = 0;
+    if (raw_key_resolver_) {
+        auto it = snapshot.find("raw_keys");
+        if (it != snapshot.end() && it->is_object()) {
+            for (const auto& [image_id, raw_key] : it->items()) {
+                if (raw_keys == config_.max_entries) {
+                    break;
+                }
+                if (raw_key.is_string()) {
+                    raw_key_resolver_->remember(image_id, raw_key.get<std::string>());
+                    ++raw_keys;
+                }
+            }
+        }
+    }
+
+    size_t renditions = 0;
+    if (cache_manager_) {
+        renditions = cache_manager_->warmKeys(readKeys(snapshot, "renditions", config_.max_entries));
+    }
+
+    size_t albums = 0;
+    if (album_service_) {
+        albums = album_service_->warmCache(readKeys(snapshot, "albums", config_.max_entries));
+    }
+
+    METRICS_COUNT("WarmupEntries", static_cast<double>(renditions), "Count", {{"section", "renditions"}});
+    METRICS_COUNT("WarmupEntries", static_cast<double>(raw_keys), "Count", {{"section", "raw_keys"}});
+    METRICS_COUNT("WarmupEntries", static_cast<double>(albums), "Count", {{"section", "albums"}});
+
+    auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - started).count();
+    gara::Logger::log_structured(spdlog::level::info, "Warmed caches from hot-set snapshot", {
+        {"path", config_.snapshot_path},
+        {"renditions", renditions},
+        {"raw_keys", raw_keys},
+        {"albums", albums},
+        {"duration_ms", elapsed_ms}
+    });
+    return renditions + raw_keys + albums;
+}
+
+bool WarmupService::writeSnapshot() {
+    nlohmann::json snapshot = {
+        {"written_at", static_cast<int64_t>(std::time(nullptr))},
+        {"renditions", nlohmann::json::array()},
+        {"raw_keys", nlohmann::json::object()},
+        {"albums", nlohmann::json::array()}
+    };
+    if (cache_manager_) {
+        snapshot["renditions"] = cache_manager_->hotKeys(config_.max_entries);
+    }
+    if (raw_key_resolver_) {
+        for (const auto& [image_id, raw_key] : raw_key_resolver_->hotMappings(config_.max_entries)) {
+            snapshot["raw_keys"][image_id] = raw_key;
+        }
+    }
+    if (album_cache_) {
+        snapshot["albums"] = album_cache_->albumIds(config_.max_entries);
+    }
+
+    std::string temp_path = config_.snapshot_path + ".tmp";
+    {
+        std::ofstream out(temp_path, std::ios::trunc);
+        out << snapshot.dump();
+        if (!out) {
+            gara::Logger::log_structured(spdlog::level::warn, "Failed to write hot-set snapshot", {
+                {"path", temp_path}
+            });
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(temp_path, config_.snapshot_path, ec);
+    if (ec) {
+        gara::Logger::log_structured(spdlog::level::warn, "Failed to replace hot-set snapshot", {
+            {"path", config_.snapshot_path},
+            {"error", ec.message()}
+        });
+        std::filesystem::remove(temp_path, ec);
+        return false;
+    }
+    return true;
+}
+
+} // namespace gara
@@ -0,0 +1,84 @@
+#ifndef GARA_WARMUP_SERVICE_H
+#define GARA_WARMUP_SERVICE_H
+
+#include "../models/warmup_config.h"
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace gara {
+
+class AlbumCache;
+class AlbumService;
+class CacheManager;
+class RawKeyResolver;
+
+/**
+ * @brief Warm-start for in-process caches, and the readiness it gates
+ *
+ * The running service periodically writes a hot-set snapshot: the most
+ * recently used rendition keys, raw-key mappings and album IDs. On startup
+ * the snapshot is loaded back before the instance reports ready, so a fresh
+ * pod answers its first requests from memory instead of sending a wave of
+ * existence checks and reads to storage and the database.
+ *
+ * Any cache may be nullptr; its section is then neither written nor loaded.
+ * Without a snapshot path the instance is ready at once.
+ */
+class WarmupService {
+public:
+    WarmupService(const WarmupConfig& config,
+                  std::shared_ptr<CacheManager> cache_manager,
+                  std::shared_ptr<RawKeyResolver> raw_key_resolver,
+                  std::shared_ptr<AlbumService> album_service,
+                  std::shared_ptr<AlbumCache> album_cache);
+
+    // Stops the snapshot thread and writes a final snapshot
+    ~WarmupService();
+
+    WarmupService(const WarmupService&) = delete;
+    WarmupService& operator=(const WarmupService&) = delete;
+
+    // Warm up on a background thread, then keep the snapshot fresh
+    void start();
+
+    // True once warm-up has finished (or was not needed)
+    bool ready() const { return ready_.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Load the snapshot into the caches
+     * @return Entries preloaded across all sections
+     */
+    size_t warm();
+
+    /**
+     * @brief Write the current hot set to the snapshot path
+     *
+     * Written to a temporary file and renamed, so a crash mid-write leaves
+     * the previous snapshot intact.
+     */
+    bool writeSnapshot();
+
+private:
+    void run();
+
+    WarmupConfig config_;
+    std::shared_ptr<CacheManager> cache_manager_;
+    std::shared_ptr<RawKeyResolver> raw_key_resolver_;
+    std::shared_ptr<AlbumService> album_service_;
+    std::shared_ptr<AlbumCache> album_cache_;
+
+    std::atomic<bool> ready_{false};
+
+    std::mutex stop_mutex_;
+    std::condition_variable stop_cv_;
+    bool stopping_ = false;
+    std::thread worker_;
+};
+
+} // namespace gara
+
+#endif // GARA_WARMUP_SERVICE_H
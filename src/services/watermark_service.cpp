@@ -5,8 +5,16 @@
 
 namespace gara {
 
+namespace {
+// Font sizes are clamped to 12..100, so this holds every overlay for typical text
+constexpr size_t OVERLAY_CACHE_BYTES = 32 * 1024 * 1024;
+constexpr size_t OVERLAY_CACHE_SHARDS = 4;
+constexpr int SHADOW_OFFSET = 2;
+}
+
 WatermarkService::WatermarkService(const WatermarkConfig& config)
-    : config_(config) {
+    : config_(config),
+      overlay_cache_(OVERLAY_CACHE_BYTES, std::chrono::seconds(0), OVERLAY_CACHE_SHARDS) {
     if (!config_.isValid()) {
         gara::Logger::log_structured(spdlog::level::warn, "Invalid watermark configuration, using defaults", {
             {"config_enabled", config.enabled},
@@ -38,26 +46,15 @@ vips::VImage WatermarkService::applyWatermark(const vips::VImage& image) const {
         // Calculate appropriate font size for this image
         int fontSize = calculateFontSize(imageWidth);
 
-        // Create text image with white text
-        vips::VImage textImage = createTextImage(config_.text, fontSize);
-
-        // Create shadow for better visibility
-        vips::VImage shadowImage = createShadow(textImage);
+        // Text and shadow are rendered once per font size and reused
+        Overlay overlay = getOverlay(fontSize);
 
-        // Get watermark dimensions (from text image)
-        int watermarkWidth = textImage.width();
-        int watermarkHeight = textImage.height();
-
-        // Calculate position based on config
+        // Calculate position based on config (placement is by the text, not its shadow)
         auto [x, y] = calculatePosition(imageWidth, imageHeight,
-                                       watermarkWidth, watermarkHeight);
-
-        // First, composite shadow onto the image
-        vips::VImage withShadow = compositeWatermark(image, shadowImage,
-                                                     x + 2, y + 2);
+                                       overlay.text_width, overlay.text_height);
 
-        // Then, composite white text on top
-        vips::VImage result = compositeWatermark(withShadow, textImage, x, y);
+        // Composite text and shadow in one pass
+        vips::VImage result = compositeWatermark(image, overlay.image, x, y);
 
         METRICS_COUNT("WatermarkOperations", 1.0, "Count", {{"status", "success"}});
         return result;
@@ -96,6 +93,57 @@ bool WatermarkService::isEnabled() const {
     return config_.enabled;
 }
 
+size_t WatermarkService::cachedOverlayCount() const {
+    return overlay_cache_.size();
+}
+
+WatermarkService::Overlay WatermarkService::getOverlay(int fontSize) const {
+    std::string key = std::to_string(fontSize);
+    if (auto cached = overlay_cache_.get(key)) {
+        METRICS_COUNT("WatermarkOverlayCache", 1.0, "Count", {{"status", "hit"}});
+        return *cached;
+    }
+
+    // Check again under the lock so concurrent misses render only once
+    std::lock_guard<std::mutex> lock(overlay_render_mutex_);
+    if (auto cached = overlay_cache_.get(key)) {
+        METRICS_COUNT("WatermarkOverlayCache", 1.0, "Count", {{"status", "hit"}});
+        return *cached;
+    }
+
+    METRICS_COUNT("WatermarkOverlayCache", 1.0, "Count", {{"status", "miss"}});
+    Overlay overlay = renderOverlay(fontSize);
+    // Overlays are 8-bit, so one byte per band per pixel
+    size_t cost = static_cast<size_t>(overlay.image.width()) * overlay.image.height() * overlay.image.bands();
+    overlay_cache_.put(key, overlay, cost);
+    return overlay;
+}
+
+WatermarkService::Overlay WatermarkService::renderOverlay(int fontSize) const {
+    // Create text image with white text
+    vips::VImage textImage = createTextImage(config_.text, fontSize);
+
+    // Create shadow for better visibility
+    vips::VImage shadowImage = createShadow(textImage, SHADOW_OFFSET);
+
+    // Shadow sits SHADOW_OFFSET pixels down and right of the text
+    int width = textImage.width() + SHADOW_OFFSET;
+    int height = textImage.height() + SHADOW_OFFSET;
+    std::vector<double> transparent = {0, 0, 0, 0};
+
+    vips::VImage shadowLayer = shadowImage.embed(SHADOW_OFFSET, SHADOW_OFFSET, width, height,
+        vips::VImage::option()->set("extend", VIPS_EXTEND_BACKGROUND)->set("background", transparent));
+    vips::VImage textLayer = textImage.embed(0, 0, width, height,
+        vips::VImage::option()->set("extend", VIPS_EXTEND_BACKGROUND)->set("background", transparent));
+
+    // Rasterize now so later images only read the pixels
+    vips::VImage combined = shadowLayer.composite2(textLayer, VIPS_BLEND_MODE_OVER)
+        .cast(VIPS_FORMAT_UCHAR)
+        .copy_memory();
+
+    return {combined, textImage.width(), textImage.height()};
+}
+
 int WatermarkService::calculateFontSize(int imageWidth) const {
     // Scale font size to 2.5% of image width
     // Minimum 12px, maximum 100px for reasonable sizes
@@ -233,23 +281,10 @@ vips::VImage WatermarkService::compositeWatermark(const vips::VImage& image,
             img = img.bandjoin(255);  // Add opaque alpha channel
         }
 
-        // Embed watermark at position (x, y) on a transparent canvas the size of the image
-        vips::VImage canvas = vips::VImage::black(img.width(), img.height())
-            .new_from_image(std::vector<double>{0, 0, 0, 0})  // Transparent black
-            .copy(vips::VImage::option()->set("interpretation", VIPS_INTERPRETATION_sRGB));
-
-        // Add alpha channel to canvas
-        if (canvas.bands() == 3) {
-            canvas = canvas.bandjoin(0);  // Add transparent alpha
-        }
-
-        // Embed watermark at position
-        vips::VImage positioned = watermark.embed(x, y, img.width(), img.height(),
-            vips::VImage::option()->set("extend", VIPS_EXTEND_BACKGROUND)
-                ->set("background", std::vector<double>{0, 0, 0, 0}));
-
-        // Composite watermark over image using "over" blend mode
-        vips::VImage result = img.composite2(positioned, VIPS_BLEND_MODE_OVER);
+        // Composite watermark over image at (x, y) using "over" blend mode; only
+        // the overlapping region is blended, so no image-sized canvas is needed
+        vips::VImage result = img.composite2(watermark, VIPS_BLEND_MODE_OVER,
+            vips::VImage::option()->set("x", x)->set("y", y));
 
         // If original image didn't have alpha, remove it now
         if (!image.has_alpha() && result.has_alpha()) {
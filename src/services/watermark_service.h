@@ -2,9 +2,12 @@
 #define GARA_WATERMARK_SERVICE_H
 
 #include <vips/vips8>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <utility>
 #include "../models/watermark_config.h"
+#include "../utils/lru_cache.h"
 
 namespace gara {
 
@@ -26,9 +29,29 @@ public:
     // Check if watermarking is enabled
     bool isEnabled() const;
 
+    // Number of rendered overlays currently cached (for testing/debugging)
+    size_t cachedOverlayCount() const;
+
 private:
+    // Text and shadow rendered once per font size, ready to composite
+    struct Overlay {
+        vips::VImage image;
+        int text_width;
+        int text_height;
+    };
+
     WatermarkConfig config_;
 
+    // Font size is the only per-image input to rendering, so it keys the cache
+    mutable utils::ShardedLruCache<Overlay> overlay_cache_;
+    mutable std::mutex overlay_render_mutex_;  // One render per font size under concurrency
+
+    // Get the overlay for a font size, rendering it on first use
+    Overlay getOverlay(int fontSize) const;
+
+    // Render text over its shadow into a single in-memory RGBA image
+    Overlay renderOverlay(int fontSize) const;
+
     // Calculate appropriate font size based on image dimensions
     // Uses 2.5% of image width as base scale
     int calculateFontSize(int imageWidth) const;
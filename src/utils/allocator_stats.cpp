@@ -0,0 +1,140 @@
+#include "allocator_stats.h"
+#include <cstdlib>
+#include <fstream>
+#include <new>
+#include <unistd.h>
+#if defined(GARA_JEMALLOC)
+#include <jemalloc/jemalloc.h>
+#elif defined(GARA_MIMALLOC)
+#include <mimalloc.h>
+#elif defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+#if defined(GARA_ALLOCATION_COUNTERS) && !defined(GARA_JEMALLOC)
+namespace {
+// Bytes handed out by operator new on this thread
+thread_local uint64_t thread_new_bytes = 0;
+} // anonymous namespace
+
+void* operator new(std::size_t size) {
+    thread_new_bytes += size;
+    if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    return ::operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    thread_new_bytes += size;
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept {
+    return ::operator new(size, tag);
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
+#endif
+
+namespace gara {
+namespace utils {
+
+namespace {
+
+#if defined(GARA_JEMALLOC)
+uint64_t readJemallocStat(const char* name) {
+    size_t value = 0;
+    size_t size = sizeof(value);
+    if (mallctl(name, &value, &size, nullptr, 0) != 0) {
+        return 0;
+    }
+    return value;
+}
+#endif
+
+} // anonymous namespace
+
+const char* AllocatorStats::allocatorName() {
+#if defined(GARA_JEMALLOC)
+    return "jemalloc";
+#elif defined(GARA_MIMALLOC)
+    return "mimalloc";
+#else
+    return "system";
+#endif
+}
+
+std::vector<std::pair<std::string, uint64_t>> AllocatorStats::sample() {
+    std::vector<std::pair<std::string, uint64_t>> stats;
+#if defined(GARA_JEMALLOC)
+    // jemalloc caches its totals; bumping the epoch refreshes them
+    uint64_t epoch = 1;
+    size_t epoch_size = sizeof(epoch);
+    mallctl("epoch", &epoch, &epoch_size, &epoch, epoch_size);
+    for (const char* name : {"stats.allocated", "stats.active", "stats.metadata", "stats.resident",
+                             "stats.mapped", "stats.retained"}) {
+        stats.emplace_back(name, readJemallocStat(name));
+    }
+#elif defined(GARA_MIMALLOC)
+    size_t elapsed = 0, user = 0, system = 0, rss = 0, peak_rss = 0, commit = 0, peak_commit = 0, faults = 0;
+    mi_process_info(&elapsed, &user, &system, &rss, &peak_rss, &commit, &peak_commit, &faults);
+    stats.emplace_back("current_rss", rss);
+    stats.emplace_back("peak_rss", peak_rss);
+    stats.emplace_back("current_commit", commit);
+    stats.emplace_back("peak_commit", peak_commit);
+#elif defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    struct mallinfo2 info = mallinfo2();
+    stats.emplace_back("arena", info.arena);
+    stats.emplace_back("mmapped", info.hblkhd);
+    stats.emplace_back("in_use", info.uordblks);
+    stats.emplace_back("free", info.fordblks);
+    stats.emplace_back("releasable", info.keepcost);
+#endif
+    return stats;
+}
+
+uint64_t AllocatorStats::residentBytes() {
+    // statm: total and resident sizes in pages
+    std::ifstream statm("/proc/self/statm");
+    uint64_t total_pages = 0;
+    uint64_t resident_pages = 0;
+    if (!(statm >> total_pages >> resident_pages)) {
+        return 0;
+    }
+    return resident_pages * static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+}
+
+bool AllocatorStats::threadCountersEnabled() {
+#if defined(GARA_ALLOCATION_COUNTERS)
+    return true;
+#else
+    return false;
+#endif
+}
+
+uint64_t AllocatorStats::threadAllocatedBytes() {
+#if defined(GARA_ALLOCATION_COUNTERS) && defined(GARA_JEMALLOC)
+    // Pointer to this thread's running total, looked up once per thread
+    thread_local uint64_t* allocated = []() -> uint64_t* {
+        uint64_t* pointer = nullptr;
+        size_t size = sizeof(pointer);
+        return mallctl("thread.allocatedp", &pointer, &size, nullptr, 0) == 0 ? pointer : nullptr;
+    }();
+    return allocated ? *allocated : 0;
+#elif defined(GARA_ALLOCATION_COUNTERS)
+    return thread_new_bytes;
+#else
+    return 0;
+#endif
+}
+
+} // namespace utils
+} // namespace gara
@@ -0,0 +1,46 @@
+#ifndef GARA_UTILS_ALLOCATOR_STATS_H
+#define GARA_UTILS_ALLOCATOR_STATS_H
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace gara {
+namespace utils {
+
+/**
+ * @brief Heap allocator introspection
+ *
+ * The allocator is picked at build time (GARA_ALLOCATOR=system|jemalloc|
+ * mimalloc). Counter names follow the allocator's own vocabulary, e.g.
+ * jemalloc's stats.allocated/active/resident/retained or glibc's mallinfo2
+ * arena and in-use totals.
+ *
+ * Per-thread allocation counts need ENABLE_ALLOCATION_COUNTERS. Under
+ * jemalloc they come from thread.allocated and cover every malloc, including
+ * libvips and glib; otherwise a replacement operator new counts C++
+ * allocations only.
+ */
+class AllocatorStats {
+public:
+    // "jemalloc", "mimalloc" or "system"
+    static const char* allocatorName();
+
+    // Allocator-specific byte counters, sampled now
+    static std::vector<std::pair<std::string, uint64_t>> sample();
+
+    // Resident set size of the process (0 where /proc is unavailable)
+    static uint64_t residentBytes();
+
+    // Whether threadAllocatedBytes() counts anything in this build
+    static bool threadCountersEnabled();
+
+    // Bytes this thread has allocated since it started (0 when not counted)
+    static uint64_t threadAllocatedBytes();
+};
+
+} // namespace utils
+} // namespace gara
+
+#endif // GARA_UTILS_ALLOCATOR_STATS_H
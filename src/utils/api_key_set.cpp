@@ -0,0 +1,95 @@
+#include "api_key_set.h"
+#include <algorithm>
+#include <openssl/evp.h>
+
+namespace gara {
+namespace utils {
+
+namespace {
+
+// Reused per thread, so steady-state digests need no allocation
+struct DigestContext {
+    EVP_MD_CTX* ctx = EVP_MD_CTX_new();
+    ~DigestContext() { EVP_MD_CTX_free(ctx); }
+};
+
+std::string_view trim(std::string_view value) {
+    const char* whitespace = " \t\r\n";
+    size_t first = value.find_first_not_of(whitespace);
+    if (first == std::string_view::npos) {
+        return {};
+    }
+    size_t last = value.find_last_not_of(whitespace);
+    return value.substr(first, last - first + 1);
+}
+
+} // anonymous namespace
+
+ApiKeySet::ApiKeySet(const std::vector<std::string>& keys) {
+    digests_.reserve(keys.size());
+    for (const auto& key : keys) {
+        if (key.empty()) {
+            continue;
+        }
+        Digest key_digest;
+        if (!digest(key, key_digest)) {
+            continue;
+        }
+        if (primary_.empty()) {
+            primary_ = key;
+        }
+        digests_.push_back(key_digest);
+    }
+    std::sort(digests_.begin(), digests_.end());
+    digests_.erase(std::unique(digests_.begin(), digests_.end()), digests_.end());
+}
+
+bool ApiKeySet::matches(std::string_view provided_key) const {
+    if (provided_key.empty() || digests_.empty()) {
+        return false;
+    }
+
+    Digest provided;
+    if (!digest(provided_key, provided)) {
+        return false;
+    }
+    uint8_t any_match = 0;
+    for (const auto& expected : digests_) {
+        uint8_t difference = 0;
+        for (size_t i = 0; i < provided.size(); ++i) {
+            difference |= provided[i] ^ expected[i];
+        }
+        any_match |= static_cast<uint8_t>(difference == 0);
+    }
+    return any_match != 0;
+}
+
+std::vector<std::string> ApiKeySet::parse(std::string_view list) {
+    std::vector<std::string> keys;
+    size_t start = 0;
+    while (start <= list.size()) {
+        size_t end = list.find_first_of(",\n", start);
+        if (end == std::string_view::npos) {
+            end = list.size();
+        }
+        std::string_view key = trim(list.substr(start, end - start));
+        if (!key.empty() && key.front() != '#') {
+            keys.emplace_back(key);
+        }
+        start = end + 1;
+    }
+    return keys;
+}
+
+bool ApiKeySet::digest(std::string_view key, Digest& out) {
+    thread_local DigestContext context;
+    unsigned int length = 0;
+    return context.ctx != nullptr &&
+           EVP_DigestInit_ex(context.ctx, EVP_sha256(), nullptr) == 1 &&
+           EVP_DigestUpdate(context.ctx, key.data(), key.size()) == 1 &&
+           EVP_DigestFinal_ex(context.ctx, out.data(), &length) == 1 &&
+           length == out.size();
+}
+
+} // namespace utils
+} // namespace gara
@@ -0,0 +1,57 @@
+#ifndef GARA_UTILS_API_KEY_SET_H
+#define GARA_UTILS_API_KEY_SET_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace gara {
+namespace utils {
+
+/**
+ * @brief Immutable set of accepted API keys, held as SHA-256 digests
+ *
+ * Several keys can be active at once so a new key can be rolled out before
+ * the old one is withdrawn. A check hashes the presented key and compares
+ * it against every digest without early exit, so timing reveals neither
+ * which key matched nor how long the keys are. After a thread's first
+ * check no memory is allocated.
+ */
+class ApiKeySet {
+public:
+    using Digest = std::array<uint8_t, 32>;
+
+    ApiKeySet() = default;
+    explicit ApiKeySet(const std::vector<std::string>& keys);
+
+    bool matches(std::string_view provided_key) const;
+
+    bool empty() const { return digests_.empty(); }
+    size_t size() const { return digests_.size(); }
+
+    // First configured key, for callers that need the key itself
+    const std::string& primary() const { return primary_; }
+
+    bool sameKeys(const ApiKeySet& other) const { return digests_ == other.digests_; }
+
+    /**
+     * @brief Split a key list on commas and newlines
+     *
+     * Whitespace around keys is trimmed; blank entries and lines starting
+     * with '#' are skipped.
+     */
+    static std::vector<std::string> parse(std::string_view list);
+
+private:
+    static bool digest(std::string_view key, Digest& out);
+
+    std::vector<Digest> digests_;  // Sorted, duplicates removed
+    std::string primary_;
+};
+
+} // namespace utils
+} // namespace gara
+
+#endif // GARA_UTILS_API_KEY_SET_H
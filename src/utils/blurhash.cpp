@@ -0,0 +1,128 @@
+#include "blurhash.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+
+namespace gara {
+namespace utils {
+
+namespace {
+
+constexpr char BASE83[] =
+    "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz#$%*+,-.:;=?@[]^_{|}~";
+
+void appendBase83(std::string& out, int value, int length) {
+    int divisor = 1;
+    for (int i = 1; i < length; ++i) {
+        divisor *= 83;
+    }
+    for (int i = 0; i < length; ++i) {
+        out += BASE83[(value / divisor) % 83];
+        divisor /= 83;
+    }
+}
+
+float srgbToLinear(uint8_t value) {
+    float v = value / 255.0f;
+    return v <= 0.04045f ? v / 12.92f : std::pow((v + 0.055f) / 1.055f, 2.4f);
+}
+
+int linearToSrgb(float value) {
+    float v = std::clamp(value, 0.0f, 1.0f);
+    if (v <= 0.0031308f) {
+        return static_cast<int>(v * 12.92f * 255.0f + 0.5f);
+    }
+    return static_cast<int>((1.055f * std::pow(v, 1.0f / 2.4f) - 0.055f) * 255.0f + 0.5f);
+}
+
+float signPow(float value, float exponent) {
+    return std::copysign(std::pow(std::fabs(value), exponent), value);
+}
+
+int quantiseAc(float value, float maximum) {
+    return std::clamp(static_cast<int>(std::floor(signPow(value / maximum, 0.5f) * 9.0f + 9.5f)), 0, 18);
+}
+
+} // anonymous namespace
+
+std::string BlurHash::encode(const uint8_t* pixels, int width, int height,
+                             int components_x, int components_y) {
+    if (!pixels || width <= 0 || height <= 0 ||
+        components_x < 1 || components_x > MAX_COMPONENTS ||
+        components_y < 1 || components_y > MAX_COMPONENTS) {
+        return "";
+    }
+
+    // Linearise once; every component reads every pixel
+    std::vector<std::array<float, 3>> linear(static_cast<size_t>(width) * height);
+    for (size_t i = 0; i < linear.size(); ++i) {
+        linear[i] = {srgbToLinear(pixels[i * 3]), srgbToLinear(pixels[i * 3 + 1]),
+                     srgbToLinear(pixels[i * 3 + 2])};
+    }
+
+    std::vector<float> cos_x(static_cast<size_t>(components_x) * width);
+    for (int i = 0; i < components_x; ++i) {
+        for (int x = 0; x < width; ++x) {
+            cos_x[i * width + x] = std::cos(static_cast<float>(M_PI) * i * x / width);
+        }
+    }
+    std::vector<float> cos_y(static_cast<size_t>(components_y) * height);
+    for (int j = 0; j < components_y; ++j) {
+        for (int y = 0; y < height; ++y) {
+            cos_y[j * height + y] = std::cos(static_cast<float>(M_PI) * j * y / height);
+        }
+    }
+
+    std::vector<std::array<float, 3>> factors;
+    factors.reserve(static_cast<size_t>(components_x) * components_y);
+    for (int j = 0; j < components_y; ++j) {
+        for (int i = 0; i < components_x; ++i) {
+            std::array<float, 3> sum = {0.0f, 0.0f, 0.0f};
+            for (int y = 0; y < height; ++y) {
+                for (int x = 0; x < width; ++x) {
+                    float basis = cos_x[i * width + x] * cos_y[j * height + y];
+                    const auto& pixel = linear[static_cast<size_t>(y) * width + x];
+                    sum[0] += basis * pixel[0];
+                    sum[1] += basis * pixel[1];
+                    sum[2] += basis * pixel[2];
+                }
+            }
+            float scale = (i == 0 && j == 0 ? 1.0f : 2.0f) / (static_cast<float>(width) * height);
+            factors.push_back({sum[0] * scale, sum[1] * scale, sum[2] * scale});
+        }
+    }
+
+    std::string hash;
+    hash.reserve(4 + 2 * factors.size());
+    appendBase83(hash, (components_x - 1) + (components_y - 1) * 9, 1);
+
+    float maximum = 1.0f;
+    if (factors.size() > 1) {
+        float actual_maximum = 0.0f;
+        for (size_t k = 1; k < factors.size(); ++k) {
+            for (float component : factors[k]) {
+                actual_maximum = std::max(actual_maximum, std::fabs(component));
+            }
+        }
+        int quantised = std::clamp(static_cast<int>(std::floor(actual_maximum * 166.0f - 0.5f)), 0, 82);
+        maximum = (quantised + 1) / 166.0f;
+        appendBase83(hash, quantised, 1);
+    } else {
+        appendBase83(hash, 0, 1);
+    }
+
+    const auto& dc = factors[0];
+    appendBase83(hash, (linearToSrgb(dc[0]) << 16) + (linearToSrgb(dc[1]) << 8) + linearToSrgb(dc[2]), 4);
+
+    for (size_t k = 1; k < factors.size(); ++k) {
+        const auto& ac = factors[k];
+        appendBase83(hash, quantiseAc(ac[0], maximum) * 19 * 19 + quantiseAc(ac[1], maximum) * 19 +
+                           quantiseAc(ac[2], maximum), 2);
+    }
+
+    return hash;
+}
+
+} // namespace utils
+} // namespace gara
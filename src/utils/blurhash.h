@@ -0,0 +1,32 @@
+#ifndef GARA_UTILS_BLURHASH_H
+#define GARA_UTILS_BLURHASH_H
+
+#include <cstdint>
+#include <string>
+
+namespace gara {
+namespace utils {
+
+/**
+ * @brief BlurHash encoder (https://blurha.sh)
+ *
+ * Reduces an image to a handful of DCT components packed into a short
+ * base83 string (4x3 components = 28 characters) that clients decode into a
+ * blurred placeholder while the real image loads. Encoding cost is
+ * proportional to pixels x components, so callers pass a thumbnail of a few
+ * dozen pixels rather than the source.
+ */
+class BlurHash {
+public:
+    static constexpr int MAX_COMPONENTS = 9;
+
+    // Encode width x height sRGB pixels (3 bytes each, rows packed).
+    // Components must be 1..MAX_COMPONENTS; returns "" on invalid input
+    static std::string encode(const uint8_t* pixels, int width, int height,
+                              int components_x, int components_y);
+};
+
+} // namespace utils
+} // namespace gara
+
+#endif // GARA_UTILS_BLURHASH_H
@@ -0,0 +1,59 @@
+#include "consistent_hash.h"
+#include <algorithm>
+
+namespace gara {
+namespace utils {
+
+namespace {
+
+const std::string NO_MEMBER;
+
+} // anonymous namespace
+
+ConsistentHashRing::ConsistentHashRing(int virtual_nodes)
+    : virtual_nodes_(std::max(1, virtual_nodes)) {}
+
+void ConsistentHashRing::setMembers(std::vector<std::string> members) {
+    std::sort(members.begin(), members.end());
+    members.erase(std::unique(members.begin(), members.end()), members.end());
+    members_ = std::move(members);
+
+    ring_.clear();
+    ring_.reserve(members_.size() * virtual_nodes_);
+    for (size_t i = 0; i < members_.size(); ++i) {
+        for (int v = 0; v < virtual_nodes_; ++v) {
+            ring_.emplace_back(hash(members_[i] + "#" + std::to_string(v)), i);
+        }
+    }
+    std::sort(ring_.begin(), ring_.end());
+}
+
+const std::string& ConsistentHashRing::ownerOf(std::string_view key) const {
+    if (ring_.empty()) {
+        return NO_MEMBER;
+    }
+    uint64_t point = hash(key);
+    auto it = std::lower_bound(ring_.begin(), ring_.end(), std::make_pair(point, size_t{0}));
+    if (it == ring_.end()) {
+        it = ring_.begin();
+    }
+    return members_[it->second];
+}
+
+uint64_t ConsistentHashRing::hash(std::string_view data) {
+    uint64_t value = 0xcbf29ce484222325ULL;
+    for (unsigned char c : data) {
+        value ^= c;
+        value *= 0x100000001b3ULL;
+    }
+    // FNV alone clusters similar strings ("node#1", "node#2") on the ring
+    value ^= value >> 33;
+    value *= 0xff51afd7ed558ccdULL;
+    value ^= value >> 33;
+    value *= 0xc4ceb9fe1a85ec53ULL;
+    value ^= value >> 33;
+    return value;
+}
+
+} // namespace utils
+} // namespace gara
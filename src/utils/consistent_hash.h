@@ -0,0 +1,46 @@
+#ifndef GARA_UTILS_CONSISTENT_HASH_H
+#define GARA_UTILS_CONSISTENT_HASH_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace gara {
+namespace utils {
+
+/**
+ * @brief Consistent hash ring mapping keys to members
+ *
+ * Each member is placed at virtual_nodes points on a 64-bit ring and a key
+ * belongs to the first point at or after its hash. Adding or removing one
+ * member moves only the keys on that member's arcs (about 1/N of them).
+ *
+ * The hash is FNV-1a with a final mix rather than std::hash, so every node
+ * in a cluster (and every build) agrees on who owns a key.
+ */
+class ConsistentHashRing {
+public:
+    explicit ConsistentHashRing(int virtual_nodes = 160);
+
+    // Replace the membership; order and duplicates do not matter
+    void setMembers(std::vector<std::string> members);
+
+    // Member owning key, or "" when the ring is empty
+    const std::string& ownerOf(std::string_view key) const;
+
+    const std::vector<std::string>& members() const { return members_; }
+
+    static uint64_t hash(std::string_view data);
+
+private:
+    int virtual_nodes_;
+    std::vector<std::string> members_;              // Sorted, unique
+    std::vector<std::pair<uint64_t, size_t>> ring_;  // (point, member index), sorted by point
+};
+
+} // namespace utils
+} // namespace gara
+
+#endif // GARA_UTILS_CONSISTENT_HASH_H
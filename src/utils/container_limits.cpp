@@ -0,0 +1,188 @@
+#include "container_limits.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <sched.h>
+
+namespace gara {
+namespace utils {
+
+namespace {
+
+namespace fs = std::filesystem;
+
+// cgroup v1 reports "no limit" as a huge page-aligned value near INT64_MAX
+constexpr uint64_t UNLIMITED_MEMORY_BYTES = 1ULL << 62;
+
+// Default CFS period when a file leaves it out
+constexpr double DEFAULT_CFS_PERIOD_US = 100000.0;
+
+// Trimmed file content, "" if unreadable
+std::string readFile(const fs::path& path) {
+    std::ifstream file(path);
+    if (!file) {
+        return "";
+    }
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    std::string content = buffer.str();
+    while (!content.empty() && std::isspace(static_cast<unsigned char>(content.back()))) {
+        content.pop_back();
+    }
+    return content;
+}
+
+// The process's cgroup directory and its ancestors up to the mount point, innermost first.
+// Under a cgroup namespace the path is "/" and the mount point is the process's own cgroup
+std::vector<fs::path> cgroupChain(const fs::path& mount, const std::string& cgroup_path) {
+    std::vector<fs::path> chain;
+    fs::path relative = fs::path(cgroup_path).relative_path();
+    while (!relative.empty()) {
+        chain.push_back(mount / relative);
+        relative = relative.parent_path();
+    }
+    chain.push_back(mount);
+    return chain;
+}
+
+// Keep the tightest of the limits seen so far (0 = unlimited)
+template<typename T>
+void tighten(T& current, T limit) {
+    if (limit > 0 && (current == 0 || limit < current)) {
+        current = limit;
+    }
+}
+
+int affinityCpus() {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        return std::max(1, CPU_COUNT(&set));
+    }
+    return std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+}
+
+} // anonymous namespace
+
+int ContainerLimits::cpus() const {
+    if (cpu_quota <= 0.0) {
+        return host_cpus;
+    }
+    // Rounded down: one thread more than the quota is throttled every period
+    return std::clamp(static_cast<int>(std::floor(cpu_quota)), 1, host_cpus);
+}
+
+const ContainerLimits& ContainerLimits::current() {
+    static const ContainerLimits limits = detect("/sys/fs/cgroup", "/proc/self/cgroup", affinityCpus());
+    return limits;
+}
+
+ContainerLimits ContainerLimits::detect(const std::string& cgroup_root, const std::string& self_cgroup_file,
+                                        int host_cpus) {
+    ContainerLimits limits;
+    limits.host_cpus = std::max(1, host_cpus);
+    fs::path root(cgroup_root);
+
+    // Lines are "id:controllers:path"; the v2 hierarchy has no controllers
+    std::string unified_path = "/";
+    std::map<std::string, std::pair<std::string, std::string>> v1_groups;  // controller -> (mount dir, path)
+    std::ifstream self(self_cgroup_file);
+    std::string line;
+    while (std::getline(self, line)) {
+        size_t first = line.find(':');
+        size_t second = first == std::string::npos ? std::string::npos : line.find(':', first + 1);
+        if (second == std::string::npos) {
+            continue;
+        }
+        std::string controllers = line.substr(first + 1, second - first - 1);
+        std::string path = line.substr(second + 1);
+        if (controllers.empty()) {
+            unified_path = path;
+            continue;
+        }
+        std::stringstream names(controllers);
+        std::string name;
+        while (std::getline(names, name, ',')) {
+            v1_groups[name] = {controllers, path};
+        }
+    }
+
+    std::error_code ec;
+    if (fs::exists(root / "cgroup.controllers", ec)) {
+        limits.source = "cgroup2";
+        for (const auto& dir : cgroupChain(root, unified_path)) {
+            tighten(limits.cpu_quota, parseCpuMax(readFile(dir / "cpu.max")));
+            tighten(limits.memory_limit_bytes, parseMemoryLimit(readFile(dir / "memory.max")));
+        }
+        return limits;
+    }
+
+    // v1 mounts each controller on its own, e.g. cpu,cpuacct/ and memory/
+    auto v1_chain = [&](const std::string& controller) {
+        std::string mount_dir = controller;
+        std::string path = "/";
+        auto it = v1_groups.find(controller);
+        if (it != v1_groups.end()) {
+            mount_dir = it->second.first;
+            path = it->second.second;
+        }
+        fs::path mount = root / mount_dir;
+        if (!fs::exists(mount, ec)) {
+            mount = root / controller;
+        }
+        if (!fs::exists(mount, ec)) {
+            return std::vector<fs::path>();
+        }
+        limits.source = "cgroup1";
+        return cgroupChain(mount, path);
+    };
+
+    for (const auto& dir : v1_chain("cpu")) {
+        tighten(limits.cpu_quota, parseCfsQuota(readFile(dir / "cpu.cfs_quota_us"),
+                                                readFile(dir / "cpu.cfs_period_us")));
+    }
+    for (const auto& dir : v1_chain("memory")) {
+        tighten(limits.memory_limit_bytes, parseMemoryLimit(readFile(dir / "memory.limit_in_bytes")));
+    }
+    return limits;
+}
+
+double ContainerLimits::parseCpuMax(const std::string& content) {
+    std::istringstream fields(content);
+    std::string quota;
+    double period = DEFAULT_CFS_PERIOD_US;
+    fields >> quota >> period;
+    if (quota.empty() || quota == "max" || period <= 0.0) {
+        return 0.0;
+    }
+    double quota_us = std::atof(quota.c_str());
+    return quota_us > 0.0 ? quota_us / period : 0.0;
+}
+
+double ContainerLimits::parseCfsQuota(const std::string& quota, const std::string& period) {
+    double quota_us = std::atof(quota.c_str());
+    double period_us = period.empty() ? DEFAULT_CFS_PERIOD_US : std::atof(period.c_str());
+    if (quota_us <= 0.0 || period_us <= 0.0) {
+        return 0.0;  // -1 means no quota
+    }
+    return quota_us / period_us;
+}
+
+uint64_t ContainerLimits::parseMemoryLimit(const std::string& content) {
+    if (content.empty() || content == "max") {
+        return 0;
+    }
+    uint64_t bytes = std::strtoull(content.c_str(), nullptr, 10);
+    return bytes >= UNLIMITED_MEMORY_BYTES ? 0 : bytes;
+}
+
+} // namespace utils
+} // namespace gara
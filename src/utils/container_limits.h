@@ -0,0 +1,54 @@
+#ifndef GARA_UTILS_CONTAINER_LIMITS_H
+#define GARA_UTILS_CONTAINER_LIMITS_H
+
+#include <cstdint>
+#include <string>
+
+namespace gara {
+namespace utils {
+
+/**
+ * @brief CPU and memory this process may actually use
+ *
+ * std::thread::hardware_concurrency() reports the host's cores, so a
+ * container with a 2-CPU quota on a 64-core host would size every pool for 64
+ * and spend its time throttled. Limits are read from the cgroup the process
+ * belongs to (v2 cpu.max and memory.max, or v1 cpu.cfs_quota_us and
+ * memory.limit_in_bytes), taking the tightest limit of the cgroup and its
+ * ancestors, and capped by the CPU affinity mask.
+ */
+struct ContainerLimits {
+    int host_cpus = 1;                // CPUs in the affinity mask
+    double cpu_quota = 0.0;           // CPUs' worth of time per period (0 = unlimited)
+    uint64_t memory_limit_bytes = 0;  // 0 = unlimited
+    std::string source = "host";      // "cgroup2", "cgroup1" or "host"
+
+    // Whole CPUs to size thread pools for: the quota rounded down (at least 1), at most host_cpus
+    int cpus() const;
+
+    // Limits of this process, detected on first use
+    static const ContainerLimits& current();
+
+    /**
+     * @brief Read the limits of the cgroup named in self_cgroup_file
+     * @param cgroup_root Mount point of the cgroup filesystem (/sys/fs/cgroup)
+     * @param self_cgroup_file The process's memberships (/proc/self/cgroup)
+     * @param host_cpus CPUs the process may run on
+     */
+    static ContainerLimits detect(const std::string& cgroup_root, const std::string& self_cgroup_file,
+                                  int host_cpus);
+
+    // cgroup v2 cpu.max ("max 100000" or "200000 100000"); 0 when unlimited
+    static double parseCpuMax(const std::string& content);
+
+    // cgroup v1 cpu.cfs_quota_us and cpu.cfs_period_us; 0 when unlimited
+    static double parseCfsQuota(const std::string& quota, const std::string& period);
+
+    // cgroup v2 memory.max or v1 memory.limit_in_bytes; 0 when unlimited
+    static uint64_t parseMemoryLimit(const std::string& content);
+};
+
+} // namespace utils
+} // namespace gara
+
+#endif // GARA_UTILS_CONTAINER_LIMITS_H
@@ -0,0 +1,45 @@
+#include "etag.h"
+#include <sstream>
+
+namespace gara {
+namespace utils {
+
+namespace {
+
+std::string opaqueTag(const std::string& tag) {
+    size_t begin = tag.find_first_not_of(" \t");
+    if (begin == std::string::npos) {
+        return "";
+    }
+    size_t end = tag.find_last_not_of(" \t");
+    std::string trimmed = tag.substr(begin, end - begin + 1);
+    return trimmed.rfind("W/", 0) == 0 ? trimmed.substr(2) : trimmed;
+}
+
+} // anonymous namespace
+
+std::string ETag::fromStorageKey(const std::string& key) {
+    size_t name_start = key.find_last_of('/');
+    std::string name = name_start == std::string::npos ? key : key.substr(name_start + 1);
+    size_t dot = name.find_last_of('.');
+    if (dot != std::string::npos && dot > 0) {
+        name = name.substr(0, dot);
+    }
+    return "\"" + name + "\"";
+}
+
+bool ETag::matches(const std::string& header, const std::string& etag) {
+    std::string target = opaqueTag(etag);
+    std::istringstream list(header);
+    std::string candidate;
+    while (std::getline(list, candidate, ',')) {
+        std::string value = opaqueTag(candidate);
+        if (value == "*" || value == target) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace utils
+} // namespace gara
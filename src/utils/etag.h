@@ -0,0 +1,33 @@
+#ifndef GARA_UTILS_ETAG_H
+#define GARA_UTILS_ETAG_H
+
+#include <string>
+
+namespace gara {
+namespace utils {
+
+/**
+ * @brief Entity tags for content-addressed storage keys
+ *
+ * Raw and transformed keys embed the image's SHA-256 and the rendition
+ * parameters, so the key alone identifies the bytes and no hashing is needed.
+ */
+class ETag {
+public:
+    /**
+     * @brief Strong tag from a key's file name ("transformed/abc_webp_0x0.webp" -> "abc_webp_0x0")
+     */
+    static std::string fromStorageKey(const std::string& key);
+
+    /**
+     * @brief True if an If-None-Match / If-Range value lists etag (or "*")
+     *
+     * Uses weak comparison, so W/ prefixes are ignored on both sides.
+     */
+    static bool matches(const std::string& header, const std::string& etag);
+};
+
+} // namespace utils
+} // namespace gara
+
+#endif // GARA_UTILS_ETAG_H
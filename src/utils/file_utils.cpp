@@ -9,6 +9,7 @@
 #include <sys/stat.h>
 #include <unistd.h>
 #include <cstdlib>
+#include <cstring>
 
 namespace gara {
 namespace utils {
@@ -203,11 +204,76 @@ std::string FileUtils::getMimeType(const std::string& extension) {
     if (lower_ext == "bmp") return "image/bmp";
     if (lower_ext == "tiff" || lower_ext == "tif") return "image/tiff";
     if (lower_ext == "webp") return "image/webp";
+    if (lower_ext == "avif") return "image/avif";
     if (lower_ext == "svg") return "image/svg+xml";
 
     return "application/octet-stream";
 }
 
+std::string FileUtils::detectImageFormat(const char* data, size_t size) {
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+
+    if (size >= 3 && bytes[0] == 0xFF && bytes[1] == 0xD8 && bytes[2] == 0xFF) {
+        return "jpg";
+    }
+    if (size >= 8 && std::memcmp(bytes, "\x89PNG\r\n\x1a\n", 8) == 0) {
+        return "png";
+    }
+    if (size >= 6 && (std::memcmp(bytes, "GIF87a", 6) == 0 || std::memcmp(bytes, "GIF89a", 6) == 0)) {
+        return "gif";
+    }
+    if (size >= 12 && std::memcmp(bytes, "RIFF", 4) == 0 && std::memcmp(bytes + 8, "WEBP", 4) == 0) {
+        return "webp";
+    }
+    if (size >= 4 && (std::memcmp(bytes, "II*\0", 4) == 0 || std::memcmp(bytes, "MM\0*", 4) == 0)) {
+        return "tiff";
+    }
+    if (size >= 2 && bytes[0] == 'B' && bytes[1] == 'M') {
+        return "bmp";
+    }
+
+    return "";
+}
+
+// Sha256Hasher implementation
+Sha256Hasher::Sha256Hasher()
+    : ctx_(EVP_MD_CTX_new()), ok_(false) {
+    ok_ = ctx_ && EVP_DigestInit_ex(ctx_, EVP_sha256(), nullptr) == 1;
+}
+
+Sha256Hasher::~Sha256Hasher() {
+    if (ctx_) {
+        EVP_MD_CTX_free(ctx_);
+    }
+}
+
+bool Sha256Hasher::update(const char* data, size_t size) {
+    if (ok_ && EVP_DigestUpdate(ctx_, data, size) != 1) {
+        ok_ = false;
+    }
+    return ok_;
+}
+
+std::string Sha256Hasher::finalizeHex() {
+    if (!ok_) {
+        return "";
+    }
+    ok_ = false;
+
+    unsigned char hash[EVP_MAX_MD_SIZE];
+    unsigned int hash_len = 0;
+    if (EVP_DigestFinal_ex(ctx_, hash, &hash_len) != 1) {
+        return "";
+    }
+
+    std::ostringstream oss;
+    for (unsigned int i = 0; i < hash_len; i++) {
+        oss << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(hash[i]);
+    }
+
+    return oss.str();
+}
+
 // TempFile implementation
 TempFile::TempFile(const std::string& prefix)
     : filepath_(FileUtils::createTempFile(prefix)) {
@@ -4,6 +4,9 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <cstddef>
+
+struct evp_md_ctx_st;
 
 namespace gara {
 namespace utils {
@@ -42,6 +45,31 @@ public:
 
     // Get MIME type from extension
     static std::string getMimeType(const std::string& extension);
+
+    // Detect image format from leading magic bytes
+    // Returns canonical extension (jpg, png, gif, webp, tiff, bmp) or empty string
+    static std::string detectImageFormat(const char* data, size_t size);
+};
+
+// Incremental SHA256 for data that arrives in chunks
+class Sha256Hasher {
+public:
+    Sha256Hasher();
+    ~Sha256Hasher();
+
+    // Disable copy
+    Sha256Hasher(const Sha256Hasher&) = delete;
+    Sha256Hasher& operator=(const Sha256Hasher&) = delete;
+
+    // Feed the next chunk; returns false on digest failure
+    bool update(const char* data, size_t size);
+
+    // Finish and return lowercase hex digest (empty on failure)
+    std::string finalizeHex();
+
+private:
+    evp_md_ctx_st* ctx_;
+    bool ok_;
 };
 
 // RAII wrapper for temporary files
@@ -61,6 +89,9 @@ public:
     std::string getPath() const { return filepath_; }
     bool write(const std::vector<char>& data);
 
+    // Give up ownership (e.g. after the file was moved into storage)
+    void release() { filepath_.clear(); }
+
 private:
     std::string filepath_;
 };
@@ -0,0 +1,61 @@
+#include "format_negotiation.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <sstream>
+
+namespace gara {
+namespace utils {
+
+namespace {
+
+std::string trimLower(const std::string& value) {
+    size_t begin = value.find_first_not_of(" \t");
+    if (begin == std::string::npos) {
+        return "";
+    }
+    size_t end = value.find_last_not_of(" \t");
+    std::string trimmed = value.substr(begin, end - begin + 1);
+    std::transform(trimmed.begin(), trimmed.end(), trimmed.begin(), ::tolower);
+    return trimmed;
+}
+
+// True if the header lists media_type with a non-zero q value
+bool accepts(const std::string& accept, const std::string& media_type) {
+    std::istringstream ranges(accept);
+    std::string range;
+    while (std::getline(ranges, range, ',')) {
+        std::istringstream parts(range);
+        std::string type;
+        std::getline(parts, type, ';');
+        if (trimLower(type) != media_type) {
+            continue;
+        }
+
+        double quality = 1.0;
+        std::string param;
+        while (std::getline(parts, param, ';')) {
+            std::string clean = trimLower(param);
+            if (clean.rfind("q=", 0) == 0) {
+                quality = std::atof(clean.c_str() + 2);
+            }
+        }
+        return quality > 0.0;
+    }
+    return false;
+}
+
+} // anonymous namespace
+
+std::string FormatNegotiation::negotiate(const std::string& accept) {
+    if (accepts(accept, "image/avif")) {
+        return "avif";
+    }
+    if (accepts(accept, "image/webp")) {
+        return "webp";
+    }
+    return "jpeg";
+}
+
+} // namespace utils
+} // namespace gara
@@ -0,0 +1,29 @@
+#ifndef GARA_UTILS_FORMAT_NEGOTIATION_H
+#define GARA_UTILS_FORMAT_NEGOTIATION_H
+
+#include <string>
+
+namespace gara {
+namespace utils {
+
+/**
+ * @brief Picks an output format for format=auto from the Accept header
+ *
+ * Preference is AVIF, then WebP, then JPEG. Only explicit image/avif and
+ * image/webp entries count: browsers send image and type wildcards even
+ * when they cannot decode the newer formats.
+ */
+class FormatNegotiation {
+public:
+    static constexpr const char* AUTO_FORMAT = "auto";
+
+    /**
+     * @brief Best supported format ("avif", "webp" or "jpeg") for an Accept value
+     */
+    static std::string negotiate(const std::string& accept);
+};
+
+} // namespace utils
+} // namespace gara
+
+#endif // GARA_UTILS_FORMAT_NEGOTIATION_H
@@ -0,0 +1,98 @@
+#include "http_range.h"
+#include <cctype>
+
+namespace gara {
+namespace utils {
+
+namespace {
+
+constexpr const char* BYTES_UNIT = "bytes=";
+
+std::string trim(const std::string& value) {
+    size_t begin = value.find_first_not_of(" \t");
+    if (begin == std::string::npos) {
+        return "";
+    }
+    size_t end = value.find_last_not_of(" \t");
+    return value.substr(begin, end - begin + 1);
+}
+
+// Digits only; stoull would accept signs and leading whitespace
+bool parseNumber(const std::string& text, uint64_t& value) {
+    if (text.empty() || text.size() > 19) {
+        return false;
+    }
+    value = 0;
+    for (char c : text) {
+        if (!std::isdigit(static_cast<unsigned char>(c))) {
+            return false;
+        }
+        value = value * 10 + static_cast<uint64_t>(c - '0');
+    }
+    return true;
+}
+
+} // anonymous namespace
+
+RangeStatus HttpRange::parse(const std::string& header, uint64_t size, ByteRange& range) {
+    std::string spec = trim(header);
+    if (spec.compare(0, 6, BYTES_UNIT) != 0) {
+        return RangeStatus::FULL;
+    }
+    spec = trim(spec.substr(6));
+    if (spec.find(',') != std::string::npos) {
+        return RangeStatus::FULL;
+    }
+
+    size_t dash = spec.find('-');
+    if (dash == std::string::npos) {
+        return RangeStatus::FULL;
+    }
+    std::string first_text = trim(spec.substr(0, dash));
+    std::string last_text = trim(spec.substr(dash + 1));
+
+    if (first_text.empty()) {
+        // Suffix range: the final N bytes
+        uint64_t suffix = 0;
+        if (!parseNumber(last_text, suffix)) {
+            return RangeStatus::FULL;
+        }
+        if (suffix == 0 || size == 0) {
+            return RangeStatus::UNSATISFIABLE;
+        }
+        range.first = suffix >= size ? 0 : size - suffix;
+        range.last = size - 1;
+        return RangeStatus::PARTIAL;
+    }
+
+    uint64_t first = 0;
+    if (!parseNumber(first_text, first)) {
+        return RangeStatus::FULL;
+    }
+
+    uint64_t last = size == 0 ? 0 : size - 1;
+    if (!last_text.empty()) {
+        if (!parseNumber(last_text, last) || last < first) {
+            return RangeStatus::FULL;
+        }
+    }
+
+    if (first >= size) {
+        return RangeStatus::UNSATISFIABLE;
+    }
+    range.first = first;
+    range.last = last >= size ? size - 1 : last;
+    return RangeStatus::PARTIAL;
+}
+
+std::string HttpRange::contentRange(const ByteRange& range, uint64_t size) {
+    return "bytes " + std::to_string(range.first) + "-" + std::to_string(range.last) +
+           "/" + std::to_string(size);
+}
+
+std::string HttpRange::unsatisfiedRange(uint64_t size) {
+    return "bytes */" + std::to_string(size);
+}
+
+} // namespace utils
+} // namespace gara
@@ -0,0 +1,48 @@
+#ifndef GARA_UTILS_HTTP_RANGE_H
+#define GARA_UTILS_HTTP_RANGE_H
+
+#include <cstdint>
+#include <string>
+
+namespace gara {
+namespace utils {
+
+/**
+ * @brief Byte range resolved against an object size (inclusive bounds)
+ */
+struct ByteRange {
+    uint64_t first = 0;
+    uint64_t last = 0;
+
+    uint64_t length() const { return last - first + 1; }
+};
+
+enum class RangeStatus {
+    FULL,           // No usable Range header: send the whole object
+    PARTIAL,        // Send 206 with the resolved range
+    UNSATISFIABLE   // Send 416
+};
+
+/**
+ * @brief Parses single-range "Range: bytes=..." headers (RFC 9110 section 14)
+ *
+ * Multi-range and malformed headers resolve to FULL, which the RFC allows
+ * a server to do by ignoring the header.
+ */
+class HttpRange {
+public:
+    static RangeStatus parse(const std::string& header, uint64_t size, ByteRange& range);
+
+    /**
+     * @brief Content-Range value for a partial response ("bytes 0-99/1000")
+     */
+    static std::string contentRange(const ByteRange& range, uint64_t size);
+
+    // Content-Range value for a 416 response: "bytes */<size>"
+    static std::string unsatisfiedRange(uint64_t size);
+};
+
+} // namespace utils
+} // namespace gara
+
+#endif // GARA_UTILS_HTTP_RANGE_H
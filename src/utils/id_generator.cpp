@@ -1,31 +1,80 @@
 #include "id_generator.h"
+#include <charconv>
+#include <chrono>
+#include <cstdint>
 #include <random>
-#include <sstream>
-#include <iomanip>
-#include <ctime>
 
 namespace gara {
 namespace utils {
 
+namespace {
+
+constexpr uint64_t COUNTER_BITS = 12;
+constexpr uint64_t COUNTER_MASK = (1ULL << COUNTER_BITS) - 1;
+
+struct ThreadState {
+    std::mt19937_64 engine{std::random_device{}()};
+    uint64_t last_ms = 0;
+    uint64_t counter = 0;
+};
+
+ThreadState& threadState() {
+    thread_local ThreadState state;
+    return state;
+}
+
+char* writeHex(char* out, uint64_t value, int digits) {
+    static const char hex[] = "0123456789abcdef";
+    for (int i = digits - 1; i >= 0; --i) {
+        out[i] = hex[value & 0x0F];
+        value >>= 4;
+    }
+    return out + digits;
+}
+
+} // anonymous namespace
+
 std::string IdGenerator::generateAlbumId() {
-    // Generate UUID-like ID with timestamp prefix for sorting
-    std::random_device rd;
-    std::mt19937_64 gen(rd());
-    std::uniform_int_distribution<uint64_t> dis;
-
-    std::time_t now = std::time(nullptr);
-    std::ostringstream oss;
-    oss << now << "_";
-
-    // Generate simple UUID (8-4-4-4-12 hex format)
-    oss << std::hex << std::setfill('0');
-    oss << std::setw(8) << (dis(gen) & 0xFFFFFFFF) << "-";
-    oss << std::setw(4) << (dis(gen) & 0xFFFF) << "-";
-    oss << std::setw(4) << ((dis(gen) & 0x0FFF) | 0x4000) << "-";
-    oss << std::setw(4) << ((dis(gen) & 0x3FFF) | 0x8000) << "-";
-    oss << std::setw(12) << (dis(gen) & 0xFFFFFFFFFFFF);
-
-    return oss.str();
+    return generate();
+}
+
+std::string IdGenerator::generateRequestId() {
+    return generate();
+}
+
+std::string IdGenerator::generate() {
+    ThreadState& state = threadState();
+
+    uint64_t now_ms = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+    if (now_ms > state.last_ms) {
+        state.last_ms = now_ms;
+        // Start each millisecond at a random point in the lower half so ordering survives bursts
+        state.counter = state.engine() & (COUNTER_MASK >> 1);
+    } else if (++state.counter > COUNTER_MASK) {
+        // Counter exhausted (or the clock stepped back): borrow the next millisecond
+        ++state.last_ms;
+        state.counter = 0;
+    }
+
+    uint64_t ms = state.last_ms;
+    uint64_t random = state.engine();
+
+    // "{seconds}_" + 36-char UUID
+    char buffer[24 + 36];
+    char* out = std::to_chars(buffer, buffer + 24, ms / 1000).ptr;
+    *out++ = '_';
+    out = writeHex(out, ms >> 16, 8);
+    *out++ = '-';
+    out = writeHex(out, ms & 0xFFFF, 4);
+    *out++ = '-';
+    out = writeHex(out, 0x4000 | state.counter, 4);
+    *out++ = '-';
+    out = writeHex(out, 0x8000 | ((random >> 48) & 0x3FFF), 4);
+    *out++ = '-';
+    out = writeHex(out, random & 0xFFFFFFFFFFFFULL, 12);
+
+    return std::string(buffer, out);
 }
 
 } // namespace utils
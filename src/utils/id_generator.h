@@ -8,6 +8,16 @@ namespace utils {
 
 /**
  * @brief Utility class for generating unique identifiers
+ *
+ * IDs look like {unix_seconds}_{8-4-4-4-12 hex}. The hex part is laid out
+ * like a UUIDv7: 48 bits of Unix milliseconds, then a per-thread counter
+ * for IDs minted in the same millisecond, then random bits. It keeps the
+ * version-4 and RFC 4122 variant nibbles so it still parses like the IDs
+ * already stored. IDs from one thread sort in creation order; across
+ * threads they sort to the millisecond.
+ *
+ * Each thread seeds its own PRNG once, so minting an ID makes no system
+ * call and takes no lock.
  */
 class IdGenerator {
 public:
@@ -20,6 +30,14 @@ public:
      * @return Unique album ID string
      */
     static std::string generateAlbumId();
+
+    /**
+     * @brief Generate a request correlation ID (same format as album IDs)
+     */
+    static std::string generateRequestId();
+
+private:
+    static std::string generate();
 };
 
 } // namespace utils
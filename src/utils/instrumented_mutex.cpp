@@ -0,0 +1,104 @@
+#include "instrumented_mutex.h"
+#include <map>
+#include <memory>
+
+namespace gara {
+namespace utils {
+
+namespace {
+
+// Waits run from an uncontended handoff (~1us) to a stalled writer
+const std::vector<double> LOCK_BUCKETS = {
+    0.000001, 0.00001, 0.0001, 0.001, 0.01, 0.1, 1.0
+};
+
+thread_local unsigned hold_sample_tick = 0;
+
+} // anonymous namespace
+
+InstrumentedMutex::Series& InstrumentedMutex::seriesFor(const std::string& name) {
+    static std::mutex mutex;
+    static std::map<std::string, std::unique_ptr<Series>> series;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& entry = series[name];
+    if (!entry) {
+        auto& registry = PrometheusRegistry::instance();
+        PrometheusRegistry::Labels labels = {{"lock", name}};
+        entry.reset(new Series{
+            registry.counter("gara_lock_acquisitions_total", "Lock acquisitions", labels),
+            registry.counter("gara_lock_contended_total", "Lock acquisitions that had to wait", labels),
+            registry.histogram("gara_lock_wait_seconds", "Time spent waiting for a contended lock",
+                               LOCK_BUCKETS, labels),
+            registry.histogram("gara_lock_hold_seconds", "Time a lock is held (sampled)",
+                               LOCK_BUCKETS, labels)
+        });
+    }
+    return *entry;
+}
+
+#ifndef GARA_DISABLE_METRICS
+
+InstrumentedMutex::InstrumentedMutex(const std::string& name) : series_(seriesFor(name)) {}
+
+void InstrumentedMutex::lock() {
+    if (mutex_.try_lock()) {
+        acquired(false, {});
+        return;
+    }
+    auto wait_started = std::chrono::steady_clock::now();
+    mutex_.lock();
+    acquired(true, wait_started);
+}
+
+bool InstrumentedMutex::try_lock() {
+    if (!mutex_.try_lock()) {
+        return false;
+    }
+    acquired(false, {});
+    return true;
+}
+
+void InstrumentedMutex::unlock() {
+    if (timing_hold_) {
+        timing_hold_ = false;
+        series_.hold.observe(std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - acquired_at_).count());
+    }
+    mutex_.unlock();
+}
+
+void InstrumentedMutex::acquired(bool contended, std::chrono::steady_clock::time_point wait_started) {
+    series_.acquisitions.inc();
+    bool sample_hold = ++hold_sample_tick % HOLD_SAMPLE_EVERY == 0;
+    if (!contended && !sample_hold) {
+        return;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    if (contended) {
+        series_.contended.inc();
+        series_.wait.observe(std::chrono::duration<double>(now - wait_started).count());
+    }
+    if (sample_hold) {
+        timing_hold_ = true;
+        acquired_at_ = now;
+    }
+}
+
+#else
+
+InstrumentedMutex::InstrumentedMutex(const std::string&) {}
+
+void InstrumentedMutex::lock() { mutex_.lock(); }
+
+bool InstrumentedMutex::try_lock() { return mutex_.try_lock(); }
+
+void InstrumentedMutex::unlock() { mutex_.unlock(); }
+
+void InstrumentedMutex::acquired(bool, std::chrono::steady_clock::time_point) {}
+
+#endif
+
+} // namespace utils
+} // namespace gara
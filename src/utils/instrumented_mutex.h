@@ -0,0 +1,63 @@
+#ifndef GARA_UTILS_INSTRUMENTED_MUTEX_H
+#define GARA_UTILS_INSTRUMENTED_MUTEX_H
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include "prometheus_registry.h"
+
+namespace gara {
+namespace utils {
+
+/**
+ * @brief std::mutex that reports how contended it is
+ *
+ * Drop-in for std::mutex (Lockable; pair with std::condition_variable_any).
+ * Every mutex sharing a name feeds the same Prometheus series:
+ * gara_lock_acquisitions_total, gara_lock_contended_total,
+ * gara_lock_wait_seconds and gara_lock_hold_seconds, all labelled lock=<name>.
+ *
+ * Kept cheap enough to leave on: an uncontended lock is a try_lock and one
+ * atomic counter update. Wait time is measured only when the try_lock
+ * fails. Hold time is timed on one acquisition in HOLD_SAMPLE_EVERY per
+ * thread. Compiled down to a bare std::mutex with GARA_DISABLE_METRICS.
+ */
+class InstrumentedMutex {
+public:
+    static constexpr unsigned HOLD_SAMPLE_EVERY = 16;
+
+    explicit InstrumentedMutex(const std::string& name);
+
+    InstrumentedMutex(const InstrumentedMutex&) = delete;
+    InstrumentedMutex& operator=(const InstrumentedMutex&) = delete;
+
+    void lock();
+    bool try_lock();
+    void unlock();
+
+private:
+    struct Series {
+        PrometheusRegistry::Counter& acquisitions;
+        PrometheusRegistry::Counter& contended;
+        PrometheusRegistry::Histogram& wait;
+        PrometheusRegistry::Histogram& hold;
+    };
+
+    // One Series per lock name, created on first use
+    static Series& seriesFor(const std::string& name);
+
+    void acquired(bool contended, std::chrono::steady_clock::time_point wait_started);
+
+    std::mutex mutex_;
+#ifndef GARA_DISABLE_METRICS
+    Series& series_;
+    // Written and read only by the holder
+    bool timing_hold_ = false;
+    std::chrono::steady_clock::time_point acquired_at_;
+#endif
+};
+
+} // namespace utils
+} // namespace gara
+
+#endif // GARA_UTILS_INSTRUMENTED_MUTEX_H
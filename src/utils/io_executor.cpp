@@ -0,0 +1,79 @@
+#include "io_executor.h"
+#include <algorithm>
+#include <cstdlib>
+
+namespace gara {
+namespace utils {
+
+namespace {
+constexpr int DEFAULT_IO_THREADS = 16;
+}
+
+IoExecutor::IoExecutor(size_t thread_count) {
+    thread_count = std::max<size_t>(thread_count, 1);
+    workers_.reserve(thread_count);
+    for (size_t i = 0; i < thread_count; ++i) {
+        workers_.emplace_back(&IoExecutor::workerLoop, this);
+    }
+}
+
+IoExecutor::~IoExecutor() {
+    shutdown();
+}
+
+IoExecutor& IoExecutor::shared() {
+    static IoExecutor executor([]() {
+        const char* threads_env = std::getenv("STORAGE_IO_THREADS");
+        int threads = threads_env ? std::atoi(threads_env) : DEFAULT_IO_THREADS;
+        return static_cast<size_t>(std::clamp(threads, 1, 256));
+    }());
+    return executor;
+}
+
+bool IoExecutor::post(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_) {
+            return false;
+        }
+        tasks_.push_back(std::move(task));
+    }
+    cv_.notify_one();
+    return true;
+}
+
+void IoExecutor::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_) {
+            return;
+        }
+        stopping_ = true;
+    }
+    cv_.notify_all();
+
+    for (auto& worker : workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+void IoExecutor::workerLoop() {
+    for (;;) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this]() { return stopping_ || !tasks_.empty(); });
+            if (tasks_.empty()) {
+                return;  // Stopping and drained
+            }
+            task = std::move(tasks_.front());
+            tasks_.pop_front();
+        }
+        task();
+    }
+}
+
+} // namespace utils
+} // namespace gara
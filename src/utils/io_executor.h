@@ -0,0 +1,74 @@
+#ifndef GARA_UTILS_IO_EXECUTOR_H
+#define GARA_UTILS_IO_EXECUTOR_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace gara {
+namespace utils {
+
+/**
+ * @brief Fixed thread pool for blocking storage I/O
+ *
+ * Backs the default asynchronous FileServiceInterface methods so callers can
+ * overlap several storage calls (or storage with CPU work) without pinning
+ * one thread per call. Tasks run in submission order.
+ *
+ * Tasks must not block waiting on other tasks of the same pool.
+ */
+class IoExecutor {
+public:
+    explicit IoExecutor(size_t thread_count);
+    ~IoExecutor();
+
+    IoExecutor(const IoExecutor&) = delete;
+    IoExecutor& operator=(const IoExecutor&) = delete;
+
+    /**
+     * @brief Process-wide pool sized by STORAGE_IO_THREADS (default 16)
+     */
+    static IoExecutor& shared();
+
+    /**
+     * @brief Run fn on the pool; exceptions are delivered through the future
+     *
+     * After shutdown() the task runs inline on the caller's thread.
+     */
+    template<typename Fn>
+    std::future<std::invoke_result_t<Fn>> submit(Fn fn) {
+        using Result = std::invoke_result_t<Fn>;
+        auto task = std::make_shared<std::packaged_task<Result()>>(std::move(fn));
+        std::future<Result> result = task->get_future();
+        if (!post([task]() { (*task)(); })) {
+            (*task)();
+        }
+        return result;
+    }
+
+    // Finish queued tasks and join the workers
+    void shutdown();
+
+    size_t threadCount() const { return workers_.size(); }
+
+private:
+    bool post(std::function<void()> task);
+    void workerLoop();
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<std::function<void()>> tasks_;
+    bool stopping_ = false;
+    std::vector<std::thread> workers_;
+};
+
+} // namespace utils
+} // namespace gara
+
+#endif // GARA_UTILS_IO_EXECUTOR_H
@@ -0,0 +1,165 @@
+#include "json_writer.h"
+#include <charconv>
+
+namespace gara {
+namespace utils {
+
+namespace {
+
+constexpr char HEX_DIGITS[] = "0123456789abcdef";
+constexpr std::string_view REPLACEMENT_CHARACTER = "\xEF\xBF\xBD";
+
+// Length of the well-formed UTF-8 sequence starting at text[i], or 0 if it is not
+size_t utf8SequenceLength(std::string_view text, size_t i) {
+    auto byte = [&](size_t offset) { return static_cast<unsigned char>(text[i + offset]); };
+    auto continuation = [&](size_t offset, unsigned char low = 0x80, unsigned char high = 0xBF) {
+        return i + offset < text.size() && byte(offset) >= low && byte(offset) <= high;
+    };
+
+    unsigned char lead = byte(0);
+    if (lead >= 0xC2 && lead <= 0xDF) {
+        return continuation(1) ? 2 : 0;
+    }
+    if (lead >= 0xE0 && lead <= 0xEF) {
+        // Reject overlong forms (E0) and UTF-16 surrogates (ED)
+        unsigned char low = lead == 0xE0 ? 0xA0 : 0x80;
+        unsigned char high = lead == 0xED ? 0x9F : 0xBF;
+        return continuation(1, low, high) && continuation(2) ? 3 : 0;
+    }
+    if (lead >= 0xF0 && lead <= 0xF4) {
+        // Reject overlong forms (F0) and code points past U+10FFFF (F4)
+        unsigned char low = lead == 0xF0 ? 0x90 : 0x80;
+        unsigned char high = lead == 0xF4 ? 0x8F : 0xBF;
+        return continuation(1, low, high) && continuation(2) && continuation(3) ? 4 : 0;
+    }
+    return 0;
+}
+
+} // anonymous namespace
+
+void JsonWriter::separate() {
+    if (after_key_) {
+        after_key_ = false;
+    } else if (!first_) {
+        out_ += ',';
+    }
+    first_ = false;
+}
+
+void JsonWriter::beginObject() {
+    separate();
+    out_ += '{';
+    first_ = true;
+}
+
+void JsonWriter::endObject() {
+    out_ += '}';
+    first_ = false;
+}
+
+void JsonWriter::beginArray() {
+    separate();
+    out_ += '[';
+    first_ = true;
+}
+
+void JsonWriter::endArray() {
+    out_ += ']';
+    first_ = false;
+}
+
+void JsonWriter::key(std::string_view name) {
+    separate();
+    writeString(name);
+    out_ += ':';
+    after_key_ = true;
+}
+
+void JsonWriter::value(std::string_view text) {
+    separate();
+    writeString(text);
+}
+
+void JsonWriter::value(int64_t number) {
+    separate();
+    char buffer[24];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), number);
+    out_.append(buffer, result.ptr);
+}
+
+void JsonWriter::value(uint64_t number) {
+    separate();
+    char buffer[24];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), number);
+    out_.append(buffer, result.ptr);
+}
+
+void JsonWriter::value(bool flag) {
+    separate();
+    out_ += flag ? "true" : "false";
+}
+
+void JsonWriter::null() {
+    separate();
+    out_ += "null";
+}
+
+void JsonWriter::value(const std::vector<std::string>& strings) {
+    beginArray();
+    for (const auto& text : strings) {
+        value(std::string_view(text));
+    }
+    endArray();
+}
+
+void JsonWriter::writeString(std::string_view text) {
+    out_ += '"';
+
+    // Copy runs of plain characters in one append
+    size_t run_start = 0;
+    auto flush = [&](size_t end) {
+        out_.append(text.data() + run_start, end - run_start);
+    };
+
+    size_t i = 0;
+    while (i < text.size()) {
+        unsigned char c = static_cast<unsigned char>(text[i]);
+        if (c >= 0x20 && c != '"' && c != '\\' && c < 0x80) {
+            ++i;
+            continue;
+        }
+        if (c >= 0x80) {
+            size_t length = utf8SequenceLength(text, i);
+            if (length > 0) {
+                i += length;
+                continue;
+            }
+            flush(i);
+            out_ += REPLACEMENT_CHARACTER;
+            run_start = ++i;
+            continue;
+        }
+
+        flush(i);
+        switch (c) {
+            case '"': out_ += "\\\""; break;
+            case '\\': out_ += "\\\\"; break;
+            case '\b': out_ += "\\b"; break;
+            case '\f': out_ += "\\f"; break;
+            case '\n': out_ += "\\n"; break;
+            case '\r': out_ += "\\r"; break;
+            case '\t': out_ += "\\t"; break;
+            default: {
+                char escape[] = {'\\', 'u', '0', '0', HEX_DIGITS[c >> 4], HEX_DIGITS[c & 0x0F]};
+                out_.append(escape, sizeof(escape));
+            }
+        }
+        run_start = ++i;
+    }
+    flush(i);
+
+    out_ += '"';
+}
+
+} // namespace utils
+} // namespace gara
@@ -0,0 +1,64 @@
+#ifndef GARA_UTILS_JSON_WRITER_H
+#define GARA_UTILS_JSON_WRITER_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace gara {
+namespace utils {
+
+/**
+ * @brief Append-only JSON writer for large response bodies
+ *
+ * Writes straight into the caller's string instead of building a json DOM
+ * and dumping it, so a list page costs one growing buffer rather than a heap
+ * node per field. Output matches nlohmann::json::dump(): same escaping, and
+ * callers emit object keys in sorted order. Invalid UTF-8 is replaced with
+ * U+FFFD instead of throwing.
+ *
+ * The writer does not check structure; unbalanced begin/end calls produce
+ * invalid JSON.
+ */
+class JsonWriter {
+public:
+    explicit JsonWriter(std::string& out) : out_(out) {}
+
+    void beginObject();
+    void endObject();
+    void beginArray();
+    void endArray();
+
+    void key(std::string_view name);
+
+    void value(std::string_view text);
+    void value(const char* text) { value(std::string_view(text)); }
+    void value(int64_t number);
+    void value(uint64_t number);
+    void value(int number) { value(static_cast<int64_t>(number)); }
+    void value(bool flag);
+    void null();
+
+    void value(const std::vector<std::string>& strings);
+
+    // Shorthand for key() followed by value()
+    template <typename T>
+    void field(std::string_view name, const T& field_value) {
+        key(name);
+        value(field_value);
+    }
+
+private:
+    void separate();
+    void writeString(std::string_view text);
+
+    std::string& out_;
+    bool first_ = true;      // Nothing written yet in the current container
+    bool after_key_ = false; // A key was written and awaits its value
+};
+
+} // namespace utils
+} // namespace gara
+
+#endif // GARA_UTILS_JSON_WRITER_H
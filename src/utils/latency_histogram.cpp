@@ -0,0 +1,126 @@
+#include "latency_histogram.h"
+#include <algorithm>
+#include <cmath>
+
+namespace gara {
+namespace utils {
+
+namespace {
+constexpr int SUB_BUCKET_BITS = 11;                        // 2048 linear values before the first doubling
+constexpr uint64_t SUB_BUCKET_COUNT = 1ULL << SUB_BUCKET_BITS;
+constexpr uint64_t SUB_BUCKET_HALF = SUB_BUCKET_COUNT / 2;  // Sub-buckets per power of two above that
+
+int highestBit(uint64_t value) {
+    return 63 - __builtin_clzll(value);
+}
+}
+
+LatencyHistogram::LatencyHistogram(uint64_t highest_trackable_value)
+    : highest_trackable_(std::max<uint64_t>(highest_trackable_value, SUB_BUCKET_COUNT)),
+      counts_(indexFor(highest_trackable_) + 1, 0) {
+}
+
+size_t LatencyHistogram::indexFor(uint64_t value) {
+    if (value < SUB_BUCKET_COUNT) {
+        return static_cast<size_t>(value);
+    }
+    int exponent = highestBit(value);                   // >= SUB_BUCKET_BITS
+    int shift = exponent - (SUB_BUCKET_BITS - 1);
+    uint64_t sub_bucket = (value >> shift) - SUB_BUCKET_HALF;  // [0, SUB_BUCKET_HALF)
+    return static_cast<size_t>(SUB_BUCKET_COUNT + (exponent - SUB_BUCKET_BITS) * SUB_BUCKET_HALF + sub_bucket);
+}
+
+uint64_t LatencyHistogram::lowestEquivalent(size_t index) {
+    if (index < SUB_BUCKET_COUNT) {
+        return index;
+    }
+    uint64_t offset = index - SUB_BUCKET_COUNT;
+    int exponent = SUB_BUCKET_BITS + static_cast<int>(offset / SUB_BUCKET_HALF);
+    uint64_t sub_bucket = SUB_BUCKET_HALF + offset % SUB_BUCKET_HALF;
+    return sub_bucket << (exponent - (SUB_BUCKET_BITS - 1));
+}
+
+uint64_t LatencyHistogram::highestEquivalent(size_t index) {
+    if (index < SUB_BUCKET_COUNT) {
+        return index;
+    }
+    int exponent = SUB_BUCKET_BITS + static_cast<int>((index - SUB_BUCKET_COUNT) / SUB_BUCKET_HALF);
+    return lowestEquivalent(index) + (1ULL << (exponent - (SUB_BUCKET_BITS - 1))) - 1;
+}
+
+void LatencyHistogram::record(uint64_t value, uint64_t count) {
+    value = std::min(value, highest_trackable_);
+    counts_[indexFor(value)] += count;
+    total_count_ += count;
+    min_ = std::min(min_, value);
+    max_ = std::max(max_, value);
+    sum_ += static_cast<long double>(value) * count;
+}
+
+void LatencyHistogram::recordCorrected(uint64_t value, uint64_t expected_interval) {
+    record(value);
+    if (expected_interval == 0) {
+        return;
+    }
+    for (uint64_t missing = value > expected_interval ? value - expected_interval : 0;
+         missing >= expected_interval; missing -= expected_interval) {
+        record(missing);
+    }
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    if (other.total_count_ == 0) {
+        return;
+    }
+    for (size_t i = 0; i < other.counts_.size(); ++i) {
+        if (other.counts_[i] > 0) {
+            // Re-bucket so histograms with different maxima still merge
+            counts_[indexFor(std::min(lowestEquivalent(i), highest_trackable_))] += other.counts_[i];
+        }
+    }
+    total_count_ += other.total_count_;
+    min_ = std::min(min_, std::min(other.min_, highest_trackable_));
+    max_ = std::max(max_, std::min(other.max_, highest_trackable_));
+    sum_ += other.sum_;
+}
+
+void LatencyHistogram::reset() {
+    std::fill(counts_.begin(), counts_.end(), 0);
+    total_count_ = 0;
+    min_ = UINT64_MAX;
+    max_ = 0;
+    sum_ = 0;
+}
+
+uint64_t LatencyHistogram::min() const {
+    return total_count_ > 0 ? min_ : 0;
+}
+
+uint64_t LatencyHistogram::max() const {
+    return max_;
+}
+
+double LatencyHistogram::mean() const {
+    return total_count_ > 0 ? static_cast<double>(sum_ / total_count_) : 0.0;
+}
+
+uint64_t LatencyHistogram::percentile(double percentile) const {
+    if (total_count_ == 0) {
+        return 0;
+    }
+    percentile = std::clamp(percentile, 0.0, 100.0);
+    uint64_t target = std::max<uint64_t>(1, static_cast<uint64_t>(
+        std::ceil(percentile / 100.0 * static_cast<double>(total_count_))));
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < counts_.size(); ++i) {
+        seen += counts_[i];
+        if (seen >= target) {
+            return std::min(highestEquivalent(i), max_);
+        }
+    }
+    return max_;
+}
+
+} // namespace utils
+} // namespace gara
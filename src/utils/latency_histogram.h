@@ -0,0 +1,69 @@
+#ifndef GARA_UTILS_LATENCY_HISTOGRAM_H
+#define GARA_UTILS_LATENCY_HISTOGRAM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace gara {
+namespace utils {
+
+/**
+ * @brief HdrHistogram-style recorder for latency percentiles
+ *
+ * Values (typically microseconds) are counted in log-linear buckets: exact
+ * below 2048, then 1024 sub-buckets per power of two, so every percentile is
+ * within 0.1% of the true value (three significant digits) at any magnitude.
+ * Recording is O(1) with no allocation. Values above the trackable maximum
+ * are clamped to it.
+ *
+ * Not thread-safe; record into one histogram per thread and merge().
+ */
+class LatencyHistogram {
+public:
+    explicit LatencyHistogram(uint64_t highest_trackable_value = 3600ULL * 1000 * 1000);
+
+    void record(uint64_t value, uint64_t count = 1);
+
+    /**
+     * @brief Record a value, back-filling the samples a stalled closed loop missed
+     *
+     * With expected_interval > 0, a value of N intervals also records
+     * value - interval, value - 2*interval, ... down to the interval, the
+     * latencies requests would have seen had they been sent on schedule
+     * (coordinated omission correction).
+     */
+    void recordCorrected(uint64_t value, uint64_t expected_interval);
+
+    void merge(const LatencyHistogram& other);
+    void reset();
+
+    uint64_t count() const { return total_count_; }
+    uint64_t min() const;
+    uint64_t max() const;
+    double mean() const;
+
+    /**
+     * @brief Smallest recorded value at or above the given percentile (0-100)
+     *
+     * Reported as the highest value equivalent to its bucket, so p100 == max().
+     */
+    uint64_t percentile(double percentile) const;
+
+private:
+    static size_t indexFor(uint64_t value);
+    static uint64_t lowestEquivalent(size_t index);
+    static uint64_t highestEquivalent(size_t index);
+
+    uint64_t highest_trackable_;
+    std::vector<uint64_t> counts_;
+    uint64_t total_count_ = 0;
+    uint64_t min_ = UINT64_MAX;
+    uint64_t max_ = 0;
+    long double sum_ = 0;
+};
+
+} // namespace utils
+} // namespace gara
+
+#endif // GARA_UTILS_LATENCY_HISTOGRAM_H
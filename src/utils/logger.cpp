@@ -1,12 +1,48 @@
 #include "utils/logger.h"
 #include <spdlog/sinks/stdout_color_sinks.h>
 #include <spdlog/pattern_formatter.h>
+#include <spdlog/async.h>
+#include <algorithm>
+#include <cstdlib>
 #include <iomanip>
 #include <sstream>
 
 namespace gara {
 
+LoggerOptions LoggerOptions::fromEnvironment() {
+    LoggerOptions options;
+
+    const char* async_env = std::getenv("LOG_ASYNC");
+    if (async_env) {
+        options.async = std::string(async_env) == "true";
+    }
+
+    const char* queue_env = std::getenv("LOG_ASYNC_QUEUE_SIZE");
+    if (queue_env) {
+        options.async_queue_size = static_cast<size_t>(std::max(1, std::atoi(queue_env)));
+    }
+
+    const char* overflow_env = std::getenv("LOG_ASYNC_OVERFLOW");
+    if (overflow_env) {
+        options.block_when_full = std::string(overflow_env) == "block";
+    }
+
+    const char* flush_env = std::getenv("LOG_FLUSH_INTERVAL_SECONDS");
+    if (flush_env) {
+        options.flush_interval = std::chrono::seconds(std::max(1, std::atoi(flush_env)));
+    }
+
+    const char* sample_env = std::getenv("LOG_SAMPLE_EVERY");
+    if (sample_env) {
+        options.sample_every = static_cast<uint32_t>(std::max(1, std::atoi(sample_env)));
+    }
+
+    return options;
+}
+
 std::shared_ptr<spdlog::logger> Logger::logger_;
+std::shared_ptr<spdlog::details::thread_pool> Logger::thread_pool_;
+std::atomic<uint32_t> Logger::sample_every_{1};
 std::string Logger::service_name_;
 std::string Logger::environment_;
 Logger::Format Logger::format_;
@@ -15,16 +51,31 @@ void Logger::initialize(
     const std::string& service_name,
     const std::string& log_level,
     Format format,
-    const std::string& environment
+    const std::string& environment,
+    const LoggerOptions& options
 ) {
     service_name_ = service_name;
     environment_ = environment;
     format_ = format;
+    sample_every_.store(std::max<uint32_t>(1, options.sample_every), std::memory_order_relaxed);
 
     // Create console sink (stdout for info+, stderr for errors)
     auto console_sink = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
 
-    logger_ = std::make_shared<spdlog::logger>("gara", console_sink);
+    // Keep the previous pool alive until the logger that uses it is replaced
+    auto previous_pool = thread_pool_;
+    if (options.async) {
+        // One writer thread keeps records in order; request threads only enqueue
+        thread_pool_ = std::make_shared<spdlog::details::thread_pool>(
+            std::max<size_t>(1, options.async_queue_size), 1);
+        auto overflow = options.block_when_full
+            ? spdlog::async_overflow_policy::block
+            : spdlog::async_overflow_policy::overrun_oldest;
+        logger_ = std::make_shared<spdlog::async_logger>("gara", console_sink, thread_pool_, overflow);
+    } else {
+        logger_ = std::make_shared<spdlog::logger>("gara", console_sink);
+        thread_pool_.reset();
+    }
 
     // Set log level
     logger_->set_level(parse_log_level(log_level));
@@ -39,11 +90,21 @@ void Logger::initialize(
         logger_->set_pattern("%v");
     }
 
-    // Flush on every log (important for CloudWatch)
-    logger_->flush_on(spdlog::level::info);
+    if (options.async) {
+        // Batch flushes; warnings and errors still reach stdout promptly
+        logger_->flush_on(spdlog::level::warn);
+    } else {
+        // Flush on every log (important for CloudWatch)
+        logger_->flush_on(spdlog::level::info);
+    }
 
     // Register as default logger
     spdlog::set_default_logger(logger_);
+    previous_pool.reset();
+
+    if (options.async) {
+        spdlog::flush_every(std::max(options.flush_interval, std::chrono::seconds(1)));
+    }
 
     LOG_INFO("Logger initialized: service={}, level={}, format={}, environment={}",
              service_name, log_level,
@@ -59,14 +120,40 @@ std::shared_ptr<spdlog::logger> Logger::get() {
     return logger_;
 }
 
+void Logger::shutdown() {
+    if (logger_) {
+        logger_->flush();
+    }
+    // Drains the async queue and joins the writer and periodic flusher
+    spdlog::shutdown();
+    logger_.reset();
+    thread_pool_.reset();
+}
+
+bool Logger::should_sample(std::atomic<uint64_t>& site_counter, spdlog::level::level_enum level) {
+    if (!get()->should_log(level)) {
+        return false;
+    }
+    uint32_t every = sample_every_.load(std::memory_order_relaxed);
+    if (level >= spdlog::level::warn || every <= 1) {
+        return true;
+    }
+    return site_counter.fetch_add(1, std::memory_order_relaxed) % every == 0;
+}
+
 void Logger::log_structured(
     spdlog::level::level_enum level,
     const std::string& message,
     const nlohmann::json& fields
 ) {
+    auto logger = get();
+    if (!logger->should_log(level)) {
+        return;
+    }
+
     if (format_ == Format::TEXT) {
         // Simple text format
-        logger_->log(level, message);
+        logger->log(level, message);
         return;
     }
 
@@ -85,7 +172,7 @@ void Logger::log_structured(
     }
 
     // Output as compact JSON on single line
-    logger_->log(level, log_entry.dump());
+    logger->log(level, log_entry.dump());
 }
 
 void Logger::log_with_request(
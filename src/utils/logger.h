@@ -5,10 +5,27 @@
 #include <nlohmann/json.hpp>
 #include <string>
 #include <memory>
+#include <atomic>
 #include <chrono>
+#include <cstdint>
+
+namespace spdlog { namespace details { class thread_pool; } }
 
 namespace gara {
 
+/**
+ * Output options that keep logging off the request path
+ */
+struct LoggerOptions {
+    bool async = false;                              // Hand records to a background writer thread
+    size_t async_queue_size = 8192;                  // Records buffered before the overflow policy applies
+    bool block_when_full = false;                    // Block callers instead of dropping the oldest record
+    std::chrono::seconds flush_interval{1};          // Async mode flushes on this period and on warn+
+    uint32_t sample_every = 1;                       // Sampled call sites log 1 in N info/debug records
+
+    static LoggerOptions fromEnvironment();
+};
+
 /**
  * Structured logger for ECS/CloudWatch integration
  * Outputs JSON-formatted logs to stdout/stderr for CloudWatch Logs
@@ -26,14 +43,21 @@ public:
      * @param log_level Minimum log level (trace, debug, info, warn, error, critical)
      * @param format Output format (JSON or TEXT)
      * @param environment Environment name (e.g., "production", "staging")
+     * @param options Async writer, flushing and sampling options
      */
     static void initialize(
         const std::string& service_name,
         const std::string& log_level = "info",
         Format format = Format::JSON,
-        const std::string& environment = "production"
+        const std::string& environment = "production",
+        const LoggerOptions& options = LoggerOptions()
     );
 
+    /**
+     * Flush queued records and stop the async writer (call before exit)
+     */
+    static void shutdown();
+
     /**
      * Get the singleton logger instance
      */
@@ -51,6 +75,14 @@ public:
         const nlohmann::json& fields = {}
     );
 
+    /**
+     * Decide whether a sampled call site should emit this record
+     * Warnings and above are always logged; see LOG_STRUCTURED_SAMPLED
+     * @param site_counter Per-call-site counter
+     * @param level Log level of the record
+     */
+    static bool should_sample(std::atomic<uint64_t>& site_counter, spdlog::level::level_enum level);
+
     /**
      * Log with request context
      * @param level Log level
@@ -91,6 +123,8 @@ public:
 
 private:
     static std::shared_ptr<spdlog::logger> logger_;
+    static std::shared_ptr<spdlog::details::thread_pool> thread_pool_;
+    static std::atomic<uint32_t> sample_every_;
     static std::string service_name_;
     static std::string environment_;
     static Format format_;
@@ -104,4 +138,14 @@ private:
 #define LOG_ERROR(...) gara::Logger::get()->error(__VA_ARGS__)
 #define LOG_CRITICAL(...) gara::Logger::get()->critical(__VA_ARGS__)
 
+// Structured log for high-volume call sites: emits 1 in LOG_SAMPLE_EVERY
+// records below warn, and skips building the fields for the rest
+#define LOG_STRUCTURED_SAMPLED(level, message, ...) \
+    do { \
+        static std::atomic<uint64_t> _log_sample_counter{0}; \
+        if (gara::Logger::should_sample(_log_sample_counter, level)) { \
+            gara::Logger::log_structured(level, message, ##__VA_ARGS__); \
+        } \
+    } while (0)
+
 } // namespace gara
@@ -0,0 +1,246 @@
+#ifndef GARA_UTILS_LRU_CACHE_H
+#define GARA_UTILS_LRU_CACHE_H
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace gara {
+namespace utils {
+
+/**
+ * @brief Thread-safe LRU cache split into independently locked shards
+ *
+ * Keys are hashed onto shards so concurrent lookups for different keys
+ * rarely contend on the same mutex. Each shard evicts least recently used
+ * entries once it exceeds its share of the byte budget. Entries older than
+ * the TTL are treated as missing and dropped on access.
+ */
+template<typename Value>
+class ShardedLruCache {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @param max_bytes Total byte budget across all shards (0 disables the cache)
+     * @param ttl Maximum entry age (0 means entries never expire)
+     * @param num_shards Number of lock stripes
+     */
+    ShardedLruCache(size_t max_bytes, std::chrono::seconds ttl, size_t num_shards = 16)
+        : ttl_(ttl),
+          shard_budget_(max_bytes / std::max<size_t>(num_shards, 1)),
+          shards_(std::max<size_t>(num_shards, 1)) {}
+
+    ShardedLruCache(const ShardedLruCache&) = delete;
+    ShardedLruCache& operator=(const ShardedLruCache&) = delete;
+
+    /**
+     * @brief Check whether caching is enabled
+     */
+    bool enabled() const {
+        return shard_budget_ > 0;
+    }
+
+    /**
+     * @brief Insert or replace an entry
+     *
+     * @param key Cache key
+     * @param value Value to store
+     * @param cost Bytes charged against the budget for this entry
+     */
+    void put(const std::string& key, Value value, size_t cost) {
+        if (!enabled() || cost > shard_budget_) {
+            erase(key);
+            return;
+        }
+
+        Shard& shard = shardFor(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        auto it = shard.index.find(key);
+        if (it != shard.index.end()) {
+            shard.bytes -= it->second->cost;
+            shard.entries.erase(it->second);
+            shard.index.erase(it);
+        }
+
+        shard.entries.push_front(Entry{key, std::move(value), cost, Clock::now()});
+        shard.index[key] = shard.entries.begin();
+        shard.bytes += cost;
+
+        while (shard.bytes > shard_budget_ && !shard.entries.empty()) {
+            removeLocked(shard, std::prev(shard.entries.end()));
+        }
+    }
+
+    /**
+     * @brief Look up an entry and mark it most recently used
+     *
+     * @return Value if present and not expired, std::nullopt otherwise
+     */
+    std::optional<Value> get(const std::string& key) {
+        if (!enabled()) {
+            return std::nullopt;
+        }
+
+        Shard& shard = shardFor(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        auto it = shard.index.find(key);
+        if (it == shard.index.end()) {
+            return std::nullopt;
+        }
+
+        if (isExpired(*it->second)) {
+            removeLocked(shard, it->second);
+            return std::nullopt;
+        }
+
+        shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+        return it->second->value;
+    }
+
+    /**
+     * @brief Remove an entry
+     *
+     * @return true if the key was present
+     */
+    bool erase(const std::string& key) {
+        Shard& shard = shardFor(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        auto it = shard.index.find(key);
+        if (it == shard.index.end()) {
+            return false;
+        }
+        removeLocked(shard, it->second);
+        return true;
+    }
+
+    /**
+     * @brief Remove every entry whose key matches a predicate
+     *
+     * @return Number of entries removed
+     */
+    size_t eraseIf(const std::function<bool(const std::string&)>& predicate) {
+        size_t removed = 0;
+        for (auto& shard : shards_) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            for (auto it = shard.entries.begin(); it != shard.entries.end();) {
+                auto next = std::next(it);
+                if (predicate(it->key)) {
+                    removeLocked(shard, it);
+                    ++removed;
+                }
+                it = next;
+            }
+        }
+        return removed;
+    }
+
+    /**
+     * @brief Copy of live entries, most recently used first within each shard
+     *
+     * @param limit Maximum entries returned, split evenly across shards (0 for all)
+     */
+    std::vector<std::pair<std::string, Value>> snapshot(size_t limit = 0) const {
+        size_t per_shard = limit == 0 ? 0 : (limit + shards_.size() - 1) / shards_.size();
+        std::vector<std::pair<std::string, Value>> entries;
+        for (const auto& shard : shards_) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            size_t taken = 0;
+            for (const auto& entry : shard.entries) {
+                if ((per_shard > 0 && taken == per_shard) || (limit > 0 && entries.size() == limit)) {
+                    break;
+                }
+                if (!isExpired(entry)) {
+                    entries.emplace_back(entry.key, entry.value);
+                    ++taken;
+                }
+            }
+        }
+        return entries;
+    }
+
+    /**
+     * @brief Remove all entries
+     */
+    void clear() {
+        for (auto& shard : shards_) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            shard.entries.clear();
+            shard.index.clear();
+            shard.bytes = 0;
+        }
+    }
+
+    /**
+     * @brief Number of entries across all shards
+     */
+    size_t size() const {
+        size_t total = 0;
+        for (const auto& shard : shards_) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            total += shard.entries.size();
+        }
+        return total;
+    }
+
+    /**
+     * @brief Bytes charged across all shards
+     */
+    size_t bytes() const {
+        size_t total = 0;
+        for (const auto& shard : shards_) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            total += shard.bytes;
+        }
+        return total;
+    }
+
+private:
+    struct Entry {
+        std::string key;
+        Value value;
+        size_t cost;
+        Clock::time_point inserted_at;
+    };
+
+    struct Shard {
+        mutable std::mutex mutex;
+        std::list<Entry> entries;  // Most recently used first
+        std::unordered_map<std::string, typename std::list<Entry>::iterator> index;
+        size_t bytes = 0;
+    };
+
+    Shard& shardFor(const std::string& key) {
+        return shards_[std::hash<std::string>{}(key) % shards_.size()];
+    }
+
+    bool isExpired(const Entry& entry) const {
+        return ttl_.count() > 0 && Clock::now() - entry.inserted_at > ttl_;
+    }
+
+    static void removeLocked(Shard& shard, typename std::list<Entry>::iterator it) {
+        shard.bytes -= it->cost;
+        shard.index.erase(it->key);
+        shard.entries.erase(it);
+    }
+
+    std::chrono::seconds ttl_;
+    size_t shard_budget_;
+    std::vector<Shard> shards_;
+};
+
+} // namespace utils
+} // namespace gara
+
+#endif // GARA_UTILS_LRU_CACHE_H
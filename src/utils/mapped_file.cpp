@@ -0,0 +1,42 @@
+#include "mapped_file.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace gara {
+namespace utils {
+
+MappedFile::~MappedFile() {
+    munmap(const_cast<char*>(data_), size_);
+}
+
+std::unique_ptr<MappedFile> MappedFile::open(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return nullptr;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode) || info.st_size <= 0) {
+        close(fd);
+        return nullptr;
+    }
+
+    size_t size = static_cast<size_t>(info.st_size);
+    void* address = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // The mapping holds its own reference to the file
+    close(fd);
+    if (address == MAP_FAILED) {
+        return nullptr;
+    }
+
+    // Decoders read front to back; queue readahead while the transform waits for a worker
+    madvise(address, size, MADV_SEQUENTIAL);
+    madvise(address, size, MADV_WILLNEED);
+
+    return std::unique_ptr<MappedFile>(new MappedFile(static_cast<const char*>(address), size));
+}
+
+} // namespace utils
+} // namespace gara
@@ -0,0 +1,68 @@
+#ifndef GARA_UTILS_MAPPED_FILE_H
+#define GARA_UTILS_MAPPED_FILE_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace gara {
+namespace utils {
+
+/**
+ * @brief Non-owning view of contiguous bytes
+ *
+ * Lets the image pipeline read from a vector or a mapped file alike; the
+ * owner must outlive the view.
+ */
+class ByteView {
+public:
+    ByteView() = default;
+    ByteView(const char* data, size_t size) : data_(data), size_(size) {}
+    ByteView(const std::vector<char>& bytes) : data_(bytes.data()), size_(bytes.size()) {}  // NOLINT: implicit by design
+
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+private:
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+/**
+ * @brief Read-only memory map of a whole file
+ *
+ * Pages are loaded on first touch, so mapping is cheap and libvips reads the
+ * stored object in place instead of from a copy. The mapping stays valid
+ * after the file is unlinked or replaced by rename, which is how storage
+ * overwrites and deletes objects.
+ */
+class MappedFile {
+public:
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * @brief Map path read-only and start reading it ahead
+     * @return nullptr if the file is missing, empty, or cannot be mapped
+     */
+    static std::unique_ptr<MappedFile> open(const std::string& path);
+
+    ByteView view() const { return ByteView(data_, size_); }
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    MappedFile(const char* data, size_t size) : data_(data), size_(size) {}
+
+    const char* data_;
+    size_t size_;
+};
+
+} // namespace utils
+} // namespace gara
+
+#endif // GARA_UTILS_MAPPED_FILE_H
@@ -1,24 +1,228 @@
 #include "utils/metrics.h"
 #include "utils/logger.h"
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 
 namespace gara {
 
+namespace {
+
+// Per-thread ring size; a full ring drops samples instead of blocking the caller
+constexpr size_t THREAD_BUFFER_CAPACITY = 1024;
+
+// How often the flusher empties thread buffers, independent of the emit interval
+constexpr std::chrono::milliseconds DRAIN_INTERVAL(100);
+
+// EMF limits: metrics per document and values per metric
+constexpr size_t EMF_MAX_METRICS = 100;
+constexpr size_t EMF_MAX_VALUES = 100;
+
+// Durations fall into exponential buckets about 5% wide
+constexpr double HISTOGRAM_MIN_MS = 0.01;
+constexpr double HISTOGRAM_GROWTH = 1.1;
+constexpr int HISTOGRAM_MAX_BUCKET = DurationMetric::BUCKETS - 1;  // ~0.01 ms * 1.1^200 > 30 minutes
+constexpr double HISTOGRAM_LOG_GROWTH = 0.09531017980432486;  // std::log(HISTOGRAM_GROWTH)
+
+double histogramValue(int bucket) {
+    if (bucket == 0) {
+        return 0.0;
+    }
+    // Geometric middle of the bucket, rounded to keep the output compact
+    double middle = HISTOGRAM_MIN_MS * std::pow(HISTOGRAM_GROWTH, bucket - 0.5);
+    double scale = std::pow(10.0, 2 - static_cast<int>(std::floor(std::log10(middle))));
+    return std::round(middle * scale) / scale;
+}
+
+std::string dimensionKey(const Metrics::DimensionMap& dimensions) {
+    std::string key;
+    for (const auto& [name, value] : dimensions) {
+        key += name;
+        key += '\x1e';
+        key += value;
+        key += '\x1f';
+    }
+    return key;
+}
+
+// Handles register here for the lifetime of the process; leaked on purpose so
+// handles with static storage can unregister after other statics are gone
+struct HandleRegistry {
+    std::mutex mutex;
+    std::vector<CounterMetric*> counters;
+    std::vector<DurationMetric*> durations;
+};
+
+HandleRegistry& handleRegistry() {
+    static HandleRegistry* registry = new HandleRegistry();
+    return *registry;
+}
+
+template<typename T>
+void unregisterHandle(std::vector<T*>& handles, T* handle) {
+    std::lock_guard<std::mutex> lock(handleRegistry().mutex);
+    handles.erase(std::remove(handles.begin(), handles.end(), handle), handles.end());
+}
+
+} // anonymous namespace
+
+size_t DurationMetric::bucket_for(double duration_ms) {
+    if (duration_ms <= 0.0) {
+        return 0;
+    }
+    if (duration_ms < HISTOGRAM_MIN_MS) {
+        return 1;
+    }
+    int bucket = 1 + static_cast<int>(std::log(duration_ms / HISTOGRAM_MIN_MS) / HISTOGRAM_LOG_GROWTH);
+    return static_cast<size_t>(std::min(bucket, HISTOGRAM_MAX_BUCKET));
+}
+
+CounterMetric::CounterMetric(std::string name, Metrics::DimensionMap dimensions, std::string unit)
+    : name_(std::move(name))
+    , unit_(std::move(unit))
+    , dimensions_(std::move(dimensions))
+    , dimension_key_(dimensionKey(dimensions_))
+{
+    std::lock_guard<std::mutex> lock(handleRegistry().mutex);
+    handleRegistry().counters.push_back(this);
+}
+
+CounterMetric::~CounterMetric() {
+    unregisterHandle(handleRegistry().counters, this);
+}
+
+DurationMetric::DurationMetric(std::string name, Metrics::DimensionMap dimensions)
+    : name_(std::move(name))
+    , dimensions_(std::move(dimensions))
+    , dimension_key_(dimensionKey(dimensions_))
+{
+    std::lock_guard<std::mutex> lock(handleRegistry().mutex);
+    handleRegistry().durations.push_back(this);
+}
+
+DurationMetric::~DurationMetric() {
+    unregisterHandle(handleRegistry().durations, this);
+}
+
+class Metrics::ThreadBuffer {
+public:
+    ThreadBuffer() : slots_(THREAD_BUFFER_CAPACITY) {}
+
+    // Producer side: only the owning thread calls this
+    bool push(Sample&& sample) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        if (head - tail_.load(std::memory_order_acquire) >= slots_.size()) {
+            return false;
+        }
+        slots_[head % slots_.size()] = std::move(sample);
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side: only the flusher calls this
+    template<typename Func>
+    void drain(Func&& consume) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        size_t head = head_.load(std::memory_order_acquire);
+        for (; tail != head; ++tail) {
+            consume(std::move(slots_[tail % slots_.size()]));
+        }
+        tail_.store(tail, std::memory_order_release);
+    }
+
+    bool empty() const {
+        return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+    }
+
+    std::atomic<uint64_t> dropped{0};
+
+private:
+    std::vector<Sample> slots_;
+    alignas(64) std::atomic<size_t> head_{0};
+    alignas(64) std::atomic<size_t> tail_{0};
+};
+
+struct Metrics::Aggregates {
+    struct Series {
+        Kind kind = Kind::COUNT;
+        std::string name;
+        std::string unit;
+        double total = 0.0;                  // Counters
+        double last = 0.0;                   // Gauges
+        std::map<int, uint64_t> histogram;   // Durations: bucket -> samples
+    };
+
+    struct Group {
+        DimensionMap dimensions;
+        std::map<std::string, Series> series;  // By metric name
+    };
+
+    std::map<std::string, Group> groups;       // By dimension values
+    uint64_t dropped = 0;
+
+    Series& series(const std::string& dimension_key, const DimensionMap& dimensions,
+                   Kind kind, const std::string& name, const std::string& unit) {
+        Group& group = groups[dimension_key];
+        if (group.series.empty()) {
+            group.dimensions = dimensions;
+        }
+
+        auto [it, inserted] = group.series.try_emplace(name);
+        if (inserted) {
+            it->second.kind = kind;
+            it->second.name = name;
+            it->second.unit = unit;
+        }
+        return it->second;
+    }
+
+    void add(Sample&& sample) {
+        Series& series = this->series(dimensionKey(sample.dimensions), sample.dimensions,
+                                      sample.kind, sample.name, sample.unit);
+        switch (series.kind) {
+            case Kind::COUNT:
+                series.total += sample.value;
+                break;
+            case Kind::GAUGE:
+                series.last = sample.value;
+                break;
+            case Kind::DURATION:
+                series.histogram[static_cast<int>(DurationMetric::bucket_for(sample.value))]++;
+                break;
+        }
+    }
+};
+
+namespace {
+
+// Remembers which Metrics instance this thread's buffer belongs to, so a
+// re-initialized instance does not inherit a buffer it never registered
+struct LocalBufferRef {
+    uint64_t owner = 0;
+    std::shared_ptr<void> buffer;
+};
+
+thread_local LocalBufferRef tls_buffer;
+
+} // anonymous namespace
+
 std::shared_ptr<Metrics> Metrics::instance_;
+std::atomic<uint64_t> Metrics::next_instance_id_{1};
 
 void Metrics::initialize(
     const std::string& namespace_name,
     const std::string& service_name,
     const std::string& environment,
-    bool enabled
+    bool enabled,
+    std::chrono::milliseconds flush_interval
 ) {
     instance_ = std::shared_ptr<Metrics>(
-        new Metrics(namespace_name, service_name, environment, enabled)
+        new Metrics(namespace_name, service_name, environment, enabled, flush_interval)
     );
 
     if (enabled) {
-        LOG_INFO("Metrics initialized: namespace={}, service={}, environment={}",
-                 namespace_name, service_name, environment);
+        LOG_INFO("Metrics initialized: namespace={}, service={}, environment={}, flush_interval_ms={}",
+                 namespace_name, service_name, environment, flush_interval.count());
     } else {
         LOG_INFO("Metrics disabled");
     }
@@ -32,17 +236,48 @@ std::shared_ptr<Metrics> Metrics::get() {
     return instance_;
 }
 
+Metrics* Metrics::instance() {
+    if (!instance_) {
+        initialize("GaraImage", "gara-image", "production", true);
+    }
+    return instance_.get();
+}
+
+void Metrics::shutdown() {
+    instance_.reset();
+}
+
 Metrics::Metrics(
     const std::string& namespace_name,
     const std::string& service_name,
     const std::string& environment,
-    bool enabled
+    bool enabled,
+    std::chrono::milliseconds flush_interval
 )
     : namespace_(namespace_name)
     , service_name_(service_name)
     , environment_(environment)
     , enabled_(enabled)
-{}
+    , flush_interval_(std::max(flush_interval, std::chrono::milliseconds(1)))
+    , instance_id_(next_instance_id_++)
+    , aggregates_(std::make_unique<Aggregates>())
+    , output_([](const std::string& documents) { std::cout << documents << std::flush; })
+{
+    if (enabled_) {
+        flusher_ = std::thread(&Metrics::flush_loop, this);
+    }
+}
+
+Metrics::~Metrics() {
+    {
+        std::lock_guard<std::mutex> lock(flusher_mutex_);
+        stopping_ = true;
+    }
+    flusher_cv_.notify_all();
+    if (flusher_.joinable()) {
+        flusher_.join();
+    }
+}
 
 void Metrics::publish_count(
     const std::string& name,
@@ -51,7 +286,7 @@ void Metrics::publish_count(
     const DimensionMap& dimensions
 ) {
     if (!enabled_) return;
-    publish_metric(name, value, unit, dimensions);
+    publish_metric(Kind::COUNT, name, value, unit, dimensions);
 }
 
 void Metrics::publish_duration(
@@ -60,7 +295,7 @@ void Metrics::publish_duration(
     const DimensionMap& dimensions
 ) {
     if (!enabled_) return;
-    publish_metric(name, duration_ms, "Milliseconds", dimensions);
+    publish_metric(Kind::DURATION, name, duration_ms, "Milliseconds", dimensions);
 }
 
 void Metrics::publish_gauge(
@@ -70,10 +305,11 @@ void Metrics::publish_gauge(
     const DimensionMap& dimensions
 ) {
     if (!enabled_) return;
-    publish_metric(name, value, unit, dimensions);
+    publish_metric(Kind::GAUGE, name, value, unit, dimensions);
 }
 
 void Metrics::publish_metric(
+    Kind kind,
     const std::string& name,
     double value,
     const std::string& unit,
@@ -81,52 +317,222 @@ void Metrics::publish_metric(
 ) {
     if (!enabled_) return;
 
-    nlohmann::json emf_log = create_emf_log(name, value, unit, dimensions);
+    ThreadBuffer& buffer = local_buffer();
+    if (!buffer.push(Sample{kind, name, unit, dimensions, value})) {
+        buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+}
 
-    // Output to stdout as JSON (CloudWatch will parse this)
-    std::cout << emf_log.dump() << std::endl;
+Metrics::ThreadBuffer& Metrics::local_buffer() {
+    if (tls_buffer.owner != instance_id_) {
+        auto buffer = std::make_shared<ThreadBuffer>();
+        {
+            std::lock_guard<utils::InstrumentedMutex> lock(buffers_mutex_);
+            buffers_.push_back(buffer);
+        }
+        tls_buffer.owner = instance_id_;
+        tls_buffer.buffer = buffer;
+    }
+    return *static_cast<ThreadBuffer*>(tls_buffer.buffer.get());
 }
 
-nlohmann::json Metrics::create_emf_log(
-    const std::string& name,
-    double value,
-    const std::string& unit,
-    const DimensionMap& dimensions
-) {
+void Metrics::drain_buffers() {
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    {
+        std::lock_guard<utils::InstrumentedMutex> lock(buffers_mutex_);
+        // Forget buffers whose thread has exited once they are empty
+        buffers_.erase(std::remove_if(buffers_.begin(), buffers_.end(),
+                                      [](const std::shared_ptr<ThreadBuffer>& buffer) {
+                                          return buffer.use_count() == 1 && buffer->empty();
+                                      }),
+                       buffers_.end());
+        buffers = buffers_;
+    }
+
+    for (auto& buffer : buffers) {
+        buffer->drain([this](Sample&& sample) {
+            aggregates_->add(std::move(sample));
+        });
+        uint64_t dropped = buffer->dropped.exchange(0, std::memory_order_relaxed);
+        aggregates_->dropped += dropped;
+        dropped_total_.fetch_add(dropped, std::memory_order_relaxed);
+    }
+
+    drain_handles();
+}
+
+void Metrics::drain_handles() {
+    HandleRegistry& registry = handleRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+
+    for (CounterMetric* counter : registry.counters) {
+        uint64_t value = counter->value_.exchange(0, std::memory_order_relaxed);
+        if (value > 0) {
+            aggregates_->series(counter->dimension_key_, counter->dimensions_,
+                                Kind::COUNT, counter->name_, counter->unit_).total += static_cast<double>(value);
+        }
+    }
+
+    for (DurationMetric* duration : registry.durations) {
+        Aggregates::Series* series = nullptr;
+        for (size_t bucket = 0; bucket < DurationMetric::BUCKETS; ++bucket) {
+            uint64_t count = duration->buckets_[bucket].exchange(0, std::memory_order_relaxed);
+            if (count == 0) {
+                continue;
+            }
+            if (!series) {
+                series = &aggregates_->series(duration->dimension_key_, duration->dimensions_,
+                                              Kind::DURATION, duration->name_, "Milliseconds");
+            }
+            series->histogram[static_cast<int>(bucket)] += count;
+        }
+    }
+}
+
+void Metrics::flush() {
+    if (!enabled_) return;
+
+    std::lock_guard<utils::InstrumentedMutex> lock(flush_mutex_);
+    drain_buffers();
+    std::string documents = render_documents();
+    if (!documents.empty()) {
+        output_(documents);
+    }
+}
+
+void Metrics::set_output(OutputFunction output) {
+    std::lock_guard<utils::InstrumentedMutex> lock(flush_mutex_);
+    output_ = std::move(output);
+}
+
+void Metrics::flush_loop() {
+    auto next_emit = std::chrono::steady_clock::now() + flush_interval_;
+    auto tick = std::min<std::chrono::milliseconds>(DRAIN_INTERVAL, flush_interval_);
+
+    std::unique_lock<std::mutex> lock(flusher_mutex_);
+    while (!stopping_) {
+        flusher_cv_.wait_for(lock, tick, [this]() { return stopping_; });
+        if (stopping_) {
+            break;
+        }
+        lock.unlock();
+
+        if (std::chrono::steady_clock::now() >= next_emit) {
+            flush();
+            next_emit = std::chrono::steady_clock::now() + flush_interval_;
+        } else {
+            // Keep rings short between emits so bursts do not overflow them
+            std::lock_guard<utils::InstrumentedMutex> flush_lock(flush_mutex_);
+            drain_buffers();
+        }
+
+        lock.lock();
+    }
+    lock.unlock();
+
+    // Write whatever arrived before shutdown
+    flush();
+}
+
+std::string Metrics::render_documents() {
+    Aggregates aggregates;
+    std::swap(aggregates, *aggregates_);
+
+    if (aggregates.dropped > 0) {
+        Sample dropped{Kind::COUNT, "MetricsDropped", "Count", {}, static_cast<double>(aggregates.dropped)};
+        aggregates.add(std::move(dropped));
+    }
+
+    std::string output;
+    for (auto& [key, group] : aggregates.groups) {
+        // Each series becomes a list of values; histograms expand each
+        // bucket into its representative value once per sample
+        std::vector<std::pair<std::string, std::string>> units;
+        std::vector<std::vector<double>> values;
+        std::vector<bool> scalar;
+        for (const auto& [name, series] : group.series) {
+            units.emplace_back(name, series.unit);
+            std::vector<double> series_values;
+            switch (series.kind) {
+                case Kind::COUNT:
+                    series_values.push_back(series.total);
+                    break;
+                case Kind::GAUGE:
+                    series_values.push_back(series.last);
+                    break;
+                case Kind::DURATION:
+                    for (const auto& [bucket, count] : series.histogram) {
+                        series_values.insert(series_values.end(), count, histogramValue(bucket));
+                    }
+                    break;
+            }
+            scalar.push_back(series.kind != Kind::DURATION);
+            values.push_back(std::move(series_values));
+        }
+
+        // Split into documents of at most 100 metrics with 100 values each
+        for (size_t first = 0; first < units.size(); first += EMF_MAX_METRICS) {
+            size_t last = std::min(first + EMF_MAX_METRICS, units.size());
+            for (size_t offset = 0;; offset += EMF_MAX_VALUES) {
+                std::vector<std::pair<std::string, std::string>> doc_units;
+                nlohmann::json doc_values = nlohmann::json::object();
+                for (size_t i = first; i < last; ++i) {
+                    if (offset >= values[i].size()) {
+                        continue;
+                    }
+                    doc_units.push_back(units[i]);
+                    if (scalar[i]) {
+                        doc_values[units[i].first] = values[i][0];
+                    } else {
+                        size_t end = std::min(offset + EMF_MAX_VALUES, values[i].size());
+                        doc_values[units[i].first] = std::vector<double>(values[i].begin() + offset,
+                                                                         values[i].begin() + end);
+                    }
+                }
+                if (doc_units.empty()) {
+                    break;
+                }
+                output += create_emf_document(group.dimensions, doc_units, std::move(doc_values)).dump();
+                output += '\n';
+            }
+        }
+    }
+
+    return output;
+}
+
+nlohmann::json Metrics::create_emf_document(
+    const DimensionMap& dimensions,
+    const std::vector<std::pair<std::string, std::string>>& metric_units,
+    nlohmann::json values
+) const {
     // Build dimension sets
-    std::vector<std::vector<std::string>> dimension_sets;
     std::vector<std::string> dimension_names = {"ServiceName", "Environment"};
-
-    // Add custom dimensions
     for (const auto& [key, val] : dimensions) {
         dimension_names.push_back(key);
     }
 
-    dimension_sets.push_back(dimension_names);
+    nlohmann::json metrics = nlohmann::json::array();
+    for (const auto& [name, unit] : metric_units) {
+        metrics.push_back({{"Name", name}, {"Unit", unit}});
+    }
 
     // Build the EMF structure
-    nlohmann::json emf_log = {
-        {"_aws", {
-            {"Timestamp", std::chrono::duration_cast<std::chrono::milliseconds>(
-                std::chrono::system_clock::now().time_since_epoch()
-            ).count()},
-            {"CloudWatchMetrics", {
-                {
-                    {"Namespace", namespace_},
-                    {"Dimensions", dimension_sets},
-                    {"Metrics", {
-                        {
-                            {"Name", name},
-                            {"Unit", unit}
-                        }
-                    }}
-                }
-            }}
-        }},
-        {"ServiceName", service_name_},
-        {"Environment", environment_},
-        {name, value}
+    nlohmann::json emf_log = std::move(values);
+    emf_log["_aws"] = {
+        {"Timestamp", std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()
+        ).count()},
+        {"CloudWatchMetrics", {
+            {
+                {"Namespace", namespace_},
+                {"Dimensions", {dimension_names}},
+                {"Metrics", metrics}
+            }
+        }}
     };
+    emf_log["ServiceName"] = service_name_;
+    emf_log["Environment"] = environment_;
 
     // Add custom dimension values
     for (const auto& [key, val] : dimensions) {
@@ -137,24 +543,24 @@ nlohmann::json Metrics::create_emf_log(
 }
 
 std::unique_ptr<Metrics::Timer> Metrics::start_timer(
-    const std::string& metric_name,
-    const DimensionMap& dimensions
+    std::string metric_name,
+    DimensionMap dimensions
 ) {
     if (!enabled_) return nullptr;
-    return std::unique_ptr<Timer>(new Timer(metric_name, dimensions));
+    return std::unique_ptr<Timer>(new Timer(std::move(metric_name), std::move(dimensions)));
 }
 
 // Timer implementation
-Metrics::Timer::Timer(const std::string& metric_name, const DimensionMap& dimensions)
-    : metric_name_(metric_name)
-    , dimensions_(dimensions)
+Metrics::Timer::Timer(std::string metric_name, DimensionMap dimensions)
+    : metric_name_(std::move(metric_name))
+    , dimensions_(std::move(dimensions))
     , start_time_(std::chrono::steady_clock::now())
 {}
 
 Metrics::Timer::~Timer() {
     try {
         double duration = elapsed_ms();
-        if (auto metrics = Metrics::get(); metrics && metrics->is_enabled()) {
+        if (auto* metrics = Metrics::instance(); metrics && metrics->is_enabled()) {
             metrics->publish_duration(metric_name_, duration, dimensions_);
         }
     } catch (...) {
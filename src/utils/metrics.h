@@ -1,11 +1,19 @@
 #pragma once
 
 #include <nlohmann/json.hpp>
+#include <array>
 #include <string>
 #include <map>
 #include <vector>
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <thread>
+#include "instrumented_mutex.h"
 
 namespace gara {
 
@@ -13,11 +21,24 @@ namespace gara {
  * CloudWatch Embedded Metric Format (EMF) metrics publisher
  * Outputs metrics embedded in JSON logs that CloudWatch automatically extracts
  *
+ * Publishing is cheap on request threads: each data point goes into a
+ * lock-free buffer owned by the calling thread. A background thread drains
+ * the buffers, sums counters, folds durations into histograms and writes
+ * one multi-metric EMF document per dimension set each flush interval.
+ *
+ * Hot paths should declare a CounterMetric or DurationMetric handle once
+ * (name and dimensions are interned at construction) and record through it;
+ * a sample is then a relaxed atomic add with no allocation.
+ *
+ * Building with -DGARA_DISABLE_METRICS (CMake: -DENABLE_METRICS=OFF) compiles
+ * the METRICS_* macros and handle updates out entirely.
+ *
  * Reference: https://docs.aws.amazon.com/AmazonCloudWatch/latest/monitoring/CloudWatch_Embedded_Metric_Format.html
  */
 class Metrics {
 public:
     using DimensionMap = std::map<std::string, std::string>;
+    using OutputFunction = std::function<void(const std::string&)>;
 
     /**
      * Initialize metrics with service configuration
@@ -25,12 +46,14 @@ public:
      * @param service_name Service name for default dimension
      * @param environment Environment name (e.g., "production")
      * @param enabled Whether metrics are enabled
+     * @param flush_interval How often aggregated metrics are written
      */
     static void initialize(
         const std::string& namespace_name,
         const std::string& service_name,
         const std::string& environment = "production",
-        bool enabled = true
+        bool enabled = true,
+        std::chrono::milliseconds flush_interval = std::chrono::milliseconds(10000)
     );
 
     /**
@@ -38,6 +61,21 @@ public:
      */
     static std::shared_ptr<Metrics> get();
 
+    /**
+     * Get the singleton without taking a reference (used by the macros)
+     */
+    static Metrics* instance();
+
+    /**
+     * Flush pending metrics and stop the background thread (call before exit)
+     */
+    static void shutdown();
+
+    ~Metrics();
+
+    Metrics(const Metrics&) = delete;
+    Metrics& operator=(const Metrics&) = delete;
+
     /**
      * Publish a counter metric
      * @param name Metric name (e.g., "CacheHits")
@@ -78,13 +116,29 @@ public:
         const DimensionMap& dimensions = {}
     );
 
+    /**
+     * Write everything recorded so far without waiting for the next interval
+     */
+    void flush();
+
+    /**
+     * Replace the destination of EMF output (stdout by default)
+     * @param output Receives newline-separated EMF documents, once per flush
+     */
+    void set_output(OutputFunction output);
+
+    /**
+     * Data points discarded because a thread's buffer was full
+     */
+    uint64_t dropped_samples() const { return dropped_total_.load(std::memory_order_relaxed); }
+
     /**
      * Helper class for timing operations
      * Automatically publishes duration when destroyed
      */
     class Timer {
     public:
-        Timer(const std::string& metric_name, const DimensionMap& dimensions = {});
+        Timer(std::string metric_name, DimensionMap dimensions = {});
         ~Timer();
 
         // Delete copy constructors
@@ -109,8 +163,8 @@ public:
      *   } // Timer publishes duration when it goes out of scope
      */
     std::unique_ptr<Timer> start_timer(
-        const std::string& metric_name,
-        const DimensionMap& dimensions = {}
+        std::string metric_name,
+        DimensionMap dimensions = {}
     );
 
     /**
@@ -119,55 +173,201 @@ public:
     bool is_enabled() const { return enabled_; }
 
 private:
+    enum class Kind { COUNT, DURATION, GAUGE };
+
+    struct Sample {
+        Kind kind = Kind::COUNT;
+        std::string name;
+        std::string unit;
+        DimensionMap dimensions;
+        double value = 0.0;
+    };
+
+    class ThreadBuffer;   // Single-producer/single-consumer ring, one per thread
+    struct Aggregates;    // Series accumulated between flushes (flusher only)
+
     Metrics(
         const std::string& namespace_name,
         const std::string& service_name,
         const std::string& environment,
-        bool enabled
+        bool enabled,
+        std::chrono::milliseconds flush_interval
     );
 
     void publish_metric(
+        Kind kind,
         const std::string& name,
         double value,
         const std::string& unit,
         const DimensionMap& dimensions
     );
 
-    nlohmann::json create_emf_log(
-        const std::string& name,
-        double value,
-        const std::string& unit,
-        const DimensionMap& dimensions
-    );
+    ThreadBuffer& local_buffer();
+    void flush_loop();
+    void drain_buffers();
+    void drain_handles();
+    std::string render_documents();
+
+    nlohmann::json create_emf_document(
+        const DimensionMap& dimensions,
+        const std::vector<std::pair<std::string, std::string>>& metric_units,
+        nlohmann::json values
+    ) const;
 
     static std::shared_ptr<Metrics> instance_;
+    static std::atomic<uint64_t> next_instance_id_;
 
     std::string namespace_;
     std::string service_name_;
     std::string environment_;
     bool enabled_;
+    std::chrono::milliseconds flush_interval_;
+    uint64_t instance_id_;
+
+    utils::InstrumentedMutex buffers_mutex_{"metrics_buffers"};  // Taken when a thread registers and by the flusher
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers_;
+
+    utils::InstrumentedMutex flush_mutex_{"metrics_flush"};  // One consumer at a time; guards aggregates_ and output_
+    std::unique_ptr<Aggregates> aggregates_;
+    OutputFunction output_;
+    std::atomic<uint64_t> dropped_total_{0};
+
+    std::mutex flusher_mutex_;
+    std::condition_variable flusher_cv_;
+    bool stopping_ = false;
+    std::thread flusher_;
+};
+
+/**
+ * Pre-declared counter; declare at namespace scope and call add() on hot paths
+ * Usage:
+ *   static gara::CounterMetric cache_hits("CacheHits", {{"operation", "transform"}});
+ *   cache_hits.add();
+ */
+class CounterMetric {
+public:
+    CounterMetric(std::string name, Metrics::DimensionMap dimensions = {}, std::string unit = "Count");
+    ~CounterMetric();
+
+    CounterMetric(const CounterMetric&) = delete;
+    CounterMetric& operator=(const CounterMetric&) = delete;
+
+    void add(uint64_t value = 1) {
+#ifndef GARA_DISABLE_METRICS
+        value_.fetch_add(value, std::memory_order_relaxed);
+#else
+        (void)value;
+#endif
+    }
+
+private:
+    friend class Metrics;
+
+    std::string name_;
+    std::string unit_;
+    Metrics::DimensionMap dimensions_;
+    std::string dimension_key_;
+    std::atomic<uint64_t> value_{0};
 };
 
+/**
+ * Pre-declared duration histogram; record through ScopedMetricTimer or record_ms()
+ */
+class DurationMetric {
+public:
+    static constexpr size_t BUCKETS = 201;  // Exponential buckets shared with Metrics::publish_duration
+
+    DurationMetric(std::string name, Metrics::DimensionMap dimensions = {});
+    ~DurationMetric();
+
+    DurationMetric(const DurationMetric&) = delete;
+    DurationMetric& operator=(const DurationMetric&) = delete;
+
+    void record_ms(double duration_ms) {
+#ifndef GARA_DISABLE_METRICS
+        buckets_[bucket_for(duration_ms)].fetch_add(1, std::memory_order_relaxed);
+#else
+        (void)duration_ms;
+#endif
+    }
+
+    static size_t bucket_for(double duration_ms);
+
+private:
+    friend class Metrics;
+
+    std::string name_;
+    Metrics::DimensionMap dimensions_;
+    std::string dimension_key_;
+    std::array<std::atomic<uint64_t>, BUCKETS> buckets_{};
+};
+
+/**
+ * Records the lifetime of the enclosing scope into a DurationMetric
+ */
+class ScopedMetricTimer {
+public:
+#ifndef GARA_DISABLE_METRICS
+    explicit ScopedMetricTimer(DurationMetric& metric)
+        : metric_(metric), start_time_(std::chrono::steady_clock::now()) {}
+
+    ~ScopedMetricTimer() {
+        auto elapsed = std::chrono::steady_clock::now() - start_time_;
+        metric_.record_ms(std::chrono::duration<double, std::milli>(elapsed).count());
+    }
+#else
+    explicit ScopedMetricTimer(DurationMetric&) {}
+#endif
+
+    ScopedMetricTimer(const ScopedMetricTimer&) = delete;
+    ScopedMetricTimer& operator=(const ScopedMetricTimer&) = delete;
+
+#ifndef GARA_DISABLE_METRICS
+private:
+    DurationMetric& metric_;
+    std::chrono::steady_clock::time_point start_time_;
+#endif
+};
+
+#define GARA_METRICS_CONCAT_INNER(a, b) a##b
+#define GARA_METRICS_CONCAT(a, b) GARA_METRICS_CONCAT_INNER(a, b)
+
+#ifndef GARA_DISABLE_METRICS
+
 // Convenience macros for metrics
 #define METRICS_COUNT(name, ...) \
-    if (auto m = gara::Metrics::get(); m && m->is_enabled()) { \
+    if (auto* m = gara::Metrics::instance(); m && m->is_enabled()) { \
         m->publish_count(name, ##__VA_ARGS__); \
     }
 
 #define METRICS_DURATION(name, duration_ms, ...) \
-    if (auto m = gara::Metrics::get(); m && m->is_enabled()) { \
+    if (auto* m = gara::Metrics::instance(); m && m->is_enabled()) { \
         m->publish_duration(name, duration_ms, ##__VA_ARGS__); \
     }
 
 #define METRICS_GAUGE(name, value, ...) \
-    if (auto m = gara::Metrics::get(); m && m->is_enabled()) { \
+    if (auto* m = gara::Metrics::instance(); m && m->is_enabled()) { \
         m->publish_gauge(name, value, ##__VA_ARGS__); \
     }
 
 #define METRICS_TIMER(name, ...) \
-    std::unique_ptr<gara::Metrics::Timer> _timer_##__LINE__; \
-    if (auto m = gara::Metrics::get(); m && m->is_enabled()) { \
-        _timer_##__LINE__ = m->start_timer(name, ##__VA_ARGS__); \
+    std::unique_ptr<gara::Metrics::Timer> GARA_METRICS_CONCAT(_timer_, __LINE__); \
+    if (auto* m = gara::Metrics::instance(); m && m->is_enabled()) { \
+        GARA_METRICS_CONCAT(_timer_, __LINE__) = m->start_timer(name, ##__VA_ARGS__); \
     }
 
+// Times the enclosing scope into a pre-declared DurationMetric
+#define METRICS_SCOPED_TIMER(metric) \
+    gara::ScopedMetricTimer GARA_METRICS_CONCAT(_scoped_timer_, __LINE__)(metric)
+
+#else
+
+#define METRICS_COUNT(name, ...) do {} while (0)
+#define METRICS_DURATION(name, duration_ms, ...) do {} while (0)
+#define METRICS_GAUGE(name, value, ...) do {} while (0)
+#define METRICS_TIMER(name, ...) do {} while (0)
+#define METRICS_SCOPED_TIMER(metric) do {} while (0)
+
+#endif // GARA_DISABLE_METRICS
+
 } // namespace gara
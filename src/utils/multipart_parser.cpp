@@ -0,0 +1,159 @@
+#include "multipart_parser.h"
+#include <algorithm>
+#include <cctype>
+#include <limits>
+
+namespace gara {
+namespace utils {
+
+namespace {
+
+bool iequals(std::string_view a, std::string_view b) {
+    return a.size() == b.size() &&
+           std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+               return std::tolower(static_cast<unsigned char>(x)) ==
+                      std::tolower(static_cast<unsigned char>(y));
+           });
+}
+
+std::string_view trim(std::string_view value) {
+    while (!value.empty() && std::isspace(static_cast<unsigned char>(value.front()))) {
+        value.remove_prefix(1);
+    }
+    while (!value.empty() && std::isspace(static_cast<unsigned char>(value.back()))) {
+        value.remove_suffix(1);
+    }
+    return value;
+}
+
+// Find a header parameter (e.g. filename="x.jpg"); returns nullopt if absent
+std::optional<std::string> findParam(std::string_view header_value, std::string_view name) {
+    size_t pos = 0;
+    while (pos < header_value.size()) {
+        size_t semi = header_value.find(';', pos);
+        std::string_view token = trim(header_value.substr(pos, semi == std::string_view::npos ? std::string_view::npos : semi - pos));
+        pos = (semi == std::string_view::npos) ? header_value.size() : semi + 1;
+
+        size_t eq = token.find('=');
+        if (eq == std::string_view::npos || !iequals(trim(token.substr(0, eq)), name)) {
+            continue;
+        }
+
+        std::string_view value = trim(token.substr(eq + 1));
+        if (value.size() >= 2 && value.front() == '"' && value.back() == '"') {
+            value = value.substr(1, value.size() - 2);
+        }
+        return std::string(value);
+    }
+    return std::nullopt;
+}
+
+} // namespace
+
+std::string MultipartParser::extractBoundary(std::string_view content_type) {
+    std::string_view media_type = trim(content_type.substr(0, content_type.find(';')));
+    if (!iequals(media_type, "multipart/form-data")) {
+        return "";
+    }
+    return findParam(content_type, "boundary").value_or("");
+}
+
+std::optional<MultipartFilePart> MultipartParser::findFilePart(std::string_view body,
+                                                              std::string_view content_type) {
+    std::vector<MultipartFilePart> parts;
+    scanFileParts(body, content_type, 1, parts);
+    if (parts.empty()) {
+        return std::nullopt;
+    }
+    return std::move(parts.front());
+}
+
+std::vector<MultipartFilePart> MultipartParser::findFileParts(std::string_view body,
+                                                             std::string_view content_type) {
+    std::vector<MultipartFilePart> parts;
+    if (!scanFileParts(body, content_type, std::numeric_limits<size_t>::max(), parts)) {
+        parts.clear();
+    }
+    return parts;
+}
+
+bool MultipartParser::scanFileParts(std::string_view body, std::string_view content_type,
+                                    size_t max_parts, std::vector<MultipartFilePart>& parts) {
+    std::string boundary = extractBoundary(content_type);
+    if (boundary.empty()) {
+        return false;
+    }
+
+    const std::string delimiter = "--" + boundary;
+    const std::string part_end = "\r\n" + delimiter;
+
+    size_t pos = body.find(delimiter);
+    while (pos != std::string_view::npos) {
+        pos += delimiter.size();
+
+        // Closing delimiter "--boundary--"
+        if (body.substr(pos, 2) == "--") {
+            return true;
+        }
+        if (body.substr(pos, 2) != "\r\n") {
+            return false;
+        }
+        pos += 2;
+
+        size_t headers_end = body.find("\r\n\r\n", pos);
+        if (headers_end == std::string_view::npos) {
+            return false;
+        }
+        std::string_view headers = body.substr(pos, headers_end - pos);
+        size_t data_start = headers_end + 4;
+
+        size_t data_end = body.find(part_end, data_start);
+        if (data_end == std::string_view::npos) {
+            return false;
+        }
+
+        MultipartFilePart part;
+        bool has_filename = false;
+
+        size_t line_start = 0;
+        while (line_start <= headers.size()) {
+            size_t line_end = headers.find("\r\n", line_start);
+            std::string_view line = headers.substr(line_start,
+                line_end == std::string_view::npos ? std::string_view::npos : line_end - line_start);
+
+            size_t colon = line.find(':');
+            if (colon != std::string_view::npos) {
+                std::string_view name = trim(line.substr(0, colon));
+                std::string_view value = trim(line.substr(colon + 1));
+                if (iequals(name, "Content-Disposition")) {
+                    if (auto filename = findParam(value, "filename")) {
+                        part.filename = *filename;
+                        has_filename = true;
+                    }
+                } else if (iequals(name, "Content-Type")) {
+                    part.content_type = std::string(value);
+                }
+            }
+
+            if (line_end == std::string_view::npos) {
+                break;
+            }
+            line_start = line_end + 2;
+        }
+
+        if (has_filename) {
+            part.data = body.substr(data_start, data_end - data_start);
+            parts.push_back(std::move(part));
+            if (parts.size() >= max_parts) {
+                return true;
+            }
+        }
+
+        pos = data_end + 2;  // Skip CRLF, land on the next delimiter
+    }
+
+    return false;
+}
+
+} // namespace utils
+} // namespace gara
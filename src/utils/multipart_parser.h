@@ -0,0 +1,62 @@
+#ifndef GARA_UTILS_MULTIPART_PARSER_H
+#define GARA_UTILS_MULTIPART_PARSER_H
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace gara {
+namespace utils {
+
+/**
+ * @brief A file part located inside a multipart/form-data body
+ *
+ * data points into the original request body; it is only valid while
+ * that body is alive.
+ */
+struct MultipartFilePart {
+    std::string filename;
+    std::string content_type;
+    std::string_view data;
+};
+
+/**
+ * @brief Minimal multipart/form-data scanner that does not copy part bodies
+ */
+class MultipartParser {
+public:
+    /**
+     * @brief Extract the boundary parameter from a Content-Type header
+     * @return Boundary, or empty string if the header is not multipart
+     */
+    static std::string extractBoundary(std::string_view content_type);
+
+    /**
+     * @brief Find the first part carrying a filename
+     * @param body Raw request body
+     * @param content_type Request Content-Type header
+     * @return File part, or std::nullopt if the body has none or is malformed
+     */
+    static std::optional<MultipartFilePart> findFilePart(std::string_view body,
+                                                         std::string_view content_type);
+
+    /**
+     * @brief Find every part carrying a filename, in body order
+     * @param body Raw request body
+     * @param content_type Request Content-Type header
+     * @return File parts, or an empty vector if the body has none or is malformed
+     */
+    static std::vector<MultipartFilePart> findFileParts(std::string_view body,
+                                                        std::string_view content_type);
+
+private:
+    // Collect up to max_parts file parts; false when the body is malformed
+    static bool scanFileParts(std::string_view body, std::string_view content_type,
+                              size_t max_parts, std::vector<MultipartFilePart>& parts);
+};
+
+} // namespace utils
+} // namespace gara
+
+#endif // GARA_UTILS_MULTIPART_PARSER_H
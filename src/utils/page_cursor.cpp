@@ -0,0 +1,137 @@
+#include "page_cursor.h"
+#include <algorithm>
+#include <cctype>
+#include <stdexcept>
+
+namespace gara {
+namespace utils {
+
+namespace {
+
+char sortCode(ImageSortOrder sort_order) {
+    switch (sort_order) {
+        case ImageSortOrder::OLDEST:    return 'o';
+        case ImageSortOrder::NAME_ASC:  return 'a';
+        case ImageSortOrder::NAME_DESC: return 'd';
+        case ImageSortOrder::NEWEST:
+        default:                        return 'n';
+    }
+}
+
+bool sortsByName(ImageSortOrder sort_order) {
+    return sort_order == ImageSortOrder::NAME_ASC || sort_order == ImageSortOrder::NAME_DESC;
+}
+
+std::string hexEncode(const std::string& value) {
+    static const char digits[] = "0123456789abcdef";
+    std::string out;
+    out.reserve(value.size() * 2);
+    for (unsigned char c : value) {
+        out.push_back(digits[c >> 4]);
+        out.push_back(digits[c & 0x0f]);
+    }
+    return out;
+}
+
+std::optional<std::string> hexDecode(const std::string& value) {
+    if (value.size() % 2 != 0) {
+        return std::nullopt;
+    }
+    auto nibble = [](char c) -> int {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        return -1;
+    };
+    std::string out;
+    out.reserve(value.size() / 2);
+    for (size_t i = 0; i < value.size(); i += 2) {
+        int high = nibble(value[i]);
+        int low = nibble(value[i + 1]);
+        if (high < 0 || low < 0) {
+            return std::nullopt;
+        }
+        out.push_back(static_cast<char>((high << 4) | low));
+    }
+    return out;
+}
+
+bool isValidImageId(const std::string& id) {
+    return !id.empty() && std::all_of(id.begin(), id.end(), [](unsigned char c) {
+        return std::isalnum(c) || c == '_' || c == '-';
+    });
+}
+
+} // anonymous namespace
+
+// Token layout: <sort code>.<sort key>.<image_id>, where the sort key is the
+// upload timestamp in decimal or the hex-encoded name
+std::string PageCursorCodec::encode(ImageSortOrder sort_order, const ImagePageCursor& cursor) {
+    std::string key = sortsByName(sort_order)
+        ? hexEncode(cursor.name)
+        : std::to_string(static_cast<long long>(cursor.uploaded_at));
+    return std::string(1, sortCode(sort_order)) + "." + key + "." + cursor.image_id;
+}
+
+std::optional<ImagePageCursor> PageCursorCodec::decode(const std::string& token,
+                                                       ImageSortOrder sort_order) {
+    size_t first = token.find('.');
+    size_t second = first == std::string::npos ? std::string::npos : token.find('.', first + 1);
+    if (first != 1 || second == std::string::npos || token[0] != sortCode(sort_order)) {
+        return std::nullopt;
+    }
+
+    std::string key = token.substr(first + 1, second - first - 1);
+    ImagePageCursor cursor;
+    cursor.image_id = token.substr(second + 1);
+    if (!isValidImageId(cursor.image_id)) {
+        return std::nullopt;
+    }
+
+    if (sortsByName(sort_order)) {
+        auto name = hexDecode(key);
+        if (!name) {
+            return std::nullopt;
+        }
+        cursor.name = *name;
+    } else {
+        if (key.empty() || !std::all_of(key.begin(), key.end(), ::isdigit)) {
+            return std::nullopt;
+        }
+        try {
+            cursor.uploaded_at = static_cast<std::time_t>(std::stoll(key));
+        } catch (const std::exception&) {
+            return std::nullopt;
+        }
+    }
+
+    return cursor;
+}
+
+// Token layout: c.<created_at>.<album_id>; the 'c' code is never used by image sorts
+std::string PageCursorCodec::encodeAlbum(const AlbumPageCursor& cursor) {
+    return "c." + std::to_string(static_cast<long long>(cursor.created_at)) + "." + cursor.album_id;
+}
+
+std::optional<AlbumPageCursor> PageCursorCodec::decodeAlbum(const std::string& token) {
+    size_t second = token.find('.', 2);
+    if (token.size() < 2 || token.compare(0, 2, "c.") != 0 || second == std::string::npos) {
+        return std::nullopt;
+    }
+
+    std::string key = token.substr(2, second - 2);
+    AlbumPageCursor cursor;
+    cursor.album_id = token.substr(second + 1);
+    if (!isValidImageId(cursor.album_id) || key.empty() || !std::all_of(key.begin(), key.end(), ::isdigit)) {
+        return std::nullopt;
+    }
+    try {
+        cursor.created_at = static_cast<std::time_t>(std::stoll(key));
+    } catch (const std::exception&) {
+        return std::nullopt;
+    }
+
+    return cursor;
+}
+
+} // namespace utils
+} // namespace gara
@@ -0,0 +1,45 @@
+#ifndef GARA_UTILS_PAGE_CURSOR_H
+#define GARA_UTILS_PAGE_CURSOR_H
+
+#include <optional>
+#include <string>
+#include "../interfaces/database_client_interface.h"
+
+namespace gara {
+namespace utils {
+
+/**
+ * @brief Encodes keyset pagination cursors as opaque, URL-safe tokens
+ *
+ * A token records the sort order it was issued for, so a cursor from one
+ * ordering cannot silently be replayed against another.
+ */
+class PageCursorCodec {
+public:
+    /**
+     * @brief Build the token for the last row of a page
+     */
+    static std::string encode(ImageSortOrder sort_order, const ImagePageCursor& cursor);
+
+    /**
+     * @brief Parse a token issued for sort_order
+     * @return Cursor, or std::nullopt if the token is malformed or for another sort order
+     */
+    static std::optional<ImagePageCursor> decode(const std::string& token, ImageSortOrder sort_order);
+
+    /**
+     * @brief Build the token for the last album of a page
+     */
+    static std::string encodeAlbum(const AlbumPageCursor& cursor);
+
+    /**
+     * @brief Parse a token issued by encodeAlbum
+     * @return Cursor, or std::nullopt if the token is malformed or not an album token
+     */
+    static std::optional<AlbumPageCursor> decodeAlbum(const std::string& token);
+};
+
+} // namespace utils
+} // namespace gara
+
+#endif // GARA_UTILS_PAGE_CURSOR_H
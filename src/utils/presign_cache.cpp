@@ -0,0 +1,51 @@
+#include "presign_cache.h"
+#include "metrics.h"
+#include <algorithm>
+
+namespace gara {
+namespace utils {
+
+namespace {
+
+constexpr size_t ENTRY_OVERHEAD = 64;
+
+CounterMetric presign_hits("PresignedUrls", {{"result", "cached"}});
+CounterMetric presign_signed("PresignedUrls", {{"result", "signed"}});
+
+} // anonymous namespace
+
+PresignCache::PresignCache(int bucket_seconds, int max_expiration_seconds, size_t max_bytes)
+    : bucket_seconds_(std::max(0, bucket_seconds)),
+      max_expiration_seconds_(std::max(1, max_expiration_seconds)),
+      cache_(bucket_seconds_ > 0 ? max_bytes : 0, std::chrono::seconds(bucket_seconds_)) {}
+
+PresignWindow PresignCache::window(std::time_t now, int expiration_seconds, int bucket_seconds,
+                                   int max_expiration_seconds) {
+    int expires_in = std::clamp(expiration_seconds, 1, max_expiration_seconds);
+    if (bucket_seconds <= 0) {
+        return {now, expires_in};
+    }
+    std::time_t signed_at = now - now % bucket_seconds;
+    return {signed_at, std::min(expires_in + bucket_seconds, max_expiration_seconds)};
+}
+
+std::string PresignCache::get(const std::string& key, int expiration_seconds, std::time_t now,
+                              const Signer& sign) {
+    PresignWindow aligned = window(now, expiration_seconds, bucket_seconds_, max_expiration_seconds_);
+
+    // Different lifetimes sign different URLs
+    std::string cache_key = std::to_string(expiration_seconds) + ":" + key;
+    auto cached = cache_.get(cache_key);
+    if (cached && cached->signed_at == aligned.signed_at) {
+        presign_hits.add();
+        return cached->url;
+    }
+
+    std::string url = sign(aligned.signed_at, aligned.expires_in);
+    presign_signed.add();
+    cache_.put(cache_key, Entry{url, aligned.signed_at}, cache_key.size() + url.size() + ENTRY_OVERHEAD);
+    return url;
+}
+
+} // namespace utils
+} // namespace gara
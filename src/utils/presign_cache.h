@@ -0,0 +1,62 @@
+#ifndef GARA_UTILS_PRESIGN_CACHE_H
+#define GARA_UTILS_PRESIGN_CACHE_H
+
+#include <ctime>
+#include <functional>
+#include <string>
+#include "lru_cache.h"
+
+namespace gara {
+namespace utils {
+
+// Signing time and lifetime for one presigned URL
+struct PresignWindow {
+    std::time_t signed_at;
+    int expires_in;
+};
+
+/**
+ * @brief Reuses presigned URLs for an object across a fixed time bucket
+ *
+ * Signing time is floored to a multiple of the bucket width and the
+ * lifetime is stretched by one bucket, so every request in a bucket gets
+ * the same URL, and that URL still has at least the requested lifetime
+ * left when the next bucket replaces it. Identical URLs let browsers and
+ * CDNs reuse what they fetched, and a hit skips the HMAC chain.
+ *
+ * A bucket width of 0 disables both alignment and caching.
+ */
+class PresignCache {
+public:
+    // Produces the URL for a key signed at signed_at, valid for expires_in seconds
+    using Signer = std::function<std::string(std::time_t signed_at, int expires_in)>;
+
+    PresignCache(int bucket_seconds, int max_expiration_seconds, size_t max_bytes);
+
+    /**
+     * @brief Aligned window for a URL requested at now
+     *
+     * expires_in is capped at max_expiration_seconds, so requests close to
+     * the cap may rotate with less than the requested lifetime left.
+     */
+    static PresignWindow window(std::time_t now, int expiration_seconds, int bucket_seconds,
+                                int max_expiration_seconds);
+
+    // URL for key, signing through sign only when the bucket has none yet
+    std::string get(const std::string& key, int expiration_seconds, std::time_t now, const Signer& sign);
+
+private:
+    struct Entry {
+        std::string url;
+        std::time_t signed_at;
+    };
+
+    int bucket_seconds_;
+    int max_expiration_seconds_;
+    ShardedLruCache<Entry> cache_;
+};
+
+} // namespace utils
+} // namespace gara
+
+#endif // GARA_UTILS_PRESIGN_CACHE_H
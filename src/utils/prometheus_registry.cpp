@@ -0,0 +1,244 @@
+#include "utils/prometheus_registry.h"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+
+namespace gara {
+
+namespace {
+
+void atomicAdd(std::atomic<double>& target, double value) {
+    double current = target.load(std::memory_order_relaxed);
+    while (!target.compare_exchange_weak(current, current + value, std::memory_order_relaxed)) {
+    }
+}
+
+std::string escapeLabelValue(const std::string& value) {
+    std::string escaped;
+    escaped.reserve(value.size());
+    for (char c : value) {
+        switch (c) {
+            case '\\': escaped += "\\\\"; break;
+            case '"': escaped += "\\\""; break;
+            case '\n': escaped += "\\n"; break;
+            default: escaped += c;
+        }
+    }
+    return escaped;
+}
+
+// Renders name="value" pairs without braces so histograms can append "le"
+std::string renderLabels(const PrometheusRegistry::Labels& labels) {
+    std::string rendered;
+    for (const auto& [name, value] : labels) {
+        if (!rendered.empty()) {
+            rendered += ',';
+        }
+        rendered += name;
+        rendered += "=\"";
+        rendered += escapeLabelValue(value);
+        rendered += '"';
+    }
+    return rendered;
+}
+
+std::string formatValue(double value) {
+    if (std::isnan(value)) {
+        return "NaN";
+    }
+    if (std::isinf(value)) {
+        return value > 0 ? "+Inf" : "-Inf";
+    }
+    if (value == std::floor(value) && std::fabs(value) < 1e15) {
+        return std::to_string(static_cast<long long>(value));
+    }
+    std::ostringstream out;
+    out << std::setprecision(12) << value;
+    return out.str();
+}
+
+void writeSample(std::ostringstream& out, const std::string& name, const std::string& labels, double value) {
+    out << name;
+    if (!labels.empty()) {
+        out << '{' << labels << '}';
+    }
+    out << ' ' << formatValue(value) << '\n';
+}
+
+// Literal path segments used by the service's routes; anything else is an ID
+const std::set<std::string>& routeVocabulary() {
+    static const std::set<std::string> vocabulary = {
+        "api", "images", "albums", "upload", "health", "ready", "reorder", "openapi.yaml", "docs", "metrics",
+        "files", "raw", "transformed", "batch", "tiles", "image.dzi", "image_files",
+        "debug", "memory", "internal", "peer", "renditions"
+    };
+    return vocabulary;
+}
+
+constexpr size_t MAX_ROUTE_SEGMENTS = 7;
+
+} // anonymous namespace
+
+void PrometheusRegistry::Counter::inc(double value) {
+    atomicAdd(value_, value);
+}
+
+void PrometheusRegistry::Gauge::inc(double value) {
+    atomicAdd(value_, value);
+}
+
+PrometheusRegistry::Histogram::Histogram(std::vector<double> upper_bounds)
+    : upper_bounds_(std::move(upper_bounds))
+{
+    std::sort(upper_bounds_.begin(), upper_bounds_.end());
+    upper_bounds_.erase(std::unique(upper_bounds_.begin(), upper_bounds_.end()), upper_bounds_.end());
+    buckets_ = std::make_unique<std::atomic<uint64_t>[]>(upper_bounds_.size() + 1);
+    for (size_t i = 0; i <= upper_bounds_.size(); ++i) {
+        buckets_[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+void PrometheusRegistry::Histogram::observe(double value) {
+    // Buckets are inclusive upper bounds ("le")
+    size_t index = std::lower_bound(upper_bounds_.begin(), upper_bounds_.end(), value) - upper_bounds_.begin();
+    buckets_[index].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    atomicAdd(sum_, value);
+}
+
+const std::vector<double>& PrometheusRegistry::defaultLatencyBuckets() {
+    static const std::vector<double> buckets = {
+        0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1.0, 2.5, 5.0, 10.0
+    };
+    return buckets;
+}
+
+const char* PrometheusRegistry::typeName(Type type) {
+    switch (type) {
+        case Type::COUNTER: return "counter";
+        case Type::GAUGE: return "gauge";
+        case Type::HISTOGRAM: return "histogram";
+    }
+    return "untyped";
+}
+
+PrometheusRegistry& PrometheusRegistry::instance() {
+    static PrometheusRegistry registry;
+    return registry;
+}
+
+PrometheusRegistry::Family& PrometheusRegistry::family(const std::string& name, Type type,
+                                                       const std::string& help) {
+    auto [it, inserted] = families_.try_emplace(name);
+    Family& family = it->second;
+    if (inserted) {
+        family.type = type;
+        family.help = help;
+    } else if (family.type != type) {
+        throw std::invalid_argument("Metric " + name + " is already registered as a " +
+                                    typeName(family.type));
+    }
+    return family;
+}
+
+PrometheusRegistry::Counter& PrometheusRegistry::counter(const std::string& name, const std::string& help,
+                                                         const Labels& labels) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& series = family(name, Type::COUNTER, help).counters[renderLabels(labels)];
+    if (!series) {
+        series = std::make_unique<Counter>();
+    }
+    return *series;
+}
+
+PrometheusRegistry::Gauge& PrometheusRegistry::gauge(const std::string& name, const std::string& help,
+                                                     const Labels& labels) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& series = family(name, Type::GAUGE, help).gauges[renderLabels(labels)];
+    if (!series) {
+        series = std::make_unique<Gauge>();
+    }
+    return *series;
+}
+
+PrometheusRegistry::Histogram& PrometheusRegistry::histogram(const std::string& name, const std::string& help,
+                                                             const std::vector<double>& upper_bounds,
+                                                             const Labels& labels) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Family& histogram_family = family(name, Type::HISTOGRAM, help);
+    if (histogram_family.histograms.empty()) {
+        histogram_family.upper_bounds = upper_bounds;
+    }
+    // Every series in a family shares the first registration's buckets
+    auto& series = histogram_family.histograms[renderLabels(labels)];
+    if (!series) {
+        series = std::make_unique<Histogram>(histogram_family.upper_bounds);
+    }
+    return *series;
+}
+
+std::string PrometheusRegistry::render() const {
+    std::ostringstream out;
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    for (const auto& [name, family] : families_) {
+        out << "# HELP " << name << ' ' << family.help << '\n';
+        out << "# TYPE " << name << ' ' << typeName(family.type) << '\n';
+
+        for (const auto& [labels, counter] : family.counters) {
+            writeSample(out, name, labels, counter->value());
+        }
+        for (const auto& [labels, gauge] : family.gauges) {
+            writeSample(out, name, labels, gauge->value());
+        }
+        for (const auto& [labels, histogram] : family.histograms) {
+            std::string prefix = labels.empty() ? "" : labels + ",";
+            uint64_t cumulative = 0;
+            for (size_t i = 0; i < histogram->upper_bounds_.size(); ++i) {
+                cumulative += histogram->buckets_[i].load(std::memory_order_relaxed);
+                writeSample(out, name + "_bucket",
+                            prefix + "le=\"" + formatValue(histogram->upper_bounds_[i]) + "\"",
+                            static_cast<double>(cumulative));
+            }
+            cumulative += histogram->buckets_[histogram->upper_bounds_.size()].load(std::memory_order_relaxed);
+            writeSample(out, name + "_bucket", prefix + "le=\"+Inf\"", static_cast<double>(cumulative));
+            writeSample(out, name + "_sum", labels, histogram->sum());
+            writeSample(out, name + "_count", labels, static_cast<double>(cumulative));
+        }
+    }
+
+    return out.str();
+}
+
+std::string PrometheusRegistry::routeLabel(const std::string& path) {
+    std::string clean = path.substr(0, path.find('?'));
+
+    std::vector<std::string> segments;
+    std::istringstream stream(clean);
+    std::string segment;
+    while (std::getline(stream, segment, '/')) {
+        if (!segment.empty()) {
+            segments.push_back(segment);
+        }
+    }
+
+    if (segments.empty()) {
+        return "/";
+    }
+    // Paths outside the service's routes (scanners, typos) share one label
+    if (segments.size() > MAX_ROUTE_SEGMENTS || routeVocabulary().count(segments[0]) == 0) {
+        return "other";
+    }
+
+    std::string label;
+    for (const auto& part : segments) {
+        label += '/';
+        label += routeVocabulary().count(part) ? part : ":id";
+    }
+    return label;
+}
+
+} // namespace gara
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace gara {
+
+/**
+ * In-process metric registry rendered in the Prometheus text exposition format
+ *
+ * Metrics are created on first use and live as long as the registry, so the
+ * references returned by counter(), gauge() and histogram() can be cached.
+ * Updates are lock-free; only lookups and rendering take the registry mutex.
+ *
+ * Reference: https://prometheus.io/docs/instrumenting/exposition_formats/
+ */
+class PrometheusRegistry {
+public:
+    // Label name/value pairs, rendered in the order given
+    using Labels = std::vector<std::pair<std::string, std::string>>;
+
+    class Counter {
+    public:
+        void inc(double value = 1.0);
+        double value() const { return value_.load(std::memory_order_relaxed); }
+
+    private:
+        std::atomic<double> value_{0.0};
+    };
+
+    class Gauge {
+    public:
+        void set(double value) { value_.store(value, std::memory_order_relaxed); }
+        void inc(double value = 1.0);
+        void dec(double value = 1.0) { inc(-value); }
+        double value() const { return value_.load(std::memory_order_relaxed); }
+
+    private:
+        std::atomic<double> value_{0.0};
+    };
+
+    class Histogram {
+    public:
+        explicit Histogram(std::vector<double> upper_bounds);
+
+        void observe(double value);
+        uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+        double sum() const { return sum_.load(std::memory_order_relaxed); }
+
+    private:
+        friend class PrometheusRegistry;
+
+        std::vector<double> upper_bounds_;
+        std::unique_ptr<std::atomic<uint64_t>[]> buckets_;  // Per bucket, plus +Inf; not cumulative
+        std::atomic<uint64_t> count_{0};
+        std::atomic<double> sum_{0.0};
+    };
+
+    // Request latency buckets in seconds
+    static const std::vector<double>& defaultLatencyBuckets();
+
+    /**
+     * Process-wide registry served at /metrics
+     */
+    static PrometheusRegistry& instance();
+
+    PrometheusRegistry() = default;
+    PrometheusRegistry(const PrometheusRegistry&) = delete;
+    PrometheusRegistry& operator=(const PrometheusRegistry&) = delete;
+
+    /**
+     * Get or create a series; throws std::invalid_argument if the name is
+     * already registered with a different type
+     */
+    Counter& counter(const std::string& name, const std::string& help, const Labels& labels = {});
+    Gauge& gauge(const std::string& name, const std::string& help, const Labels& labels = {});
+    Histogram& histogram(const std::string& name, const std::string& help,
+                         const std::vector<double>& upper_bounds, const Labels& labels = {});
+
+    /**
+     * Render all metrics in text exposition format
+     */
+    std::string render() const;
+
+    /**
+     * Collapse IDs in a request path so route labels stay low cardinality
+     * (e.g. /api/albums/abc/images -> /api/albums/:id/images)
+     */
+    static std::string routeLabel(const std::string& path);
+
+private:
+    enum class Type { COUNTER, GAUGE, HISTOGRAM };
+
+    struct Family {
+        Type type;
+        std::string help;
+        std::vector<double> upper_bounds;
+        // Keyed by rendered label set
+        std::map<std::string, std::unique_ptr<Counter>> counters;
+        std::map<std::string, std::unique_ptr<Gauge>> gauges;
+        std::map<std::string, std::unique_ptr<Histogram>> histograms;
+    };
+
+    static const char* typeName(Type type);
+    Family& family(const std::string& name, Type type, const std::string& help);
+
+    mutable std::mutex mutex_;
+    std::map<std::string, Family> families_;
+};
+
+} // namespace gara
@@ -0,0 +1,215 @@
+#include "rate_limiter.h"
+#include "metrics.h"
+#include "../exceptions/transform_exceptions.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+
+namespace gara {
+namespace utils {
+
+namespace {
+
+// Bucket word: tokens (thousandths) above a 40-bit millisecond timestamp
+constexpr int TIME_BITS = 40;
+constexpr uint64_t TIME_MASK = (uint64_t{1} << TIME_BITS) - 1;
+constexpr int64_t MILLI = 1000;
+
+CounterMetric limited_tokens("RateLimited", {{"reason", "tokens"}});
+CounterMetric limited_concurrency("RateLimited", {{"reason", "concurrency"}});
+
+thread_local RateLimiter* current_limiter = nullptr;
+thread_local RateLimiter::Client current_client;
+
+// Spreads std::hash output so the key and IP of one client land apart
+uint64_t mix(uint64_t value) {
+    value ^= value >> 33;
+    value *= 0xff51afd7ed558ccdULL;
+    value ^= value >> 33;
+    value *= 0xc4ceb9fe1a85ec53ULL;
+    value ^= value >> 33;
+    return value;
+}
+
+size_t roundUpToPowerOfTwo(size_t value) {
+    size_t size = 1;
+    while (size < value) {
+        size <<= 1;
+    }
+    return size;
+}
+
+} // anonymous namespace
+
+RateLimiter::TransformPermit& RateLimiter::TransformPermit::operator=(TransformPermit&& other) noexcept {
+    if (this != &other) {
+        if (slot_) {
+            slot_->fetch_sub(1, std::memory_order_acq_rel);
+        }
+        slot_ = other.slot_;
+        other.slot_ = nullptr;
+    }
+    return *this;
+}
+
+RateLimiter::TransformPermit::~TransformPermit() {
+    if (slot_) {
+        slot_->fetch_sub(1, std::memory_order_acq_rel);
+    }
+}
+
+RateLimiter::Scope::Scope(RateLimiter* limiter, const Client& client) {
+    current_limiter = limiter;
+    current_client = client;
+}
+
+RateLimiter::Scope::~Scope() {
+    current_limiter = nullptr;
+    current_client = Client();
+}
+
+RateLimiter::RateLimiter(const RateLimitConfig& config)
+    : config_(config),
+      capacity_(static_cast<int64_t>(std::max(1, config.burst)) * MILLI),
+      refill_per_ms_(config.requests_per_second),
+      mask_(roundUpToPowerOfTwo(std::max<size_t>(1, config.table_size)) - 1),
+      buckets_(new std::atomic<uint64_t>[mask_ + 1]),
+      transforms_(new std::atomic<int>[mask_ + 1]) {
+    for (size_t i = 0; i <= mask_; ++i) {
+        buckets_[i].store(0, std::memory_order_relaxed);
+        transforms_[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+RateLimiter::Client RateLimiter::client(std::string_view api_key, std::string_view ip) {
+    Client client;
+    client.has_key = !api_key.empty();
+    if (client.has_key) {
+        client.key_slot = mix(std::hash<std::string_view>{}(api_key));
+    }
+    client.ip_slot = mix(std::hash<std::string_view>{}(ip) ^ 0x9e3779b97f4a7c15ULL);
+    return client;
+}
+
+RateLimiter::Decision RateLimiter::admit(const Client& client, int cost) {
+    return admit(client, cost, nowMs());
+}
+
+RateLimiter::Decision RateLimiter::admit(const Client& client, int cost, uint64_t now_ms) {
+    return admitAll(client, static_cast<int64_t>(std::max(0, cost)) * MILLI, std::max<uint64_t>(1, now_ms));
+}
+
+RateLimiter::TransformPermit RateLimiter::admitTransform() {
+    RateLimiter* limiter = current_limiter;
+    if (!limiter) {
+        return TransformPermit();
+    }
+
+    int64_t cost = static_cast<int64_t>(limiter->config_.miss_cost) * MILLI;
+    Decision decision = limiter->admitAll(current_client, cost, limiter->nowMs());
+    if (!decision.allowed) {
+        limited_tokens.add();
+        throw exceptions::TooManyRequestsException("Rate limit exceeded", decision.retry_after_seconds);
+    }
+
+    int cap = limiter->config_.max_concurrent_transforms;
+    if (cap <= 0) {
+        return TransformPermit();
+    }
+    uint64_t slot = current_client.has_key ? current_client.key_slot : current_client.ip_slot;
+    std::atomic<int>& transforms = limiter->transforms_[slot & limiter->mask_];
+    if (transforms.fetch_add(1, std::memory_order_acq_rel) >= cap) {
+        transforms.fetch_sub(1, std::memory_order_acq_rel);
+        // Turned away before doing any work, so the tokens go back
+        limiter->refund(limiter->buckets_[current_client.ip_slot & limiter->mask_], std::min(cost, limiter->capacity_));
+        if (current_client.has_key) {
+            limiter->refund(limiter->buckets_[current_client.key_slot & limiter->mask_],
+                            std::min(cost, limiter->capacity_));
+        }
+        limited_concurrency.add();
+        throw exceptions::TooManyRequestsException("Too many concurrent transforms", 1);
+    }
+    return TransformPermit(&transforms);
+}
+
+bool RateLimiter::chargeMisses(size_t count) {
+    RateLimiter* limiter = current_limiter;
+    if (!limiter || count == 0) {
+        return true;
+    }
+    int64_t cost = static_cast<int64_t>(limiter->config_.miss_cost) * MILLI * static_cast<int64_t>(count);
+    if (!limiter->admitAll(current_client, cost, limiter->nowMs()).allowed) {
+        limited_tokens.add();
+        return false;
+    }
+    return true;
+}
+
+RateLimiter::Decision RateLimiter::admitAll(const Client& client, int64_t cost, uint64_t now_ms) {
+    cost = std::min(cost, capacity_);
+    int64_t shortfall = 0;
+    bool allowed = take(buckets_[client.ip_slot & mask_], cost, now_ms, shortfall);
+    if (allowed && client.has_key && !take(buckets_[client.key_slot & mask_], cost, now_ms, shortfall)) {
+        refund(buckets_[client.ip_slot & mask_], cost);
+        allowed = false;
+    }
+    if (allowed) {
+        return {true, 0};
+    }
+    double wait_ms = static_cast<double>(shortfall) / refill_per_ms_;
+    return {false, std::max(1, static_cast<int>(std::ceil(wait_ms / 1000.0)))};
+}
+
+bool RateLimiter::take(std::atomic<uint64_t>& bucket, int64_t cost, uint64_t now_ms, int64_t& shortfall) {
+    uint64_t word = bucket.load(std::memory_order_relaxed);
+    for (;;) {
+        // An untouched slot starts full
+        int64_t tokens = capacity_;
+        uint64_t stamp = now_ms;
+        if (word != 0) {
+            tokens = static_cast<int64_t>(word >> TIME_BITS);
+            uint64_t last = word & TIME_MASK;
+            int64_t refill = now_ms > last ? static_cast<int64_t>((now_ms - last) * refill_per_ms_) : 0;
+            if (refill > 0) {
+                tokens = std::min(capacity_, tokens + refill);
+            } else {
+                // Keep the old stamp so slow refills still accumulate
+                stamp = last;
+            }
+        }
+        if (tokens < cost) {
+            shortfall = cost - tokens;
+            return false;
+        }
+        uint64_t next = (static_cast<uint64_t>(tokens - cost) << TIME_BITS) | (stamp & TIME_MASK);
+        if (bucket.compare_exchange_weak(word, next, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+            return true;
+        }
+    }
+}
+
+void RateLimiter::refund(std::atomic<uint64_t>& bucket, int64_t cost) {
+    uint64_t word = bucket.load(std::memory_order_relaxed);
+    for (;;) {
+        if (word == 0) {
+            return;
+        }
+        int64_t tokens = std::min(capacity_, static_cast<int64_t>(word >> TIME_BITS) + cost);
+        uint64_t next = (static_cast<uint64_t>(tokens) << TIME_BITS) | (word & TIME_MASK);
+        if (bucket.compare_exchange_weak(word, next, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+            return;
+        }
+    }
+}
+
+uint64_t RateLimiter::nowMs() const {
+    static const auto epoch = std::chrono::steady_clock::now();
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - epoch).count();
+    // 0 marks an untouched slot
+    return static_cast<uint64_t>(elapsed) + 1;
+}
+
+} // namespace utils
+} // namespace gara
@@ -0,0 +1,115 @@
+#ifndef GARA_UTILS_RATE_LIMITER_H
+#define GARA_UTILS_RATE_LIMITER_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include "../models/rate_limit_config.h"
+
+namespace gara {
+namespace utils {
+
+/**
+ * @brief Lock-free per-client token buckets and transform concurrency caps
+ *
+ * Every client is charged against two buckets: one for its API key (when it
+ * sends one) and one for its IP, so rotating made-up keys does not escape the
+ * IP bucket. A bucket is a single 64-bit word (tokens and last refill time)
+ * updated with compare-and-swap, in a fixed table indexed by a hash of the
+ * client; clients that collide share a slot, so the table is sized well above
+ * the number of active clients.
+ *
+ * Requests cost 1 token on arrival. A rendition cache miss costs miss_cost
+ * more and holds one of the client's transform slots until it finishes.
+ * The handler's thread finds its client through Scope, which the rate limit
+ * middleware installs for the length of the request.
+ */
+class RateLimiter {
+public:
+    struct Client {
+        uint64_t key_slot = 0;
+        uint64_t ip_slot = 0;
+        bool has_key = false;
+    };
+
+    struct Decision {
+        bool allowed;
+        int retry_after_seconds;  // Whole seconds until the cost is affordable (0 when allowed)
+    };
+
+    // Holds one transform slot for a client; releases it when destroyed
+    class TransformPermit {
+    public:
+        TransformPermit() = default;
+        TransformPermit(std::atomic<int>* slot) : slot_(slot) {}
+        TransformPermit(TransformPermit&& other) noexcept : slot_(other.slot_) { other.slot_ = nullptr; }
+        TransformPermit& operator=(TransformPermit&& other) noexcept;
+        TransformPermit(const TransformPermit&) = delete;
+        TransformPermit& operator=(const TransformPermit&) = delete;
+        ~TransformPermit();
+
+    private:
+        std::atomic<int>* slot_ = nullptr;
+    };
+
+    // Makes limiter and client current for this thread until destroyed
+    class Scope {
+    public:
+        Scope(RateLimiter* limiter, const Client& client);
+        ~Scope();
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+
+    explicit RateLimiter(const RateLimitConfig& config);
+
+    const RateLimitConfig& config() const { return config_; }
+
+    static Client client(std::string_view api_key, std::string_view ip);
+
+    /**
+     * @brief Take cost tokens from the client's key and IP buckets
+     *
+     * Both buckets must afford the cost; when one cannot, neither is charged.
+     * cost is capped at the burst so every cost is affordable eventually.
+     */
+    Decision admit(const Client& client, int cost);
+    Decision admit(const Client& client, int cost, uint64_t now_ms);
+
+    /**
+     * @brief Charge the current thread's client for a cache-miss transform
+     *
+     * Takes miss_cost tokens and a transform slot. Returns an empty permit
+     * when no Scope is active.
+     *
+     * @throws exceptions::TooManyRequestsException when the client is out of
+     *         tokens or already at max_concurrent_transforms
+     */
+    static TransformPermit admitTransform();
+
+    /**
+     * @brief Charge the current thread's client for count cache misses that
+     *        do not hold a slot on this thread (e.g. batch items)
+     * @return false when the tokens are not there; nothing is charged then
+     */
+    static bool chargeMisses(size_t count);
+
+private:
+    bool take(std::atomic<uint64_t>& bucket, int64_t cost, uint64_t now_ms, int64_t& shortfall);
+    void refund(std::atomic<uint64_t>& bucket, int64_t cost);
+    Decision admitAll(const Client& client, int64_t cost, uint64_t now_ms);
+    uint64_t nowMs() const;
+
+    RateLimitConfig config_;
+    int64_t capacity_;       // Thousandths of a token
+    double refill_per_ms_;   // Thousandths of a token per millisecond
+    size_t mask_;
+    std::unique_ptr<std::atomic<uint64_t>[]> buckets_;
+    std::unique_ptr<std::atomic<int>[]> transforms_;
+};
+
+} // namespace utils
+} // namespace gara
+
+#endif // GARA_UTILS_RATE_LIMITER_H
@@ -0,0 +1,248 @@
+#include "response_compression.h"
+#include <cstdlib>
+#include <strings.h>
+#include <zlib.h>
+#ifdef GARA_BROTLI_SUPPORT
+#include <brotli/encode.h>
+#endif
+#ifdef GARA_ZSTD_SUPPORT
+#include <zstd.h>
+#endif
+
+namespace gara {
+namespace utils {
+
+namespace {
+
+std::string_view trim(std::string_view value) {
+    const char* whitespace = " \t";
+    size_t first = value.find_first_not_of(whitespace);
+    if (first == std::string_view::npos) {
+        return {};
+    }
+    size_t last = value.find_last_not_of(whitespace);
+    return value.substr(first, last - first + 1);
+}
+
+bool equalsIgnoreCase(std::string_view a, const char* b) {
+    std::string_view other(b);
+    return a.size() == other.size() && strncasecmp(a.data(), b, a.size()) == 0;
+}
+
+// Quality from a coding's parameters ("q=0.5"); 1 when absent
+double parseQuality(std::string_view params) {
+    while (!params.empty()) {
+        size_t end = params.find(';');
+        std::string_view param = trim(params.substr(0, end));
+        if (param.size() > 2 && (param[0] == 'q' || param[0] == 'Q') && param[1] == '=') {
+            std::string value(param.substr(2));
+            return std::strtod(value.c_str(), nullptr);
+        }
+        if (end == std::string_view::npos) {
+            break;
+        }
+        params.remove_prefix(end + 1);
+    }
+    return 1.0;
+}
+
+// Per-thread deflate stream, rebuilt only when the level changes
+struct GzipStream {
+    z_stream stream{};
+    int level = -1;
+
+    ~GzipStream() {
+        if (level >= 0) {
+            deflateEnd(&stream);
+        }
+    }
+
+    bool prepare(int wanted_level) {
+        if (level == wanted_level) {
+            return deflateReset(&stream) == Z_OK;
+        }
+        if (level >= 0) {
+            deflateEnd(&stream);
+            level = -1;
+        }
+        stream = z_stream{};
+        // 15 + 16: largest window, gzip wrapper
+        if (deflateInit2(&stream, wanted_level, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+            return false;
+        }
+        level = wanted_level;
+        return true;
+    }
+};
+
+#ifdef GARA_ZSTD_SUPPORT
+struct ZstdContext {
+    ZSTD_CCtx* ctx = ZSTD_createCCtx();
+    ~ZstdContext() { ZSTD_freeCCtx(ctx); }
+};
+#endif
+
+} // anonymous namespace
+
+ResponseCompressor::ResponseCompressor(const CompressionConfig& config) : config_(config) {}
+
+bool ResponseCompressor::isSupported(ContentEncoding encoding) {
+    switch (encoding) {
+        case ContentEncoding::GZIP:
+            return true;
+        case ContentEncoding::BROTLI:
+#ifdef GARA_BROTLI_SUPPORT
+            return true;
+#else
+            return false;
+#endif
+        case ContentEncoding::ZSTD:
+#ifdef GARA_ZSTD_SUPPORT
+            return true;
+#else
+            return false;
+#endif
+        default:
+            return false;
+    }
+}
+
+const char* ResponseCompressor::token(ContentEncoding encoding) {
+    switch (encoding) {
+        case ContentEncoding::GZIP: return "gzip";
+        case ContentEncoding::BROTLI: return "br";
+        case ContentEncoding::ZSTD: return "zstd";
+        default: return "identity";
+    }
+}
+
+ContentEncoding ResponseCompressor::negotiate(std::string_view accept_encoding) const {
+    if (!config_.enabled || accept_encoding.empty()) {
+        return ContentEncoding::IDENTITY;
+    }
+
+    // Server preference order, used to break ties
+    static constexpr ContentEncoding candidates[] = {
+        ContentEncoding::ZSTD, ContentEncoding::BROTLI, ContentEncoding::GZIP
+    };
+    double quality[3] = {-1.0, -1.0, -1.0};  // -1: not named
+    double wildcard = -1.0;
+
+    while (!accept_encoding.empty()) {
+        size_t end = accept_encoding.find(',');
+        std::string_view entry = trim(accept_encoding.substr(0, end));
+        size_t semicolon = entry.find(';');
+        std::string_view coding = trim(entry.substr(0, semicolon));
+        double q = semicolon == std::string_view::npos ? 1.0 : parseQuality(entry.substr(semicolon + 1));
+
+        if (coding == "*") {
+            wildcard = q;
+        } else {
+            for (size_t i = 0; i < 3; ++i) {
+                if (equalsIgnoreCase(coding, token(candidates[i])) ||
+                    (candidates[i] == ContentEncoding::GZIP && equalsIgnoreCase(coding, "x-gzip"))) {
+                    quality[i] = q;
+                }
+            }
+        }
+
+        if (end == std::string_view::npos) {
+            break;
+        }
+        accept_encoding.remove_prefix(end + 1);
+    }
+
+    ContentEncoding best = ContentEncoding::IDENTITY;
+    double best_quality = 0.0;
+    for (size_t i = 0; i < 3; ++i) {
+        double q = quality[i] >= 0.0 ? quality[i] : wildcard;
+        if (q > best_quality && isSupported(candidates[i])) {
+            best = candidates[i];
+            best_quality = q;
+        }
+    }
+    return best;
+}
+
+std::optional<std::string> ResponseCompressor::compress(std::string_view body, ContentEncoding encoding) const {
+    if (body.size() < config_.min_bytes) {
+        return std::nullopt;
+    }
+
+    std::optional<std::string> encoded;
+    switch (encoding) {
+        case ContentEncoding::GZIP: encoded = gzip(body); break;
+        case ContentEncoding::BROTLI: encoded = brotli(body); break;
+        case ContentEncoding::ZSTD: encoded = zstd(body); break;
+        default: break;
+    }
+
+    if (encoded && encoded->size() >= body.size()) {
+        return std::nullopt;
+    }
+    return encoded;
+}
+
+std::optional<std::string> ResponseCompressor::gzip(std::string_view body) const {
+    thread_local GzipStream gzip_stream;
+    if (!gzip_stream.prepare(config_.gzip_level)) {
+        return std::nullopt;
+    }
+
+    z_stream& stream = gzip_stream.stream;
+    std::string out(deflateBound(&stream, body.size()), '\0');
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(body.data()));
+    stream.avail_in = static_cast<uInt>(body.size());
+    stream.next_out = reinterpret_cast<Bytef*>(&out[0]);
+    stream.avail_out = static_cast<uInt>(out.size());
+
+    // deflateBound leaves room to finish in one call
+    if (deflate(&stream, Z_FINISH) != Z_STREAM_END) {
+        return std::nullopt;
+    }
+    out.resize(stream.total_out);
+    return out;
+}
+
+std::optional<std::string> ResponseCompressor::brotli(std::string_view body) const {
+#ifdef GARA_BROTLI_SUPPORT
+    size_t size = BrotliEncoderMaxCompressedSize(body.size());
+    if (size == 0) {
+        return std::nullopt;
+    }
+    std::string out(size, '\0');
+    if (!BrotliEncoderCompress(config_.brotli_quality, BROTLI_DEFAULT_WINDOW, BROTLI_MODE_TEXT,
+                               body.size(), reinterpret_cast<const uint8_t*>(body.data()),
+                               &size, reinterpret_cast<uint8_t*>(&out[0]))) {
+        return std::nullopt;
+    }
+    out.resize(size);
+    return out;
+#else
+    (void)body;
+    return std::nullopt;
+#endif
+}
+
+std::optional<std::string> ResponseCompressor::zstd(std::string_view body) const {
+#ifdef GARA_ZSTD_SUPPORT
+    thread_local ZstdContext context;
+    if (context.ctx == nullptr) {
+        return std::nullopt;
+    }
+    std::string out(ZSTD_compressBound(body.size()), '\0');
+    size_t size = ZSTD_compressCCtx(context.ctx, &out[0], out.size(), body.data(), body.size(),
+                                    config_.zstd_level);
+    if (ZSTD_isError(size)) {
+        return std::nullopt;
+    }
+    out.resize(size);
+    return out;
+#else
+    (void)body;
+    return std::nullopt;
+#endif
+}
+
+} // namespace utils
+} // namespace gara
@@ -0,0 +1,65 @@
+#ifndef GARA_UTILS_RESPONSE_COMPRESSION_H
+#define GARA_UTILS_RESPONSE_COMPRESSION_H
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include "../models/compression_config.h"
+
+namespace gara {
+namespace utils {
+
+enum class ContentEncoding {
+    IDENTITY,
+    GZIP,
+    BROTLI,
+    ZSTD
+};
+
+/**
+ * @brief Content-coding negotiation and compression for response bodies
+ *
+ * gzip is always available. Brotli and zstd are compiled in when their
+ * libraries are found (GARA_BROTLI_SUPPORT, GARA_ZSTD_SUPPORT). Each thread
+ * keeps its own encoder state, so steady-state compression does not
+ * reallocate compressor windows per response.
+ */
+class ResponseCompressor {
+public:
+    explicit ResponseCompressor(const CompressionConfig& config = CompressionConfig());
+
+    const CompressionConfig& config() const { return config_; }
+
+    /**
+     * @brief Pick the coding for an Accept-Encoding header value
+     *
+     * The client's highest q-value wins. Ties go to zstd, then br, then
+     * gzip. Codings with q=0 or not compiled in are never chosen, and "*"
+     * covers codings the header does not name.
+     */
+    ContentEncoding negotiate(std::string_view accept_encoding) const;
+
+    /**
+     * @brief Compress a body
+     * @return Encoded body, or nullopt below min_bytes, on failure, or when
+     *         the result would not be smaller
+     */
+    std::optional<std::string> compress(std::string_view body, ContentEncoding encoding) const;
+
+    // Content-Encoding token ("gzip", "br", "zstd"; "identity" otherwise)
+    static const char* token(ContentEncoding encoding);
+
+    static bool isSupported(ContentEncoding encoding);
+
+private:
+    std::optional<std::string> gzip(std::string_view body) const;
+    std::optional<std::string> brotli(std::string_view body) const;
+    std::optional<std::string> zstd(std::string_view body) const;
+
+    CompressionConfig config_;
+};
+
+} // namespace utils
+} // namespace gara
+
+#endif // GARA_UTILS_RESPONSE_COMPRESSION_H
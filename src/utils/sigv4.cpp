@@ -0,0 +1,154 @@
+#include "sigv4.h"
+#include "file_utils.h"
+#include <openssl/evp.h>
+#include <openssl/hmac.h>
+#include <cstdio>
+#include <sstream>
+
+namespace gara {
+namespace utils {
+
+namespace {
+
+std::string toHex(const std::string& bytes) {
+    static const char digits[] = "0123456789abcdef";
+    std::string hex;
+    hex.reserve(bytes.size() * 2);
+    for (unsigned char c : bytes) {
+        hex += digits[c >> 4];
+        hex += digits[c & 0x0f];
+    }
+    return hex;
+}
+
+} // anonymous namespace
+
+std::string SigV4::uriEncode(const std::string& value, bool encode_slash) {
+    static const char digits[] = "0123456789ABCDEF";
+    std::string encoded;
+    encoded.reserve(value.size());
+    for (unsigned char c : value) {
+        bool unreserved = (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') ||
+                          c == '-' || c == '_' || c == '.' || c == '~';
+        if (unreserved || (c == '/' && !encode_slash)) {
+            encoded += static_cast<char>(c);
+        } else {
+            encoded += '%';
+            encoded += digits[c >> 4];
+            encoded += digits[c & 0x0f];
+        }
+    }
+    return encoded;
+}
+
+std::string SigV4::canonicalQuery(const Params& query) {
+    // Params is ordered by name, which is the order SigV4 requires
+    std::string canonical;
+    for (const auto& [name, value] : query) {
+        if (!canonical.empty()) {
+            canonical += '&';
+        }
+        canonical += uriEncode(name);
+        canonical += '=';
+        canonical += uriEncode(value);
+    }
+    return canonical;
+}
+
+std::string SigV4::amzDate(std::time_t time) {
+    std::tm utc{};
+    gmtime_r(&time, &utc);
+    char buffer[17];
+    std::strftime(buffer, sizeof(buffer), "%Y%m%dT%H%M%SZ", &utc);
+    return buffer;
+}
+
+std::string SigV4::sha256Hex(const char* data, size_t size) {
+    Sha256Hasher hasher;
+    hasher.update(data, size);
+    return hasher.finalizeHex();
+}
+
+std::string SigV4::hmac(const std::string& key, const std::string& data) {
+    unsigned char digest[EVP_MAX_MD_SIZE];
+    unsigned int length = 0;
+    HMAC(EVP_sha256(), key.data(), static_cast<int>(key.size()),
+         reinterpret_cast<const unsigned char*>(data.data()), data.size(), digest, &length);
+    return std::string(reinterpret_cast<const char*>(digest), length);
+}
+
+std::string SigV4::scope(const std::string& amz_date, const std::string& region, const std::string& service) {
+    return amz_date.substr(0, 8) + "/" + region + "/" + service + "/aws4_request";
+}
+
+std::string SigV4::signature(const std::string& canonical_request,
+                             const AwsCredentials& credentials,
+                             const std::string& region,
+                             const std::string& amz_date,
+                             const std::string& service) {
+    std::string string_to_sign = "AWS4-HMAC-SHA256\n" + amz_date + "\n" +
+                                 scope(amz_date, region, service) + "\n" +
+                                 sha256Hex(canonical_request.data(), canonical_request.size());
+
+    std::string key = hmac("AWS4" + credentials.secret_access_key, amz_date.substr(0, 8));
+    key = hmac(key, region);
+    key = hmac(key, service);
+    key = hmac(key, "aws4_request");
+    return toHex(hmac(key, string_to_sign));
+}
+
+std::string SigV4::authorization(const std::string& method,
+                                 const std::string& canonical_uri,
+                                 const Params& query,
+                                 const Params& headers,
+                                 const std::string& payload_hash,
+                                 const AwsCredentials& credentials,
+                                 const std::string& region,
+                                 const std::string& amz_date,
+                                 const std::string& service) {
+    std::string canonical_headers;
+    std::string signed_headers;
+    for (const auto& [name, value] : headers) {
+        canonical_headers += name + ":" + value + "\n";
+        if (!signed_headers.empty()) {
+            signed_headers += ';';
+        }
+        signed_headers += name;
+    }
+
+    std::string canonical_request = method + "\n" + canonical_uri + "\n" + canonicalQuery(query) + "\n" +
+                                    canonical_headers + "\n" + signed_headers + "\n" + payload_hash;
+
+    return "AWS4-HMAC-SHA256 Credential=" + credentials.access_key_id + "/" + scope(amz_date, region, service) +
+           ",SignedHeaders=" + signed_headers +
+           ",Signature=" + signature(canonical_request, credentials, region, amz_date, service);
+}
+
+std::string SigV4::presignQuery(const std::string& method,
+                                const std::string& host,
+                                const std::string& canonical_uri,
+                                const AwsCredentials& credentials,
+                                const std::string& region,
+                                const std::string& amz_date,
+                                int expires_seconds,
+                                const std::string& service) {
+    Params query = {
+        {"X-Amz-Algorithm", "AWS4-HMAC-SHA256"},
+        {"X-Amz-Credential", credentials.access_key_id + "/" + scope(amz_date, region, service)},
+        {"X-Amz-Date", amz_date},
+        {"X-Amz-Expires", std::to_string(expires_seconds)},
+        {"X-Amz-SignedHeaders", "host"}
+    };
+    if (!credentials.session_token.empty()) {
+        query["X-Amz-Security-Token"] = credentials.session_token;
+    }
+
+    std::string canonical_request = method + "\n" + canonical_uri + "\n" + canonicalQuery(query) + "\n" +
+                                    "host:" + host + "\n\nhost\n" + UNSIGNED_PAYLOAD;
+
+    return canonicalQuery(query) + "&X-Amz-Signature=" +
+           signature(canonical_request, credentials, region, amz_date, service);
+}
+
+} // namespace utils
+} // namespace gara
@@ -0,0 +1,98 @@
+#ifndef GARA_UTILS_SIGV4_H
+#define GARA_UTILS_SIGV4_H
+
+#include <ctime>
+#include <map>
+#include <string>
+
+namespace gara {
+namespace utils {
+
+struct AwsCredentials {
+    std::string access_key_id;
+    std::string secret_access_key;
+    std::string session_token;  // Only for temporary credentials
+};
+
+/**
+ * @brief AWS Signature Version 4 signing, computed locally
+ *
+ * Header maps use lowercase names. Canonical URIs are passed already
+ * URI-encoded, as S3 expects them (each path segment encoded once).
+ *
+ * Reference: https://docs.aws.amazon.com/AmazonS3/latest/API/sig-v4-authenticating-requests.html
+ */
+class SigV4 {
+public:
+    using Params = std::map<std::string, std::string>;
+
+    // x-amz-content-sha256 values
+    static constexpr const char* UNSIGNED_PAYLOAD = "UNSIGNED-PAYLOAD";
+    static constexpr const char* EMPTY_PAYLOAD_HASH =
+        "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855";
+
+    /**
+     * @brief Percent-encode everything except unreserved characters
+     * @param encode_slash false for object key paths, where '/' stays literal
+     */
+    static std::string uriEncode(const std::string& value, bool encode_slash = true);
+
+    /**
+     * @brief Sorted, encoded query string used both on the wire and when signing
+     */
+    static std::string canonicalQuery(const Params& query);
+
+    /**
+     * @brief ISO 8601 basic UTC timestamp (e.g. 20130524T000000Z)
+     */
+    static std::string amzDate(std::time_t time);
+
+    /**
+     * @brief Lowercase hex SHA256 of a payload
+     */
+    static std::string sha256Hex(const char* data, size_t size);
+
+    /**
+     * @brief Authorization header value for a request
+     *
+     * headers must contain every header to sign, including host,
+     * x-amz-date and x-amz-content-sha256.
+     */
+    static std::string authorization(const std::string& method,
+                                     const std::string& canonical_uri,
+                                     const Params& query,
+                                     const Params& headers,
+                                     const std::string& payload_hash,
+                                     const AwsCredentials& credentials,
+                                     const std::string& region,
+                                     const std::string& amz_date,
+                                     const std::string& service = "s3");
+
+    /**
+     * @brief Query string for a presigned URL (host is the only signed header)
+     *
+     * @return Canonical query including X-Amz-Signature, without the leading '?'
+     */
+    static std::string presignQuery(const std::string& method,
+                                    const std::string& host,
+                                    const std::string& canonical_uri,
+                                    const AwsCredentials& credentials,
+                                    const std::string& region,
+                                    const std::string& amz_date,
+                                    int expires_seconds,
+                                    const std::string& service = "s3");
+
+private:
+    static std::string hmac(const std::string& key, const std::string& data);
+    static std::string signature(const std::string& canonical_request,
+                                 const AwsCredentials& credentials,
+                                 const std::string& region,
+                                 const std::string& amz_date,
+                                 const std::string& service);
+    static std::string scope(const std::string& amz_date, const std::string& region, const std::string& service);
+};
+
+} // namespace utils
+} // namespace gara
+
+#endif // GARA_UTILS_SIGV4_H
@@ -0,0 +1,131 @@
+#ifndef GARA_UTILS_SINGLE_FLIGHT_H
+#define GARA_UTILS_SINGLE_FLIGHT_H
+
+#include "metrics.h"
+#include <chrono>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+namespace gara {
+namespace utils {
+
+/**
+ * @brief Coalesces concurrent calls that share a key into a single execution
+ *
+ * The first caller for a key (the leader) runs the work; callers arriving
+ * while it is in flight wait for the leader's result instead of repeating
+ * the work. Exceptions thrown by the leader are rethrown to every waiter.
+ *
+ * Publishes "SingleFlightCalls" counts (role=leader|coalesced|timeout) and a
+ * "SingleFlightInFlight" gauge, both dimensioned by the table name.
+ */
+template<typename Result>
+class SingleFlight {
+public:
+    /**
+     * @param name Name used as the "table" metrics dimension
+     * @param wait_timeout How long a waiter blocks before giving up
+     */
+    SingleFlight(std::string name, std::chrono::milliseconds wait_timeout)
+        : name_(std::move(name)), wait_timeout_(wait_timeout) {}
+
+    SingleFlight(const SingleFlight&) = delete;
+    SingleFlight& operator=(const SingleFlight&) = delete;
+
+    /**
+     * @brief Run work for key, or wait for the in-flight call with the same key
+     *
+     * @param key Coalescing key
+     * @param work Work to run if no call for key is in flight
+     * @return Result of the work, or std::nullopt if waiting timed out
+     */
+    std::optional<Result> run(const std::string& key, const std::function<Result()>& work) {
+        return execute(key, work, true);
+    }
+
+    /**
+     * @brief Run work for key unless a call with the same key is already in flight
+     *
+     * For background work that should never block behind another caller.
+     *
+     * @param key Coalescing key
+     * @param work Work to run if no call for key is in flight
+     * @return Result of the work, or std::nullopt if another call holds the key
+     */
+    std::optional<Result> tryRun(const std::string& key, const std::function<Result()>& work) {
+        return execute(key, work, false);
+    }
+
+    /**
+     * @brief Number of keys currently being worked on
+     */
+    size_t inFlight() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return calls_.size();
+    }
+
+private:
+    std::optional<Result> execute(const std::string& key, const std::function<Result()>& work, bool wait) {
+        std::shared_future<Result> pending;
+        std::promise<Result> promise;
+        size_t in_flight = 0;
+        bool leader = false;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = calls_.find(key);
+            if (it != calls_.end()) {
+                pending = it->second;
+            } else {
+                leader = true;
+                calls_.emplace(key, promise.get_future().share());
+                in_flight = calls_.size();
+            }
+        }
+
+        if (!leader) {
+            if (!wait) {
+                return std::nullopt;
+            }
+            if (pending.wait_for(wait_timeout_) != std::future_status::ready) {
+                METRICS_COUNT("SingleFlightCalls", 1.0, "Count", {{"table", name_}, {"role", "timeout"}});
+                return std::nullopt;
+            }
+            METRICS_COUNT("SingleFlightCalls", 1.0, "Count", {{"table", name_}, {"role", "coalesced"}});
+            return pending.get();
+        }
+
+        METRICS_COUNT("SingleFlightCalls", 1.0, "Count", {{"table", name_}, {"role", "leader"}});
+        METRICS_GAUGE("SingleFlightInFlight", static_cast<double>(in_flight), "Count", {{"table", name_}});
+
+        try {
+            Result result = work();
+            promise.set_value(result);
+            finish(key);
+            return result;
+        } catch (...) {
+            promise.set_exception(std::current_exception());
+            finish(key);
+            throw;
+        }
+    }
+
+    void finish(const std::string& key) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        calls_.erase(key);
+    }
+
+    std::string name_;
+    std::chrono::milliseconds wait_timeout_;
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, std::shared_future<Result>> calls_;
+};
+
+} // namespace utils
+} // namespace gara
+
+#endif // GARA_UTILS_SINGLE_FLIGHT_H
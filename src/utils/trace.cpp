@@ -0,0 +1,202 @@
+#include "trace.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <random>
+
+namespace gara {
+namespace utils {
+
+namespace {
+
+thread_local std::shared_ptr<RequestTrace> current_trace;
+
+std::mt19937_64& randomEngine() {
+    thread_local std::mt19937_64 engine(std::random_device{}());
+    return engine;
+}
+
+bool isHex(const std::string& value, size_t length) {
+    if (value.size() != length) {
+        return false;
+    }
+    return std::all_of(value.begin(), value.end(), [](char c) {
+        return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f');
+    });
+}
+
+bool isAllZeros(const std::string& value) {
+    return value.find_first_not_of('0') == std::string::npos;
+}
+
+// Trace id carried by a UUID request id ("<timestamp>_<uuid>" or a bare UUID)
+std::string traceIdFromRequestId(const std::string& request_id) {
+    size_t underscore = request_id.rfind('_');
+    std::string tail = underscore == std::string::npos ? request_id : request_id.substr(underscore + 1);
+    std::string hex;
+    hex.reserve(32);
+    for (char c : tail) {
+        if (c == '-') {
+            continue;
+        }
+        hex += static_cast<char>(c >= 'A' && c <= 'F' ? c - 'A' + 'a' : c);
+    }
+    if (!isHex(hex, 32) || isAllZeros(hex)) {
+        return "";
+    }
+    return hex;
+}
+
+} // anonymous namespace
+
+RequestTrace::RequestTrace(const std::string& traceparent, const std::string& request_id, double sample_ratio)
+    : span_id_(randomHex(16)),
+      request_id_(request_id),
+      sampled_(false),
+      start_(Clock::now()),
+      end_(start_),
+      wall_start_(std::chrono::system_clock::now()) {
+    bool parent_sampled = false;
+    if (parseTraceparent(traceparent, trace_id_, parent_span_id_, parent_sampled)) {
+        // Follow the caller's sampling decision so traces are never half-exported
+        sampled_ = parent_sampled;
+        return;
+    }
+
+    trace_id_ = traceIdFromRequestId(request_id);
+    if (trace_id_.empty()) {
+        trace_id_ = randomHex(32);
+    }
+    if (sample_ratio >= 1.0) {
+        sampled_ = true;
+    } else if (sample_ratio > 0.0) {
+        sampled_ = std::uniform_real_distribution<double>(0.0, 1.0)(randomEngine()) < sample_ratio;
+    }
+}
+
+void RequestTrace::addSpan(const char* name, Clock::time_point start, Clock::time_point end) {
+    std::string span_id = sampled_ ? randomHex(16) : std::string();
+    std::lock_guard<std::mutex> lock(mutex_);
+    spans_.push_back({name, std::move(span_id), start, end});
+}
+
+void RequestTrace::finish(const std::string& method, const std::string& route, int status) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    end_ = Clock::now();
+    method_ = method;
+    route_ = route;
+    status_ = status;
+}
+
+std::string RequestTrace::serverTiming() const {
+    std::vector<std::pair<const char*, double>> totals;
+    Clock::time_point end;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& span : spans_) {
+            double ms = std::chrono::duration<double, std::milli>(span.end - span.start).count();
+            auto it = std::find_if(totals.begin(), totals.end(), [&span](const auto& entry) {
+                return std::strcmp(entry.first, span.name) == 0;
+            });
+            if (it == totals.end()) {
+                totals.emplace_back(span.name, ms);
+            } else {
+                it->second += ms;
+            }
+        }
+        end = end_ > start_ ? end_ : Clock::now();
+    }
+    totals.emplace_back("total", std::chrono::duration<double, std::milli>(end - start_).count());
+
+    std::string header;
+    char buffer[64];
+    for (const auto& [name, ms] : totals) {
+        if (!header.empty()) {
+            header += ", ";
+        }
+        std::snprintf(buffer, sizeof(buffer), ";dur=%.1f", ms);
+        header += name;
+        header += buffer;
+    }
+    return header;
+}
+
+std::string RequestTrace::traceparent() const {
+    return "00-" + trace_id_ + "-" + span_id_ + (sampled_ ? "-01" : "-00");
+}
+
+std::vector<RequestTrace::Span> RequestTrace::spans() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return spans_;
+}
+
+uint64_t RequestTrace::unixNanos(Clock::time_point point) const {
+    auto wall = wall_start_ + std::chrono::duration_cast<std::chrono::system_clock::duration>(point - start_);
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(wall.time_since_epoch()).count());
+}
+
+bool RequestTrace::parseTraceparent(const std::string& header, std::string& trace_id,
+                                    std::string& span_id, bool& sampled) {
+    // version(2) - trace-id(32) - parent-id(16) - flags(2)
+    if (header.size() < 55 || header[2] != '-' || header[35] != '-' || header[52] != '-') {
+        return false;
+    }
+    std::string version = header.substr(0, 2);
+    if (!isHex(version, 2) || version == "ff" || (version == "00" && header.size() != 55)) {
+        return false;
+    }
+    std::string parsed_trace = header.substr(3, 32);
+    std::string parsed_span = header.substr(36, 16);
+    std::string flags = header.substr(53, 2);
+    if (!isHex(parsed_trace, 32) || !isHex(parsed_span, 16) || !isHex(flags, 2) ||
+        isAllZeros(parsed_trace) || isAllZeros(parsed_span)) {
+        return false;
+    }
+
+    trace_id = parsed_trace;
+    span_id = parsed_span;
+    sampled = (std::stoi(flags, nullptr, 16) & 0x01) != 0;
+    return true;
+}
+
+std::string RequestTrace::randomHex(size_t length) {
+    static const char digits[] = "0123456789abcdef";
+    std::string hex(length, '0');
+    auto& engine = randomEngine();
+    do {
+        uint64_t bits = 0;
+        for (size_t i = 0; i < length; ++i) {
+            if (i % 16 == 0) {
+                bits = engine();
+            }
+            hex[i] = digits[bits & 0x0F];
+            bits >>= 4;
+        }
+    } while (isAllZeros(hex));
+    return hex;
+}
+
+RequestTrace* RequestTrace::active() {
+    return current_trace.get();
+}
+
+std::shared_ptr<RequestTrace> RequestTrace::current() {
+    return current_trace;
+}
+
+void RequestTrace::setCurrent(std::shared_ptr<RequestTrace> trace) {
+    current_trace = std::move(trace);
+}
+
+RequestTrace::Scope::Scope(std::shared_ptr<RequestTrace> trace)
+    : previous_(std::move(current_trace)) {
+    current_trace = std::move(trace);
+}
+
+RequestTrace::Scope::~Scope() {
+    current_trace = std::move(previous_);
+}
+
+} // namespace utils
+} // namespace gara
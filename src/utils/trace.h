@@ -0,0 +1,167 @@
+#ifndef GARA_UTILS_TRACE_H
+#define GARA_UTILS_TRACE_H
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace gara {
+namespace utils {
+
+/**
+ * @brief Per-request span recorder behind Server-Timing and OTLP export
+ *
+ * One trace is created per HTTP request and installed as the calling
+ * thread's current trace; stages record themselves with TRACE_SPAN. Work
+ * handed to another thread (transform workers) carries the trace along with
+ * a Scope. Spans are flat children of the request's root span and may be
+ * added from several threads at once.
+ *
+ * The trace id comes from an incoming W3C traceparent header, else from an
+ * X-Request-ID that holds a UUID, else it is random.
+ */
+class RequestTrace {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Span {
+        const char* name;  // Static string; stage names are a fixed vocabulary
+        std::string span_id;
+        Clock::time_point start;
+        Clock::time_point end;
+    };
+
+    /**
+     * @param traceparent Incoming traceparent header (may be empty or invalid)
+     * @param request_id  Request id; a UUID in it seeds the trace id when no traceparent is given
+     * @param sample_ratio Export probability for traces without a sampled parent
+     */
+    RequestTrace(const std::string& traceparent, const std::string& request_id, double sample_ratio);
+
+    RequestTrace(const RequestTrace&) = delete;
+    RequestTrace& operator=(const RequestTrace&) = delete;
+
+    void addSpan(const char* name, Clock::time_point start, Clock::time_point end);
+
+    // Closes the root span; the attributes land on it when exported
+    void finish(const std::string& method, const std::string& route, int status);
+
+    /**
+     * @brief Server-Timing header value: per-stage totals in ms, then "total"
+     *
+     * Repeated stages (one encode per rendition) are summed under one entry,
+     * listed in the order they were first recorded.
+     */
+    std::string serverTiming() const;
+
+    // traceparent for the response, naming this request's root span
+    std::string traceparent() const;
+
+    std::vector<Span> spans() const;
+
+    const std::string& traceId() const { return trace_id_; }
+    const std::string& spanId() const { return span_id_; }
+    const std::string& parentSpanId() const { return parent_span_id_; }
+    const std::string& requestId() const { return request_id_; }
+    bool sampled() const { return sampled_; }
+
+    const std::string& method() const { return method_; }
+    const std::string& route() const { return route_; }
+    int status() const { return status_; }
+    Clock::time_point start() const { return start_; }
+    Clock::time_point end() const { return end_; }
+
+    // Wall-clock nanoseconds since the epoch for a point on the steady clock
+    uint64_t unixNanos(Clock::time_point point) const;
+
+    /**
+     * @brief Parse "00-<32 hex trace id>-<16 hex span id>-<2 hex flags>"
+     * @return false for malformed headers and all-zero ids
+     */
+    static bool parseTraceparent(const std::string& header, std::string& trace_id,
+                                 std::string& span_id, bool& sampled);
+
+    // Random lowercase hex of the given length, never all zeros
+    static std::string randomHex(size_t length);
+
+    // The calling thread's trace, or nullptr outside a traced request
+    static RequestTrace* active();
+    static std::shared_ptr<RequestTrace> current();
+    static void setCurrent(std::shared_ptr<RequestTrace> trace);
+
+    /**
+     * @brief Installs a trace on this thread for the enclosing scope
+     */
+    class Scope {
+    public:
+        explicit Scope(std::shared_ptr<RequestTrace> trace);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        std::shared_ptr<RequestTrace> previous_;
+    };
+
+private:
+    std::string trace_id_;
+    std::string span_id_;
+    std::string parent_span_id_;
+    std::string request_id_;
+    bool sampled_;
+
+    Clock::time_point start_;
+    Clock::time_point end_;
+    std::chrono::system_clock::time_point wall_start_;
+    std::string method_;
+    std::string route_;
+    int status_ = 0;
+
+    mutable std::mutex mutex_;
+    std::vector<Span> spans_;
+};
+
+/**
+ * @brief Records the enclosing scope as a span of the current trace
+ *
+ * Costs one thread-local read when no request is being traced.
+ */
+class ScopedSpan {
+public:
+    explicit ScopedSpan(const char* name)
+        : trace_(RequestTrace::active()), name_(name) {
+        if (trace_) {
+            start_ = RequestTrace::Clock::now();
+        }
+    }
+
+    ~ScopedSpan() {
+        if (trace_) {
+            trace_->addSpan(name_, start_, RequestTrace::Clock::now());
+        }
+    }
+
+    ScopedSpan(const ScopedSpan&) = delete;
+    ScopedSpan& operator=(const ScopedSpan&) = delete;
+
+private:
+    RequestTrace* trace_;
+    const char* name_;
+    RequestTrace::Clock::time_point start_;
+};
+
+} // namespace utils
+} // namespace gara
+
+#define GARA_TRACE_CONCAT_INNER(a, b) a##b
+#define GARA_TRACE_CONCAT(a, b) GARA_TRACE_CONCAT_INNER(a, b)
+
+// Times the enclosing scope as a stage of the current request
+#define TRACE_SPAN(name) \
+    gara::utils::ScopedSpan GARA_TRACE_CONCAT(_trace_span_, __LINE__)(name)
+
+#endif // GARA_UTILS_TRACE_H
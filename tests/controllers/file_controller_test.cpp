@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+#include "controllers/file_controller.h"
+#include "services/local_file_service.h"
+#include "test_helpers/test_file_manager.h"
+#include "utils/logger.h"
+#include "utils/metrics.h"
+#include <filesystem>
+#include <fstream>
+#include <sys/stat.h>
+
+using namespace gara;
+using namespace gara::test_helpers;
+
+class FileControllerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        gara::Logger::initialize("gara-test", "error", gara::Logger::Format::TEXT, "test");
+        gara::Metrics::initialize("GaraTest", "gara-test", "test", false);
+
+        storage_path_ = TestFileManager::createUniquePath("file_controller_", "");
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(storage_path_);
+    }
+
+    std::string storage_path_;
+};
+
+// ============================================================================
+// ETag Tests
+// ============================================================================
+
+TEST_F(FileControllerTest, ComputeETag_ContentAddressedKey_StrongTagFromHash) {
+    EXPECT_EQ("\"abc123\"", FileController::computeETag("raw/abc123.jpg", 10, 1));
+    EXPECT_EQ("\"abc123_webp_320x0_wm\"",
+              FileController::computeETag("transformed/abc123_webp_320x0_wm.webp", 10, 1));
+}
+
+TEST_F(FileControllerTest, ComputeETag_OtherKey_WeakTagChangesWithFile) {
+    std::string before = FileController::computeETag("fonts/custom.ttf", 10, 1);
+    std::string after = FileController::computeETag("fonts/custom.ttf", 10, 2);
+
+    EXPECT_EQ(0u, before.rfind("W/", 0));
+    EXPECT_NE(before, after);
+}
+
+TEST_F(FileControllerTest, IsContentAddressed_OnlyRawAndTransformedPrefixes) {
+    EXPECT_TRUE(FileController::isContentAddressed("raw/abc.jpg"));
+    EXPECT_TRUE(FileController::isContentAddressed("transformed/abc_jpeg_0x0.jpeg"));
+    EXPECT_FALSE(FileController::isContentAddressed("rawfile.jpg"));
+}
+
+// ============================================================================
+// Key Resolution Tests
+// ============================================================================
+
+TEST_F(FileControllerTest, ResolveServablePath_TraversalKeys_Rejected) {
+    // Arrange
+    LocalFileService file_service(storage_path_);
+
+    // Act & Assert
+    EXPECT_TRUE(file_service.resolveServablePath("../etc/passwd").empty());
+    EXPECT_TRUE(file_service.resolveServablePath("raw/../../secret").empty());
+    EXPECT_TRUE(file_service.resolveServablePath("/etc/passwd").empty());
+    EXPECT_TRUE(file_service.resolveServablePath("").empty());
+    EXPECT_FALSE(file_service.resolveServablePath("raw/abc.jpg").empty());
+}
+
+TEST_F(FileControllerTest, MapObject_StoredKey_ReadsInPlace) {
+    // Arrange
+    LocalFileService file_service(storage_path_);
+    std::vector<char> data = {'r', 'a', 'w'};
+    ASSERT_TRUE(file_service.uploadData(data, "raw/abc.jpg"));
+
+    // Act
+    auto mapped = file_service.mapObject("raw/abc.jpg");
+
+    // Assert
+    ASSERT_NE(mapped, nullptr);
+    EXPECT_EQ(std::string(mapped->data(), mapped->size()), "raw");
+}
+
+TEST_F(FileControllerTest, MapObject_TraversalOrMissingKey_ReturnsNull) {
+    LocalFileService file_service(storage_path_);
+
+    EXPECT_EQ(file_service.mapObject("../etc/passwd"), nullptr);
+    EXPECT_EQ(file_service.mapObject("raw/missing.jpg"), nullptr);
+}
+
+TEST_F(FileControllerTest, MoveFileToStorage_PrivateTempFile_StoredWithUmaskMode) {
+    // Arrange - a source file as private as mkstemp leaves it
+    LocalFileService file_service(storage_path_);
+    std::string source = TestFileManager::createUniquePath("file_controller_src_", ".jpg");
+    std::ofstream(source, std::ios::binary) << "raw";
+    std::filesystem::permissions(source, std::filesystem::perms::owner_read | std::filesystem::perms::owner_write);
+    mode_t mask = ::umask(0);
+    ::umask(mask);
+
+    // Act
+    ASSERT_TRUE(file_service.moveFileToStorage(source, "raw/abc.jpg"));
+
+    // Assert
+    auto perms = std::filesystem::status(file_service.resolveServablePath("raw/abc.jpg")).permissions();
+    EXPECT_EQ(static_cast<std::filesystem::perms>(0644 & ~mask), perms & std::filesystem::perms::all)
+        << "Stored files should not keep the temp file's 0600 mode";
+}
+
+TEST_F(FileControllerTest, GeneratePresignedUrl_WithBaseUrl_PointsAtFilesRoute) {
+    // Arrange
+    LocalFileService file_service(storage_path_, "http://localhost:8080/");
+
+    // Act
+    std::string url = file_service.generatePresignedUrl("raw/abc.jpg");
+
+    // Assert
+    EXPECT_EQ("http://localhost:8080/files/raw/abc.jpg", url);
+}
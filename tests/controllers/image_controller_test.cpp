@@ -1,24 +1,172 @@
 #include <gtest/gtest.h>
 #include "controllers/image_controller.h"
 #include "models/image_metadata.h"
+#include "models/transform_config.h"
+#include "models/watermark_config.h"
+#include "services/cache_manager.h"
+#include "services/image_processor.h"
+#include "services/local_config_service.h"
+#include "services/raw_key_resolver.h"
+#include "services/watermark_service.h"
+#include "mocks/fake_database_client.h"
+#include "mocks/fake_file_service.h"
 #include "utils/logger.h"
 #include "utils/metrics.h"
+#include <crow.h>
+#include <vips/vips8>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 #include <nlohmann/json.hpp>
 
 using namespace gara;
+using namespace gara::testing;
 using json = nlohmann::json;
 
+namespace {
+constexpr const char* TEST_API_KEY = "image-controller-test-key";
+constexpr const char* TEST_BOUNDARY = "gara-test-boundary";
+}
+
 class ImageControllerTest : public ::testing::Test {
 protected:
+    static void SetUpTestSuite() {
+        ImageProcessor::initialize();
+    }
+
+    static void TearDownTestSuite() {
+        ImageProcessor::shutdown();
+    }
+
     void SetUp() override {
         // Initialize logger and metrics for tests
         gara::Logger::initialize("gara-test", "error", gara::Logger::Format::TEXT, "test");
         gara::Metrics::initialize("GaraTest", "gara-test", "test", false);
+        setenv("API_KEY", TEST_API_KEY, 1);
+
+        // Route tests drive the controller through a Crow app backed by fakes
+        file_service_ = std::make_shared<FakeFileService>("test-bucket");
+        db_client_ = std::make_shared<FakeDatabaseClient>();
+        WatermarkConfig watermark_config;
+        watermark_config.enabled = false;
+        controller_ = std::make_shared<ImageController>(
+            file_service_,
+            std::make_shared<ImageProcessor>(),
+            std::make_shared<CacheManager>(file_service_),
+            std::make_shared<LocalConfigService>(),
+            std::make_shared<WatermarkService>(watermark_config),
+            db_client_,
+            std::make_shared<RawKeyResolver>(db_client_, file_service_));
+        controller_->registerRoutes(app_);
+        app_.validate();
+    }
+
+    void TearDown() override {
+        file_service_->clear();
+        unsetenv("API_KEY");
+    }
+
+    // Solid grey PNG; a different shade gives different bytes and so a different image ID
+    static std::string pngBytes(int width, int height, double shade) {
+        vips::VImage image = vips::VImage::black(width, height, vips::VImage::option()->set("bands", 3))
+            .new_from_image({shade, shade, shade});
+        void* buffer = nullptr;
+        size_t length = 0;
+        image.write_to_buffer(".png", &buffer, &length);
+        std::string bytes(static_cast<const char*>(buffer), length);
+        g_free(buffer);
+        return bytes;
+    }
+
+    // multipart/form-data body with one file part per (filename, data) pair
+    static std::string multipartBody(const std::vector<std::pair<std::string, std::string>>& files) {
+        std::string body;
+        for (const auto& [filename, data] : files) {
+            body += std::string("--") + TEST_BOUNDARY + "\r\n";
+            body += "Content-Disposition: form-data; name=\"file\"; filename=\"" + filename + "\"\r\n";
+            body += "Content-Type: application/octet-stream\r\n\r\n";
+            body += data + "\r\n";
+        }
+        body += std::string("--") + TEST_BOUNDARY + "--\r\n";
+        return body;
+    }
+
+    // Route a request through the app, authenticated unless api_key is empty
+    crow::response send(crow::HTTPMethod method, const std::string& url, const std::string& body = "",
+                        const std::vector<std::pair<std::string, std::string>>& headers = {},
+                        const std::string& api_key = TEST_API_KEY) {
+        crow::request req;
+        req.method = method;
+        req.raw_url = url;
+        req.url = url.substr(0, url.find('?'));
+        req.url_params = crow::query_string(url);
+        req.body = body;
+        if (!api_key.empty()) {
+            req.add_header("X-API-Key", api_key);
+        }
+        for (const auto& [name, value] : headers) {
+            req.add_header(name, value);
+        }
+        crow::response res;
+        app_.handle_full(req, res);
+        return res;
+    }
 
-        // Tests for image controller would require mocking Crow requests
-        // which is complex. For basic smoke tests, we'll test the helper
-        // methods and data models instead.
+    crow::response upload(const std::vector<std::pair<std::string, std::string>>& files, bool bulk = false) {
+        return send(crow::HTTPMethod::Post, bulk ? "/api/images/upload/bulk" : "/api/images/upload",
+                    multipartBody(files),
+                    {{"Content-Type", std::string("multipart/form-data; boundary=") + TEST_BOUNDARY}});
     }
+
+    // Send the same upload from count threads while the first storage write is
+    // held back, then let each write call on_write (which may throw)
+    std::vector<crow::response> concurrentUploads(const std::string& data, size_t count,
+                                                  std::function<void()> on_write = nullptr) {
+        std::promise<void> release;
+        std::shared_future<void> released = release.get_future().share();
+        std::promise<void> entered;
+        std::future<void> write_started = entered.get_future();
+        std::atomic<bool> first{true};
+        file_service_->setMoveHook([&](const std::string&) {
+            if (first.exchange(false)) {
+                entered.set_value();
+                released.wait();
+            }
+            if (on_write) {
+                on_write();
+            }
+        });
+
+        std::vector<crow::response> responses(count);
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i < count; ++i) {
+            threads.emplace_back([this, &responses, &data, i]() {
+                responses[i] = upload({{"same.png", data}});
+            });
+        }
+        write_started.wait();
+        // Waiters cannot be observed directly; give the others time to hash and join the flight
+        std::this_thread::sleep_for(std::chrono::milliseconds(300));
+        release.set_value();
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        file_service_->setMoveHook(nullptr);
+        return responses;
+    }
+
+    std::shared_ptr<FakeFileService> file_service_;
+    std::shared_ptr<FakeDatabaseClient> db_client_;
+    std::shared_ptr<ImageController> controller_;
+    crow::SimpleApp app_;
 };
 
 // Test TransformRequest construction
@@ -146,3 +294,373 @@ TEST_F(ImageControllerTest, ErrorResponseFormat) {
     EXPECT_EQ("File too large", error_response["error"]);
     EXPECT_TRUE(error_response.contains("message"));
 }
+
+// Test rendition profile list parsing
+TEST_F(ImageControllerTest, ParseRenditionProfiles) {
+    auto profiles = RenditionProfile::parseList("webp:320, WEBP:640x480,jpeg:1280x0");
+
+    ASSERT_EQ(3u, profiles.size());
+    EXPECT_EQ("webp", profiles[0].format);
+    EXPECT_EQ(320, profiles[0].width);
+    EXPECT_EQ(0, profiles[0].height);
+    EXPECT_EQ("webp", profiles[1].format);
+    EXPECT_EQ(640, profiles[1].width);
+    EXPECT_EQ(480, profiles[1].height);
+    EXPECT_EQ("jpeg", profiles[2].format);
+    EXPECT_EQ(1280, profiles[2].width);
+}
+
+// Test malformed rendition profiles are skipped
+TEST_F(ImageControllerTest, ParseRenditionProfilesSkipsMalformedEntries) {
+    auto profiles = RenditionProfile::parseList("webp,:320,png:abc,jpeg:-5,png:100x100,");
+
+    ASSERT_EQ(1u, profiles.size());
+    EXPECT_EQ("png", profiles[0].format);
+    EXPECT_EQ(100, profiles[0].width);
+}
+
+// Test pre-generated renditions share the cache key a GET would use
+TEST_F(ImageControllerTest, RenditionProfileMatchesGetCacheKey) {
+    RenditionProfile profile = RenditionProfile::parseList("webp:320")[0];
+    TransformRequest pregenerated("abc123", profile.format, profile.width, profile.height);
+
+    TransformRequest from_get;
+    from_get.image_id = "abc123";
+    from_get.target_format = "webp";
+    from_get.width = 320;
+    from_get.height = 0;
+
+    EXPECT_EQ(from_get.getCacheKey(), pregenerated.getCacheKey());
+}
+
+// Test default encoder settings leave transformed keys unchanged
+TEST_F(ImageControllerTest, GenerateTransformedKeyWithEncoderOptions) {
+    EXPECT_EQ("transformed/abc_webp_320x0_wm.webp",
+              ImageMetadata::generateTransformedKey("abc", "webp", 320, 0, true));
+    EXPECT_EQ("transformed/abc_webp_320x0_q60_smallest_wm.webp",
+              ImageMetadata::generateTransformedKey("abc", "webp", 320, 0, true, 60, "smallest"));
+
+    TransformRequest req("abc", "webp", 320, 0);
+    req.quality = 60;
+    EXPECT_EQ("transformed/abc_webp_320x0_q60_wm.webp", req.getCacheKey());
+}
+
+// Test encoder profiles resolve with quality overrides
+TEST_F(ImageControllerTest, EncoderConfigResolvesProfiles) {
+    EncoderConfig config;
+
+    EXPECT_NE(nullptr, config.find("fast"));
+    EXPECT_NE(nullptr, config.find("smallest"));
+    EXPECT_EQ(nullptr, config.find("missing"));
+
+    EncoderProfile baseline = config.resolve("");
+    EXPECT_EQ(EncoderConfig::BASELINE_PROFILE, baseline.name);
+    EXPECT_EQ(85, baseline.quality);
+
+    EncoderProfile smallest = config.resolve("smallest", 50);
+    EXPECT_EQ(50, smallest.quality);
+    EXPECT_TRUE(smallest.png_palette);
+}
+
+// Test snapping rounds up to the next ladder size and caps at the largest
+TEST_F(ImageControllerTest, SizeLadderSnapsToNextSize) {
+    SizeLadder ladder;
+    ladder.policy = SizePolicy::SNAP;
+    ladder.sizes = SizeLadder::parseSizes("640, 320,abc,-5,1280,320");
+
+    ASSERT_EQ(3u, ladder.sizes.size());
+    EXPECT_EQ(320, ladder.sizes[0]);
+
+    int width = 321;
+    EXPECT_TRUE(ladder.apply(width));
+    EXPECT_EQ(640, width);
+
+    int large = 5000;
+    EXPECT_TRUE(ladder.apply(large));
+    EXPECT_EQ(1280, large);
+
+    int original = 0;
+    EXPECT_TRUE(ladder.apply(original));
+    EXPECT_EQ(0, original);
+}
+
+// Test reject policy only accepts exact ladder sizes
+TEST_F(ImageControllerTest, SizeLadderRejectsOffLadderSizes) {
+    SizeLadder ladder;
+    ladder.policy = SizePolicy::REJECT;
+    ladder.sizes = {320, 640};
+
+    int on_ladder = 640;
+    int off_ladder = 500;
+    EXPECT_TRUE(ladder.apply(on_ladder));
+    EXPECT_FALSE(ladder.apply(off_ladder));
+    EXPECT_EQ("320,640", ladder.describe());
+}
+
+// Test the ladder is inactive unless a policy is configured
+TEST_F(ImageControllerTest, SizeLadderOffKeepsRequestedSize) {
+    SizeLadder ladder;
+    ladder.sizes = {320, 640};
+
+    int width = 333;
+    EXPECT_TRUE(ladder.apply(width));
+    EXPECT_EQ(333, width);
+}
+
+// Test shared parameter validation (used by GET, batch and album renditions)
+TEST_F(ImageControllerTest, BuildTransformRequestAppliesProfileAndLadder) {
+    TransformConfig config;
+    config.size_ladder.policy = SizePolicy::SNAP;
+    config.size_ladder.sizes = {320, 640};
+
+    TransformParams params;
+    params.format = "webp";
+    params.width = "300";
+    params.profile = "smallest";
+
+    std::string error;
+    auto request = ImageController::buildTransformRequest(config, "img1", params, error);
+    ASSERT_TRUE(request.has_value()) << error;
+    EXPECT_EQ("webp", request->target_format);
+    EXPECT_EQ(320, request->width);
+    EXPECT_EQ(0, request->height);
+    EXPECT_EQ("smallest", request->encoder_profile);
+
+    params.profile = "balanced";
+    auto baseline = ImageController::buildTransformRequest(config, "img1", params, error);
+    ASSERT_TRUE(baseline.has_value());
+    EXPECT_EQ("", baseline->encoder_profile) << "Baseline profile should keep unsuffixed cache keys";
+
+    params.quality = "0";
+    EXPECT_FALSE(ImageController::buildTransformRequest(config, "img1", params, error).has_value());
+    EXPECT_FALSE(error.empty());
+}
+
+// Test ?delivery= parsing for GET /api/images/<id>
+TEST_F(ImageControllerTest, ParseDeliveryModes) {
+    EXPECT_EQ(ImageDelivery::JSON, ImageController::parseDelivery(nullptr));
+    EXPECT_EQ(ImageDelivery::JSON, ImageController::parseDelivery("json"));
+    EXPECT_EQ(ImageDelivery::REDIRECT, ImageController::parseDelivery("redirect"));
+    EXPECT_EQ(ImageDelivery::INLINE, ImageController::parseDelivery("inline"));
+    EXPECT_FALSE(ImageController::parseDelivery("Inline").has_value());
+    EXPECT_FALSE(ImageController::parseDelivery("").has_value());
+}
+
+// Test tile names accepted under /api/images/<id>/tiles/image_files/<level>/
+TEST_F(ImageControllerTest, TileConfig_ParseTileName) {
+    TileConfig config;
+    int col = -1;
+    int row = -1;
+
+    EXPECT_TRUE(config.parseTileName("3_12.jpg", col, row));
+    EXPECT_EQ(3, col);
+    EXPECT_EQ(12, row);
+
+    EXPECT_FALSE(config.parseTileName("3_12.png", col, row));
+    EXPECT_FALSE(config.parseTileName("3-12.jpg", col, row));
+    EXPECT_FALSE(config.parseTileName("_12.jpg", col, row));
+    EXPECT_FALSE(config.parseTileName("3_.jpg", col, row));
+    EXPECT_FALSE(config.parseTileName("../3_1.jpg", col, row));
+    EXPECT_FALSE(config.parseTileName("12345678901_1.jpg", col, row));
+
+    config.format = "webp";
+    EXPECT_TRUE(config.parseTileName("0_0.webp", col, row));
+    EXPECT_EQ("webp-254-1-q85", config.variant());
+}
+
+// ============================================================================
+// Upload Coalescing Tests
+// ============================================================================
+
+TEST_F(ImageControllerTest, Upload_ConcurrentIdenticalUploads_StoreOnceAndShareTheImageId) {
+    // Arrange
+    std::string png = pngBytes(8, 8, 120.0);
+
+    // Act
+    std::vector<crow::response> responses = concurrentUploads(png, 8);
+
+    // Assert
+    std::string image_id;
+    for (const auto& res : responses) {
+        ASSERT_EQ(201, res.code) << res.body;
+        std::string id = json::parse(res.body)["image_id"];
+        if (image_id.empty()) {
+            image_id = id;
+        }
+        EXPECT_EQ(image_id, id);
+    }
+    EXPECT_EQ(1u, file_service_->getMoveCallCount())
+        << "Only the leader should write the object";
+    EXPECT_EQ(1u, db_client_->getImageWriteCount())
+        << "Only the leader should write the metadata row";
+    EXPECT_TRUE(db_client_->getImageMetadata(image_id).has_value());
+}
+
+TEST_F(ImageControllerTest, Upload_LeaderThrows_ExceptionReachesEveryWaiter) {
+    // Arrange
+    auto failing_write = []() {
+        throw std::runtime_error("storage unavailable");
+    };
+
+    // Act
+    std::vector<crow::response> responses = concurrentUploads(pngBytes(8, 8, 60.0), 8, failing_write);
+
+    // Assert
+    for (const auto& res : responses) {
+        EXPECT_EQ(500, res.code) << res.body;
+    }
+    EXPECT_EQ(1u, file_service_->getMoveCallCount())
+        << "Waiters should get the leader's failure instead of retrying the write";
+    EXPECT_EQ(0u, db_client_->getImageWriteCount());
+    EXPECT_EQ(0u, file_service_->getObjectCount());
+}
+
+// ============================================================================
+// Bulk Upload Tests
+// ============================================================================
+
+TEST_F(ImageControllerTest, BulkUpload_StoredFile_ReportsPerFileResult) {
+    // Arrange
+    std::string png = pngBytes(8, 8, 40.0);
+
+    // Act
+    crow::response res = upload({{"photo.png", png}}, true);
+
+    // Assert
+    ASSERT_EQ(200, res.code) << res.body;
+    json body = json::parse(res.body);
+    EXPECT_EQ(1, body["count"]);
+    EXPECT_EQ(1, body["created"]);
+    EXPECT_EQ(0, body["duplicates"]);
+    EXPECT_EQ(0, body["failed"]);
+    EXPECT_TRUE(body.contains("upload_timestamp"));
+    ASSERT_EQ(1u, body["results"].size());
+
+    const json& result = body["results"][0];
+    EXPECT_EQ("photo.png", result["filename"]);
+    EXPECT_EQ(png.size(), result["size"].get<size_t>());
+    EXPECT_EQ("created", result["status"]);
+    EXPECT_FALSE(result.contains("error"));
+    std::string image_id = result["image_id"];
+    EXPECT_TRUE(file_service_->objectExists(ImageMetadata::generateRawKey(image_id, "png")));
+    auto metadata = db_client_->getImageMetadata(image_id);
+    ASSERT_TRUE(metadata.has_value())
+        << "The file's metadata row should be committed with it";
+    EXPECT_EQ(8, metadata->width);
+}
+
+TEST_F(ImageControllerTest, BulkUpload_DuplicateInOneBatch_StoresContentOnce) {
+    // Arrange
+    std::string first = pngBytes(8, 8, 10.0);
+    std::string second = pngBytes(8, 8, 200.0);
+
+    // Act
+    crow::response res = upload({{"a.png", first}, {"b.png", first}, {"c.png", second}}, true);
+
+    // Assert
+    ASSERT_EQ(200, res.code) << res.body;
+    json body = json::parse(res.body);
+    EXPECT_EQ(2, body["created"]);
+    EXPECT_EQ(1, body["duplicates"]);
+    EXPECT_EQ(0, body["failed"]);
+
+    // Either copy may finish hashing first and store the content
+    const json& results = body["results"];
+    std::string copies = results[0]["status"].get<std::string>() + "," + results[1]["status"].get<std::string>();
+    EXPECT_TRUE(copies == "created,duplicate" || copies == "duplicate,created") << copies;
+    EXPECT_EQ(results[0]["image_id"], results[1]["image_id"]);
+    EXPECT_EQ("created", results[2]["status"]);
+    EXPECT_NE(results[0]["image_id"], results[2]["image_id"]);
+
+    EXPECT_EQ(2u, file_service_->getMoveCallCount());
+    EXPECT_EQ(2u, file_service_->getObjectCount());
+    EXPECT_EQ(2u, db_client_->getImageWriteCount());
+}
+
+TEST_F(ImageControllerTest, BulkUpload_MetadataWriteFails_RemovesObjectsAndReportsErrors) {
+    // Arrange
+    db_client_->setFailImageWrites(true);
+
+    // Act
+    crow::response res = upload({{"a.png", pngBytes(8, 8, 10.0)}, {"b.png", pngBytes(8, 8, 200.0)}}, true);
+
+    // Assert
+    ASSERT_EQ(200, res.code) << res.body;
+    json body = json::parse(res.body);
+    EXPECT_EQ(0, body["created"]);
+    EXPECT_EQ(2, body["failed"]);
+    for (const auto& result : body["results"]) {
+        EXPECT_EQ("error", result["status"]);
+        EXPECT_EQ("Failed to process and upload image", result["error"]);
+        EXPECT_TRUE(result.contains("image_id"));
+    }
+    EXPECT_EQ(2u, file_service_->getMoveCallCount());
+    EXPECT_EQ(0u, file_service_->getObjectCount())
+        << "Objects without a metadata row should be deleted again";
+}
+
+TEST_F(ImageControllerTest, BulkUpload_RejectedParts_AreReportedWithoutStoppingTheBatch) {
+    // Arrange - 1 byte over the 100MB limit
+    std::string oversize(100 * 1024 * 1024 + 1, 'x');
+    std::string png = pngBytes(8, 8, 90.0);
+
+    // Act
+    crow::response res = upload({
+        {"huge.png", oversize},
+        {"notes.txt", png},
+        {"fake.png", "plain text, not an image"},
+        {"ok.png", png}
+    }, true);
+
+    // Assert
+    ASSERT_EQ(200, res.code);
+    json body = json::parse(res.body);
+    EXPECT_EQ(4, body["count"]);
+    EXPECT_EQ(1, body["created"]);
+    EXPECT_EQ(3, body["failed"]);
+
+    const json& results = body["results"];
+    EXPECT_EQ("invalid", results[0]["status"]);
+    EXPECT_EQ("File too large. Maximum file size is 100MB", results[0]["error"]);
+    EXPECT_EQ(oversize.size(), results[0]["size"].get<size_t>());
+    for (size_t i : {1, 2}) {
+        EXPECT_EQ("invalid", results[i]["status"]) << results[i]["filename"];
+        EXPECT_EQ("Unsupported or unrecognised image file", results[i]["error"]);
+    }
+    for (size_t i : {0, 1, 2}) {
+        EXPECT_FALSE(results[i].contains("image_id"))
+            << "Rejected parts are never hashed";
+    }
+    EXPECT_EQ("created", results[3]["status"]);
+    EXPECT_EQ(1u, file_service_->getObjectCount());
+}
+
+// ============================================================================
+// Delivery Tests
+// ============================================================================
+
+TEST_F(ImageControllerTest, GetImage_InlineRevalidation_KeepsInlineCacheControl) {
+    // Arrange
+    crow::response uploaded = upload({{"photo.png", pngBytes(16, 16, 80.0)}});
+    ASSERT_EQ(201, uploaded.code) << uploaded.body;
+    std::string url = "/api/images/" + json::parse(uploaded.body)["image_id"].get<std::string>() +
+                      "?format=png&width=8&height=8&delivery=inline";
+    crow::response first = send(crow::HTTPMethod::Get, url);
+    ASSERT_EQ(200, first.code) << first.body;
+    std::string etag = first.get_header_value("ETag");
+    ASSERT_FALSE(etag.empty());
+
+    // Act
+    crow::response revalidated = send(crow::HTTPMethod::Get, url, "", {{"If-None-Match", etag}});
+    crow::response revalidated_json = send(crow::HTTPMethod::Get, url.substr(0, url.find("&delivery")), "",
+                                           {{"If-None-Match", etag}});
+
+    // Assert
+    EXPECT_EQ(304, revalidated.code);
+    EXPECT_EQ(etag, revalidated.get_header_value("ETag"));
+    EXPECT_EQ(first.get_header_value("Cache-Control"), revalidated.get_header_value("Cache-Control"))
+        << "A 304 should not shorten the year-long policy of the inline 200";
+    EXPECT_EQ("public, max-age=31536000, immutable", revalidated.get_header_value("Cache-Control"));
+    EXPECT_EQ(304, revalidated_json.code);
+    EXPECT_EQ("public, max-age=1800, immutable", revalidated_json.get_header_value("Cache-Control"));
+}
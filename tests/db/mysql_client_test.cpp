@@ -33,6 +33,13 @@ protected:
         unsetenv("MYSQL_USER");
         unsetenv("MYSQL_PASSWORD");
         unsetenv("MYSQL_DATABASE");
+        unsetenv("MYSQL_POOL_MIN");
+        unsetenv("MYSQL_POOL_MAX");
+        unsetenv("MYSQL_POOL_IDLE_TIMEOUT_SECONDS");
+        unsetenv("MYSQL_POOL_ACQUIRE_TIMEOUT_MS");
+        unsetenv("MYSQL_POOL_HEALTH_CHECK_SECONDS");
+        unsetenv("MYSQL_REPLICA_HOSTS");
+        unsetenv("MYSQL_READ_YOUR_WRITES_MS");
     }
 
     void setMySQLEnvVars(const std::string& host, const std::string& port,
@@ -152,6 +159,105 @@ TEST_F(MySQLClientTest, MySQLConfig_FromEnvironment_WithEmptyPort_UsesDefault) {
         << "Empty port should fall back to default";
 }
 
+// ============================================================================
+// Connection Pool Config Tests
+// ============================================================================
+
+TEST_F(MySQLClientTest, MySQLConfig_PoolDefaults_AreSensible) {
+    // Arrange & Act
+    MySQLConfig config;
+
+    // Assert
+    EXPECT_GE(config.pool_min, 1);
+    EXPECT_GE(config.pool_max, config.pool_min);
+    EXPECT_GT(config.pool_acquire_timeout_ms, 0);
+    EXPECT_GT(config.pool_health_check_seconds, 0);
+}
+
+TEST_F(MySQLClientTest, MySQLConfig_FromEnvironment_WithPoolEnvVars_ParsesCorrectly) {
+    // Arrange
+    setenv("MYSQL_POOL_MIN", "4", 1);
+    setenv("MYSQL_POOL_MAX", "32", 1);
+    setenv("MYSQL_POOL_IDLE_TIMEOUT_SECONDS", "60", 1);
+    setenv("MYSQL_POOL_ACQUIRE_TIMEOUT_MS", "250", 1);
+    setenv("MYSQL_POOL_HEALTH_CHECK_SECONDS", "10", 1);
+
+    // Act
+    MySQLConfig config = MySQLConfig::fromEnvironment();
+
+    // Assert
+    EXPECT_EQ(4, config.pool_min);
+    EXPECT_EQ(32, config.pool_max);
+    EXPECT_EQ(60, config.pool_idle_timeout_seconds);
+    EXPECT_EQ(250, config.pool_acquire_timeout_ms);
+    EXPECT_EQ(10, config.pool_health_check_seconds);
+}
+
+TEST_F(MySQLClientTest, MySQLConfig_FromEnvironment_WithMinAboveMax_ClampsMin) {
+    // Arrange
+    setenv("MYSQL_POOL_MIN", "20", 1);
+    setenv("MYSQL_POOL_MAX", "8", 1);
+
+    // Act
+    MySQLConfig config = MySQLConfig::fromEnvironment();
+
+    // Assert
+    EXPECT_EQ(8, config.pool_max);
+    EXPECT_EQ(8, config.pool_min)
+        << "Pool floor should never exceed the ceiling";
+}
+
+TEST_F(MySQLClientTest, MySQLConfig_FromEnvironment_WithInvalidPoolMax_UsesDefault) {
+    // Arrange
+    setenv("MYSQL_POOL_MAX", "lots", 1);
+
+    // Act
+    MySQLConfig config = MySQLConfig::fromEnvironment();
+
+    // Assert
+    EXPECT_EQ(MySQLConfig().pool_max, config.pool_max);
+}
+
+TEST_F(MySQLClientTest, MySQLConfig_FromEnvironment_WithReplicaHosts_ParsesEndpoints) {
+    // Arrange
+    setenv("MYSQL_PORT", "3307", 1);
+    setenv("MYSQL_REPLICA_HOSTS", "replica-a, replica-b:3310 ,,replica-c:bad", 1);
+    setenv("MYSQL_READ_YOUR_WRITES_MS", "2000", 1);
+
+    // Act
+    MySQLConfig config = MySQLConfig::fromEnvironment();
+
+    // Assert
+    ASSERT_EQ(2u, config.replicas.size());
+    EXPECT_EQ("replica-a", config.replicas[0].host);
+    EXPECT_EQ(3307, config.replicas[0].port)
+        << "A replica without a port should use the primary's";
+    EXPECT_EQ("replica-b", config.replicas[1].host);
+    EXPECT_EQ(3310, config.replicas[1].port);
+    EXPECT_EQ(2000, config.read_your_writes_ms);
+}
+
+TEST_F(MySQLClientTest, MySQLConfig_FromEnvironment_WithNoReplicas_ReadsFromPrimary) {
+    // Act
+    MySQLConfig config = MySQLConfig::fromEnvironment();
+
+    // Assert
+    EXPECT_TRUE(config.replicas.empty());
+    EXPECT_EQ(0, config.read_your_writes_ms);
+}
+
+TEST_F(MySQLClientTest, MySQLParam_Factories_SetTypeAndValue) {
+    // Arrange & Act
+    MySQLParam text = MySQLParam::string(TEST_IMAGE_ID);
+    MySQLParam number = MySQLParam::integer(42);
+
+    // Assert
+    EXPECT_EQ(MySQLParam::Type::STRING, text.type);
+    EXPECT_EQ(TEST_IMAGE_ID, text.text);
+    EXPECT_EQ(MySQLParam::Type::INTEGER, number.type);
+    EXPECT_EQ(42, number.number);
+}
+
 // ============================================================================
 // ImageSortOrder SQL Generation Tests
 // ============================================================================
@@ -0,0 +1,835 @@
+#include <gtest/gtest.h>
+#include "db/sqlite_client.h"
+#include "utils/logger.h"
+#include "utils/metrics.h"
+#include "test_helpers/test_constants.h"
+#include <atomic>
+#include <cstdlib>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+using namespace gara;
+using namespace gara::test_constants;
+
+class SQLiteClientTest : public ::testing::Test {
+protected:
+    std::filesystem::path temp_dir_;
+
+    void SetUp() override {
+        gara::Logger::initialize("gara-test", "error", gara::Logger::Format::TEXT, "test");
+        gara::Metrics::initialize("GaraTest", "gara-test", "test", false);
+
+        temp_dir_ = std::filesystem::temp_directory_path() /
+                    ("gara_sqlite_test_" + std::to_string(std::rand()));
+        std::filesystem::create_directories(temp_dir_);
+        clearSQLiteEnvVars();
+    }
+
+    void TearDown() override {
+        clearSQLiteEnvVars();
+        std::filesystem::remove_all(temp_dir_);
+    }
+
+    void clearSQLiteEnvVars() {
+        unsetenv("SQLITE_READ_CONNECTIONS");
+        unsetenv("SQLITE_MMAP_SIZE");
+        unsetenv("SQLITE_CACHE_SIZE_KB");
+        unsetenv("SQLITE_BUSY_TIMEOUT_MS");
+        unsetenv("SQLITE_SYNCHRONOUS");
+    }
+
+    // initialize() reads src/db/schema.sql relative to the working directory
+    std::unique_ptr<SQLiteClient> createClient(const std::string& db_path,
+                                               const SQLiteConfig& config = SQLiteConfig()) {
+        auto client = std::make_unique<SQLiteClient>(db_path, config);
+        auto cwd = std::filesystem::current_path();
+        std::filesystem::current_path(GARA_SOURCE_DIR);
+        bool initialized = client->initialize();
+        std::filesystem::current_path(cwd);
+        EXPECT_TRUE(initialized);
+        return client;
+    }
+
+    std::string fileDbPath() const {
+        return (temp_dir_ / "gara.db").string();
+    }
+
+    static ImageMetadata makeImage(const std::string& id, const std::string& name,
+                                   std::time_t uploaded_at) {
+        ImageMetadata metadata(id, "jpeg", ImageMetadata::generateRawKey(id, "jpeg"), SMALL_DATA_SIZE);
+        metadata.name = name;
+        metadata.width = STANDARD_WIDTH_800;
+        metadata.height = STANDARD_HEIGHT_600;
+        metadata.upload_timestamp = uploaded_at;
+        return metadata;
+    }
+};
+
+// ============================================================================
+// SQLiteConfig Tests
+// ============================================================================
+
+TEST_F(SQLiteClientTest, SQLiteConfig_FromEnvironment_ReadsOverrides) {
+    // Arrange
+    setenv("SQLITE_READ_CONNECTIONS", "2", 1);
+    setenv("SQLITE_MMAP_SIZE", "1048576", 1);
+    setenv("SQLITE_SYNCHRONOUS", "FULL", 1);
+
+    // Act
+    SQLiteConfig config = SQLiteConfig::fromEnvironment();
+
+    // Assert
+    EXPECT_EQ(2, config.read_connections);
+    EXPECT_EQ(1048576LL, config.mmap_size);
+    EXPECT_EQ("FULL", config.synchronous);
+}
+
+TEST_F(SQLiteClientTest, SQLiteConfig_InvalidValue_KeepsDefault) {
+    // Arrange
+    setenv("SQLITE_READ_CONNECTIONS", "many", 1);
+
+    // Act
+    SQLiteConfig config = SQLiteConfig::fromEnvironment();
+
+    // Assert
+    EXPECT_EQ(SQLiteConfig().read_connections, config.read_connections);
+}
+
+// ============================================================================
+// Connection Pool Tests
+// ============================================================================
+
+TEST_F(SQLiteClientTest, Constructor_FileDatabase_OpensReadPool) {
+    // Arrange
+    SQLiteConfig config;
+    config.read_connections = 3;
+
+    // Act
+    auto client = createClient(fileDbPath(), config);
+
+    // Assert
+    EXPECT_EQ(3u, client->readConnectionCount());
+}
+
+TEST_F(SQLiteClientTest, Constructor_InMemoryDatabase_ReadsUseWriter) {
+    // Arrange & Act
+    auto client = createClient(":memory:");
+
+    // Assert
+    EXPECT_EQ(0u, client->readConnectionCount())
+        << "Separate connections to :memory: would each see an empty database";
+    ASSERT_TRUE(client->putImageMetadata(makeImage(TEST_IMAGE_ID, "photo", 100)));
+    EXPECT_TRUE(client->imageExists(TEST_IMAGE_ID));
+}
+
+TEST_F(SQLiteClientTest, GetImageMetadata_AfterWrite_VisibleToReaders) {
+    // Arrange
+    auto client = createClient(fileDbPath());
+
+    // Act
+    ASSERT_TRUE(client->putImageMetadata(makeImage(TEST_IMAGE_ID, "photo", 100)));
+    auto metadata = client->getImageMetadata(TEST_IMAGE_ID);
+
+    // Assert
+    ASSERT_TRUE(metadata.has_value());
+    EXPECT_EQ("photo", metadata->name);
+    EXPECT_EQ(STANDARD_WIDTH_800, metadata->width);
+    EXPECT_EQ(ImageMetadata::generateRawKey(TEST_IMAGE_ID, "jpeg"), metadata->s3_raw_key);
+}
+
+// ============================================================================
+// Statement Cache Tests
+// ============================================================================
+
+TEST_F(SQLiteClientTest, GetAlbum_RepeatedCalls_ReuseStatementCleanly) {
+    // Arrange
+    auto client = createClient(fileDbPath());
+    Album album("album-1", "Holidays");
+    album.image_ids = {"img1", "img2"};
+    ASSERT_TRUE(client->putAlbum(album));
+
+    // Act & Assert
+    for (int i = 0; i < 3; ++i) {
+        auto found = client->getAlbum("album-1");
+        ASSERT_TRUE(found.has_value()) << "Iteration " << i;
+        EXPECT_EQ("Holidays", found->name);
+        EXPECT_EQ(ALBUM_IMAGES_COUNT_TWO, found->image_ids.size());
+        EXPECT_FALSE(client->getAlbum("missing").has_value())
+            << "Stale bindings from the previous call must be cleared";
+    }
+}
+
+TEST_F(SQLiteClientTest, ListImages_DifferentSortOrders_ReturnsOrderedRows) {
+    // Arrange
+    auto client = createClient(fileDbPath());
+    client->putImageMetadata(makeImage("a", "beta", 100));
+    client->putImageMetadata(makeImage("b", "alpha", 200));
+
+    // Act
+    auto newest = client->listImages(10, 0, ImageSortOrder::NEWEST);
+    auto by_name = client->listImages(10, 0, ImageSortOrder::NAME_ASC);
+    auto newest_again = client->listImages(10, 0, ImageSortOrder::NEWEST);
+
+    // Assert
+    ASSERT_EQ(2u, newest.size());
+    EXPECT_EQ("b", newest[0].image_id);
+    ASSERT_EQ(2u, by_name.size());
+    EXPECT_EQ("alpha", by_name[0].name);
+    ASSERT_EQ(2u, newest_again.size());
+    EXPECT_EQ("b", newest_again[0].image_id);
+    EXPECT_EQ(2, client->getImageCount());
+}
+
+TEST_F(SQLiteClientTest, DeleteAlbum_AfterRead_ChangesVisibleToNextRead) {
+    // Arrange
+    auto client = createClient(fileDbPath());
+    ASSERT_TRUE(client->putAlbum(Album("album-1", "Holidays")));
+    ASSERT_TRUE(client->albumNameExists("Holidays"));
+
+    // Act
+    bool deleted = client->deleteAlbum("album-1");
+
+    // Assert
+    EXPECT_TRUE(deleted);
+    EXPECT_FALSE(client->albumNameExists("Holidays"));
+    EXPECT_FALSE(client->getAlbum("album-1").has_value());
+}
+
+TEST_F(SQLiteClientTest, ImagesExist_MixedBatch_ReturnsOnlyStoredIds) {
+    // Arrange
+    auto client = createClient(fileDbPath());
+    client->putImageMetadata(makeImage("a", "alpha", 100));
+    client->putImageMetadata(makeImage("c", "gamma", 100));
+
+    // Act
+    auto found = client->imagesExist({"a", "b", "c", "it's"});
+
+    // Assert
+    EXPECT_EQ((std::unordered_set<std::string>{"a", "c"}), found);
+    EXPECT_TRUE(client->imagesExist({}).empty());
+}
+
+TEST_F(SQLiteClientTest, GetImagePlaceholders_MixedBatch_ReturnsOnlyStoredPlaceholders) {
+    // Arrange
+    auto client = createClient(fileDbPath());
+    ImageMetadata with_placeholder = makeImage("a", "alpha", 100);
+    with_placeholder.placeholder = "LEHV6nWB2yk8pyo0adR*.7kCMdnj";
+    client->putImageMetadata(with_placeholder);
+    client->putImageMetadata(makeImage("b", "beta", 100));
+
+    // Act
+    auto placeholders = client->getImagePlaceholders({"a", "b", "missing"});
+
+    // Assert
+    EXPECT_EQ((std::unordered_map<std::string, std::string>{{"a", with_placeholder.placeholder}}), placeholders);
+    EXPECT_EQ(with_placeholder.placeholder, client->getImageMetadata("a")->placeholder);
+    EXPECT_EQ("", client->getImageMetadata("b")->placeholder);
+}
+
+TEST_F(SQLiteClientTest, PutImageMetadataBatch_ManyImages_StoresEveryRow) {
+    // Arrange
+    auto client = createClient(fileDbPath());
+    client->putImageMetadata(makeImage("a", "old name", 100));
+    std::vector<ImageMetadata> batch;
+    for (const char* id : {"a", "b", "c"}) {
+        batch.push_back(makeImage(id, std::string("image ") + id, 200));
+    }
+
+    // Act
+    bool stored = client->putImageMetadataBatch(batch);
+
+    // Assert
+    EXPECT_TRUE(stored);
+    EXPECT_EQ(3, client->getImageCount());
+    EXPECT_EQ("image a", client->getImageMetadata("a")->name);
+    EXPECT_TRUE(client->putImageMetadataBatch({}));
+}
+
+// ============================================================================
+// Album Membership Tests
+// ============================================================================
+
+TEST_F(SQLiteClientTest, PutAlbum_ExistingAlbum_KeepsMembership) {
+    // Arrange
+    auto client = createClient(fileDbPath());
+    Album album("album-1", "Holidays");
+    album.image_ids = {"img1", "img2"};
+    ASSERT_TRUE(client->putAlbum(album));
+
+    // Act - a field-only update carrying a stale image list
+    album.name = "Summer";
+    album.image_ids = {};
+    ASSERT_TRUE(client->putAlbum(album));
+    auto found = client->getAlbum("album-1");
+
+    // Assert
+    ASSERT_TRUE(found.has_value());
+    EXPECT_EQ("Summer", found->name);
+    EXPECT_EQ((std::vector<std::string>{"img1", "img2"}), found->image_ids);
+}
+
+TEST_F(SQLiteClientTest, AddAlbumImages_AtPositionAfterRemoval_InsertsAtIndex) {
+    // Arrange - removing img2 leaves a gap in the stored positions
+    auto client = createClient(fileDbPath());
+    Album album("album-1", "Holidays");
+    album.image_ids = {"img1", "img2", "img3"};
+    ASSERT_TRUE(client->putAlbum(album));
+    ASSERT_TRUE(client->removeAlbumImage("album-1", "img2", 200));
+
+    // Act
+    ASSERT_TRUE(client->addAlbumImages("album-1", {"new1", "new2"}, 1, 300));
+    ASSERT_TRUE(client->addAlbumImages("album-1", {"last"}, -1, 400));
+
+    // Assert
+    auto found = client->getAlbum("album-1");
+    ASSERT_TRUE(found.has_value());
+    EXPECT_EQ((std::vector<std::string>{"img1", "new1", "new2", "img3", "last"}), found->image_ids);
+    EXPECT_EQ(400, found->updated_at);
+}
+
+TEST_F(SQLiteClientTest, AddAlbumImages_MissingAlbum_ReturnsFalse) {
+    // Arrange
+    auto client = createClient(fileDbPath());
+
+    // Act & Assert
+    EXPECT_FALSE(client->addAlbumImages("missing", {"img1"}, -1, 100));
+    EXPECT_EQ(0, client->getAlbumImageCount("missing"));
+}
+
+TEST_F(SQLiteClientTest, RemoveAlbumImage_NotInAlbum_ReturnsFalse) {
+    // Arrange
+    auto client = createClient(fileDbPath());
+    ASSERT_TRUE(client->putAlbum(Album("album-1", "Holidays")));
+
+    // Act & Assert
+    EXPECT_FALSE(client->removeAlbumImage("album-1", "img1", 100));
+}
+
+TEST_F(SQLiteClientTest, ReorderAlbumImages_NewOrder_IsReturnedByReads) {
+    // Arrange
+    auto client = createClient(fileDbPath());
+    Album album("album-1", "Holidays");
+    album.image_ids = {"img1", "img2", "img3"};
+    ASSERT_TRUE(client->putAlbum(album));
+
+    // Act
+    ASSERT_TRUE(client->reorderAlbumImages("album-1", {"img3", "img1", "img2"}, 500));
+
+    // Assert
+    EXPECT_EQ((std::vector<std::string>{"img3", "img1", "img2"}), client->getAlbum("album-1")->image_ids);
+    EXPECT_EQ((std::vector<std::string>{"img1"}), client->listAlbumImages("album-1", 1, 1));
+}
+
+TEST_F(SQLiteClientTest, AlbumImagesContained_MixedIds_ReturnsOnlyThisAlbumsMembers) {
+    // Arrange
+    auto client = createClient(fileDbPath());
+    Album album("album-1", "Holidays");
+    album.image_ids = {"img1", "img2"};
+    ASSERT_TRUE(client->putAlbum(album));
+    Album other("album-2", "Work");
+    other.image_ids = {"img3"};
+    ASSERT_TRUE(client->putAlbum(other));
+
+    // Act
+    auto contained = client->albumImagesContained("album-1", {"img2", "img3", "img9"});
+
+    // Assert
+    ASSERT_TRUE(contained.has_value());
+    EXPECT_EQ((std::unordered_set<std::string>{"img2"}), *contained);
+    auto none = client->albumImagesContained("missing", {"img1"});
+    ASSERT_TRUE(none.has_value()) << "An album without the images is an answer, not an error";
+    EXPECT_TRUE(none->empty());
+    EXPECT_EQ((std::vector<std::string>{"img1", "img2"}), client->listAlbumImages("album-1", -1, 0))
+        << "A limit of -1 should list every image";
+}
+
+TEST_F(SQLiteClientTest, ListAlbumImages_Paged_ReturnsSlicesAndCount) {
+    // Arrange
+    auto client = createClient(fileDbPath());
+    Album album("album-1", "Holidays");
+    for (int i = 0; i < 5; ++i) {
+        album.image_ids.push_back("img" + std::to_string(i));
+    }
+    ASSERT_TRUE(client->putAlbum(album));
+
+    // Act
+    auto first = client->listAlbumImages("album-1", 2, 0);
+    auto last = client->listAlbumImages("album-1", 2, 4);
+
+    // Assert
+    EXPECT_EQ((std::vector<std::string>{"img0", "img1"}), first);
+    EXPECT_EQ((std::vector<std::string>{"img4"}), last);
+    EXPECT_EQ(5, client->getAlbumImageCount("album-1"));
+    EXPECT_TRUE(client->getAlbum("album-1", false)->image_ids.empty());
+}
+
+TEST_F(SQLiteClientTest, ListAlbums_PublishedOnly_FillsMembership) {
+    // Arrange
+    auto client = createClient(fileDbPath());
+    Album published("album-1", "Public");
+    published.published = true;
+    published.image_ids = {"img1", "img2"};
+    Album hidden("album-2", "Private");
+    hidden.image_ids = {"img3"};
+    ASSERT_TRUE(client->putAlbum(published));
+    ASSERT_TRUE(client->putAlbum(hidden));
+
+    // Act
+    auto albums = client->listAlbums(true);
+
+    // Assert
+    ASSERT_EQ(1u, albums.size());
+    EXPECT_EQ(ALBUM_IMAGES_COUNT_TWO, albums[0].image_ids.size());
+}
+
+TEST_F(SQLiteClientTest, ListAlbumsAfter_TagFilters_ReturnAlbumsWithEveryTag) {
+    // Arrange
+    auto client = createClient(fileDbPath());
+    Album beach("album-1", "Beach");
+    beach.tags = {"summer", "travel"};
+    beach.image_ids = {"img1", "img2"};
+    Album city("album-2", "City");
+    city.tags = {"travel"};
+    Album ski("album-3", "Ski");
+    ski.tags = {"winter", "travel"};
+    ski.published = true;
+    ASSERT_TRUE(client->putAlbum(beach));
+    ASSERT_TRUE(client->putAlbum(city));
+    ASSERT_TRUE(client->putAlbum(ski));
+
+    // Act
+    auto travel = client->listAlbumsAfter(AlbumQuery{{"travel"}, false}, 10, std::nullopt);
+    auto summer_travel = client->listAlbumsAfter(AlbumQuery{{"travel", "summer", "travel"}, false}, 10,
+                                                 std::nullopt);
+    auto published_travel = client->listAlbumsAfter(AlbumQuery{{"travel"}, true}, 10, std::nullopt);
+
+    // Assert
+    EXPECT_EQ(3u, travel.size());
+    ASSERT_EQ(1u, summer_travel.size());
+    EXPECT_EQ("album-1", summer_travel[0].album_id);
+    EXPECT_EQ((std::vector<std::string>{"img1", "img2"}), summer_travel[0].image_ids);
+    ASSERT_EQ(1u, published_travel.size());
+    EXPECT_EQ("album-3", published_travel[0].album_id);
+}
+
+TEST_F(SQLiteClientTest, ListAlbumsAfter_UpdatedTags_ReplaceIndexedTags) {
+    // Arrange
+    auto client = createClient(fileDbPath());
+    Album album("album-1", "Beach");
+    album.tags = {"summer"};
+    ASSERT_TRUE(client->putAlbum(album));
+
+    // Act
+    album.tags = {"archive"};
+    ASSERT_TRUE(client->putAlbum(album));
+
+    // Assert
+    EXPECT_TRUE(client->listAlbumsAfter(AlbumQuery{{"summer"}, false}, 10, std::nullopt).empty());
+    EXPECT_EQ(1u, client->listAlbumsAfter(AlbumQuery{{"archive"}, false}, 10, std::nullopt).size());
+}
+
+TEST_F(SQLiteClientTest, ListAlbumsAfter_WalkingCursors_VisitsEveryAlbumOnceNewestFirst) {
+    // Arrange - shared timestamps exercise the album_id tie-breaker
+    auto client = createClient(fileDbPath());
+    for (int i = 0; i < 7; ++i) {
+        Album album("album-" + std::to_string(i), "Album " + std::to_string(i));
+        album.created_at = 100 + i / 2;
+        album.tags = {"all"};
+        ASSERT_TRUE(client->putAlbum(album));
+    }
+
+    // Act
+    std::vector<std::string> visited;
+    std::optional<AlbumPageCursor> cursor;
+    for (int page = 0; page < 10; ++page) {
+        auto albums = client->listAlbumsAfter(AlbumQuery{{"all"}, false}, 3, cursor);
+        if (albums.empty()) {
+            break;
+        }
+        for (const auto& album : albums) {
+            visited.push_back(album.album_id);
+        }
+        cursor = AlbumPageCursor::fromAlbum(albums.back());
+    }
+
+    // Assert
+    EXPECT_EQ((std::vector<std::string>{"album-6", "album-5", "album-4", "album-3",
+                                        "album-2", "album-1", "album-0"}), visited);
+}
+
+TEST_F(SQLiteClientTest, Initialize_TagsOnlyInJsonColumn_BackfillsAlbumTags) {
+    // Arrange - an album whose tags predate album_tags
+    {
+        auto client = createClient(fileDbPath());
+        ASSERT_TRUE(client->putAlbum(Album("album-1", "Holidays")));
+    }
+    sqlite3* db = nullptr;
+    ASSERT_EQ(SQLITE_OK, sqlite3_open(fileDbPath().c_str(), &db));
+    ASSERT_EQ(SQLITE_OK, sqlite3_exec(db,
+        "UPDATE albums SET tags = '[\"summer\",\"beach\"]' WHERE album_id = 'album-1'",
+        nullptr, nullptr, nullptr));
+    sqlite3_close(db);
+
+    // Act
+    auto client = createClient(fileDbPath());
+
+    // Assert
+    auto albums = client->listAlbumsAfter(AlbumQuery{{"beach"}, false}, 10, std::nullopt);
+    ASSERT_EQ(1u, albums.size());
+    EXPECT_EQ((std::vector<std::string>{"summer", "beach"}), albums[0].tags);
+}
+
+TEST_F(SQLiteClientTest, DeleteAlbum_WithImages_RemovesMembership) {
+    // Arrange
+    auto client = createClient(fileDbPath());
+    Album album("album-1", "Holidays");
+    album.image_ids = {"img1"};
+    ASSERT_TRUE(client->putAlbum(album));
+
+    // Act
+    ASSERT_TRUE(client->deleteAlbum("album-1"));
+    ASSERT_TRUE(client->putAlbum(Album("album-1", "Holidays")));
+
+    // Assert
+    EXPECT_EQ(0, client->getAlbumImageCount("album-1"))
+        << "Membership should cascade with the album row";
+}
+
+TEST_F(SQLiteClientTest, Initialize_LegacyJsonImageIds_MigratesIntoAlbumImages) {
+    // Arrange - an album row written by a version that stored image_ids as JSON
+    {
+        auto client = createClient(fileDbPath());
+        ASSERT_TRUE(client->putAlbum(Album("album-1", "Holidays")));
+    }
+    sqlite3* db = nullptr;
+    ASSERT_EQ(SQLITE_OK, sqlite3_open(fileDbPath().c_str(), &db));
+    ASSERT_EQ(SQLITE_OK, sqlite3_exec(db,
+        "UPDATE albums SET image_ids = '[\"img2\",\"img1\",\"img2\"]' WHERE album_id = 'album-1'",
+        nullptr, nullptr, nullptr));
+    sqlite3_close(db);
+
+    // Act
+    auto client = createClient(fileDbPath());
+
+    // Assert
+    EXPECT_EQ((std::vector<std::string>{"img2", "img1"}), client->getAlbum("album-1")->image_ids);
+}
+
+TEST_F(SQLiteClientTest, Initialize_ImagesTableWithoutPlaceholder_AddsColumn) {
+    // Arrange - an images table created before the placeholder column existed
+    sqlite3* db = nullptr;
+    ASSERT_EQ(SQLITE_OK, sqlite3_open(fileDbPath().c_str(), &db));
+    ASSERT_EQ(SQLITE_OK, sqlite3_exec(db,
+        "CREATE TABLE images (image_id TEXT PRIMARY KEY, name TEXT NOT NULL, original_format TEXT NOT NULL, "
+        "size INTEGER NOT NULL, width INTEGER, height INTEGER, uploaded_at INTEGER NOT NULL);"
+        "INSERT INTO images VALUES ('old', 'legacy', 'jpeg', 10, 1, 1, 100);",
+        nullptr, nullptr, nullptr));
+    sqlite3_close(db);
+
+    // Act
+    auto client = createClient(fileDbPath());
+    ImageMetadata image = makeImage("new", "fresh", 200);
+    image.placeholder = "00TSUA";
+
+    // Assert
+    ASSERT_TRUE(client->putImageMetadata(image));
+    EXPECT_EQ("00TSUA", client->getImageMetadata("new")->placeholder);
+    EXPECT_EQ("legacy", client->getImageMetadata("old")->name);
+}
+
+// ============================================================================
+// Keyset Pagination Tests
+// ============================================================================
+
+TEST_F(SQLiteClientTest, ListImagesAfter_WalkingCursors_VisitsEveryRowOnceInOrder) {
+    // Arrange - duplicate timestamps exercise the image_id tie-breaker
+    auto client = createClient(fileDbPath());
+    for (int i = 0; i < 7; ++i) {
+        client->putImageMetadata(makeImage("img" + std::to_string(i), "n", 100 + i / 2));
+    }
+
+    // Act
+    std::vector<std::string> visited;
+    std::optional<ImagePageCursor> cursor;
+    for (int page = 0; page < 10; ++page) {
+        auto images = client->listImagesAfter(3, ImageSortOrder::NEWEST, cursor);
+        if (images.empty()) {
+            break;
+        }
+        for (const auto& img : images) {
+            visited.push_back(img.image_id);
+        }
+        cursor = ImagePageCursor::fromImage(images.back());
+    }
+
+    // Assert
+    auto by_offset = client->listImages(10, 0, ImageSortOrder::NEWEST);
+    ASSERT_EQ(7u, visited.size());
+    for (size_t i = 0; i < visited.size(); ++i) {
+        EXPECT_EQ(by_offset[i].image_id, visited[i])
+            << "Cursor and offset pagination should agree at position " << i;
+    }
+}
+
+TEST_F(SQLiteClientTest, ListImagesAfter_NameCursor_ResumesAfterTies) {
+    // Arrange
+    auto client = createClient(fileDbPath());
+    client->putImageMetadata(makeImage("b", "same", 1));
+    client->putImageMetadata(makeImage("a", "same", 2));
+    client->putImageMetadata(makeImage("c", "zeta", 3));
+
+    // Act
+    auto first = client->listImagesAfter(1, ImageSortOrder::NAME_ASC, std::nullopt);
+    ASSERT_EQ(1u, first.size());
+    auto rest = client->listImagesAfter(10, ImageSortOrder::NAME_ASC,
+                                        ImagePageCursor::fromImage(first[0]));
+
+    // Assert
+    EXPECT_EQ("a", first[0].image_id);
+    ASSERT_EQ(2u, rest.size());
+    EXPECT_EQ("b", rest[0].image_id);
+    EXPECT_EQ("c", rest[1].image_id);
+}
+
+// ============================================================================
+// Transform Index Tests
+// ============================================================================
+
+TEST_F(SQLiteClientTest, Renditions_PutTouchAndList_TrackSizeAndAccess) {
+    // Arrange
+    auto client = createClient(fileDbPath());
+    client->putRendition({"transformed/a_100x100.jpeg", "a", 100, 10, 0});
+    client->putRendition({"transformed/a_200x200.jpeg", "a", 300, 20, 0});
+    client->putRendition({"transformed/b_100x100.jpeg", "b", 50, 30, 0});
+
+    // Act
+    client->touchRenditions({"transformed/a_100x100.jpeg", "transformed/unknown.jpeg"}, 40);
+
+    // Assert
+    EXPECT_EQ(450u, client->getRenditionBytes());
+    auto keys = client->listRenditionKeys("a");
+    EXPECT_EQ(2u, keys.size());
+
+    auto lru = client->listEvictionCandidates(10, RenditionEvictionPolicy::LRU);
+    ASSERT_EQ(3u, lru.size());
+    EXPECT_EQ("transformed/a_200x200.jpeg", lru[0].storage_key)
+        << "The least recently accessed rendition should be evicted first";
+    EXPECT_EQ("transformed/a_100x100.jpeg", lru[2].storage_key);
+    EXPECT_EQ(1, lru[2].hits);
+
+    auto lfu = client->listEvictionCandidates(1, RenditionEvictionPolicy::LFU);
+    ASSERT_EQ(1u, lfu.size());
+    EXPECT_EQ("transformed/a_200x200.jpeg", lfu[0].storage_key);
+}
+
+TEST_F(SQLiteClientTest, DeleteRenditions_RemovesRowsFromTotals) {
+    // Arrange
+    auto client = createClient(fileDbPath());
+    client->putRendition({"transformed/a_100x100.jpeg", "a", 100, 10, 0});
+    client->putRendition({"transformed/b_100x100.jpeg", "b", 50, 30, 0});
+
+    // Act
+    bool deleted = client->deleteRenditions({"transformed/a_100x100.jpeg"});
+
+    // Assert
+    EXPECT_TRUE(deleted);
+    EXPECT_EQ(50u, client->getRenditionBytes());
+    EXPECT_TRUE(client->listRenditionKeys("a").empty());
+}
+
+// ============================================================================
+// Render Job Tests
+// ============================================================================
+
+TEST_F(SQLiteClientTest, RenderJobs_ClaimLeasesEveryJobOfTheTopImages) {
+    // Arrange
+    auto client = createClient(fileDbPath());
+    auto make_job = [](const std::string& image_id, int width, int priority) {
+        RenderJob job;
+        job.image_id = image_id;
+        job.format = "webp";
+        job.width = width;
+        job.priority = priority;
+        job.run_after = 100;
+        return job;
+    };
+    ASSERT_TRUE(client->enqueueRenderJobs({
+        make_job("a", 320, 0), make_job("b", 320, 10), make_job("a", 640, 0), make_job("c", 320, 0)
+    }));
+    // Queued again at a higher priority: raised, not duplicated
+    ASSERT_TRUE(client->enqueueRenderJobs({make_job("a", 640, 5)}));
+
+    // Act
+    auto claimed = client->claimRenderJobs("lease-1", 2, 200, 500);
+    auto none_left = client->claimRenderJobs("lease-2", 2, 200, 500);
+
+    // Assert - b (priority 10) and a (priority 5), with every job of a
+    ASSERT_EQ(3u, claimed.size());
+    EXPECT_EQ("a", claimed[0].image_id);
+    EXPECT_EQ(640, claimed[0].width);
+    EXPECT_EQ("a", claimed[1].image_id);
+    EXPECT_EQ("b", claimed[2].image_id);
+    EXPECT_EQ(1, claimed[0].attempts);
+    ASSERT_EQ(1u, none_left.size());
+    EXPECT_EQ("c", none_left[0].image_id);
+
+    RenderJobCounts counts = client->getRenderJobCounts(200);
+    EXPECT_EQ(4, counts.leased);
+    EXPECT_EQ(0, counts.pending);
+    // Leases of a crashed worker run out
+    EXPECT_EQ(4, client->getRenderJobCounts(600).pending);
+}
+
+TEST_F(SQLiteClientTest, RenderJobs_ManyJobsPerImage_ClaimLimitCountsImages) {
+    // Arrange
+    auto client = createClient(fileDbPath());
+    std::vector<RenderJob> jobs;
+    for (const auto& [image_id, priority] : std::vector<std::pair<std::string, int>>{{"a", 10}, {"b", 5}, {"c", 1}}) {
+        for (int width : {160, 320, 640}) {
+            RenderJob job;
+            job.image_id = image_id;
+            job.format = "webp";
+            job.width = width;
+            job.priority = priority;
+            job.run_after = 100;
+            jobs.push_back(job);
+        }
+    }
+    ASSERT_TRUE(client->enqueueRenderJobs(jobs));
+
+    // Act
+    auto claimed = client->claimRenderJobs("lease-1", 2, 200, 500);
+
+    // Assert - every job of the two best images, not two jobs of one image
+    ASSERT_EQ(6u, claimed.size());
+    std::unordered_set<std::string> images;
+    for (const auto& job : claimed) {
+        images.insert(job.image_id);
+    }
+    EXPECT_EQ((std::unordered_set<std::string>{"a", "b"}), images);
+    EXPECT_EQ(3, client->getRenderJobCounts(200).pending);
+}
+
+TEST_F(SQLiteClientTest, RenderJobs_CompleteAndRelease_SettleJobs) {
+    // Arrange
+    auto client = createClient(fileDbPath());
+    std::vector<RenderJob> jobs(3);
+    for (int i = 0; i < 3; ++i) {
+        jobs[i].image_id = "a";
+        jobs[i].format = "webp";
+        jobs[i].width = 320 * (i + 1);
+        jobs[i].run_after = 100;
+    }
+    ASSERT_TRUE(client->enqueueRenderJobs(jobs));
+    auto claimed = client->claimRenderJobs("lease-1", 1, 200, 500);
+    ASSERT_EQ(3u, claimed.size());
+
+    // Act
+    EXPECT_TRUE(client->completeRenderJobs("lease-1", {claimed[0].job_id}));
+    EXPECT_TRUE(client->releaseRenderJob("lease-1", claimed[1].job_id, 300, "timeout"));
+    EXPECT_TRUE(client->releaseRenderJob("lease-1", claimed[2].job_id, std::nullopt, "corrupt"));
+
+    // Assert
+    EXPECT_TRUE(client->claimRenderJobs("lease-2", 1, 250, 500).empty())
+        << "A released job should wait for its retry time";
+    auto retried = client->claimRenderJobs("lease-3", 1, 300, 500);
+    ASSERT_EQ(1u, retried.size());
+    EXPECT_EQ(claimed[1].job_id, retried[0].job_id);
+    EXPECT_EQ(2, retried[0].attempts);
+
+    RenderJobCounts counts = client->getRenderJobCounts(300);
+    EXPECT_EQ(1, counts.leased);
+    EXPECT_EQ(1, counts.failed);
+    EXPECT_EQ(0, counts.pending);
+}
+
+TEST_F(SQLiteClientTest, RenderJobs_ExpiredLease_CannotSettleReclaimedJob) {
+    // Arrange - lease-1 runs out and lease-2 claims the job
+    auto client = createClient(fileDbPath());
+    RenderJob job;
+    job.image_id = "a";
+    job.format = "webp";
+    job.width = 320;
+    job.run_after = 100;
+    ASSERT_TRUE(client->enqueueRenderJobs({job}));
+    auto first = client->claimRenderJobs("lease-1", 1, 200, 500);
+    ASSERT_EQ(1u, first.size());
+    ASSERT_EQ(1u, client->claimRenderJobs("lease-2", 1, 600, 900).size());
+
+    // Act
+    EXPECT_TRUE(client->releaseRenderJob("lease-1", first[0].job_id, std::nullopt, "late failure"));
+    EXPECT_TRUE(client->completeRenderJobs("lease-1", {first[0].job_id}));
+
+    // Assert
+    RenderJobCounts counts = client->getRenderJobCounts(600);
+    EXPECT_EQ(1, counts.leased) << "The stale claim should leave lease-2's job alone";
+    EXPECT_EQ(0, counts.failed);
+    EXPECT_TRUE(client->completeRenderJobs("lease-2", {first[0].job_id}));
+    EXPECT_EQ(0, client->getRenderJobCounts(600).leased);
+}
+
+TEST_F(SQLiteClientTest, RenderJobs_RequeuedWhileLeased_SurvivesCompletion) {
+    // Arrange
+    auto client = createClient(fileDbPath());
+    RenderJob job;
+    job.image_id = "a";
+    job.format = "webp";
+    job.width = 320;
+    job.run_after = 100;
+    ASSERT_TRUE(client->enqueueRenderJobs({job}));
+    auto claimed = client->claimRenderJobs("lease-1", 1, 200, 500);
+    ASSERT_EQ(1u, claimed.size());
+
+    // Act - queued again while lease-1 works on it
+    ASSERT_TRUE(client->enqueueRenderJobs({job}));
+    EXPECT_TRUE(client->completeRenderJobs("lease-1", {claimed[0].job_id}));
+
+    // Assert - the newer request runs once the lease expires
+    auto again = client->claimRenderJobs("lease-2", 1, 600, 900);
+    ASSERT_EQ(1u, again.size());
+    EXPECT_EQ(claimed[0].job_id, again[0].job_id);
+}
+
+// ============================================================================
+// Concurrency Tests
+// ============================================================================
+
+TEST_F(SQLiteClientTest, ConcurrentReadsAndWrites_AllSucceed) {
+    // Arrange
+    SQLiteConfig config;
+    config.read_connections = 2;
+    auto client = createClient(fileDbPath(), config);
+    ASSERT_TRUE(client->putImageMetadata(makeImage(TEST_IMAGE_ID, "photo", 100)));
+    std::atomic<int> failures{0};
+
+    // Act
+    std::vector<std::thread> threads;
+    threads.emplace_back([&]() {
+        for (int i = 0; i < THREAD_ITERATION_COUNT; ++i) {
+            if (!client->putImageMetadata(makeImage("w" + std::to_string(i), "w", i))) {
+                failures++;
+            }
+        }
+    });
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&]() {
+            for (int i = 0; i < THREAD_ITERATION_COUNT; ++i) {
+                if (!client->imageExists(TEST_IMAGE_ID)) {
+                    failures++;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    // Assert
+    EXPECT_EQ(0, failures.load());
+    EXPECT_EQ(THREAD_ITERATION_COUNT + 1, client->getImageCount());
+}
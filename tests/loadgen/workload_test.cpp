@@ -0,0 +1,205 @@
+#include <gtest/gtest.h>
+#include "loadgen/loadgen_config.h"
+#include "loadgen/workload.h"
+#include "utils/multipart_parser.h"
+#include <filesystem>
+#include <fstream>
+#include <set>
+
+using namespace gara;
+using namespace gara::loadgen;
+
+class WorkloadTest : public ::testing::Test {
+protected:
+    static Corpus sampleCorpus() {
+        Corpus corpus;
+        corpus.image_ids = {"img1", "img2", "img3"};
+        corpus.album_ids = {"album1"};
+        corpus.upload_payload = {'\xFF', '\xD8', '\xFF', '\xD9'};
+        return corpus;
+    }
+
+    std::mt19937_64 rng_{7};
+};
+
+// ============================================================================
+// Traffic Mix Tests
+// ============================================================================
+
+TEST_F(WorkloadTest, TrafficMixParse_ValidSpec_SetsWeights) {
+    // Act
+    std::string error;
+    auto mix = TrafficMix::parse("cached_get=3,list=1", error);
+
+    // Assert
+    ASSERT_TRUE(mix.has_value()) << error;
+    EXPECT_DOUBLE_EQ(mix->weights[static_cast<size_t>(Operation::CACHED_GET)], 3.0);
+    EXPECT_DOUBLE_EQ(mix->weights[static_cast<size_t>(Operation::LIST)], 1.0);
+    EXPECT_DOUBLE_EQ(mix->weights[static_cast<size_t>(Operation::UPLOAD)], 0.0);
+}
+
+TEST_F(WorkloadTest, TrafficMixParse_UnknownOperation_Fails) {
+    std::string error;
+    EXPECT_FALSE(TrafficMix::parse("cached_get=1,delete=2", error).has_value());
+    EXPECT_NE(error.find("delete"), std::string::npos);
+}
+
+TEST_F(WorkloadTest, TrafficMixParse_AllZero_Fails) {
+    std::string error;
+    EXPECT_FALSE(TrafficMix::parse("list=0", error).has_value());
+}
+
+TEST_F(WorkloadTest, TrafficMixPick_SingleOperation_AlwaysPicksIt) {
+    std::string error;
+    auto mix = TrafficMix::parse("album=1", error);
+
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ(mix->pick(rng_), Operation::ALBUM);
+    }
+}
+
+// ============================================================================
+// Request Generation Tests
+// ============================================================================
+
+TEST_F(WorkloadTest, Build_ColdGet_NeverRepeatsAPath) {
+    // Arrange
+    WorkloadGenerator generator(TrafficMix::defaults(), sampleCorpus());
+    std::set<std::string> paths;
+
+    // Act
+    for (int i = 0; i < 5000; ++i) {
+        paths.insert(generator.build(Operation::COLD_GET, rng_).path);
+    }
+
+    // Assert
+    EXPECT_EQ(paths.size(), 5000u);
+}
+
+TEST_F(WorkloadTest, Build_CachedGet_StaysInWarmSet) {
+    // Arrange
+    WorkloadGenerator generator(TrafficMix::defaults(), sampleCorpus(), 2);
+    std::set<std::string> paths;
+
+    // Act
+    for (int i = 0; i < 200; ++i) {
+        paths.insert(generator.build(Operation::CACHED_GET, rng_).path);
+    }
+
+    // Assert
+    EXPECT_EQ(paths.size(), 2u);
+}
+
+TEST_F(WorkloadTest, Build_NoImages_FallsBackToList) {
+    WorkloadGenerator generator(TrafficMix::defaults(), Corpus());
+
+    PlannedRequest request = generator.build(Operation::CACHED_GET, rng_);
+
+    EXPECT_EQ(request.op, Operation::LIST);
+    EXPECT_EQ(request.path.rfind("/api/images?", 0), 0u);
+}
+
+TEST_F(WorkloadTest, Build_Upload_IsParseableAndUnique) {
+    // Arrange
+    WorkloadGenerator generator(TrafficMix::defaults(), sampleCorpus());
+
+    // Act
+    PlannedRequest first = generator.build(Operation::UPLOAD, rng_);
+    PlannedRequest second = generator.build(Operation::UPLOAD, rng_);
+
+    // Assert
+    EXPECT_EQ(first.method, "POST");
+    EXPECT_TRUE(first.authenticated);
+    auto part = utils::MultipartParser::findFilePart(first.body, first.content_type);
+    ASSERT_TRUE(part.has_value());
+    EXPECT_EQ(part->filename, "loadgen.jpg");
+    EXPECT_EQ(part->data.substr(0, 4), std::string("\xFF\xD8\xFF\xD9", 4));
+    EXPECT_NE(first.body, second.body);
+}
+
+// ============================================================================
+// Access Log Tests
+// ============================================================================
+
+TEST_F(WorkloadTest, ParseLine_CombinedFormat_ExtractsRequestAndTime) {
+    // Act
+    auto parsed = AccessLog::parseLine(
+        "10.0.0.1 - - [10/Oct/2000:13:55:36 -0700] \"GET /api/images/abc?width=320 HTTP/1.1\" 200 2326 \"-\" \"curl\"");
+
+    // Assert
+    ASSERT_TRUE(parsed.has_value());
+    EXPECT_DOUBLE_EQ(parsed->first, 971211336.0);  // 2000-10-10T20:55:36Z
+    EXPECT_EQ(parsed->second.method, "GET");
+    EXPECT_EQ(parsed->second.path, "/api/images/abc?width=320");
+}
+
+TEST_F(WorkloadTest, ParseLine_JsonLine_ReadsPathAndMillisecondTimestamp) {
+    auto parsed = AccessLog::parseLine("{\"method\":\"get\",\"path\":\"/api/albums\",\"timestamp\":1700000000500}");
+
+    ASSERT_TRUE(parsed.has_value());
+    EXPECT_DOUBLE_EQ(parsed->first, 1700000000.5);
+    EXPECT_EQ(parsed->second.method, "GET");
+    EXPECT_EQ(parsed->second.path, "/api/albums");
+}
+
+TEST_F(WorkloadTest, ParseLine_Garbage_ReturnsNullopt) {
+    EXPECT_FALSE(AccessLog::parseLine("not a log line").has_value());
+    EXPECT_FALSE(AccessLog::parseLine("").has_value());
+    EXPECT_FALSE(AccessLog::parseLine("{\"message\":\"started\"}").has_value());
+}
+
+TEST_F(WorkloadTest, Load_MixedLog_SortsRebasesAndSkipsWrites) {
+    // Arrange
+    auto path = std::filesystem::temp_directory_path() / "gara_loadgen_access.log";
+    {
+        std::ofstream log(path);
+        log << "{\"method\":\"GET\",\"path\":\"/api/images\",\"timestamp\":102}\n";
+        log << "{\"method\":\"GET\",\"path\":\"/health\",\"timestamp\":100}\n";
+        log << "{\"method\":\"POST\",\"path\":\"/api/images/upload\",\"timestamp\":101}\n";
+        log << "garbage\n";
+    }
+
+    // Act
+    size_t skipped = 0;
+    auto entries = AccessLog::load(path.string(), skipped);
+    std::filesystem::remove(path);
+
+    // Assert
+    ASSERT_EQ(entries.size(), 2u);
+    EXPECT_EQ(entries[0].path, "/health");
+    EXPECT_DOUBLE_EQ(entries[0].offset_seconds, 0.0);
+    EXPECT_DOUBLE_EQ(entries[1].offset_seconds, 2.0);
+    EXPECT_EQ(skipped, 2u);
+}
+
+TEST_F(WorkloadTest, Classify_Routes_MapToOperations) {
+    EXPECT_EQ(AccessLog::classify("GET", "/api/images?limit=10"), Operation::LIST);
+    EXPECT_EQ(AccessLog::classify("GET", "/api/images/abc?width=10"), Operation::CACHED_GET);
+    EXPECT_EQ(AccessLog::classify("GET", "/api/albums/a1"), Operation::ALBUM);
+    EXPECT_EQ(AccessLog::classify("POST", "/api/images/upload"), Operation::UPLOAD);
+    EXPECT_EQ(AccessLog::classify("GET", "/metrics"), Operation::OTHER);
+}
+
+// ============================================================================
+// Config Tests
+// ============================================================================
+
+TEST_F(WorkloadTest, FromArgs_ReplayWithoutDuration_RunsWholeLog) {
+    const char* argv[] = {"gara-loadgen", "--mode=replay", "--access-log=/tmp/x.log", "--concurrency=4"};
+    std::string error;
+
+    auto config = LoadgenConfig::fromArgs(4, const_cast<char**>(argv), error);
+
+    ASSERT_TRUE(config.has_value()) << error;
+    EXPECT_EQ(config->mode, LoadMode::REPLAY);
+    EXPECT_EQ(config->duration_seconds, 0);
+    EXPECT_EQ(config->concurrency, 4);
+}
+
+TEST_F(WorkloadTest, FromArgs_UnknownOption_Fails) {
+    const char* argv[] = {"gara-loadgen", "--bogus=1"};
+    std::string error;
+
+    EXPECT_FALSE(LoadgenConfig::fromArgs(2, const_cast<char**>(argv), error).has_value());
+    EXPECT_NE(error.find("bogus"), std::string::npos);
+}
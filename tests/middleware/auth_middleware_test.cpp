@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 #include "middleware/auth_middleware.h"
+#include "services/local_config_service.h"
 #include "test_helpers/test_constants.h"
 #include "test_helpers/custom_matchers.h"
 #include <crow.h>
@@ -132,6 +133,28 @@ TEST_F(AuthMiddlewareTest, ValidateApiKey_WithEmptyExpectedKey_ReturnsFalse) {
         << "Should fail validation when expected key is empty";
 }
 
+TEST_F(AuthMiddlewareTest, ValidateApiKey_WithRotatedKeys_AcceptsEachActiveKey) {
+    // Arrange
+    setenv("GARA_AUTH_TEST_KEYS", "new-key,old-key", 1);
+    gara::LocalConfigService config_service("GARA_AUTH_TEST_KEYS");
+    unsetenv("GARA_AUTH_TEST_KEYS");
+
+    // Act & Assert
+    EXPECT_TRUE(AuthMiddleware::validateApiKey(createMockRequest({{HTTP_HEADER_API_KEY, "new-key"}}), config_service));
+    EXPECT_TRUE(AuthMiddleware::validateApiKey(createMockRequest({{HTTP_HEADER_API_KEY, "old-key"}}), config_service));
+    EXPECT_FALSE(AuthMiddleware::validateApiKey(createMockRequest({{HTTP_HEADER_API_KEY, TEST_API_KEY_WRONG}}), config_service));
+    EXPECT_FALSE(AuthMiddleware::validateApiKey(createMockRequest({}), config_service));
+}
+
+TEST_F(AuthMiddlewareTest, ValidateApiKey_WithUnconfiguredService_ReturnsFalse) {
+    // Arrange
+    gara::LocalConfigService config_service("GARA_AUTH_TEST_UNSET");
+    auto req = createMockRequest({{HTTP_HEADER_API_KEY, TEST_API_KEY_SOME}});
+
+    // Act & Assert
+    EXPECT_FALSE(AuthMiddleware::validateApiKey(req, config_service));
+}
+
 // ============================================================================
 // Constant Time Comparison Tests
 // ============================================================================
@@ -4,8 +4,11 @@
 #include "../../src/interfaces/database_client_interface.h"
 #include "../../src/models/album.h"
 #include <map>
+#include <unordered_set>
+#include <vector>
 #include <string>
 #include <mutex>
+#include <tuple>
 #include <optional>
 #include <algorithm>
 
@@ -23,16 +26,31 @@ public:
 
     bool putAlbum(const Album& album) override {
         std::lock_guard<std::mutex> lock(mutex_);
-        albums_[album.album_id] = album;
+
+        // Like the SQL clients, image_ids only seed a new album's membership
+        auto it = albums_.find(album.album_id);
+        if (it != albums_.end()) {
+            std::vector<std::string> image_ids = std::move(it->second.image_ids);
+            it->second = album;
+            it->second.image_ids = std::move(image_ids);
+        } else {
+            albums_[album.album_id] = album;
+        }
         return true;
     }
 
-    std::optional<Album> getAlbum(const std::string& album_id) override {
+    std::optional<Album> getAlbum(const std::string& album_id, bool include_images = true) override {
         std::lock_guard<std::mutex> lock(mutex_);
 
         auto it = albums_.find(album_id);
         if (it != albums_.end()) {
-            return it->second;
+            Album album = it->second;
+            if (!include_images) {
+                album.image_ids.clear();
+            } else {
+                ++membership_reads_;
+            }
+            return album;
         }
         return std::nullopt;
     }
@@ -56,6 +74,36 @@ public:
         return result;
     }
 
+    std::vector<Album> listAlbumsAfter(const AlbumQuery& query, int limit,
+                                       const std::optional<AlbumPageCursor>& after) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        std::vector<Album> matches;
+        for (const auto& [id, album] : albums_) {
+            if (query.published_only && !album.published) {
+                continue;
+            }
+            bool has_tags = std::all_of(query.tags.begin(), query.tags.end(), [&album](const std::string& tag) {
+                return std::find(album.tags.begin(), album.tags.end(), tag) != album.tags.end();
+            });
+            if (!has_tags) {
+                continue;
+            }
+            if (after && std::tie(album.created_at, album.album_id) >= std::tie(after->created_at, after->album_id)) {
+                continue;
+            }
+            matches.push_back(album);
+        }
+
+        std::sort(matches.begin(), matches.end(), [](const Album& a, const Album& b) {
+            return std::tie(a.created_at, a.album_id) > std::tie(b.created_at, b.album_id);
+        });
+        if (matches.size() > static_cast<size_t>(limit)) {
+            matches.resize(limit);
+        }
+        return matches;
+    }
+
     bool deleteAlbum(const std::string& album_id) override {
         std::lock_guard<std::mutex> lock(mutex_);
 
@@ -78,13 +126,122 @@ public:
         return false;
     }
 
+    // Album membership operations
+    bool addAlbumImages(const std::string& album_id, const std::vector<std::string>& image_ids,
+                        int position, std::time_t updated_at) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        auto it = albums_.find(album_id);
+        if (it == albums_.end()) {
+            return false;
+        }
+
+        auto& ids = it->second.image_ids;
+        auto insert_at = position >= 0 && position < static_cast<int>(ids.size())
+            ? ids.begin() + position
+            : ids.end();
+        ids.insert(insert_at, image_ids.begin(), image_ids.end());
+        it->second.updated_at = updated_at;
+        return true;
+    }
+
+    bool removeAlbumImage(const std::string& album_id, const std::string& image_id,
+                          std::time_t updated_at) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        auto it = albums_.find(album_id);
+        if (it == albums_.end()) {
+            return false;
+        }
+
+        auto& ids = it->second.image_ids;
+        auto pos = std::find(ids.begin(), ids.end(), image_id);
+        if (pos == ids.end()) {
+            return false;
+        }
+        ids.erase(pos);
+        it->second.updated_at = updated_at;
+        return true;
+    }
+
+    bool reorderAlbumImages(const std::string& album_id, const std::vector<std::string>& image_ids,
+                            std::time_t updated_at) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        auto it = albums_.find(album_id);
+        if (it == albums_.end()) {
+            return false;
+        }
+        it->second.image_ids = image_ids;
+        it->second.updated_at = updated_at;
+        return true;
+    }
+
+    std::vector<std::string> listAlbumImages(const std::string& album_id, int limit, int offset) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        auto it = albums_.find(album_id);
+        if (it == albums_.end()) {
+            return {};
+        }
+
+        const auto& ids = it->second.image_ids;
+        size_t start = std::min(static_cast<size_t>(offset), ids.size());
+        size_t end = limit < 0 ? ids.size() : std::min(start + static_cast<size_t>(limit), ids.size());
+        return std::vector<std::string>(ids.begin() + start, ids.begin() + end);
+    }
+
+    int getAlbumImageCount(const std::string& album_id) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        auto it = albums_.find(album_id);
+        return it == albums_.end() ? 0 : static_cast<int>(it->second.image_ids.size());
+    }
+
+    std::optional<std::unordered_set<std::string>> albumImagesContained(
+        const std::string& album_id, const std::vector<std::string>& image_ids) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        if (fail_membership_checks_) {
+            return std::nullopt;
+        }
+        std::unordered_set<std::string> found;
+        auto it = albums_.find(album_id);
+        if (it == albums_.end()) {
+            return found;
+        }
+        const auto& members = it->second.image_ids;
+        for (const auto& image_id : image_ids) {
+            if (std::find(members.begin(), members.end(), image_id) != members.end()) {
+                found.insert(image_id);
+            }
+        }
+        return found;
+    }
+
     // Image metadata operations
     bool putImageMetadata(const ImageMetadata& metadata) override {
         std::lock_guard<std::mutex> lock(mutex_);
+        ++image_writes_;
+        if (fail_image_writes_) {
+            return false;
+        }
         images_[metadata.image_id] = metadata;
         return true;
     }
 
+    bool putImageMetadataBatch(const std::vector<ImageMetadata>& batch) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++image_writes_;
+        if (fail_image_writes_) {
+            return false;
+        }
+        for (const auto& metadata : batch) {
+            images_[metadata.image_id] = metadata;
+        }
+        return true;
+    }
+
     std::optional<ImageMetadata> getImageMetadata(const std::string& image_id) override {
         std::lock_guard<std::mutex> lock(mutex_);
 
@@ -98,39 +255,7 @@ public:
     std::vector<ImageMetadata> listImages(int limit, int offset, ImageSortOrder sort_order) override {
         std::lock_guard<std::mutex> lock(mutex_);
 
-        // Convert map to vector
-        std::vector<ImageMetadata> all_images;
-        for (const auto& [id, img] : images_) {
-            all_images.push_back(img);
-        }
-
-        // Sort based on sort_order
-        switch (sort_order) {
-            case ImageSortOrder::NEWEST:
-                std::sort(all_images.begin(), all_images.end(),
-                         [](const ImageMetadata& a, const ImageMetadata& b) {
-                             return a.upload_timestamp > b.upload_timestamp;
-                         });
-                break;
-            case ImageSortOrder::OLDEST:
-                std::sort(all_images.begin(), all_images.end(),
-                         [](const ImageMetadata& a, const ImageMetadata& b) {
-                             return a.upload_timestamp < b.upload_timestamp;
-                         });
-                break;
-            case ImageSortOrder::NAME_ASC:
-                std::sort(all_images.begin(), all_images.end(),
-                         [](const ImageMetadata& a, const ImageMetadata& b) {
-                             return a.name < b.name;
-                         });
-                break;
-            case ImageSortOrder::NAME_DESC:
-                std::sort(all_images.begin(), all_images.end(),
-                         [](const ImageMetadata& a, const ImageMetadata& b) {
-                             return a.name > b.name;
-                         });
-                break;
-        }
+        std::vector<ImageMetadata> all_images = sortedImages(sort_order);
 
         // Apply pagination
         std::vector<ImageMetadata> result;
@@ -144,6 +269,24 @@ public:
         return result;
     }
 
+    std::vector<ImageMetadata> listImagesAfter(int limit, ImageSortOrder sort_order,
+                                               const std::optional<ImagePageCursor>& after) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        std::vector<ImageMetadata> result;
+        for (const auto& img : sortedImages(sort_order)) {
+            if (result.size() >= static_cast<size_t>(limit)) {
+                break;
+            }
+            if (after && !comesAfter(img, *after, sort_order)) {
+                continue;
+            }
+            result.push_back(img);
+        }
+
+        return result;
+    }
+
     int getImageCount() override {
         std::lock_guard<std::mutex> lock(mutex_);
         return static_cast<int>(images_.size());
@@ -154,11 +297,240 @@ public:
         return images_.find(image_id) != images_.end();
     }
 
+    std::unordered_set<std::string> imagesExist(const std::vector<std::string>& image_ids) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++batch_exists_calls_;
+
+        std::unordered_set<std::string> found;
+        for (const auto& image_id : image_ids) {
+            if (images_.count(image_id)) {
+                found.insert(image_id);
+            }
+        }
+        return found;
+    }
+
+    std::unordered_map<std::string, std::string> getImagePlaceholders(
+        const std::vector<std::string>& image_ids) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        std::unordered_map<std::string, std::string> placeholders;
+        for (const auto& image_id : image_ids) {
+            auto it = images_.find(image_id);
+            if (it != images_.end() && !it->second.placeholder.empty()) {
+                placeholders[image_id] = it->second.placeholder;
+            }
+        }
+        return placeholders;
+    }
+
+    bool putRendition(const RenditionRecord& record) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        renditions_[record.storage_key] = record;
+        return true;
+    }
+
+    bool touchRenditions(const std::vector<std::string>& storage_keys, std::time_t accessed_at) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& key : storage_keys) {
+            auto it = renditions_.find(key);
+            if (it != renditions_.end()) {
+                it->second.last_accessed = std::max(it->second.last_accessed, accessed_at);
+                ++it->second.hits;
+            }
+        }
+        return true;
+    }
+
+    std::vector<std::string> listRenditionKeys(const std::string& image_id) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::vector<std::string> keys;
+        for (const auto& [key, record] : renditions_) {
+            if (record.image_id == image_id) {
+                keys.push_back(key);
+            }
+        }
+        return keys;
+    }
+
+    std::vector<RenditionRecord> listEvictionCandidates(int limit, RenditionEvictionPolicy policy) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::vector<RenditionRecord> records;
+        for (const auto& [key, record] : renditions_) {
+            records.push_back(record);
+        }
+        std::sort(records.begin(), records.end(), [policy](const RenditionRecord& a, const RenditionRecord& b) {
+            if (policy == RenditionEvictionPolicy::LFU) {
+                return std::tie(a.hits, a.last_accessed) < std::tie(b.hits, b.last_accessed);
+            }
+            return a.last_accessed < b.last_accessed;
+        });
+        if (records.size() > static_cast<size_t>(std::max(limit, 0))) {
+            records.resize(static_cast<size_t>(std::max(limit, 0)));
+        }
+        return records;
+    }
+
+    bool deleteRenditions(const std::vector<std::string>& storage_keys) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& key : storage_keys) {
+            renditions_.erase(key);
+        }
+        return true;
+    }
+
+    uint64_t getRenditionBytes() override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        uint64_t total = 0;
+        for (const auto& [key, record] : renditions_) {
+            total += record.size_bytes;
+        }
+        return total;
+    }
+
+    bool enqueueRenderJobs(const std::vector<RenderJob>& jobs) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& job : jobs) {
+            auto existing = std::find_if(render_jobs_.begin(), render_jobs_.end(), [&job](const auto& entry) {
+                const RenderJob& queued = entry.second.job;
+                return std::tie(queued.image_id, queued.format, queued.width, queued.height,
+                                queued.quality, queued.profile) ==
+                       std::tie(job.image_id, job.format, job.width, job.height, job.quality, job.profile);
+            });
+            if (existing == render_jobs_.end()) {
+                QueuedRenderJob queued;
+                queued.job = job;
+                queued.job.job_id = next_render_job_id_++;
+                queued.job.attempts = 0;
+                render_jobs_[queued.job.job_id] = queued;
+                continue;
+            }
+            QueuedRenderJob& queued = existing->second;
+            queued.job.priority = std::max(queued.job.priority, job.priority);
+            if (queued.failed) {
+                queued.job.attempts = 0;
+                queued.job.run_after = job.run_after;
+                queued.failed = false;
+            }
+            queued.lease_token.clear();
+        }
+        return true;
+    }
+
+    std::vector<RenderJob> claimRenderJobs(const std::string& lease_token, int max_images,
+                                           std::time_t now, std::time_t lease_expires_at) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto ready = [now](const QueuedRenderJob& queued) {
+            return !queued.failed && queued.job.run_after <= now && queued.lease_expires_at <= now;
+        };
+
+        std::vector<const RenderJob*> candidates;
+        for (const auto& [job_id, queued] : render_jobs_) {
+            if (ready(queued)) {
+                candidates.push_back(&queued.job);
+            }
+        }
+        std::sort(candidates.begin(), candidates.end(), [](const RenderJob* a, const RenderJob* b) {
+            return std::make_tuple(-a->priority, a->run_after, a->job_id) <
+                   std::make_tuple(-b->priority, b->run_after, b->job_id);
+        });
+        // max_images distinct images, in the order of their best job
+        std::unordered_set<std::string> image_ids;
+        for (size_t i = 0; i < candidates.size() && image_ids.size() < static_cast<size_t>(std::max(max_images, 0));
+             ++i) {
+            image_ids.insert(candidates[i]->image_id);
+        }
+
+        std::vector<RenderJob> claimed;
+        for (auto& [job_id, queued] : render_jobs_) {
+            if (ready(queued) && image_ids.count(queued.job.image_id)) {
+                queued.lease_token = lease_token;
+                queued.lease_expires_at = lease_expires_at;
+                ++queued.job.attempts;
+                claimed.push_back(queued.job);
+            }
+        }
+        std::sort(claimed.begin(), claimed.end(), [](const RenderJob& a, const RenderJob& b) {
+            return std::make_tuple(a.image_id, -a.priority, a.job_id) <
+                   std::make_tuple(b.image_id, -b.priority, b.job_id);
+        });
+        return claimed;
+    }
+
+    bool completeRenderJobs(const std::string& lease_token, const std::vector<int64_t>& job_ids) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (int64_t job_id : job_ids) {
+            auto it = render_jobs_.find(job_id);
+            if (it != render_jobs_.end() && it->second.lease_token == lease_token) {
+                render_jobs_.erase(it);
+            }
+        }
+        return true;
+    }
+
+    bool releaseRenderJob(const std::string& lease_token, int64_t job_id,
+                          std::optional<std::time_t> retry_at, const std::string& error) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = render_jobs_.find(job_id);
+        if (it == render_jobs_.end() || it->second.lease_token != lease_token) {
+            return true;
+        }
+        it->second.lease_token.clear();
+        it->second.lease_expires_at = 0;
+        it->second.failed = !retry_at.has_value();
+        if (retry_at) {
+            it->second.job.run_after = *retry_at;
+        }
+        it->second.last_error = error;
+        return true;
+    }
+
+    RenderJobCounts getRenderJobCounts(std::time_t now) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        RenderJobCounts counts;
+        for (const auto& [job_id, queued] : render_jobs_) {
+            if (queued.failed) {
+                ++counts.failed;
+            } else if (queued.lease_expires_at > now) {
+                ++counts.leased;
+            } else {
+                ++counts.pending;
+            }
+        }
+        return counts;
+    }
+
     // Test helper methods
     void clear() {
         std::lock_guard<std::mutex> lock(mutex_);
         albums_.clear();
         images_.clear();
+        renditions_.clear();
+        render_jobs_.clear();
+    }
+
+    // Queued render job by ID (completed jobs are removed)
+    std::optional<RenderJob> getRenderJob(int64_t job_id) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = render_jobs_.find(job_id);
+        if (it == render_jobs_.end()) {
+            return std::nullopt;
+        }
+        return it->second.job;
+    }
+
+    size_t getRenditionCount() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return renditions_.size();
+    }
+
+    std::optional<RenditionRecord> getRendition(const std::string& storage_key) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = renditions_.find(storage_key);
+        if (it == renditions_.end()) {
+            return std::nullopt;
+        }
+        return it->second;
     }
 
     size_t getAlbumCount() const {
@@ -171,10 +543,91 @@ public:
         return images_.size();
     }
 
+    size_t getBatchExistsCallCount() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return batch_exists_calls_;
+    }
+
+    // getAlbum calls that loaded the album's membership
+    size_t getMembershipReadCount() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return membership_reads_;
+    }
+
+    // Make putImageMetadata and putImageMetadataBatch fail without storing anything
+    void setFailImageWrites(bool fail) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        fail_image_writes_ = fail;
+    }
+
+    // Make albumImagesContained fail as on a database error
+    void setFailMembershipChecks(bool fail) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        fail_membership_checks_ = fail;
+    }
+
+    // putImageMetadata and putImageMetadataBatch calls, failed ones included
+    size_t getImageWriteCount() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return image_writes_;
+    }
+
 private:
+    // Mirrors the SQL ORDER BY, with image_id as the tie-breaker
+    static bool lessFor(const ImageMetadata& a, const ImageMetadata& b, ImageSortOrder sort_order) {
+        switch (sort_order) {
+            case ImageSortOrder::OLDEST:
+                return std::tie(a.upload_timestamp, a.image_id) < std::tie(b.upload_timestamp, b.image_id);
+            case ImageSortOrder::NAME_ASC:
+                return std::tie(a.name, a.image_id) < std::tie(b.name, b.image_id);
+            case ImageSortOrder::NAME_DESC:
+                return std::tie(a.name, a.image_id) > std::tie(b.name, b.image_id);
+            case ImageSortOrder::NEWEST:
+            default:
+                return std::tie(a.upload_timestamp, a.image_id) > std::tie(b.upload_timestamp, b.image_id);
+        }
+    }
+
+    static bool comesAfter(const ImageMetadata& img, const ImagePageCursor& cursor,
+                           ImageSortOrder sort_order) {
+        ImageMetadata boundary;
+        boundary.image_id = cursor.image_id;
+        boundary.name = cursor.name;
+        boundary.upload_timestamp = cursor.uploaded_at;
+        return lessFor(boundary, img, sort_order);
+    }
+
+    std::vector<ImageMetadata> sortedImages(ImageSortOrder sort_order) const {
+        std::vector<ImageMetadata> all_images;
+        for (const auto& [id, img] : images_) {
+            all_images.push_back(img);
+        }
+        std::sort(all_images.begin(), all_images.end(),
+                 [sort_order](const ImageMetadata& a, const ImageMetadata& b) {
+                     return lessFor(a, b, sort_order);
+                 });
+        return all_images;
+    }
+
     mutable std::mutex mutex_;
     std::map<std::string, Album> albums_;
     std::map<std::string, ImageMetadata> images_;
+    std::map<std::string, RenditionRecord> renditions_;
+    size_t batch_exists_calls_ = 0;
+    size_t membership_reads_ = 0;
+    size_t image_writes_ = 0;
+    bool fail_image_writes_ = false;
+    bool fail_membership_checks_ = false;
+
+    struct QueuedRenderJob {
+        RenderJob job;
+        std::string lease_token;
+        std::time_t lease_expires_at = 0;
+        bool failed = false;
+        std::string last_error;
+    };
+    std::map<int64_t, QueuedRenderJob> render_jobs_;
+    int64_t next_render_job_id_ = 1;
 };
 
 } // namespace testing
@@ -6,6 +6,8 @@
 #include <vector>
 #include <fstream>
 #include <mutex>
+#include <cstdio>
+#include <functional>
 
 namespace gara {
 namespace testing {
@@ -44,6 +46,25 @@ public:
         return true;
     }
 
+    bool moveFileToStorage(const std::string& local_path, const std::string& key,
+                           const std::string& content_type = "application/octet-stream") override {
+        std::function<void(const std::string&)> hook;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ++move_calls_;
+            hook = move_hook_;
+        }
+        // Runs unlocked so a test can block or fail one write while others proceed
+        if (hook) {
+            hook(key);
+        }
+        if (!uploadFile(local_path, key, content_type)) {
+            return false;
+        }
+        std::remove(local_path.c_str());
+        return true;
+    }
+
     bool downloadFile(const std::string& key, const std::string& local_path) override {
         std::lock_guard<std::mutex> lock(mutex_);
 
@@ -109,11 +130,24 @@ public:
         return storage_.size();
     }
 
+    // Called with the key before each moveFileToStorage stores it; may block or throw
+    void setMoveHook(std::function<void(const std::string&)> hook) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        move_hook_ = std::move(hook);
+    }
+
+    size_t getMoveCallCount() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return move_calls_;
+    }
+
 private:
     std::string bucket_name_;
     mutable std::mutex mutex_;
     std::map<std::string, std::vector<char>> storage_;
     std::map<std::string, std::string> content_types_;
+    std::function<void(const std::string&)> move_hook_;
+    size_t move_calls_ = 0;
 };
 
 } // namespace testing
@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+#include "services/album_cache.h"
+
+using namespace gara;
+
+class AlbumCacheTest : public ::testing::Test {
+protected:
+    static std::shared_ptr<const Album> makeAlbum(const std::string& id, const std::string& name) {
+        return std::make_shared<const Album>(id, name);
+    }
+
+    static std::shared_ptr<const AlbumCache::Listing> makeListing(const std::string& body) {
+        auto listing = std::make_shared<AlbumCache::Listing>();
+        listing->body = body;
+        return listing;
+    }
+};
+
+// ============================================================================
+// Album Entry Tests
+// ============================================================================
+
+TEST_F(AlbumCacheTest, PutAlbum_CurrentVersion_IsReturned) {
+    // Arrange
+    AlbumCache cache{AlbumCacheConfig()};
+
+    // Act
+    cache.putAlbum(makeAlbum("a1", "Holiday"), cache.version());
+    auto cached = cache.getAlbum("a1");
+
+    // Assert
+    ASSERT_NE(nullptr, cached);
+    EXPECT_EQ("Holiday", cached->name);
+    EXPECT_EQ(nullptr, cache.getAlbum("a2"));
+}
+
+TEST_F(AlbumCacheTest, PutAlbum_WriteSinceRead_IsDropped) {
+    // Arrange
+    AlbumCache cache{AlbumCacheConfig()};
+    uint64_t read_version = cache.version();
+
+    // Act: a write lands while the old row is in flight
+    cache.invalidate("a1");
+    cache.putAlbum(makeAlbum("a1", "Old name"), read_version);
+
+    // Assert
+    EXPECT_EQ(nullptr, cache.getAlbum("a1"));
+}
+
+// ============================================================================
+// Listing Tests
+// ============================================================================
+
+TEST_F(AlbumCacheTest, GetListing_KeyedByPublishedOnly) {
+    // Arrange
+    AlbumCache cache{AlbumCacheConfig()};
+
+    // Act
+    cache.putListing(true, makeListing("published"), cache.version());
+
+    // Assert
+    ASSERT_NE(nullptr, cache.getListing(true));
+    EXPECT_EQ("published", cache.getListing(true)->body);
+    EXPECT_EQ(nullptr, cache.getListing(false));
+}
+
+TEST_F(AlbumCacheTest, Invalidate_DropsAlbumAndListings) {
+    // Arrange
+    AlbumCache cache{AlbumCacheConfig()};
+    cache.putAlbum(makeAlbum("a1", "Holiday"), cache.version());
+    cache.putAlbum(makeAlbum("a2", "Work"), cache.version());
+    cache.putListing(false, makeListing("all"), cache.version());
+    cache.putListing(true, makeListing("published"), cache.version());
+
+    // Act
+    cache.invalidate("a1");
+
+    // Assert
+    EXPECT_EQ(nullptr, cache.getAlbum("a1"));
+    EXPECT_NE(nullptr, cache.getAlbum("a2"));
+    EXPECT_EQ(nullptr, cache.getListing(false));
+    EXPECT_EQ(nullptr, cache.getListing(true));
+}
+
+TEST_F(AlbumCacheTest, ZeroTtl_DisablesCache) {
+    // Arrange
+    AlbumCacheConfig config;
+    config.ttl_seconds = 0;
+    AlbumCache cache{config};
+
+    // Act
+    cache.putAlbum(makeAlbum("a1", "Holiday"), cache.version());
+    cache.putListing(false, makeListing("all"), cache.version());
+
+    // Assert
+    EXPECT_FALSE(cache.enabled());
+    EXPECT_EQ(nullptr, cache.getAlbum("a1"));
+    EXPECT_EQ(nullptr, cache.getListing(false));
+}
@@ -9,6 +9,7 @@
 #include "test_helpers/custom_matchers.h"
 #include "utils/logger.h"
 #include "utils/metrics.h"
+#include <functional>
 #include <memory>
 
 using namespace gara;
@@ -396,6 +397,126 @@ TEST_F(AlbumServiceTest, AddImages_WithNonexistentImages_ThrowsValidationExcepti
     ) << "Adding non-existent images should throw ValidationException";
 }
 
+TEST_F(AlbumServiceTest, AddImages_ImagesWithMetadata_ValidatedInOneBatch) {
+    // Arrange - metadata only, so any storage probe would fail the request
+    Album album = album_service_->createAlbum(CreateAlbumRequestBuilder().withName(ALBUM_NAME_TEST).build());
+    for (const auto& id : {TEST_IMAGE_ID_1, TEST_IMAGE_ID_2, TEST_IMAGE_ID_3}) {
+        fake_db_client_->putImageMetadata(
+            ImageMetadata(id, FORMAT_JPG, ImageMetadata::generateRawKey(id, FORMAT_JPG), SMALL_DATA_SIZE));
+    }
+
+    auto add_req = AddImagesRequestBuilder()
+        .addImageId(TEST_IMAGE_ID_1)
+        .addImageId(TEST_IMAGE_ID_2)
+        .addImageId(TEST_IMAGE_ID_3)
+        .build();
+
+    // Act
+    Album updated = album_service_->addImages(album.album_id, add_req);
+
+    // Assert
+    EXPECT_EQ(ALBUM_IMAGES_COUNT_THREE, updated.image_ids.size());
+    EXPECT_EQ(1u, fake_db_client_->getBatchExistsCallCount())
+        << "All images should be checked with a single batch lookup";
+}
+
+TEST_F(AlbumServiceTest, AddImages_SameImageTwiceInRequest_ThrowsValidationException) {
+    // Arrange
+    Album album = album_service_->createAlbum(CreateAlbumRequestBuilder().withName(ALBUM_NAME_TEST).build());
+    uploadFakeImage(TEST_IMAGE_ID_1, FORMAT_JPG);
+
+    auto add_req = AddImagesRequestBuilder()
+        .addImageId(TEST_IMAGE_ID_1)
+        .addImageId(TEST_IMAGE_ID_1)
+        .build();
+
+    // Act & Assert
+    EXPECT_THROW(album_service_->addImages(album.album_id, add_req), exceptions::ValidationException);
+    EXPECT_TRUE(album_service_->getAlbum(album.album_id).image_ids.empty())
+        << "A rejected request should not add any images";
+}
+
+TEST_F(AlbumServiceTest, AddImages_AtPosition_PersistsOrder) {
+    // Arrange
+    Album album = album_service_->createAlbum(CreateAlbumRequestBuilder().withName(ALBUM_NAME_TEST).build());
+    uploadFakeImage(TEST_IMAGE_ID_1, FORMAT_JPG);
+    uploadFakeImage(TEST_IMAGE_ID_2, FORMAT_JPG);
+    uploadFakeImage(TEST_IMAGE_ID_3, FORMAT_JPG);
+    album_service_->addImages(album.album_id, AddImagesRequestBuilder()
+        .addImageId(TEST_IMAGE_ID_1)
+        .addImageId(TEST_IMAGE_ID_3)
+        .build());
+
+    // Act
+    AddImagesRequest insert_req;
+    insert_req.image_ids = {TEST_IMAGE_ID_2};
+    insert_req.position = 1;
+    Album returned = album_service_->addImages(album.album_id, insert_req);
+
+    // Assert
+    std::vector<std::string> expected = {TEST_IMAGE_ID_1, TEST_IMAGE_ID_2, TEST_IMAGE_ID_3};
+    EXPECT_EQ(expected, returned.image_ids);
+    EXPECT_EQ(expected, album_service_->getAlbum(album.album_id).image_ids);
+}
+
+// ============================================================================
+// List Album Images Tests
+// ============================================================================
+
+TEST_F(AlbumServiceTest, ListAlbumImages_WithLimitAndOffset_ReturnsPageAndTotal) {
+    // Arrange
+    Album album = album_service_->createAlbum(CreateAlbumRequestBuilder().withName(ALBUM_NAME_TEST).build());
+    uploadFakeImage(TEST_IMAGE_ID_1, FORMAT_JPG);
+    uploadFakeImage(TEST_IMAGE_ID_2, FORMAT_JPG);
+    uploadFakeImage(TEST_IMAGE_ID_3, FORMAT_JPG);
+    album_service_->addImages(album.album_id, AddImagesRequestBuilder()
+        .addImageId(TEST_IMAGE_ID_1)
+        .addImageId(TEST_IMAGE_ID_2)
+        .addImageId(TEST_IMAGE_ID_3)
+        .build());
+
+    // Act
+    AlbumImagePage page = album_service_->listAlbumImages(album.album_id, 1, 1);
+
+    // Assert
+    ASSERT_EQ(1u, page.album.image_ids.size());
+    EXPECT_EQ(TEST_IMAGE_ID_2, page.album.image_ids[0]);
+    EXPECT_EQ(static_cast<int>(ALBUM_IMAGES_COUNT_THREE), page.total);
+    EXPECT_EQ(ALBUM_NAME_TEST, page.album.name);
+}
+
+TEST_F(AlbumServiceTest, ListAlbumImages_WithNonexistentAlbum_ThrowsNotFoundException) {
+    // Act & Assert
+    EXPECT_THROW(album_service_->listAlbumImages(ALBUM_ID_NONEXISTENT, 10, 0),
+                 exceptions::NotFoundException);
+}
+
+TEST_F(AlbumServiceTest, ListAlbumsPage_MoreMatchesThanLimit_ReturnsCursorToNextPage) {
+    // Arrange
+    for (int i = 0; i < 3; ++i) {
+        Album album("album-" + std::to_string(i), "Trip " + std::to_string(i));
+        album.created_at = 100 + i;
+        album.tags = {"travel"};
+        fake_db_client_->putAlbum(album);
+    }
+    fake_db_client_->putAlbum(Album("album-untagged", "Misc"));
+    AlbumQuery query;
+    query.tags = {"travel"};
+
+    // Act
+    auto first = album_service_->listAlbumsPage(query, 2, std::nullopt);
+    auto second = album_service_->listAlbumsPage(query, 2, first.next);
+
+    // Assert
+    ASSERT_EQ(2u, first.albums.size());
+    EXPECT_EQ("album-2", first.albums[0].album_id);
+    ASSERT_TRUE(first.next.has_value());
+    EXPECT_EQ("album-1", first.next->album_id);
+    ASSERT_EQ(1u, second.albums.size());
+    EXPECT_EQ("album-0", second.albums[0].album_id);
+    EXPECT_FALSE(second.next.has_value());
+}
+
 // ============================================================================
 // Reorder Images Tests
 // ============================================================================
@@ -429,3 +550,175 @@ TEST_F(AlbumServiceTest, ReorderImages_WithIncorrectCount_ThrowsValidationExcept
         exceptions::ValidationException
     ) << "Reordering with incorrect image count should throw ValidationException";
 }
+
+TEST_F(AlbumServiceTest, ReorderImages_ValidOrder_ChecksMembershipWithoutLoadingIt) {
+    // Arrange
+    Album album = album_service_->createAlbum(CreateAlbumRequestBuilder().withName(ALBUM_NAME_TEST).build());
+    for (const auto& id : {TEST_IMAGE_ID_1, TEST_IMAGE_ID_2, TEST_IMAGE_ID_3}) {
+        uploadFakeImage(id, FORMAT_JPG);
+    }
+    album_service_->addImages(album.album_id, AddImagesRequestBuilder()
+        .addImageId(TEST_IMAGE_ID_1)
+        .addImageId(TEST_IMAGE_ID_2)
+        .addImageId(TEST_IMAGE_ID_3)
+        .build());
+    size_t reads_before = fake_db_client_->getMembershipReadCount();
+
+    ReorderImagesRequest reorder_req;
+    reorder_req.image_ids = {TEST_IMAGE_ID_3, TEST_IMAGE_ID_1, TEST_IMAGE_ID_2};
+
+    // Act
+    Album returned = album_service_->reorderImages(album.album_id, reorder_req);
+
+    // Assert
+    EXPECT_EQ(reads_before, fake_db_client_->getMembershipReadCount())
+        << "Reordering should check membership by key, not load the album's images";
+    EXPECT_EQ(reorder_req.image_ids, returned.image_ids);
+    EXPECT_EQ(reorder_req.image_ids, album_service_->getAlbum(album.album_id).image_ids);
+}
+
+TEST_F(AlbumServiceTest, ReorderImages_RepeatedOrForeignImage_ThrowsValidationException) {
+    // Arrange
+    Album album = album_service_->createAlbum(CreateAlbumRequestBuilder().withName(ALBUM_NAME_TEST).build());
+    uploadFakeImage(TEST_IMAGE_ID_1, FORMAT_JPG);
+    uploadFakeImage(TEST_IMAGE_ID_2, FORMAT_JPG);
+    album_service_->addImages(album.album_id, AddImagesRequestBuilder()
+        .addImageId(TEST_IMAGE_ID_1)
+        .addImageId(TEST_IMAGE_ID_2)
+        .build());
+
+    ReorderImagesRequest repeated;
+    repeated.image_ids = {TEST_IMAGE_ID_1, TEST_IMAGE_ID_1};
+    ReorderImagesRequest foreign;
+    foreign.image_ids = {TEST_IMAGE_ID_1, TEST_IMAGE_ID_3};
+
+    // Act & Assert
+    EXPECT_THROW(album_service_->reorderImages(album.album_id, repeated), exceptions::ValidationException);
+    EXPECT_THROW(album_service_->reorderImages(album.album_id, foreign), exceptions::ValidationException);
+}
+
+// ============================================================================
+// Membership Change Tests
+// ============================================================================
+
+TEST_F(AlbumServiceTest, AddImages_ImageAlreadyInAlbum_ThrowsValidationException) {
+    // Arrange
+    Album album = album_service_->createAlbum(CreateAlbumRequestBuilder().withName(ALBUM_NAME_TEST).build());
+    uploadFakeImage(TEST_IMAGE_ID_1, FORMAT_JPG);
+    uploadFakeImage(TEST_IMAGE_ID_2, FORMAT_JPG);
+    album_service_->addImages(album.album_id, AddImagesRequestBuilder().addImageId(TEST_IMAGE_ID_1).build());
+    size_t reads_before = fake_db_client_->getMembershipReadCount();
+
+    auto add_req = AddImagesRequestBuilder()
+        .addImageId(TEST_IMAGE_ID_2)
+        .addImageId(TEST_IMAGE_ID_1)
+        .build();
+
+    // Act & Assert
+    EXPECT_THROW(album_service_->addImages(album.album_id, add_req), exceptions::ValidationException);
+    EXPECT_EQ(reads_before, fake_db_client_->getMembershipReadCount());
+    EXPECT_EQ(std::vector<std::string>{TEST_IMAGE_ID_1}, album_service_->getAlbum(album.album_id).image_ids);
+}
+
+TEST_F(AlbumServiceTest, RemoveImage_Member_ReturnsRemainingImages) {
+    // Arrange
+    Album album = album_service_->createAlbum(CreateAlbumRequestBuilder().withName(ALBUM_NAME_TEST).build());
+    uploadFakeImage(TEST_IMAGE_ID_1, FORMAT_JPG);
+    uploadFakeImage(TEST_IMAGE_ID_2, FORMAT_JPG);
+    album_service_->addImages(album.album_id, AddImagesRequestBuilder()
+        .addImageId(TEST_IMAGE_ID_1)
+        .addImageId(TEST_IMAGE_ID_2)
+        .build());
+
+    // Act
+    Album returned = album_service_->removeImage(album.album_id, TEST_IMAGE_ID_1);
+
+    // Assert
+    EXPECT_EQ(std::vector<std::string>{TEST_IMAGE_ID_2}, returned.image_ids)
+        << "The response should carry the remaining images";
+    EXPECT_THROW(album_service_->removeImage(album.album_id, TEST_IMAGE_ID_1), exceptions::ValidationException);
+}
+
+TEST_F(AlbumServiceTest, MembershipChanges_MembershipCheckFails_ThrowsRuntimeError) {
+    // Arrange
+    Album album = album_service_->createAlbum(CreateAlbumRequestBuilder().withName(ALBUM_NAME_TEST).build());
+    uploadFakeImage(TEST_IMAGE_ID_1, FORMAT_JPG);
+    uploadFakeImage(TEST_IMAGE_ID_2, FORMAT_JPG);
+    album_service_->addImages(album.album_id, AddImagesRequestBuilder().addImageId(TEST_IMAGE_ID_1).build());
+    fake_db_client_->setFailMembershipChecks(true);
+
+    ReorderImagesRequest reorder_req;
+    reorder_req.image_ids = {TEST_IMAGE_ID_1};
+
+    // ValidationException is a runtime_error too, so check the message
+    auto expectDatabaseError = [](const std::function<void()>& call) {
+        try {
+            call();
+            ADD_FAILURE() << "Expected a database error";
+        } catch (const std::runtime_error& e) {
+            EXPECT_STREQ("Failed to check album membership", e.what())
+                << "A database error should not read as a validation failure";
+        }
+    };
+
+    // Act & Assert
+    expectDatabaseError([&]() { album_service_->removeImage(album.album_id, TEST_IMAGE_ID_1); });
+    expectDatabaseError([&]() { album_service_->reorderImages(album.album_id, reorder_req); });
+    expectDatabaseError([&]() {
+        album_service_->addImages(album.album_id, AddImagesRequestBuilder().addImageId(TEST_IMAGE_ID_2).build());
+    });
+    fake_db_client_->setFailMembershipChecks(false);
+    EXPECT_EQ(std::vector<std::string>{TEST_IMAGE_ID_1}, album_service_->getAlbum(album.album_id).image_ids);
+}
+
+// ============================================================================
+// Read Cache Tests
+// ============================================================================
+
+TEST_F(AlbumServiceTest, GetAlbum_WithCache_ServedWithoutDatabaseUntilWrite) {
+    // Arrange
+    auto cached_service = std::make_shared<AlbumService>(
+        fake_db_client_, fake_file_service_, nullptr, std::make_shared<AlbumCache>(AlbumCacheConfig()));
+    Album album = cached_service->createAlbum(CreateAlbumRequestBuilder().withName(ALBUM_NAME_TEST).build());
+    cached_service->getAlbum(album.album_id);
+
+    // Act: a row changed behind the service is not seen until the service writes
+    Album changed = album;
+    changed.description = "changed in the database";
+    fake_db_client_->putAlbum(changed);
+    Album from_cache = cached_service->getAlbum(album.album_id);
+
+    UpdateAlbumRequest update;
+    update.name = "Renamed";
+    cached_service->updateAlbum(album.album_id, update);
+    Album after_write = cached_service->getAlbum(album.album_id);
+
+    // Assert
+    EXPECT_EQ(album.description, from_cache.description);
+    EXPECT_EQ("Renamed", after_write.name);
+    EXPECT_EQ("changed in the database", after_write.description);
+}
+
+TEST_F(AlbumServiceTest, ListAlbumsJson_WithCache_InvalidatedByCreateAndDelete) {
+    // Arrange
+    auto cached_service = std::make_shared<AlbumService>(
+        fake_db_client_, fake_file_service_, nullptr, std::make_shared<AlbumCache>(AlbumCacheConfig()));
+    Album first = cached_service->createAlbum(CreateAlbumRequestBuilder().withName("First").build());
+    auto before = cached_service->listAlbumsJson();
+
+    // Act
+    Album second = cached_service->createAlbum(CreateAlbumRequestBuilder().withName("Second").build());
+    auto after_create = cached_service->listAlbumsJson();
+    cached_service->deleteAlbum(first.album_id);
+    auto after_delete = cached_service->listAlbumsJson();
+
+    // Assert
+    EXPECT_EQ(1u, nlohmann::json::parse(before->body)["albums"].size());
+    EXPECT_EQ(2u, nlohmann::json::parse(after_create->body)["albums"].size());
+    auto remaining = nlohmann::json::parse(after_delete->body)["albums"];
+    ASSERT_EQ(1u, remaining.size());
+    EXPECT_EQ(second.album_id, remaining[0]["album_id"]);
+    EXPECT_EQ(cached_service->listAlbumsJson().get(), after_delete.get())
+        << "An unchanged listing should be reused, not rebuilt";
+    EXPECT_NE(before->etag, after_create->etag);
+}
@@ -9,7 +9,10 @@
 #include "test_helpers/test_builders.h"
 #include "test_helpers/test_file_manager.h"
 #include "test_helpers/custom_matchers.h"
+#include <atomic>
+#include <chrono>
 #include <memory>
+#include <thread>
 
 using namespace gara;
 using namespace gara::utils;
@@ -151,6 +154,55 @@ TEST_F(CacheManagerTest, StoreInCache_NonExistentFile_ReturnsFalse) {
         << "Failed store should not add to cache";
 }
 
+TEST_F(CacheManagerTest, MoveToCache_WithValidFile_ConsumesIt) {
+    // Arrange
+    auto request = TransformRequestBuilder::defaultJpeg();
+    TempFile temp("cache_test_");
+    auto data = TestDataBuilder::createData(SMALL_DATA_SIZE);
+    temp.write(data);
+
+    // Act
+    bool success = cache_manager_->moveToCache(request, temp.getPath());
+
+    // Assert
+    EXPECT_TRUE(success);
+    EXPECT_EQ(data, fake_file_service_->downloadData(request.getCacheKey()));
+    EXPECT_FALSE(FileUtils::fileExists(temp.getPath()))
+        << "The stored file should be consumed";
+}
+
+TEST_F(CacheManagerTest, StoreInCache_EncodedData_UploadsBytesUnderCacheKey) {
+    // Arrange
+    auto request = TransformRequestBuilder::defaultJpeg();
+    auto data = TestDataBuilder::createData(SMALL_DATA_SIZE);
+
+    // Act
+    bool success = cache_manager_->storeInCache(request, data);
+
+    // Assert
+    EXPECT_TRUE(success)
+        << "Storing encoded bytes in cache should succeed";
+
+    EXPECT_EQ(data, fake_file_service_->downloadData(request.getCacheKey()))
+        << "Cached object should contain the exact bytes stored";
+}
+
+TEST_F(CacheManagerTest, StoreInCache_EmptyData_ReturnsFalse) {
+    // Arrange
+    auto request = TransformRequestBuilder::defaultJpeg();
+    std::vector<char> empty_data;
+
+    // Act
+    bool success = cache_manager_->storeInCache(request, empty_data);
+
+    // Assert
+    EXPECT_FALSE(success)
+        << "Storing empty data should fail";
+
+    EXPECT_FALSE(cache_manager_->existsInCache(request))
+        << "Failed store should not add to cache";
+}
+
 // ============================================================================
 // Presigned URL Tests
 // ============================================================================
@@ -243,6 +295,104 @@ TEST_F(CacheManagerTest, ClearTransformation_ForNonCachedImage_ReturnsFalse) {
         << "Clearing non-existent cached image should return false";
 }
 
+// ============================================================================
+// Memory Tier Tests
+// ============================================================================
+
+TEST_F(CacheManagerTest, GetCachedImage_AfterStore_AnsweredFromMemory) {
+    // Arrange
+    auto request = TransformRequestBuilder::defaultJpeg();
+    cache_manager_->storeInCache(request, TestDataBuilder::createData(SMALL_DATA_SIZE));
+
+    // Remove the object behind the cache's back: only the memory tier knows it
+    fake_file_service_->deleteObject(request.getCacheKey());
+
+    // Act
+    std::string cached_key = cache_manager_->getCachedImage(request);
+
+    // Assert
+    EXPECT_EQ(request.getCacheKey(), cached_key)
+        << "Recently stored keys should be answered without a storage lookup";
+}
+
+TEST_F(CacheManagerTest, GetCachedImages_MixedHitsAndMisses_KeysInRequestOrder) {
+    // Arrange
+    auto in_memory = TransformRequestBuilder::defaultJpeg();
+    auto in_storage = TransformRequestBuilder().withDimensions(1024, 768).build();
+    auto missing = TransformRequestBuilder().withFormat("png").build();
+    cache_manager_->storeInCache(in_memory, TestDataBuilder::createData(SMALL_DATA_SIZE));
+    uploadFakeTransformedImage(in_storage);
+
+    // Act
+    auto keys = cache_manager_->getCachedImages({missing, in_memory, in_storage});
+
+    // Assert
+    ASSERT_EQ(3u, keys.size());
+    EXPECT_TRUE(keys[0].empty()) << "Uncached renditions should come back empty";
+    EXPECT_EQ(in_memory.getCacheKey(), keys[1]);
+    EXPECT_EQ(in_storage.getCacheKey(), keys[2]);
+}
+
+TEST_F(CacheManagerTest, GetCachedData_SmallRendition_ReturnsStoredBytes) {
+    // Arrange
+    auto request = TransformRequestBuilder::defaultJpeg();
+    auto data = TestDataBuilder::createData(SMALL_DATA_SIZE);
+    cache_manager_->storeInCache(request, data);
+
+    // Act
+    auto cached = cache_manager_->getCachedData(request);
+
+    // Assert
+    ASSERT_NE(nullptr, cached)
+        << "Small renditions should be held in memory";
+    EXPECT_EQ(data, *cached);
+}
+
+TEST_F(CacheManagerTest, GetCachedData_RenditionOverEntryLimit_ReturnsNull) {
+    // Arrange
+    CacheConfig config;
+    config.memory_max_entry_bytes = SMALL_DATA_SIZE - 1;
+    CacheManager cache_manager(fake_file_service_, config);
+    auto request = TransformRequestBuilder::defaultJpeg();
+    cache_manager.storeInCache(request, TestDataBuilder::createData(SMALL_DATA_SIZE));
+
+    // Act
+    auto cached = cache_manager.getCachedData(request);
+
+    // Assert
+    EXPECT_EQ(nullptr, cached)
+        << "Renditions above the entry limit should only record presence";
+    EXPECT_TRUE(cache_manager.existsInCache(request));
+}
+
+TEST_F(CacheManagerTest, ClearTransformation_AfterStore_InvalidatesMemoryTier) {
+    // Arrange
+    auto request = TransformRequestBuilder::defaultJpeg();
+    cache_manager_->storeInCache(request, TestDataBuilder::createData(SMALL_DATA_SIZE));
+
+    // Act
+    cache_manager_->clearTransformation(request);
+
+    // Assert
+    EXPECT_FALSE(cache_manager_->existsInCache(request));
+    EXPECT_EQ(nullptr, cache_manager_->getCachedData(request));
+}
+
+TEST_F(CacheManagerTest, ClearImageCache_AfterStore_InvalidatesAllRenditionsInMemory) {
+    // Arrange
+    auto small = TransformRequestBuilder().withImageId(TEST_IMAGE_ID).withDimensions(100, 100).build();
+    auto large = TransformRequestBuilder().withImageId(TEST_IMAGE_ID).withDimensions(800, 600).build();
+    cache_manager_->storeInCache(small, TestDataBuilder::createData(SMALL_DATA_SIZE));
+    cache_manager_->storeInCache(large, TestDataBuilder::createData(SMALL_DATA_SIZE));
+
+    // Act
+    cache_manager_->clearImageCache(TEST_IMAGE_ID);
+
+    // Assert
+    EXPECT_EQ(nullptr, cache_manager_->getCachedData(small));
+    EXPECT_EQ(nullptr, cache_manager_->getCachedData(large));
+}
+
 // ============================================================================
 // Cache Key Generation Tests
 // ============================================================================
@@ -421,3 +571,252 @@ TEST_F(CacheManagerTest, ClearTransformation_SpecificFormat_DoesNotAffectOthers)
     EXPECT_TRUE(cache_manager_->existsInCache(req_png))
         << "PNG format should still exist in cache";
 }
+
+// ============================================================================
+// Write-Behind Tests
+// ============================================================================
+
+namespace {
+
+// Fails the first failures_left uploads, then behaves like FakeFileService
+class FlakyFileService : public FakeFileService {
+public:
+    explicit FlakyFileService(int failures) : failures_left(failures) {}
+
+    bool uploadData(const std::vector<char>& data, const std::string& key,
+                    const std::string& content_type = "application/octet-stream") override {
+        if (failures_left.fetch_sub(1) > 0) {
+            return false;
+        }
+        return FakeFileService::uploadData(data, key, content_type);
+    }
+
+    bool uploadFile(const std::string& local_path, const std::string& key,
+                    const std::string& content_type = "application/octet-stream") override {
+        if (failures_left.fetch_sub(1) > 0) {
+            return false;
+        }
+        return FakeFileService::uploadFile(local_path, key, content_type);
+    }
+
+    std::atomic<int> failures_left;
+};
+
+CacheConfig writeBehindConfig() {
+    CacheConfig config;
+    config.write_behind = true;
+    config.write_behind_workers = 1;
+    return config;
+}
+
+} // anonymous namespace
+
+TEST_F(CacheManagerTest, WriteBehind_Store_UploadsInBackground) {
+    // Arrange
+    CacheManager cache_manager(fake_file_service_, writeBehindConfig());
+    auto request = TransformRequestBuilder::defaultJpeg();
+    auto data = TestDataBuilder::createData(SMALL_DATA_SIZE);
+
+    // Act
+    bool stored = cache_manager.storeInCache(request, data);
+    cache_manager.flush();
+
+    // Assert
+    EXPECT_TRUE(stored);
+    EXPECT_TRUE(fake_file_service_->objectExists(request.getCacheKey()))
+        << "Queued renditions should reach storage";
+    EXPECT_EQ(0u, cache_manager.pendingUploads());
+}
+
+TEST_F(CacheManagerTest, WriteBehind_WhilePending_CountsAsCachedAndServesBytes) {
+    // Arrange - the first attempt fails, keeping the upload pending during its retry delay
+    auto flaky = std::make_shared<FlakyFileService>(1);
+    CacheManager cache_manager(flaky, writeBehindConfig());
+    auto request = TransformRequestBuilder::defaultJpeg();
+    auto data = TestDataBuilder::createData(SMALL_DATA_SIZE);
+
+    // Act
+    cache_manager.storeInCache(request, data);
+
+    // Assert
+    EXPECT_EQ(request.getCacheKey(), cache_manager.getCachedImage(request))
+        << "A pending rendition should not be generated again";
+    auto pending = cache_manager.getPendingData(request.getCacheKey());
+    ASSERT_NE(nullptr, pending);
+    EXPECT_EQ(data, *pending);
+    cache_manager.flush();
+}
+
+TEST_F(CacheManagerTest, WriteBehind_MoveToCache_ServesSpoolWhilePendingThenRemovesIt) {
+    // Arrange - the first attempt fails, keeping the upload pending during its retry delay
+    auto flaky = std::make_shared<FlakyFileService>(1);
+    CacheManager cache_manager(flaky, writeBehindConfig());
+    auto request = TransformRequestBuilder::defaultJpeg();
+    auto data = TestDataBuilder::createData(SMALL_DATA_SIZE);
+    TempFile spool("cache_test_");
+    spool.write(data);
+    std::string spool_path = spool.getPath();
+
+    // Act
+    ASSERT_TRUE(cache_manager.moveToCache(request, spool_path));
+    spool.release();
+
+    // Assert
+    EXPECT_EQ(request.getCacheKey(), cache_manager.getCachedImage(request));
+    auto pending = cache_manager.getPendingData(request.getCacheKey());
+    ASSERT_NE(nullptr, pending);
+    EXPECT_EQ(data, *pending);
+    cache_manager.flush();
+    EXPECT_EQ(data, flaky->downloadData(request.getCacheKey()));
+    EXPECT_FALSE(FileUtils::fileExists(spool_path))
+        << "The spool file should be removed once its upload lands";
+}
+
+TEST_F(CacheManagerTest, WriteBehind_UploadFails_RetriesUntilStored) {
+    // Arrange
+    auto flaky = std::make_shared<FlakyFileService>(2);
+    CacheManager cache_manager(flaky, writeBehindConfig());
+    auto request = TransformRequestBuilder::defaultJpeg();
+
+    // Act
+    cache_manager.storeInCache(request, TestDataBuilder::createData(SMALL_DATA_SIZE));
+    cache_manager.flush();
+
+    // Assert
+    EXPECT_TRUE(flaky->objectExists(request.getCacheKey()));
+}
+
+TEST_F(CacheManagerTest, WriteBehind_AttemptsExhausted_DropsRendition) {
+    // Arrange
+    auto flaky = std::make_shared<FlakyFileService>(100);
+    CacheConfig config = writeBehindConfig();
+    config.write_behind_max_attempts = 2;
+    CacheManager cache_manager(flaky, config);
+    auto request = TransformRequestBuilder::defaultJpeg();
+
+    // Act
+    cache_manager.storeInCache(request, TestDataBuilder::createData(SMALL_DATA_SIZE));
+    cache_manager.flush();
+
+    // Assert
+    EXPECT_TRUE(cache_manager.getCachedImage(request).empty())
+        << "A rendition that never landed should be regenerated on the next request";
+}
+
+TEST_F(CacheManagerTest, WriteBehind_AttemptsExhausted_ForgetsKeySeenWhilePending) {
+    // Arrange
+    auto flaky = std::make_shared<FlakyFileService>(100);
+    CacheConfig config = writeBehindConfig();
+    config.write_behind_max_attempts = 2;
+    CacheManager cache_manager(flaky, config);
+    auto request = TransformRequestBuilder::defaultJpeg();
+    cache_manager.storeInCache(request, TestDataBuilder::createData(SMALL_DATA_SIZE));
+    ASSERT_EQ(request.getCacheKey(), cache_manager.getCachedImages({request})[0]);
+
+    // Act
+    cache_manager.flush();
+
+    // Assert
+    EXPECT_TRUE(cache_manager.getCachedImages({request})[0].empty())
+        << "A lookup during the upload must not leave the key answering from memory";
+    EXPECT_TRUE(cache_manager.getCachedImage(request).empty());
+}
+
+TEST_F(CacheManagerTest, WriteBehind_PresignedUrl_WaitsForPendingUpload) {
+    // Arrange - the first attempt fails, keeping the upload pending during its retry delay
+    auto flaky = std::make_shared<FlakyFileService>(1);
+    CacheManager cache_manager(flaky, writeBehindConfig());
+    auto request = TransformRequestBuilder::defaultJpeg();
+    cache_manager.storeInCache(request, TestDataBuilder::createData(SMALL_DATA_SIZE));
+
+    // Act
+    std::string url = cache_manager.getPresignedUrl(request);
+
+    // Assert
+    EXPECT_FALSE(url.empty());
+    EXPECT_TRUE(flaky->objectExists(request.getCacheKey()))
+        << "A URL should only be handed out once the object is in storage";
+}
+
+TEST_F(CacheManagerTest, WriteBehind_UrlWaitExpires_NotReadyUntilUploadLands) {
+    // Arrange
+    auto flaky = std::make_shared<FlakyFileService>(1);
+    CacheConfig config = writeBehindConfig();
+    config.write_behind_url_wait_ms = 0;
+    CacheManager cache_manager(flaky, config);
+    auto request = TransformRequestBuilder::defaultJpeg();
+    cache_manager.storeInCache(request, TestDataBuilder::createData(SMALL_DATA_SIZE));
+
+    // Act & Assert
+    EXPECT_FALSE(cache_manager.awaitUrl(request.getCacheKey()));
+    EXPECT_TRUE(cache_manager.getPresignedUrl(request).empty());
+    cache_manager.flush();
+    EXPECT_TRUE(cache_manager.awaitUrl(request.getCacheKey()));
+    EXPECT_FALSE(cache_manager.getPresignedUrl(request).empty());
+}
+
+TEST_F(CacheManagerTest, WriteBehind_UploadNeverLands_UrlNotReady) {
+    // Arrange
+    auto flaky = std::make_shared<FlakyFileService>(100);
+    CacheConfig config = writeBehindConfig();
+    config.write_behind_max_attempts = 2;
+    CacheManager cache_manager(flaky, config);
+    auto request = TransformRequestBuilder::defaultJpeg();
+    cache_manager.storeInCache(request, TestDataBuilder::createData(SMALL_DATA_SIZE));
+
+    // Act
+    std::vector<bool> ready = cache_manager.awaitUrls({request.getCacheKey(), ""});
+
+    // Assert
+    EXPECT_FALSE(ready[0]) << "A dropped upload has no URL to hand out";
+    EXPECT_TRUE(ready[1]);
+}
+
+TEST_F(CacheManagerTest, WriteBehind_PendingUrlsServed_ReadyWhilePending) {
+    // Arrange
+    auto flaky = std::make_shared<FlakyFileService>(1);
+    CacheConfig config = writeBehindConfig();
+    config.write_behind_url_wait_ms = 0;
+    config.pending_urls_served = true;
+    CacheManager cache_manager(flaky, config);
+    auto request = TransformRequestBuilder::defaultJpeg();
+    cache_manager.storeInCache(request, TestDataBuilder::createData(SMALL_DATA_SIZE));
+
+    // Act & Assert
+    EXPECT_TRUE(cache_manager.awaitUrl(request.getCacheKey()))
+        << "URLs this process serves from memory need no wait";
+    cache_manager.flush();
+}
+
+TEST_F(CacheManagerTest, WriteBehind_QueueFull_StoresSynchronously) {
+    // Arrange
+    CacheConfig config = writeBehindConfig();
+    config.write_behind_max_pending = 0;
+    CacheManager cache_manager(fake_file_service_, config);
+    auto request = TransformRequestBuilder::defaultJpeg();
+
+    // Act
+    bool stored = cache_manager.storeInCache(request, TestDataBuilder::createData(SMALL_DATA_SIZE));
+
+    // Assert
+    EXPECT_TRUE(stored);
+    EXPECT_TRUE(fake_file_service_->objectExists(request.getCacheKey()))
+        << "Stores beyond the queue limit should upload inline";
+}
+
+TEST_F(CacheManagerTest, WriteBehind_ClearWhilePending_LeavesNothingInStorage) {
+    // Arrange
+    auto flaky = std::make_shared<FlakyFileService>(1);
+    CacheManager cache_manager(flaky, writeBehindConfig());
+    auto request = TransformRequestBuilder::defaultJpeg();
+    cache_manager.storeInCache(request, TestDataBuilder::createData(SMALL_DATA_SIZE));
+
+    // Act
+    cache_manager.clearTransformation(request);
+    cache_manager.flush();
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));  // Let an in-flight retry finish
+
+    // Assert
+    EXPECT_EQ(nullptr, cache_manager.getPendingData(request.getCacheKey()));
+    EXPECT_FALSE(flaky->objectExists(request.getCacheKey()));
+}
@@ -0,0 +1,197 @@
+#include <gtest/gtest.h>
+#include "services/cached_file_service.h"
+#include "utils/logger.h"
+#include "utils/metrics.h"
+#include "mocks/fake_file_service.h"
+#include "test_helpers/test_constants.h"
+#include "test_helpers/test_builders.h"
+#include <atomic>
+#include <cstdlib>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace gara;
+using namespace gara::testing;
+using namespace gara::test_constants;
+using namespace gara::test_builders;
+
+namespace {
+
+// Counts backend downloads so tests can tell hits from misses
+class CountingFileService : public FakeFileService {
+public:
+    bool downloadFile(const std::string& key, const std::string& local_path) override {
+        ++downloads;
+        return FakeFileService::downloadFile(key, local_path);
+    }
+
+    std::vector<char> downloadData(const std::string& key) override {
+        ++downloads;
+        return FakeFileService::downloadData(key);
+    }
+
+    std::atomic<int> downloads{0};
+};
+
+} // anonymous namespace
+
+class CachedFileServiceTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        gara::Logger::initialize("gara-test", "error", gara::Logger::Format::TEXT, "test");
+        gara::Metrics::initialize("GaraTest", "gara-test", "test", false);
+
+        temp_dir_ = std::filesystem::temp_directory_path() /
+                    ("gara_raw_cache_test_" + std::to_string(std::rand()));
+        config_.directory = temp_dir_.string();
+        config_.max_bytes = 10 * SMALL_DATA_SIZE;
+        backend_ = std::make_shared<CountingFileService>();
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(temp_dir_);
+    }
+
+    std::string putOriginal(const std::string& image_id, size_t size = SMALL_DATA_SIZE) {
+        std::string key = TestDataBuilder::createRawImageKey(image_id, FORMAT_JPEG);
+        backend_->uploadData(TestDataBuilder::createData(size), key);
+        return key;
+    }
+
+    std::filesystem::path temp_dir_;
+    RawCacheConfig config_;
+    std::shared_ptr<CountingFileService> backend_;
+};
+
+// ============================================================================
+// Hit and Miss Tests
+// ============================================================================
+
+TEST_F(CachedFileServiceTest, DownloadData_SecondCall_ServedFromDisk) {
+    // Arrange
+    CachedFileService service(backend_, config_);
+    std::string key = putOriginal(TEST_IMAGE_ID);
+
+    // Act
+    auto first = service.downloadData(key);
+    auto second = service.downloadData(key);
+
+    // Assert
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(SMALL_DATA_SIZE, second.size());
+    EXPECT_EQ(1, backend_->downloads.load()) << "The original should be downloaded once";
+}
+
+TEST_F(CachedFileServiceTest, DownloadData_OutsidePrefix_AlwaysGoesToBackend) {
+    // Arrange
+    CachedFileService service(backend_, config_);
+    backend_->uploadData(TestDataBuilder::createData(SMALL_DATA_SIZE), "transformed/a.jpeg");
+
+    // Act
+    service.downloadData("transformed/a.jpeg");
+    service.downloadData("transformed/a.jpeg");
+
+    // Assert
+    EXPECT_EQ(2, backend_->downloads.load());
+    EXPECT_EQ(0u, service.cachedEntries());
+}
+
+TEST_F(CachedFileServiceTest, DownloadData_ConcurrentMisses_DownloadOnce) {
+    // Arrange
+    CachedFileService service(backend_, config_);
+    std::string key = putOriginal(TEST_IMAGE_ID);
+
+    // Act
+    std::vector<std::thread> threads;
+    std::atomic<int> complete{0};
+    for (int i = 0; i < 8; ++i) {
+        threads.emplace_back([&]() {
+            if (service.downloadData(key).size() == SMALL_DATA_SIZE) {
+                ++complete;
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    // Assert
+    EXPECT_EQ(8, complete.load());
+    EXPECT_LE(backend_->downloads.load(), 2)
+        << "Concurrent misses should mostly share one download";
+}
+
+TEST_F(CachedFileServiceTest, UploadData_RawKey_SeedsDiskTier) {
+    // Arrange
+    CachedFileService service(backend_, config_);
+    std::string key = TestDataBuilder::createRawImageKey(TEST_IMAGE_ID, FORMAT_PNG);
+
+    // Act
+    service.uploadData(TestDataBuilder::createData(SMALL_DATA_SIZE), key);
+    service.downloadData(key);
+
+    // Assert
+    EXPECT_EQ(0, backend_->downloads.load());
+}
+
+// ============================================================================
+// Eviction Tests
+// ============================================================================
+
+TEST_F(CachedFileServiceTest, Admit_OverBudget_EvictsLeastRecentlyUsed) {
+    // Arrange - budget holds two originals
+    config_.max_bytes = 2 * SMALL_DATA_SIZE;
+    CachedFileService service(backend_, config_);
+    std::string a = putOriginal("a");
+    std::string b = putOriginal("b");
+    std::string c = putOriginal("c");
+    service.downloadData(a);
+    service.downloadData(b);
+    service.downloadData(a);  // a is now more recent than b
+
+    // Act
+    service.downloadData(c);
+
+    // Assert
+    EXPECT_EQ(2u, service.cachedEntries());
+    EXPECT_LE(service.cachedBytes(), config_.max_bytes);
+    int before = backend_->downloads.load();
+    service.downloadData(a);
+    EXPECT_EQ(before, backend_->downloads.load()) << "Recently used originals should stay cached";
+    service.downloadData(b);
+    EXPECT_EQ(before + 1, backend_->downloads.load()) << "The least recently used original should be evicted";
+}
+
+TEST_F(CachedFileServiceTest, DeleteObject_RemovesCachedCopy) {
+    // Arrange
+    CachedFileService service(backend_, config_);
+    std::string key = putOriginal(TEST_IMAGE_ID);
+    service.downloadData(key);
+
+    // Act
+    service.deleteObject(key);
+
+    // Assert
+    EXPECT_EQ(0u, service.cachedEntries());
+    EXPECT_FALSE(service.objectExists(key));
+}
+
+TEST_F(CachedFileServiceTest, Constructor_ExistingDirectory_ReloadsCachedOriginals) {
+    // Arrange
+    std::string key = putOriginal(TEST_IMAGE_ID);
+    {
+        CachedFileService first(backend_, config_);
+        first.downloadData(key);
+    }
+
+    // Act
+    CachedFileService second(backend_, config_);
+    auto data = second.downloadData(key);
+
+    // Assert
+    EXPECT_EQ(SMALL_DATA_SIZE, data.size());
+    EXPECT_EQ(1, backend_->downloads.load()) << "Cached files should survive a restart";
+}
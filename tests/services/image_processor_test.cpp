@@ -172,6 +172,36 @@ TEST_F(ImageProcessorTest, GetImageInfo_FromValidImage_ReturnsCorrectInfo) {
         << "Format should be detected as PPM";
 }
 
+TEST_F(ImageProcessorTest, GetImageInfo_FromValidImage_ReportsBandsAndFileSize) {
+    // Act
+    ImageInfo info = processor_->getImageInfo(test_image_path_);
+
+    // Assert
+    EXPECT_EQ(RGB_BANDS, info.bands)
+        << "Band count should come from the image header";
+
+    EXPECT_EQ(FileUtils::getFileSize(test_image_path_), info.size_bytes)
+        << "Size should be the encoded file size, not an estimate of decoded pixels";
+
+    EXPECT_EQ(1, info.orientation)
+        << "Images without EXIF orientation should report upright";
+}
+
+TEST_F(ImageProcessorTest, GetImageInfo_WithMisleadingSuffix_ReportsLoaderFormat) {
+    // Arrange - PNG content saved under a .jpg name
+    std::string output_path = createTrackedOutputPath("png_as_jpg_", ".png");
+    ASSERT_TRUE(processor_->transform(test_image_path_, output_path, FORMAT_PNG));
+    std::string misnamed = createTrackedOutputPath("misnamed_", ".jpg");
+    FileUtils::writeToFile(misnamed, FileUtils::readFile(output_path));
+
+    // Act
+    ImageInfo info = processor_->getImageInfo(misnamed);
+
+    // Assert
+    EXPECT_EQ(FORMAT_PNG, info.format)
+        << "Format should come from the loader, not the filename";
+}
+
 TEST_F(ImageProcessorTest, GetImageInfo_FromInvalidFile_ReturnsInvalidInfo) {
     // Arrange
     std::string nonexistent = TestFileManager::createUniquePath("nonexistent_", ".jpg");
@@ -363,6 +393,217 @@ TEST_F(ImageProcessorTest, Transform_ResizeBothDimensions_ResizesToExactSize) {
         << "Height should match specified resize height";
 }
 
+// ============================================================================
+// In-Memory Transform Tests
+// ============================================================================
+
+TEST_F(ImageProcessorTest, TransformBuffer_ResizeWidthOnly_EncodesResizedImage) {
+    // Arrange
+    std::string large_image = createTrackedTestImage(
+        "buffer_image_",
+        TEST_MEDIUM_IMAGE_WIDTH,
+        TEST_MEDIUM_IMAGE_HEIGHT
+    );
+    std::vector<char> input = FileUtils::readFile(large_image);
+
+    // Act
+    std::vector<char> output = processor_->transformBuffer(
+        input,
+        FORMAT_JPEG,
+        RESIZE_TARGET_WIDTH_50,
+        RESIZE_MAINTAIN_ASPECT
+    );
+
+    // Assert
+    ASSERT_FALSE(output.empty())
+        << "In-memory transformation should produce encoded bytes";
+
+    vips::VImage decoded = vips::VImage::new_from_buffer(output.data(), output.size(), "");
+    EXPECT_EQ(RESIZE_TARGET_WIDTH_50, decoded.width())
+        << "Width should be resized to target width";
+
+    EXPECT_EQ(RESIZE_TARGET_HEIGHT_25, decoded.height())
+        << "Height should be auto-scaled to maintain 2:1 aspect ratio";
+}
+
+TEST_F(ImageProcessorTest, TransformBuffer_WithPostProcess_AppliesStepBeforeEncoding) {
+    // Arrange
+    std::vector<char> input = FileUtils::readFile(test_image_path_);
+    bool post_process_called = false;
+
+    // Act
+    std::vector<char> output = processor_->transformBuffer(
+        input,
+        FORMAT_PNG,
+        RESIZE_MAINTAIN_ASPECT,
+        RESIZE_MAINTAIN_ASPECT,
+        85,
+        [&post_process_called](const vips::VImage& image) {
+            post_process_called = true;
+            return image.embed(0, 0, RESIZE_TARGET_WIDTH_20, RESIZE_TARGET_HEIGHT_20);
+        }
+    );
+
+    // Assert
+    ASSERT_FALSE(output.empty())
+        << "In-memory transformation with post-process should succeed";
+
+    EXPECT_TRUE(post_process_called)
+        << "Post-process step should be invoked";
+
+    vips::VImage decoded = vips::VImage::new_from_buffer(output.data(), output.size(), "");
+    EXPECT_EQ(RESIZE_TARGET_WIDTH_20, decoded.width())
+        << "Encoded output should reflect the post-processed image";
+}
+
+TEST_F(ImageProcessorTest, TransformBuffer_Upscale_ResizesToExactSize) {
+    // Arrange - Upscales bypass shrink-on-load and use resize
+    std::vector<char> input = FileUtils::readFile(test_image_path_);
+
+    // Act
+    std::vector<char> output = processor_->transformBuffer(
+        input,
+        FORMAT_PNG,
+        RESIZE_TARGET_WIDTH_20,
+        RESIZE_TARGET_HEIGHT_20
+    );
+
+    // Assert
+    ASSERT_FALSE(output.empty())
+        << "Upscaling in memory should succeed";
+
+    vips::VImage decoded = vips::VImage::new_from_buffer(output.data(), output.size(), "");
+    EXPECT_EQ(RESIZE_TARGET_WIDTH_20, decoded.width())
+        << "Width should match specified resize width";
+
+    EXPECT_EQ(RESIZE_TARGET_HEIGHT_20, decoded.height())
+        << "Height should match specified resize height";
+}
+
+TEST_F(ImageProcessorTest, TransformBuffer_EncoderProfiles_EncodeEveryFormat) {
+    // Arrange
+    std::vector<char> input = FileUtils::readFile(test_image_path_);
+    EncoderConfig config;
+
+    for (const auto& profile : config.profiles) {
+        for (const std::string& format : {FORMAT_JPEG, FORMAT_PNG, FORMAT_WEBP}) {
+            // Act
+            std::vector<char> output = processor_->transformBuffer(
+                input, format, RESIZE_MAINTAIN_ASPECT, RESIZE_MAINTAIN_ASPECT, profile);
+
+            // Assert
+            EXPECT_FALSE(output.empty())
+                << "Profile '" << profile.name << "' should encode " << format;
+        }
+    }
+}
+
+TEST_F(ImageProcessorTest, TransformBuffer_AnimatedWebP_KeepsEveryFrame) {
+    // Arrange - Three 40x20 frames stacked into one animated WebP
+    const int frame_count = 3;
+    std::vector<vips::VImage> frames;
+    for (int i = 0; i < frame_count; ++i) {
+        frames.push_back(vips::VImage::black(RESIZE_TARGET_WIDTH_20 * 2, RESIZE_TARGET_HEIGHT_20,
+                                             vips::VImage::option()->set("bands", RGB_BANDS)) + i * 80);
+    }
+    vips::VImage strip = vips::VImage::arrayjoin(frames, vips::VImage::option()->set("across", 1))
+        .cast(VIPS_FORMAT_UCHAR).copy();
+    strip.set("page-height", RESIZE_TARGET_HEIGHT_20);
+    void* buf = nullptr;
+    size_t length = 0;
+    strip.write_to_buffer(".webp", &buf, &length);
+    std::vector<char> input(static_cast<char*>(buf), static_cast<char*>(buf) + length);
+    g_free(buf);
+    int post_process_calls = 0;
+
+    // Act
+    std::vector<char> output = processor_->transformBuffer(
+        input, FORMAT_WEBP, RESIZE_TARGET_WIDTH_20, RESIZE_MAINTAIN_ASPECT, EncoderProfile(),
+        [&post_process_calls](const vips::VImage& image) {
+            ++post_process_calls;
+            return image;
+        });
+
+    // Assert
+    ASSERT_FALSE(output.empty())
+        << "Animated transformation should succeed";
+
+    EXPECT_EQ(frame_count, post_process_calls)
+        << "Post-process step should run once per frame";
+
+    vips::VImage decoded = vips::VImage::new_from_buffer(output.data(), output.size(), "",
+                                                         vips::VImage::option()->set("n", -1));
+    EXPECT_EQ(frame_count, decoded.get_int("n-pages"))
+        << "Every frame should survive the transformation";
+
+    EXPECT_EQ(RESIZE_TARGET_WIDTH_20, decoded.width())
+        << "Each frame should be resized to the target width";
+
+    EXPECT_EQ(RESIZE_TARGET_HEIGHT_20 / 2, decoded.get_int("page-height"))
+        << "Frame height should keep the 2:1 aspect ratio";
+}
+
+TEST_F(ImageProcessorTest, TransformBuffer_WithInvalidData_ReturnsEmpty) {
+    // Arrange
+    std::vector<char> input(TEST_INVALID_IMAGE_CONTENT.begin(), TEST_INVALID_IMAGE_CONTENT.end());
+
+    // Act
+    std::vector<char> output = processor_->transformBuffer(input, FORMAT_JPEG);
+
+    // Assert
+    EXPECT_TRUE(output.empty())
+        << "Transformation of non-image data should fail";
+}
+
+TEST_F(ImageProcessorTest, TransformBufferMany_SeveralTargets_EncodesEachSize) {
+    // Arrange
+    std::string large_image = createTrackedTestImage(
+        "multi_image_",
+        TEST_MEDIUM_IMAGE_WIDTH,
+        TEST_MEDIUM_IMAGE_HEIGHT
+    );
+    std::vector<char> input = FileUtils::readFile(large_image);
+    std::vector<RenditionTarget> targets = {
+        {FORMAT_JPEG, RESIZE_TARGET_WIDTH_50, RESIZE_MAINTAIN_ASPECT, EncoderProfile()},
+        {FORMAT_PNG, RESIZE_TARGET_WIDTH_20, RESIZE_TARGET_HEIGHT_20, EncoderProfile()},
+        {FORMAT_WEBP, RESIZE_MAINTAIN_ASPECT, RESIZE_MAINTAIN_ASPECT, EncoderProfile()}
+    };
+
+    // Act
+    auto outputs = processor_->transformBufferMany(input, targets);
+
+    // Assert
+    ASSERT_EQ(targets.size(), outputs.size());
+
+    vips::VImage first = vips::VImage::new_from_buffer(outputs[0].data(), outputs[0].size(), "");
+    EXPECT_EQ(RESIZE_TARGET_WIDTH_50, first.width());
+    EXPECT_EQ(RESIZE_TARGET_HEIGHT_25, first.height())
+        << "Width-only target should keep the source aspect ratio";
+
+    vips::VImage second = vips::VImage::new_from_buffer(outputs[1].data(), outputs[1].size(), "");
+    EXPECT_EQ(RESIZE_TARGET_WIDTH_20, second.width());
+    EXPECT_EQ(RESIZE_TARGET_HEIGHT_20, second.height());
+
+    vips::VImage third = vips::VImage::new_from_buffer(outputs[2].data(), outputs[2].size(), "");
+    EXPECT_EQ(TEST_MEDIUM_IMAGE_WIDTH, third.width())
+        << "Target without dimensions should keep the original size";
+}
+
+TEST_F(ImageProcessorTest, TransformBufferMany_WithInvalidData_ReturnsEmptyOutputs) {
+    // Arrange
+    std::vector<char> input(TEST_INVALID_IMAGE_CONTENT.begin(), TEST_INVALID_IMAGE_CONTENT.end());
+    std::vector<RenditionTarget> targets(2);
+    targets[1].format = FORMAT_PNG;
+
+    // Act
+    auto outputs = processor_->transformBufferMany(input, targets);
+
+    // Assert
+    ASSERT_EQ(targets.size(), outputs.size());
+    EXPECT_TRUE(outputs[0].empty());
+    EXPECT_TRUE(outputs[1].empty());
+}
+
 // ============================================================================
 // Error Handling Tests
 // ============================================================================
@@ -0,0 +1,103 @@
+#include <gtest/gtest.h>
+#include "services/local_config_service.h"
+#include "test_helpers/test_file_manager.h"
+#include "utils/logger.h"
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+using namespace gara;
+using namespace gara::test_helpers;
+
+class LocalConfigServiceTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        gara::Logger::initialize("gara-test", "error", gara::Logger::Format::TEXT, "test");
+        keys_file_ = TestFileManager::createUniquePath("api_keys_", ".txt");
+        unsetenv(ENV_VAR);
+    }
+
+    void TearDown() override {
+        unsetenv(ENV_VAR);
+        std::filesystem::remove(keys_file_);
+    }
+
+    void writeKeysFile(const std::string& content) {
+        std::ofstream file(keys_file_);
+        file << content;
+    }
+
+    static constexpr const char* ENV_VAR = "GARA_TEST_API_KEY";
+    std::string keys_file_;
+};
+
+// ============================================================================
+// Validation Tests
+// ============================================================================
+
+TEST_F(LocalConfigServiceTest, ValidateApiKey_CommaSeparatedEnv_AcceptsEachKey) {
+    // Arrange
+    setenv(ENV_VAR, "new-key,old-key", 1);
+
+    // Act
+    LocalConfigService service(ENV_VAR);
+
+    // Assert
+    EXPECT_TRUE(service.isInitialized());
+    EXPECT_EQ(service.activeKeyCount(), 2u);
+    EXPECT_TRUE(service.validateApiKey("new-key"));
+    EXPECT_TRUE(service.validateApiKey("old-key"));
+    EXPECT_FALSE(service.validateApiKey("other-key"));
+    EXPECT_EQ(service.getApiKey(), "new-key");
+}
+
+TEST_F(LocalConfigServiceTest, ValidateApiKey_NoKeys_RejectsAll) {
+    LocalConfigService service(ENV_VAR);
+
+    EXPECT_FALSE(service.isInitialized());
+    EXPECT_FALSE(service.validateApiKey(""));
+    EXPECT_FALSE(service.validateApiKey("anything"));
+}
+
+// ============================================================================
+// Rotation Tests
+// ============================================================================
+
+TEST_F(LocalConfigServiceTest, RefreshApiKey_KeysFileChanged_RotatesKeys) {
+    // Arrange
+    setenv(ENV_VAR, "env-key", 1);
+    writeKeysFile("old-key\n");
+    LocalConfigService service(ENV_VAR, keys_file_, 3600);
+    ASSERT_TRUE(service.validateApiKey("old-key"));
+
+    // Act
+    writeKeysFile("# rotated\nnew-key\n");
+    EXPECT_TRUE(service.refreshApiKey());
+
+    // Assert
+    EXPECT_TRUE(service.validateApiKey("env-key"));
+    EXPECT_TRUE(service.validateApiKey("new-key"));
+    EXPECT_FALSE(service.validateApiKey("old-key"));
+}
+
+TEST_F(LocalConfigServiceTest, BackgroundRefresh_KeysFileChanged_PicksUpNewKey) {
+    // Arrange
+    writeKeysFile("old-key\n");
+    LocalConfigService service(ENV_VAR, keys_file_, 1);
+
+    // Act: move the timestamp forward so the change is visible on coarse clocks
+    writeKeysFile("old-key\nnew-key\n");
+    std::filesystem::last_write_time(keys_file_,
+                                     std::filesystem::last_write_time(keys_file_) + std::chrono::seconds(5));
+
+    // Assert
+    bool rotated = false;
+    for (int i = 0; i < 40 && !rotated; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        rotated = service.validateApiKey("new-key");
+    }
+    EXPECT_TRUE(rotated);
+    EXPECT_TRUE(service.validateApiKey("old-key"));
+}
@@ -0,0 +1,66 @@
+#include <gtest/gtest.h>
+#include "services/otlp_exporter.h"
+#include <nlohmann/json.hpp>
+
+using namespace gara;
+using json = nlohmann::json;
+
+class OtlpExporterTest : public ::testing::Test {};
+
+// ============================================================================
+// Payload Tests
+// ============================================================================
+
+TEST_F(OtlpExporterTest, BuildPayload_RootAndStageSpans) {
+    // Arrange
+    auto trace = std::make_shared<utils::RequestTrace>(
+        "00-4bf92f3577b34da6a3ce929d0e0e4736-00f067aa0ba902b7-01", "req-42", 1.0);
+    auto base = utils::RequestTrace::Clock::now();
+    trace->addSpan("decode", base, base + std::chrono::milliseconds(4));
+    trace->finish("GET", "/api/images/:id", 503);
+
+    // Act
+    json payload = json::parse(OtlpExporter::buildPayload({trace}, "gara-test"));
+
+    // Assert
+    const json& resource = payload["resourceSpans"][0];
+    EXPECT_EQ(resource["resource"]["attributes"][0]["value"]["stringValue"], "gara-test");
+
+    const json& spans = resource["scopeSpans"][0]["spans"];
+    ASSERT_EQ(spans.size(), 2u);
+
+    const json& root = spans[0];
+    EXPECT_EQ(root["traceId"], "4bf92f3577b34da6a3ce929d0e0e4736");
+    EXPECT_EQ(root["spanId"], trace->spanId());
+    EXPECT_EQ(root["parentSpanId"], "00f067aa0ba902b7");
+    EXPECT_EQ(root["name"], "GET /api/images/:id");
+    EXPECT_EQ(root["kind"], 2);
+    EXPECT_EQ(root["status"]["code"], 2);
+
+    const json& stage = spans[1];
+    EXPECT_EQ(stage["name"], "decode");
+    EXPECT_EQ(stage["parentSpanId"], trace->spanId());
+    EXPECT_EQ(stage["spanId"].get<std::string>().size(), 16u);
+    uint64_t start = std::stoull(stage["startTimeUnixNano"].get<std::string>());
+    uint64_t end = std::stoull(stage["endTimeUnixNano"].get<std::string>());
+    EXPECT_EQ(end - start, 4000000u);
+}
+
+TEST_F(OtlpExporterTest, BuildPayload_UnparentedSuccess_OmitsParentAndStatus) {
+    auto trace = std::make_shared<utils::RequestTrace>("", "req", 1.0);
+    trace->finish("GET", "/health", 200);
+
+    json payload = json::parse(OtlpExporter::buildPayload({trace}, "gara-image"));
+    const json& root = payload["resourceSpans"][0]["scopeSpans"][0]["spans"][0];
+
+    EXPECT_FALSE(root.contains("parentSpanId"));
+    EXPECT_FALSE(root.contains("status"));
+}
+
+TEST_F(OtlpExporterTest, Constructor_BaseEndpoint_AppendsTracesPath) {
+    TracingConfig config;
+    config.otlp_endpoint = "http://127.0.0.1:4318/";
+    OtlpExporter exporter(config);
+
+    EXPECT_EQ(exporter.url(), "http://127.0.0.1:4318/v1/traces");
+}
@@ -0,0 +1,138 @@
+#include <gtest/gtest.h>
+#include "services/peer_pool.h"
+#include "utils/logger.h"
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace gara;
+
+class PeerPoolTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        gara::Logger::initialize("gara-test", "error", gara::Logger::Format::TEXT, "test");
+        clearPeerEnvVars();
+    }
+
+    void TearDown() override {
+        clearPeerEnvVars();
+    }
+
+    void clearPeerEnvVars() {
+        unsetenv("PEER_SELF_URL");
+        unsetenv("PEER_URLS");
+        unsetenv("PEER_DNS_NAME");
+        unsetenv("PEER_PORT");
+        unsetenv("PEER_VIRTUAL_NODES");
+    }
+
+    static PeerConfig staticConfig() {
+        PeerConfig config;
+        config.self_url = SELF;
+        config.urls = {SELF, "http://10.0.0.2:8080", "http://10.0.0.3:8080"};
+        return config;
+    }
+
+    static constexpr const char* SELF = "http://10.0.0.1:8080";
+};
+
+// ============================================================================
+// PeerConfig Tests
+// ============================================================================
+
+TEST_F(PeerPoolTest, PeerConfig_FromEnvironment_ParsesAndNormalizesUrls) {
+    // Arrange
+    setenv("PEER_SELF_URL", "http://10.0.0.1:8080/", 1);
+    setenv("PEER_URLS", " http://10.0.0.1:8080, http://10.0.0.2:8080/ ,,", 1);
+
+    // Act
+    PeerConfig config = PeerConfig::fromEnvironment();
+
+    // Assert
+    EXPECT_TRUE(config.isEnabled());
+    EXPECT_EQ(SELF, config.self_url);
+    EXPECT_EQ((std::vector<std::string>{SELF, "http://10.0.0.2:8080"}), config.urls);
+}
+
+TEST_F(PeerPoolTest, PeerConfig_NoSelfUrl_IsDisabled) {
+    setenv("PEER_URLS", "http://10.0.0.2:8080", 1);
+
+    EXPECT_FALSE(PeerConfig::fromEnvironment().isEnabled());
+}
+
+// ============================================================================
+// Ownership Tests
+// ============================================================================
+
+TEST_F(PeerPoolTest, OwnerOf_KeysOwnedHere_ReturnEmpty) {
+    // Arrange
+    PeerPool pool(staticConfig());
+
+    // Act
+    int local = 0;
+    int remote = 0;
+    for (int i = 0; i < 300; ++i) {
+        std::string owner = pool.ownerOf("transformed/image" + std::to_string(i) + "_jpeg_0x0.jpeg");
+        if (owner.empty()) {
+            ++local;
+        } else {
+            ++remote;
+            EXPECT_NE(SELF, owner);
+        }
+    }
+
+    // Assert - roughly a third each
+    EXPECT_GT(local, 50);
+    EXPECT_GT(remote, 100);
+}
+
+TEST_F(PeerPoolTest, SetMembers_WithoutSelf_KeepsSelfAsMember) {
+    // Arrange
+    PeerPool pool(staticConfig());
+
+    // Act
+    pool.setMembers({"http://10.0.0.9:8080/"});
+
+    // Assert
+    EXPECT_EQ((std::vector<std::string>{SELF, "http://10.0.0.9:8080"}), pool.members());
+}
+
+TEST_F(PeerPoolTest, OwnerOf_OnlySelf_OwnsEverything) {
+    // Arrange
+    PeerConfig config = staticConfig();
+    config.urls = {};
+    PeerPool pool(config);
+
+    // Act & Assert
+    EXPECT_EQ("", pool.ownerOf("transformed/a_webp_320x0.webp"));
+    EXPECT_EQ("", pool.ownerOf("transformed/b_webp_320x0.webp"));
+}
+
+// ============================================================================
+// Transport Tests
+// ============================================================================
+
+TEST_F(PeerPoolTest, Get_UnreachablePeer_ReturnsStatusZero) {
+    // Arrange - nothing listens on port 1
+    PeerConfig config = staticConfig();
+    config.connect_timeout_ms = 200;
+    config.timeout_ms = 500;
+    PeerPool pool(config);
+
+    // Act
+    PeerPool::Response response = pool.get("http://127.0.0.1:1", "/internal/peer/renditions/abc");
+
+    // Assert
+    EXPECT_EQ(0, response.status);
+    EXPECT_TRUE(response.body.empty());
+}
+
+TEST_F(PeerPoolTest, Resolve_Localhost_ReturnsBaseUrls) {
+    auto urls = PeerPool::resolve("localhost", 9000);
+
+    ASSERT_FALSE(urls.empty());
+    for (const auto& url : urls) {
+        EXPECT_EQ(0u, url.rfind("http://", 0)) << url;
+        EXPECT_NE(std::string::npos, url.find(":9000")) << url;
+    }
+}
@@ -0,0 +1,139 @@
+#include <gtest/gtest.h>
+#include "services/raw_key_resolver.h"
+#include "models/image_metadata.h"
+#include "utils/logger.h"
+#include "utils/metrics.h"
+#include "mocks/fake_file_service.h"
+#include "mocks/fake_database_client.h"
+#include "test_helpers/test_constants.h"
+#include "test_helpers/test_builders.h"
+#include <memory>
+
+using namespace gara;
+using namespace gara::testing;
+using namespace gara::test_constants;
+using namespace gara::test_builders;
+
+class RawKeyResolverTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        gara::Logger::initialize("gara-test", "error", gara::Logger::Format::TEXT, "test");
+        gara::Metrics::initialize("GaraTest", "gara-test", "test", false);
+
+        fake_file_service_ = std::make_shared<FakeFileService>(TEST_BUCKET_NAME);
+        fake_db_client_ = std::make_shared<FakeDatabaseClient>();
+        resolver_ = std::make_shared<RawKeyResolver>(fake_db_client_, fake_file_service_);
+    }
+
+    void TearDown() override {
+        fake_file_service_->clear();
+        fake_db_client_->clear();
+    }
+
+    void storeMetadata(const std::string& image_id, const std::string& format) {
+        ImageMetadata metadata;
+        metadata.image_id = image_id;
+        metadata.original_format = format;
+        metadata.s3_raw_key = ImageMetadata::generateRawKey(image_id, format);
+        fake_db_client_->putImageMetadata(metadata);
+    }
+
+    std::shared_ptr<FakeFileService> fake_file_service_;
+    std::shared_ptr<FakeDatabaseClient> fake_db_client_;
+    std::shared_ptr<RawKeyResolver> resolver_;
+};
+
+// ============================================================================
+// Resolution Tests
+// ============================================================================
+
+TEST_F(RawKeyResolverTest, Resolve_WithMetadata_ReturnsKeyWithoutStorageLookup) {
+    // Arrange - metadata only, no object in storage
+    storeMetadata(TEST_IMAGE_ID, FORMAT_PNG);
+
+    // Act
+    std::string key = resolver_->resolve(TEST_IMAGE_ID);
+
+    // Assert
+    EXPECT_EQ(TestDataBuilder::createRawImageKey(TEST_IMAGE_ID, FORMAT_PNG), key)
+        << "Raw key should come from image metadata";
+}
+
+TEST_F(RawKeyResolverTest, Resolve_WithoutMetadata_FallsBackToProbing) {
+    // Arrange
+    auto raw_key = TestDataBuilder::createRawImageKey(TEST_IMAGE_ID, FORMAT_WEBP);
+    fake_file_service_->uploadData(TestDataBuilder::createData(SMALL_DATA_SIZE), raw_key);
+
+    // Act
+    std::string key = resolver_->resolve(TEST_IMAGE_ID);
+
+    // Assert
+    EXPECT_EQ(raw_key, key)
+        << "Images without metadata should be found by probing storage";
+}
+
+TEST_F(RawKeyResolverTest, Resolve_UnknownImage_ReturnsEmpty) {
+    // Act
+    std::string key = resolver_->resolve(IMAGE_ID_NONEXISTENT);
+
+    // Assert
+    EXPECT_TRUE(key.empty());
+}
+
+TEST_F(RawKeyResolverTest, Resolve_SecondCall_ServedFromMemory) {
+    // Arrange
+    storeMetadata(TEST_IMAGE_ID, FORMAT_JPG);
+    std::string first = resolver_->resolve(TEST_IMAGE_ID);
+    fake_db_client_->clear();
+
+    // Act
+    std::string second = resolver_->resolve(TEST_IMAGE_ID);
+
+    // Assert
+    EXPECT_EQ(first, second)
+        << "Resolved keys should be cached in memory";
+}
+
+TEST_F(RawKeyResolverTest, Remember_ThenResolve_ReturnsRememberedKey) {
+    // Arrange
+    auto raw_key = TestDataBuilder::createRawImageKey(TEST_IMAGE_ID, FORMAT_GIF);
+
+    // Act
+    resolver_->remember(TEST_IMAGE_ID, raw_key);
+
+    // Assert
+    EXPECT_EQ(raw_key, resolver_->resolve(TEST_IMAGE_ID));
+}
+
+TEST_F(RawKeyResolverTest, Forget_AfterResolve_ResolvesAgain) {
+    // Arrange
+    resolver_->remember(TEST_IMAGE_ID, "raw/stale.jpg");
+
+    // Act
+    resolver_->forget(TEST_IMAGE_ID);
+
+    // Assert
+    EXPECT_TRUE(resolver_->resolve(TEST_IMAGE_ID).empty())
+        << "Forgotten mappings should not be served";
+}
+
+// ============================================================================
+// Batch Resolution Tests
+// ============================================================================
+
+TEST_F(RawKeyResolverTest, ResolveAll_MixedImages_KeysInInputOrder) {
+    // Arrange - one with metadata, one only in storage, one unknown
+    storeMetadata(TEST_IMAGE_ID, FORMAT_PNG);
+    const std::string probed_id = "probed-image";
+    auto probed_key = TestDataBuilder::createRawImageKey(probed_id, FORMAT_JPEG);
+    fake_file_service_->uploadData(TestDataBuilder::createData(SMALL_DATA_SIZE), probed_key);
+
+    // Act
+    auto keys = resolver_->resolveAll({IMAGE_ID_NONEXISTENT, probed_id, TEST_IMAGE_ID});
+
+    // Assert
+    ASSERT_EQ(3u, keys.size());
+    EXPECT_TRUE(keys[0].empty());
+    EXPECT_EQ(probed_key, keys[1]);
+    EXPECT_EQ(TestDataBuilder::createRawImageKey(TEST_IMAGE_ID, FORMAT_PNG), keys[2]);
+}
@@ -0,0 +1,298 @@
+#include <gtest/gtest.h>
+#include "services/render_job_worker.h"
+#include "mocks/fake_database_client.h"
+#include "utils/logger.h"
+#include "utils/metrics.h"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace gara;
+using namespace gara::testing;
+
+class RenderJobWorkerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        gara::Logger::initialize("gara-test", "error", gara::Logger::Format::TEXT, "test");
+        gara::Metrics::initialize("GaraTest", "gara-test", "test", false);
+        unsetenv("RENDER_JOBS_ENABLED");
+        unsetenv("RENDER_JOBS_RETRY_BASE_SECONDS");
+        unsetenv("RENDER_JOBS_RETRY_MAX_SECONDS");
+
+        db_client_ = std::make_shared<FakeDatabaseClient>();
+        config_.enabled = true;
+        config_.poll_interval_ms = 10;
+    }
+
+    static RenderJob job(const std::string& image_id, const std::string& format, int width, int priority = 0) {
+        RenderJob job;
+        job.image_id = image_id;
+        job.format = format;
+        job.width = width;
+        job.priority = priority;
+        job.run_after = std::time(nullptr);
+        return job;
+    }
+
+    // Handler answering every job with outcome, recording the calls
+    RenderJobWorker::BatchHandler handlerReturning(RenderJobOutcome outcome) {
+        return [this, outcome](const std::string& image_id, const std::vector<RenderJob>& jobs) {
+            std::lock_guard<std::mutex> lock(calls_mutex_);
+            calls_.push_back({image_id, jobs.size()});
+            return std::vector<RenderJobResult>(jobs.size(), RenderJobResult{outcome, "boom"});
+        };
+    }
+
+    struct Call {
+        std::string image_id;
+        size_t jobs;
+    };
+
+    std::shared_ptr<FakeDatabaseClient> db_client_;
+    RenderJobConfig config_;
+    std::mutex calls_mutex_;
+    std::vector<Call> calls_;
+};
+
+// ============================================================================
+// Config Tests
+// ============================================================================
+
+TEST_F(RenderJobWorkerTest, Config_RetryDelay_DoublesUpToTheCap) {
+    // Arrange
+    setenv("RENDER_JOBS_ENABLED", "true", 1);
+    setenv("RENDER_JOBS_RETRY_BASE_SECONDS", "10", 1);
+    setenv("RENDER_JOBS_RETRY_MAX_SECONDS", "60", 1);
+
+    // Act
+    RenderJobConfig config = RenderJobConfig::fromEnvironment();
+
+    // Assert
+    EXPECT_TRUE(config.isEnabled());
+    EXPECT_EQ(10, config.retryDelaySeconds(1));
+    EXPECT_EQ(20, config.retryDelaySeconds(2));
+    EXPECT_EQ(40, config.retryDelaySeconds(3));
+    EXPECT_EQ(60, config.retryDelaySeconds(4));
+    EXPECT_EQ(60, config.retryDelaySeconds(40));
+    EXPECT_FALSE(RenderJobConfig().isEnabled());
+}
+
+// ============================================================================
+// Claim Tests
+// ============================================================================
+
+TEST_F(RenderJobWorkerTest, RunOnce_DoneJobs_AreRemovedWithOneCallPerImage) {
+    // Arrange
+    ASSERT_TRUE(db_client_->enqueueRenderJobs({
+        job("img-a", "webp", 320), job("img-b", "webp", 320), job("img-a", "webp", 640)
+    }));
+    RenderJobWorker worker(config_, db_client_, handlerReturning(RenderJobOutcome::DONE));
+
+    // Act
+    size_t claimed = worker.runOnce();
+
+    // Assert
+    EXPECT_EQ(3u, claimed);
+    ASSERT_EQ(2u, calls_.size());
+    EXPECT_EQ("img-a", calls_[0].image_id);
+    EXPECT_EQ(2u, calls_[0].jobs);
+    EXPECT_EQ("img-b", calls_[1].image_id);
+    RenderJobCounts counts = db_client_->getRenderJobCounts(std::time(nullptr));
+    EXPECT_EQ(0, counts.pending + counts.leased + counts.failed);
+}
+
+TEST_F(RenderJobWorkerTest, RunOnce_JobQueuedAgainWhileRunning_IsKept) {
+    // Arrange - the handler's image is requested again mid-render
+    ASSERT_TRUE(db_client_->enqueueRenderJobs({job("img-a", "webp", 320)}));
+    RenderJobWorker worker(config_, db_client_,
+        [this](const std::string&, const std::vector<RenderJob>& jobs) {
+            db_client_->enqueueRenderJobs({job("img-a", "webp", 320)});
+            return std::vector<RenderJobResult>(jobs.size(), RenderJobResult{RenderJobOutcome::DONE, ""});
+        });
+
+    // Act
+    worker.runOnce();
+
+    // Assert
+    RenderJobCounts counts = db_client_->getRenderJobCounts(std::time(nullptr));
+    EXPECT_EQ(1, counts.pending + counts.leased)
+        << "Completing the older claim should not remove the newer request";
+}
+
+TEST_F(RenderJobWorkerTest, RunOnce_BatchLimit_ClaimsHighestPriorityImageFirst) {
+    // Arrange
+    config_.batch_images = 1;
+    ASSERT_TRUE(db_client_->enqueueRenderJobs({
+        job("img-low", "webp", 320, RenderJobPriority::BACKFILL),
+        job("img-high", "webp", 320, RenderJobPriority::PREGENERATE)
+    }));
+    RenderJobWorker worker(config_, db_client_, handlerReturning(RenderJobOutcome::DONE));
+
+    // Act
+    worker.runOnce();
+
+    // Assert
+    ASSERT_EQ(1u, calls_.size());
+    EXPECT_EQ("img-high", calls_[0].image_id);
+    EXPECT_EQ(1, db_client_->getRenderJobCounts(std::time(nullptr)).pending);
+}
+
+TEST_F(RenderJobWorkerTest, RunOnce_ManyJobsPerImage_ClaimsBatchImagesImages) {
+    // Arrange
+    config_.batch_images = 2;
+    ASSERT_TRUE(db_client_->enqueueRenderJobs({
+        job("img-a", "webp", 320, RenderJobPriority::PREGENERATE),
+        job("img-a", "webp", 640, RenderJobPriority::PREGENERATE),
+        job("img-a", "jpeg", 1280, RenderJobPriority::PREGENERATE),
+        job("img-b", "webp", 320, RenderJobPriority::BACKFILL),
+        job("img-c", "webp", 320, RenderJobPriority::BACKFILL)
+    }));
+    RenderJobWorker worker(config_, db_client_, handlerReturning(RenderJobOutcome::DONE));
+
+    // Act
+    size_t claimed = worker.runOnce();
+
+    // Assert
+    EXPECT_EQ(4u, claimed);
+    ASSERT_EQ(2u, calls_.size())
+        << "batch_images should count images, not jobs";
+    EXPECT_EQ("img-a", calls_[0].image_id);
+    EXPECT_EQ(3u, calls_[0].jobs);
+    EXPECT_EQ(1, db_client_->getRenderJobCounts(std::time(nullptr)).pending);
+}
+
+TEST_F(RenderJobWorkerTest, RunOnce_NoSpareCapacity_ClaimsNothing) {
+    // Arrange
+    ASSERT_TRUE(db_client_->enqueueRenderJobs({job("img-a", "webp", 320)}));
+    RenderJobWorker worker(config_, db_client_, handlerReturning(RenderJobOutcome::DONE),
+                           []() { return false; });
+
+    // Act
+    size_t claimed = worker.runOnce();
+
+    // Assert
+    EXPECT_EQ(0u, claimed);
+    EXPECT_TRUE(calls_.empty());
+    EXPECT_EQ(1, db_client_->getRenderJobCounts(std::time(nullptr)).pending);
+}
+
+// ============================================================================
+// Retry Tests
+// ============================================================================
+
+TEST_F(RenderJobWorkerTest, RunOnce_Retry_BacksOffBeforeTheNextAttempt) {
+    // Arrange
+    config_.max_attempts = 3;
+    config_.retry_base_seconds = 60;
+    ASSERT_TRUE(db_client_->enqueueRenderJobs({job("img-a", "webp", 320)}));
+    RenderJobWorker worker(config_, db_client_, handlerReturning(RenderJobOutcome::RETRY));
+    std::time_t before = std::time(nullptr);
+
+    // Act
+    size_t first = worker.runOnce();
+    size_t second = worker.runOnce();
+
+    // Assert
+    EXPECT_EQ(1u, first);
+    EXPECT_EQ(0u, second)
+        << "A retried job should wait out its backoff";
+    auto queued = db_client_->getRenderJob(1);
+    ASSERT_TRUE(queued.has_value());
+    EXPECT_EQ(1, queued->attempts);
+    EXPECT_GE(queued->run_after, before + 60);
+    EXPECT_EQ(1, db_client_->getRenderJobCounts(std::time(nullptr)).pending);
+}
+
+TEST_F(RenderJobWorkerTest, RunOnce_LastAttemptFails_KeepsJobAsFailed) {
+    // Arrange
+    config_.max_attempts = 1;
+    ASSERT_TRUE(db_client_->enqueueRenderJobs({job("img-a", "webp", 320)}));
+    RenderJobWorker worker(config_, db_client_, [](const std::string&, const std::vector<RenderJob>&)
+        -> std::vector<RenderJobResult> {
+        throw std::runtime_error("storage unavailable");
+    });
+
+    // Act
+    worker.runOnce();
+
+    // Assert
+    RenderJobCounts counts = db_client_->getRenderJobCounts(std::time(nullptr));
+    EXPECT_EQ(1, counts.failed);
+    EXPECT_EQ(0, counts.pending);
+
+    // A failed job is given a fresh start when queued again
+    ASSERT_TRUE(db_client_->enqueueRenderJobs({job("img-a", "webp", 320)}));
+    EXPECT_EQ(1, db_client_->getRenderJobCounts(std::time(nullptr)).pending);
+}
+
+TEST_F(RenderJobWorkerTest, RunOnce_PermanentFailure_SkipsRetries) {
+    // Arrange
+    config_.max_attempts = 5;
+    ASSERT_TRUE(db_client_->enqueueRenderJobs({job("img-a", "webp", 320)}));
+    RenderJobWorker worker(config_, db_client_, handlerReturning(RenderJobOutcome::FAILED));
+
+    // Act
+    worker.runOnce();
+
+    // Assert
+    EXPECT_EQ(1, db_client_->getRenderJobCounts(std::time(nullptr)).failed);
+}
+
+// ============================================================================
+// Backfill Tests
+// ============================================================================
+
+TEST_F(RenderJobWorkerTest, Backfill_QueuesEachRenditionForEveryImageOnce) {
+    // Arrange
+    for (int i = 0; i < 3; ++i) {
+        ImageMetadata metadata("img-" + std::to_string(i), "jpg", "raw/img-" + std::to_string(i) + ".jpg", 100);
+        metadata.upload_timestamp = 1000 + i;
+        db_client_->putImageMetadata(metadata);
+    }
+    RenderJobWorker worker(config_, db_client_, handlerReturning(RenderJobOutcome::DONE));
+    std::vector<RenderJob> renditions = {job("", "webp", 320), job("", "jpeg", 1280)};
+
+    // Act
+    size_t queued = worker.backfill(renditions, RenderJobPriority::BACKFILL);
+    worker.backfill(renditions, RenderJobPriority::BACKFILL);
+
+    // Assert
+    EXPECT_EQ(6u, queued);
+    EXPECT_EQ(6, db_client_->getRenderJobCounts(std::time(nullptr)).pending)
+        << "Queuing a rendition again should not duplicate its job";
+}
+
+// ============================================================================
+// Worker Thread Tests
+// ============================================================================
+
+TEST_F(RenderJobWorkerTest, Start_WithQueuedJobs_DrainsQueueUntilStopped) {
+    // Arrange
+    config_.workers = 2;
+    std::vector<RenderJob> jobs;
+    for (int i = 0; i < 20; ++i) {
+        jobs.push_back(job("img-" + std::to_string(i), "webp", 320));
+    }
+    ASSERT_TRUE(db_client_->enqueueRenderJobs(jobs));
+    RenderJobWorker worker(config_, db_client_, handlerReturning(RenderJobOutcome::DONE));
+
+    // Act
+    worker.start();
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (db_client_->getRenderJobCounts(std::time(nullptr)).pending > 0 &&
+           std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    worker.stop();
+
+    // Assert
+    RenderJobCounts counts = db_client_->getRenderJobCounts(std::time(nullptr));
+    EXPECT_EQ(0, counts.pending + counts.leased + counts.failed);
+    EXPECT_EQ(20u, calls_.size());
+}
@@ -0,0 +1,137 @@
+#include <gtest/gtest.h>
+#include "services/resource_governor.h"
+#include "exceptions/transform_exceptions.h"
+#include "utils/logger.h"
+#include "utils/metrics.h"
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <thread>
+
+using namespace gara;
+
+class ResourceGovernorTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        gara::Logger::initialize("gara-test", "error", gara::Logger::Format::TEXT, "test");
+        gara::Metrics::initialize("GaraTest", "gara-test", "test", false);
+    }
+
+    static GovernorConfig budget(uint64_t bytes, int timeout_ms = 2000) {
+        GovernorConfig config;
+        config.memory_budget_bytes = bytes;
+        config.admission_timeout_ms = timeout_ms;
+        return config;
+    }
+};
+
+// ============================================================================
+// Cost Estimation Tests
+// ============================================================================
+
+TEST_F(ResourceGovernorTest, EstimateCost_NoResize_CountsSourceAndOutput) {
+    // Act
+    uint64_t cost = ResourceGovernor::estimateCost(1000, 100, 100, 3, "png", 0, 0);
+
+    // Assert: input + decoded + output
+    EXPECT_EQ(cost, 1000u + (100u * 100u + 100u * 100u) * 3u);
+}
+
+TEST_F(ResourceGovernorTest, EstimateCost_JpegDownscale_UsesShrinkOnLoad) {
+    // Act
+    uint64_t jpeg = ResourceGovernor::estimateCost(0, 8000, 8000, 3, "jpeg", 800, 0);
+    uint64_t png = ResourceGovernor::estimateCost(0, 8000, 8000, 3, "png", 800, 0);
+
+    // Assert: JPEG decodes at 1/8 scale, PNG at full size
+    EXPECT_EQ(jpeg, (1000u * 1000u + 800u * 800u) * 3u);
+    EXPECT_EQ(png, (8000u * 8000u + 800u * 800u) * 3u);
+}
+
+TEST_F(ResourceGovernorTest, EstimateCost_UnknownBands_AssumesRgba) {
+    // Act
+    uint64_t cost = ResourceGovernor::estimateCost(0, 10, 10, 0, "png", 10, 10);
+
+    // Assert
+    EXPECT_EQ(cost, (10u * 10u + 10u * 10u) * 4u);
+}
+
+// ============================================================================
+// Admission Tests
+// ============================================================================
+
+TEST_F(ResourceGovernorTest, Admit_WithinBudget_AdmitsImmediately) {
+    // Arrange
+    ResourceGovernor governor(budget(100));
+
+    // Act
+    auto first = governor.admit(40);
+    auto second = governor.admit(60);
+
+    // Assert
+    EXPECT_EQ(governor.inUseBytes(), 100u);
+    first.release();
+    EXPECT_EQ(governor.inUseBytes(), 60u);
+}
+
+TEST_F(ResourceGovernorTest, Admit_BudgetFull_WaitsForRelease) {
+    // Arrange
+    ResourceGovernor governor(budget(100));
+    auto held = governor.admit(80);
+    std::atomic<bool> admitted{false};
+
+    // Act
+    std::thread waiter([&]() {
+        auto permit = governor.admit(50);
+        admitted = true;
+    });
+    while (governor.waiting() == 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_FALSE(admitted);
+    held.release();
+    waiter.join();
+
+    // Assert
+    EXPECT_TRUE(admitted);
+    EXPECT_EQ(governor.inUseBytes(), 0u);
+}
+
+TEST_F(ResourceGovernorTest, Admit_Timeout_ThrowsServiceUnavailable) {
+    // Arrange
+    ResourceGovernor governor(budget(100, 20), 5);
+    auto held = governor.admit(100);
+
+    // Act & Assert
+    try {
+        governor.admit(10);
+        FAIL() << "Expected ServiceUnavailableException";
+    } catch (const exceptions::ServiceUnavailableException& e) {
+        EXPECT_EQ(e.retryAfterSeconds(), 5);
+    }
+    EXPECT_EQ(governor.waiting(), 0u);
+    EXPECT_EQ(governor.inUseBytes(), 100u);
+}
+
+TEST_F(ResourceGovernorTest, Admit_CostAboveBudget_RunsAlone) {
+    // Arrange
+    ResourceGovernor governor(budget(100));
+
+    // Act
+    auto permit = governor.admit(10000);
+
+    // Assert: clamped to the whole budget
+    EXPECT_EQ(permit.cost(), 100u);
+    EXPECT_EQ(governor.inUseBytes(), 100u);
+}
+
+TEST_F(ResourceGovernorTest, Admit_ZeroBudget_Disabled) {
+    // Arrange
+    ResourceGovernor governor(budget(0));
+
+    // Act
+    auto permit = governor.admit(1u << 30);
+
+    // Assert
+    EXPECT_FALSE(governor.enabled());
+    EXPECT_EQ(governor.inUseBytes(), 0u);
+}
@@ -0,0 +1,169 @@
+#include <gtest/gtest.h>
+#include "services/simulated_file_service.h"
+#include "utils/logger.h"
+#include "utils/metrics.h"
+#include "mocks/fake_file_service.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace gara;
+using namespace gara::testing;
+
+class SimulatedFileServiceTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        gara::Logger::initialize("gara-test", "error", gara::Logger::Format::TEXT, "test");
+        gara::Metrics::initialize("GaraTest", "gara-test", "test", false);
+        clearSimulationEnvVars();
+
+        backend_ = std::make_shared<FakeFileService>();
+        backend_->uploadData(std::vector<char>(1000, 'x'), "raw/a.jpg");
+    }
+
+    void TearDown() override {
+        clearSimulationEnvVars();
+    }
+
+    void clearSimulationEnvVars() {
+        unsetenv("STORAGE_SIM_ENABLED");
+        unsetenv("STORAGE_SIM_ERROR_RATE");
+        unsetenv("STORAGE_SIM_GET_LATENCY_MS");
+        unsetenv("STORAGE_SIM_GET_P99_MS");
+        unsetenv("STORAGE_SIM_PUT_ERROR_RATE");
+        unsetenv("STORAGE_SIM_BANDWIDTH_BYTES_PER_SEC");
+    }
+
+    // A profile set that answers instantly and never fails
+    static StorageSimulationConfig instantConfig() {
+        StorageSimulationConfig config;
+        config.enabled = true;
+        for (auto* profile : {&config.get, &config.put, &config.head, &config.del}) {
+            *profile = StorageOperationProfile(0.0, 0.0);
+        }
+        return config;
+    }
+
+    static double elapsedMs(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    std::shared_ptr<FakeFileService> backend_;
+};
+
+// ============================================================================
+// Config Tests
+// ============================================================================
+
+TEST_F(SimulatedFileServiceTest, Config_FromEnvironment_OperationOverridesGlobalErrorRate) {
+    // Arrange
+    setenv("STORAGE_SIM_ENABLED", "true", 1);
+    setenv("STORAGE_SIM_ERROR_RATE", "0.1", 1);
+    setenv("STORAGE_SIM_PUT_ERROR_RATE", "2", 1);
+    setenv("STORAGE_SIM_GET_LATENCY_MS", "25", 1);
+    setenv("STORAGE_SIM_BANDWIDTH_BYTES_PER_SEC", "1048576", 1);
+
+    // Act
+    StorageSimulationConfig config = StorageSimulationConfig::fromEnvironment();
+
+    // Assert
+    EXPECT_TRUE(config.isEnabled());
+    EXPECT_DOUBLE_EQ(0.1, config.get.error_rate);
+    EXPECT_DOUBLE_EQ(1.0, config.put.error_rate);
+    EXPECT_DOUBLE_EQ(25.0, config.get.median_ms);
+    EXPECT_EQ(1048576u, config.bandwidth_bytes_per_sec);
+}
+
+TEST_F(SimulatedFileServiceTest, Config_Default_IsDisabled) {
+    EXPECT_FALSE(StorageSimulationConfig::fromEnvironment().isEnabled());
+}
+
+// ============================================================================
+// Latency Tests
+// ============================================================================
+
+TEST_F(SimulatedFileServiceTest, SampleLatency_LogNormal_MatchesMedianAndTail) {
+    // Arrange
+    StorageSimulationConfig config = instantConfig();
+    config.get = StorageOperationProfile(30.0, 80.0);
+    SimulatedFileService service(backend_, config);
+
+    // Act
+    std::vector<double> samples;
+    for (int i = 0; i < 20000; ++i) {
+        samples.push_back(service.sampleLatencyMs(SimulatedFileService::Operation::GET));
+    }
+    std::sort(samples.begin(), samples.end());
+
+    // Assert
+    EXPECT_NEAR(30.0, samples[samples.size() / 2], 1.5);
+    EXPECT_NEAR(80.0, samples[samples.size() * 99 / 100], 8.0);
+    EXPECT_LE(samples.back(), 320.0);
+}
+
+TEST_F(SimulatedFileServiceTest, DownloadData_FixedLatencyAndBandwidth_TakesBoth) {
+    // Arrange - 20 ms round trip plus 1000 bytes at 50 KB/s
+    StorageSimulationConfig config = instantConfig();
+    config.get = StorageOperationProfile(20.0, 0.0);
+    config.bandwidth_bytes_per_sec = 50000;
+    SimulatedFileService service(backend_, config);
+
+    // Act
+    auto start = std::chrono::steady_clock::now();
+    auto data = service.downloadData("raw/a.jpg");
+
+    // Assert
+    EXPECT_EQ(1000u, data.size());
+    EXPECT_GE(elapsedMs(start), 40.0);
+    EXPECT_DOUBLE_EQ(20.0, service.transferMs(1000));
+}
+
+TEST_F(SimulatedFileServiceTest, ObjectExists_NoDelayConfigured_PassesThrough) {
+    SimulatedFileService service(backend_, instantConfig());
+
+    EXPECT_TRUE(service.objectExists("raw/a.jpg"));
+    EXPECT_FALSE(service.objectExists("raw/missing.jpg"));
+    EXPECT_EQ(backend_->getBucketName(), service.getBucketName());
+    EXPECT_EQ(nullptr, service.mapObject("raw/a.jpg"));
+}
+
+// ============================================================================
+// Error Injection Tests
+// ============================================================================
+
+TEST_F(SimulatedFileServiceTest, UploadData_AlwaysFailing_NeverReachesBackend) {
+    // Arrange
+    StorageSimulationConfig config = instantConfig();
+    config.put.error_rate = 1.0;
+    SimulatedFileService service(backend_, config);
+
+    // Act
+    bool uploaded = service.uploadData(std::vector<char>(10, 'y'), "raw/b.jpg");
+
+    // Assert
+    EXPECT_FALSE(uploaded);
+    EXPECT_FALSE(backend_->objectExists("raw/b.jpg"));
+    EXPECT_EQ(1000u, service.downloadData("raw/a.jpg").size());
+}
+
+TEST_F(SimulatedFileServiceTest, DownloadData_PartialErrorRate_FailsThatFraction) {
+    // Arrange
+    StorageSimulationConfig config = instantConfig();
+    config.get.error_rate = 0.25;
+    SimulatedFileService service(backend_, config);
+
+    // Act
+    int failures = 0;
+    for (int i = 0; i < 4000; ++i) {
+        if (service.downloadData("raw/a.jpg").empty()) {
+            ++failures;
+        }
+    }
+
+    // Assert
+    EXPECT_GT(failures, 800);
+    EXPECT_LT(failures, 1200);
+}
@@ -0,0 +1,145 @@
+#include <gtest/gtest.h>
+#include "services/transform_executor.h"
+#include "utils/logger.h"
+#include "utils/metrics.h"
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace gara;
+
+class TransformExecutorTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        gara::Logger::initialize("gara-test", "error", gara::Logger::Format::TEXT, "test");
+        gara::Metrics::initialize("GaraTest", "gara-test", "test", false);
+    }
+
+    // Occupy the single worker until the returned promise is fulfilled
+    std::promise<void> blockWorker(TransformExecutor& executor) {
+        std::promise<void> release;
+        auto released = release.get_future().share();
+        std::promise<void> started;
+        auto started_future = started.get_future();
+        executor.trySubmit(TransformPriority::NORMAL, [released, &started]() {
+            started.set_value();
+            released.wait();
+        });
+        started_future.wait();
+        return release;
+    }
+};
+
+// ============================================================================
+// Execution Tests
+// ============================================================================
+
+TEST_F(TransformExecutorTest, TrySubmit_WithCapacity_RunsTask) {
+    // Arrange
+    TransformExecutor executor(2, 4);
+    std::promise<int> result;
+
+    // Act
+    bool accepted = executor.trySubmit(TransformPriority::NORMAL, [&result]() {
+        result.set_value(7);
+    });
+
+    // Assert
+    EXPECT_TRUE(accepted);
+    EXPECT_EQ(7, result.get_future().get());
+}
+
+TEST_F(TransformExecutorTest, TrySubmit_QueueFull_RejectsTask) {
+    // Arrange
+    TransformExecutor executor(1, 1);
+    auto release = blockWorker(executor);
+    ASSERT_TRUE(executor.trySubmit(TransformPriority::NORMAL, []() {}));
+
+    // Act
+    bool accepted = executor.trySubmit(TransformPriority::HIGH, []() {});
+
+    // Assert
+    EXPECT_FALSE(accepted)
+        << "Tasks beyond the queue bound should be refused";
+    EXPECT_EQ(1u, executor.queueDepth());
+
+    release.set_value();
+}
+
+TEST_F(TransformExecutorTest, Worker_WithMixedLanes_RunsHighPriorityFirst) {
+    // Arrange
+    TransformExecutor executor(1, 8);
+    auto release = blockWorker(executor);
+    std::mutex order_mutex;
+    std::vector<std::string> order;
+    auto record = [&order, &order_mutex](const std::string& name) {
+        return [&order, &order_mutex, name]() {
+            std::lock_guard<std::mutex> lock(order_mutex);
+            order.push_back(name);
+        };
+    };
+
+    executor.trySubmit(TransformPriority::LOW, record("low"));
+    executor.trySubmit(TransformPriority::NORMAL, record("normal"));
+    executor.trySubmit(TransformPriority::HIGH, record("high"));
+
+    // Act
+    release.set_value();
+    executor.shutdown();
+
+    // Assert
+    ASSERT_EQ(3u, order.size());
+    EXPECT_EQ("high", order[0]);
+    EXPECT_EQ("normal", order[1]);
+    EXPECT_EQ("low", order[2]);
+}
+
+TEST_F(TransformExecutorTest, Shutdown_WithQueuedTasks_DrainsThenRejects) {
+    // Arrange
+    TransformExecutor executor(2, 16);
+    std::atomic<int> completed{0};
+    for (int i = 0; i < 10; ++i) {
+        executor.trySubmit(TransformPriority::NORMAL, [&completed]() { completed++; });
+    }
+
+    // Act
+    executor.shutdown();
+
+    // Assert
+    EXPECT_EQ(10, completed.load())
+        << "Queued tasks should finish before shutdown returns";
+    EXPECT_FALSE(executor.trySubmit(TransformPriority::NORMAL, []() {}));
+}
+
+TEST_F(TransformExecutorTest, HasSpareCapacity_TracksBusyWorkersAndQueue) {
+    // Arrange
+    TransformExecutor executor(1, 4);
+    EXPECT_TRUE(executor.hasSpareCapacity());
+
+    // Act & Assert - the only worker is busy
+    auto release = blockWorker(executor);
+    EXPECT_FALSE(executor.hasSpareCapacity());
+
+    release.set_value();
+    executor.shutdown();
+    EXPECT_TRUE(executor.hasSpareCapacity())
+        << "A finished task should give its worker back";
+}
+
+// ============================================================================
+// Classification Tests
+// ============================================================================
+
+TEST_F(TransformExecutorTest, Classify_BySize_PicksLane) {
+    const long long small = 512LL * 512LL;
+    const long long large = 2048LL * 2048LL;
+
+    EXPECT_EQ(TransformPriority::HIGH, TransformExecutor::classify(200, 0, small, large));
+    EXPECT_EQ(TransformPriority::NORMAL, TransformExecutor::classify(1024, 768, small, large));
+    EXPECT_EQ(TransformPriority::LOW, TransformExecutor::classify(4000, 3000, small, large));
+    EXPECT_EQ(TransformPriority::LOW, TransformExecutor::classify(0, 0, small, large))
+        << "Original-size renditions should use the low priority lane";
+}
@@ -0,0 +1,202 @@
+#include <gtest/gtest.h>
+#include "services/transform_index.h"
+#include "services/cache_manager.h"
+#include "utils/logger.h"
+#include "utils/metrics.h"
+#include "mocks/fake_file_service.h"
+#include "mocks/fake_database_client.h"
+#include "test_helpers/test_constants.h"
+#include "test_helpers/test_builders.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace gara;
+using namespace gara::testing;
+using namespace gara::test_constants;
+using namespace gara::test_builders;
+
+class TransformIndexTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        gara::Logger::initialize("gara-test", "error", gara::Logger::Format::TEXT, "test");
+        gara::Metrics::initialize("GaraTest", "gara-test", "test", false);
+
+        fake_file_service_ = std::make_shared<FakeFileService>(TEST_BUCKET_NAME);
+        fake_db_client_ = std::make_shared<FakeDatabaseClient>();
+
+        // Passes are run explicitly, not by the background thread
+        config_.eviction_interval_seconds = 0;
+    }
+
+    void TearDown() override {
+        fake_file_service_->clear();
+        fake_db_client_->clear();
+    }
+
+    // Store an object and record it with the given last access time
+    void storeRendition(const std::string& key, const std::string& image_id, uint64_t size,
+                        std::time_t last_accessed, int64_t hits = 0) {
+        fake_file_service_->uploadData(TestDataBuilder::createData(SMALL_DATA_SIZE), key);
+        fake_db_client_->putRendition({key, image_id, size, last_accessed, hits});
+    }
+
+    std::shared_ptr<FakeFileService> fake_file_service_;
+    std::shared_ptr<FakeDatabaseClient> fake_db_client_;
+    CacheConfig config_;
+};
+
+// ============================================================================
+// Recording Tests
+// ============================================================================
+
+TEST_F(TransformIndexTest, RecordStored_WritesRowWithSize) {
+    // Arrange
+    TransformIndex index(fake_db_client_, fake_file_service_, config_);
+
+    // Act
+    index.recordStored("transformed/a_100x100.jpeg", "a", 1234);
+
+    // Assert
+    auto record = fake_db_client_->getRendition("transformed/a_100x100.jpeg");
+    ASSERT_TRUE(record.has_value());
+    EXPECT_EQ("a", record->image_id);
+    EXPECT_EQ(1234u, record->size_bytes);
+    EXPECT_GT(record->last_accessed, 0);
+}
+
+TEST_F(TransformIndexTest, RecordAccess_WrittenOnFlush) {
+    // Arrange
+    TransformIndex index(fake_db_client_, fake_file_service_, config_);
+    storeRendition("transformed/a_100x100.jpeg", "a", 100, 1);
+
+    // Act
+    index.recordAccess("transformed/a_100x100.jpeg");
+    index.recordAccess("transformed/a_100x100.jpeg");
+    auto before_flush = fake_db_client_->getRendition("transformed/a_100x100.jpeg");
+    index.flushAccesses();
+
+    // Assert
+    EXPECT_EQ(0, before_flush->hits) << "Accesses should be buffered until a flush";
+    auto record = fake_db_client_->getRendition("transformed/a_100x100.jpeg");
+    EXPECT_EQ(1, record->hits) << "Repeated accesses between flushes count once";
+    EXPECT_GT(record->last_accessed, 1);
+}
+
+// ============================================================================
+// Invalidation Tests
+// ============================================================================
+
+TEST_F(TransformIndexTest, InvalidateImage_RemovesOnlyThatImagesRenditions) {
+    // Arrange
+    TransformIndex index(fake_db_client_, fake_file_service_, config_);
+    storeRendition("transformed/a_100x100.jpeg", "a", 100, 1);
+    storeRendition("transformed/a_200x200.webp", "a", 100, 1);
+    storeRendition("transformed/b_100x100.jpeg", "b", 100, 1);
+
+    // Act
+    auto removed = index.invalidateImage("a");
+
+    // Assert
+    EXPECT_EQ(2u, removed.size());
+    EXPECT_FALSE(fake_file_service_->objectExists("transformed/a_100x100.jpeg"));
+    EXPECT_FALSE(fake_file_service_->objectExists("transformed/a_200x200.webp"));
+    EXPECT_TRUE(fake_file_service_->objectExists("transformed/b_100x100.jpeg"));
+    EXPECT_EQ(1u, fake_db_client_->getRenditionCount());
+}
+
+// ============================================================================
+// Eviction Tests
+// ============================================================================
+
+TEST_F(TransformIndexTest, Evict_UnderBudget_RemovesNothing) {
+    // Arrange
+    config_.storage_max_bytes = 1000;
+    TransformIndex index(fake_db_client_, fake_file_service_, config_);
+    storeRendition("transformed/a_100x100.jpeg", "a", 500, 1);
+
+    // Act
+    uint64_t freed = index.evict();
+
+    // Assert
+    EXPECT_EQ(0u, freed);
+    EXPECT_EQ(1u, fake_db_client_->getRenditionCount());
+}
+
+TEST_F(TransformIndexTest, Evict_OverBudgetLru_RemovesLeastRecentlyUsedFirst) {
+    // Arrange - 1200 bytes against a 1000 byte budget (target 900)
+    config_.storage_max_bytes = 1000;
+    std::vector<std::string> evicted;
+    TransformIndex index(fake_db_client_, fake_file_service_, config_,
+                         [&evicted](const std::string& key) { evicted.push_back(key); });
+    storeRendition("transformed/old.jpeg", "a", 400, 10);
+    storeRendition("transformed/mid.jpeg", "b", 400, 20);
+    storeRendition("transformed/new.jpeg", "c", 400, 30);
+
+    // Act
+    uint64_t freed = index.evict();
+
+    // Assert
+    EXPECT_EQ(400u, freed);
+    ASSERT_EQ(1u, evicted.size());
+    EXPECT_EQ("transformed/old.jpeg", evicted[0]);
+    EXPECT_FALSE(fake_file_service_->objectExists("transformed/old.jpeg"));
+    EXPECT_TRUE(fake_file_service_->objectExists("transformed/new.jpeg"));
+    EXPECT_EQ(800u, fake_db_client_->getRenditionBytes());
+}
+
+TEST_F(TransformIndexTest, Evict_OverBudgetLfu_RemovesLeastFrequentlyUsedFirst) {
+    // Arrange
+    config_.storage_max_bytes = 1000;
+    config_.eviction_policy = "lfu";
+    TransformIndex index(fake_db_client_, fake_file_service_, config_);
+    storeRendition("transformed/old_popular.jpeg", "a", 400, 10, 50);
+    storeRendition("transformed/new_rare.jpeg", "b", 400, 30, 1);
+    storeRendition("transformed/mid_popular.jpeg", "c", 400, 20, 20);
+
+    // Act
+    index.evict();
+
+    // Assert
+    EXPECT_FALSE(fake_file_service_->objectExists("transformed/new_rare.jpeg"));
+    EXPECT_TRUE(fake_file_service_->objectExists("transformed/old_popular.jpeg"));
+}
+
+// ============================================================================
+// CacheManager Integration Tests
+// ============================================================================
+
+TEST_F(TransformIndexTest, CacheManager_ClearImageCache_DeletesStoredRenditions) {
+    // Arrange
+    CacheManager cache_manager(fake_file_service_, config_, fake_db_client_);
+    auto small = TransformRequestBuilder().withImageId(TEST_IMAGE_ID).withDimensions(100, 100).build();
+    auto large = TransformRequestBuilder().withImageId(TEST_IMAGE_ID).withDimensions(800, 600).build();
+    cache_manager.storeInCache(small, TestDataBuilder::createData(SMALL_DATA_SIZE));
+    cache_manager.storeInCache(large, TestDataBuilder::createData(SMALL_DATA_SIZE));
+
+    // Act
+    bool cleared = cache_manager.clearImageCache(TEST_IMAGE_ID);
+
+    // Assert
+    EXPECT_TRUE(cleared);
+    EXPECT_FALSE(fake_file_service_->objectExists(small.getCacheKey()));
+    EXPECT_FALSE(fake_file_service_->objectExists(large.getCacheKey()));
+    EXPECT_FALSE(cache_manager.existsInCache(small));
+    EXPECT_EQ(0u, fake_db_client_->getRenditionCount());
+}
+
+TEST_F(TransformIndexTest, CacheManager_EvictedRendition_LeavesMemoryTier) {
+    // Arrange
+    config_.storage_max_bytes = 1;
+    CacheManager cache_manager(fake_file_service_, config_, fake_db_client_);
+    auto request = TransformRequestBuilder::defaultJpeg();
+    cache_manager.storeInCache(request, TestDataBuilder::createData(SMALL_DATA_SIZE));
+
+    // Act
+    cache_manager.transformIndex()->evict();
+
+    // Assert
+    EXPECT_EQ(nullptr, cache_manager.getCachedData(request));
+    EXPECT_FALSE(cache_manager.existsInCache(request))
+        << "Evicted renditions should be regenerated, not served from memory";
+}
@@ -0,0 +1,151 @@
+#include <gtest/gtest.h>
+#include "services/warmup_service.h"
+#include "services/album_cache.h"
+#include "services/album_service.h"
+#include "services/cache_manager.h"
+#include "services/raw_key_resolver.h"
+#include "mocks/fake_file_service.h"
+#include "mocks/fake_database_client.h"
+#include "test_helpers/test_builders.h"
+#include "test_helpers/test_constants.h"
+#include "test_helpers/test_file_manager.h"
+#include "utils/logger.h"
+#include "utils/metrics.h"
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <thread>
+
+using namespace gara;
+using namespace gara::testing;
+using namespace gara::test_builders;
+using namespace gara::test_constants;
+using namespace gara::test_helpers;
+
+class WarmupServiceTest : public ::testing::Test {
+protected:
+    // One instance's worth of caches over shared storage and database
+    struct Instance {
+        std::shared_ptr<CacheManager> cache_manager;
+        std::shared_ptr<RawKeyResolver> raw_key_resolver;
+        std::shared_ptr<AlbumCache> album_cache;
+        std::shared_ptr<AlbumService> album_service;
+        std::unique_ptr<WarmupService> warmup;
+    };
+
+    void SetUp() override {
+        gara::Logger::initialize("gara-test", "error", gara::Logger::Format::TEXT, "test");
+        gara::Metrics::initialize("GaraTest", "gara-test", "test", false);
+
+        fake_file_service_ = std::make_shared<FakeFileService>(TEST_BUCKET_NAME);
+        fake_db_client_ = std::make_shared<FakeDatabaseClient>();
+        config_.snapshot_path = TestFileManager::createUniquePath("hot_set_", ".json");
+    }
+
+    void TearDown() override {
+        std::error_code ec;
+        std::filesystem::remove(config_.snapshot_path, ec);
+    }
+
+    Instance makeInstance() {
+        Instance instance;
+        instance.cache_manager = std::make_shared<CacheManager>(fake_file_service_);
+        instance.raw_key_resolver = std::make_shared<RawKeyResolver>(fake_db_client_, fake_file_service_);
+        instance.album_cache = std::make_shared<AlbumCache>(AlbumCacheConfig());
+        instance.album_service = std::make_shared<AlbumService>(
+            fake_db_client_, fake_file_service_, instance.raw_key_resolver, instance.album_cache);
+        instance.warmup = std::make_unique<WarmupService>(config_, instance.cache_manager,
+            instance.raw_key_resolver, instance.album_service, instance.album_cache);
+        return instance;
+    }
+
+    static bool waitUntilReady(const WarmupService& warmup) {
+        for (int i = 0; i < 200 && !warmup.ready(); ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        return warmup.ready();
+    }
+
+    std::shared_ptr<FakeFileService> fake_file_service_;
+    std::shared_ptr<FakeDatabaseClient> fake_db_client_;
+    WarmupConfig config_;
+};
+
+// ============================================================================
+// Snapshot Round-Trip Tests
+// ============================================================================
+
+TEST_F(WarmupServiceTest, WriteThenWarm_PreloadsHotSetIntoFreshInstance) {
+    // Arrange: a running instance with one hot rendition, raw key and album
+    TransformRequest hot("img1", "webp", 320, 0);
+    TransformRequest gone("img2", "webp", 320, 0);
+    fake_file_service_->uploadData(TestDataBuilder::createData(SMALL_DATA_SIZE), hot.getCacheKey());
+    fake_file_service_->uploadData(TestDataBuilder::createData(SMALL_DATA_SIZE), gone.getCacheKey());
+
+    Instance running = makeInstance();
+    running.cache_manager->getCachedImage(hot);
+    running.cache_manager->getCachedImage(gone);
+    running.raw_key_resolver->remember("img1", "raw/img1.jpg");
+    Album album = running.album_service->createAlbum(CreateAlbumRequestBuilder().withName("Hot").build());
+    running.album_service->getAlbum(album.album_id);
+    ASSERT_TRUE(running.warmup->writeSnapshot());
+
+    // A rendition deleted since the snapshot must not come back as present
+    fake_file_service_->deleteObject(gone.getCacheKey());
+
+    // Act
+    Instance fresh = makeInstance();
+    size_t warmed = fresh.warmup->warm();
+
+    // Assert
+    EXPECT_EQ(3u, warmed);
+    auto keys = fresh.cache_manager->hotKeys(10);
+    ASSERT_EQ(1u, keys.size());
+    EXPECT_EQ(hot.getCacheKey(), keys[0]);
+    auto mappings = fresh.raw_key_resolver->hotMappings(10);
+    ASSERT_EQ(1u, mappings.size());
+    EXPECT_EQ("raw/img1.jpg", mappings[0].second);
+    EXPECT_EQ(std::vector<std::string>{album.album_id}, fresh.album_cache->albumIds(10));
+    EXPECT_NE(nullptr, fresh.album_cache->getListing(false));
+}
+
+TEST_F(WarmupServiceTest, Warm_UnreadableSnapshot_StartsCold) {
+    // Arrange
+    std::ofstream(config_.snapshot_path) << "{\"renditions\": [";
+    Instance instance = makeInstance();
+
+    // Act & Assert
+    EXPECT_EQ(0u, instance.warmup->warm());
+}
+
+// ============================================================================
+// Readiness Tests
+// ============================================================================
+
+TEST_F(WarmupServiceTest, Start_WithoutSnapshotPath_ReadyAtOnce) {
+    // Arrange
+    config_.snapshot_path.clear();
+    Instance instance = makeInstance();
+    EXPECT_FALSE(instance.warmup->ready());
+
+    // Act
+    instance.warmup->start();
+
+    // Assert
+    EXPECT_TRUE(instance.warmup->ready());
+}
+
+TEST_F(WarmupServiceTest, Start_NoSnapshotYet_BecomesReadyAndWritesOneOnShutdown) {
+    // Arrange
+    Instance instance = makeInstance();
+
+    // Act
+    instance.warmup->start();
+    bool ready = waitUntilReady(*instance.warmup);
+    instance.warmup.reset();
+
+    // Assert
+    EXPECT_TRUE(ready);
+    EXPECT_TRUE(std::filesystem::exists(config_.snapshot_path));
+}
@@ -188,6 +188,33 @@ TEST_F(WatermarkServiceTest, WorksWithDifferentImageSizes) {
     }
 }
 
+// Test: Overlay is rendered once per font size and reused
+TEST_F(WatermarkServiceTest, ReusesOverlayForSameFontSize) {
+    vips::VImage original = vips::VImage::new_from_file(test_image_path_.c_str());
+
+    service_->applyWatermark(original);
+    service_->applyWatermark(original);
+
+    EXPECT_EQ(service_->cachedOverlayCount(), 1u);
+}
+
+// Test: Widths that map to different font sizes get their own overlay
+TEST_F(WatermarkServiceTest, CachesOverlayPerFontSize) {
+    std::string wide_path = TestFileManager::createUniquePath("wide_test_", ".ppm");
+    createTestImage(wide_path, 2000, 600);
+    temp_files_.push_back(wide_path);
+
+    vips::VImage original = vips::VImage::new_from_file(test_image_path_.c_str());
+    vips::VImage wide = vips::VImage::new_from_file(wide_path.c_str());
+
+    vips::VImage watermarked = service_->applyWatermark(original);
+    vips::VImage wide_watermarked = service_->applyWatermark(wide);
+
+    EXPECT_EQ(service_->cachedOverlayCount(), 2u);
+    EXPECT_EQ(wide_watermarked.width(), 2000);
+    EXPECT_EQ(watermarked.bands(), original.bands());
+}
+
 // Test: Graceful error handling
 TEST_F(WatermarkServiceTest, HandlesErrorsGracefully) {
     // Even with invalid image, service should not crash
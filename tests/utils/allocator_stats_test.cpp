@@ -0,0 +1,45 @@
+#include <gtest/gtest.h>
+#include <cstring>
+#include <vector>
+#include "utils/allocator_stats.h"
+
+using namespace gara::utils;
+
+class AllocatorStatsTest : public ::testing::Test {};
+
+// ============================================================================
+// Allocator Introspection Tests
+// ============================================================================
+
+TEST_F(AllocatorStatsTest, AllocatorName_IsKnown) {
+    std::string name = AllocatorStats::allocatorName();
+    EXPECT_TRUE(name == "system" || name == "jemalloc" || name == "mimalloc") << name;
+}
+
+TEST_F(AllocatorStatsTest, ResidentBytes_ReportsProcessMemory) {
+    EXPECT_GT(AllocatorStats::residentBytes(), 0u);
+}
+
+TEST_F(AllocatorStatsTest, Sample_NamesEveryCounter) {
+    for (const auto& [name, value] : AllocatorStats::sample()) {
+        EXPECT_FALSE(name.empty());
+        (void)value;
+    }
+}
+
+TEST_F(AllocatorStatsTest, ThreadAllocatedBytes_CountsOnlyWhenEnabled) {
+    // Arrange
+    uint64_t before = AllocatorStats::threadAllocatedBytes();
+
+    // Act
+    auto buffer = std::make_unique<std::vector<char>>(1 << 16);
+    std::memset(buffer->data(), 1, buffer->size());
+    uint64_t after = AllocatorStats::threadAllocatedBytes();
+
+    // Assert
+    if (AllocatorStats::threadCountersEnabled()) {
+        EXPECT_GE(after - before, buffer->size());
+    } else {
+        EXPECT_EQ(0u, after);
+    }
+}
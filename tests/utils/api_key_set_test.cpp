@@ -0,0 +1,66 @@
+#include <gtest/gtest.h>
+#include "utils/api_key_set.h"
+
+using namespace gara::utils;
+
+class ApiKeySetTest : public ::testing::Test {};
+
+// ============================================================================
+// Match Tests
+// ============================================================================
+
+TEST_F(ApiKeySetTest, Matches_AnyActiveKey_Accepted) {
+    ApiKeySet keys({"new-key", "old-key"});
+
+    EXPECT_TRUE(keys.matches("new-key"));
+    EXPECT_TRUE(keys.matches("old-key"));
+    EXPECT_EQ(keys.size(), 2u);
+    EXPECT_EQ(keys.primary(), "new-key");
+}
+
+TEST_F(ApiKeySetTest, Matches_UnknownOrPrefixKey_Rejected) {
+    ApiKeySet keys({"secret-key"});
+
+    EXPECT_FALSE(keys.matches("secret"));
+    EXPECT_FALSE(keys.matches("secret-key "));
+    EXPECT_FALSE(keys.matches("SECRET-KEY"));
+    EXPECT_FALSE(keys.matches(""));
+}
+
+TEST_F(ApiKeySetTest, Matches_EmptySet_RejectsEverything) {
+    ApiKeySet keys;
+
+    EXPECT_TRUE(keys.empty());
+    EXPECT_FALSE(keys.matches(""));
+    EXPECT_FALSE(keys.matches("anything"));
+}
+
+TEST_F(ApiKeySetTest, Constructor_DuplicateAndEmptyKeys_Collapsed) {
+    ApiKeySet keys({"", "a", "a", "b"});
+
+    EXPECT_EQ(keys.size(), 2u);
+    EXPECT_EQ(keys.primary(), "a");
+}
+
+TEST_F(ApiKeySetTest, SameKeys_OrderIndependent) {
+    EXPECT_TRUE(ApiKeySet({"a", "b"}).sameKeys(ApiKeySet({"b", "a"})));
+    EXPECT_FALSE(ApiKeySet({"a"}).sameKeys(ApiKeySet({"a", "b"})));
+}
+
+// ============================================================================
+// Parse Tests
+// ============================================================================
+
+TEST_F(ApiKeySetTest, Parse_CommasNewlinesAndComments) {
+    auto keys = ApiKeySet::parse(" new-key , old-key\n# retired 2026-01\nfile-key\r\n\n");
+
+    ASSERT_EQ(keys.size(), 3u);
+    EXPECT_EQ(keys[0], "new-key");
+    EXPECT_EQ(keys[1], "old-key");
+    EXPECT_EQ(keys[2], "file-key");
+}
+
+TEST_F(ApiKeySetTest, Parse_Empty_ReturnsNothing) {
+    EXPECT_TRUE(ApiKeySet::parse("").empty());
+    EXPECT_TRUE(ApiKeySet::parse(" ,\n").empty());
+}
@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+#include "utils/blurhash.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace gara::utils;
+
+class BlurHashTest : public ::testing::Test {
+protected:
+    static std::vector<uint8_t> solid(int width, int height, uint8_t value) {
+        return std::vector<uint8_t>(static_cast<size_t>(width) * height * 3, value);
+    }
+
+    // AC components with no energy quantise to the neutral value
+    static std::string neutralAc(int count) {
+        std::string ac;
+        for (int i = 0; i < count; ++i) {
+            ac += "fQ";
+        }
+        return ac;
+    }
+};
+
+// ============================================================================
+// Encoding Tests
+// ============================================================================
+
+TEST_F(BlurHashTest, Encode_SolidWhite_EncodesSizeFlagAndColour) {
+    // Arrange
+    auto pixels = solid(8, 6, 255);
+
+    // Act
+    std::string hash = BlurHash::encode(pixels.data(), 8, 6, 4, 3);
+
+    // Assert - size flag 'L' (4x3), then after the AC maximum, DC 0xFFFFFF
+    ASSERT_EQ(28u, hash.size());
+    EXPECT_EQ('L', hash[0]);
+    EXPECT_EQ("TSUA", hash.substr(2, 4));
+}
+
+TEST_F(BlurHashTest, Encode_SolidBlack_EncodesZeroColour) {
+    auto pixels = solid(5, 5, 0);
+
+    EXPECT_EQ("L00000" + neutralAc(11), BlurHash::encode(pixels.data(), 5, 5, 4, 3));
+}
+
+TEST_F(BlurHashTest, Encode_SingleComponent_IsSixCharacters) {
+    auto pixels = solid(4, 4, 255);
+
+    EXPECT_EQ("00TSUA", BlurHash::encode(pixels.data(), 4, 4, 1, 1));
+}
+
+TEST_F(BlurHashTest, Encode_HorizontalEdge_CarriesHorizontalDetail) {
+    // Arrange - white left half, black right half
+    const int width = 8;
+    const int height = 4;
+    std::vector<uint8_t> pixels(width * height * 3, 0);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width / 2; ++x) {
+            for (int c = 0; c < 3; ++c) {
+                pixels[(y * width + x) * 3 + c] = 255;
+            }
+        }
+    }
+
+    // Act
+    std::string hash = BlurHash::encode(pixels.data(), width, height, 4, 3);
+
+    // Assert
+    auto white = solid(width, height, 255);
+    ASSERT_EQ(28u, hash.size());
+    EXPECT_NE(BlurHash::encode(white.data(), width, height, 4, 3).substr(6), hash.substr(6));
+    EXPECT_EQ(hash, BlurHash::encode(pixels.data(), width, height, 4, 3));
+}
+
+TEST_F(BlurHashTest, Encode_InvalidInput_ReturnsEmpty) {
+    auto pixels = solid(2, 2, 128);
+
+    EXPECT_EQ("", BlurHash::encode(pixels.data(), 2, 2, 0, 3));
+    EXPECT_EQ("", BlurHash::encode(pixels.data(), 2, 2, 4, BlurHash::MAX_COMPONENTS + 1));
+    EXPECT_EQ("", BlurHash::encode(nullptr, 2, 2, 4, 3));
+    EXPECT_EQ("", BlurHash::encode(pixels.data(), 0, 2, 4, 3));
+}
@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+#include "utils/consistent_hash.h"
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace gara::utils;
+
+class ConsistentHashRingTest : public ::testing::Test {
+protected:
+    static std::vector<std::string> nodes(int count) {
+        std::vector<std::string> members;
+        for (int i = 0; i < count; ++i) {
+            members.push_back("http://10.0.0." + std::to_string(i + 1) + ":8080");
+        }
+        return members;
+    }
+
+    static std::string key(int i) {
+        return "transformed/image" + std::to_string(i) + "_webp_320x0.webp";
+    }
+
+    static constexpr int KEY_COUNT = 10000;
+};
+
+// ============================================================================
+// Ownership Tests
+// ============================================================================
+
+TEST_F(ConsistentHashRingTest, OwnerOf_EmptyRing_ReturnsEmpty) {
+    ConsistentHashRing ring;
+
+    EXPECT_EQ("", ring.ownerOf("anything"));
+}
+
+TEST_F(ConsistentHashRingTest, OwnerOf_SameMembersInAnyOrder_AgreeOnEveryKey) {
+    // Arrange - two nodes that list their peers differently
+    ConsistentHashRing first;
+    first.setMembers(nodes(5));
+    std::vector<std::string> shuffled = nodes(5);
+    std::reverse(shuffled.begin(), shuffled.end());
+    shuffled.push_back(shuffled.front());
+    ConsistentHashRing second;
+    second.setMembers(shuffled);
+
+    // Act & Assert
+    for (int i = 0; i < 1000; ++i) {
+        EXPECT_EQ(first.ownerOf(key(i)), second.ownerOf(key(i)));
+    }
+    EXPECT_EQ(5u, second.members().size());
+}
+
+TEST_F(ConsistentHashRingTest, OwnerOf_ManyKeys_SpreadAcrossMembers) {
+    // Arrange
+    ConsistentHashRing ring;
+    ring.setMembers(nodes(12));
+
+    // Act
+    std::map<std::string, int> counts;
+    for (int i = 0; i < KEY_COUNT; ++i) {
+        ++counts[ring.ownerOf(key(i))];
+    }
+
+    // Assert - every member within half and one and a half times its fair share
+    ASSERT_EQ(12u, counts.size());
+    for (const auto& [member, count] : counts) {
+        EXPECT_GT(count, KEY_COUNT / 12 / 2) << member;
+        EXPECT_LT(count, KEY_COUNT / 12 * 3 / 2) << member;
+    }
+}
+
+TEST_F(ConsistentHashRingTest, SetMembers_RemovingOneMember_MovesOnlyItsKeys) {
+    // Arrange
+    ConsistentHashRing before;
+    before.setMembers(nodes(12));
+    std::vector<std::string> remaining = nodes(12);
+    std::string removed = remaining[3];
+    remaining.erase(remaining.begin() + 3);
+    ConsistentHashRing after;
+    after.setMembers(remaining);
+
+    // Act & Assert
+    for (int i = 0; i < KEY_COUNT; ++i) {
+        if (before.ownerOf(key(i)) != removed) {
+            EXPECT_EQ(before.ownerOf(key(i)), after.ownerOf(key(i)));
+        } else {
+            EXPECT_NE(removed, after.ownerOf(key(i)));
+        }
+    }
+}
+
+TEST_F(ConsistentHashRingTest, Hash_KnownInput_IsStable) {
+    // Nodes of different builds must agree, so the hash is pinned
+    EXPECT_EQ(0xefd01f60ba992926ULL, ConsistentHashRing::hash(""));
+    EXPECT_EQ(0x153b9408744e4d22ULL, ConsistentHashRing::hash("transformed/a_webp_320x0.webp"));
+    EXPECT_NE(ConsistentHashRing::hash("node#1"), ConsistentHashRing::hash("node#2"));
+}
@@ -0,0 +1,145 @@
+#include <gtest/gtest.h>
+#include "utils/container_limits.h"
+#include "models/governor_config.h"
+#include "test_helpers/test_file_manager.h"
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+using namespace gara;
+using namespace gara::utils;
+using namespace gara::test_helpers;
+
+class ContainerLimitsTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        root_ = TestFileManager::createUniqueDirPath("cgroup_test_");
+        std::filesystem::create_directories(root_);
+        self_cgroup_ = root_ + "/self_cgroup";
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(root_);
+    }
+
+    // Write content to a file under the fake cgroup mount
+    void writeFile(const std::string& relative_path, const std::string& content) {
+        std::filesystem::path path = std::filesystem::path(root_) / "mount" / relative_path;
+        std::filesystem::create_directories(path.parent_path());
+        std::ofstream file(path);
+        file << content << "\n";
+    }
+
+    void writeSelfCgroup(const std::string& content) {
+        std::ofstream file(self_cgroup_);
+        file << content;
+    }
+
+    ContainerLimits detect(int host_cpus) {
+        return ContainerLimits::detect(root_ + "/mount", self_cgroup_, host_cpus);
+    }
+
+    std::string root_;
+    std::string self_cgroup_;
+};
+
+// ============================================================================
+// Parsing Tests
+// ============================================================================
+
+TEST_F(ContainerLimitsTest, Parse_LimitFiles_ConvertToCpusAndBytes) {
+    EXPECT_DOUBLE_EQ(2.0, ContainerLimits::parseCpuMax("200000 100000"));
+    EXPECT_DOUBLE_EQ(0.5, ContainerLimits::parseCpuMax("50000 100000"));
+    EXPECT_DOUBLE_EQ(0.0, ContainerLimits::parseCpuMax("max 100000"));
+    EXPECT_DOUBLE_EQ(0.0, ContainerLimits::parseCpuMax(""));
+
+    EXPECT_DOUBLE_EQ(1.5, ContainerLimits::parseCfsQuota("150000", "100000"));
+    EXPECT_DOUBLE_EQ(0.0, ContainerLimits::parseCfsQuota("-1", "100000"));
+
+    EXPECT_EQ(536870912u, ContainerLimits::parseMemoryLimit("536870912"));
+    EXPECT_EQ(0u, ContainerLimits::parseMemoryLimit("max"));
+    EXPECT_EQ(0u, ContainerLimits::parseMemoryLimit("9223372036854771712"))
+        << "cgroup v1's no-limit sentinel should read as unlimited";
+}
+
+TEST_F(ContainerLimitsTest, Cpus_Quota_RoundsDownWithinHostCpus) {
+    ContainerLimits limits;
+    limits.host_cpus = 64;
+
+    limits.cpu_quota = 0.0;
+    EXPECT_EQ(64, limits.cpus());
+    limits.cpu_quota = 2.5;
+    EXPECT_EQ(2, limits.cpus());
+    limits.cpu_quota = 0.25;
+    EXPECT_EQ(1, limits.cpus());
+
+    limits.host_cpus = 4;
+    limits.cpu_quota = 8.0;
+    EXPECT_EQ(4, limits.cpus());
+}
+
+// ============================================================================
+// Detection Tests
+// ============================================================================
+
+TEST_F(ContainerLimitsTest, Detect_CgroupV2_TakesTightestLimitOfTheChain) {
+    // Arrange - the parent caps memory, the leaf caps CPU
+    writeFile("cgroup.controllers", "cpu memory");
+    writeFile("cpu.max", "max 100000");
+    writeFile("memory.max", "max");
+    writeFile("kubepods/cpu.max", "max 100000");
+    writeFile("kubepods/memory.max", "1073741824");
+    writeFile("kubepods/pod1/cpu.max", "200000 100000");
+    writeFile("kubepods/pod1/memory.max", "max");
+    writeSelfCgroup("0::/kubepods/pod1\n");
+
+    // Act
+    ContainerLimits limits = detect(64);
+
+    // Assert
+    EXPECT_EQ("cgroup2", limits.source);
+    EXPECT_DOUBLE_EQ(2.0, limits.cpu_quota);
+    EXPECT_EQ(2, limits.cpus());
+    EXPECT_EQ(1073741824u, limits.memory_limit_bytes);
+}
+
+TEST_F(ContainerLimitsTest, Detect_CgroupV1Namespaced_ReadsControllerMounts) {
+    // Arrange
+    writeFile("cpu,cpuacct/cpu.cfs_quota_us", "300000");
+    writeFile("cpu,cpuacct/cpu.cfs_period_us", "100000");
+    writeFile("memory/memory.limit_in_bytes", "2147483648");
+    writeSelfCgroup("12:memory:/\n4:cpu,cpuacct:/\n0::/\n");
+
+    // Act
+    ContainerLimits limits = detect(16);
+
+    // Assert
+    EXPECT_EQ("cgroup1", limits.source);
+    EXPECT_EQ(3, limits.cpus());
+    EXPECT_EQ(2147483648u, limits.memory_limit_bytes);
+}
+
+TEST_F(ContainerLimitsTest, Detect_NoCgroupFilesystem_UsesHostCpus) {
+    ContainerLimits limits = detect(8);
+
+    EXPECT_EQ("host", limits.source);
+    EXPECT_EQ(8, limits.cpus());
+    EXPECT_EQ(0u, limits.memory_limit_bytes);
+}
+
+// ============================================================================
+// Derived Default Tests
+// ============================================================================
+
+TEST_F(ContainerLimitsTest, GovernorDefaults_MemoryLimit_ScaleBudgetAndVipsCache) {
+    const uint64_t mb = 1024ULL * 1024;
+
+    EXPECT_EQ(1024 * mb, GovernorConfig::defaultMemoryBudget(0));
+    EXPECT_EQ(256 * mb, GovernorConfig::defaultMemoryBudget(512 * mb));
+    EXPECT_EQ(1024 * mb, GovernorConfig::defaultMemoryBudget(16384 * mb));
+
+    EXPECT_EQ(64, GovernorConfig::defaultVipsCacheMemMb(0));
+    EXPECT_EQ(16, GovernorConfig::defaultVipsCacheMemMb(256 * mb));
+    EXPECT_EQ(128, GovernorConfig::defaultVipsCacheMemMb(4096 * mb));
+    EXPECT_EQ(256, GovernorConfig::defaultVipsCacheMemMb(65536 * mb));
+}
@@ -0,0 +1,34 @@
+#include <gtest/gtest.h>
+#include "utils/etag.h"
+
+using namespace gara::utils;
+
+class ETagTest : public ::testing::Test {};
+
+// ============================================================================
+// Tag Construction Tests
+// ============================================================================
+
+TEST_F(ETagTest, FromStorageKey_TransformedKey_UsesFileStem) {
+    EXPECT_EQ("\"abc123_webp_320x0_wm\"", ETag::fromStorageKey("transformed/abc123_webp_320x0_wm.webp"));
+    EXPECT_EQ("\"abc123\"", ETag::fromStorageKey("raw/abc123.jpg"));
+}
+
+TEST_F(ETagTest, FromStorageKey_NoDirectoryOrExtension_UsesWholeName) {
+    EXPECT_EQ("\"abc123\"", ETag::fromStorageKey("abc123"));
+}
+
+// ============================================================================
+// Matching Tests
+// ============================================================================
+
+TEST_F(ETagTest, Matches_ListWithWeakAndStar_Matches) {
+    EXPECT_TRUE(ETag::matches("\"x\", \"abc\"", "\"abc\""));
+    EXPECT_TRUE(ETag::matches("W/\"abc\"", "\"abc\""));
+    EXPECT_TRUE(ETag::matches("*", "\"abc\""));
+}
+
+TEST_F(ETagTest, Matches_DifferentTag_DoesNotMatch) {
+    EXPECT_FALSE(ETag::matches("\"abcd\"", "\"abc\""));
+    EXPECT_FALSE(ETag::matches("", "\"abc\""));
+}
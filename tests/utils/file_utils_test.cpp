@@ -126,6 +126,49 @@ TEST_F(FileUtilsTest, CalculateSHA256_NonExistentFile_ReturnsEmptyString) {
         << "Calculating hash of non-existent file should return empty string";
 }
 
+TEST_F(FileUtilsTest, Sha256Hasher_ChunkedUpdates_MatchesOneShotHash) {
+    // Arrange
+    auto data = TestDataBuilder::createBinaryData(MEDIUM_DATA_SIZE);
+    Sha256Hasher hasher;
+
+    // Act - feed in uneven chunks
+    const size_t chunk = 100;
+    for (size_t offset = 0; offset < data.size(); offset += chunk) {
+        hasher.update(data.data() + offset, std::min(chunk, data.size() - offset));
+    }
+    std::string chunked = hasher.finalizeHex();
+
+    // Assert
+    EXPECT_EQ(FileUtils::calculateSHA256(data), chunked)
+        << "Incremental hashing should match hashing the whole buffer";
+}
+
+// ============================================================================
+// Image Header Detection Tests
+// ============================================================================
+
+TEST_F(FileUtilsTest, DetectImageFormat_KnownSignatures_ReturnsFormat) {
+    const char jpeg[] = {'\xFF', '\xD8', '\xFF', '\xE0'};
+    const char png[] = {'\x89', 'P', 'N', 'G', '\r', '\n', '\x1a', '\n'};
+    const std::string gif = "GIF89a";
+    const std::string webp("RIFF\x10\x00\x00\x00WEBPVP8 ", 16);
+
+    EXPECT_EQ("jpg", FileUtils::detectImageFormat(jpeg, sizeof(jpeg)));
+    EXPECT_EQ("png", FileUtils::detectImageFormat(png, sizeof(png)));
+    EXPECT_EQ("gif", FileUtils::detectImageFormat(gif.data(), gif.size()));
+    EXPECT_EQ("webp", FileUtils::detectImageFormat(webp.data(), webp.size()));
+}
+
+TEST_F(FileUtilsTest, DetectImageFormat_TextData_ReturnsEmptyString) {
+    // Act
+    std::string format = FileUtils::detectImageFormat(
+        TEST_INVALID_IMAGE_CONTENT.data(), TEST_INVALID_IMAGE_CONTENT.size());
+
+    // Assert
+    EXPECT_TRUE(format.empty())
+        << "Non-image data should not be recognised";
+}
+
 // ============================================================================
 // File Extension Tests
 // ============================================================================
@@ -237,6 +280,7 @@ INSTANTIATE_TEST_SUITE_P(
         MimeTypeTestCase{FORMAT_PNG, MIME_PNG},
         MimeTypeTestCase{FORMAT_GIF, MIME_GIF},
         MimeTypeTestCase{FORMAT_WEBP, MIME_WEBP},
+        MimeTypeTestCase{"avif", "image/avif"},
         MimeTypeTestCase{"unknown", MIME_DEFAULT}
     )
 );
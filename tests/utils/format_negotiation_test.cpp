@@ -0,0 +1,31 @@
+#include <gtest/gtest.h>
+#include "utils/format_negotiation.h"
+
+using namespace gara::utils;
+
+class FormatNegotiationTest : public ::testing::Test {};
+
+// ============================================================================
+// Negotiation Tests
+// ============================================================================
+
+TEST_F(FormatNegotiationTest, Negotiate_ModernBrowser_PrefersAvif) {
+    EXPECT_EQ("avif", FormatNegotiation::negotiate("image/avif,image/webp,image/apng,image/*,*/*;q=0.8"));
+}
+
+TEST_F(FormatNegotiationTest, Negotiate_WebpOnly_ReturnsWebp) {
+    EXPECT_EQ("webp", FormatNegotiation::negotiate("image/webp,*/*"));
+}
+
+TEST_F(FormatNegotiationTest, Negotiate_WildcardsOnly_FallsBackToJpeg) {
+    EXPECT_EQ("jpeg", FormatNegotiation::negotiate("image/*,*/*;q=0.8"));
+    EXPECT_EQ("jpeg", FormatNegotiation::negotiate(""));
+}
+
+TEST_F(FormatNegotiationTest, Negotiate_ZeroQuality_TreatedAsRefused) {
+    EXPECT_EQ("webp", FormatNegotiation::negotiate("image/avif;q=0, image/webp;q=0.9"));
+}
+
+TEST_F(FormatNegotiationTest, Negotiate_MixedCaseAndSpacing_Recognized) {
+    EXPECT_EQ("avif", FormatNegotiation::negotiate(" Image/AVIF ; q=0.5"));
+}
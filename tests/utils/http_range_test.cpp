@@ -0,0 +1,83 @@
+#include <gtest/gtest.h>
+#include "utils/http_range.h"
+
+using namespace gara::utils;
+
+class HttpRangeTest : public ::testing::Test {
+protected:
+    static constexpr uint64_t OBJECT_SIZE = 1000;
+
+    ByteRange range_;
+};
+
+// ============================================================================
+// Satisfiable Range Tests
+// ============================================================================
+
+TEST_F(HttpRangeTest, Parse_ClosedRange_ResolvesInclusiveBounds) {
+    // Act
+    RangeStatus status = HttpRange::parse("bytes=0-99", OBJECT_SIZE, range_);
+
+    // Assert
+    ASSERT_EQ(RangeStatus::PARTIAL, status);
+    EXPECT_EQ(0u, range_.first);
+    EXPECT_EQ(99u, range_.last);
+    EXPECT_EQ(100u, range_.length());
+}
+
+TEST_F(HttpRangeTest, Parse_OpenEndedRange_RunsToEnd) {
+    // Act
+    RangeStatus status = HttpRange::parse("bytes=900-", OBJECT_SIZE, range_);
+
+    // Assert
+    ASSERT_EQ(RangeStatus::PARTIAL, status);
+    EXPECT_EQ(900u, range_.first);
+    EXPECT_EQ(999u, range_.last);
+}
+
+TEST_F(HttpRangeTest, Parse_SuffixRange_ReturnsFinalBytes) {
+    // Act
+    RangeStatus status = HttpRange::parse("bytes=-100", OBJECT_SIZE, range_);
+
+    // Assert
+    ASSERT_EQ(RangeStatus::PARTIAL, status);
+    EXPECT_EQ(900u, range_.first);
+    EXPECT_EQ(999u, range_.last);
+}
+
+TEST_F(HttpRangeTest, Parse_LastBeyondSize_ClampedToObject) {
+    // Act
+    RangeStatus status = HttpRange::parse("bytes=500-5000", OBJECT_SIZE, range_);
+
+    // Assert
+    ASSERT_EQ(RangeStatus::PARTIAL, status);
+    EXPECT_EQ(999u, range_.last);
+}
+
+// ============================================================================
+// Ignored And Unsatisfiable Range Tests
+// ============================================================================
+
+TEST_F(HttpRangeTest, Parse_FirstPastEnd_Unsatisfiable) {
+    EXPECT_EQ(RangeStatus::UNSATISFIABLE, HttpRange::parse("bytes=1000-", OBJECT_SIZE, range_));
+    EXPECT_EQ(RangeStatus::UNSATISFIABLE, HttpRange::parse("bytes=-0", OBJECT_SIZE, range_));
+}
+
+TEST_F(HttpRangeTest, Parse_MalformedOrMultiRange_ServedInFull) {
+    EXPECT_EQ(RangeStatus::FULL, HttpRange::parse("items=0-10", OBJECT_SIZE, range_));
+    EXPECT_EQ(RangeStatus::FULL, HttpRange::parse("bytes=0-10,20-30", OBJECT_SIZE, range_));
+    EXPECT_EQ(RangeStatus::FULL, HttpRange::parse("bytes=50-10", OBJECT_SIZE, range_));
+    EXPECT_EQ(RangeStatus::FULL, HttpRange::parse("bytes=+5-10", OBJECT_SIZE, range_));
+    EXPECT_EQ(RangeStatus::FULL, HttpRange::parse("bytes=abc", OBJECT_SIZE, range_));
+}
+
+// ============================================================================
+// Header Formatting Tests
+// ============================================================================
+
+TEST_F(HttpRangeTest, ContentRange_FormatsRangeAndSize) {
+    ByteRange range{0, 99};
+
+    EXPECT_EQ("bytes 0-99/1000", HttpRange::contentRange(range, OBJECT_SIZE));
+    EXPECT_EQ("bytes */1000", HttpRange::unsatisfiedRange(OBJECT_SIZE));
+}
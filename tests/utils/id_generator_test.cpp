@@ -200,3 +200,34 @@ TEST_F(IdGeneratorTest, GenerateAlbumIdReasonableLength) {
     EXPECT_GE(id.length(), 40);
     EXPECT_LE(id.length(), 60);
 }
+
+// Test IDs from one thread sort in creation order, even within a millisecond
+TEST_F(IdGeneratorTest, GenerateAlbumIdMonotonicWithinThread) {
+    std::string previous = IdGenerator::generateAlbumId();
+    for (int i = 0; i < 20000; ++i) {
+        std::string id = IdGenerator::generateAlbumId();
+        ASSERT_LT(previous, id) << "IDs minted back to back must keep increasing";
+        previous = id;
+    }
+}
+
+// Test the hex part starts with the millisecond timestamp matching the prefix
+TEST_F(IdGeneratorTest, GenerateAlbumIdEmbedsMilliseconds) {
+    std::string id = IdGenerator::generateAlbumId();
+
+    size_t underscore_pos = id.find('_');
+    unsigned long long seconds = std::stoull(id.substr(0, underscore_pos));
+    std::string hex = id.substr(underscore_pos + 1, 8) + id.substr(underscore_pos + 10, 4);
+    unsigned long long ms = std::stoull(hex, nullptr, 16);
+
+    EXPECT_EQ(seconds, ms / 1000);
+}
+
+// Test request IDs share the album ID format
+TEST_F(IdGeneratorTest, GenerateRequestIdHasCorrectFormat) {
+    std::string id = IdGenerator::generateRequestId();
+
+    std::regex pattern(R"(^\d+_[0-9a-f]{8}-[0-9a-f]{4}-4[0-9a-f]{3}-[89ab][0-9a-f]{3}-[0-9a-f]{12}$)");
+    EXPECT_TRUE(std::regex_match(id, pattern))
+        << "Request ID does not match expected format: " << id;
+}
@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+#include <condition_variable>
+#include <thread>
+#include "utils/instrumented_mutex.h"
+
+using namespace gara;
+using namespace gara::utils;
+
+class InstrumentedMutexTest : public ::testing::Test {
+protected:
+    static PrometheusRegistry::Counter& counter(const std::string& name, const std::string& lock) {
+        return PrometheusRegistry::instance().counter(name, "", {{"lock", lock}});
+    }
+
+    static PrometheusRegistry::Histogram& histogram(const std::string& name, const std::string& lock) {
+        return PrometheusRegistry::instance().histogram(name, "", {}, {{"lock", lock}});
+    }
+};
+
+// ============================================================================
+// Acquisition Tests
+// ============================================================================
+
+TEST_F(InstrumentedMutexTest, Lock_Uncontended_CountsAcquisitionsOnly) {
+    // Arrange
+    InstrumentedMutex mutex("test_uncontended");
+    auto& acquisitions = counter("gara_lock_acquisitions_total", "test_uncontended");
+    auto& contended = counter("gara_lock_contended_total", "test_uncontended");
+
+    // Act
+    for (unsigned i = 0; i < InstrumentedMutex::HOLD_SAMPLE_EVERY * 2; ++i) {
+        std::lock_guard<InstrumentedMutex> lock(mutex);
+    }
+
+    // Assert
+    EXPECT_DOUBLE_EQ(InstrumentedMutex::HOLD_SAMPLE_EVERY * 2, acquisitions.value());
+    EXPECT_DOUBLE_EQ(0.0, contended.value());
+    EXPECT_EQ(2u, histogram("gara_lock_hold_seconds", "test_uncontended").count())
+        << "Hold time is sampled once per HOLD_SAMPLE_EVERY acquisitions";
+}
+
+TEST_F(InstrumentedMutexTest, Lock_WhileHeld_RecordsWait) {
+    // Arrange
+    InstrumentedMutex mutex("test_contended");
+    std::unique_lock<InstrumentedMutex> held(mutex);
+    std::thread waiter([&mutex]() {
+        std::lock_guard<InstrumentedMutex> lock(mutex);
+    });
+
+    // Act
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    held.unlock();
+    waiter.join();
+
+    // Assert
+    EXPECT_DOUBLE_EQ(1.0, counter("gara_lock_contended_total", "test_contended").value());
+    auto& wait = histogram("gara_lock_wait_seconds", "test_contended");
+    EXPECT_EQ(1u, wait.count());
+    EXPECT_GT(wait.sum(), 0.01);
+}
+
+TEST_F(InstrumentedMutexTest, TryLock_WhileHeld_Fails) {
+    InstrumentedMutex mutex("test_try_lock");
+    std::lock_guard<InstrumentedMutex> held(mutex);
+    bool acquired = true;
+    std::thread([&]() { acquired = mutex.try_lock(); }).join();
+    EXPECT_FALSE(acquired);
+}
+
+TEST_F(InstrumentedMutexTest, SameName_SharesSeries) {
+    // Arrange
+    InstrumentedMutex first("test_shared");
+    InstrumentedMutex second("test_shared");
+
+    // Act
+    { std::lock_guard<InstrumentedMutex> lock(first); }
+    { std::lock_guard<InstrumentedMutex> lock(second); }
+
+    // Assert
+    EXPECT_DOUBLE_EQ(2.0, counter("gara_lock_acquisitions_total", "test_shared").value());
+}
+
+TEST_F(InstrumentedMutexTest, ConditionVariableAny_WaitsAndWakes) {
+    // Arrange
+    InstrumentedMutex mutex("test_condition");
+    std::condition_variable_any cv;
+    bool ready = false;
+
+    // Act
+    std::thread notifier([&]() {
+        std::lock_guard<InstrumentedMutex> lock(mutex);
+        ready = true;
+        cv.notify_one();
+    });
+    std::unique_lock<InstrumentedMutex> lock(mutex);
+    bool woke = cv.wait_for(lock, std::chrono::seconds(5), [&]() { return ready; });
+    lock.unlock();
+    notifier.join();
+
+    // Assert
+    EXPECT_TRUE(woke);
+}
@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+#include "utils/io_executor.h"
+#include <atomic>
+#include <future>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace gara::utils;
+
+class IoExecutorTest : public ::testing::Test {};
+
+// ============================================================================
+// Submission Tests
+// ============================================================================
+
+TEST_F(IoExecutorTest, Submit_ReturnsTaskResult) {
+    // Arrange
+    IoExecutor executor(2);
+
+    // Act
+    auto result = executor.submit([]() { return std::string("value"); });
+
+    // Assert
+    EXPECT_EQ("value", result.get());
+}
+
+TEST_F(IoExecutorTest, Submit_TaskThrows_ExceptionDeliveredThroughFuture) {
+    // Arrange
+    IoExecutor executor(1);
+
+    // Act
+    auto result = executor.submit([]() -> int { throw std::runtime_error("storage failure"); });
+
+    // Assert
+    EXPECT_THROW(result.get(), std::runtime_error);
+}
+
+TEST_F(IoExecutorTest, Submit_ManyTasks_RunInParallel) {
+    // Arrange - every task waits until all of them have started
+    constexpr int TASKS = 4;
+    IoExecutor executor(TASKS);
+    std::atomic<int> started{0};
+
+    // Act
+    std::vector<std::future<bool>> results;
+    for (int i = 0; i < TASKS; ++i) {
+        results.push_back(executor.submit([&started]() {
+            started.fetch_add(1);
+            for (int spins = 0; spins < 5000 && started.load() < TASKS; ++spins) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            return started.load() == TASKS;
+        }));
+    }
+
+    // Assert
+    for (auto& result : results) {
+        EXPECT_TRUE(result.get()) << "Tasks should overlap across pool threads";
+    }
+}
+
+// ============================================================================
+// Shutdown Tests
+// ============================================================================
+
+TEST_F(IoExecutorTest, Submit_AfterShutdown_RunsInline) {
+    // Arrange
+    IoExecutor executor(1);
+    executor.shutdown();
+
+    // Act
+    auto caller = std::this_thread::get_id();
+    auto result = executor.submit([]() { return std::this_thread::get_id(); });
+
+    // Assert
+    EXPECT_EQ(caller, result.get());
+}
+
+TEST_F(IoExecutorTest, Shutdown_FinishesQueuedTasks) {
+    // Arrange
+    IoExecutor executor(1);
+    std::atomic<int> completed{0};
+    for (int i = 0; i < 10; ++i) {
+        executor.submit([&completed]() { completed.fetch_add(1); });
+    }
+
+    // Act
+    executor.shutdown();
+
+    // Assert
+    EXPECT_EQ(10, completed.load());
+}
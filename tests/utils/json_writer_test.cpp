@@ -0,0 +1,124 @@
+#include <gtest/gtest.h>
+#include <limits>
+#include <nlohmann/json.hpp>
+#include "utils/json_writer.h"
+#include "models/album.h"
+#include "models/image_metadata.h"
+
+using namespace gara;
+using namespace gara::utils;
+
+class JsonWriterTest : public ::testing::Test {};
+
+// ============================================================================
+// Writer Tests
+// ============================================================================
+
+TEST_F(JsonWriterTest, NestedContainers_SeparatedLikeDump) {
+    // Arrange
+    std::string out;
+    JsonWriter writer(out);
+
+    // Act
+    writer.beginObject();
+    writer.key("a");
+    writer.beginArray();
+    writer.value(1);
+    writer.beginObject();
+    writer.endObject();
+    writer.beginArray();
+    writer.endArray();
+    writer.null();
+    writer.endArray();
+    writer.field("b", true);
+    writer.field("c", "x");
+    writer.endObject();
+
+    // Assert
+    EXPECT_EQ(R"({"a":[1,{},[],null],"b":true,"c":"x"})", out);
+}
+
+TEST_F(JsonWriterTest, StringEscapes_MatchNlohmann) {
+    // Arrange
+    std::string text = std::string("quote\" slash\\ tab\t nl\n bell\x07 nul") + '\0' + " caf\xC3\xA9 \xF0\x9F\x98\x80";
+    std::string out;
+    JsonWriter writer(out);
+
+    // Act
+    writer.value(text);
+
+    // Assert
+    EXPECT_EQ(nlohmann::json(text).dump(), out);
+}
+
+TEST_F(JsonWriterTest, InvalidUtf8_ReplacedInsteadOfThrowing) {
+    // Arrange
+    std::string out;
+    JsonWriter writer(out);
+
+    // Act
+    writer.value(std::string_view("a\xFF" "b\xC3", 4));
+
+    // Assert
+    EXPECT_EQ("\"a\xEF\xBF\xBD" "b\xEF\xBF\xBD\"", out);
+    EXPECT_NO_THROW(nlohmann::json::parse(out));
+}
+
+TEST_F(JsonWriterTest, Integers_FullRange) {
+    // Arrange
+    std::string out;
+    JsonWriter writer(out);
+
+    // Act
+    writer.beginArray();
+    writer.value(std::numeric_limits<int64_t>::min());
+    writer.value(std::numeric_limits<uint64_t>::max());
+    writer.endArray();
+
+    // Assert
+    EXPECT_EQ("[-9223372036854775808,18446744073709551615]", out);
+}
+
+// ============================================================================
+// Model Parity Tests
+// ============================================================================
+
+TEST_F(JsonWriterTest, ImageMetadata_WriteJson_MatchesToJsonDump) {
+    // Arrange
+    ImageMetadata image("abc123", "png", "raw/abc123.png", 2048);
+    image.name = "sunset \"final\"";
+    image.upload_timestamp = 1700000000;
+    ImageMetadata no_dimensions = image;
+    image.width = 640;
+    image.height = 480;
+    ImageMetadata with_placeholder = image;
+    with_placeholder.placeholder = "LEHV6nWB2yk8pyo0adR*.7kCMdnj";
+
+    for (const auto& metadata : {image, no_dimensions, with_placeholder}) {
+        std::string out;
+        JsonWriter writer(out);
+
+        // Act
+        metadata.writeJson(writer);
+
+        // Assert
+        EXPECT_EQ(metadata.toJson().dump(), out);
+    }
+}
+
+TEST_F(JsonWriterTest, Album_WriteJson_MatchesToJsonDump) {
+    // Arrange
+    Album album("album-1", "Holiday");
+    album.description = "Line one\nLine two";
+    album.image_ids = {"img1", "img2"};
+    album.tags = {"travel"};
+    album.published = true;
+    std::string out;
+    JsonWriter writer(out);
+
+    // Act
+    album.writeJson(writer);
+
+    // Assert
+    EXPECT_EQ(album.toJson().dump(), out);
+}
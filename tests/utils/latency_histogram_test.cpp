@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+#include "utils/latency_histogram.h"
+
+using namespace gara::utils;
+
+class LatencyHistogramTest : public ::testing::Test {};
+
+// ============================================================================
+// Percentile Tests
+// ============================================================================
+
+TEST_F(LatencyHistogramTest, Percentile_Empty_ReturnsZero) {
+    LatencyHistogram histogram;
+
+    EXPECT_EQ(histogram.count(), 0u);
+    EXPECT_EQ(histogram.percentile(99), 0u);
+    EXPECT_EQ(histogram.min(), 0u);
+    EXPECT_DOUBLE_EQ(histogram.mean(), 0.0);
+}
+
+TEST_F(LatencyHistogramTest, Percentile_SmallValues_AreExact) {
+    // Arrange
+    LatencyHistogram histogram;
+    for (uint64_t v = 1; v <= 1000; ++v) {
+        histogram.record(v);
+    }
+
+    // Assert
+    EXPECT_EQ(histogram.percentile(50), 500u);
+    EXPECT_EQ(histogram.percentile(99), 990u);
+    EXPECT_EQ(histogram.percentile(100), 1000u);
+    EXPECT_EQ(histogram.min(), 1u);
+    EXPECT_DOUBLE_EQ(histogram.mean(), 500.5);
+}
+
+TEST_F(LatencyHistogramTest, Percentile_LargeValues_WithinThreeSignificantDigits) {
+    // Arrange
+    LatencyHistogram histogram;
+    for (uint64_t v = 1; v <= 100000; ++v) {
+        histogram.record(v * 1000);
+    }
+
+    // Assert
+    for (double p : {50.0, 90.0, 99.0, 99.9}) {
+        double expected = p / 100.0 * 100000 * 1000;
+        double actual = static_cast<double>(histogram.percentile(p));
+        EXPECT_NEAR(actual, expected, expected * 0.001) << "p" << p;
+    }
+    EXPECT_EQ(histogram.percentile(100), 100000u * 1000);
+}
+
+TEST_F(LatencyHistogramTest, Record_AboveTrackable_ClampsToMax) {
+    LatencyHistogram histogram(10000);
+
+    histogram.record(1000000);
+
+    EXPECT_EQ(histogram.max(), 10000u);
+    EXPECT_EQ(histogram.percentile(100), 10000u);
+}
+
+// ============================================================================
+// Correction and Merge Tests
+// ============================================================================
+
+TEST_F(LatencyHistogramTest, RecordCorrected_Stall_BackfillsMissedSamples) {
+    // Arrange
+    LatencyHistogram histogram;
+
+    // Act: one 1000us stall where requests were due every 100us
+    histogram.recordCorrected(1000, 100);
+
+    // Assert: 1000, 900, ..., 100
+    EXPECT_EQ(histogram.count(), 10u);
+    EXPECT_EQ(histogram.min(), 100u);
+    EXPECT_EQ(histogram.percentile(50), 500u);
+}
+
+TEST_F(LatencyHistogramTest, RecordCorrected_ZeroInterval_RecordsOnce) {
+    LatencyHistogram histogram;
+
+    histogram.recordCorrected(1000, 0);
+
+    EXPECT_EQ(histogram.count(), 1u);
+}
+
+TEST_F(LatencyHistogramTest, Merge_CombinesCountsAndExtremes) {
+    // Arrange
+    LatencyHistogram a;
+    LatencyHistogram b;
+    a.record(10);
+    a.record(20);
+    b.record(5000000);
+
+    // Act
+    a.merge(b);
+
+    // Assert
+    EXPECT_EQ(a.count(), 3u);
+    EXPECT_EQ(a.min(), 10u);
+    EXPECT_EQ(a.max(), 5000000u);
+    EXPECT_NEAR(a.mean(), (10.0 + 20.0 + 5000000.0) / 3, 1e-6);
+    EXPECT_EQ(a.percentile(50), 20u);
+}
+
+TEST_F(LatencyHistogramTest, Reset_ClearsEverything) {
+    LatencyHistogram histogram;
+    histogram.record(42);
+
+    histogram.reset();
+
+    EXPECT_EQ(histogram.count(), 0u);
+    EXPECT_EQ(histogram.max(), 0u);
+}
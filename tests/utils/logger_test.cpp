@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+#include "utils/logger.h"
+#include <spdlog/async_logger.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+class LoggerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        gara::Logger::initialize("gara-test", "error", gara::Logger::Format::TEXT, "test");
+    }
+
+    void TearDown() override {
+        // Leave a synchronous logger behind for the rest of the suite
+        gara::Logger::initialize("gara-test", "error", gara::Logger::Format::TEXT, "test");
+    }
+
+    static gara::LoggerOptions sampledOptions(uint32_t every) {
+        gara::LoggerOptions options;
+        options.sample_every = every;
+        return options;
+    }
+
+    static int countSampled(std::atomic<uint64_t>& counter, spdlog::level::level_enum level, int calls) {
+        int logged = 0;
+        for (int i = 0; i < calls; ++i) {
+            if (gara::Logger::should_sample(counter, level)) {
+                ++logged;
+            }
+        }
+        return logged;
+    }
+};
+
+// ============================================================================
+// Sampling Tests
+// ============================================================================
+
+TEST_F(LoggerTest, ShouldSample_EveryFour_LogsOneInFour) {
+    // Arrange
+    gara::Logger::initialize("gara-test", "info", gara::Logger::Format::TEXT, "test", sampledOptions(4));
+    std::atomic<uint64_t> counter{0};
+
+    // Act
+    int logged = countSampled(counter, spdlog::level::info, 20);
+
+    // Assert
+    EXPECT_EQ(5, logged);
+}
+
+TEST_F(LoggerTest, ShouldSample_Warning_NeverSampled) {
+    // Arrange
+    gara::Logger::initialize("gara-test", "info", gara::Logger::Format::TEXT, "test", sampledOptions(4));
+    std::atomic<uint64_t> counter{0};
+
+    // Act
+    int logged = countSampled(counter, spdlog::level::warn, 10);
+
+    // Assert
+    EXPECT_EQ(10, logged);
+}
+
+TEST_F(LoggerTest, ShouldSample_BelowLogLevel_ReturnsFalse) {
+    // Arrange
+    std::atomic<uint64_t> counter{0};
+
+    // Act
+    int logged = countSampled(counter, spdlog::level::info, 10);
+
+    // Assert
+    EXPECT_EQ(0, logged) << "Logger is at error level, so info records are skipped entirely";
+    EXPECT_EQ(0u, counter.load()) << "Skipped records should not advance the site counter";
+}
+
+TEST_F(LoggerTest, ShouldSample_SeparateCallSites_CountedIndependently) {
+    // Arrange
+    gara::Logger::initialize("gara-test", "info", gara::Logger::Format::TEXT, "test", sampledOptions(2));
+    std::atomic<uint64_t> first_site{0};
+    std::atomic<uint64_t> second_site{0};
+
+    // Act & Assert
+    EXPECT_TRUE(gara::Logger::should_sample(first_site, spdlog::level::info));
+    EXPECT_TRUE(gara::Logger::should_sample(second_site, spdlog::level::info));
+    EXPECT_FALSE(gara::Logger::should_sample(first_site, spdlog::level::info));
+}
+
+// ============================================================================
+// Async Tests
+// ============================================================================
+
+TEST_F(LoggerTest, Initialize_AsyncDropPolicy_LogsFromManyThreads) {
+    // Arrange
+    gara::LoggerOptions options;
+    options.async = true;
+    options.async_queue_size = 16;
+    gara::Logger::initialize("gara-test", "warn", gara::Logger::Format::JSON, "test", options);
+    std::vector<std::thread> threads;
+
+    // Act
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([]() {
+            for (int i = 0; i < 10; ++i) {
+                gara::Logger::log_structured(spdlog::level::warn, "async record", {{"i", i}});
+                LOG_STRUCTURED_SAMPLED(spdlog::level::info, "sampled record", {{"i", i}});
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    // Assert
+    EXPECT_NE(nullptr, std::dynamic_pointer_cast<spdlog::async_logger>(gara::Logger::get()));
+    EXPECT_NO_THROW(gara::Logger::shutdown());
+}
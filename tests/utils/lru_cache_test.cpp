@@ -0,0 +1,204 @@
+#include <gtest/gtest.h>
+#include "utils/lru_cache.h"
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace gara::utils;
+
+class ShardedLruCacheTest : public ::testing::Test {
+protected:
+    // Single shard so eviction order is deterministic
+    static constexpr size_t ONE_SHARD = 1;
+};
+
+// ============================================================================
+// Basic Operation Tests
+// ============================================================================
+
+TEST_F(ShardedLruCacheTest, Get_AfterPut_ReturnsValue) {
+    // Arrange
+    ShardedLruCache<int> cache(1024, std::chrono::seconds(0));
+    cache.put("key", 42, 10);
+
+    // Act
+    auto value = cache.get("key");
+
+    // Assert
+    ASSERT_TRUE(value.has_value());
+    EXPECT_EQ(42, *value);
+    EXPECT_EQ(1u, cache.size());
+}
+
+TEST_F(ShardedLruCacheTest, Get_MissingKey_ReturnsNullopt) {
+    // Arrange
+    ShardedLruCache<int> cache(1024, std::chrono::seconds(0));
+
+    // Act & Assert
+    EXPECT_FALSE(cache.get("missing").has_value());
+}
+
+TEST_F(ShardedLruCacheTest, Put_ExistingKey_ReplacesValueAndCost) {
+    // Arrange
+    ShardedLruCache<int> cache(1024, std::chrono::seconds(0), ONE_SHARD);
+    cache.put("key", 1, 100);
+
+    // Act
+    cache.put("key", 2, 50);
+
+    // Assert
+    EXPECT_EQ(2, *cache.get("key"));
+    EXPECT_EQ(50u, cache.bytes());
+    EXPECT_EQ(1u, cache.size());
+}
+
+TEST_F(ShardedLruCacheTest, ZeroBudget_DisablesCache) {
+    // Arrange
+    ShardedLruCache<int> cache(0, std::chrono::seconds(0));
+
+    // Act
+    cache.put("key", 1, 1);
+
+    // Assert
+    EXPECT_FALSE(cache.enabled());
+    EXPECT_FALSE(cache.get("key").has_value());
+}
+
+// ============================================================================
+// Eviction Tests
+// ============================================================================
+
+TEST_F(ShardedLruCacheTest, Put_OverBudget_EvictsLeastRecentlyUsed) {
+    // Arrange
+    ShardedLruCache<int> cache(300, std::chrono::seconds(0), ONE_SHARD);
+    cache.put("a", 1, 100);
+    cache.put("b", 2, 100);
+    cache.put("c", 3, 100);
+    cache.get("a");  // "b" is now least recently used
+
+    // Act
+    cache.put("d", 4, 100);
+
+    // Assert
+    EXPECT_TRUE(cache.get("a").has_value());
+    EXPECT_FALSE(cache.get("b").has_value())
+        << "Least recently used entry should be evicted first";
+    EXPECT_TRUE(cache.get("c").has_value());
+    EXPECT_TRUE(cache.get("d").has_value());
+    EXPECT_LE(cache.bytes(), 300u);
+}
+
+TEST_F(ShardedLruCacheTest, Put_EntryLargerThanBudget_IsNotStored) {
+    // Arrange
+    ShardedLruCache<int> cache(100, std::chrono::seconds(0), ONE_SHARD);
+
+    // Act
+    cache.put("huge", 1, 1000);
+
+    // Assert
+    EXPECT_FALSE(cache.get("huge").has_value());
+    EXPECT_EQ(0u, cache.bytes());
+}
+
+TEST_F(ShardedLruCacheTest, Get_ExpiredEntry_ReturnsNullopt) {
+    // Arrange
+    ShardedLruCache<int> cache(1024, std::chrono::seconds(1), ONE_SHARD);
+    cache.put("key", 1, 10);
+
+    // Act
+    std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+    auto value = cache.get("key");
+
+    // Assert
+    EXPECT_FALSE(value.has_value())
+        << "Entries older than the TTL should be treated as missing";
+    EXPECT_EQ(0u, cache.size());
+}
+
+// ============================================================================
+// Invalidation Tests
+// ============================================================================
+
+TEST_F(ShardedLruCacheTest, EraseIf_MatchingPrefix_RemovesOnlyMatches) {
+    // Arrange
+    ShardedLruCache<int> cache(4096, std::chrono::seconds(0));
+    cache.put("transformed/abc_jpeg_100x100.jpeg", 1, 10);
+    cache.put("transformed/abc_png_0x0.png", 2, 10);
+    cache.put("transformed/xyz_jpeg_100x100.jpeg", 3, 10);
+
+    // Act
+    size_t removed = cache.eraseIf([](const std::string& key) {
+        return key.rfind("transformed/abc_", 0) == 0;
+    });
+
+    // Assert
+    EXPECT_EQ(2u, removed);
+    EXPECT_EQ(1u, cache.size());
+    EXPECT_TRUE(cache.get("transformed/xyz_jpeg_100x100.jpeg").has_value());
+}
+
+TEST_F(ShardedLruCacheTest, Clear_RemovesAllEntries) {
+    // Arrange
+    ShardedLruCache<int> cache(4096, std::chrono::seconds(0));
+    cache.put("a", 1, 10);
+    cache.put("b", 2, 10);
+
+    // Act
+    cache.clear();
+
+    // Assert
+    EXPECT_EQ(0u, cache.size());
+    EXPECT_EQ(0u, cache.bytes());
+}
+
+// ============================================================================
+// Snapshot Tests
+// ============================================================================
+
+TEST_F(ShardedLruCacheTest, Snapshot_ReturnsMostRecentlyUsedFirst) {
+    // Arrange
+    ShardedLruCache<int> cache(4096, std::chrono::seconds(0), ONE_SHARD);
+    cache.put("a", 1, 10);
+    cache.put("b", 2, 10);
+    cache.put("c", 3, 10);
+    cache.get("a");
+
+    // Act
+    auto entries = cache.snapshot(2);
+
+    // Assert
+    ASSERT_EQ(2u, entries.size());
+    EXPECT_EQ("a", entries[0].first);
+    EXPECT_EQ(1, entries[0].second);
+    EXPECT_EQ("c", entries[1].first);
+    EXPECT_EQ(3u, cache.snapshot().size());
+}
+
+// ============================================================================
+// Concurrency Tests
+// ============================================================================
+
+TEST_F(ShardedLruCacheTest, ConcurrentPutAndGet_StaysWithinBudget) {
+    // Arrange
+    ShardedLruCache<int> cache(16 * 1000, std::chrono::seconds(0), 16);
+    std::vector<std::thread> threads;
+
+    // Act
+    for (int t = 0; t < 8; ++t) {
+        threads.emplace_back([&cache, t]() {
+            for (int i = 0; i < 1000; ++i) {
+                std::string key = std::to_string(t) + "_" + std::to_string(i);
+                cache.put(key, i, 10);
+                cache.get(key);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    // Assert
+    EXPECT_LE(cache.bytes(), 16u * 1000u);
+    EXPECT_GT(cache.size(), 0u);
+}
@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+#include "utils/mapped_file.h"
+#include "test_helpers/test_file_manager.h"
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+using namespace gara::utils;
+using namespace gara::test_helpers;
+
+class MappedFileTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        path_ = TestFileManager::createUniquePath("mapped_file_test_", ".bin");
+    }
+
+    void TearDown() override {
+        std::filesystem::remove(path_);
+    }
+
+    void writeFile(const std::string& content) {
+        std::ofstream file(path_, std::ios::binary);
+        file << content;
+    }
+
+    std::string path_;
+};
+
+// ============================================================================
+// Open Tests
+// ============================================================================
+
+TEST_F(MappedFileTest, Open_RegularFile_ViewsWholeContent) {
+    // Arrange
+    writeFile("Hello, Gara!");
+
+    // Act
+    auto mapped = MappedFile::open(path_);
+
+    // Assert
+    ASSERT_NE(mapped, nullptr);
+    EXPECT_EQ(std::string(mapped->data(), mapped->size()), "Hello, Gara!");
+    EXPECT_EQ(mapped->view().size(), 12u);
+}
+
+TEST_F(MappedFileTest, Open_MissingFile_ReturnsNull) {
+    EXPECT_EQ(MappedFile::open(path_), nullptr);
+}
+
+TEST_F(MappedFileTest, Open_EmptyFile_ReturnsNull) {
+    writeFile("");
+
+    EXPECT_EQ(MappedFile::open(path_), nullptr);
+}
+
+TEST_F(MappedFileTest, Open_Directory_ReturnsNull) {
+    EXPECT_EQ(MappedFile::open(std::filesystem::temp_directory_path().string()), nullptr);
+}
+
+TEST_F(MappedFileTest, View_FileDeletedAfterMapping_StillReadable) {
+    // Arrange
+    writeFile("original bytes");
+    auto mapped = MappedFile::open(path_);
+    ASSERT_NE(mapped, nullptr);
+
+    // Act: storage deletes or atomically replaces objects by unlinking
+    std::filesystem::remove(path_);
+
+    // Assert
+    EXPECT_EQ(std::string(mapped->data(), mapped->size()), "original bytes");
+}
+
+// ============================================================================
+// ByteView Tests
+// ============================================================================
+
+TEST_F(MappedFileTest, ByteView_FromVector_SharesStorage) {
+    std::vector<char> bytes = {'a', 'b', 'c'};
+
+    ByteView view = bytes;
+
+    EXPECT_EQ(view.data(), bytes.data());
+    EXPECT_EQ(view.size(), 3u);
+    EXPECT_FALSE(view.empty());
+    EXPECT_TRUE(ByteView().empty());
+}
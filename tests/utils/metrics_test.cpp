@@ -0,0 +1,261 @@
+#include <gtest/gtest.h>
+#include "utils/metrics.h"
+#include "utils/logger.h"
+#include <nlohmann/json.hpp>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using json = nlohmann::json;
+
+class MetricsTest : public ::testing::Test {
+protected:
+    // Long interval so only explicit flush() calls write documents
+    static constexpr std::chrono::milliseconds NO_AUTO_FLUSH{3600000};
+
+    void SetUp() override {
+        gara::Logger::initialize("gara-test", "error", gara::Logger::Format::TEXT, "test");
+        gara::Metrics::initialize("GaraTest", "gara-test", "test", true, NO_AUTO_FLUSH);
+        gara::Metrics::get()->set_output([this](const std::string& documents) {
+            output_ += documents;
+        });
+    }
+
+    void TearDown() override {
+        gara::Metrics::shutdown();
+    }
+
+    std::vector<json> flushDocuments() {
+        output_.clear();
+        gara::Metrics::get()->flush();
+
+        std::vector<json> documents;
+        std::istringstream lines(output_);
+        std::string line;
+        while (std::getline(lines, line)) {
+            documents.push_back(json::parse(line));
+        }
+        return documents;
+    }
+
+    std::string output_;
+};
+
+// ============================================================================
+// Aggregation Tests
+// ============================================================================
+
+TEST_F(MetricsTest, PublishCount_RepeatedSamples_SummedIntoOneDocument) {
+    // Arrange
+    auto metrics = gara::Metrics::get();
+
+    // Act
+    for (int i = 0; i < 10; ++i) {
+        metrics->publish_count("CacheHits");
+    }
+    metrics->publish_count("CacheMisses", 3.0);
+    auto documents = flushDocuments();
+
+    // Assert
+    ASSERT_EQ(1u, documents.size());
+    EXPECT_DOUBLE_EQ(10.0, documents[0]["CacheHits"].get<double>());
+    EXPECT_DOUBLE_EQ(3.0, documents[0]["CacheMisses"].get<double>());
+    EXPECT_EQ("GaraTest", documents[0]["_aws"]["CloudWatchMetrics"][0]["Namespace"]);
+    EXPECT_EQ(2u, documents[0]["_aws"]["CloudWatchMetrics"][0]["Metrics"].size());
+}
+
+TEST_F(MetricsTest, PublishCount_DifferentDimensions_OneDocumentPerDimensionSet) {
+    // Arrange
+    auto metrics = gara::Metrics::get();
+
+    // Act
+    metrics->publish_count("Requests", 1.0, "Count", {{"Route", "/a"}});
+    metrics->publish_count("Requests", 1.0, "Count", {{"Route", "/b"}});
+    metrics->publish_count("Requests", 1.0, "Count", {{"Route", "/b"}});
+    auto documents = flushDocuments();
+
+    // Assert
+    ASSERT_EQ(2u, documents.size());
+    EXPECT_EQ("/a", documents[0]["Route"]);
+    EXPECT_DOUBLE_EQ(1.0, documents[0]["Requests"].get<double>());
+    EXPECT_EQ("/b", documents[1]["Route"]);
+    EXPECT_DOUBLE_EQ(2.0, documents[1]["Requests"].get<double>());
+}
+
+TEST_F(MetricsTest, PublishDuration_Samples_EmittedAsValueArray) {
+    // Arrange
+    auto metrics = gara::Metrics::get();
+
+    // Act
+    metrics->publish_duration("Latency", 10.0);
+    metrics->publish_duration("Latency", 10.0);
+    metrics->publish_duration("Latency", 250.0);
+    auto documents = flushDocuments();
+
+    // Assert
+    ASSERT_EQ(1u, documents.size());
+    const auto& values = documents[0]["Latency"];
+    ASSERT_TRUE(values.is_array());
+    ASSERT_EQ(3u, values.size());
+    EXPECT_NEAR(10.0, values[0].get<double>(), 10.0 * 0.06);
+    EXPECT_NEAR(250.0, values[2].get<double>(), 250.0 * 0.06);
+}
+
+TEST_F(MetricsTest, PublishGauge_RepeatedSamples_KeepsLastValue) {
+    // Arrange
+    auto metrics = gara::Metrics::get();
+
+    // Act
+    metrics->publish_gauge("QueueDepth", 5.0);
+    metrics->publish_gauge("QueueDepth", 2.0);
+    auto documents = flushDocuments();
+
+    // Assert
+    ASSERT_EQ(1u, documents.size());
+    EXPECT_DOUBLE_EQ(2.0, documents[0]["QueueDepth"].get<double>());
+}
+
+TEST_F(MetricsTest, Flush_MoreThanHundredMetrics_SplitsDocuments) {
+    // Arrange
+    auto metrics = gara::Metrics::get();
+
+    // Act
+    for (int i = 0; i < 150; ++i) {
+        metrics->publish_count("Metric" + std::to_string(i));
+    }
+    auto documents = flushDocuments();
+
+    // Assert
+    ASSERT_EQ(2u, documents.size());
+    EXPECT_EQ(100u, documents[0]["_aws"]["CloudWatchMetrics"][0]["Metrics"].size());
+    EXPECT_EQ(50u, documents[1]["_aws"]["CloudWatchMetrics"][0]["Metrics"].size());
+}
+
+TEST_F(MetricsTest, Flush_AfterFlush_AggregatesReset) {
+    // Arrange
+    auto metrics = gara::Metrics::get();
+    metrics->publish_count("CacheHits");
+    flushDocuments();
+
+    // Act
+    auto documents = flushDocuments();
+
+    // Assert
+    EXPECT_TRUE(documents.empty());
+}
+
+#ifndef GARA_DISABLE_METRICS  // Handle updates compile to no-ops otherwise
+
+// ============================================================================
+// Handle Tests
+// ============================================================================
+
+TEST_F(MetricsTest, CounterMetric_Add_SummedWithInternedDimensions) {
+    // Arrange
+    gara::CounterMetric counter("HandleHits", {{"operation", "transform"}});
+
+    // Act
+    counter.add();
+    counter.add(4);
+    auto documents = flushDocuments();
+
+    // Assert
+    ASSERT_EQ(1u, documents.size());
+    EXPECT_DOUBLE_EQ(5.0, documents[0]["HandleHits"].get<double>());
+    EXPECT_EQ("transform", documents[0]["operation"]);
+}
+
+TEST_F(MetricsTest, CounterMetric_SameDimensionsAsPublish_SharesDocument) {
+    // Arrange
+    gara::CounterMetric counter("HandleHits", {{"operation", "transform"}});
+
+    // Act
+    counter.add();
+    gara::Metrics::get()->publish_count("HandleHits", 2.0, "Count", {{"operation", "transform"}});
+    auto documents = flushDocuments();
+
+    // Assert
+    ASSERT_EQ(1u, documents.size());
+    EXPECT_DOUBLE_EQ(3.0, documents[0]["HandleHits"].get<double>());
+}
+
+TEST_F(MetricsTest, DurationMetric_ScopedTimer_RecordsOneSample) {
+    // Arrange
+    gara::DurationMetric duration("HandleLatency", {{"step", "encode"}});
+
+    // Act
+    {
+        gara::ScopedMetricTimer timer(duration);
+    }
+    duration.record_ms(40.0);
+    auto documents = flushDocuments();
+
+    // Assert
+    ASSERT_EQ(1u, documents.size());
+    const auto& values = documents[0]["HandleLatency"];
+    ASSERT_TRUE(values.is_array());
+    ASSERT_EQ(2u, values.size());
+    EXPECT_NEAR(40.0, values[1].get<double>(), 40.0 * 0.06);
+}
+
+TEST_F(MetricsTest, DurationMetric_NoSamples_WritesNothing) {
+    // Arrange
+    gara::DurationMetric duration("HandleLatency");
+
+    // Act
+    auto documents = flushDocuments();
+
+    // Assert
+    EXPECT_TRUE(documents.empty());
+}
+
+#endif // GARA_DISABLE_METRICS
+
+// ============================================================================
+// Threading Tests
+// ============================================================================
+
+TEST_F(MetricsTest, PublishCount_ManyThreads_NoSamplesLost) {
+    // Arrange
+    auto metrics = gara::Metrics::get();
+    std::vector<std::thread> threads;
+
+    // Act
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([metrics]() {
+            for (int i = 0; i < 500; ++i) {
+                metrics->publish_count("Requests");
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    auto documents = flushDocuments();
+
+    // Assert
+    ASSERT_EQ(1u, documents.size());
+    EXPECT_DOUBLE_EQ(2000.0, documents[0]["Requests"].get<double>());
+    EXPECT_EQ(0u, metrics->dropped_samples());
+}
+
+// ============================================================================
+// Disabled Tests
+// ============================================================================
+
+TEST_F(MetricsTest, Disabled_Publish_WritesNothing) {
+    // Arrange
+    gara::Metrics::initialize("GaraTest", "gara-test", "test", false, NO_AUTO_FLUSH);
+    auto metrics = gara::Metrics::get();
+    metrics->set_output([this](const std::string& documents) { output_ += documents; });
+
+    // Act
+    metrics->publish_count("CacheHits");
+    metrics->publish_duration("Latency", 5.0);
+    auto documents = flushDocuments();
+
+    // Assert
+    EXPECT_TRUE(documents.empty());
+    EXPECT_EQ(nullptr, metrics->start_timer("Latency"));
+}
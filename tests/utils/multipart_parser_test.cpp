@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+#include "utils/multipart_parser.h"
+#include <string>
+
+using namespace gara::utils;
+
+class MultipartParserTest : public ::testing::Test {
+protected:
+    const std::string content_type_ = "multipart/form-data; boundary=----GaraBoundary";
+
+    static std::string buildBody(const std::string& parts) {
+        return parts + "------GaraBoundary--\r\n";
+    }
+
+    static std::string filePart(const std::string& filename, const std::string& data) {
+        return "------GaraBoundary\r\n"
+               "Content-Disposition: form-data; name=\"file\"; filename=\"" + filename + "\"\r\n"
+               "Content-Type: image/jpeg\r\n"
+               "\r\n" + data + "\r\n";
+    }
+
+    static std::string fieldPart(const std::string& name, const std::string& value) {
+        return "------GaraBoundary\r\n"
+               "Content-Disposition: form-data; name=\"" + name + "\"\r\n"
+               "\r\n" + value + "\r\n";
+    }
+};
+
+// ============================================================================
+// Boundary Tests
+// ============================================================================
+
+TEST_F(MultipartParserTest, ExtractBoundary_QuotedValue_StripsQuotes) {
+    EXPECT_EQ("abc123", MultipartParser::extractBoundary("multipart/form-data; boundary=\"abc123\""));
+}
+
+TEST_F(MultipartParserTest, ExtractBoundary_NonMultipart_ReturnsEmpty) {
+    EXPECT_TRUE(MultipartParser::extractBoundary("application/json").empty());
+}
+
+// ============================================================================
+// File Part Tests
+// ============================================================================
+
+TEST_F(MultipartParserTest, FindFilePart_SingleFile_ReturnsViewIntoBody) {
+    // Arrange
+    std::string body = buildBody(filePart("photo.jpg", "binary\r\ndata"));
+
+    // Act
+    auto part = MultipartParser::findFilePart(body, content_type_);
+
+    // Assert
+    ASSERT_TRUE(part.has_value());
+    EXPECT_EQ("photo.jpg", part->filename);
+    EXPECT_EQ("image/jpeg", part->content_type);
+    EXPECT_EQ("binary\r\ndata", std::string(part->data));
+    EXPECT_GE(part->data.data(), body.data())
+        << "Part data should point into the original body, not a copy";
+    EXPECT_LE(part->data.data() + part->data.size(), body.data() + body.size());
+}
+
+TEST_F(MultipartParserTest, FindFilePart_FieldBeforeFile_SkipsField) {
+    // Arrange
+    std::string body = buildBody(fieldPart("title", "hello") + filePart("a.png", "PNGDATA"));
+
+    // Act
+    auto part = MultipartParser::findFilePart(body, content_type_);
+
+    // Assert
+    ASSERT_TRUE(part.has_value());
+    EXPECT_EQ("a.png", part->filename);
+    EXPECT_EQ("PNGDATA", std::string(part->data));
+}
+
+TEST_F(MultipartParserTest, FindFilePart_NoFile_ReturnsNullopt) {
+    // Arrange
+    std::string body = buildBody(fieldPart("title", "hello"));
+
+    // Act & Assert
+    EXPECT_FALSE(MultipartParser::findFilePart(body, content_type_).has_value());
+}
+
+TEST_F(MultipartParserTest, FindFilePart_Truncated_ReturnsNullopt) {
+    // Arrange - no closing delimiter after the data
+    std::string body = "------GaraBoundary\r\n"
+                       "Content-Disposition: form-data; name=\"file\"; filename=\"a.jpg\"\r\n"
+                       "\r\nDATA";
+
+    // Act & Assert
+    EXPECT_FALSE(MultipartParser::findFilePart(body, content_type_).has_value());
+}
+
+TEST_F(MultipartParserTest, FindFileParts_ManyFiles_ReturnsEachInOrder) {
+    // Arrange
+    std::string body = buildBody(filePart("a.jpg", "aaa") + fieldPart("album", "x") +
+                                 filePart("b.png", "bb") + filePart("c.gif", ""));
+
+    // Act
+    auto parts = MultipartParser::findFileParts(body, content_type_);
+
+    // Assert
+    ASSERT_EQ(3u, parts.size());
+    EXPECT_EQ("a.jpg", parts[0].filename);
+    EXPECT_EQ("aaa", std::string(parts[0].data));
+    EXPECT_EQ("b.png", parts[1].filename);
+    EXPECT_EQ("bb", std::string(parts[1].data));
+    EXPECT_EQ("c.gif", parts[2].filename);
+    EXPECT_TRUE(parts[2].data.empty());
+}
+
+TEST_F(MultipartParserTest, FindFileParts_TruncatedAfterFirstFile_ReturnsEmpty) {
+    std::string body = filePart("a.jpg", "aaa") + "------GaraBoundary\r\nContent-Disposition: form-data";
+
+    EXPECT_TRUE(MultipartParser::findFileParts(body, content_type_).empty());
+}
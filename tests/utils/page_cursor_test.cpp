@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+#include "utils/page_cursor.h"
+#include "test_helpers/test_constants.h"
+
+using namespace gara;
+using namespace gara::utils;
+using namespace gara::test_constants;
+
+class PageCursorCodecTest : public ::testing::Test {
+protected:
+    static ImagePageCursor makeCursor(std::time_t uploaded_at, const std::string& name) {
+        ImagePageCursor cursor;
+        cursor.uploaded_at = uploaded_at;
+        cursor.name = name;
+        cursor.image_id = "abc123";
+        return cursor;
+    }
+};
+
+// ============================================================================
+// Round Trip Tests
+// ============================================================================
+
+TEST_F(PageCursorCodecTest, Decode_TimeSortedToken_RoundTrips) {
+    // Arrange
+    std::string token = PageCursorCodec::encode(ImageSortOrder::NEWEST, makeCursor(1700000000, "ignored"));
+
+    // Act
+    auto cursor = PageCursorCodec::decode(token, ImageSortOrder::NEWEST);
+
+    // Assert
+    ASSERT_TRUE(cursor.has_value());
+    EXPECT_EQ(1700000000, cursor->uploaded_at);
+    EXPECT_EQ("abc123", cursor->image_id);
+}
+
+TEST_F(PageCursorCodecTest, Decode_NameSortedToken_RoundTripsSpecialCharacters) {
+    // Arrange
+    std::string name = "holiday. photo/\xc3\xa9&x=1";
+    std::string token = PageCursorCodec::encode(ImageSortOrder::NAME_ASC, makeCursor(0, name));
+
+    // Act
+    auto cursor = PageCursorCodec::decode(token, ImageSortOrder::NAME_ASC);
+
+    // Assert
+    ASSERT_TRUE(cursor.has_value());
+    EXPECT_EQ(name, cursor->name);
+    EXPECT_EQ(std::string::npos, token.find('/'))
+        << "Tokens should be safe to place in a query string";
+}
+
+// ============================================================================
+// Validation Tests
+// ============================================================================
+
+TEST_F(PageCursorCodecTest, Decode_TokenForOtherSortOrder_ReturnsNullopt) {
+    // Arrange
+    std::string token = PageCursorCodec::encode(ImageSortOrder::NEWEST, makeCursor(SMALL_IMAGE_SIZE, ""));
+
+    // Act & Assert
+    EXPECT_FALSE(PageCursorCodec::decode(token, ImageSortOrder::OLDEST).has_value())
+        << "A cursor is only meaningful for the ordering it was issued under";
+}
+
+TEST_F(PageCursorCodecTest, Decode_MalformedTokens_ReturnNullopt) {
+    EXPECT_FALSE(PageCursorCodec::decode("", ImageSortOrder::NEWEST).has_value());
+    EXPECT_FALSE(PageCursorCodec::decode("n.123", ImageSortOrder::NEWEST).has_value());
+    EXPECT_FALSE(PageCursorCodec::decode("n.12x.abc", ImageSortOrder::NEWEST).has_value());
+    EXPECT_FALSE(PageCursorCodec::decode("n.123.", ImageSortOrder::NEWEST).has_value());
+    EXPECT_FALSE(PageCursorCodec::decode("n.123.a'b", ImageSortOrder::NEWEST).has_value());
+    EXPECT_FALSE(PageCursorCodec::decode("a.6g.abc", ImageSortOrder::NAME_ASC).has_value());
+    EXPECT_FALSE(PageCursorCodec::decode("a.616.abc", ImageSortOrder::NAME_ASC).has_value());
+}
+
+// ============================================================================
+// Album Cursor Tests
+// ============================================================================
+
+TEST_F(PageCursorCodecTest, DecodeAlbum_EncodedCursor_RoundTrips) {
+    // Arrange
+    AlbumPageCursor original{1700000000, "0190a1b2c3d4e5f6"};
+
+    // Act
+    auto cursor = PageCursorCodec::decodeAlbum(PageCursorCodec::encodeAlbum(original));
+
+    // Assert
+    ASSERT_TRUE(cursor.has_value());
+    EXPECT_EQ(original.created_at, cursor->created_at);
+    EXPECT_EQ(original.album_id, cursor->album_id);
+}
+
+TEST_F(PageCursorCodecTest, DecodeAlbum_ImageOrMalformedTokens_ReturnNullopt) {
+    EXPECT_FALSE(PageCursorCodec::decodeAlbum("").has_value());
+    EXPECT_FALSE(PageCursorCodec::decodeAlbum("n.123.abc").has_value());
+    EXPECT_FALSE(PageCursorCodec::decodeAlbum("c.123").has_value());
+    EXPECT_FALSE(PageCursorCodec::decodeAlbum("c..abc").has_value());
+    EXPECT_FALSE(PageCursorCodec::decodeAlbum("c.12x.abc").has_value());
+    EXPECT_FALSE(PageCursorCodec::decodeAlbum("c.123.a'b").has_value());
+}
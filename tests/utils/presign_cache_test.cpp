@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+#include "utils/presign_cache.h"
+
+using namespace gara::utils;
+
+class PresignCacheTest : public ::testing::Test {
+protected:
+    static constexpr int BUCKET = 900;
+    static constexpr int MAX_EXPIRATION = 7 * 24 * 3600;
+    static constexpr std::time_t BUCKET_START = 1700000100;  // A multiple of 900
+
+    PresignCache::Signer countingSigner(int& calls) {
+        return [&calls](std::time_t signed_at, int expires_in) {
+            ++calls;
+            return "https://bucket/key?t=" + std::to_string(signed_at) + "&e=" + std::to_string(expires_in);
+        };
+    }
+};
+
+// ============================================================================
+// Window Tests
+// ============================================================================
+
+TEST_F(PresignCacheTest, Window_FloorsToBucketAndExtendsLifetime) {
+    // Act
+    PresignWindow window = PresignCache::window(BUCKET_START + 437, 3600, BUCKET, MAX_EXPIRATION);
+
+    // Assert
+    EXPECT_EQ(BUCKET_START, window.signed_at);
+    EXPECT_EQ(3600 + BUCKET, window.expires_in);
+}
+
+TEST_F(PresignCacheTest, Window_LastSecondOfBucket_KeepsRequestedLifetime) {
+    std::time_t now = BUCKET_START + BUCKET - 1;
+    PresignWindow window = PresignCache::window(now, 3600, BUCKET, MAX_EXPIRATION);
+    EXPECT_GE(window.signed_at + window.expires_in - now, 3600);
+}
+
+TEST_F(PresignCacheTest, Window_CapsAtMaximum) {
+    PresignWindow window = PresignCache::window(BUCKET_START, MAX_EXPIRATION, BUCKET, MAX_EXPIRATION);
+    EXPECT_EQ(MAX_EXPIRATION, window.expires_in);
+}
+
+TEST_F(PresignCacheTest, Window_NoBucket_SignsNow) {
+    PresignWindow window = PresignCache::window(BUCKET_START + 437, 3600, 0, MAX_EXPIRATION);
+    EXPECT_EQ(BUCKET_START + 437, window.signed_at);
+    EXPECT_EQ(3600, window.expires_in);
+}
+
+// ============================================================================
+// Cache Tests
+// ============================================================================
+
+TEST_F(PresignCacheTest, Get_SameBucket_ReusesUrl) {
+    // Arrange
+    PresignCache cache(BUCKET, MAX_EXPIRATION, 1024 * 1024);
+    int calls = 0;
+    auto sign = countingSigner(calls);
+
+    // Act
+    std::string first = cache.get("raw/a.jpg", 3600, BUCKET_START + 10, sign);
+    std::string second = cache.get("raw/a.jpg", 3600, BUCKET_START + 800, sign);
+
+    // Assert
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(1, calls);
+}
+
+TEST_F(PresignCacheTest, Get_NextBucket_SignsAgain) {
+    // Arrange
+    PresignCache cache(BUCKET, MAX_EXPIRATION, 1024 * 1024);
+    int calls = 0;
+    auto sign = countingSigner(calls);
+
+    // Act
+    std::string first = cache.get("raw/a.jpg", 3600, BUCKET_START + 10, sign);
+    std::string second = cache.get("raw/a.jpg", 3600, BUCKET_START + BUCKET + 10, sign);
+
+    // Assert
+    EXPECT_NE(first, second);
+    EXPECT_EQ(2, calls);
+}
+
+TEST_F(PresignCacheTest, Get_DifferentKeyOrLifetime_SignsSeparately) {
+    PresignCache cache(BUCKET, MAX_EXPIRATION, 1024 * 1024);
+    int calls = 0;
+    auto sign = countingSigner(calls);
+
+    cache.get("raw/a.jpg", 3600, BUCKET_START, sign);
+    cache.get("raw/b.jpg", 3600, BUCKET_START, sign);
+    std::string day = cache.get("raw/a.jpg", 86400, BUCKET_START, sign);
+
+    EXPECT_EQ(3, calls);
+    EXPECT_NE(std::string::npos, day.find("e=" + std::to_string(86400 + BUCKET)));
+}
+
+TEST_F(PresignCacheTest, Get_Disabled_SignsEveryTime) {
+    PresignCache cache(0, MAX_EXPIRATION, 1024 * 1024);
+    int calls = 0;
+    auto sign = countingSigner(calls);
+
+    cache.get("raw/a.jpg", 3600, BUCKET_START, sign);
+    cache.get("raw/a.jpg", 3600, BUCKET_START, sign);
+
+    EXPECT_EQ(2, calls);
+}
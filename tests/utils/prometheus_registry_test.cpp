@@ -0,0 +1,150 @@
+#include <gtest/gtest.h>
+#include "utils/prometheus_registry.h"
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using gara::PrometheusRegistry;
+
+class PrometheusRegistryTest : public ::testing::Test {
+protected:
+    static bool contains(const std::string& haystack, const std::string& needle) {
+        return haystack.find(needle) != std::string::npos;
+    }
+
+    PrometheusRegistry registry_;
+};
+
+// ============================================================================
+// Rendering Tests
+// ============================================================================
+
+TEST_F(PrometheusRegistryTest, Counter_Inc_RenderedWithLabelsAndType) {
+    // Arrange
+    auto& hits = registry_.counter("gara_cache_requests_total", "Cache lookups", {{"result", "hit"}});
+
+    // Act
+    hits.inc();
+    hits.inc(2);
+    std::string output = registry_.render();
+
+    // Assert
+    EXPECT_TRUE(contains(output, "# HELP gara_cache_requests_total Cache lookups\n"));
+    EXPECT_TRUE(contains(output, "# TYPE gara_cache_requests_total counter\n"));
+    EXPECT_TRUE(contains(output, "gara_cache_requests_total{result=\"hit\"} 3\n"));
+}
+
+TEST_F(PrometheusRegistryTest, Gauge_IncAndDec_RendersCurrentValue) {
+    // Arrange
+    auto& in_flight = registry_.gauge("gara_transforms_in_flight", "Running transforms");
+
+    // Act
+    in_flight.inc();
+    in_flight.inc();
+    in_flight.dec();
+
+    // Assert
+    EXPECT_TRUE(contains(registry_.render(), "gara_transforms_in_flight 1\n"));
+}
+
+TEST_F(PrometheusRegistryTest, Histogram_Observe_RendersCumulativeBuckets) {
+    // Arrange
+    auto& latency = registry_.histogram("gara_latency_seconds", "Latency", {0.1, 1.0}, {{"route", "/api/images"}});
+
+    // Act
+    latency.observe(0.05);
+    latency.observe(0.1);
+    latency.observe(0.5);
+    latency.observe(3.0);
+    std::string output = registry_.render();
+
+    // Assert
+    EXPECT_TRUE(contains(output, "# TYPE gara_latency_seconds histogram\n"));
+    EXPECT_TRUE(contains(output, "gara_latency_seconds_bucket{route=\"/api/images\",le=\"0.1\"} 2\n"))
+        << "Bucket bounds are inclusive";
+    EXPECT_TRUE(contains(output, "gara_latency_seconds_bucket{route=\"/api/images\",le=\"1\"} 3\n"));
+    EXPECT_TRUE(contains(output, "gara_latency_seconds_bucket{route=\"/api/images\",le=\"+Inf\"} 4\n"));
+    EXPECT_TRUE(contains(output, "gara_latency_seconds_sum{route=\"/api/images\"} 3.65\n"));
+    EXPECT_TRUE(contains(output, "gara_latency_seconds_count{route=\"/api/images\"} 4\n"));
+}
+
+TEST_F(PrometheusRegistryTest, Counter_LabelValueWithQuotes_IsEscaped) {
+    // Arrange
+    registry_.counter("gara_test_total", "Test", {{"path", "a\"b\\c"}}).inc();
+
+    // Act
+    std::string output = registry_.render();
+
+    // Assert
+    EXPECT_TRUE(contains(output, "gara_test_total{path=\"a\\\"b\\\\c\"} 1\n"));
+}
+
+// ============================================================================
+// Registration Tests
+// ============================================================================
+
+TEST_F(PrometheusRegistryTest, Counter_SameNameAndLabels_ReturnsSameSeries) {
+    // Act
+    auto& first = registry_.counter("gara_test_total", "Test", {{"result", "hit"}});
+    auto& second = registry_.counter("gara_test_total", "Test", {{"result", "hit"}});
+    auto& other = registry_.counter("gara_test_total", "Test", {{"result", "miss"}});
+
+    // Assert
+    EXPECT_EQ(&first, &second);
+    EXPECT_NE(&first, &other);
+}
+
+TEST_F(PrometheusRegistryTest, Gauge_NameRegisteredAsCounter_Throws) {
+    // Arrange
+    registry_.counter("gara_test_total", "Test");
+
+    // Act & Assert
+    EXPECT_THROW(registry_.gauge("gara_test_total", "Test"), std::invalid_argument);
+}
+
+TEST_F(PrometheusRegistryTest, Counter_ConcurrentIncrements_NoneLost) {
+    // Arrange
+    auto& counter = registry_.counter("gara_test_total", "Test");
+    std::vector<std::thread> threads;
+
+    // Act
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&counter]() {
+            for (int i = 0; i < 1000; ++i) {
+                counter.inc();
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    // Assert
+    EXPECT_DOUBLE_EQ(4000.0, counter.value());
+}
+
+// ============================================================================
+// Route Label Tests
+// ============================================================================
+
+TEST_F(PrometheusRegistryTest, RouteLabel_PathWithIds_CollapsesIds) {
+    EXPECT_EQ("/api/albums/:id/images/:id", PrometheusRegistry::routeLabel("/api/albums/abc123/images/img456"));
+    EXPECT_EQ("/api/images/:id", PrometheusRegistry::routeLabel("/api/images/deadbeef?format=png"));
+    EXPECT_EQ("/files/transformed/:id", PrometheusRegistry::routeLabel("/files/transformed/abc_webp_320x0.webp"));
+    EXPECT_EQ("/api/images/:id/tiles/image_files/:id/:id",
+              PrometheusRegistry::routeLabel("/api/images/deadbeef/tiles/image_files/12/3_5.jpg"));
+}
+
+TEST_F(PrometheusRegistryTest, RouteLabel_LiteralRoutes_Unchanged) {
+    EXPECT_EQ("/", PrometheusRegistry::routeLabel("/"));
+    EXPECT_EQ("/api/images/upload", PrometheusRegistry::routeLabel("/api/images/upload"));
+    EXPECT_EQ("/health", PrometheusRegistry::routeLabel("/health"));
+    EXPECT_EQ("/debug/memory", PrometheusRegistry::routeLabel("/debug/memory"));
+    EXPECT_EQ("/internal/peer/renditions/:id", PrometheusRegistry::routeLabel("/internal/peer/renditions/abc123"));
+}
+
+TEST_F(PrometheusRegistryTest, RouteLabel_UnknownPath_GroupedAsOther) {
+    EXPECT_EQ("other", PrometheusRegistry::routeLabel("/wp-admin/login.php"));
+    EXPECT_EQ("other", PrometheusRegistry::routeLabel("/api/a/b/c/d/e/f/g"));
+}
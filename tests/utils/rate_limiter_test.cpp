@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+#include "utils/rate_limiter.h"
+#include "exceptions/transform_exceptions.h"
+
+using namespace gara;
+using namespace gara::utils;
+
+class RateLimiterTest : public ::testing::Test {
+protected:
+    static RateLimitConfig makeConfig(double rate, int burst) {
+        RateLimitConfig config;
+        config.enabled = true;
+        config.requests_per_second = rate;
+        config.burst = burst;
+        config.miss_cost = 5;
+        config.max_concurrent_transforms = 2;
+        config.table_size = 1024;
+        return config;
+    }
+};
+
+// ============================================================================
+// Token Bucket Tests
+// ============================================================================
+
+TEST_F(RateLimiterTest, Admit_WithinBurst_Allows) {
+    // Arrange
+    RateLimiter limiter(makeConfig(1.0, 3));
+    auto client = RateLimiter::client("key", "10.0.0.1");
+
+    // Act & Assert
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_TRUE(limiter.admit(client, 1, 1000).allowed) << "request " << i;
+    }
+    auto decision = limiter.admit(client, 1, 1000);
+    EXPECT_FALSE(decision.allowed);
+    EXPECT_EQ(1, decision.retry_after_seconds);
+}
+
+TEST_F(RateLimiterTest, Admit_RefillsOverTime) {
+    // Arrange
+    RateLimiter limiter(makeConfig(2.0, 2));
+    auto client = RateLimiter::client("", "10.0.0.1");
+    ASSERT_TRUE(limiter.admit(client, 2, 1000).allowed);
+    ASSERT_FALSE(limiter.admit(client, 1, 1000).allowed);
+
+    // Act & Assert - Two tokens a second: one is back after 500ms
+    EXPECT_TRUE(limiter.admit(client, 1, 1500).allowed);
+    EXPECT_FALSE(limiter.admit(client, 1, 1500).allowed);
+}
+
+TEST_F(RateLimiterTest, Admit_SlowRefill_AccumulatesAcrossShortIntervals) {
+    // Arrange - 0.5 tokens a second adds nothing per millisecond
+    RateLimiter limiter(makeConfig(0.5, 1));
+    auto client = RateLimiter::client("", "10.0.0.1");
+    ASSERT_TRUE(limiter.admit(client, 1, 1000).allowed);
+
+    // Act - Frequent rejected polls must not reset the refill clock
+    for (uint64_t now = 1001; now < 3000; now += 100) {
+        limiter.admit(client, 1, now);
+    }
+
+    // Assert
+    EXPECT_TRUE(limiter.admit(client, 1, 3000).allowed);
+}
+
+TEST_F(RateLimiterTest, Admit_RetryAfter_CoversShortfall) {
+    RateLimiter limiter(makeConfig(1.0, 10));
+    auto client = RateLimiter::client("", "10.0.0.1");
+    ASSERT_TRUE(limiter.admit(client, 10, 1000).allowed);
+
+    EXPECT_EQ(4, limiter.admit(client, 4, 1000).retry_after_seconds);
+}
+
+TEST_F(RateLimiterTest, Admit_KeyAndIpBuckets_BothMustAfford) {
+    // Arrange
+    RateLimiter limiter(makeConfig(1.0, 2));
+    auto first = RateLimiter::client("key-a", "10.0.0.1");
+    auto same_ip = RateLimiter::client("key-b", "10.0.0.1");
+    auto same_key = RateLimiter::client("key-a", "10.0.0.2");
+
+    // Act
+    ASSERT_TRUE(limiter.admit(first, 2, 1000).allowed);
+
+    // Assert - Each shares an empty bucket with the first client
+    EXPECT_FALSE(limiter.admit(same_ip, 1, 1000).allowed);
+    EXPECT_FALSE(limiter.admit(same_key, 1, 1000).allowed);
+
+    // A rejection charges neither bucket, so 10.0.0.2 can still spend on another key
+    EXPECT_TRUE(limiter.admit(RateLimiter::client("key-c", "10.0.0.2"), 2, 1000).allowed);
+}
+
+// ============================================================================
+// Transform Admission Tests
+// ============================================================================
+
+TEST_F(RateLimiterTest, AdmitTransform_WithoutScope_IsUnlimited) {
+    EXPECT_NO_THROW({
+        for (int i = 0; i < 100; ++i) {
+            RateLimiter::admitTransform();
+        }
+    });
+    EXPECT_TRUE(RateLimiter::chargeMisses(100));
+}
+
+TEST_F(RateLimiterTest, AdmitTransform_CapsConcurrentTransforms) {
+    // Arrange
+    RateLimiter limiter(makeConfig(1.0, 100));
+    RateLimiter::Scope scope(&limiter, RateLimiter::client("key", "10.0.0.1"));
+
+    // Act
+    auto first = RateLimiter::admitTransform();
+    auto second = RateLimiter::admitTransform();
+
+    // Assert
+    EXPECT_THROW(RateLimiter::admitTransform(), exceptions::TooManyRequestsException);
+    {
+        auto released = std::move(first);
+    }
+    EXPECT_NO_THROW(RateLimiter::admitTransform());
+}
+
+TEST_F(RateLimiterTest, AdmitTransform_ChargesMissCost) {
+    // Arrange - Room for two misses at 5 tokens each
+    auto config = makeConfig(0.01, 10);
+    config.max_concurrent_transforms = 0;
+    RateLimiter limiter(config);
+    RateLimiter::Scope scope(&limiter, RateLimiter::client("", "10.0.0.1"));
+
+    // Act & Assert
+    EXPECT_NO_THROW(RateLimiter::admitTransform());
+    EXPECT_TRUE(RateLimiter::chargeMisses(1));
+    EXPECT_FALSE(RateLimiter::chargeMisses(1));
+    EXPECT_THROW(RateLimiter::admitTransform(), exceptions::TooManyRequestsException);
+}
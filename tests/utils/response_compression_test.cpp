@@ -0,0 +1,136 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <zlib.h>
+#include "utils/response_compression.h"
+
+using namespace gara;
+using namespace gara::utils;
+
+class ResponseCompressionTest : public ::testing::Test {
+protected:
+    static std::string jsonBody(size_t rows) {
+        std::string body = "{\"images\":[";
+        for (size_t i = 0; i < rows; ++i) {
+            body += "{\"format\":\"jpg\",\"id\":\"" + std::string(64, static_cast<char>('a' + i % 6)) +
+                    "\",\"name\":\"photo\",\"size\":2048},";
+        }
+        body += "{}]}";
+        return body;
+    }
+
+    static std::string gunzip(const std::string& encoded) {
+        z_stream stream{};
+        inflateInit2(&stream, 15 + 16);
+        std::string out(1 << 20, '\0');
+        stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(encoded.data()));
+        stream.avail_in = static_cast<uInt>(encoded.size());
+        stream.next_out = reinterpret_cast<Bytef*>(&out[0]);
+        stream.avail_out = static_cast<uInt>(out.size());
+        int rc = inflate(&stream, Z_FINISH);
+        out.resize(rc == Z_STREAM_END ? stream.total_out : 0);
+        inflateEnd(&stream);
+        return out;
+    }
+};
+
+// ============================================================================
+// Negotiation Tests
+// ============================================================================
+
+TEST_F(ResponseCompressionTest, Negotiate_GzipOnly_PicksGzip) {
+    ResponseCompressor compressor;
+    EXPECT_EQ(ContentEncoding::GZIP, compressor.negotiate("gzip"));
+    EXPECT_EQ(ContentEncoding::GZIP, compressor.negotiate("deflate, GZIP;q=0.8"));
+}
+
+TEST_F(ResponseCompressionTest, Negotiate_NoneOrRefused_PicksIdentity) {
+    ResponseCompressor compressor;
+    EXPECT_EQ(ContentEncoding::IDENTITY, compressor.negotiate(""));
+    EXPECT_EQ(ContentEncoding::IDENTITY, compressor.negotiate("identity"));
+    EXPECT_EQ(ContentEncoding::IDENTITY, compressor.negotiate("gzip;q=0, deflate"));
+    EXPECT_EQ(ContentEncoding::IDENTITY, compressor.negotiate("*;q=0"));
+}
+
+TEST_F(ResponseCompressionTest, Negotiate_HigherQualityWins) {
+    // Arrange
+    ResponseCompressor compressor;
+
+    // Act
+    ContentEncoding encoding = compressor.negotiate("gzip;q=1.0, br;q=0.5, zstd;q=0.2");
+
+    // Assert
+    EXPECT_EQ(ContentEncoding::GZIP, encoding);
+}
+
+TEST_F(ResponseCompressionTest, Negotiate_Tie_PrefersStrongestSupportedCoding) {
+    // Arrange
+    ResponseCompressor compressor;
+    ContentEncoding expected = ResponseCompressor::isSupported(ContentEncoding::ZSTD) ? ContentEncoding::ZSTD
+        : ResponseCompressor::isSupported(ContentEncoding::BROTLI) ? ContentEncoding::BROTLI
+        : ContentEncoding::GZIP;
+
+    // Act & Assert
+    EXPECT_EQ(expected, compressor.negotiate("gzip, deflate, br, zstd"));
+    EXPECT_EQ(expected, compressor.negotiate("*"));
+}
+
+TEST_F(ResponseCompressionTest, Negotiate_Disabled_PicksIdentity) {
+    CompressionConfig config;
+    config.enabled = false;
+    ResponseCompressor compressor(config);
+    EXPECT_EQ(ContentEncoding::IDENTITY, compressor.negotiate("gzip"));
+}
+
+// ============================================================================
+// Compression Tests
+// ============================================================================
+
+TEST_F(ResponseCompressionTest, Compress_Gzip_RoundTrips) {
+    // Arrange
+    ResponseCompressor compressor;
+    std::string body = jsonBody(200);
+
+    // Act
+    auto encoded = compressor.compress(body, ContentEncoding::GZIP);
+
+    // Assert
+    ASSERT_TRUE(encoded.has_value());
+    EXPECT_LT(encoded->size(), body.size() / 4);
+    EXPECT_EQ(body, gunzip(*encoded));
+
+    // The per-thread stream is reused for the next body
+    auto again = compressor.compress(body, ContentEncoding::GZIP);
+    ASSERT_TRUE(again.has_value());
+    EXPECT_EQ(*encoded, *again);
+}
+
+TEST_F(ResponseCompressionTest, Compress_BelowThreshold_Skipped) {
+    ResponseCompressor compressor;
+    EXPECT_FALSE(compressor.compress("{\"albums\":[]}", ContentEncoding::GZIP).has_value());
+}
+
+TEST_F(ResponseCompressionTest, Compress_Incompressible_Skipped) {
+    // Arrange
+    std::mt19937 rng(42);
+    std::string body(8192, '\0');
+    for (auto& c : body) {
+        c = static_cast<char>(rng());
+    }
+    ResponseCompressor compressor;
+
+    // Act & Assert
+    EXPECT_FALSE(compressor.compress(body, ContentEncoding::GZIP).has_value());
+}
+
+TEST_F(ResponseCompressionTest, Compress_EveryCompiledInCoding_Shrinks) {
+    ResponseCompressor compressor;
+    std::string body = jsonBody(200);
+    for (auto encoding : {ContentEncoding::GZIP, ContentEncoding::BROTLI, ContentEncoding::ZSTD}) {
+        auto encoded = compressor.compress(body, encoding);
+        EXPECT_EQ(ResponseCompressor::isSupported(encoding), encoded.has_value())
+            << ResponseCompressor::token(encoding);
+        if (encoded) {
+            EXPECT_LT(encoded->size(), body.size() / 4) << ResponseCompressor::token(encoding);
+        }
+    }
+}
@@ -0,0 +1,171 @@
+#include <gtest/gtest.h>
+#include "utils/single_flight.h"
+#include "utils/logger.h"
+#include "utils/metrics.h"
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace gara::utils;
+
+class SingleFlightTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        gara::Logger::initialize("gara-test", "error", gara::Logger::Format::TEXT, "test");
+        gara::Metrics::initialize("GaraTest", "gara-test", "test", false);
+    }
+};
+
+// ============================================================================
+// Basic Execution Tests
+// ============================================================================
+
+TEST_F(SingleFlightTest, Run_SingleCaller_ReturnsWorkResult) {
+    // Arrange
+    SingleFlight<std::string> flights("test", std::chrono::milliseconds(1000));
+
+    // Act
+    auto result = flights.run("key", []() { return std::string("value"); });
+
+    // Assert
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ("value", *result);
+    EXPECT_EQ(0u, flights.inFlight())
+        << "Completed calls should be removed from the table";
+}
+
+TEST_F(SingleFlightTest, Run_WorkThrows_RethrowsAndClearsKey) {
+    // Arrange
+    SingleFlight<int> flights("test", std::chrono::milliseconds(1000));
+
+    // Act & Assert
+    EXPECT_THROW(flights.run("key", []() -> int { throw std::runtime_error("boom"); }),
+                 std::runtime_error);
+    EXPECT_EQ(0u, flights.inFlight());
+
+    auto result = flights.run("key", []() { return 7; });
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(7, *result)
+        << "A failed call should not poison later calls for the same key";
+}
+
+// ============================================================================
+// Coalescing Tests
+// ============================================================================
+
+TEST_F(SingleFlightTest, Run_ConcurrentCallersSameKey_ExecutesWorkOnce) {
+    // Arrange
+    SingleFlight<int> flights("test", std::chrono::milliseconds(5000));
+    std::atomic<int> executions{0};
+    std::atomic<int> successes{0};
+    const int num_threads = 8;
+
+    // Act
+    std::vector<std::thread> threads;
+    for (int i = 0; i < num_threads; ++i) {
+        threads.emplace_back([&]() {
+            auto result = flights.run("same-key", [&]() {
+                executions++;
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                return 42;
+            });
+            if (result && *result == 42) {
+                successes++;
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    // Assert
+    EXPECT_EQ(1, executions.load())
+        << "Concurrent callers for one key should share a single execution";
+    EXPECT_EQ(num_threads, successes.load())
+        << "Every caller should receive the leader's result";
+}
+
+TEST_F(SingleFlightTest, Run_DifferentKeys_ExecutesEachKey) {
+    // Arrange
+    SingleFlight<int> flights("test", std::chrono::milliseconds(1000));
+    std::atomic<int> executions{0};
+
+    // Act
+    std::thread first([&]() { flights.run("a", [&]() { executions++; return 1; }); });
+    std::thread second([&]() { flights.run("b", [&]() { executions++; return 2; }); });
+    first.join();
+    second.join();
+
+    // Assert
+    EXPECT_EQ(2, executions.load());
+}
+
+TEST_F(SingleFlightTest, Run_WaiterExceedsTimeout_ReturnsNullopt) {
+    // Arrange
+    SingleFlight<int> flights("test", std::chrono::milliseconds(10));
+    std::atomic<bool> leader_started{false};
+
+    std::thread leader([&]() {
+        flights.run("slow", [&]() {
+            leader_started = true;
+            std::this_thread::sleep_for(std::chrono::milliseconds(200));
+            return 1;
+        });
+    });
+    while (!leader_started) {
+        std::this_thread::yield();
+    }
+
+    // Act
+    auto result = flights.run("slow", []() { return 2; });
+    leader.join();
+
+    // Assert
+    EXPECT_FALSE(result.has_value())
+        << "Waiter should give up after its timeout";
+}
+
+TEST_F(SingleFlightTest, TryRun_KeyInFlight_ReturnsImmediatelyWithoutWork) {
+    // Arrange
+    SingleFlight<int> flights("test", std::chrono::milliseconds(5000));
+    std::atomic<bool> leader_started{false};
+    std::atomic<bool> release{false};
+    std::atomic<bool> ran{false};
+
+    std::thread leader([&]() {
+        flights.run("busy", [&]() {
+            leader_started = true;
+            while (!release) {
+                std::this_thread::yield();
+            }
+            return 1;
+        });
+    });
+    while (!leader_started) {
+        std::this_thread::yield();
+    }
+
+    // Act
+    auto result = flights.tryRun("busy", [&]() { ran = true; return 2; });
+    release = true;
+    leader.join();
+
+    // Assert
+    EXPECT_FALSE(result.has_value())
+        << "tryRun should not wait for the in-flight call";
+    EXPECT_FALSE(ran.load());
+}
+
+TEST_F(SingleFlightTest, TryRun_KeyIdle_RunsWork) {
+    // Arrange
+    SingleFlight<int> flights("test", std::chrono::milliseconds(1000));
+
+    // Act
+    auto result = flights.tryRun("idle", []() { return 7; });
+
+    // Assert
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(7, *result);
+}
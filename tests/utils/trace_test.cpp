@@ -0,0 +1,143 @@
+#include <gtest/gtest.h>
+#include "utils/trace.h"
+#include <thread>
+
+using namespace gara::utils;
+
+class RequestTraceTest : public ::testing::Test {
+protected:
+    void TearDown() override {
+        RequestTrace::setCurrent(nullptr);
+    }
+};
+
+// ============================================================================
+// Traceparent Tests
+// ============================================================================
+
+TEST_F(RequestTraceTest, ParseTraceparent_Valid_ExtractsIdsAndFlag) {
+    std::string trace_id;
+    std::string span_id;
+    bool sampled = false;
+
+    ASSERT_TRUE(RequestTrace::parseTraceparent(
+        "00-4bf92f3577b34da6a3ce929d0e0e4736-00f067aa0ba902b7-01", trace_id, span_id, sampled));
+
+    EXPECT_EQ(trace_id, "4bf92f3577b34da6a3ce929d0e0e4736");
+    EXPECT_EQ(span_id, "00f067aa0ba902b7");
+    EXPECT_TRUE(sampled);
+}
+
+TEST_F(RequestTraceTest, ParseTraceparent_Malformed_Rejected) {
+    std::string trace_id;
+    std::string span_id;
+    bool sampled = false;
+
+    EXPECT_FALSE(RequestTrace::parseTraceparent("", trace_id, span_id, sampled));
+    EXPECT_FALSE(RequestTrace::parseTraceparent(
+        "00-4bf92f3577b34da6a3ce929d0e0e4736-00f067aa0ba902b7", trace_id, span_id, sampled));
+    EXPECT_FALSE(RequestTrace::parseTraceparent(
+        "00-4BF92F3577B34DA6A3CE929D0E0E4736-00f067aa0ba902b7-01", trace_id, span_id, sampled));
+    EXPECT_FALSE(RequestTrace::parseTraceparent(
+        "00-00000000000000000000000000000000-00f067aa0ba902b7-01", trace_id, span_id, sampled));
+    EXPECT_FALSE(RequestTrace::parseTraceparent(
+        "ff-4bf92f3577b34da6a3ce929d0e0e4736-00f067aa0ba902b7-01", trace_id, span_id, sampled));
+}
+
+TEST_F(RequestTraceTest, Constructor_WithTraceparent_JoinsParentTrace) {
+    RequestTrace trace("00-4bf92f3577b34da6a3ce929d0e0e4736-00f067aa0ba902b7-00", "req-1", 1.0);
+
+    EXPECT_EQ(trace.traceId(), "4bf92f3577b34da6a3ce929d0e0e4736");
+    EXPECT_EQ(trace.parentSpanId(), "00f067aa0ba902b7");
+    EXPECT_NE(trace.spanId(), "00f067aa0ba902b7");
+    // The caller's "not sampled" decision wins over the local ratio
+    EXPECT_FALSE(trace.sampled());
+}
+
+TEST_F(RequestTraceTest, Constructor_UuidRequestId_BecomesTraceId) {
+    RequestTrace trace("", "1700000000_0af7651a-6d6e-4b2c-9e0f-1234567890ab", 0.0);
+
+    EXPECT_EQ(trace.traceId(), "0af7651a6d6e4b2c9e0f1234567890ab");
+    EXPECT_TRUE(trace.parentSpanId().empty());
+    EXPECT_FALSE(trace.sampled());
+}
+
+TEST_F(RequestTraceTest, Constructor_OpaqueRequestId_GeneratesTraceId) {
+    RequestTrace trace("", "my-request", 1.0);
+
+    EXPECT_EQ(trace.traceId().size(), 32u);
+    EXPECT_EQ(trace.spanId().size(), 16u);
+    EXPECT_TRUE(trace.sampled());
+    EXPECT_EQ(trace.traceparent(), "00-" + trace.traceId() + "-" + trace.spanId() + "-01");
+}
+
+// ============================================================================
+// Server-Timing Tests
+// ============================================================================
+
+TEST_F(RequestTraceTest, ServerTiming_RepeatedStages_SummedInFirstSeenOrder) {
+    // Arrange
+    RequestTrace trace("", "req", 0.0);
+    auto base = RequestTrace::Clock::now();
+    trace.addSpan("cache", base, base + std::chrono::microseconds(1500));
+    trace.addSpan("encode", base, base + std::chrono::milliseconds(2));
+    trace.addSpan("encode", base, base + std::chrono::milliseconds(3));
+
+    // Act
+    trace.finish("GET", "/api/images/:id", 200);
+    std::string header = trace.serverTiming();
+
+    // Assert
+    EXPECT_EQ(header.rfind("cache;dur=1.5, encode;dur=5.0, total;dur=", 0), 0u) << header;
+}
+
+TEST_F(RequestTraceTest, ServerTiming_NoSpans_OnlyTotal) {
+    RequestTrace trace("", "req", 0.0);
+
+    EXPECT_EQ(trace.serverTiming().rfind("total;dur=", 0), 0u);
+}
+
+// ============================================================================
+// Current Trace Tests
+// ============================================================================
+
+TEST_F(RequestTraceTest, ScopedSpan_NoActiveTrace_IsNoOp) {
+    ASSERT_EQ(RequestTrace::active(), nullptr);
+    {
+        TRACE_SPAN("cache");
+    }
+    EXPECT_EQ(RequestTrace::active(), nullptr);
+}
+
+TEST_F(RequestTraceTest, Scope_OnWorkerThread_RecordsIntoRequestTrace) {
+    // Arrange
+    auto trace = std::make_shared<RequestTrace>("", "req", 0.0);
+    RequestTrace::setCurrent(trace);
+    { TRACE_SPAN("raw"); }
+
+    // Act: hand the trace to another thread as transform tasks do
+    std::thread worker([captured = RequestTrace::current()]() {
+        RequestTrace::Scope scope(captured);
+        TRACE_SPAN("decode");
+    });
+    worker.join();
+
+    // Assert
+    auto spans = trace->spans();
+    ASSERT_EQ(spans.size(), 2u);
+    EXPECT_STREQ(spans[0].name, "raw");
+    EXPECT_STREQ(spans[1].name, "decode");
+}
+
+TEST_F(RequestTraceTest, Scope_Destroyed_RestoresPreviousTrace) {
+    auto outer = std::make_shared<RequestTrace>("", "outer", 0.0);
+    auto inner = std::make_shared<RequestTrace>("", "inner", 0.0);
+    RequestTrace::setCurrent(outer);
+
+    {
+        RequestTrace::Scope scope(inner);
+        EXPECT_EQ(RequestTrace::active(), inner.get());
+    }
+
+    EXPECT_EQ(RequestTrace::active(), outer.get());
+}